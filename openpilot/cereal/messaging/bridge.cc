@@ -6,6 +6,12 @@
 
 ExitHandler do_exit;
 
+// must match BRIDGE_CAN_DELTA on the msgq_to_zmq side
+static const bool BRIDGE_CAN_DELTA = getenv("BRIDGE_CAN_DELTA") != nullptr;
+
+// must match BRIDGE_ZSTD on the msgq_to_zmq side
+static const bool BRIDGE_ZSTD = getenv("BRIDGE_ZSTD") != nullptr;
+
 static std::vector<std::string> get_services(const std::string &whitelist_str, bool zmq_to_msgq) {
   std::vector<std::string> service_list;
   for (const auto& it : services) {
@@ -29,6 +35,8 @@ void zmq_to_msgq(const std::vector<std::string> &endpoints, const std::string &i
   auto pub_context = std::make_unique<Context>();
   auto sub_context = std::make_unique<BridgeZmqContext>();
   std::map<BridgeZmqSubSocket *, PubSocket *> sub2pub;
+  std::map<BridgeZmqSubSocket *, std::unique_ptr<CanDeltaCodec>> sub2codec;
+  std::map<BridgeZmqSubSocket *, std::unique_ptr<ZstdTransportCodec>> sub2zstd;
 
   for (auto endpoint : endpoints) {
     auto pub_sock = new PubSocket();
@@ -39,13 +47,35 @@ void zmq_to_msgq(const std::vector<std::string> &endpoints, const std::string &i
 
     poller->registerSocket(sub_sock);
     sub2pub[sub_sock] = pub_sock;
+    if (BRIDGE_CAN_DELTA && isCanDeltaEndpoint(endpoint)) {
+      sub2codec[sub_sock] = std::make_unique<CanDeltaCodec>();
+    } else if (BRIDGE_ZSTD && isZstdTransportEndpoint(endpoint)) {
+      sub2zstd[sub_sock] = std::make_unique<ZstdTransportCodec>();
+    }
   }
 
   while (!do_exit) {
     for (auto sub_sock : poller->poll(100)) {
-      std::unique_ptr<Message> msg(sub_sock->receive(true));
-      if (msg) {
-        sub2pub[sub_sock]->sendMessage(msg.get());
+      // handles both single messages and bulk-mode multi-part messages
+      for (Message *part : sub_sock->receiveParts(true)) {
+        std::unique_ptr<Message> msg(part);
+        auto codec_it = sub2codec.find(sub_sock);
+        auto zstd_it = sub2zstd.find(sub_sock);
+        if (codec_it != sub2codec.end()) {
+          // reinflate delta-encoded CAN payloads before republishing
+          std::string inflated;
+          if (codec_it->second->decode(msg->getData(), msg->getSize(), &inflated)) {
+            sub2pub[sub_sock]->send(inflated.data(), inflated.size());
+          }
+        } else if (zstd_it != sub2zstd.end()) {
+          // decompress transport frames before republishing
+          std::string inflated;
+          if (zstd_it->second->decode(msg->getData(), msg->getSize(), &inflated)) {
+            sub2pub[sub_sock]->send(inflated.data(), inflated.size());
+          }
+        } else {
+          sub2pub[sub_sock]->sendMessage(msg.get());
+        }
       }
     }
   }
@@ -102,17 +102,39 @@ Message *BridgeZmqSubSocket::receive(bool non_blocking) {
   return ret;
 }
 
+std::vector<Message *> BridgeZmqSubSocket::receiveParts(bool non_blocking) {
+  std::vector<Message *> ret;
+
+  int more = 0;
+  do {
+    Message *msg = receive(non_blocking && ret.empty());
+    if (msg == nullptr) break;
+    ret.push_back(msg);
+
+    size_t more_size = sizeof(more);
+    zmq_getsockopt(sock, ZMQ_RCVMORE, &more, &more_size);
+  } while (more);
+
+  return ret;
+}
+
 BridgeZmqSubSocket::~BridgeZmqSubSocket() {
   if (sock != nullptr) {
     zmq_close(sock);
   }
 }
 
-int BridgeZmqPubSocket::connect(BridgeZmqContext *context, std::string endpoint, bool check_endpoint) {
-  sock = zmq_socket(context->getRawContext(), ZMQ_PUB);
+int BridgeZmqPubSocket::connect(BridgeZmqContext *context, std::string endpoint, bool check_endpoint, bool xpub) {
+  sock = zmq_socket(context->getRawContext(), xpub ? ZMQ_XPUB : ZMQ_PUB);
   if (sock == nullptr) {
     return -1;
   }
+  if (xpub) {
+    // pass every subscribe/unsubscribe upstream, including duplicates, so the
+    // bridge can refcount remote subscribers per topic
+    int arg = 1;
+    zmq_setsockopt(sock, ZMQ_XPUB_VERBOSER, &arg, sizeof(arg));
+  }
 
   full_endpoint = "tcp://*:";
   if (check_endpoint) {
@@ -132,6 +154,18 @@ int BridgeZmqPubSocket::sendMessage(Message *message) {
   return zmq_send(sock, message->getData(), message->getSize(), ZMQ_DONTWAIT);
 }
 
+int BridgeZmqPubSocket::sendMessageParts(const std::vector<Message *> &messages) {
+  assert(pid == getpid());
+  int total = 0;
+  for (size_t i = 0; i < messages.size(); i++) {
+    int flags = ZMQ_DONTWAIT | (i + 1 < messages.size() ? ZMQ_SNDMORE : 0);
+    int rc = zmq_send(sock, messages[i]->getData(), messages[i]->getSize(), flags);
+    if (rc < 0) return rc;
+    total += rc;
+  }
+  return total;
+}
+
 int BridgeZmqPubSocket::send(char *data, size_t size) {
   assert(pid == getpid());
   return zmq_send(sock, data, size, ZMQ_DONTWAIT);
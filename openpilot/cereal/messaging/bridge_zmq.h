@@ -37,6 +37,10 @@ public:
   int connect(BridgeZmqContext *context, std::string endpoint, std::string address, bool conflate = false, bool check_endpoint = true);
   void setTimeout(int timeout);
   Message *receive(bool non_blocking = false);
+  // Receives all frames of one (possibly multi-part) ZMQ message. A bulk-mode
+  // sender packs a whole poll tick into one multi-part message; each frame is
+  // one msgq message. Caller owns the returned messages.
+  std::vector<Message *> receiveParts(bool non_blocking = false);
   void *getRawSocket() { return sock; }
   ~BridgeZmqSubSocket();
 
@@ -47,8 +51,13 @@ private:
 
 class BridgeZmqPubSocket {
 public:
-  int connect(BridgeZmqContext *context, std::string endpoint, bool check_endpoint = true);
+  // xpub exposes subscribe/unsubscribe frames as inbound messages on the
+  // socket (with duplicates), so the owner can track remote subscribers
+  int connect(BridgeZmqContext *context, std::string endpoint, bool check_endpoint = true, bool xpub = false);
   int sendMessage(Message *message);
+  // Coalesces all messages into a single multi-part ZMQ message (one syscall per
+  // frame, one wire message). Split on the receive side with receiveParts().
+  int sendMessageParts(const std::vector<Message *> &messages);
   int send(char *data, size_t size);
   void *getRawSocket() { return sock; }
   ~BridgeZmqPubSocket();
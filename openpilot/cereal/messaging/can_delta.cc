@@ -0,0 +1,89 @@
+#include "openpilot/cereal/messaging/can_delta.h"
+
+#include <cstring>
+
+// Frame layout:
+//   'R' + raw bytes                          - raw fallback
+//   'D' + repeated (varint skip, varint lit, lit bytes)
+// where skip copies bytes from the previous message at the current offset.
+
+static void put_varint(std::string &out, uint64_t v) {
+  while (v >= 0x80) {
+    out.push_back((char)(v | 0x80));
+    v >>= 7;
+  }
+  out.push_back((char)v);
+}
+
+static bool get_varint(const char *&p, const char *end, uint64_t *v) {
+  *v = 0;
+  for (int shift = 0; p < end && shift < 64; shift += 7) {
+    uint8_t b = (uint8_t)*p++;
+    *v |= (uint64_t)(b & 0x7f) << shift;
+    if (!(b & 0x80)) return true;
+  }
+  return false;
+}
+
+bool isCanDeltaEndpoint(const std::string &endpoint) {
+  return endpoint == "can" || endpoint == "sendcan";
+}
+
+std::string CanDeltaCodec::encode(const char *data, size_t size) {
+  std::string out;
+  // periodic raw frame so a subscriber that missed frames resynchronizes
+  bool force_raw = (seq_++ % 100) == 0;
+  if (!prev_.empty() && !force_raw) {
+    out.push_back('D');
+    size_t common = std::min(prev_.size(), size);
+    size_t i = 0;
+    while (i < size) {
+      // run of bytes identical to the previous message
+      size_t skip = i;
+      while (skip < common && data[skip] == prev_[skip]) skip++;
+      skip -= i;
+
+      // following run of changed (or trailing) bytes
+      size_t lit_start = i + skip;
+      size_t lit = lit_start;
+      while (lit < size && (lit >= common || data[lit] != prev_[lit])) lit++;
+      lit -= lit_start;
+
+      put_varint(out, skip);
+      put_varint(out, lit);
+      out.append(data + lit_start, lit);
+      i = lit_start + lit;
+    }
+  }
+
+  if (out.empty() || out.size() >= size + 1) {
+    out.assign(1, 'R');
+    out.append(data, size);
+  }
+  prev_.assign(data, size);
+  return out;
+}
+
+bool CanDeltaCodec::decode(const char *data, size_t size, std::string *out) {
+  if (size < 1) return false;
+  const char *p = data + 1, *end = data + size;
+
+  if (data[0] == 'R') {
+    out->assign(p, end - p);
+  } else if (data[0] == 'D') {
+    out->clear();
+    while (p < end) {
+      uint64_t skip, lit;
+      if (!get_varint(p, end, &skip) || !get_varint(p, end, &lit)) return false;
+      if (out->size() + skip > prev_.size() || (uint64_t)(end - p) < lit) return false;
+      out->append(prev_, out->size(), skip);
+      out->append(p, lit);
+      p += lit;
+    }
+  } else {
+    return false;
+  }
+
+  prev_ = *out;
+  return true;
+}
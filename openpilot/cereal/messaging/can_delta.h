@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Byte-level delta codec for the msgq<->zmq bridge, used on high-volume CAN
+// topics (can/sendcan). Consecutive CAN events share most of their bytes
+// (message IDs, unchanged payloads, capnp framing), so each message is encoded
+// against the previous one on the same endpoint as alternating runs of
+// "copy from previous" and literal bytes. The decoder keeps the mirrored
+// previous-message state, making reinflation transparent to subscribers.
+
+class CanDeltaCodec {
+public:
+  // Encodes data against the previous message on this endpoint and updates the
+  // previous-message state. Falls back to a raw frame when there is no prior
+  // state or the delta would not be smaller.
+  std::string encode(const char *data, size_t size);
+
+  // Inverse of encode(); returns false on a malformed frame.
+  bool decode(const char *data, size_t size, std::string *out);
+
+private:
+  std::string prev_;
+  uint64_t seq_ = 0;
+};
+
+// Only can/sendcan are worth delta-encoding on the wire
+bool isCanDeltaEndpoint(const std::string &endpoint);
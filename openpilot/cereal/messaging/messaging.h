@@ -1,7 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <utility>
@@ -14,14 +18,47 @@
 
 class SubMaster {
 public:
+  // Services in latest_only are treated as pure state topics: update() skips
+  // straight to the newest queued message and decodes exactly one reader per
+  // cycle instead of working through the whole ring.
   SubMaster(const std::vector<const char *> &service_list, const std::vector<const char *> &poll = {},
-            const char *address = nullptr, const std::vector<const char *> &ignore_alive = {});
+            const char *address = nullptr, const std::vector<const char *> &ignore_alive = {},
+            const std::vector<const char *> &latest_only = {});
   void update(int timeout = 1000);
+  // Poll timeout (ms) until the earliest expected message, derived from the
+  // per-service frequencies. Low-rate subscribers can call
+  // update(adaptiveTimeout()) to sleep through known-idle periods instead of
+  // spinning on a fixed short timeout.
+  int adaptiveTimeout(int max_timeout = 1000) const;
   void update_msgs(uint64_t current_time, const std::vector<std::pair<std::string, cereal::Event::Reader>> &messages);
   inline bool allAlive(const std::vector<const char *> &service_list = {}) { return all_(service_list, false, true); }
   inline bool allValid(const std::vector<const char *> &service_list = {}) { return all_(service_list, true, false); }
   inline bool allAliveAndValid(const std::vector<const char *> &service_list = {}) { return all_(service_list, true, true); }
   void drain();
+
+  // Batched drain: consumes every queued message on all sockets in one poll cycle
+  // without the per-message AlignedBuffer copy. Readers point directly into the
+  // received msgq buffers when they are word-aligned (a copy is only made for the
+  // rare misaligned message) and stay valid until the next call to drainBatch()
+  // or releaseDrained().
+  struct DrainedEvent {
+    std::string name;
+    cereal::Event::Reader event;
+  };
+  const std::vector<DrainedEvent> &drainBatch(int timeout = 1000);
+  void releaseDrained();
+
+  // Opt-in poll loop instrumentation (set SUBMASTER_PERF=1): per-socket
+  // histograms of poll-wakeup-to-decoded latency plus messages drained per
+  // cycle, in log2 ns buckets. Zero overhead when not enabled.
+  struct PerfSnapshot {
+    std::string name;
+    uint64_t count = 0;
+    uint64_t max_latency_ns = 0;
+    uint64_t latency_buckets[32] = {};  // bucket i: latency in [2^i, 2^(i+1)) ns
+    uint64_t msgs_per_cycle_buckets[16] = {};
+  };
+  std::vector<PerfSnapshot> perfSnapshot() const;
   ~SubMaster();
 
   uint64_t frame = 0;
@@ -38,15 +75,34 @@ private:
   struct SubMessage;
   std::map<SubSocket *, SubMessage *> messages_;
   std::map<std::string, SubMessage *> services_;
+
+  // cached aggregates so all_() and the per-update alive recompute scale with
+  // traffic instead of subscription count
+  size_t valid_count_ = 0;
+  size_t alive_ok_count_ = 0;  // alive or ignore_alive
+  uint64_t next_alive_check_ = 0;  // earliest time any service can go stale
+
+  // state owned by the batched drain path, released by releaseDrained()
+  std::vector<DrainedEvent> drained_events_;
+  std::vector<std::unique_ptr<Message>> drained_msgs_;
+  std::vector<std::unique_ptr<capnp::FlatArrayMessageReader>> drained_readers_;
+  std::vector<kj::Array<capnp::word>> drained_copies_;
 };
 
 class MessageBuilder : public capnp::MallocMessageBuilder {
 public:
   MessageBuilder() = default;
 
+protected:
+  explicit MessageBuilder(kj::ArrayPtr<capnp::word> firstSegment) : capnp::MallocMessageBuilder(firstSegment) {}
+
+public:
+
   cereal::Event::Builder initEvent(bool valid = true) {
     cereal::Event::Builder event = initRoot<cereal::Event>();
-    event.setLogMonoTime(nanos_since_boot());
+    // coarse falls back to the precise clock unless the process opted in
+    // via start_coarse_timing_thread()
+    event.setLogMonoTime(nanos_since_boot_coarse());
     event.setValid(valid);
     return event;
   }
@@ -72,15 +128,80 @@ private:
   kj::Array<capnp::word> heapArray_;
 };
 
+// Thread-local free list of fixed-size capnp first segments. High-rate
+// publishers construct hundreds of builders per second; recycling the first
+// segment turns steady-state event construction into zero heap allocations.
+class MessageSegmentPool {
+public:
+  static constexpr size_t SEGMENT_WORDS = 4 * 1024;  // 32 KiB, covers every high-rate event
+
+  static kj::Array<capnp::word> acquire() {
+    auto &free_list = freeList();
+    if (!free_list.empty()) {
+      kj::Array<capnp::word> seg = std::move(free_list.back());
+      free_list.pop_back();
+      return seg;
+    }
+    auto seg = kj::heapArray<capnp::word>(SEGMENT_WORDS);
+    memset(seg.begin(), 0, seg.size() * sizeof(capnp::word));
+    return seg;
+  }
+
+  static void release(kj::Array<capnp::word> segment) {
+    // capnp requires a zeroed first segment, so reset on the way back in
+    memset(segment.begin(), 0, segment.size() * sizeof(capnp::word));
+    freeList().push_back(std::move(segment));
+  }
+
+private:
+  static std::vector<kj::Array<capnp::word>> &freeList() {
+    static thread_local std::vector<kj::Array<capnp::word>> free_list;
+    return free_list;
+  }
+};
+
+// Drop-in MessageBuilder whose first segment comes from the thread-local pool
+// and is returned (reset, not freed) on destruction. Events larger than the
+// pooled segment transparently fall back to heap-allocated extra segments.
+class PooledMessageBuilder : public MessageBuilder {
+public:
+  PooledMessageBuilder() : PooledMessageBuilder(MessageSegmentPool::acquire()) {}
+  ~PooledMessageBuilder() { MessageSegmentPool::release(std::move(segment_)); }
+
+private:
+  explicit PooledMessageBuilder(kj::Array<capnp::word> segment)
+      : MessageBuilder(kj::ArrayPtr<capnp::word>(segment.begin(), segment.size())),
+        segment_(std::move(segment)) {}
+  kj::Array<capnp::word> segment_;
+};
+
 class PubMaster {
 public:
   PubMaster(const std::vector<const char *> &service_list);
   inline int send(const char *name, capnp::byte *data, size_t size) { return sockets_.at(name)->send((char *)data, size); }
   int send(const char *name, MessageBuilder &msg);
+
+  // Serialize and send several related events in one pass. Every builder goes
+  // through a shared thread-local scratch buffer, so a batch costs no
+  // per-message flat-array allocation (send() heap-allocates one per call).
+  // Returns the number of messages accepted by their sockets.
+  int sendBatch(const std::vector<std::pair<const char *, MessageBuilder *>> &msgs);
+
+  // Lock-free multi-producer mode: sendAsync() may be called concurrently from
+  // any number of worker threads. Each thread stages serialized messages in its
+  // own SPSC ring; the socket-owning thread drains all rings with flushAsync()
+  // and performs the actual sends, so workers never touch a shared lock or the
+  // sockets. sendAsync() returns -1 if the caller's ring is full.
+  int sendAsync(const char *name, MessageBuilder &msg);
+  void flushAsync();
   ~PubMaster();
 
 private:
+  struct AsyncRing;
+  AsyncRing *asyncRing();
   std::map<std::string, PubSocket *> sockets_;
+  std::vector<std::shared_ptr<AsyncRing>> async_rings_;
+  std::mutex async_rings_lock_;  // taken only on first send from a new thread
 };
 
 class AlignedBuffer {
@@ -100,3 +221,64 @@ private:
   kj::Array<capnp::word> aligned_buf;
   size_t words_size;
 };
+
+// Zero-copy receive path for language bindings. Owns the received msgq
+// Message and exposes the payload bytes in place, so a binding can hand them
+// to the consumer as a buffer-protocol view (e.g. a Python memoryview)
+// instead of copying into an intermediate bytes object. The view stays valid
+// until release() or destruction; callers that outlive a view must release
+// explicitly so the msgq buffer is returned promptly. getEvent() parses
+// directly from the receive buffer when it is word-aligned, copying only for
+// the rare misaligned message — same policy as SubMaster::drainBatch().
+class ZeroCopyMessage {
+public:
+  explicit ZeroCopyMessage(Message *msg = nullptr) : msg_(msg) {}
+  ~ZeroCopyMessage() { release(); }
+  ZeroCopyMessage(const ZeroCopyMessage &) = delete;
+  ZeroCopyMessage &operator=(const ZeroCopyMessage &) = delete;
+  ZeroCopyMessage(ZeroCopyMessage &&other) noexcept { *this = std::move(other); }
+  ZeroCopyMessage &operator=(ZeroCopyMessage &&other) noexcept {
+    if (this != &other) {
+      release();
+      msg_ = other.msg_;
+      reader_ = std::move(other.reader_);
+      other.msg_ = nullptr;
+    }
+    return *this;
+  }
+
+  explicit operator bool() const { return msg_ != nullptr; }
+  const char *data() const { return msg_->getData(); }
+  size_t size() const { return msg_->getSize(); }
+
+  cereal::Event::Reader getEvent() {
+    if (!reader_) {
+      kj::ArrayPtr<const capnp::word> words;
+      if (reinterpret_cast<uintptr_t>(msg_->getData()) % sizeof(capnp::word) == 0) {
+        words = kj::ArrayPtr<const capnp::word>(reinterpret_cast<const capnp::word *>(msg_->getData()),
+                                                msg_->getSize() / sizeof(capnp::word));
+      } else {
+        words = aligned_.align(msg_);
+      }
+      reader_ = std::make_unique<capnp::FlatArrayMessageReader>(words);
+    }
+    return reader_->getRoot<cereal::Event>();
+  }
+
+  void release() {
+    reader_.reset();
+    delete msg_;
+    msg_ = nullptr;
+  }
+
+private:
+  Message *msg_ = nullptr;
+  std::unique_ptr<capnp::FlatArrayMessageReader> reader_;
+  AlignedBuffer aligned_;
+};
+
+// Blocking (or non-blocking) receive into a ZeroCopyMessage; evaluates false
+// on timeout.
+inline ZeroCopyMessage recvZeroCopy(SubSocket *sock, bool non_blocking = false) {
+  return ZeroCopyMessage(sock->receive(non_blocking));
+}
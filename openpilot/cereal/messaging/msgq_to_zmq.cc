@@ -10,46 +10,90 @@ extern ExitHandler do_exit;
 // Max messages to process per socket per poll
 constexpr int MAX_MESSAGES_PER_SOCKET = 50;
 
-static std::string recv_zmq_msg(void *sock) {
-  zmq_msg_t msg;
-  zmq_msg_init(&msg);
-  std::string ret;
-  if (zmq_msg_recv(&msg, sock, 0) > 0) {
-    ret.assign((char *)zmq_msg_data(&msg), zmq_msg_size(&msg));
-  }
-  zmq_msg_close(&msg);
-  return ret;
-}
+// Bulk mode coalesces all messages accumulated per poll tick into one
+// multi-part ZMQ message (one wire message instead of one send per msg).
+const bool BRIDGE_BULK = getenv("BRIDGE_BULK") != nullptr;
+
+// Delta-encode can/sendcan payloads against the previous message so remote
+// (LTE) subscribers don't pay full capnp CAN event size on the wire.
+const bool BRIDGE_CAN_DELTA = getenv("BRIDGE_CAN_DELTA") != nullptr;
+
+// Zstd-compress payloads on the wire; log-heavy topics shrink several-fold.
+// Video/audio endpoints and delta-encoded CAN are left alone.
+const bool BRIDGE_ZSTD = getenv("BRIDGE_ZSTD") != nullptr;
 
 void MsgqToZmq::run(const std::vector<std::string> &endpoints, const std::string &ip) {
   zmq_context = std::make_unique<BridgeZmqContext>();
   msgq_context = std::make_unique<Context>();
 
-  // Create ZMQPubSockets for each endpoint
+  // Create XPUB sockets for each endpoint. XPUB surfaces subscribe and
+  // unsubscribe frames as inbound messages, so the bridge only taps a msgq
+  // topic while a remote client is actually subscribed to it instead of
+  // forwarding everything to anyone who merely connects.
   for (const auto &endpoint : endpoints) {
     auto &socket_pair = socket_pairs.emplace_back();
     socket_pair.endpoint = endpoint;
+    socket_pair.delta = BRIDGE_CAN_DELTA && isCanDeltaEndpoint(endpoint);
+    socket_pair.zstd = BRIDGE_ZSTD && !socket_pair.delta && isZstdTransportEndpoint(endpoint);
     socket_pair.pub_sock = std::make_unique<BridgeZmqPubSocket>();
-    int ret = socket_pair.pub_sock->connect(zmq_context.get(), endpoint);
+    int ret = socket_pair.pub_sock->connect(zmq_context.get(), endpoint, true, true);
     if (ret != 0) {
       printf("Failed to create ZMQ publisher for [%s]: %s\n", endpoint.c_str(), zmq_strerror(zmq_errno()));
       return;
     }
   }
 
-  // Start ZMQ monitoring thread to monitor socket events
-  std::thread thread(&MsgqToZmq::zmqMonitorThread, this);
-
-  // Main loop for processing messages
+  // Main loop for processing messages. Everything happens on this thread:
+  // ZMQ sockets are not thread safe, and the subscription frames arrive on
+  // the same XPUB sockets the loop publishes on.
   while (!do_exit) {
-    {
-      std::unique_lock lk(mutex);
-      cv.wait(lk, [this]() { return do_exit || !sub2pub.empty(); });
-      if (do_exit) break;
-
-      for (auto sub_sock : msgq_poller->poll(100)) {
-        // Process messages for each socket
-        BridgeZmqPubSocket *pub_sock = sub2pub.at(sub_sock);
+    processSubscriptionEvents();
+    if (sub2pub.empty()) {
+      util::sleep_for(100);  // no remote subscribers; stay idle
+      continue;
+    }
+
+    for (auto sub_sock : msgq_poller->poll(100)) {
+      // Process messages for each socket
+      SocketPair *pair = sub2pub.at(sub_sock);
+      BridgeZmqPubSocket *pub_sock = pair->pub_sock.get();
+      if (pair->delta) {
+        for (int i = 0; i < MAX_MESSAGES_PER_SOCKET; ++i) {
+          auto msg = std::unique_ptr<Message>(sub_sock->receive(true));
+          if (!msg) break;
+
+          std::string encoded = pair->codec.encode(msg->getData(), msg->getSize());
+          while (pub_sock->send(encoded.data(), encoded.size()) == -1) {
+            if (errno != EINTR) break;
+          }
+        }
+      } else if (pair->zstd) {
+        for (int i = 0; i < MAX_MESSAGES_PER_SOCKET; ++i) {
+          auto msg = std::unique_ptr<Message>(sub_sock->receive(true));
+          if (!msg) break;
+
+          std::string encoded = pair->zstd_codec.encode(msg->getData(), msg->getSize());
+          while (pub_sock->send(encoded.data(), encoded.size()) == -1) {
+            if (errno != EINTR) break;
+          }
+        }
+      } else if (BRIDGE_BULK) {
+        // Drain the socket, then ship everything as one multi-part message
+        std::vector<std::unique_ptr<Message>> msgs;
+        for (int i = 0; i < MAX_MESSAGES_PER_SOCKET; ++i) {
+          auto msg = std::unique_ptr<Message>(sub_sock->receive(true));
+          if (!msg) break;
+          msgs.push_back(std::move(msg));
+        }
+        if (!msgs.empty()) {
+          std::vector<Message *> parts;
+          parts.reserve(msgs.size());
+          for (auto &m : msgs) parts.push_back(m.get());
+          while (pub_sock->sendMessageParts(parts) == -1) {
+            if (errno != EINTR) break;
+          }
+        }
+      } else {
         for (int i = 0; i < MAX_MESSAGES_PER_SOCKET; ++i) {
           auto msg = std::unique_ptr<Message>(sub_sock->receive(true));
           if (!msg) break;
@@ -60,80 +104,46 @@ void MsgqToZmq::run(const std::vector<std::string> &endpoints, const std::string
         }
       }
     }
-    util::sleep_for(1);  // Give zmqMonitorThread a chance to acquire the mutex
   }
-
-  thread.join();
 }
 
-void MsgqToZmq::zmqMonitorThread() {
-  std::vector<zmq_pollitem_t> pollitems;
-
-  // Set up ZMQ monitor for each pub socket
-  for (int i = 0; i < socket_pairs.size(); ++i) {
-    std::string addr = "inproc://op-bridge-monitor-" + std::to_string(i);
-    zmq_socket_monitor(socket_pairs[i].pub_sock->getRawSocket(), addr.c_str(), ZMQ_EVENT_ACCEPTED | ZMQ_EVENT_DISCONNECTED);
-
-    void *monitor_socket = zmq_socket(zmq_context->getRawContext(), ZMQ_PAIR);
-    zmq_connect(monitor_socket, addr.c_str());
-    pollitems.emplace_back(zmq_pollitem_t{.socket = monitor_socket, .events = ZMQ_POLLIN});
-  }
-
-  while (!do_exit) {
-    int ret = zmq_poll(pollitems.data(), pollitems.size(), 1000);
-    if (ret < 0) {
-      if (errno == EINTR) {
-        // Due to frequent EINTR signals from msgq, introduce a brief delay (200 ms)
-        // to reduce CPU usage during retry attempts.
-        util::sleep_for(200);
-      }
-      continue;
-    }
-
-    for (int i = 0; i < pollitems.size(); ++i) {
-      if (pollitems[i].revents & ZMQ_POLLIN) {
-        // First frame in message contains event number and value
-        std::string frame = recv_zmq_msg(pollitems[i].socket);
-        if (frame.empty()) continue;
-
-        uint16_t event_type = *(uint16_t *)(frame.data());
-
-        // Second frame in message contains event address
-        frame = recv_zmq_msg(pollitems[i].socket);
-        if (frame.empty()) continue;
-
-        std::unique_lock lk(mutex);
-        auto &pair = socket_pairs[i];
-        if (event_type & ZMQ_EVENT_ACCEPTED) {
-          printf("socket [%s] connected\n", pair.endpoint.c_str());
-          if (++pair.connected_clients == 1) {
-            // Create new MSGQ subscriber socket and map to ZMQ publisher
-            pair.sub_sock = std::make_unique<MSGQSubSocket>();
-            size_t queue_size = services.at(pair.endpoint).queue_size;
-            pair.sub_sock->connect(msgq_context.get(), pair.endpoint, "127.0.0.1", false, true, queue_size);
-            sub2pub[pair.sub_sock.get()] = pair.pub_sock.get();
-            registerSockets();
-          }
-        } else if (event_type & ZMQ_EVENT_DISCONNECTED) {
-          printf("socket [%s] disconnected\n", pair.endpoint.c_str());
-          if (pair.connected_clients == 0 || --pair.connected_clients == 0) {
-            // Remove MSGQ subscriber socket from mapping and reset it
-            sub2pub.erase(pair.sub_sock.get());
-            pair.sub_sock.reset(nullptr);
-            registerSockets();
-          }
+void MsgqToZmq::processSubscriptionEvents() {
+  for (auto &pair : socket_pairs) {
+    while (true) {
+      // XPUB delivers one frame per (un)subscription: a 0/1 byte followed by
+      // the topic. Each endpoint is its own socket, so the topic is empty and
+      // the byte is all that matters. ZMQ_XPUB_VERBOSER keeps duplicates, so
+      // the count below tracks the number of remote subscribers exactly; a
+      // subscriber that drops its TCP connection generates an unsubscribe.
+      zmq_msg_t msg;
+      zmq_msg_init(&msg);
+      int ret = zmq_msg_recv(&msg, pair.pub_sock->getRawSocket(), ZMQ_DONTWAIT);
+      const bool subscribe = ret > 0 && ((uint8_t *)zmq_msg_data(&msg))[0] == 1;
+      const bool unsubscribe = ret > 0 && ((uint8_t *)zmq_msg_data(&msg))[0] == 0;
+      zmq_msg_close(&msg);
+      if (ret < 0) break;
+
+      if (subscribe) {
+        printf("socket [%s] subscribed\n", pair.endpoint.c_str());
+        if (++pair.subscribed_clients == 1) {
+          // Create new MSGQ subscriber socket and map to ZMQ publisher
+          pair.sub_sock = std::make_unique<MSGQSubSocket>();
+          size_t queue_size = services.at(pair.endpoint).queue_size;
+          pair.sub_sock->connect(msgq_context.get(), pair.endpoint, "127.0.0.1", false, true, queue_size);
+          sub2pub[pair.sub_sock.get()] = &pair;
+          registerSockets();
+        }
+      } else if (unsubscribe) {
+        printf("socket [%s] unsubscribed\n", pair.endpoint.c_str());
+        if (pair.subscribed_clients > 0 && --pair.subscribed_clients == 0) {
+          // Remove MSGQ subscriber socket from mapping and reset it
+          sub2pub.erase(pair.sub_sock.get());
+          pair.sub_sock.reset(nullptr);
+          registerSockets();
         }
-        cv.notify_one();
       }
     }
   }
-
-  // Clean up monitor sockets
-  for (int i = 0; i < pollitems.size(); ++i) {
-    zmq_socket_monitor(socket_pairs[i].pub_sock->getRawSocket(), nullptr, 0);
-    zmq_close(pollitems[i].socket);
-  }
-  cv.notify_one();
 }
 
 void MsgqToZmq::registerSockets() {
@@ -1,14 +1,14 @@
 #pragma once
 
-#include <condition_variable>
 #include <map>
 #include <memory>
-#include <mutex>
 #include <string>
 #include <vector>
 
 #include "msgq/impl_msgq.h"
 #include "openpilot/cereal/messaging/bridge_zmq.h"
+#include "openpilot/cereal/messaging/can_delta.h"
+#include "openpilot/cereal/messaging/zstd_transport.h"
 
 class MsgqToZmq {
 public:
@@ -17,20 +17,22 @@ public:
 
 protected:
   void registerSockets();
-  void zmqMonitorThread();
+  void processSubscriptionEvents();
 
   struct SocketPair {
     std::string endpoint;
     std::unique_ptr<BridgeZmqPubSocket> pub_sock;
     std::unique_ptr<MSGQSubSocket> sub_sock;
-    int connected_clients = 0;
+    int subscribed_clients = 0;
+    bool delta = false;  // delta-encode CAN payloads on the wire
+    CanDeltaCodec codec;
+    bool zstd = false;  // zstd-compress payloads on the wire
+    ZstdTransportCodec zstd_codec;
   };
 
   std::unique_ptr<Context> msgq_context;
   std::unique_ptr<BridgeZmqContext> zmq_context;
-  std::mutex mutex;
-  std::condition_variable cv;
   std::unique_ptr<MSGQPoller> msgq_poller;
-  std::map<SubSocket *, BridgeZmqPubSocket *> sub2pub;
+  std::map<SubSocket *, SocketPair *> sub2pub;
   std::vector<SocketPair> socket_pairs;
 };
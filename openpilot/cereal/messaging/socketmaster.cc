@@ -1,5 +1,6 @@
 #include <assert.h>
 #include <stdlib.h>
+#include <algorithm>
 #include <string>
 #include <mutex>
 
@@ -7,6 +8,13 @@
 #include "openpilot/cereal/messaging/messaging.h"
 
 const bool SIMULATION = (getenv("SIMULATION") != nullptr) && (std::string(getenv("SIMULATION")) == "1");
+const bool SUBMASTER_PERF = (getenv("SUBMASTER_PERF") != nullptr) && (std::string(getenv("SUBMASTER_PERF")) == "1");
+
+static inline int log2_bucket(uint64_t v, int max_bucket) {
+  int b = 0;
+  while (v >>= 1) b++;
+  return b < max_bucket ? b : max_bucket - 1;
+}
 
 static inline bool inList(const std::vector<const char *> &list, const char *value) {
   for (auto &v : list) {
@@ -35,35 +43,42 @@ struct SubMaster::SubMessage {
   SubSocket *socket = nullptr;
   float freq = 0.0f;
   bool updated = false, alive = false, valid = false, ignore_alive;
+  bool latest_only = false;
   uint64_t rcv_time = 0, rcv_frame = 0;
   void *allocated_msg_reader = nullptr;
   bool is_polled = false;
   capnp::FlatArrayMessageReader *msg_reader = nullptr;
+  // receive buffer the current reader parses in place; only misaligned
+  // messages fall back to a copy through aligned_buf
+  Message *held_msg = nullptr;
   AlignedBuffer aligned_buf;
   cereal::Event::Reader event;
+  SubMaster::PerfSnapshot perf;
 };
 
 SubMaster::SubMaster(const std::vector<const char *> &service_list, const std::vector<const char *> &poll,
-                     const char *address, const std::vector<const char *> &ignore_alive) {
+                     const char *address, const std::vector<const char *> &ignore_alive,
+                     const std::vector<const char *> &latest_only) {
   poller_ = Poller::create();
   for (auto name : service_list) {
-    assert(services.count(std::string(name)) > 0);
-
-    service serv = services.at(std::string(name));
-    SubSocket *socket = SubSocket::create(message_context.context(), name, address ? address : "127.0.0.1", true, true, serv.queue_size);
+    const service_entry *serv = find_service(name);
+    assert(serv != nullptr);
+    SubSocket *socket = SubSocket::create(message_context.context(), name, address ? address : "127.0.0.1", true, true, serv->queue_size);
     assert(socket != 0);
     bool is_polled = inList(poll, name) || poll.empty();
     if (is_polled) poller_->registerSocket(socket);
     SubMessage *m = new SubMessage{
       .name = name,
       .socket = socket,
-      .freq = serv.frequency,
+      .freq = serv->frequency,
       .ignore_alive = inList(ignore_alive, name),
+      .latest_only = inList(latest_only, name),
       .allocated_msg_reader = malloc(sizeof(capnp::FlatArrayMessageReader)),
       .is_polled = is_polled};
     m->msg_reader = new (m->allocated_msg_reader) capnp::FlatArrayMessageReader({});
     messages_[socket] = m;
     services_[name] = m;
+    alive_ok_count_ += m->ignore_alive;
   }
 }
 
@@ -89,17 +104,66 @@ void SubMaster::update(int timeout) {
 
     SubMessage *m = messages_.at(s);
 
+    if (m->latest_only) {
+      // skip to the newest queued message; only the last one gets decoded
+      while (Message *newer = s->receive(true)) {
+        delete msg;
+        msg = newer;
+      }
+    }
+
     m->msg_reader->~FlatArrayMessageReader();
     capnp::ReaderOptions options;
     options.traversalLimitInWords = kj::maxValue; // Don't limit
-    m->msg_reader = new (m->allocated_msg_reader) capnp::FlatArrayMessageReader(m->aligned_buf.align(msg), options);
-    delete msg;
+    // capnp requires word-aligned data. msgq buffers usually are, so the
+    // reader parses the receive buffer in place and the buffer is held until
+    // the next message replaces it; only misaligned messages get copied.
+    kj::ArrayPtr<const capnp::word> words;
+    if (reinterpret_cast<uintptr_t>(msg->getData()) % sizeof(capnp::word) == 0) {
+      words = kj::ArrayPtr<const capnp::word>((const capnp::word *)msg->getData(), msg->getSize() / sizeof(capnp::word));
+      delete m->held_msg;
+      m->held_msg = msg;
+    } else {
+      words = m->aligned_buf.align(msg);
+      delete msg;
+      delete m->held_msg;
+      m->held_msg = nullptr;
+    }
+    m->msg_reader = new (m->allocated_msg_reader) capnp::FlatArrayMessageReader(words, options);
     messages.push_back({m->name, m->msg_reader->getRoot<cereal::Event>()});
+
+    if (SUBMASTER_PERF) {
+      uint64_t latency = nanos_since_boot() - current_time;
+      m->perf.count++;
+      m->perf.max_latency_ns = std::max(m->perf.max_latency_ns, latency);
+      m->perf.latency_buckets[log2_bucket(latency, 32)]++;
+      m->perf.msgs_per_cycle_buckets[log2_bucket(1, 16)]++;
+    }
   }
 
   update_msgs(current_time, messages);
 }
 
+int SubMaster::adaptiveTimeout(int max_timeout) const {
+  uint64_t now = nanos_since_boot();
+  uint64_t deadline = UINT64_MAX;
+  for (auto &kv : messages_) {
+    const SubMessage *m = kv.second;
+    if (!m->is_polled || m->freq <= 1e-5) continue;
+    uint64_t period = (uint64_t)(1e9 / m->freq);
+    // a never-seen service could publish anytime within one period from now
+    uint64_t base = m->rcv_time > 0 ? m->rcv_time : now;
+    uint64_t d = base + period;
+    // an overdue service (stalled publisher or a late message) gets a fresh
+    // period from now, so waiting on it costs a bounded poll rate, not a spin
+    if (d <= now) d = now + period;
+    deadline = std::min(deadline, d);
+  }
+  if (deadline == UINT64_MAX) return max_timeout;
+  // floor at 1 ms so sub-ms remainders don't truncate into a busy loop
+  return std::clamp((int)((deadline - now) / 1000000ULL), 1, max_timeout);
+}
+
 void SubMaster::update_msgs(uint64_t current_time, const std::vector<std::pair<std::string, cereal::Event::Reader>> &messages){
   if (++frame == UINT64_MAX) frame = 1;
 
@@ -113,19 +177,47 @@ void SubMaster::update_msgs(uint64_t current_time, const std::vector<std::pair<s
     m->updated = true;
     m->rcv_time = current_time;
     m->rcv_frame = frame;
+
+    bool was_valid = m->valid;
     m->valid = m->event.getValid();
-    if (SIMULATION) m->alive = true;
+    valid_count_ += (int)m->valid - (int)was_valid;
+
+    bool was_ok = m->alive || m->ignore_alive;
+    if (SIMULATION) {
+      m->alive = true;
+    } else {
+      // a fresh message always makes the service alive and extends its deadline
+      m->alive = true;
+      if (m->freq > 1e-5) {
+        next_alive_check_ = std::min(next_alive_check_, m->rcv_time + (uint64_t)(10.0 / m->freq * 1e9));
+      }
+    }
+    alive_ok_count_ += (int)(m->alive || m->ignore_alive) - (int)was_ok;
   }
 
-  if (!SIMULATION) {
+  // Only rescan every service once the earliest staleness deadline has passed;
+  // otherwise no alive flag can have flipped and the dirty set above suffices.
+  if (!SIMULATION && current_time >= next_alive_check_) {
+    next_alive_check_ = UINT64_MAX;
+    alive_ok_count_ = 0;
     for (auto &kv : messages_) {
       SubMessage *m = kv.second;
       m->alive = (m->freq <= (1e-5) || ((current_time - m->rcv_time) * (1e-9)) < (10.0 / m->freq));
+      if (m->alive && m->freq > 1e-5) {
+        next_alive_check_ = std::min(next_alive_check_, m->rcv_time + (uint64_t)(10.0 / m->freq * 1e9));
+      }
+      alive_ok_count_ += m->alive || m->ignore_alive;
     }
   }
 }
 
 bool SubMaster::all_(const std::vector<const char *> &service_list, bool valid, bool alive) {
+  if (service_list.empty()) {
+    // cached aggregates, maintained incrementally by update_msgs()
+    return (!valid || valid_count_ == messages_.size()) &&
+           (!alive || alive_ok_count_ == messages_.size());
+  }
+
   int found = 0;
   for (auto &kv : messages_) {
     SubMessage *m = kv.second;
@@ -136,6 +228,71 @@ bool SubMaster::all_(const std::vector<const char *> &service_list, bool valid,
   return service_list.size() == 0 ? found == messages_.size() : found == service_list.size();
 }
 
+const std::vector<SubMaster::DrainedEvent> &SubMaster::drainBatch(int timeout) {
+  releaseDrained();
+
+  auto sockets = poller_->poll(timeout);
+  for (auto &kv : messages_) {
+    if (!kv.second->is_polled) sockets.push_back(kv.first);
+  }
+
+  capnp::ReaderOptions options;
+  options.traversalLimitInWords = kj::maxValue;  // Don't limit
+
+  uint64_t wakeup_time = SUBMASTER_PERF ? nanos_since_boot() : 0;
+
+  for (auto s : sockets) {
+    SubMessage *m = messages_.at(s);
+    int drained = 0;
+    while (Message *msg = s->receive(true)) {
+      drained++;
+      drained_msgs_.emplace_back(msg);
+
+      // capnp requires word-aligned data. msgq buffers usually are; only copy when not.
+      kj::ArrayPtr<const capnp::word> words;
+      const char *data = msg->getData();
+      const size_t size = msg->getSize();
+      if (reinterpret_cast<uintptr_t>(data) % sizeof(capnp::word) == 0) {
+        words = kj::ArrayPtr<const capnp::word>((const capnp::word *)data, size / sizeof(capnp::word));
+      } else {
+        auto &copy = drained_copies_.emplace_back(kj::heapArray<capnp::word>(size / sizeof(capnp::word) + 1));
+        memcpy(copy.begin(), data, size);
+        words = copy.asPtr();
+      }
+
+      auto &reader = drained_readers_.emplace_back(std::make_unique<capnp::FlatArrayMessageReader>(words, options));
+      drained_events_.push_back({m->name, reader->getRoot<cereal::Event>()});
+    }
+
+    if (SUBMASTER_PERF && drained > 0) {
+      uint64_t latency = nanos_since_boot() - wakeup_time;
+      m->perf.count += drained;
+      m->perf.max_latency_ns = std::max(m->perf.max_latency_ns, latency);
+      m->perf.latency_buckets[log2_bucket(latency, 32)]++;
+      m->perf.msgs_per_cycle_buckets[log2_bucket(drained, 16)]++;
+    }
+  }
+
+  return drained_events_;
+}
+
+std::vector<SubMaster::PerfSnapshot> SubMaster::perfSnapshot() const {
+  std::vector<PerfSnapshot> ret;
+  for (auto &kv : services_) {
+    PerfSnapshot snap = kv.second->perf;
+    snap.name = kv.first;
+    ret.push_back(snap);
+  }
+  return ret;
+}
+
+void SubMaster::releaseDrained() {
+  drained_events_.clear();
+  drained_readers_.clear();
+  drained_copies_.clear();
+  drained_msgs_.clear();
+}
+
 void SubMaster::drain() {
   while (true) {
     auto polls = poller_->poll(0);
@@ -179,6 +336,7 @@ SubMaster::~SubMaster() {
     SubMessage *m = kv.second;
     m->msg_reader->~FlatArrayMessageReader();
     free(m->allocated_msg_reader);
+    delete m->held_msg;
     delete m->socket;
     delete m;
   }
@@ -186,9 +344,9 @@ SubMaster::~SubMaster() {
 
 PubMaster::PubMaster(const std::vector<const char *> &service_list) {
   for (auto name : service_list) {
-    assert(services.count(name) > 0);
-    service serv = services.at(std::string(name));
-    PubSocket *socket = PubSocket::create(message_context.context(), name, true, serv.queue_size);
+    const service_entry *serv = find_service(name);
+    assert(serv != nullptr);
+    PubSocket *socket = PubSocket::create(message_context.context(), name, true, serv->queue_size);
     assert(socket);
     sockets_[name] = socket;
   }
@@ -199,6 +357,78 @@ int PubMaster::send(const char *name, MessageBuilder &msg) {
   return send(name, bytes.begin(), bytes.size());
 }
 
+int PubMaster::sendBatch(const std::vector<std::pair<const char *, MessageBuilder *>> &msgs) {
+  // one scratch buffer serves the whole batch; it only ever grows to the
+  // largest event this thread publishes, so steady state is allocation-free
+  static thread_local std::vector<capnp::byte> scratch;
+  int sent = 0;
+  for (const auto &[name, msg] : msgs) {
+    const size_t size = msg->getSerializedSize();
+    if (scratch.size() < size) scratch.resize(size);
+    const int serialized = msg->serializeToBuffer(scratch.data(), scratch.size());
+    if (serialized < 0) continue;
+    if (send(name, scratch.data(), static_cast<size_t>(serialized)) >= 0) sent++;
+  }
+  return sent;
+}
+
+// Single-producer/single-consumer staging ring. The owning worker thread is
+// the only producer, the flushAsync() caller the only consumer, so head/tail
+// only need acquire/release ordering and no locks.
+struct PubMaster::AsyncRing {
+  static constexpr size_t SIZE = 64;  // power of two
+  struct Slot {
+    std::string name;
+    std::vector<char> data;
+  };
+  Slot slots[SIZE];
+  std::atomic<uint64_t> head{0};  // consumer position
+  std::atomic<uint64_t> tail{0};  // producer position
+
+  bool push(const char *name, kj::ArrayPtr<capnp::byte> bytes) {
+    uint64_t t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) >= SIZE) return false;
+    Slot &slot = slots[t % SIZE];
+    slot.name = name;
+    slot.data.assign(bytes.begin(), bytes.end());
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+};
+
+PubMaster::AsyncRing *PubMaster::asyncRing() {
+  static thread_local std::map<PubMaster *, std::shared_ptr<AsyncRing>> rings;
+  auto &ring = rings[this];
+  if (!ring) {
+    ring = std::make_shared<AsyncRing>();
+    std::lock_guard lk(async_rings_lock_);
+    async_rings_.push_back(ring);
+  }
+  return ring.get();
+}
+
+int PubMaster::sendAsync(const char *name, MessageBuilder &msg) {
+  assert(sockets_.count(name) > 0);
+  return asyncRing()->push(name, msg.toBytes()) ? 0 : -1;
+}
+
+void PubMaster::flushAsync() {
+  std::vector<std::shared_ptr<AsyncRing>> rings;
+  {
+    std::lock_guard lk(async_rings_lock_);
+    rings = async_rings_;
+  }
+  for (auto &ring : rings) {
+    uint64_t h = ring->head.load(std::memory_order_relaxed);
+    uint64_t t = ring->tail.load(std::memory_order_acquire);
+    for (; h != t; ++h) {
+      AsyncRing::Slot &slot = ring->slots[h % AsyncRing::SIZE];
+      send(slot.name.c_str(), (capnp::byte *)slot.data.data(), slot.data.size());
+    }
+    ring->head.store(h, std::memory_order_release);
+  }
+}
+
 PubMaster::~PubMaster() {
   for (auto s : sockets_) delete s.second;
 }
@@ -0,0 +1,213 @@
+// Micro-benchmark for the C++ messaging hot path.
+//
+// Measures PubMaster::send and SubMaster::update throughput and latency
+// distributions across message sizes and subscriber counts, plus the
+// zero-copy receive and batched send/drain modes, so IPC regressions show
+// up in a number before they hit the fleet. Human-readable results go to
+// stderr; one JSON document goes to stdout for trend tracking.
+//
+//   ./bench_messaging [iters-per-scenario]
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "json11/json11.hpp"
+
+#include "common/timing.h"
+#include "openpilot/cereal/messaging/messaging.h"
+
+namespace {
+
+// takes arbitrary payload bytes, so one service covers every size under test
+const char *SERVICE = "customReservedRawData0";
+
+struct LatencyStats {
+  double per_msg_ns, p50_ns, p99_ns, max_ns;
+};
+
+LatencyStats computeStats(std::vector<uint64_t> &samples) {
+  std::sort(samples.begin(), samples.end());
+  double total = 0;
+  for (uint64_t s : samples) total += s;
+  auto pct = [&](double p) { return (double)samples[std::min(samples.size() - 1, (size_t)(p * samples.size()))]; };
+  return {total / samples.size(), pct(0.50), pct(0.99), (double)samples.back()};
+}
+
+json11::Json::object report(const char *name, size_t msg_size, int subscribers, std::vector<uint64_t> &samples) {
+  LatencyStats s = computeStats(samples);
+  fprintf(stderr, "%-16s size %7zu  subs %d  %9.0f msgs/sec  %7.2f MB/sec  p50 %6.0fns  p99 %7.0fns  max %8.0fns\n",
+          name, msg_size, subscribers, 1e9 / s.per_msg_ns, msg_size * 1e3 / s.per_msg_ns, s.p50_ns, s.p99_ns, s.max_ns);
+  return json11::Json::object{
+      {"name", name},
+      {"msg_size", (int)msg_size},
+      {"subscribers", subscribers},
+      {"msgs_per_sec", 1e9 / s.per_msg_ns},
+      {"mb_per_sec", msg_size * 1e3 / s.per_msg_ns},
+      {"p50_ns", s.p50_ns},
+      {"p99_ns", s.p99_ns},
+      {"max_ns", s.max_ns},
+  };
+}
+
+void fillEvent(MessageBuilder &msg, const std::vector<uint8_t> &payload) {
+  auto event = msg.initEvent();
+  event.setCustomReservedRawData0(kj::ArrayPtr<const capnp::byte>(payload.data(), payload.size()));
+}
+
+// PubMaster::send cost as message size and registered reader count grow
+void benchSend(int iters, const std::vector<size_t> &sizes, const std::vector<int> &sub_counts,
+               json11::Json::array &out) {
+  for (int subs : sub_counts) {
+    std::unique_ptr<Context> ctx(Context::create());
+    std::vector<std::unique_ptr<SubSocket>> readers;
+    for (int i = 0; i < subs; ++i) {
+      readers.emplace_back(SubSocket::create(ctx.get(), SERVICE));
+    }
+
+    PubMaster pm({SERVICE});
+    for (size_t size : sizes) {
+      std::vector<uint8_t> payload(size, 0xa5);
+      std::vector<uint64_t> lat;
+      lat.reserve(iters);
+      for (int i = 0; i < iters; ++i) {
+        PooledMessageBuilder msg;
+        fillEvent(msg, payload);
+        uint64_t t0 = nanos_since_boot();
+        pm.send(SERVICE, msg);
+        lat.push_back(nanos_since_boot() - t0);
+      }
+      out.push_back(report("send", size, subs, lat));
+    }
+  }
+}
+
+// serialize-and-send of several related events in one sendBatch pass
+void benchSendBatch(int iters, json11::Json::array &out) {
+  const int batch = 8;
+  const size_t size = 2048;
+  std::vector<uint8_t> payload(size, 0xa5);
+
+  PubMaster pm({SERVICE});
+  std::vector<uint64_t> lat;
+  lat.reserve(iters);
+  for (int i = 0; i < iters / batch; ++i) {
+    PooledMessageBuilder msgs[batch];
+    std::vector<std::pair<const char *, MessageBuilder *>> batch_msgs;
+    for (auto &msg : msgs) {
+      fillEvent(msg, payload);
+      batch_msgs.emplace_back(SERVICE, &msg);
+    }
+    uint64_t t0 = nanos_since_boot();
+    pm.sendBatch(batch_msgs);
+    lat.push_back((nanos_since_boot() - t0) / batch);
+  }
+  out.push_back(report("send_batch", size, 0, lat));
+}
+
+// publish-to-decoded latency through a SubMaster::update cycle
+void benchUpdate(int iters, const std::vector<size_t> &sizes, json11::Json::array &out) {
+  for (size_t size : sizes) {
+    SubMaster sm({SERVICE});
+    PubMaster pm({SERVICE});
+    std::vector<uint8_t> payload(size, 0xa5);
+
+    std::vector<uint64_t> lat;
+    lat.reserve(iters);
+    for (int i = 0; i < iters; ++i) {
+      PooledMessageBuilder msg;
+      fillEvent(msg, payload);
+      uint64_t t0 = nanos_since_boot();
+      pm.send(SERVICE, msg);
+      sm.update(100);
+      lat.push_back(nanos_since_boot() - t0);
+      assert(i == 0 || sm.updated(SERVICE));
+    }
+    out.push_back(report("pub_to_update", size, 1, lat));
+  }
+}
+
+// burst drain through the batched path, no per-message aligned copy
+void benchDrainBatch(int iters, json11::Json::array &out) {
+  const int burst = 32;
+  const size_t size = 2048;
+  std::vector<uint8_t> payload(size, 0xa5);
+
+  SubMaster sm({SERVICE});
+  PubMaster pm({SERVICE});
+  std::vector<uint64_t> lat;
+  lat.reserve(iters);
+  for (int i = 0; i < iters / burst; ++i) {
+    for (int b = 0; b < burst; ++b) {
+      PooledMessageBuilder msg;
+      fillEvent(msg, payload);
+      pm.send(SERVICE, msg);
+    }
+    uint64_t t0 = nanos_since_boot();
+    const auto &events = sm.drainBatch(100);
+    uint64_t dt = nanos_since_boot() - t0;
+    assert(!events.empty());
+    for (size_t e = 0; e < events.size(); ++e) {
+      lat.push_back(dt / events.size());
+    }
+    sm.releaseDrained();
+  }
+  out.push_back(report("drain_batch", size, 1, lat));
+}
+
+// raw socket receive + in-place parse through ZeroCopyMessage
+void benchZeroCopy(int iters, const std::vector<size_t> &sizes, json11::Json::array &out) {
+  for (size_t size : sizes) {
+    std::unique_ptr<Context> ctx(Context::create());
+    std::unique_ptr<SubSocket> sock(SubSocket::create(ctx.get(), SERVICE));
+    PubMaster pm({SERVICE});
+    std::vector<uint8_t> payload(size, 0xa5);
+
+    std::vector<uint64_t> lat;
+    lat.reserve(iters);
+    for (int i = 0; i < iters; ++i) {
+      PooledMessageBuilder msg;
+      fillEvent(msg, payload);
+      pm.send(SERVICE, msg);
+      uint64_t t0 = nanos_since_boot();
+      ZeroCopyMessage m = recvZeroCopy(sock.get());
+      assert(m);
+      auto event = m.getEvent();
+      (void)event.getLogMonoTime();
+      lat.push_back(nanos_since_boot() - t0);
+    }
+    out.push_back(report("recv_zero_copy", size, 1, lat));
+  }
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  int iters = argc > 1 ? atoi(argv[1]) : 20000;
+  assert(iters > 0);
+
+  // keep bench traffic out of a live device's queues
+  if (getenv("OPENPILOT_PREFIX") == nullptr) {
+    setenv("OPENPILOT_PREFIX", "bench_messaging", 1);
+  }
+
+  const std::vector<size_t> sizes = {64, 2048, 32768, 262144};
+  json11::Json::array scenarios;
+
+  benchSend(iters, sizes, {0, 1, 4}, scenarios);
+  benchSendBatch(iters, scenarios);
+  benchUpdate(iters, sizes, scenarios);
+  benchDrainBatch(iters, scenarios);
+  benchZeroCopy(iters, sizes, scenarios);
+
+  json11::Json results = json11::Json::object{
+      {"iters", iters},
+      {"scenarios", scenarios},
+  };
+  printf("%s\n", results.dump().c_str());
+  return 0;
+}
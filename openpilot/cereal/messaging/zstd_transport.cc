@@ -0,0 +1,73 @@
+#include "openpilot/cereal/messaging/zstd_transport.h"
+
+#include <utility>
+
+extern "C" {
+#include <zstd.h>
+}
+
+// Frame layout:
+//   'R' + raw bytes        - raw fallback (incompressible payload)
+//   'Z' + zstd frame       - one independent zstd frame per message
+
+bool isZstdTransportEndpoint(const std::string &endpoint) {
+  return endpoint.find("EncodeData") == std::string::npos && endpoint != "rawAudioData";
+}
+
+ZstdTransportCodec::~ZstdTransportCodec() {
+  ZSTD_freeCCtx((ZSTD_CCtx *)cctx_);
+  ZSTD_freeDCtx((ZSTD_DCtx *)dctx_);
+}
+
+ZstdTransportCodec::ZstdTransportCodec(ZstdTransportCodec &&other) noexcept {
+  *this = std::move(other);
+}
+
+ZstdTransportCodec &ZstdTransportCodec::operator=(ZstdTransportCodec &&other) noexcept {
+  if (this != &other) {
+    std::swap(cctx_, other.cctx_);
+    std::swap(dctx_, other.dctx_);
+  }
+  return *this;
+}
+
+std::string ZstdTransportCodec::encode(const char *data, size_t size) {
+  if (cctx_ == nullptr) {
+    cctx_ = ZSTD_createCCtx();
+  }
+  std::string out(1 + ZSTD_compressBound(size), '\0');
+  out[0] = 'Z';
+  // level 1: the bridge shares a core with the stream it forwards, and the
+  // link is the bottleneck, not the ratio
+  const size_t n = ZSTD_compressCCtx((ZSTD_CCtx *)cctx_, out.data() + 1, out.size() - 1, data, size, 1);
+  if (ZSTD_isError(n) || n + 1 >= size + 1) {
+    out.assign(1, 'R');
+    out.append(data, size);
+    return out;
+  }
+  out.resize(n + 1);
+  return out;
+}
+
+bool ZstdTransportCodec::decode(const char *data, size_t size, std::string *out) {
+  if (size < 1) {
+    return false;
+  }
+  if (data[0] == 'R') {
+    out->assign(data + 1, size - 1);
+    return true;
+  }
+  if (data[0] != 'Z') {
+    return false;
+  }
+  const unsigned long long raw_size = ZSTD_getFrameContentSize(data + 1, size - 1);
+  if (raw_size == ZSTD_CONTENTSIZE_ERROR || raw_size == ZSTD_CONTENTSIZE_UNKNOWN || raw_size > (1ULL << 31)) {
+    return false;
+  }
+  if (dctx_ == nullptr) {
+    dctx_ = ZSTD_createDCtx();
+  }
+  out->resize(static_cast<size_t>(raw_size));
+  const size_t n = ZSTD_decompressDCtx((ZSTD_DCtx *)dctx_, out->data(), out->size(), data + 1, size - 1);
+  return !ZSTD_isError(n) && n == raw_size;
+}
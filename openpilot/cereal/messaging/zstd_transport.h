@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Per-endpoint zstd codec for the msgq<->zmq bridge. capnp events are full of
+// zero padding and repeated field layouts, so log-heavy topics compress
+// several-fold on the wire. Every message is its own zstd frame — PUB/SUB can
+// drop messages, so the codec never carries inter-message state the way a
+// streaming window would — with a raw fallback whenever compression does not
+// actually shrink the payload.
+
+class ZstdTransportCodec {
+public:
+  ZstdTransportCodec() = default;
+  ~ZstdTransportCodec();
+  ZstdTransportCodec(const ZstdTransportCodec &) = delete;
+  ZstdTransportCodec &operator=(const ZstdTransportCodec &) = delete;
+  ZstdTransportCodec(ZstdTransportCodec &&other) noexcept;
+  ZstdTransportCodec &operator=(ZstdTransportCodec &&other) noexcept;
+
+  // Compresses data into a tagged frame; falls back to a raw frame when the
+  // compressed form would not be smaller.
+  std::string encode(const char *data, size_t size);
+
+  // Inverse of encode(); returns false on a malformed frame.
+  bool decode(const char *data, size_t size, std::string *out);
+
+private:
+  // ZSTD_CCtx / ZSTD_DCtx, opaque here so zstd.h stays out of the header;
+  // reused across messages to keep per-message allocations off the hot path
+  void *cctx_ = nullptr;
+  void *dctx_ = nullptr;
+};
+
+// Video and audio payloads are already entropy-coded and only get bigger;
+// those endpoints skip the codec entirely.
+bool isZstdTransportEndpoint(const std::string &endpoint);
@@ -28,6 +28,7 @@ _services: dict[str, tuple] = {
   "deviceState": (True, 2., 1),
   "touch": (True, 20., 1),
   "can": (True, 100., 2053, QueueSize.BIG),  # decimation gives ~3 msgs in a full segment
+  "canFiltered": (False, 100., None, QueueSize.BIG),  # pandad-side tap of can, gated on CanFilterIds
   "controlsState": (True, 100., 10, QueueSize.MEDIUM),
   "selfdriveState": (True, 100., 10),
   "pandaStates": (True, 10., 1),
@@ -49,6 +50,8 @@ _services: dict[str, tuple] = {
   "lateralManeuverPlan": (True, 20.),
   "driverAssistance": (True, 20., 20),
   "procLog": (True, 0.5, 15, QueueSize.BIG),
+  "selfMetrics": (True, 1., 60),
+  "cameraTimings": (True, 1., 60),
   "gpsLocationExternal": (True, 10., 10),
   "gpsLocation": (True, 1., 1),
   "ubloxGnss": (True, 10.),
@@ -59,6 +62,8 @@ _services: dict[str, tuple] = {
   "liveParameters": (True, 20., 5),
   "cameraOdometry": (True, 20., 10),
   "thumbnail": (True, 1 / 60., 1),
+  "cameraSnapshotRequest": (True, 0.),
+  "cameraSnapshot": (True, 0., 1, QueueSize.MEDIUM),
   "onroadEvents": (True, 1., 1),
   "carParams": (True, 0.02, 1),
   "roadCameraState": (True, 20., 20),
@@ -104,6 +109,8 @@ def build_header():
   h += "#ifndef __SERVICES_H\n"
   h += "#define __SERVICES_H\n"
 
+  h += "#include <cstddef>\n"
+  h += "#include <cstdint>\n"
   h += "#include <map>\n"
   h += "#include <string>\n"
 
@@ -116,6 +123,41 @@ def build_header():
          (k, k, should_log, v.frequency, decimation, v.queue_size)
   h += "};\n"
 
+  # the same table as a constexpr array: lookups with literal names resolve at
+  # compile time (and a typo'd name fails the build when forced constexpr),
+  # and runtime lookup is a pointer walk with no map, string, or hashing
+  h += "struct service_entry { const char *name; uint64_t name_hash; bool should_log; float frequency; int decimation; size_t queue_size; };\n"
+  h += "constexpr uint64_t service_name_hash(const char *name) {\n"
+  h += "  uint64_t value = 1469598103934665603ULL;  // FNV-1a\n"
+  h += "  for (; *name != '\\0'; ++name) {\n"
+  h += "    value ^= static_cast<uint64_t>(static_cast<unsigned char>(*name));\n"
+  h += "    value *= 1099511628211ULL;\n"
+  h += "  }\n"
+  h += "  return value;\n"
+  h += "}\n"
+  h += "constexpr service_entry service_table[] = {\n"
+  for k, v in SERVICE_LIST.items():
+    should_log = "true" if v.should_log else "false"
+    decimation = -1 if v.decimation is None else v.decimation
+    h += '  { "%s", service_name_hash("%s"), %s, %ff, %d, %d },\n' % \
+         (k, k, should_log, v.frequency, decimation, v.queue_size)
+  h += "};\n"
+  h += "constexpr bool service_name_equals(const char *a, const char *b) {\n"
+  h += "  for (; *a != '\\0' && *a == *b; ++a, ++b) {}\n"
+  h += "  return *a == *b;\n"
+  h += "}\n"
+  h += "constexpr const service_entry *find_service(const char *name) {\n"
+  h += "  for (const service_entry &entry : service_table) {\n"
+  h += "    if (service_name_equals(entry.name, name)) return &entry;\n"
+  h += "  }\n"
+  h += "  return nullptr;\n"
+  h += "}\n"
+  # get_service(\"carState\") in a constexpr context makes an unknown name a
+  # compile error (dereferencing the null from find_service is ill-formed there)
+  h += "constexpr const service_entry &get_service(const char *name) {\n"
+  h += "  return *find_service(name);\n"
+  h += "}\n"
+
   h += "#endif\n"
   return h
 
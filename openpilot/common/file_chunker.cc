@@ -0,0 +1,166 @@
+#include "common/file_chunker.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace file_chunker {
+
+// reference: https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+static constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+static constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+static constexpr uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+static constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+static constexpr uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rotl64(uint64_t x, int r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t read64(const uint8_t *p) {
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline uint32_t read32(const uint8_t *p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline uint64_t round64(uint64_t acc, uint64_t input) {
+  return rotl64(acc + input * PRIME2, 31) * PRIME1;
+}
+
+static inline uint64_t merge_round64(uint64_t acc, uint64_t val) {
+  return (acc ^ round64(0, val)) * PRIME1 + PRIME4;
+}
+
+uint64_t xxh64(const void *data, size_t len) {
+  const uint8_t *p = static_cast<const uint8_t *>(data);
+  const uint8_t *end = p + len;
+  uint64_t h;
+
+  if (len >= 32) {
+    uint64_t v1 = PRIME1 + PRIME2, v2 = PRIME2, v3 = 0, v4 = 0 - PRIME1;
+    do {
+      v1 = round64(v1, read64(p)); p += 8;
+      v2 = round64(v2, read64(p)); p += 8;
+      v3 = round64(v3, read64(p)); p += 8;
+      v4 = round64(v4, read64(p)); p += 8;
+    } while (p + 32 <= end);
+    h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+    h = merge_round64(h, v1);
+    h = merge_round64(h, v2);
+    h = merge_round64(h, v3);
+    h = merge_round64(h, v4);
+  } else {
+    h = PRIME5;
+  }
+
+  h += (uint64_t)len;
+  while (p + 8 <= end) {
+    h = rotl64(h ^ round64(0, read64(p)), 27) * PRIME1 + PRIME4;
+    p += 8;
+  }
+  if (p + 4 <= end) {
+    h = rotl64(h ^ (read32(p) * PRIME1), 23) * PRIME2 + PRIME3;
+    p += 4;
+  }
+  while (p < end) {
+    h = rotl64(h ^ (*p * PRIME5), 11) * PRIME1;
+    ++p;
+  }
+
+  h ^= h >> 33;
+  h *= PRIME2;
+  h ^= h >> 29;
+  h *= PRIME3;
+  h ^= h >> 32;
+  return h;
+}
+
+static void write_all(int fd, const uint8_t *data, size_t len) {
+  size_t written = 0;
+  while (written < len) {
+    const ssize_t n = write(fd, data + written, len - written);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw std::runtime_error("chunk write failed: " + std::string(strerror(errno)));
+    }
+    written += n;
+  }
+}
+
+std::vector<ChunkResult> chunk_file(const std::string &path, const std::vector<std::string> &chunk_paths, size_t chunk_size) {
+  assert(chunk_size > 0);
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("failed to open " + path + ": " + std::string(strerror(errno)));
+  }
+  struct stat st = {};
+  fstat(fd, &st);
+  const size_t file_size = st.st_size;
+
+  uint8_t *data = nullptr;
+  if (file_size > 0) {
+    data = static_cast<uint8_t *>(mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0));
+    if (data == MAP_FAILED) {
+      close(fd);
+      throw std::runtime_error("failed to mmap " + path + ": " + std::string(strerror(errno)));
+    }
+    madvise(data, file_size, MADV_SEQUENTIAL);
+  }
+  close(fd);
+
+  const size_t num_chunks = chunk_paths.size();
+  std::vector<ChunkResult> results(num_chunks);
+  std::atomic<size_t> next_chunk{0};
+  std::atomic<bool> failed{false};
+
+  auto worker = [&]() {
+    for (size_t i = next_chunk.fetch_add(1); i < num_chunks; i = next_chunk.fetch_add(1)) {
+      const size_t begin = std::min(i * chunk_size, file_size);
+      const size_t len = std::min(chunk_size, file_size - begin);
+      const int out = open(chunk_paths[i].c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (out < 0) {
+        failed = true;
+        return;
+      }
+      try {
+        write_all(out, data + begin, len);
+      } catch (const std::runtime_error &) {
+        close(out);
+        failed = true;
+        return;
+      }
+      close(out);
+      results[i] = {len, xxh64(data + begin, len)};
+    }
+  };
+
+  const size_t n_threads = std::max<size_t>(1, std::min({num_chunks, (size_t)std::thread::hardware_concurrency(), (size_t)8}));
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < n_threads; ++i) threads.emplace_back(worker);
+  for (auto &t : threads) t.join();
+
+  if (data != nullptr) {
+    munmap(data, file_size);
+  }
+  if (failed) {
+    throw std::runtime_error("failed to write chunks for " + path);
+  }
+  return results;
+}
+
+}  // namespace file_chunker
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace file_chunker {
+
+struct ChunkResult {
+  uint64_t size;
+  uint64_t hash;  // XXH64 of the chunk contents
+};
+
+// XXH64 with seed 0
+uint64_t xxh64(const void *data, size_t len);
+
+// splits the file at path into the given chunk targets in a single mmap pass,
+// hashing each chunk while writing; chunks past EOF come out empty, matching
+// the python fallback. chunks are processed on a small thread pool.
+std::vector<ChunkResult> chunk_file(const std::string &path, const std::vector<std::string> &chunk_paths, size_t chunk_size);
+
+}  // namespace file_chunker
@@ -7,6 +7,13 @@ from pathlib import Path
 
 CHUNK_SIZE = 45 * 1024 * 1024  # 45MB, under GitHub's 50MB limit
 
+# the native engine splits and hashes in one mmap pass; it isn't built yet when
+# scons imports this module to chunk freshly compiled models, so keep a fallback
+try:
+  from openpilot.common.file_chunker_pyx import chunk_file_native, xxh64
+except ImportError:
+  chunk_file_native, xxh64 = None, None
+
 def get_chunk_name(name, idx, num_chunks):
   return f"{name}.chunk{idx+1:02d}of{num_chunks:02d}"
 
@@ -24,24 +31,37 @@ def chunk_file(path, targets):
   manifest_path, *chunk_paths = targets
   actual_num_chunks = max(1, math.ceil(os.path.getsize(path) / CHUNK_SIZE))
   assert len(chunk_paths) >= actual_num_chunks, f"Allowed {len(chunk_paths)} chunks but needs at least {actual_num_chunks}, for path {path}"
-  with open(path, 'rb') as f:
-    for chunk_path in chunk_paths:
-      with open(chunk_path, 'wb') as out:
-        out.write(f.read(CHUNK_SIZE))
-  Path(manifest_path).write_text(str(len(chunk_paths)))
+  manifest_lines = [str(len(chunk_paths))]
+  if chunk_file_native is not None:
+    results = chunk_file_native(path, chunk_paths, CHUNK_SIZE)
+    manifest_lines += [f"{h:016x}" for _, h in results]
+  else:
+    with open(path, 'rb') as f:
+      for chunk_path in chunk_paths:
+        with open(chunk_path, 'wb') as out:
+          out.write(f.read(CHUNK_SIZE))
+  Path(manifest_path).write_text("\n".join(manifest_lines))
   os.remove(path)
 
+def _read_manifest(manifest_path):
+  # first line is the chunk count; subsequent lines are optional per-chunk xxh64 hashes
+  lines = Path(manifest_path).read_text().splitlines()
+  num_chunks = int(lines[0].strip())
+  hashes = [int(line, 16) for line in lines[1:]] or None
+  return num_chunks, hashes
+
 def get_existing_chunks(path):
   if os.path.isfile(path):
     return [path]
   if os.path.isfile(manifest := get_manifest_path(path)):
-    num_chunks = int(Path(manifest).read_text().strip())
+    num_chunks, _ = _read_manifest(manifest)
     return _chunk_paths(path, num_chunks)
   raise FileNotFoundError(path)
 
 class ChunkStream(io.RawIOBase):
-  def __init__(self, paths):
-    self._paths = iter(paths)
+  def __init__(self, paths, hashes=None):
+    self._paths = iter(paths if hashes is None else zip(paths, hashes, strict=True))
+    self._verify = hashes is not None
     self._buf = memoryview(b'')
 
   def readable(self):
@@ -54,8 +74,11 @@ class ChunkStream(io.RawIOBase):
         p = next(self._paths, None)
         if p is None:
           break
+        p, expected_hash = p if self._verify else (p, None)
         with open(p, 'rb') as f:
           self._buf = memoryview(f.read())
+        if self._verify and xxh64(self._buf) != expected_hash:
+          raise OSError(f"chunk hash mismatch for {p}")
         continue
       take = min(len(b) - n, len(self._buf))
       b[n:n + take] = self._buf[:take]
@@ -66,13 +89,14 @@ class ChunkStream(io.RawIOBase):
 def open_file_chunked(path):
   manifest_path = get_manifest_path(path)
   if os.path.isfile(manifest_path):
-    num_chunks = int(Path(manifest_path).read_text().strip())
+    num_chunks, hashes = _read_manifest(manifest_path)
     paths = [get_chunk_name(path, i, num_chunks) for i in range(num_chunks)]
+    if xxh64 is None:
+      hashes = None
+    return io.BufferedReader(ChunkStream(paths, hashes))
   elif os.path.isfile(path):
-    paths = [path]
-  else:
-    raise FileNotFoundError(path)
-  return io.BufferedReader(ChunkStream(paths))
+    return io.BufferedReader(ChunkStream([path]))
+  raise FileNotFoundError(path)
 
 
 if __name__ == "__main__":
@@ -0,0 +1,37 @@
+# distutils: language = c++
+# cython: language_level = 3
+from libc.stdint cimport uint64_t
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+cdef extern from "common/file_chunker.h" namespace "file_chunker":
+  cdef struct ChunkResult:
+    uint64_t size
+    uint64_t hash
+
+  uint64_t c_xxh64 "file_chunker::xxh64"(const void *data, size_t len) nogil
+  vector[ChunkResult] c_chunk_file "file_chunker::chunk_file"(const string &path, const vector[string] &chunk_paths, size_t chunk_size) nogil except +
+
+
+def xxh64(data):
+  cdef const unsigned char[::1] view = data
+  cdef uint64_t h
+  cdef size_t n = view.shape[0]
+  if n == 0:
+    return c_xxh64(NULL, 0)
+  with nogil:
+    h = c_xxh64(&view[0], n)
+  return h
+
+
+def chunk_file_native(path, chunk_paths, chunk_size):
+  """Splits path into chunk_paths in one mmap pass; returns (size, hash) per chunk."""
+  cdef string c_path = path.encode()
+  cdef vector[string] c_paths
+  for p in chunk_paths:
+    c_paths.push_back(p.encode())
+  cdef size_t c_chunk_size = chunk_size
+  cdef vector[ChunkResult] results
+  with nogil:
+    results = c_chunk_file(c_path, c_paths, c_chunk_size)
+  return [(r.size, r.hash) for r in results]
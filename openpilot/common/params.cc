@@ -2,6 +2,11 @@
 
 #include <dirent.h>
 #include <sys/file.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include <algorithm>
 #include <cassert>
@@ -101,6 +106,10 @@ Params::~Params() {
     future.wait();
   }
   assert(queue.empty());
+  for (auto &[_, m] : mapped_) {
+    if (m.addr) munmap(m.addr, m.len);
+  }
+  if (watch_fd_ >= 0) close(watch_fd_);
 }
 
 std::vector<std::string> Params::allKeys() const {
@@ -166,6 +175,73 @@ int Params::put(const char* key, const char* value, size_t value_size) {
   return result;
 }
 
+int Params::putBatch(const std::vector<std::pair<std::string, std::string>> &items) {
+  // Stage every value in a synced temp file, then rename them all into place
+  // under one lock and fsync the directory once. Each key keeps the same
+  // atomic-rename guarantee as put(); only the directory sync is coalesced.
+  std::vector<std::pair<std::string, std::string>> staged;  // key, tmp_path
+  int result = 0;
+
+  for (auto &[key, value] : items) {
+    std::string tmp_path = params_path + "/.tmp_value_XXXXXX";
+    int tmp_fd = mkstemp((char *)tmp_path.c_str());
+    if (tmp_fd < 0) { result = -1; break; }
+
+    ssize_t bytes_written = HANDLE_EINTR(write(tmp_fd, value.data(), value.size()));
+    if (bytes_written < 0 || (size_t)bytes_written != value.size()) {
+      result = -20;
+    } else {
+      result = HANDLE_EINTR(fsync(tmp_fd));
+    }
+    close(tmp_fd);
+    if (result != 0) {
+      ::unlink(tmp_path.c_str());
+      break;
+    }
+    staged.push_back({key, tmp_path});
+  }
+
+  if (result == 0) {
+    FileLock file_lock(params_path + "/.lock");
+    for (auto &[key, tmp_path] : staged) {
+      if ((result = rename(tmp_path.c_str(), getParamPath(key).c_str())) < 0) break;
+    }
+    if (result == 0) {
+      result = fsync_dir(getParamPath());
+    }
+  }
+
+  if (result != 0) {
+    for (auto &[key, tmp_path] : staged) ::unlink(tmp_path.c_str());
+  }
+  return result;
+}
+
+std::string_view Params::getMapped(const std::string &key) {
+  struct stat st;
+  if (stat(getParamPath(key).c_str(), &st) != 0) {
+    return {};
+  }
+
+  MappedFile &m = mapped_[key];
+  if (m.addr == nullptr || m.ino != (uint64_t)st.st_ino) {
+    // put() renamed a new file into place; remap it
+    if (m.addr) munmap(m.addr, m.len);
+    m = MappedFile{};
+
+    int fd = HANDLE_EINTR(open(getParamPath(key).c_str(), O_RDONLY));
+    if (fd < 0) return {};
+    if (st.st_size > 0) {
+      void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED) {
+        m = MappedFile{.addr = addr, .len = (size_t)st.st_size, .ino = (uint64_t)st.st_ino};
+      }
+    }
+    close(fd);
+  }
+  return m.addr ? std::string_view((const char *)m.addr, m.len) : std::string_view();
+}
+
 int Params::remove(const std::string &key) {
   FileLock file_lock(params_path + "/.lock");
   int result = unlink(getParamPath(key).c_str());
@@ -198,6 +274,16 @@ std::string Params::get(const std::string &key, bool block) {
   }
 }
 
+std::vector<std::string> Params::getMany(const std::vector<std::string> &keys_in) {
+  std::vector<std::string> values;
+  values.reserve(keys_in.size());
+  FileLock file_lock(params_path + "/.lock");
+  for (const std::string &key : keys_in) {
+    values.push_back(util::read_file(getParamPath(key)));
+  }
+  return values;
+}
+
 std::map<std::string, std::string> Params::readAll() {
   FileLock file_lock(params_path + "/.lock");
   return util::read_files_in_dir(getParamPath());
@@ -224,6 +310,42 @@ void Params::clearAll(ParamKeyFlag key_flag) {
   fsync_dir(getParamPath());
 }
 
+int Params::watchFd() {
+#ifdef __linux__
+  if (watch_fd_ < 0) {
+    watch_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watch_fd_ >= 0) {
+      // put() renames into place (IN_MOVED_TO); remove() unlinks (IN_DELETE)
+      if (inotify_add_watch(watch_fd_, getParamPath().c_str(), IN_MOVED_TO | IN_DELETE) < 0) {
+        close(watch_fd_);
+        watch_fd_ = -1;
+      }
+    }
+  }
+#endif
+  return watch_fd_;
+}
+
+std::vector<std::string> Params::readChanges() {
+  std::vector<std::string> changed;
+#ifdef __linux__
+  if (watchFd() < 0) return changed;
+
+  char buf[4096] __attribute__((aligned(alignof(struct inotify_event))));
+  ssize_t len;
+  while ((len = read(watch_fd_, buf, sizeof(buf))) > 0) {
+    for (char *p = buf; p < buf + len;) {
+      auto *ev = (struct inotify_event *)p;
+      if (ev->len > 0 && checkKey(ev->name)) {
+        changed.push_back(ev->name);
+      }
+      p += sizeof(struct inotify_event) + ev->len;
+    }
+  }
+#endif
+  return changed;
+}
+
 void Params::putNonBlocking(const std::string &key, const std::string &val) {
    queue.push(std::make_pair(key, val));
   // start thread on demand
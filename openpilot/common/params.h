@@ -4,6 +4,7 @@
 #include <map>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -60,19 +61,41 @@ public:
 
   // helpers for reading values
   std::string get(const std::string &key, bool block = false);
+  // mmap-backed read for hot keys polled every cycle: the mapping is kept per
+  // key and only refreshed when the underlying inode changes (a put() renames
+  // a new file into place), so steady-state reads are a stat() with no
+  // open/read/copy and no lock. The view is invalidated by the next
+  // getMapped() of the same key.
+  std::string_view getMapped(const std::string &key);
   inline bool getBool(const std::string &key, bool block = false) {
     return get(key, block) == "1";
   }
+  // reads several keys in one pass under a single lock, so the returned
+  // values (in key order) form a consistent snapshot with respect to
+  // putBatch()
+  std::vector<std::string> getMany(const std::vector<std::string> &keys);
   std::map<std::string, std::string> readAll();
 
   // helpers for writing values
   int put(const char *key, const char *val, size_t value_size);
+  // write-ahead batch: stages every value in temp files first, then renames
+  // them into place under one lock and a single directory fsync, keeping the
+  // per-key atomic-rename crash consistency while paying one fsync storm
+  // instead of one per key
+  int putBatch(const std::vector<std::pair<std::string, std::string>> &items);
   inline int put(const std::string &key, const std::string &val) {
     return put(key.c_str(), val.data(), val.size());
   }
   inline int putBool(const std::string &key, bool val) {
     return put(key.c_str(), val ? "1" : "0", 1);
   }
+  // Change notification (Linux): a non-blocking inotify fd on the params
+  // directory that becomes readable when any key is written or removed.
+  // Poll/select on watchFd() and drain with readChanges() instead of calling
+  // get()/getBool() every cycle. Returns -1 where inotify is unavailable.
+  int watchFd();
+  std::vector<std::string> readChanges();
+
   void putNonBlocking(const std::string &key, const std::string &val);
   inline void putBoolNonBlocking(const std::string &key, bool val) {
     putNonBlocking(key, val ? "1" : "0");
@@ -84,6 +107,15 @@ private:
   std::string params_path;
   std::string params_prefix;
 
+  // state for the mmap read path
+  struct MappedFile {
+    void *addr = nullptr;
+    size_t len = 0;
+    uint64_t ino = 0;
+  };
+  std::map<std::string, MappedFile> mapped_;
+  int watch_fd_ = -1;
+
   // for nonblocking write
   std::future<void> future;
   SafeQueue<std::pair<std::string, std::string>> queue;
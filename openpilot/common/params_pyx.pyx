@@ -4,6 +4,7 @@ import builtins
 import datetime
 import json
 from libcpp cimport bool
+from libcpp.pair cimport pair
 from libcpp.string cimport string
 from libcpp.vector cimport vector
 from libcpp.optional cimport optional
@@ -32,9 +33,11 @@ cdef extern from "common/params.h":
   cdef cppclass c_Params "Params":
     c_Params(string) except + nogil
     string get(string, bool) nogil
+    vector[string] getMany(vector[string]) nogil
     bool getBool(string, bool) nogil
     int remove(string) nogil
     int put(string, string) nogil
+    int putBatch(vector[pair[string, string]]) nogil
     void putNonBlocking(string, string) nogil
     void putBoolNonBlocking(string, bool) nogil
     int putBool(string, bool) nogil
@@ -129,6 +132,38 @@ cdef class Params:
         return self._cpp2python(t, default_val, None, key)
     return self._cpp2python(t, val, default_val, key)
 
+  def get_many(self, keys, bool return_default=False):
+    """Read several keys in one pass under a single lock.
+
+    Returns {key: value} with the same typing/default behavior as get();
+    one call replaces N get() round trips through the pyx boundary.
+    """
+    cdef vector[string] ks
+    cdef vector[string] vals
+    cdef optional[string] default
+    key_list = list(keys)
+    types = []
+    default_vals = []
+    for key in key_list:
+      k = self.check_key(key)
+      ks.push_back(<string>k)
+      types.append(self.p.getKeyType(k))
+      if return_default:
+        default = self.p.getKeyDefaultValue(k)
+        default_vals.append(default.value() if default.has_value() else None)
+      else:
+        default_vals.append(None)
+    with nogil:
+      vals = self.p.getMany(ks)
+    ret = {}
+    for i, key in enumerate(key_list):
+      val = vals[i]
+      if val == b"":
+        ret[key] = self._cpp2python(types[i], default_vals[i], None, key)
+      else:
+        ret[key] = self._cpp2python(types[i], val, default_vals[i], key)
+    return ret
+
   def get_bool(self, key, bool block=False):
     cdef string k = self.check_key(key)
     cdef bool r
@@ -156,6 +191,22 @@ cdef class Params:
       else:
         self.p.putNonBlocking(k, dat_bytes)
 
+  def put_many(self, items):
+    """
+    Write several params atomically per key with one lock and a single
+    directory sync. Blocks until everything is on disk, so the same warning
+    as put(block=True) applies — but the fsync cost is paid once for the
+    whole batch instead of once per key.
+    """
+    cdef vector[pair[string, string]] batch
+    cdef int result
+    for key, dat in items.items():
+      k = self.check_key(key)
+      batch.push_back(pair[string, string](<string>k, <string>self._put_cast(key, dat)))
+    with nogil:
+      result = self.p.putBatch(batch)
+    return result
+
   def put_bool(self, key, bool val, bool block = False):
     cdef string k = self.check_key(key)
     with nogil:
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <queue>
+#include <vector>
 
 template <class T>
 class SafeQueue {
@@ -50,3 +54,103 @@ private:
   std::condition_variable cv;
   std::queue<T> q;
 };
+
+// Bounded lock-free single-producer/single-consumer ring. The fast path is a
+// slot write plus one release store with no locks or condvar wakeups, so
+// handoff latency stays deterministic under load (unlike SafeQueue, whose
+// condvar adds scheduler jitter). Blocking push()/pop() spin briefly, then
+// park on a condvar; the waker only touches the lock when the other side is
+// actually parked.
+template <class T>
+class SpscRing {
+public:
+  explicit SpscRing(size_t capacity) {
+    size_t n = 2;
+    while (n < capacity) n <<= 1;
+    buf_.resize(n);
+    mask_ = n - 1;
+  }
+
+  bool try_push(const T &v) {
+    uint64_t t = tail_.load(std::memory_order_relaxed);
+    if (t - head_.load(std::memory_order_acquire) > mask_) return false;
+    buf_[t & mask_] = v;
+    tail_.store(t + 1, std::memory_order_release);
+    wake(consumer_waiting_);
+    return true;
+  }
+
+  bool try_pop(T &v) {
+    uint64_t h = head_.load(std::memory_order_relaxed);
+    if (h == tail_.load(std::memory_order_acquire)) return false;
+    v = buf_[h & mask_];
+    head_.store(h + 1, std::memory_order_release);
+    wake(producer_waiting_);
+    return true;
+  }
+
+  // bulk variants amortize the release store over a batch
+  size_t push_bulk(const T *items, size_t n) {
+    uint64_t t = tail_.load(std::memory_order_relaxed);
+    size_t space = mask_ + 1 - (t - head_.load(std::memory_order_acquire));
+    n = std::min(n, space);
+    for (size_t i = 0; i < n; ++i) buf_[(t + i) & mask_] = items[i];
+    if (n > 0) {
+      tail_.store(t + n, std::memory_order_release);
+      wake(consumer_waiting_);
+    }
+    return n;
+  }
+
+  size_t pop_bulk(T *out, size_t max) {
+    uint64_t h = head_.load(std::memory_order_relaxed);
+    size_t avail = tail_.load(std::memory_order_acquire) - h;
+    max = std::min(max, avail);
+    for (size_t i = 0; i < max; ++i) out[i] = buf_[(h + i) & mask_];
+    if (max > 0) {
+      head_.store(h + max, std::memory_order_release);
+      wake(producer_waiting_);
+    }
+    return max;
+  }
+
+  void push(const T &v) {
+    for (int spins = 0; !try_push(v); ++spins) park(producer_waiting_, spins);
+  }
+
+  T pop() {
+    T v;
+    for (int spins = 0; !try_pop(v); ++spins) park(consumer_waiting_, spins);
+    return v;
+  }
+
+  bool empty() const { return size() == 0; }
+  size_t size() const {
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+  }
+
+private:
+  void park(std::atomic<bool> &waiting, int spins) {
+    if (spins < 2048) return;  // spin-then-park keeps the common case wait-free
+    std::unique_lock lk(m_);
+    waiting.store(true, std::memory_order_relaxed);
+    cv_.wait_for(lk, std::chrono::milliseconds(1));
+    waiting.store(false, std::memory_order_relaxed);
+  }
+
+  void wake(std::atomic<bool> &waiting) {
+    if (waiting.load(std::memory_order_relaxed)) {
+      std::lock_guard lk(m_);
+      cv_.notify_all();
+    }
+  }
+
+  std::vector<T> buf_;
+  uint64_t mask_ = 0;
+  alignas(64) std::atomic<uint64_t> head_{0};
+  alignas(64) std::atomic<uint64_t> tail_{0};
+  std::atomic<bool> producer_waiting_{false};
+  std::atomic<bool> consumer_waiting_{false};
+  std::mutex m_;
+  std::condition_variable cv_;
+};
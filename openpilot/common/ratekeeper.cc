@@ -1,6 +1,7 @@
 #include "common/ratekeeper.h"
 
 #include <algorithm>
+#include <cmath>
 
 #include "common/swaglog.h"
 #include "common/timing.h"
@@ -14,6 +15,16 @@ RateKeeper::RateKeeper(const std::string &name_, float rate, float print_delay_t
   next_frame_time = last_monitor_time + interval;
 }
 
+void RateKeeper::alignToEpoch(double phase_offset) {
+  phase_ = std::fmod(phase_offset, interval);
+  phase_aligned_ = true;
+  next_frame_time = nextSlot(seconds_since_boot());
+}
+
+double RateKeeper::nextSlot(double t) const {
+  return (std::floor((t - phase_) / interval) + 1) * interval + phase_;
+}
+
 bool RateKeeper::keepTime() {
   bool lagged = monitorTime();
   if (remaining_ > 0) {
@@ -32,7 +43,9 @@ bool RateKeeper::monitorTime() {
     if (print_delay_threshold > 0 && remaining_ < -print_delay_threshold) {
       LOGW("%s lagging by %.2f ms", name.c_str(), -remaining_ * 1000);
     }
-    next_frame_time = last_monitor_time + interval;
+    // in phase-aligned mode, skip to the next shared slot instead of
+    // free-running from the late wakeup
+    next_frame_time = phase_aligned_ ? nextSlot(last_monitor_time) : last_monitor_time + interval;
   } else {
     next_frame_time += interval;
   }
@@ -9,14 +9,22 @@ public:
   ~RateKeeper() {}
   bool keepTime();
   bool monitorTime();
+  // Phase-aligned mode: wakeup slots are derived from a shared epoch (boot
+  // time zero) plus a fixed offset within the interval, so co-scheduled loops
+  // in different processes wake on a staggered schedule instead of stacking
+  // on the same scheduler tick. Alignment is preserved across lag.
+  void alignToEpoch(double phase_offset = 0);
   inline uint64_t frame() const { return frame_; }
   inline double remaining() const { return remaining_; }
 
 private:
+  double nextSlot(double t) const;
   double interval;
   double next_frame_time;
   double last_monitor_time;
   double remaining_ = 0;
+  double phase_ = 0;
+  bool phase_aligned_ = false;
   float print_delay_threshold = 0;
   uint64_t frame_ = 0;
   std::string name;
@@ -0,0 +1,114 @@
+#include "common/self_metrics.h"
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "openpilot/cereal/messaging/messaging.h"
+#include "common/util.h"
+
+namespace self_metrics {
+
+namespace {
+
+std::atomic<bool> run{false};
+std::thread sampler;
+
+struct ThreadSample {
+  int tid;
+  std::string name;
+  float cpu_user;
+  float cpu_system;
+};
+
+// /proc/.../stat fields after the parenthesized comm, 1-indexed from minflt=10
+bool parse_stat(const std::string &stat, unsigned long *minflt, unsigned long *majflt,
+                unsigned long *utime, unsigned long *stime) {
+  size_t pos = stat.rfind(')');
+  if (pos == std::string::npos) return false;
+  return sscanf(stat.c_str() + pos + 1, " %*c %*d %*d %*d %*d %*d %*u %lu %*u %lu %*u %lu %lu",
+                minflt, majflt, utime, stime) == 4;
+}
+
+void sample_threads(std::vector<ThreadSample> &threads, double clk_tck) {
+  threads.clear();
+  DIR *d = opendir("/proc/self/task");
+  if (!d) return;
+
+  struct dirent *de = NULL;
+  while ((de = readdir(d))) {
+    int tid = atoi(de->d_name);
+    if (tid <= 0) continue;
+
+    std::string base = "/proc/self/task/" + std::string(de->d_name);
+    unsigned long minflt, majflt, utime, stime;
+    if (!parse_stat(util::read_file(base + "/stat"), &minflt, &majflt, &utime, &stime)) continue;
+
+    threads.push_back({
+      .tid = tid,
+      .name = util::strip(util::read_file(base + "/comm")),
+      .cpu_user = float(utime / clk_tck),
+      .cpu_system = float(stime / clk_tck),
+    });
+  }
+  closedir(d);
+}
+
+void sampler_thread(std::string proc_name) {
+  util::set_thread_name("self_metrics");
+
+  PubMaster pm({"selfMetrics"});
+  const double clk_tck = sysconf(_SC_CLK_TCK);
+  const unsigned long page_size = sysconf(_SC_PAGESIZE);
+  std::vector<ThreadSample> threads;
+
+  while (run) {
+    unsigned long vms_pages = 0, rss_pages = 0;
+    sscanf(util::read_file("/proc/self/statm").c_str(), "%lu %lu", &vms_pages, &rss_pages);
+
+    unsigned long minflt = 0, majflt = 0, utime, stime;
+    parse_stat(util::read_file("/proc/self/stat"), &minflt, &majflt, &utime, &stime);
+
+    sample_threads(threads, clk_tck);
+
+    MessageBuilder msg;
+    auto sm = msg.initEvent().initSelfMetrics();
+    sm.setProcName(proc_name);
+    sm.setPid(getpid());
+    sm.setMemRss(rss_pages * page_size);
+    sm.setMemVms(vms_pages * page_size);
+    sm.setMinorFaults(minflt);
+    sm.setMajorFaults(majflt);
+
+    auto tt = sm.initThreads(threads.size());
+    for (size_t i = 0; i < threads.size(); ++i) {
+      tt[i].setTid(threads[i].tid);
+      tt[i].setName(threads[i].name);
+      tt[i].setCpuUser(threads[i].cpu_user);
+      tt[i].setCpuSystem(threads[i].cpu_system);
+    }
+    pm.send("selfMetrics", msg);
+
+    util::sleep_for(1000);
+  }
+}
+
+}  // namespace
+
+void start(const char *proc_name) {
+  bool expected = false;
+  if (!run.compare_exchange_strong(expected, true)) return;
+  sampler = std::thread(sampler_thread, std::string(proc_name));
+}
+
+void stop() {
+  if (run.exchange(false) && sampler.joinable()) {
+    sampler.join();
+  }
+}
+
+}  // namespace self_metrics
@@ -0,0 +1,20 @@
+#pragma once
+
+// In-process self metrics: a 1Hz sampler thread reads this process's RSS,
+// fault counters, and per-thread CPU times from /proc/self and publishes
+// them on the selfMetrics service. Unlike proclogd's external /proc scrape,
+// samples are taken inside the daemon, so short allocation or CPU spikes
+// between external samples still show up in the log.
+//
+//   int main() {
+//     self_metrics::start("loggerd");
+//     ...
+//   }
+
+namespace self_metrics {
+
+// idempotent; no-op after the first call
+void start(const char *proc_name);
+void stop();
+
+}  // namespace self_metrics
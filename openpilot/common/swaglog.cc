@@ -4,10 +4,19 @@
 
 #include "common/swaglog.h"
 
+#include <unistd.h>
+
+#include <atomic>
 #include <cassert>
+#include <cinttypes>
+#include <deque>
 #include <limits>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <zmq.h>
 #include <stdarg.h>
@@ -66,12 +75,111 @@ public:
     zmq_ctx_destroy(zctx);
   }
 
+  // Spill ring for early boot and zmq-down periods: zmq only buffers up to
+  // the socket HWM before NOBLOCK sends start failing, which used to silently
+  // drop the first seconds of boot diagnostics until logmessaged came up.
+  // Failed sends land in a bounded in-memory ring (oldest dropped beyond the
+  // cap) and a lazily started drain thread replays them in order once the
+  // socket accepts traffic again, then exits.
+  static constexpr size_t SPILL_MAX_BYTES = 1 << 20;
+
+  // must be called with lock held
+  void sendOrSpill(const std::string &frame) {
+    // once anything is spilled, new frames queue behind it to keep ordering
+    if (spill.empty() && zmq_send(sock, frame.data(), frame.length(), ZMQ_NOBLOCK) >= 0) {
+      return;
+    }
+    spill.push_back(frame);
+    spill_bytes += frame.size();
+    while (spill_bytes > SPILL_MAX_BYTES) {
+      spill_bytes -= spill.front().size();
+      spill.pop_front();
+      spill_dropped++;
+    }
+    if (!spill_thread_running) {
+      spill_thread_running = true;
+      std::thread(&SwaglogState::spillDrainThread, this).detach();
+    }
+  }
+
+  void spillDrainThread() {
+    while (true) {
+      usleep(100000);  // 100 ms retry while the socket is down
+      std::lock_guard lk(lock);
+      while (!spill.empty()) {
+        const std::string &frame = spill.front();
+        if (zmq_send(sock, frame.data(), frame.length(), ZMQ_NOBLOCK) < 0) break;
+        spill_bytes -= frame.size();
+        spill.pop_front();
+      }
+      if (spill.empty()) {
+        if (spill_dropped > 0) {
+          json11::Json::object log_j = json11::Json::object{
+            {"ctx", ctx_j},
+            {"levelnum", CLOUDLOG_WARNING},
+            {"filename", __FILE__},
+            {"lineno", __LINE__},
+            {"funcname", "spillDrainThread"},
+            {"created", seconds_since_epoch()},
+            {"msg", "swaglog: " + std::to_string(spill_dropped) + " messages dropped from spill ring"},
+          };
+          std::string log_s;
+          log_s += (char)CLOUDLOG_WARNING;
+          ((json11::Json)log_j).dump(log_s);
+          zmq_send(sock, log_s.data(), log_s.length(), ZMQ_NOBLOCK);
+          spill_dropped = 0;
+        }
+        spill_thread_running = false;
+        return;
+      }
+    }
+  }
+
   void log(int levelnum, const char* filename, int lineno, const char* func, const char* msg, const std::string& log_s) {
     std::lock_guard lk(lock);
     if (levelnum >= print_level) {
       printf("%s: %s\n", filename, msg);
     }
-    zmq_send(sock, log_s.data(), log_s.length(), ZMQ_NOBLOCK);
+    sendOrSpill(log_s);
+  }
+
+  // Compact binary framing (SWAGLOG_BINARY=1): the static fields of each
+  // callsite (filename/lineno/funcname + process ctx) are interned into a
+  // per-process dictionary sent once as a 0xD1 frame; subsequent messages are
+  // tiny 0xD2 frames referencing the dictionary id. Several-fold smaller on
+  // the wire and in rlogs, and skips JSON serialization per message.
+  void logBinary(int levelnum, const char* filename, int lineno, const char* func, const char* msg) {
+    std::lock_guard lk(lock);
+    if (levelnum >= print_level) {
+      printf("%s: %s\n", filename, msg);
+    }
+
+    std::string key = std::string(filename) + ":" + std::to_string(lineno) + ":" + func;
+    auto [it, inserted] = intern_ids.insert({key, (uint32_t)intern_ids.size()});
+    if (inserted) {
+      json11::Json::object dict_j = json11::Json::object{
+        {"id", (int)it->second},
+        {"ctx", ctx_j},
+        {"filename", filename},
+        {"lineno", lineno},
+        {"funcname", func},
+      };
+      std::string dict_s;
+      dict_s += (char)0xD1;
+      ((json11::Json)dict_j).dump(dict_s);
+      sendOrSpill(dict_s);
+    }
+
+    std::string frame;
+    frame += (char)0xD2;
+    uint32_t id = it->second;
+    while (id >= 0x80) { frame += (char)(id | 0x80); id >>= 7; }
+    frame += (char)id;
+    frame += (char)levelnum;
+    double created = seconds_since_epoch();
+    frame.append((const char *)&created, sizeof(created));
+    frame += msg;
+    sendOrSpill(frame);
   }
 
   std::mutex lock;
@@ -79,15 +187,127 @@ public:
   void* sock = nullptr;
   int print_level;
   json11::Json::object ctx_j;
+  std::map<std::string, uint32_t> intern_ids;
+
+  // spill ring state, guarded by lock
+  std::deque<std::string> spill;
+  size_t spill_bytes = 0;
+  uint64_t spill_dropped = 0;
+  bool spill_thread_running = false;
 };
 
 bool LOG_TIMESTAMPS = getenv("LOG_TIMESTAMPS");
 uint32_t NO_FRAME_ID = std::numeric_limits<uint32_t>::max();
 
+// Deferred logging (SWAGLOG_ASYNC=1): hot loops enqueue raw records into
+// per-thread SPSC rings and a drain thread does the JSON formatting and zmq
+// send, so a log call costs one ring slot write instead of a mutex + format +
+// blocking send. Records carry pointers to the static __FILE__/__func__
+// literals and ownership of the vasprintf'd message buffer.
+static const bool SWAGLOG_ASYNC = getenv("SWAGLOG_ASYNC") != nullptr;
+
+static void swaglog_format_and_send(int levelnum, const char* filename, int lineno, const char* func,
+                                    char* msg_buf, const json11::Json::object &msg_j = {});
+
+namespace {
+
+struct AsyncLogRing {
+  static constexpr size_t SIZE = 256;  // power of two
+  struct Record {
+    int level;
+    const char *filename;
+    int lineno;
+    const char *func;
+    char *msg;  // owned
+  };
+  Record slots[SIZE];
+  std::atomic<uint64_t> head{0}, tail{0};
+  std::atomic<uint64_t> dropped{0};
+
+  bool push(const Record &r) {
+    uint64_t t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) >= SIZE) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    slots[t % SIZE] = r;
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+};
+
+std::mutex async_rings_lock;
+std::vector<std::shared_ptr<AsyncLogRing>> async_rings;
+
+void async_drain_thread() {
+  while (true) {
+    std::vector<std::shared_ptr<AsyncLogRing>> rings;
+    {
+      std::lock_guard lk(async_rings_lock);
+      rings = async_rings;
+    }
+    for (auto &ring : rings) {
+      uint64_t h = ring->head.load(std::memory_order_relaxed);
+      uint64_t t = ring->tail.load(std::memory_order_acquire);
+      for (; h != t; ++h) {
+        AsyncLogRing::Record &r = ring->slots[h % AsyncLogRing::SIZE];
+        swaglog_format_and_send(r.level, r.filename, r.lineno, r.func, r.msg);
+      }
+      ring->head.store(h, std::memory_order_release);
+
+      uint64_t d = ring->dropped.exchange(0, std::memory_order_relaxed);
+      if (d > 0) {
+        char *msg = nullptr;
+        if (asprintf(&msg, "swaglog: %" PRIu64 " messages dropped from async ring", d) > 0) {
+          swaglog_format_and_send(CLOUDLOG_WARNING, __FILE__, __LINE__, __func__, msg);
+        }
+      }
+    }
+    usleep(10000);  // 10 ms drain interval bounds deferral latency
+  }
+}
+
+AsyncLogRing *thread_log_ring() {
+  static thread_local std::shared_ptr<AsyncLogRing> ring;
+  if (!ring) {
+    ring = std::make_shared<AsyncLogRing>();
+    std::lock_guard lk(async_rings_lock);
+    if (async_rings.empty()) {
+      std::thread(async_drain_thread).detach();
+    }
+    async_rings.push_back(ring);
+  }
+  return ring.get();
+}
+
+}  // namespace
+
 static void cloudlog_common(int levelnum, const char* filename, int lineno, const char* func,
                             char* msg_buf, const json11::Json::object &msg_j={}) {
+  if (SWAGLOG_ASYNC && msg_j.empty()) {
+    if (thread_log_ring()->push({levelnum, filename, lineno, func, msg_buf})) {
+      return;  // ring owns msg_buf now
+    }
+    free(msg_buf);  // ring full: record already counted as dropped
+    return;
+  }
+  swaglog_format_and_send(levelnum, filename, lineno, func, msg_buf, msg_j);
+}
+
+static const bool SWAGLOG_BINARY = getenv("SWAGLOG_BINARY") != nullptr;
+
+static void swaglog_format_and_send(int levelnum, const char* filename, int lineno, const char* func,
+                                    char* msg_buf, const json11::Json::object &msg_j) {
   static SwaglogState s;
 
+  // binary framing only applies to plain messages; structured msg_j payloads
+  // (timestamps) keep the JSON path so their shape survives
+  if (SWAGLOG_BINARY && msg_j.empty()) {
+    s.logBinary(levelnum, filename, lineno, func, msg_buf);
+    free(msg_buf);
+    return;
+  }
+
   json11::Json::object log_j = json11::Json::object {
     {"ctx", s.ctx_j},
     {"levelnum", levelnum},
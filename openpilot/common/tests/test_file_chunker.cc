@@ -0,0 +1,52 @@
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "common/file_chunker.h"
+
+TEST_CASE("xxh64 known answers") {
+  CHECK(file_chunker::xxh64("", 0) == 0xEF46DB3751D8E999ULL);
+  CHECK(file_chunker::xxh64("a", 1) == 0xD24EC4F1A98C6E5BULL);
+  CHECK(file_chunker::xxh64("abc", 3) == 0x44BC2CF5AD770999ULL);
+  const char *s = "Nobody inspects the spammish repetition";
+  CHECK(file_chunker::xxh64(s, strlen(s)) == 0xFBCEA83C8A378BF1ULL);
+}
+
+TEST_CASE("chunk_file splits and hashes") {
+  std::mt19937 rng(0);
+  const size_t file_size = 1000 * 1000 + 12345;
+  const size_t chunk_size = 256 * 1024;
+  std::vector<char> blob(file_size);
+  for (auto &b : blob) b = rng() & 0xff;
+
+  const std::string src = "/tmp/test_file_chunker_src";
+  std::ofstream(src, std::ios::binary).write(blob.data(), blob.size());
+
+  const size_t num_chunks = (file_size + chunk_size - 1) / chunk_size;
+  std::vector<std::string> chunk_paths;
+  for (size_t i = 0; i < num_chunks + 1; ++i) {  // one extra target, must come out empty
+    chunk_paths.push_back("/tmp/test_file_chunker_chunk" + std::to_string(i));
+  }
+
+  auto results = file_chunker::chunk_file(src, chunk_paths, chunk_size);
+  REQUIRE(results.size() == chunk_paths.size());
+  CHECK(results.back().size == 0);
+
+  std::vector<char> rebuilt;
+  for (size_t i = 0; i < results.size(); ++i) {
+    std::ifstream f(chunk_paths[i], std::ios::binary);
+    std::vector<char> chunk((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    CHECK(chunk.size() == results[i].size);
+    CHECK(file_chunker::xxh64(chunk.data(), chunk.size()) == results[i].hash);
+    rebuilt.insert(rebuilt.end(), chunk.begin(), chunk.end());
+    unlink(chunk_paths[i].c_str());
+  }
+  CHECK(rebuilt == blob);
+  unlink(src.c_str());
+}
@@ -0,0 +1,42 @@
+import os
+import pytest
+
+import openpilot.common.file_chunker as fc
+
+
+@pytest.fixture(autouse=True)
+def small_chunks(monkeypatch):
+  # keep the test files small
+  monkeypatch.setattr(fc, "CHUNK_SIZE", 64 * 1024)
+
+
+class TestFileChunker:
+  def _make_chunked_file(self, tmp_path, size=200 * 1024):
+    path = str(tmp_path / "blob.bin")
+    data = os.urandom(size)
+    with open(path, 'wb') as f:
+      f.write(data)
+    targets = fc.get_chunk_targets(path, size)
+    fc.chunk_file(path, targets)
+    return path, data, targets
+
+  def test_round_trip(self, tmp_path):
+    path, data, _ = self._make_chunked_file(tmp_path)
+    assert not os.path.isfile(path)
+    with fc.open_file_chunked(path) as f:
+      assert f.read() == data
+
+  def test_existing_chunks(self, tmp_path):
+    path, _, targets = self._make_chunked_file(tmp_path)
+    assert sorted(fc.get_existing_chunks(path)) == sorted(targets)
+
+  @pytest.mark.skipif(fc.xxh64 is None, reason="native chunker not built")
+  def test_corruption_detected(self, tmp_path):
+    path, _, targets = self._make_chunked_file(tmp_path)
+    with open(targets[1], 'r+b') as f:
+      f.seek(10)
+      byte = f.read(1)
+      f.seek(10)
+      f.write(bytes([byte[0] ^ 0xff]))
+    with pytest.raises(OSError, match="chunk hash mismatch"), fc.open_file_chunked(path) as f:
+      f.read()
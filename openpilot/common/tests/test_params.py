@@ -41,6 +41,17 @@ class TestParams:
     assert self.params.get("DongleId") == "bob"
     assert self.params.get("AthenadPid") == 123
 
+  def test_params_put_many_and_get_many(self):
+    self.params.put_many({"DongleId": "bob", "AthenadPid": 123})
+    vals = self.params.get_many(["DongleId", "AthenadPid", "CarParams"])
+    assert vals["DongleId"] == "bob"
+    assert vals["AthenadPid"] == 123
+    assert vals["CarParams"] is None
+
+  def test_params_get_many_unknown_key_fails(self):
+    with pytest.raises(UnknownKeyName):
+      self.params.get_many(["DongleId", "swag"])
+
   def test_params_get_block(self):
     def _delayed_writer():
       time.sleep(0.1)
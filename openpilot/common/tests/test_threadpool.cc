@@ -0,0 +1,65 @@
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "common/threadpool.h"
+
+TEST_CASE("ThreadPool runs every posted task") {
+  ThreadPool pool(4);
+  std::atomic<int> count = 0;
+  for (int i = 0; i < 1000; ++i) {
+    pool.post([&count]() { ++count; });
+  }
+  pool.wait();
+  REQUIRE(count == 1000);
+}
+
+TEST_CASE("ThreadPool dispatches higher priorities first") {
+  // a single worker so dispatch order is observable
+  ThreadPool pool(1);
+  std::vector<int> order;
+  std::mutex m;
+  // block the worker while the queue fills up
+  std::atomic<bool> release = false;
+  pool.post([&release]() { while (!release) std::this_thread::yield(); });
+  auto record = [&](int v) { std::lock_guard lk(m); order.push_back(v); };
+  pool.post([&record]() { record(2); }, ThreadPool::Priority::Low);
+  pool.post([&record]() { record(1); }, ThreadPool::Priority::Normal);
+  pool.post([&record]() { record(0); }, ThreadPool::Priority::High);
+  release = true;
+  pool.wait();
+  REQUIRE(order == std::vector<int>{0, 1, 2});
+}
+
+TEST_CASE("ThreadPool steals work from a busy worker") {
+  ThreadPool pool(4);
+  std::atomic<int> count = 0;
+  std::set<std::thread::id> tids;
+  std::mutex m;
+  // pin everything on one worker's deque via the affinity hint; idle workers
+  // should steal most of it
+  for (int i = 0; i < 256; ++i) {
+    pool.post([&]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      std::lock_guard lk(m);
+      tids.insert(std::this_thread::get_id());
+      ++count;
+    }, ThreadPool::Priority::Normal, 0);
+  }
+  pool.wait();
+  REQUIRE(count == 256);
+  REQUIRE(tids.size() > 1);
+}
+
+TEST_CASE("ThreadPool affinity routes to one deque") {
+  ThreadPool pool(2);
+  std::atomic<int> count = 0;
+  for (int i = 0; i < 64; ++i) {
+    pool.post([&count]() { ++count; }, ThreadPool::Priority::Normal, 7);
+  }
+  pool.wait();
+  REQUIRE(count == 64);
+}
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "common/timing.h"
+#include "common/yuv.h"
+
+namespace {
+
+// straight-line scalar references: everything the kernels must match,
+// written with no regard for speed
+
+void ref_nv12_to_i420(const uint8_t *src_y, int sy, const uint8_t *src_uv, int suv,
+                      uint8_t *dst_y, int dy, uint8_t *dst_u, int du, uint8_t *dst_v, int dv,
+                      int width, int height) {
+  for (int y = 0; y < height; ++y) {
+    memcpy(dst_y + y * dy, src_y + y * sy, width);
+  }
+  for (int y = 0; y < height / 2; ++y) {
+    for (int x = 0; x < width / 2; ++x) {
+      dst_u[y * du + x] = src_uv[y * suv + 2 * x];
+      dst_v[y * dv + x] = src_uv[y * suv + 2 * x + 1];
+    }
+  }
+}
+
+void ref_scale_point(const uint8_t *src, int src_stride, int src_w, int src_h,
+                     uint8_t *dst, int dst_stride, int dst_w, int dst_h) {
+  for (int y = 0; y < dst_h; ++y) {
+    for (int x = 0; x < dst_w; ++x) {
+      dst[y * dst_stride + x] = src[(y * src_h / dst_h) * src_stride + (x * src_w / dst_w)];
+    }
+  }
+}
+
+// same integer BT.601 limited-range formula the kernels implement
+void ref_nv12_to_rgba(const uint8_t *src_y, int sy, const uint8_t *src_uv, int suv,
+                      uint8_t *dst, int dst_stride, int width, int height) {
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      const int c = (src_y[y * sy + x] - 16) * 298;
+      const int d = src_uv[(y / 2) * suv + (x & ~1)] - 128;
+      const int e = src_uv[(y / 2) * suv + (x & ~1) + 1] - 128;
+      uint8_t *px = dst + y * dst_stride + 4 * x;
+      px[0] = (uint8_t)std::clamp((c + 409 * e + 128) >> 8, 0, 255);
+      px[1] = (uint8_t)std::clamp((c - 100 * d - 208 * e + 128) >> 8, 0, 255);
+      px[2] = (uint8_t)std::clamp((c + 516 * d + 128) >> 8, 0, 255);
+      px[3] = 255;
+    }
+  }
+}
+
+std::vector<uint8_t> random_plane(size_t size, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::vector<uint8_t> buf(size);
+  for (auto &b : buf) b = (uint8_t)rng();
+  return buf;
+}
+
+// camera frame, qcam, and an even-but-unaligned size that exercises the SIMD tails
+struct FrameSize { int w, h; };
+const FrameSize SIZES[] = {{1928, 1208}, {526, 330}, {634, 482}};
+
+}  // namespace
+
+TEST_CASE("yuv nv12/i420 conversions") {
+  for (const auto &[W, H] : SIZES) {
+    // sloppy strides so row addressing bugs can't hide
+    const int stride_y = W + 32, stride_uv = W + 32, stride_c = W / 2 + 16;
+    auto src_y = random_plane((size_t)stride_y * H, W);
+    auto src_uv = random_plane((size_t)stride_uv * (H / 2), W + 1);
+
+    std::vector<uint8_t> got_y(stride_y * H), got_u(stride_c * (H / 2)), got_v(stride_c * (H / 2));
+    std::vector<uint8_t> ref_y(stride_y * H), ref_u(stride_c * (H / 2)), ref_v(stride_c * (H / 2));
+
+    yuv::nv12_to_i420(src_y.data(), stride_y, src_uv.data(), stride_uv,
+                      got_y.data(), stride_y, got_u.data(), stride_c, got_v.data(), stride_c, W, H);
+    ref_nv12_to_i420(src_y.data(), stride_y, src_uv.data(), stride_uv,
+                     ref_y.data(), stride_y, ref_u.data(), stride_c, ref_v.data(), stride_c, W, H);
+    REQUIRE(got_y == ref_y);
+    REQUIRE(got_u == ref_u);
+    REQUIRE(got_v == ref_v);
+
+    // interleaving back must reproduce the original UV plane exactly
+    std::vector<uint8_t> round_y(stride_y * H), round_uv(stride_uv * (H / 2));
+    yuv::i420_to_nv12(got_y.data(), stride_y, got_u.data(), stride_c, got_v.data(), stride_c,
+                      round_y.data(), stride_y, round_uv.data(), stride_uv, W, H);
+    for (int y = 0; y < H; ++y) {
+      REQUIRE(memcmp(round_y.data() + y * stride_y, src_y.data() + y * stride_y, W) == 0);
+    }
+    for (int y = 0; y < H / 2; ++y) {
+      REQUIRE(memcmp(round_uv.data() + y * stride_uv, src_uv.data() + y * stride_uv, W) == 0);
+    }
+  }
+}
+
+TEST_CASE("yuv i420 scaling") {
+  const int SW = 1928, SH = 1208;
+  const int stride = SW, stride_c = SW / 2;
+  auto src_y = random_plane((size_t)stride * SH, 1);
+  auto src_u = random_plane((size_t)stride_c * (SH / 2), 2);
+  auto src_v = random_plane((size_t)stride_c * (SH / 2), 3);
+
+  for (const auto &[DW, DH] : {FrameSize{526, 330}, FrameSize{964, 604}, FrameSize{1928, 1208}}) {
+    std::vector<uint8_t> got_y(DW * DH), got_u((DW / 2) * (DH / 2)), got_v((DW / 2) * (DH / 2));
+    yuv::i420_scale(src_y.data(), stride, src_u.data(), stride_c, src_v.data(), stride_c, SW, SH,
+                    got_y.data(), DW, got_u.data(), DW / 2, got_v.data(), DW / 2, DW, DH);
+
+    std::vector<uint8_t> ref_y(DW * DH), ref_u((DW / 2) * (DH / 2)), ref_v((DW / 2) * (DH / 2));
+    ref_scale_point(src_y.data(), stride, SW, SH, ref_y.data(), DW, DW, DH);
+    ref_scale_point(src_u.data(), stride_c, SW / 2, SH / 2, ref_u.data(), DW / 2, DW / 2, DH / 2);
+    ref_scale_point(src_v.data(), stride_c, SW / 2, SH / 2, ref_v.data(), DW / 2, DW / 2, DH / 2);
+    REQUIRE(got_y == ref_y);
+    REQUIRE(got_u == ref_u);
+    REQUIRE(got_v == ref_v);
+
+    // tiled point scaler matches i420_scale, on one thread and several
+    for (int threads : {1, 4}) {
+      std::vector<uint8_t> tiled_y(DW * DH), tiled_u((DW / 2) * (DH / 2)), tiled_v((DW / 2) * (DH / 2));
+      yuv::i420_scale_tiled(src_y.data(), stride, src_u.data(), stride_c, src_v.data(), stride_c, SW, SH,
+                            tiled_y.data(), DW, tiled_u.data(), DW / 2, tiled_v.data(), DW / 2, DW, DH,
+                            false, threads);
+      REQUIRE(tiled_y == ref_y);
+      REQUIRE(tiled_u == ref_u);
+      REQUIRE(tiled_v == ref_v);
+    }
+
+    // bilinear output has no scalar reference here, but must not depend on
+    // the thread count
+    std::vector<uint8_t> bl1_y(DW * DH), bl1_u((DW / 2) * (DH / 2)), bl1_v((DW / 2) * (DH / 2));
+    std::vector<uint8_t> bl4_y(DW * DH), bl4_u((DW / 2) * (DH / 2)), bl4_v((DW / 2) * (DH / 2));
+    yuv::i420_scale_tiled(src_y.data(), stride, src_u.data(), stride_c, src_v.data(), stride_c, SW, SH,
+                          bl1_y.data(), DW, bl1_u.data(), DW / 2, bl1_v.data(), DW / 2, DW, DH, true, 1);
+    yuv::i420_scale_tiled(src_y.data(), stride, src_u.data(), stride_c, src_v.data(), stride_c, SW, SH,
+                          bl4_y.data(), DW, bl4_u.data(), DW / 2, bl4_v.data(), DW / 2, DW, DH, true, 4);
+    REQUIRE(bl1_y == bl4_y);
+    REQUIRE(bl1_u == bl4_u);
+    REQUIRE(bl1_v == bl4_v);
+  }
+}
+
+TEST_CASE("yuv nv12 to rgba") {
+  for (const auto &[W, H] : SIZES) {
+    const int stride_y = W + 32, stride_uv = W + 32, stride_rgba = 4 * W + 64;
+    auto src_y = random_plane((size_t)stride_y * H, W + 2);
+    auto src_uv = random_plane((size_t)stride_uv * (H / 2), W + 3);
+
+    std::vector<uint8_t> got((size_t)stride_rgba * H), ref((size_t)stride_rgba * H);
+    yuv::nv12_to_rgba(src_y.data(), stride_y, src_uv.data(), stride_uv, got.data(), stride_rgba, W, H);
+    ref_nv12_to_rgba(src_y.data(), stride_y, src_uv.data(), stride_uv, ref.data(), stride_rgba, W, H);
+    for (int y = 0; y < H; ++y) {
+      REQUIRE(memcmp(got.data() + y * stride_rgba, ref.data() + y * stride_rgba, 4 * W) == 0);
+    }
+
+    for (int threads : {2, 4}) {
+      std::vector<uint8_t> mt((size_t)stride_rgba * H);
+      yuv::nv12_to_rgba_mt(src_y.data(), stride_y, src_uv.data(), stride_uv, mt.data(), stride_rgba, W, H, threads);
+      for (int y = 0; y < H; ++y) {
+        REQUIRE(memcmp(mt.data() + y * stride_rgba, ref.data() + y * stride_rgba, 4 * W) == 0);
+      }
+    }
+  }
+}
+
+// hidden from the default run; invoke with ./test_common "[bench]" to get
+// per-kernel GB/s on the build machine or device
+TEST_CASE("yuv kernel throughput", "[.][bench]") {
+  const int W = 1928, H = 1208;
+  const size_t y_size = (size_t)W * H, uv_size = y_size / 2, c_size = uv_size / 2;
+  auto src_y = random_plane(y_size, 1);
+  auto src_uv = random_plane(uv_size, 2);
+  std::vector<uint8_t> u(c_size), v(c_size), y2(y_size), uv2(uv_size);
+  std::vector<uint8_t> small_y((size_t)526 * 330), small_u((size_t)263 * 165), small_v((size_t)263 * 165);
+  std::vector<uint8_t> rgba(4 * y_size);
+
+  auto bench = [](const char *name, size_t bytes, auto &&fn) {
+    fn();  // warm caches and spin up any threads
+    const int reps = 20;
+    double t0 = millis_since_boot();
+    for (int i = 0; i < reps; ++i) fn();
+    double ms = (millis_since_boot() - t0) / reps;
+    printf("%-28s %7.2f ms  %6.2f GB/s\n", name, ms, bytes / (ms / 1e3) / 1e9);
+  };
+
+  bench("nv12_to_i420", 2 * (y_size + uv_size), [&] {
+    yuv::nv12_to_i420(src_y.data(), W, src_uv.data(), W, y2.data(), W, u.data(), W / 2, v.data(), W / 2, W, H);
+  });
+  bench("i420_to_nv12", 2 * (y_size + uv_size), [&] {
+    yuv::i420_to_nv12(y2.data(), W, u.data(), W / 2, v.data(), W / 2, src_y.data(), W, uv2.data(), W, W, H);
+  });
+  bench("i420_scale 1928->526", y_size + uv_size, [&] {
+    yuv::i420_scale(src_y.data(), W, u.data(), W / 2, v.data(), W / 2, W, H,
+                    small_y.data(), 526, small_u.data(), 263, small_v.data(), 263, 526, 330);
+  });
+  bench("i420_scale_tiled bilin x4", y_size + uv_size, [&] {
+    yuv::i420_scale_tiled(src_y.data(), W, u.data(), W / 2, v.data(), W / 2, W, H,
+                          small_y.data(), 526, small_u.data(), 263, small_v.data(), 263, 526, 330, true, 4);
+  });
+  bench("nv12_to_rgba", y_size + uv_size + 4 * y_size, [&] {
+    yuv::nv12_to_rgba(src_y.data(), W, src_uv.data(), W, rgba.data(), 4 * W, W, H);
+  });
+  bench("nv12_to_rgba_mt x4", y_size + uv_size + 4 * y_size, [&] {
+    yuv::nv12_to_rgba_mt(src_y.data(), W, src_uv.data(), W, rgba.data(), 4 * W, W, H, 4);
+  });
+}
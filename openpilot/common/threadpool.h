@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+#include "common/util.h"
+
+// Process-wide work-stealing task pool for the tools. replay's segment
+// loading, cabana's chart sampling and jotpluggler's route loader each used
+// to spin up private threads with ad hoc queues, oversubscribing cores when
+// the tools run together; ThreadPool::shared() sizes one pool to the machine
+// and lets them share it.
+//
+// Each worker owns a deque: it runs its own tasks LIFO (freshly posted work
+// still has warm caches) and steals FIFO from the other workers when it runs
+// dry, so no worker idles while another has a backlog. Within a worker,
+// higher-priority tasks always dispatch first. An affinity hint routes tasks
+// with the same hint to the same worker's deque, keeping related work (e.g.
+// one chart's samples) on one core unless it gets stolen by an idle one.
+class ThreadPool {
+public:
+  enum class Priority { High = 0, Normal = 1, Low = 2 };
+
+  explicit ThreadPool(int num_threads = 0) {
+    int n = num_threads > 0 ? num_threads : (int)std::max(2u, std::thread::hardware_concurrency());
+    for (int i = 0; i < n; ++i) workers_.emplace_back(std::make_unique<Worker>());
+    for (int i = 0; i < n; ++i) threads_.emplace_back(&ThreadPool::workerLoop, this, i);
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard lk(sleep_m_);
+      exit_ = true;
+    }
+    sleep_cv_.notify_all();
+    for (auto &t : threads_) t.join();
+  }
+
+  static ThreadPool &shared() {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  // affinity >= 0 routes equal hints to the same worker; -1 round-robins
+  void post(std::function<void()> task, Priority prio = Priority::Normal, int affinity = -1) {
+    size_t w = (affinity >= 0 ? (size_t)affinity : next_.fetch_add(1, std::memory_order_relaxed)) % workers_.size();
+    {
+      std::lock_guard lk(workers_[w]->m);
+      workers_[w]->q[(int)prio].push_back(std::move(task));
+    }
+    pending_.fetch_add(1, std::memory_order_release);
+    {
+      // taking the lock orders the notify against a worker that just checked
+      // the predicate and is about to park
+      std::lock_guard lk(sleep_m_);
+    }
+    sleep_cv_.notify_one();
+  }
+
+  // blocks until every posted task has finished; mostly for tests and teardown
+  void wait() {
+    std::unique_lock lk(sleep_m_);
+    done_cv_.wait(lk, [this] { return pending_.load() == 0 && active_.load() == 0; });
+  }
+
+  int numWorkers() const { return (int)workers_.size(); }
+
+private:
+  struct Worker {
+    std::mutex m;
+    std::deque<std::function<void()>> q[3];
+  };
+
+  bool popTask(size_t w, bool lifo, std::function<void()> &task) {
+    std::lock_guard lk(workers_[w]->m);
+    for (auto &q : workers_[w]->q) {
+      if (!q.empty()) {
+        task = std::move(lifo ? q.back() : q.front());
+        lifo ? q.pop_back() : q.pop_front();
+        // claim the task as active before dropping it from pending, so
+        // wait()'s predicate never sees both counters at zero mid-transfer
+        active_.fetch_add(1, std::memory_order_relaxed);
+        pending_.fetch_sub(1, std::memory_order_release);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void workerLoop(int idx) {
+    util::set_thread_name("threadpool");
+    while (true) {
+      std::function<void()> task;
+      bool found = popTask(idx, true, task);
+      for (size_t k = 1; !found && k < workers_.size(); ++k) {
+        found = popTask((idx + k) % workers_.size(), false, task);
+      }
+      if (found) {
+        task();
+        if (active_.fetch_sub(1, std::memory_order_acq_rel) == 1 && pending_.load() == 0) {
+          std::lock_guard lk(sleep_m_);
+          done_cv_.notify_all();
+        }
+        continue;
+      }
+      std::unique_lock lk(sleep_m_);
+      sleep_cv_.wait(lk, [this] { return exit_ || pending_.load(std::memory_order_acquire) > 0; });
+      if (exit_) return;
+    }
+  }
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+  std::atomic<size_t> next_{0};
+  std::atomic<size_t> pending_{0};
+  std::atomic<size_t> active_{0};
+  std::mutex sleep_m_;
+  std::condition_variable sleep_cv_, done_cv_;
+  bool exit_ = false;
+};
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <ctime>
+#include <mutex>
+#include <thread>
 
 #ifdef __APPLE__
 #define CLOCK_BOOTTIME CLOCK_MONOTONIC
@@ -37,6 +40,31 @@ static inline double seconds_since_epoch() {
   return (double)t.tv_sec + t.tv_nsec * 1e-9;
 }
 
+// Coarse timestamping for hot paths that build tens of thousands of events per
+// second: a 1 kHz ticker thread publishes boottime into an atomic, and
+// nanos_since_boot_coarse() reads it without a clock_gettime call. Until
+// start_coarse_timing_thread() is called the coarse read transparently falls
+// back to the precise clock, so precision stays opt-out per process.
+inline std::atomic<uint64_t> coarse_boottime_ns{0};
+
+inline void start_coarse_timing_thread() {
+  static std::once_flag once;
+  std::call_once(once, []() {
+    std::thread([]() {
+      while (true) {
+        coarse_boottime_ns.store(nanos_since_boot(), std::memory_order_relaxed);
+        struct timespec ts = {0, 1000000};  // 1 ms
+        nanosleep(&ts, nullptr);
+      }
+    }).detach();
+  });
+}
+
+static inline uint64_t nanos_since_boot_coarse() {
+  uint64_t t = coarse_boottime_ns.load(std::memory_order_relaxed);
+  return t != 0 ? t : nanos_since_boot();
+}
+
 // you probably should use nanos_since_boot instead
 static inline uint64_t nanos_monotonic() {
   struct timespec t;
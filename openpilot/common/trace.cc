@@ -0,0 +1,66 @@
+#include "common/trace.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+
+#include "common/timing.h"
+
+namespace optrace {
+
+Shm *shm() {
+  static Shm *s = []() -> Shm * {
+    if (getenv("OPTRACE") == nullptr) return nullptr;
+
+    char path[64];
+    snprintf(path, sizeof(path), "/dev/shm/optrace_%d", getpid());
+    int fd = open(path, O_CREAT | O_RDWR, 0644);
+    if (fd < 0) return nullptr;
+    if (ftruncate(fd, sizeof(Shm)) != 0) {
+      close(fd);
+      return nullptr;
+    }
+    void *addr = mmap(nullptr, sizeof(Shm), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) return nullptr;
+
+    Shm *ret = (Shm *)addr;
+    ret->num_records = kNumRecords;
+    ret->magic = kMagic;
+    return ret;
+  }();
+  return s;
+}
+
+int registerEvent(const char *name) {
+  Shm *s = shm();
+  if (s == nullptr) return -1;
+
+  static std::mutex lock;
+  static int next_id = 0;
+  std::lock_guard lk(lock);
+  if (next_id >= kMaxEvents) return -1;
+  int id = next_id++;
+  strncpy(s->names[id], name, kMaxNameLen - 1);
+  return id;
+}
+
+void emit(int event_id, uint8_t phase) {
+  Shm *s = shm();
+  if (s == nullptr) return;
+
+  static thread_local uint16_t tid = (uint16_t)syscall(SYS_gettid);
+  uint64_t idx = s->write_idx.fetch_add(1, std::memory_order_relaxed);
+  Record &r = s->records[idx % kNumRecords];
+  r.ts_ns = nanos_since_boot();
+  r.event_id = (uint32_t)event_id;
+  r.tid = tid;
+  r.phase = phase;
+}
+
+}  // namespace optrace
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+// Lightweight hot-path tracing: RAII spans write 16-byte records into a
+// per-process file-backed ring in /dev/shm, so microsecond-resolution
+// timelines can be captured in production and inspected after the fact with
+// tools/scripts/profiling/optrace_dump.py. Disabled (every call a no-op)
+// unless the process is started with OPTRACE=1.
+//
+//   void loop() {
+//     OP_TRACE_SPAN("can_recv");
+//     ...
+//   }
+
+namespace optrace {
+
+constexpr uint32_t kMagic = 0x4f505452;  // "OPTR"
+constexpr int kMaxEvents = 64;
+constexpr int kMaxNameLen = 32;
+constexpr uint32_t kNumRecords = 1 << 16;
+
+struct Record {  // 16 bytes
+  uint64_t ts_ns;
+  uint32_t event_id;
+  uint16_t tid;
+  uint8_t phase;  // 0 = begin, 1 = end
+  uint8_t pad;
+};
+
+struct Shm {
+  uint32_t magic;
+  uint32_t num_records;
+  std::atomic<uint64_t> write_idx;
+  char names[kMaxEvents][kMaxNameLen];
+  Record records[kNumRecords];
+};
+
+// nullptr unless OPTRACE=1; lazily maps /dev/shm/optrace_<pid>
+Shm *shm();
+int registerEvent(const char *name);
+void emit(int event_id, uint8_t phase);
+
+class Span {
+public:
+  explicit Span(int event_id) : event_id_(event_id) {
+    if (event_id_ >= 0) emit(event_id_, 0);
+  }
+  ~Span() {
+    if (event_id_ >= 0) emit(event_id_, 1);
+  }
+
+private:
+  int event_id_;
+};
+
+}  // namespace optrace
+
+#define OP_TRACE_CONCAT_(a, b) a##b
+#define OP_TRACE_CONCAT(a, b) OP_TRACE_CONCAT_(a, b)
+#define OP_TRACE_SPAN(name)                                                             \
+  static const int OP_TRACE_CONCAT(op_trace_ev_, __LINE__) = optrace::registerEvent(name); \
+  optrace::Span OP_TRACE_CONCAT(op_trace_span_, __LINE__)(OP_TRACE_CONCAT(op_trace_ev_, __LINE__))
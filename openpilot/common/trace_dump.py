@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+"""Dump an optrace ring (common/trace.h) as a microsecond timeline.
+
+Usage: trace_dump.py /dev/shm/optrace_<pid>
+"""
+import struct
+import sys
+
+MAGIC = 0x4f505452
+MAX_EVENTS = 64
+MAX_NAME_LEN = 32
+HEADER_FMT = "<IIQ"  # magic, num_records, write_idx
+RECORD_FMT = "<QIHBB"  # ts_ns, event_id, tid, phase, pad
+RECORD_SIZE = struct.calcsize(RECORD_FMT)
+
+
+def dump(fn: str) -> None:
+  with open(fn, "rb") as f:
+    data = f.read()
+
+  magic, num_records, write_idx = struct.unpack_from(HEADER_FMT, data, 0)
+  if magic != MAGIC:
+    raise SystemExit(f"{fn}: bad magic {magic:#x}")
+
+  names_off = struct.calcsize(HEADER_FMT)
+  names = []
+  for i in range(MAX_EVENTS):
+    raw = data[names_off + i * MAX_NAME_LEN:names_off + (i + 1) * MAX_NAME_LEN]
+    names.append(raw.split(b"\0", 1)[0].decode())
+
+  records_off = names_off + MAX_EVENTS * MAX_NAME_LEN
+  # oldest record first when the ring has wrapped
+  start = write_idx % num_records if write_idx > num_records else 0
+  count = min(write_idx, num_records)
+
+  open_spans = {}  # (tid, event_id) -> begin ts
+  for n in range(count):
+    idx = (start + n) % num_records
+    ts_ns, event_id, tid, phase, _ = struct.unpack_from(RECORD_FMT, data, records_off + idx * RECORD_SIZE)
+    name = names[event_id] if event_id < MAX_EVENTS and names[event_id] else f"event_{event_id}"
+    if phase == 0:
+      open_spans[(tid, event_id)] = ts_ns
+      print(f"{ts_ns / 1e3:16.1f} us  tid={tid:<6} B {name}")
+    else:
+      begin = open_spans.pop((tid, event_id), None)
+      dur = f" ({(ts_ns - begin) / 1e3:.1f} us)" if begin is not None else ""
+      print(f"{ts_ns / 1e3:16.1f} us  tid={tid:<6} E {name}{dur}")
+
+
+if __name__ == "__main__":
+  if len(sys.argv) != 2:
+    raise SystemExit(__doc__)
+  dump(sys.argv[1])
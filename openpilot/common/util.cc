@@ -2,6 +2,7 @@
 #include "common/swaglog.h"
 
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/resource.h>
 
@@ -100,6 +101,59 @@ std::string read_file(const std::string& fn) {
   return std::string();
 }
 
+MappedFile::~MappedFile() {
+  if (addr_) munmap(addr_, size_);
+}
+
+MappedFile map_file(const std::string &fn) {
+  MappedFile m;
+  int fd = HANDLE_EINTR(open(fn.c_str(), O_RDONLY));
+  if (fd >= 0) {
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+      void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED) {
+        m.addr_ = addr;
+        m.size_ = st.st_size;
+      }
+    }
+    close(fd);
+  }
+  return m;
+}
+
+StreamingFileReader::StreamingFileReader(const std::string &fn, size_t chunk_size) {
+  fd_ = HANDLE_EINTR(open(fn.c_str(), O_RDONLY));
+  if (fd_ >= 0) {
+    buf_.resize(chunk_size);
+#ifdef __linux__
+    posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+  }
+}
+
+StreamingFileReader::~StreamingFileReader() {
+  if (fd_ >= 0) close(fd_);
+}
+
+std::string_view StreamingFileReader::next() {
+  if (fd_ < 0) return {};
+
+#ifdef __linux__
+  // drop the pages we just consumed so a big ingest doesn't evict everything
+  // else from the page cache, and prefetch the next chunk
+  if (offset_ > 0) {
+    posix_fadvise(fd_, 0, offset_, POSIX_FADV_DONTNEED);
+  }
+  posix_fadvise(fd_, offset_, buf_.size(), POSIX_FADV_WILLNEED);
+#endif
+
+  ssize_t n = HANDLE_EINTR(read(fd_, buf_.data(), buf_.size()));
+  if (n <= 0) return {};
+  offset_ += n;
+  return std::string_view(buf_.data(), n);
+}
+
 std::map<std::string, std::string> read_files_in_dir(const std::string &path) {
   std::map<std::string, std::string> ret;
   DIR *d = opendir(path.c_str());
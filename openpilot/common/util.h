@@ -12,6 +12,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 
@@ -82,6 +83,52 @@ std::string random_string(std::string::size_type length);
 
 // **** file helpers *****
 std::string read_file(const std::string& fn);
+
+// mmap-backed whole-file read: returns a movable view with no copy; pages
+// fault in on demand and the mapping is released on destruction. Falls back
+// to an empty view on failure (use read_file for procfs-style files).
+class MappedFile {
+public:
+  MappedFile() = default;
+  MappedFile(MappedFile &&other) { *this = std::move(other); }
+  MappedFile &operator=(MappedFile &&other) {
+    std::swap(addr_, other.addr_);
+    std::swap(size_, other.size_);
+    return *this;
+  }
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  ~MappedFile();
+
+  const char *data() const { return (const char *)addr_; }
+  size_t size() const { return size_; }
+  std::string_view view() const { return addr_ ? std::string_view(data(), size_) : std::string_view(); }
+  explicit operator bool() const { return addr_ != nullptr; }
+
+private:
+  friend MappedFile map_file(const std::string &fn);
+  void *addr_ = nullptr;
+  size_t size_ = 0;
+};
+MappedFile map_file(const std::string &fn);
+
+// Chunked sequential reader for multi-hundred-MB files (rlogs, bootlogs):
+// advises the kernel of sequential access up front and drops consumed pages
+// behind the read position, so big ingests don't evict the rest of the page
+// cache. Each next() returns a view into an internal buffer that stays valid
+// until the following call; an empty view means EOF or error.
+class StreamingFileReader {
+public:
+  explicit StreamingFileReader(const std::string &fn, size_t chunk_size = 4 * 1024 * 1024);
+  ~StreamingFileReader();
+  bool ok() const { return fd_ >= 0; }
+  std::string_view next();
+
+private:
+  int fd_ = -1;
+  std::vector<char> buf_;
+  off_t offset_ = 0;
+};
 std::map<std::string, std::string> read_files_in_dir(const std::string& path);
 int write_file(const char* path, const void* data, size_t size, int flags = O_WRONLY, mode_t mode = 0664);
 
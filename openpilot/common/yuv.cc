@@ -2,6 +2,14 @@
 
 #include <algorithm>
 #include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
 
 namespace yuv {
 
@@ -39,6 +47,78 @@ void scale_plane_point(const uint8_t *src, int src_stride, int src_width, int sr
   }
 }
 
+// Bilinear scale of a tile of destination rows [y0, y1). Column offsets and
+// weights are precomputed per tile so the inner loop is sequential loads from
+// two source rows, which stay cache-resident across the row pair.
+void scale_plane_bilinear_tile(const uint8_t *src, int src_stride, int src_width, int src_height,
+                               uint8_t *dst, int dst_stride, int dst_width, int dst_height,
+                               int y0, int y1) {
+  std::vector<int32_t> x_off(dst_width);
+  std::vector<int32_t> x_frac(dst_width);
+  const int64_t x_ratio = ((int64_t)src_width << 16) / dst_width;
+  for (int x = 0; x < dst_width; ++x) {
+    int64_t fx = x * x_ratio + (x_ratio >> 1) - 32768;
+    fx = std::max<int64_t>(fx, 0);
+    x_off[x] = std::min<int32_t>(fx >> 16, src_width - 2 >= 0 ? src_width - 2 : 0);
+    x_frac[x] = fx & 0xffff;
+  }
+
+  const int64_t y_ratio = ((int64_t)src_height << 16) / dst_height;
+  for (int y = y0; y < y1; ++y) {
+    int64_t fy = y * y_ratio + (y_ratio >> 1) - 32768;
+    fy = std::max<int64_t>(fy, 0);
+    int sy = std::min<int32_t>(fy >> 16, src_height - 2 >= 0 ? src_height - 2 : 0);
+    int wy = fy & 0xffff;
+
+    const uint8_t *r0 = src + sy * src_stride;
+    const uint8_t *r1 = src + std::min(sy + 1, src_height - 1) * src_stride;
+    uint8_t *dst_row = dst + y * dst_stride;
+    for (int x = 0; x < dst_width; ++x) {
+      int sx = x_off[x], wx = x_frac[x];
+      int x1 = std::min(sx + 1, src_width - 1);
+      int top = r0[sx] * (65536 - wx) + r0[x1] * wx;
+      int bot = r1[sx] * (65536 - wx) + r1[x1] * wx;
+      dst_row[x] = (uint8_t)((int64_t(top) * (65536 - wy) + int64_t(bot) * wy + (1LL << 31)) >> 32);
+    }
+  }
+}
+
+constexpr int kScaleTileRows = 64;
+
+void scale_plane_tiled(const uint8_t *src, int src_stride, int src_width, int src_height,
+                       uint8_t *dst, int dst_stride, int dst_width, int dst_height,
+                       bool bilinear, int threads) {
+  auto run_tiles = [&](int tile0, int tile_step) {
+    for (int y0 = tile0 * kScaleTileRows; y0 < dst_height; y0 += tile_step * kScaleTileRows) {
+      int y1 = std::min(y0 + kScaleTileRows, dst_height);
+      if (bilinear) {
+        scale_plane_bilinear_tile(src, src_stride, src_width, src_height,
+                                  dst, dst_stride, dst_width, dst_height, y0, y1);
+      } else {
+        for (int y = y0; y < y1; ++y) {
+          const uint8_t *src_row = src + (y * src_height / dst_height) * src_stride;
+          uint8_t *dst_row = dst + y * dst_stride;
+          for (int x = 0; x < dst_width; ++x) {
+            dst_row[x] = src_row[x * src_width / dst_width];
+          }
+        }
+      }
+    }
+  };
+
+  int num_tiles = (dst_height + kScaleTileRows - 1) / kScaleTileRows;
+  threads = std::clamp(threads, 1, num_tiles);
+  if (threads <= 1) {
+    run_tiles(0, 1);
+  } else {
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+      workers.emplace_back(run_tiles, t, threads);
+    }
+    for (auto &w : workers) w.join();
+  }
+}
+
 // BT.601 limited range → RGB (integer form used widely, incl. similar to libyuv).
 inline void yuv_to_rgb(int y, int u, int v, uint8_t *r, uint8_t *g, uint8_t *b) {
   const int c = (y - 16) * 298;
@@ -65,7 +145,23 @@ void nv12_to_i420(const uint8_t *src_y, int src_stride_y,
     const uint8_t *uv = src_uv + y * src_stride_uv;
     uint8_t *u = dst_u + y * dst_stride_u;
     uint8_t *v = dst_v + y * dst_stride_v;
-    for (int x = 0; x < uv_width; ++x) {
+    int x = 0;
+#if defined(__ARM_NEON)
+    for (; x + 16 <= uv_width; x += 16) {
+      uint8x16x2_t d = vld2q_u8(uv + 2 * x);
+      vst1q_u8(u + x, d.val[0]);
+      vst1q_u8(v + x, d.val[1]);
+    }
+#elif defined(__SSE4_1__)
+    const __m128i mask = _mm_set1_epi16(0x00ff);
+    for (; x + 16 <= uv_width; x += 16) {
+      __m128i a = _mm_loadu_si128((const __m128i *)(uv + 2 * x));
+      __m128i b = _mm_loadu_si128((const __m128i *)(uv + 2 * x + 16));
+      _mm_storeu_si128((__m128i *)(u + x), _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask)));
+      _mm_storeu_si128((__m128i *)(v + x), _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8)));
+    }
+#endif
+    for (; x < uv_width; ++x) {
       u[x] = uv[2 * x];
       v[x] = uv[2 * x + 1];
     }
@@ -109,24 +205,149 @@ void i420_scale(const uint8_t *src_y, int src_stride_y,
                     dst_v, dst_stride_v, dst_width / 2, dst_height / 2);
 }
 
+void i420_scale_tiled(const uint8_t *src_y, int src_stride_y,
+                      const uint8_t *src_u, int src_stride_u,
+                      const uint8_t *src_v, int src_stride_v,
+                      int src_width, int src_height,
+                      uint8_t *dst_y, int dst_stride_y,
+                      uint8_t *dst_u, int dst_stride_u,
+                      uint8_t *dst_v, int dst_stride_v,
+                      int dst_width, int dst_height,
+                      bool bilinear, int threads) {
+  scale_plane_tiled(src_y, src_stride_y, src_width, src_height,
+                    dst_y, dst_stride_y, dst_width, dst_height, bilinear, threads);
+  scale_plane_tiled(src_u, src_stride_u, src_width / 2, src_height / 2,
+                    dst_u, dst_stride_u, dst_width / 2, dst_height / 2, bilinear, threads);
+  scale_plane_tiled(src_v, src_stride_v, src_width / 2, src_height / 2,
+                    dst_v, dst_stride_v, dst_width / 2, dst_height / 2, bilinear, threads);
+}
+
+namespace {
+
+// One row of NV12 -> RGBA. The SIMD paths evaluate the exact integer formula
+// from yuv_to_rgb() on 8 pixels per iteration, so output is bit-identical to
+// the scalar path.
+void rgba_row(const uint8_t *y_row, const uint8_t *uv_row, uint8_t *dst, int width) {
+  int x = 0;
+#if defined(__ARM_NEON)
+  for (; x + 8 <= width; x += 8) {
+    uint8x8_t y8 = vld1_u8(y_row + x);
+    uint8x8_t uv8 = vld1_u8(uv_row + x);  // 4 UV pairs covering 8 pixels
+
+    // deinterleave, then duplicate each chroma sample over its pixel pair
+    uint8x8x2_t uz = vuzp_u8(uv8, uv8);
+    uint8x8_t u8v = vzip_u8(uz.val[0], uz.val[0]).val[0];
+    uint8x8_t v8v = vzip_u8(uz.val[1], uz.val[1]).val[0];
+
+    int16x8_t c = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(y8)), vdupq_n_s16(16));
+    int16x8_t d = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(u8v)), vdupq_n_s16(128));
+    int16x8_t e = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(v8v)), vdupq_n_s16(128));
+
+    int32x4_t c_lo = vaddq_s32(vmull_n_s16(vget_low_s16(c), 298), vdupq_n_s32(128));
+    int32x4_t c_hi = vaddq_s32(vmull_n_s16(vget_high_s16(c), 298), vdupq_n_s32(128));
+
+    int32x4_t r_lo = vmlal_n_s16(c_lo, vget_low_s16(e), 409);
+    int32x4_t r_hi = vmlal_n_s16(c_hi, vget_high_s16(e), 409);
+    int32x4_t g_lo = vmlal_n_s16(vmlal_n_s16(c_lo, vget_low_s16(d), -100), vget_low_s16(e), -208);
+    int32x4_t g_hi = vmlal_n_s16(vmlal_n_s16(c_hi, vget_high_s16(d), -100), vget_high_s16(e), -208);
+    int32x4_t b_lo = vmlal_n_s16(c_lo, vget_low_s16(d), 516);
+    int32x4_t b_hi = vmlal_n_s16(c_hi, vget_high_s16(d), 516);
+
+    uint8x8x4_t out;
+    out.val[0] = vqmovun_s16(vcombine_s16(vqmovn_s32(vshrq_n_s32(r_lo, 8)), vqmovn_s32(vshrq_n_s32(r_hi, 8))));
+    out.val[1] = vqmovun_s16(vcombine_s16(vqmovn_s32(vshrq_n_s32(g_lo, 8)), vqmovn_s32(vshrq_n_s32(g_hi, 8))));
+    out.val[2] = vqmovun_s16(vcombine_s16(vqmovn_s32(vshrq_n_s32(b_lo, 8)), vqmovn_s32(vshrq_n_s32(b_hi, 8))));
+    out.val[3] = vdup_n_u8(255);
+    vst4_u8(dst + 4 * x, out);
+  }
+#elif defined(__SSE4_1__)
+  const __m128i dup_u = _mm_setr_epi8(0, 0, 2, 2, 4, 4, 6, 6, -1, -1, -1, -1, -1, -1, -1, -1);
+  const __m128i dup_v = _mm_setr_epi8(1, 1, 3, 3, 5, 5, 7, 7, -1, -1, -1, -1, -1, -1, -1, -1);
+  for (; x + 8 <= width; x += 8) {
+    __m128i y16 = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)(y_row + x)));
+    __m128i uv8 = _mm_loadl_epi64((const __m128i *)(uv_row + x));
+    __m128i u16 = _mm_cvtepu8_epi16(_mm_shuffle_epi8(uv8, dup_u));
+    __m128i v16 = _mm_cvtepu8_epi16(_mm_shuffle_epi8(uv8, dup_v));
+
+    __m128i c16 = _mm_sub_epi16(y16, _mm_set1_epi16(16));
+    __m128i d16 = _mm_sub_epi16(u16, _mm_set1_epi16(128));
+    __m128i e16 = _mm_sub_epi16(v16, _mm_set1_epi16(128));
+
+    auto widen_lo = [](__m128i v) { return _mm_cvtepi16_epi32(v); };
+    auto widen_hi = [](__m128i v) { return _mm_cvtepi16_epi32(_mm_srli_si128(v, 8)); };
+
+    __m128i out16[3];
+    for (int ch = 0; ch < 3; ++ch) {
+      static const int kd[3] = {0, -100, 516};
+      static const int ke[3] = {409, -208, 0};
+      __m128i lo = _mm_add_epi32(_mm_mullo_epi32(widen_lo(c16), _mm_set1_epi32(298)), _mm_set1_epi32(128));
+      __m128i hi = _mm_add_epi32(_mm_mullo_epi32(widen_hi(c16), _mm_set1_epi32(298)), _mm_set1_epi32(128));
+      lo = _mm_add_epi32(lo, _mm_mullo_epi32(widen_lo(d16), _mm_set1_epi32(kd[ch])));
+      hi = _mm_add_epi32(hi, _mm_mullo_epi32(widen_hi(d16), _mm_set1_epi32(kd[ch])));
+      lo = _mm_add_epi32(lo, _mm_mullo_epi32(widen_lo(e16), _mm_set1_epi32(ke[ch])));
+      hi = _mm_add_epi32(hi, _mm_mullo_epi32(widen_hi(e16), _mm_set1_epi32(ke[ch])));
+      out16[ch] = _mm_packs_epi32(_mm_srai_epi32(lo, 8), _mm_srai_epi32(hi, 8));
+    }
+
+    __m128i r8 = _mm_packus_epi16(out16[0], out16[0]);
+    __m128i g8 = _mm_packus_epi16(out16[1], out16[1]);
+    __m128i b8 = _mm_packus_epi16(out16[2], out16[2]);
+    __m128i a8 = _mm_set1_epi8((char)255);
+    __m128i rg = _mm_unpacklo_epi8(r8, g8);
+    __m128i ba = _mm_unpacklo_epi8(b8, a8);
+    _mm_storeu_si128((__m128i *)(dst + 4 * x), _mm_unpacklo_epi16(rg, ba));
+    _mm_storeu_si128((__m128i *)(dst + 4 * x + 16), _mm_unpackhi_epi16(rg, ba));
+  }
+#endif
+  for (; x < width; ++x) {
+    const int uv_x = (x & ~1);
+    uint8_t r, g, b;
+    yuv_to_rgb(y_row[x], uv_row[uv_x], uv_row[uv_x + 1], &r, &g, &b);
+    dst[4 * x + 0] = r;
+    dst[4 * x + 1] = g;
+    dst[4 * x + 2] = b;
+    dst[4 * x + 3] = 255;
+  }
+}
+
+}  // namespace
+
 void nv12_to_rgba(const uint8_t *src_y, int src_stride_y,
                   const uint8_t *src_uv, int src_stride_uv,
                   uint8_t *dst_rgba, int dst_stride_rgba,
                   int width, int height) {
   for (int y = 0; y < height; ++y) {
-    const uint8_t *y_row = src_y + y * src_stride_y;
-    const uint8_t *uv_row = src_uv + (y / 2) * src_stride_uv;
-    uint8_t *dst = dst_rgba + y * dst_stride_rgba;
-    for (int x = 0; x < width; ++x) {
-      const int uv_x = (x & ~1);
-      uint8_t r, g, b;
-      yuv_to_rgb(y_row[x], uv_row[uv_x], uv_row[uv_x + 1], &r, &g, &b);
-      dst[4 * x + 0] = r;
-      dst[4 * x + 1] = g;
-      dst[4 * x + 2] = b;
-      dst[4 * x + 3] = 255;
-    }
+    rgba_row(src_y + y * src_stride_y, src_uv + (y / 2) * src_stride_uv,
+             dst_rgba + y * dst_stride_rgba, width);
+  }
+}
+
+void nv12_to_rgba_mt(const uint8_t *src_y, int src_stride_y,
+                     const uint8_t *src_uv, int src_stride_uv,
+                     uint8_t *dst_rgba, int dst_stride_rgba,
+                     int width, int height, int threads) {
+  threads = std::clamp(threads, 1, height / 2);
+  if (threads <= 1) {
+    nv12_to_rgba(src_y, src_stride_y, src_uv, src_stride_uv, dst_rgba, dst_stride_rgba, width, height);
+    return;
+  }
+
+  // split into even-height bands so no two threads share a UV row; round the
+  // band height up so the last band can never fall short of the image
+  std::vector<std::thread> workers;
+  int rows_per = (((height + threads - 1) / threads) + 1) & ~1;
+  for (int t = 0; t < threads; ++t) {
+    int y0 = t * rows_per;
+    int y1 = std::min(y0 + rows_per, height);
+    if (y0 >= y1) break;
+    workers.emplace_back([=]() {
+      nv12_to_rgba(src_y + y0 * src_stride_y, src_stride_y,
+                   src_uv + (y0 / 2) * src_stride_uv, src_stride_uv,
+                   dst_rgba + y0 * dst_stride_rgba, dst_stride_rgba,
+                   width, y1 - y0);
+    });
   }
+  for (auto &w : workers) w.join();
 }
 
 }  // namespace yuv
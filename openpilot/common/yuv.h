@@ -32,6 +32,19 @@ void i420_scale(const uint8_t *src_y, int src_stride_y,
                 uint8_t *dst_v, int dst_stride_v,
                 int dst_width, int dst_height);
 
+// Cache-blocked I420 scaler: processes the destination in 64-line tiles,
+// optionally with bilinear filtering and with tiles distributed across
+// `threads` worker threads. bilinear=false matches i420_scale output.
+void i420_scale_tiled(const uint8_t *src_y, int src_stride_y,
+                      const uint8_t *src_u, int src_stride_u,
+                      const uint8_t *src_v, int src_stride_v,
+                      int src_width, int src_height,
+                      uint8_t *dst_y, int dst_stride_y,
+                      uint8_t *dst_u, int dst_stride_u,
+                      uint8_t *dst_v, int dst_stride_v,
+                      int dst_width, int dst_height,
+                      bool bilinear = false, int threads = 1);
+
 // Convert NV12 to packed RGBA (R,G,B,A bytes — suitable for GL_RGBA).
 // BT.601 limited-range, matching common libyuv defaults.
 void nv12_to_rgba(const uint8_t *src_y, int src_stride_y,
@@ -39,4 +52,11 @@ void nv12_to_rgba(const uint8_t *src_y, int src_stride_y,
                   uint8_t *dst_rgba, int dst_stride_rgba,
                   int width, int height);
 
+// Row-parallel variant of nv12_to_rgba: splits the image into even-height
+// bands converted on `threads` worker threads. Output matches nv12_to_rgba.
+void nv12_to_rgba_mt(const uint8_t *src_y, int src_stride_y,
+                     const uint8_t *src_uv, int src_stride_uv,
+                     uint8_t *dst_rgba, int dst_stride_rgba,
+                     int width, int height, int threads);
+
 }
@@ -0,0 +1,100 @@
+#include "selfdrive/locationd/lag_corr.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+namespace lag_corr {
+
+LagCorrelator::LagCorrelator(int window_len, int lag_min, int lag_max)
+    : window_len_(window_len), lag_min_(lag_min), lag_max_(lag_max),
+      expected_(window_len), actual_(window_len), okay_(window_len),
+      sums_(lag_max - lag_min) {
+  assert(window_len > 0 && lag_max > lag_min);
+}
+
+void LagCorrelator::reset() {
+  size_ = 0;
+  next_ = 0;
+  std::fill(sums_.begin(), sums_.end(), LagSums{});
+}
+
+void LagCorrelator::add_pair(LagSums &s, double x, double y, double sign) {
+  s.n += sign;
+  s.sx += sign * x;
+  s.sy += sign * y;
+  s.sxx += sign * x * x;
+  s.syy += sign * y * y;
+  s.sxy += sign * x * y;
+}
+
+void LagCorrelator::push(double expected, double actual, bool okay) {
+  if (size_ == window_len_) {
+    // evict the oldest sample: drop every pair it forms with a newer one
+    const int64_t oldest = next_ - window_len_;
+    const int slot = oldest % window_len_;
+    if (okay_[slot]) {
+      for (int lag = lag_min_; lag < lag_max_; ++lag) {
+        // lag > 0 pairs the evictee's expected with a newer actual,
+        // lag < 0 pairs a newer expected with the evictee's actual
+        const int64_t partner = oldest + std::abs(lag);
+        if (partner >= next_) continue;
+        const int pslot = partner % window_len_;
+        if (!okay_[pslot]) continue;
+        if (lag >= 0) {
+          add_pair(sums_[lag - lag_min_], expected_[slot], actual_[pslot], -1.0);
+        } else {
+          add_pair(sums_[lag - lag_min_], expected_[pslot], actual_[slot], -1.0);
+        }
+      }
+    }
+    --size_;
+  }
+
+  const int slot = next_ % window_len_;
+  expected_[slot] = expected;
+  actual_[slot] = actual;
+  okay_[slot] = okay;
+  ++size_;
+  ++next_;
+
+  if (okay) {
+    // pair the new sample with every older one within the lag range
+    for (int lag = lag_min_; lag < lag_max_; ++lag) {
+      const int64_t partner = next_ - 1 - std::abs(lag);
+      if (partner < next_ - size_) continue;
+      const int pslot = partner % window_len_;
+      if (!okay_[pslot]) continue;
+      if (lag > 0) {
+        add_pair(sums_[lag - lag_min_], expected_[pslot], actual_[slot], 1.0);
+      } else if (lag < 0) {
+        add_pair(sums_[lag - lag_min_], expected_[slot], actual_[pslot], 1.0);
+      } else {
+        add_pair(sums_[lag - lag_min_], expected_[slot], actual_[slot], 1.0);
+      }
+    }
+  }
+}
+
+void LagCorrelator::ncc(double *out) const {
+  const int n_lags = num_lags();
+  std::vector<double> numerator(n_lags), denom(n_lags);
+  double max_denom = 0.0;
+  for (int k = 0; k < n_lags; ++k) {
+    const LagSums &s = sums_[k];
+    const double n = std::fmax(s.n, DBL_EPSILON);
+    numerator[k] = s.sxy - s.sx * s.sy / n;
+    const double dx = std::fmax(s.sxx - s.sx * s.sx / n, 0.0);
+    const double dy = std::fmax(s.syy - s.sy * s.sy / n, 0.0);
+    denom[k] = std::sqrt(dx * dy);
+    max_denom = std::fmax(max_denom, denom[k]);
+  }
+  // zero-out lags with very small denominators, like the python reference
+  const double tol = 1e3 * DBL_EPSILON * max_denom;
+  for (int k = 0; k < n_lags; ++k) {
+    out[k] = denom[k] > tol ? std::clamp(numerator[k] / denom[k], -1.0, 1.0) : 0.0;
+  }
+}
+
+}  // namespace lag_corr
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace lag_corr {
+
+// Incremental masked cross-correlation engine for the lateral lag estimator
+// (lagd.py). Maintains per-lag running sums over a sliding window of
+// (expected, actual, okay) samples, so the masked normalized cross-correlation
+// over the lag range of interest costs O(lags) per new sample instead of a
+// full FFT pass over the window every estimate. The values match the masked
+// FFT NCC reference (Padfield 2010) in lagd.py: both reduce to the Pearson
+// correlation over the sample pairs where both sides of the lag are unmasked.
+class LagCorrelator {
+ public:
+  // lags run [lag_min, lag_max); lag L correlates expected[i] with actual[i + L]
+  LagCorrelator(int window_len, int lag_min, int lag_max);
+
+  void reset();
+  // appends one sample, evicting the oldest once the window is full
+  void push(double expected, double actual, bool okay);
+
+  int size() const { return size_; }
+  int num_lags() const { return lag_max_ - lag_min_; }
+  // normalized cross-correlation per lag, out[k] for lag lag_min + k
+  void ncc(double *out) const;
+
+ private:
+  struct LagSums {
+    double n = 0.0;    // overlapping unmasked pair count
+    double sx = 0.0;   // sum expected
+    double sy = 0.0;   // sum actual
+    double sxx = 0.0;  // sum expected^2
+    double syy = 0.0;  // sum actual^2
+    double sxy = 0.0;  // sum expected * actual
+  };
+
+  void add_pair(LagSums &s, double x, double y, double sign);
+
+  int window_len_;
+  int lag_min_;
+  int lag_max_;
+  int size_ = 0;
+  int64_t next_ = 0;  // absolute index of the next sample
+  std::vector<double> expected_;
+  std::vector<double> actual_;
+  std::vector<uint8_t> okay_;
+  std::vector<LagSums> sums_;
+};
+
+}  // namespace lag_corr
@@ -0,0 +1,41 @@
+# distutils: language = c++
+# cython: language_level = 3
+
+import numpy as np
+
+cdef extern from "selfdrive/locationd/lag_corr.h" namespace "lag_corr":
+  cdef cppclass LagCorrelator:
+    LagCorrelator(int window_len, int lag_min, int lag_max)
+    void reset() nogil
+    void push(double expected, double actual, bint okay) nogil
+    int size()
+    int num_lags()
+    void ncc(double *out) nogil
+
+
+cdef class LagCorrelatorNative:
+  """Incremental masked cross-correlation over a sliding sample window."""
+  cdef LagCorrelator *corr
+
+  def __cinit__(self, int window_len, int lag_min, int lag_max):
+    self.corr = new LagCorrelator(window_len, lag_min, lag_max)
+
+  def __dealloc__(self):
+    del self.corr
+
+  def reset(self):
+    self.corr.reset()
+
+  def push(self, double expected, double actual, bint okay):
+    self.corr.push(expected, actual, okay)
+
+  def ncc(self):
+    out = np.empty(self.corr.num_lags(), dtype=np.float64)
+    cdef double[::1] out_view = out
+    with nogil:
+      self.corr.ncc(&out_view[0])
+    return out
+
+  @property
+  def size(self):
+    return self.corr.size()
@@ -13,7 +13,8 @@ from openpilot.common.constants import CV
 from openpilot.common.params import Params
 from openpilot.common.realtime import config_realtime_process
 from openpilot.common.swaglog import cloudlog
-from openpilot.selfdrive.locationd.helpers import PoseCalibrator, Pose, fft_next_good_size, parabolic_peak_interp
+from openpilot.selfdrive.locationd.helpers import PoseCalibrator, Pose, parabolic_peak_interp
+from openpilot.selfdrive.locationd.lag_corr_pyx import LagCorrelatorNative
 
 BLOCK_SIZE = 100
 BLOCK_NUM = 50
@@ -54,6 +55,9 @@ def masked_symmetric_moving_average(x: np.ndarray, mask: np.ndarray, k: int, sig
 
 def masked_normalized_cross_correlation(expected_sig: np.ndarray, actual_sig: np.ndarray, mask: np.ndarray, n: int):
   """
+  Reference implementation for the native correlation engine (lag_corr.cc),
+  which computes the same values with incremental per-lag sums.
+
   References:
     D. Padfield. "Masked FFT registration". In Proc. Computer Vision and
     Pattern Recognition, pp. 2918-2925 (2010).
@@ -217,6 +221,12 @@ class LateralLagEstimator:
     window_len = int(self.window_sec / self.dt)
     self.points = Points(window_len)
     self.block_avg = BlockAverage(self.block_count, self.block_size, valid_blocks, initial_lag)
+    # the native engine keeps running correlation sums over the window; it only
+    # needs the lags the estimate and its confidence check look at
+    one_sec_samples = int(round(1.0 / self.dt))
+    self.correlator = LagCorrelatorNative(window_len, -CORR_BORDER_OFFSET, one_sec_samples + CORR_BORDER_OFFSET)
+    # raw samples awaiting enough neighbors for their smoothed value to be final
+    self.smooth_tail = deque(maxlen=SMOOTH_K)
 
   def get_msg(self, valid: bool, debug: bool = False) -> capnp._DynamicStructBuilder:
     msg = messaging.new_message('liveDelay')
@@ -308,21 +318,30 @@ class LateralLagEstimator:
 
     self.points.update(self.t, la_desired, la_actual_pose, okay)
 
+    # a sample's smoothed value is final once it has a full neighborhood, so it
+    # can be fed to the correlation engine with a SMOOTH_K // 2 sample delay
+    self.smooth_tail.append((la_desired, la_actual_pose, okay))
+    if len(self.smooth_tail) == SMOOTH_K:
+      tail_desired, tail_actual, tail_okay = (np.array(v) for v in zip(*self.smooth_tail))
+      center = SMOOTH_K // 2
+      smoothed_desired = masked_symmetric_moving_average(tail_desired, tail_okay, SMOOTH_K, SMOOTH_SIGMA)[center]
+      smoothed_actual = masked_symmetric_moving_average(tail_actual, tail_okay, SMOOTH_K, SMOOTH_SIGMA)[center]
+      center_okay = bool(tail_okay[center]) and np.isfinite(smoothed_desired) and np.isfinite(smoothed_actual)
+      self.correlator.push(np.nan_to_num(smoothed_desired), np.nan_to_num(smoothed_actual), center_okay)
+
   def update_estimate(self):
     if not self.points_enough():
       return
 
-    times, desired, actual, okay = self.points.get()
+    times, _, actual, okay = self.points.get()
     # check if there are any new valid data points since the last update
     is_valid = self.points_valid() and (actual.max() - actual.min() >= MIN_LAT_ACCEL_RANGE)
     if self.last_estimate_t != 0 and times[0] <= self.last_estimate_t:
       new_values_start_idx = next(-i for i, t in enumerate(reversed(times)) if t <= self.last_estimate_t)
       is_valid = is_valid and not (new_values_start_idx == 0 or not np.any(okay[new_values_start_idx:]))
 
-    desired = masked_symmetric_moving_average(desired, okay, SMOOTH_K, SMOOTH_SIGMA)
-    actual = masked_symmetric_moving_average(actual, okay, SMOOTH_K, SMOOTH_SIGMA)
-
-    delay, corr, confidence = self.actuator_delay(desired, actual, okay, self.dt, MIN_LAG, MAX_LAG)
+    ncc = self.correlator.ncc()
+    delay, corr, confidence = self.actuator_delay(ncc, self.dt, MIN_LAG, MAX_LAG)
     if corr < self.min_ncc or confidence < self.min_confidence or not is_valid:
       return
 
@@ -330,17 +349,13 @@ class LateralLagEstimator:
     self.last_estimate_t = self.t
 
   @staticmethod
-  def actuator_delay(expected_sig: np.ndarray, actual_sig: np.ndarray, mask: np.ndarray,
-                     dt: float, min_lag: float, max_lag: float) -> tuple[float, float, float]:
-    assert len(expected_sig) == len(actual_sig)
+  def actuator_delay(ncc: np.ndarray, dt: float, min_lag: float, max_lag: float) -> tuple[float, float, float]:
+    # ncc comes from the correlation engine, indexed by lag starting at -CORR_BORDER_OFFSET
     min_lag_samples, max_lag_samples, one_sec_samples = int(round(min_lag / dt)), int(round(max_lag / dt)), int(round(1.0 / dt))
-    padded_size = fft_next_good_size(len(expected_sig) + max(max_lag_samples, one_sec_samples))
-
-    ncc = masked_normalized_cross_correlation(expected_sig, actual_sig, mask, padded_size)
 
     # only consider lags from ranges:
-    roi = np.s_[len(expected_sig) - 1 + min_lag_samples: len(expected_sig) - 1 + max_lag_samples] # min_lag - max_lag range
-    threshold_roi = np.s_[len(expected_sig) - 1: len(expected_sig) - 1 + one_sec_samples] # 0 - 1 second range
+    roi = np.s_[CORR_BORDER_OFFSET + min_lag_samples: CORR_BORDER_OFFSET + max_lag_samples] # min_lag - max_lag range
+    threshold_roi = np.s_[CORR_BORDER_OFFSET: CORR_BORDER_OFFSET + one_sec_samples] # 0 - 1 second range
     confidence_roi = np.s_[threshold_roi.start - CORR_BORDER_OFFSET: threshold_roi.stop + CORR_BORDER_OFFSET] # threshold range +/- border
     roi_ncc, confidence_roi_ncc, threshold_roi_ncc = ncc[roi], ncc[confidence_roi], ncc[threshold_roi]
 
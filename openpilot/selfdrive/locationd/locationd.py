@@ -14,7 +14,7 @@ from openpilot.common.params import Params
 from openpilot.common.swaglog import cloudlog
 from openpilot.selfdrive.locationd.helpers import rotate_std
 from openpilot.selfdrive.locationd.models.pose_kf import PoseKalman, States
-from openpilot.selfdrive.locationd.models.constants import ObservationKind, GENERATED_DIR
+from openpilot.selfdrive.locationd.models.constants import ObservationKind
 
 ACCEL_SANITY_CHECK = 100.0  # m/s^2
 ROTATION_SANITY_CHECK = 10.0  # rad/s
@@ -53,7 +53,7 @@ class HandleLogResult(Enum):
 
 class LocationEstimator:
   def __init__(self, debug: bool):
-    self.kf = PoseKalman(GENERATED_DIR, MAX_FILTER_REWIND_TIME)
+    self.kf = PoseKalman(MAX_FILTER_REWIND_TIME)
 
     self.debug = debug
 
@@ -97,36 +97,32 @@ class LocationEstimator:
       cloudlog.error("Non-finite values detected, kalman reset")
       self.reset(t)
 
-  def handle_log(self, t: float, which: str, msg: capnp._DynamicStructReader) -> HandleLogResult:
-    new_x, new_P = None, None
+  def _prepare_sensor_obs(self, t: float, which: str, msg: capnp._DynamicStructReader):
+    # validates one IMU reading; returns the observation to apply on success
     if which == "accelerometer" and msg.which() == "acceleration":
       sensor_time = msg.timestamp * 1e-9
 
       if not self._validate_sensor_time(sensor_time, t) or not self._validate_timestamp(sensor_time):
-        return HandleLogResult.TIMING_INVALID
+        return HandleLogResult.TIMING_INVALID, None
 
       if not self._validate_sensor_source(msg.source):
-        return HandleLogResult.SENSOR_SOURCE_INVALID
+        return HandleLogResult.SENSOR_SOURCE_INVALID, None
 
       v = msg.acceleration.v
       meas = np.array([-v[2], -v[1], -v[0]])
       if np.linalg.norm(meas) >= ACCEL_SANITY_CHECK:
-        return HandleLogResult.INPUT_INVALID
+        return HandleLogResult.INPUT_INVALID, None
 
-      acc_res = self.kf.predict_and_observe(sensor_time, ObservationKind.PHONE_ACCEL, meas)
-      if acc_res is not None:
-        _, new_x, _, new_P, _, _, (acc_err,), _, _ = acc_res
-        self.observation_errors[ObservationKind.PHONE_ACCEL] = np.array(acc_err)
-        self.observations[ObservationKind.PHONE_ACCEL] = meas
+      return HandleLogResult.SUCCESS, (sensor_time, ObservationKind.PHONE_ACCEL, meas)
 
     elif which == "gyroscope" and msg.which() == "gyroUncalibrated":
       sensor_time = msg.timestamp * 1e-9
 
       if not self._validate_sensor_time(sensor_time, t) or not self._validate_timestamp(sensor_time):
-        return HandleLogResult.TIMING_INVALID
+        return HandleLogResult.TIMING_INVALID, None
 
       if not self._validate_sensor_source(msg.source):
-        return HandleLogResult.SENSOR_SOURCE_INVALID
+        return HandleLogResult.SENSOR_SOURCE_INVALID, None
 
       v = msg.gyroUncalibrated.v
       meas = np.array([-v[2], -v[1], -v[0]])
@@ -137,15 +133,49 @@ class LocationEstimator:
       gyro_valid = gyro_camodo_yawrate_err < gyro_camodo_yawrate_err_threshold
 
       if np.linalg.norm(meas) >= ROTATION_SANITY_CHECK or not gyro_valid:
-        return HandleLogResult.INPUT_INVALID
+        return HandleLogResult.INPUT_INVALID, None
+
+      return HandleLogResult.SUCCESS, (sensor_time, ObservationKind.PHONE_GYRO, meas)
+
+    return HandleLogResult.SUCCESS, None
+
+  def handle_sensor_batch(self, msgs: list[tuple[float, str, capnp._DynamicStructReader]]) -> list[tuple[str, HandleLogResult]]:
+    # validates a full sensor socket drain, then applies every accepted reading
+    # with a single crossing into the native filter core
+    results = []
+    obs_rows, ts, kinds, meas, noises = [], [], [], [], []
+    for t, which, msg in msgs:
+      res, obs = self._prepare_sensor_obs(t, which, msg)
+      results.append([which, res])
+      if obs is not None:
+        sensor_time, kind, z = obs
+        obs_rows.append((len(results) - 1, kind, z))
+        ts.append(sensor_time)
+        kinds.append(int(kind))
+        meas.append(z)
+        noises.append(PoseKalman.obs_noise[kind])
+
+    if len(ts) == 0:
+      return [(which, res) for which, res in results]
+
+    status = self.kf.predict_and_observe_batch(ts, kinds, meas, noises)
+    applied_kinds = set()
+    for applied, (row, kind, z) in zip(status, obs_rows):
+      if applied:
+        self.observations[kind] = z
+        applied_kinds.add(kind)
+      else:
+        # the native core only refuses observations outside its rewind window
+        results[row][1] = HandleLogResult.TIMING_INVALID
+    for kind in applied_kinds:
+      self.observation_errors[kind] = np.array(self.kf.last_innovation(kind))
+    if applied_kinds:
+      self._finite_check(ts[-1], self.kf.x, self.kf.P)
+    return [(which, res) for which, res in results]
 
-      gyro_res = self.kf.predict_and_observe(sensor_time, ObservationKind.PHONE_GYRO, meas)
-      if gyro_res is not None:
-        _, new_x, _, new_P, _, _, (gyro_err,), _, _ = gyro_res
-        self.observation_errors[ObservationKind.PHONE_GYRO] = np.array(gyro_err)
-        self.observations[ObservationKind.PHONE_GYRO] = meas
-
-    elif which == "carState":
+  def handle_log(self, t: float, which: str, msg: capnp._DynamicStructReader) -> HandleLogResult:
+    new_x, new_P = None, None
+    if which == "carState":
       self.car_speed = abs(msg.vEgo)
 
     elif which == "liveCalibration":
@@ -285,6 +315,18 @@ def main():
   input_invalid_threshold = {s: input_invalid_limit[s] - 0.5 for s in critcal_services}
   input_invalid_decay = {s: calculate_invalid_input_decay(input_invalid_limit[s], INPUT_INVALID_RECOVERY, SERVICE_LIST[s].frequency) for s in critcal_services}
 
+  def track_input_validity(which, res):
+    if which not in critcal_services:
+      return
+    if res == HandleLogResult.TIMING_INVALID:
+      cloudlog.warning(f"Observation {which} ignored due to failed timing check")
+      observation_input_invalid[which] += 1
+    elif res == HandleLogResult.INPUT_INVALID:
+      cloudlog.warning(f"Observation {which} ignored due to failed sanity check")
+      observation_input_invalid[which] += 1
+    elif res == HandleLogResult.SUCCESS:
+      observation_input_invalid[which] *= input_invalid_decay[which]
+
   initial_pose_data = params.get("LocationFilterInitialState")
   if initial_pose_data is not None:
     with log.Event.from_bytes(initial_pose_data) as lp_msg:
@@ -299,10 +341,15 @@ def main():
     acc_msgs, gyro_msgs = (messaging.drain_sock(sock) for sock in sensor_sockets)
 
     if filter_initialized:
+      # the full IMU drain goes through one batched filter call; the slower
+      # services follow in log order, and the filter rewind absorbs the
+      # delayed camera odometry timestamps either way
+      sensor_msgs = sorted(((msg.logMonoTime * 1e-9, msg.which(), getattr(msg, msg.which()))
+                            for msg in acc_msgs + gyro_msgs if msg.valid), key=lambda x: x[0])
+      for which, res in estimator.handle_sensor_batch(sensor_msgs):
+        track_input_validity(which, res)
+
       msgs = []
-      for msg in acc_msgs + gyro_msgs:
-        t, valid, which, data = msg.logMonoTime, msg.valid, msg.which(), getattr(msg, msg.which())
-        msgs.append((t, valid, which, data))
       for which, updated in sm.updated.items():
         if not updated:
           continue
@@ -313,17 +360,7 @@ def main():
         if valid:
           t = log_mono_time * 1e-9
           res = estimator.handle_log(t, which, msg)
-          if which not in critcal_services:
-            continue
-
-          if res == HandleLogResult.TIMING_INVALID:
-            cloudlog.warning(f"Observation {which} ignored due to failed timing check")
-            observation_input_invalid[which] += 1
-          elif res == HandleLogResult.INPUT_INVALID:
-            cloudlog.warning(f"Observation {which} ignored due to failed sanity check")
-            observation_input_invalid[which] += 1
-          elif res == HandleLogResult.SUCCESS:
-            observation_input_invalid[which] *= input_invalid_decay[which]
+          track_input_validity(which, res)
     else:
       filter_initialized = sm.all_checks() and sensor_all_checks(acc_msgs, gyro_msgs, sensor_valid, sensor_recv_time, sensor_alive, SIMULATION)
 
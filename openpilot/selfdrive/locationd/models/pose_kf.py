@@ -5,14 +5,12 @@ import numpy as np
 
 from openpilot.selfdrive.locationd.models.constants import ObservationKind
 
-from rednose.helpers.kalmanfilter import KalmanFilter
-
 if __name__=="__main__":
   import sympy as sp
   from rednose.helpers.ekf_sym import gen_code
   from rednose.helpers.sympy_helpers import euler_rotate, rot_to_euler
 else:
-  from rednose.helpers.ekf_sym_pyx import EKF_sym_pyx
+  from openpilot.selfdrive.locationd.pose_ekf_pyx import PoseEkfNative
 
 EARTH_G = 9.81
 
@@ -26,7 +24,7 @@ class States:
   ACCEL_BIAS = slice(15, 18)  # Acceletometer bias in m/s**2
 
 
-class PoseKalman(KalmanFilter):
+class PoseKalman:
   name = "pose"
 
   # state
@@ -59,6 +57,8 @@ class PoseKalman(KalmanFilter):
 
   @staticmethod
   def generate_code(generated_dir):
+    # symbolic reference model; the native core in selfdrive/locationd/pose_ekf.cc
+    # implements these exact dynamics and observation equations by hand
     name = PoseKalman.name
     dim_state = PoseKalman.initial_x.shape[0]
     dim_state_err = PoseKalman.initial_P.shape[0]
@@ -100,10 +100,50 @@ class PoseKalman(KalmanFilter):
     ]
     gen_code(generated_dir, name, f_sym, dt, state_sym, obs_eqs, dim_state, dim_state_err)
 
-  def __init__(self, generated_dir, max_rewind_age):
-    dim_state, dim_state_err = PoseKalman.initial_x.shape[0], PoseKalman.initial_P.shape[0]
-    self.filter = EKF_sym_pyx(generated_dir, self.name, PoseKalman.Q, PoseKalman.initial_x, PoseKalman.initial_P,
-                              dim_state, dim_state_err, max_rewind_age=max_rewind_age)
+  def __init__(self, max_rewind_age):
+    self.filter = PoseEkfNative(np.ascontiguousarray(np.diag(PoseKalman.Q)), max_rewind_age)
+
+  @property
+  def t(self):
+    return self.filter.t
+
+  @property
+  def x(self):
+    return self.filter.x
+
+  @property
+  def P(self):
+    return self.filter.P
+
+  def init_state(self, state, covs=None, filter_time=None):
+    if covs is None:
+      covs = self.P
+    self.filter.init_state(np.ascontiguousarray(state, dtype=np.float64),
+                           np.ascontiguousarray(covs, dtype=np.float64), filter_time)
+
+  def predict_and_observe(self, t, kind, meas, obs_noise=None):
+    # obs_noise follows the rednose convention of one covariance per measurement
+    R = obs_noise[0] if obs_noise is not None else self.obs_noise[kind]
+    applied = self.filter.predict_and_observe(t, int(kind), np.ascontiguousarray(meas, dtype=np.float64),
+                                              np.ascontiguousarray(R, dtype=np.float64))
+    if not applied:
+      return None
+    # match the rednose EKF_sym return shape locationd unpacks
+    return t, self.filter.x, None, self.filter.P, None, None, (self.filter.last_innovation(int(kind)),), None, None
+
+  def predict_and_observe_batch(self, ts, kinds, meas, obs_noises):
+    """Applies a full drain of sensor observations with one native call; returns a per-observation applied mask."""
+    n = len(ts)
+    if n == 0:
+      return np.zeros(0, dtype=np.uint8)
+    status = self.filter.predict_and_observe_batch(np.ascontiguousarray(ts, dtype=np.float64),
+                                                   np.ascontiguousarray(kinds, dtype=np.int32),
+                                                   np.ascontiguousarray(meas, dtype=np.float64).reshape(n, 3),
+                                                   np.ascontiguousarray(obs_noises, dtype=np.float64).reshape(n, 3, 3))
+    return status
+
+  def last_innovation(self, kind):
+    return self.filter.last_innovation(int(kind))
 
 
 if __name__ == "__main__":
@@ -0,0 +1,445 @@
+#include "selfdrive/locationd/pose_ekf.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace pose_ekf {
+
+namespace {
+
+constexpr double EARTH_G = 9.81;
+// central-difference step for the orientation Jacobian columns; the euler
+// kinematics are smooth, so this lands well inside the stable range
+constexpr double JACOBIAN_EPS = 1e-6;
+
+// state layout, matching States in models/pose_kf.py
+constexpr int NED_ORIENTATION = 0;
+constexpr int DEVICE_VELOCITY = 3;
+constexpr int ANGULAR_VELOCITY = 6;
+constexpr int GYRO_BIAS = 9;
+constexpr int ACCELERATION = 12;
+constexpr int ACCEL_BIAS = 15;
+
+int kind_index(int kind) {
+  switch (kind) {
+    case KIND_PHONE_GYRO: return 0;
+    case KIND_PHONE_ACCEL: return 1;
+    case KIND_CAMERA_ODO_TRANSLATION: return 2;
+    case KIND_CAMERA_ODO_ROTATION: return 3;
+    default: return -1;
+  }
+}
+
+// R = Rz(yaw) * Ry(pitch) * Rx(roll), the convention used by
+// common/transformations euler2rot
+void euler_to_rot(const double euler[3], double R[9]) {
+  const double cx = std::cos(euler[0]), sx = std::sin(euler[0]);
+  const double cy = std::cos(euler[1]), sy = std::sin(euler[1]);
+  const double cz = std::cos(euler[2]), sz = std::sin(euler[2]);
+  R[0] = cz * cy;  R[1] = cz * sy * sx - sz * cx;  R[2] = cz * sy * cx + sz * sx;
+  R[3] = sz * cy;  R[4] = sz * sy * sx + cz * cx;  R[5] = sz * sy * cx - cz * sx;
+  R[6] = -sy;      R[7] = cy * sx;                 R[8] = cy * cx;
+}
+
+void rot_to_euler(const double R[9], double euler[3]) {
+  euler[0] = std::atan2(R[7], R[8]);
+  euler[1] = -std::asin(std::clamp(R[6], -1.0, 1.0));
+  euler[2] = std::atan2(R[3], R[0]);
+}
+
+void rot_mul(const double A[9], const double B[9], double C[9]) {
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      C[i * 3 + j] = A[i * 3] * B[j] + A[i * 3 + 1] * B[3 + j] + A[i * 3 + 2] * B[6 + j];
+    }
+  }
+}
+
+// state transition over dt: velocity integrates the acceleration estimate,
+// orientation composes with the body-rate rotation
+void transition(const double *x, double dt, double *out) {
+  std::memcpy(out, x, DIM * sizeof(double));
+  for (int i = 0; i < 3; ++i) {
+    out[DEVICE_VELOCITY + i] += dt * x[ACCELERATION + i];
+  }
+  double ned_from_device[9], delta[9], composed[9];
+  const double w_dt[3] = {dt * x[ANGULAR_VELOCITY], dt * x[ANGULAR_VELOCITY + 1], dt * x[ANGULAR_VELOCITY + 2]};
+  euler_to_rot(&x[NED_ORIENTATION], ned_from_device);
+  euler_to_rot(w_dt, delta);
+  rot_mul(ned_from_device, delta, composed);
+  rot_to_euler(composed, &out[NED_ORIENTATION]);
+}
+
+// device-frame accelerometer model: gravity rotated into the device frame
+// plus the acceleration estimate, the centripetal term and the bias
+void accel_model(const double *x, double h[3]) {
+  double ned_from_device[9];
+  euler_to_rot(&x[NED_ORIENTATION], ned_from_device);
+  const double *v = &x[DEVICE_VELOCITY];
+  const double *w = &x[ANGULAR_VELOCITY];
+  // device_from_ned * (0, 0, -g) reads the third row of ned_from_device
+  h[0] = -EARTH_G * ned_from_device[6] + x[ACCELERATION] + (w[1] * v[2] - w[2] * v[1]) + x[ACCEL_BIAS];
+  h[1] = -EARTH_G * ned_from_device[7] + x[ACCELERATION + 1] + (w[2] * v[0] - w[0] * v[2]) + x[ACCEL_BIAS + 1];
+  h[2] = -EARTH_G * ned_from_device[8] + x[ACCELERATION + 2] + (w[0] * v[1] - w[1] * v[0]) + x[ACCEL_BIAS + 2];
+}
+
+bool invert3(const double S[9], double inv[9]) {
+  const double det = S[0] * (S[4] * S[8] - S[5] * S[7])
+                   - S[1] * (S[3] * S[8] - S[5] * S[6])
+                   + S[2] * (S[3] * S[7] - S[4] * S[6]);
+  if (std::fabs(det) < 1e-12) {
+    return false;
+  }
+  const double inv_det = 1.0 / det;
+  inv[0] = (S[4] * S[8] - S[5] * S[7]) * inv_det;
+  inv[1] = (S[2] * S[7] - S[1] * S[8]) * inv_det;
+  inv[2] = (S[1] * S[5] - S[2] * S[4]) * inv_det;
+  inv[3] = (S[5] * S[6] - S[3] * S[8]) * inv_det;
+  inv[4] = (S[0] * S[8] - S[2] * S[6]) * inv_det;
+  inv[5] = (S[2] * S[3] - S[0] * S[5]) * inv_det;
+  inv[6] = (S[3] * S[7] - S[4] * S[6]) * inv_det;
+  inv[7] = (S[1] * S[6] - S[0] * S[7]) * inv_det;
+  inv[8] = (S[0] * S[4] - S[1] * S[3]) * inv_det;
+  return true;
+}
+
+}  // namespace
+
+PoseEkf::PoseEkf(const double *q_diag, double max_rewind_age)
+    : max_rewind_age_(max_rewind_age), t_(NAN) {
+  std::memcpy(q_diag_, q_diag, sizeof(q_diag_));
+  std::memset(x_, 0, sizeof(x_));
+  std::memset(P_, 0, sizeof(P_));
+}
+
+void PoseEkf::init_state(const double *x, const double *P, double filter_time) {
+  std::memcpy(x_, x, sizeof(x_));
+  std::memcpy(P_, P, sizeof(P_));
+  t_ = filter_time;
+  history_.clear();
+  std::memset(has_innovation_, 0, sizeof(has_innovation_));
+}
+
+bool PoseEkf::predict_and_observe(double t, int kind, const double *z, const double *R) {
+  return apply(t, kind, z, R);
+}
+
+int PoseEkf::predict_and_observe_batch(int n, const double *ts, const int *kinds,
+                                       const double *zs, const double *Rs, unsigned char *status) {
+  int applied = 0;
+  for (int i = 0; i < n; ++i) {
+    const bool ok = apply(ts[i], kinds[i], &zs[i * OBS_DIM], &Rs[i * OBS_DIM * OBS_DIM]);
+    if (status != nullptr) {
+      status[i] = ok ? 1 : 0;
+    }
+    applied += ok ? 1 : 0;
+  }
+  return applied;
+}
+
+bool PoseEkf::last_innovation(int kind, double *y_out) const {
+  const int idx = kind_index(kind);
+  if (idx < 0 || !has_innovation_[idx]) {
+    return false;
+  }
+  std::memcpy(y_out, innovations_[idx], OBS_DIM * sizeof(double));
+  return true;
+}
+
+bool PoseEkf::apply(double t, int kind, const double *z, const double *R) {
+  if (kind_index(kind) < 0) {
+    return false;
+  }
+  if (std::isnan(t_)) {
+    t_ = t;  // first observation pins the filter time, no prediction yet
+  }
+  if (t < t_) {
+    return rewind_and_replay(t, kind, z, R);
+  }
+
+  predict(t - t_);
+  t_ = t;
+  if (!update(kind, z, R)) {
+    return false;
+  }
+
+  Checkpoint cp;
+  cp.t = t_;
+  cp.kind = kind;
+  std::memcpy(cp.z, z, sizeof(cp.z));
+  std::memcpy(cp.R, R, sizeof(cp.R));
+  std::memcpy(cp.x, x_, sizeof(cp.x));
+  std::memcpy(cp.P, P_, sizeof(cp.P));
+  history_.push_back(cp);
+  while (!history_.empty() && history_.front().t < t_ - max_rewind_age_) {
+    history_.pop_front();
+  }
+  return true;
+}
+
+bool PoseEkf::rewind_and_replay(double t, int kind, const double *z, const double *R) {
+  if (t_ - t > max_rewind_age_ || history_.empty() || t < history_.front().t) {
+    return false;
+  }
+  size_t idx = history_.size();
+  while (idx > 0 && history_[idx - 1].t > t) {
+    --idx;
+  }
+  if (idx == 0) {
+    return false;
+  }
+  const Checkpoint &anchor = history_[idx - 1];
+  std::memcpy(x_, anchor.x, sizeof(x_));
+  std::memcpy(P_, anchor.P, sizeof(P_));
+  t_ = anchor.t;
+
+  // replay the late observation in its time slot followed by everything
+  // that had already been applied after it
+  struct PendingObs {
+    double t;
+    int kind;
+    double z[OBS_DIM];
+    double R[OBS_DIM * OBS_DIM];
+  };
+  std::vector<PendingObs> pending;
+  pending.reserve(history_.size() - idx + 1);
+  PendingObs late{t, kind, {}, {}};
+  std::memcpy(late.z, z, sizeof(late.z));
+  std::memcpy(late.R, R, sizeof(late.R));
+  pending.push_back(late);
+  for (size_t i = idx; i < history_.size(); ++i) {
+    PendingObs obs{history_[i].t, history_[i].kind, {}, {}};
+    std::memcpy(obs.z, history_[i].z, sizeof(obs.z));
+    std::memcpy(obs.R, history_[i].R, sizeof(obs.R));
+    pending.push_back(obs);
+  }
+  std::stable_sort(pending.begin(), pending.end(),
+                   [](const PendingObs &a, const PendingObs &b) { return a.t < b.t; });
+  history_.resize(idx);
+
+  bool late_ok = false;
+  for (const PendingObs &obs : pending) {
+    const bool ok = apply(obs.t, obs.kind, obs.z, obs.R);
+    if (obs.t == t && obs.kind == kind) {
+      late_ok = ok;
+    }
+  }
+  return late_ok;
+}
+
+void PoseEkf::predict(double dt) {
+  if (dt <= 0.0) {
+    return;
+  }
+  double x_new[DIM];
+  transition(x_, dt, x_new);
+
+  // the transition is identity except velocity += dt * acceleration and the
+  // orientation composition, so the Jacobian is I with a dt block plus six
+  // orientation columns differenced numerically
+  double F[DIM * DIM] = {};
+  for (int i = 0; i < DIM; ++i) {
+    F[i * DIM + i] = 1.0;
+  }
+  for (int i = 0; i < 3; ++i) {
+    F[(DEVICE_VELOCITY + i) * DIM + ACCELERATION + i] = dt;
+  }
+  const int orientation_cols[6] = {NED_ORIENTATION, NED_ORIENTATION + 1, NED_ORIENTATION + 2,
+                                   ANGULAR_VELOCITY, ANGULAR_VELOCITY + 1, ANGULAR_VELOCITY + 2};
+  double xp[DIM], xm[DIM], fp[DIM], fm[DIM];
+  for (const int col : orientation_cols) {
+    std::memcpy(xp, x_, sizeof(xp));
+    std::memcpy(xm, x_, sizeof(xm));
+    xp[col] += JACOBIAN_EPS;
+    xm[col] -= JACOBIAN_EPS;
+    transition(xp, dt, fp);
+    transition(xm, dt, fm);
+    for (int row = NED_ORIENTATION; row < NED_ORIENTATION + 3; ++row) {
+      F[row * DIM + col] = (fp[row] - fm[row]) / (2.0 * JACOBIAN_EPS);
+    }
+  }
+
+  // P = F P F^T + Q dt
+  double FP[DIM * DIM];
+  for (int i = 0; i < DIM; ++i) {
+    for (int j = 0; j < DIM; ++j) {
+      double sum = 0.0;
+      for (int k = 0; k < DIM; ++k) {
+        sum += F[i * DIM + k] * P_[k * DIM + j];
+      }
+      FP[i * DIM + j] = sum;
+    }
+  }
+  for (int i = 0; i < DIM; ++i) {
+    for (int j = 0; j <= i; ++j) {
+      double sum = 0.0;
+      for (int k = 0; k < DIM; ++k) {
+        sum += FP[i * DIM + k] * F[j * DIM + k];
+      }
+      if (i == j) {
+        sum += q_diag_[i] * dt;
+      }
+      P_[i * DIM + j] = sum;
+      P_[j * DIM + i] = sum;
+    }
+  }
+  std::memcpy(x_, x_new, sizeof(x_));
+}
+
+bool PoseEkf::update(int kind, const double *z, const double *R) {
+  double h[OBS_DIM] = {};
+  double H[OBS_DIM * DIM] = {};
+  switch (kind) {
+    case KIND_PHONE_GYRO:
+      for (int i = 0; i < 3; ++i) {
+        h[i] = x_[ANGULAR_VELOCITY + i] + x_[GYRO_BIAS + i];
+        H[i * DIM + ANGULAR_VELOCITY + i] = 1.0;
+        H[i * DIM + GYRO_BIAS + i] = 1.0;
+      }
+      break;
+    case KIND_PHONE_ACCEL: {
+      accel_model(x_, h);
+      const double *v = &x_[DEVICE_VELOCITY];
+      const double *w = &x_[ANGULAR_VELOCITY];
+      for (int i = 0; i < 3; ++i) {
+        H[i * DIM + ACCELERATION + i] = 1.0;
+        H[i * DIM + ACCEL_BIAS + i] = 1.0;
+      }
+      // centripetal term: d(w x v)/dv = [w]x, d(w x v)/dw = -[v]x
+      H[0 * DIM + DEVICE_VELOCITY + 1] = -w[2];
+      H[0 * DIM + DEVICE_VELOCITY + 2] = w[1];
+      H[1 * DIM + DEVICE_VELOCITY] = w[2];
+      H[1 * DIM + DEVICE_VELOCITY + 2] = -w[0];
+      H[2 * DIM + DEVICE_VELOCITY] = -w[1];
+      H[2 * DIM + DEVICE_VELOCITY + 1] = w[0];
+      H[0 * DIM + ANGULAR_VELOCITY + 1] = v[2];
+      H[0 * DIM + ANGULAR_VELOCITY + 2] = -v[1];
+      H[1 * DIM + ANGULAR_VELOCITY] = -v[2];
+      H[1 * DIM + ANGULAR_VELOCITY + 2] = v[0];
+      H[2 * DIM + ANGULAR_VELOCITY] = v[1];
+      H[2 * DIM + ANGULAR_VELOCITY + 1] = -v[0];
+      // gravity columns by central differences over the orientation
+      double xp[DIM], xm[DIM], hp[3], hm[3];
+      for (int col = NED_ORIENTATION; col < NED_ORIENTATION + 3; ++col) {
+        std::memcpy(xp, x_, sizeof(xp));
+        std::memcpy(xm, x_, sizeof(xm));
+        xp[col] += JACOBIAN_EPS;
+        xm[col] -= JACOBIAN_EPS;
+        accel_model(xp, hp);
+        accel_model(xm, hm);
+        for (int row = 0; row < 3; ++row) {
+          H[row * DIM + col] = (hp[row] - hm[row]) / (2.0 * JACOBIAN_EPS);
+        }
+      }
+      break;
+    }
+    case KIND_CAMERA_ODO_TRANSLATION:
+      for (int i = 0; i < 3; ++i) {
+        h[i] = x_[DEVICE_VELOCITY + i];
+        H[i * DIM + DEVICE_VELOCITY + i] = 1.0;
+      }
+      break;
+    case KIND_CAMERA_ODO_ROTATION:
+      for (int i = 0; i < 3; ++i) {
+        h[i] = x_[ANGULAR_VELOCITY + i];
+        H[i * DIM + ANGULAR_VELOCITY + i] = 1.0;
+      }
+      break;
+    default:
+      return false;
+  }
+
+  double y[OBS_DIM];
+  for (int i = 0; i < OBS_DIM; ++i) {
+    y[i] = z[i] - h[i];
+  }
+
+  // PHt (DIM x 3), S = H PHt + R
+  double PHt[DIM * OBS_DIM];
+  for (int i = 0; i < DIM; ++i) {
+    for (int j = 0; j < OBS_DIM; ++j) {
+      double sum = 0.0;
+      for (int k = 0; k < DIM; ++k) {
+        sum += P_[i * DIM + k] * H[j * DIM + k];
+      }
+      PHt[i * OBS_DIM + j] = sum;
+    }
+  }
+  double S[OBS_DIM * OBS_DIM];
+  for (int i = 0; i < OBS_DIM; ++i) {
+    for (int j = 0; j < OBS_DIM; ++j) {
+      double sum = R[i * OBS_DIM + j];
+      for (int k = 0; k < DIM; ++k) {
+        sum += H[i * DIM + k] * PHt[k * OBS_DIM + j];
+      }
+      S[i * OBS_DIM + j] = sum;
+    }
+  }
+  double S_inv[OBS_DIM * OBS_DIM];
+  if (!invert3(S, S_inv)) {
+    return false;
+  }
+
+  double K[DIM * OBS_DIM];
+  for (int i = 0; i < DIM; ++i) {
+    for (int j = 0; j < OBS_DIM; ++j) {
+      K[i * OBS_DIM + j] = PHt[i * OBS_DIM] * S_inv[j]
+                         + PHt[i * OBS_DIM + 1] * S_inv[OBS_DIM + j]
+                         + PHt[i * OBS_DIM + 2] * S_inv[2 * OBS_DIM + j];
+    }
+  }
+  for (int i = 0; i < DIM; ++i) {
+    x_[i] += K[i * OBS_DIM] * y[0] + K[i * OBS_DIM + 1] * y[1] + K[i * OBS_DIM + 2] * y[2];
+  }
+
+  // Joseph form keeps P symmetric positive semi-definite:
+  // P = (I - K H) P (I - K H)^T + K R K^T
+  double A[DIM * DIM];
+  for (int i = 0; i < DIM; ++i) {
+    for (int j = 0; j < DIM; ++j) {
+      double sum = (i == j) ? 1.0 : 0.0;
+      sum -= K[i * OBS_DIM] * H[j] + K[i * OBS_DIM + 1] * H[DIM + j] + K[i * OBS_DIM + 2] * H[2 * DIM + j];
+      A[i * DIM + j] = sum;
+    }
+  }
+  double AP[DIM * DIM];
+  for (int i = 0; i < DIM; ++i) {
+    for (int j = 0; j < DIM; ++j) {
+      double sum = 0.0;
+      for (int k = 0; k < DIM; ++k) {
+        sum += A[i * DIM + k] * P_[k * DIM + j];
+      }
+      AP[i * DIM + j] = sum;
+    }
+  }
+  double KR[DIM * OBS_DIM];
+  for (int i = 0; i < DIM; ++i) {
+    for (int j = 0; j < OBS_DIM; ++j) {
+      KR[i * OBS_DIM + j] = K[i * OBS_DIM] * R[j]
+                          + K[i * OBS_DIM + 1] * R[OBS_DIM + j]
+                          + K[i * OBS_DIM + 2] * R[2 * OBS_DIM + j];
+    }
+  }
+  for (int i = 0; i < DIM; ++i) {
+    for (int j = 0; j <= i; ++j) {
+      double sum = 0.0;
+      for (int k = 0; k < DIM; ++k) {
+        sum += AP[i * DIM + k] * A[j * DIM + k];
+      }
+      sum += KR[i * OBS_DIM] * K[j * OBS_DIM]
+           + KR[i * OBS_DIM + 1] * K[j * OBS_DIM + 1]
+           + KR[i * OBS_DIM + 2] * K[j * OBS_DIM + 2];
+      P_[i * DIM + j] = sum;
+      P_[j * DIM + i] = sum;
+    }
+  }
+
+  const int idx = kind_index(kind);
+  std::memcpy(innovations_[idx], y, sizeof(innovations_[idx]));
+  has_innovation_[idx] = true;
+  return true;
+}
+
+}  // namespace pose_ekf
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <deque>
+
+namespace pose_ekf {
+
+constexpr int DIM = 18;
+constexpr int OBS_DIM = 3;
+
+// observation kinds, matching ObservationKind in models/constants.py
+constexpr int KIND_PHONE_GYRO = 4;
+constexpr int KIND_PHONE_ACCEL = 10;
+constexpr int KIND_CAMERA_ODO_TRANSLATION = 13;
+constexpr int KIND_CAMERA_ODO_ROTATION = 14;
+
+// Extended Kalman filter core for the pose model in models/pose_kf.py:
+// euler NED orientation, device velocity, angular velocity, gyro bias,
+// device acceleration and accel bias. Predict and update run in fixed-size
+// double kernels the compiler vectorizes; out-of-order observations (the
+// delayed camera odometry) rewind to a stored checkpoint and replay, like
+// rednose's EKF_sym, bounded by max_rewind_age.
+class PoseEkf {
+ public:
+  PoseEkf(const double *q_diag, double max_rewind_age);
+
+  // P is a row-major DIM x DIM covariance; a NaN filter_time leaves the
+  // filter uninitialized until the first observation
+  void init_state(const double *x, const double *P, double filter_time);
+
+  // applies one predict+update; z is a 3-vector, R a row-major 3x3
+  // measurement covariance. returns false when the observation is outside
+  // the rewind window or the innovation covariance is singular.
+  bool predict_and_observe(double t, int kind, const double *z, const double *R);
+
+  // applies n observations in order with a single crossing; zs is n x 3,
+  // Rs is n x 9, status (optional) receives 1/0 per observation. returns
+  // the number applied.
+  int predict_and_observe_batch(int n, const double *ts, const int *kinds,
+                                const double *zs, const double *Rs, unsigned char *status);
+
+  double filter_time() const { return t_; }
+  const double *state() const { return x_; }
+  const double *covariance() const { return P_; }
+  // innovation of the most recent successful observation of this kind
+  bool last_innovation(int kind, double *y_out) const;
+
+ private:
+  // filter state recorded after each applied observation, so a late
+  // observation can restore the newest checkpoint at or before its time
+  // and replay everything that came after
+  struct Checkpoint {
+    double t;
+    int kind;
+    double z[OBS_DIM];
+    double R[OBS_DIM * OBS_DIM];
+    double x[DIM];
+    double P[DIM * DIM];
+  };
+
+  bool apply(double t, int kind, const double *z, const double *R);
+  bool rewind_and_replay(double t, int kind, const double *z, const double *R);
+  void predict(double dt);
+  bool update(int kind, const double *z, const double *R);
+
+  double q_diag_[DIM];
+  double max_rewind_age_;
+  double t_;
+  double x_[DIM];
+  double P_[DIM * DIM];
+  double innovations_[4][OBS_DIM] = {};
+  bool has_innovation_[4] = {};
+  std::deque<Checkpoint> history_;
+};
+
+}  // namespace pose_ekf
@@ -0,0 +1,71 @@
+# distutils: language = c++
+# cython: language_level = 3
+
+import numpy as np
+
+cdef extern from "selfdrive/locationd/pose_ekf.h" namespace "pose_ekf":
+  cdef cppclass PoseEkf:
+    PoseEkf(const double *q_diag, double max_rewind_age)
+    void init_state(const double *x, const double *P, double filter_time) nogil
+    bint predict_and_observe(double t, int kind, const double *z, const double *R) nogil
+    int predict_and_observe_batch(int n, const double *ts, const int *kinds,
+                                  const double *zs, const double *Rs, unsigned char *status) nogil
+    double filter_time()
+    const double *state()
+    const double *covariance()
+    bint last_innovation(int kind, double *y_out)
+
+DIM = 18
+
+
+cdef class PoseEkfNative:
+  """Native predict/update core for the pose kalman filter."""
+  cdef PoseEkf *ekf
+
+  def __cinit__(self, const double[::1] q_diag, double max_rewind_age):
+    assert q_diag.shape[0] == DIM
+    self.ekf = new PoseEkf(&q_diag[0], max_rewind_age)
+
+  def __dealloc__(self):
+    del self.ekf
+
+  def init_state(self, const double[::1] x, const double[:, ::1] P, filter_time):
+    assert x.shape[0] == DIM and P.shape[0] == DIM and P.shape[1] == DIM
+    cdef double t = float('nan') if filter_time is None else filter_time
+    self.ekf.init_state(&x[0], &P[0, 0], t)
+
+  def predict_and_observe(self, double t, int kind, const double[::1] z, const double[:, ::1] R):
+    assert z.shape[0] == 3 and R.shape[0] == 3 and R.shape[1] == 3
+    return bool(self.ekf.predict_and_observe(t, kind, &z[0], &R[0, 0]))
+
+  def predict_and_observe_batch(self, const double[::1] ts, const int[::1] kinds,
+                                const double[:, ::1] zs, const double[:, :, ::1] Rs):
+    """Applies all observations with a single crossing; returns a per-observation applied mask."""
+    cdef int n = ts.shape[0]
+    assert kinds.shape[0] == n and zs.shape[0] == n and Rs.shape[0] == n
+    assert zs.shape[1] == 3 and Rs.shape[1] == 3 and Rs.shape[2] == 3
+    status = np.zeros(n, dtype=np.uint8)
+    if n == 0:
+      return status
+    cdef unsigned char[::1] status_view = status
+    with nogil:
+      self.ekf.predict_and_observe_batch(n, &ts[0], &kinds[0], &zs[0, 0], &Rs[0, 0, 0], &status_view[0])
+    return status
+
+  def last_innovation(self, int kind):
+    cdef double y[3]
+    if not self.ekf.last_innovation(kind, y):
+      return None
+    return np.array([y[0], y[1], y[2]])
+
+  @property
+  def t(self):
+    return self.ekf.filter_time()
+
+  @property
+  def x(self):
+    return np.asarray(<const double[:DIM]>self.ekf.state()).copy()
+
+  @property
+  def P(self):
+    return np.asarray(<const double[:DIM * DIM]>self.ekf.covariance()).reshape(DIM, DIM).copy()
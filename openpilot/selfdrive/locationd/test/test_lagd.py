@@ -6,7 +6,8 @@ import pytest
 from openpilot.cereal import messaging, log
 from opendbc.car.structs import car
 from openpilot.selfdrive.locationd.lagd import LateralLagEstimator, retrieve_initial_lag, masked_normalized_cross_correlation, \
-                                               BLOCK_NUM_NEEDED, BLOCK_SIZE, MIN_OKAY_WINDOW_SEC, VERSION, MIN_LAG, MAX_LAG
+                                               BLOCK_NUM_NEEDED, BLOCK_SIZE, MIN_OKAY_WINDOW_SEC, VERSION, MIN_LAG, MAX_LAG, CORR_BORDER_OFFSET
+from openpilot.selfdrive.locationd.lag_corr_pyx import LagCorrelatorNative
 from openpilot.selfdrive.test.process_replay.migration import migrate, migrate_carParams
 from openpilot.selfdrive.locationd.test.test_locationd_scenarios import TEST_ROUTE
 from openpilot.common.params import Params
@@ -103,6 +104,28 @@ class TestLagd:
     corr = masked_normalized_cross_correlation(desired_sig, actual_sig, mask, 200)[len(desired_sig) - 1:len(desired_sig) + 20]
     assert np.argmax(corr) in range(lag_frames - MAX_ERR_FRAMES, lag_frames + MAX_ERR_FRAMES + 1)
 
+  def test_native_correlator(self):
+    lag_frames = random.randint(1, 19)
+    window, total = 200, 300
+    one_sec_samples = int(round(1.0 / DT))
+
+    sig = np.sin(np.arange(total) * 0.1)
+    desired_sig = sig + np.random.normal(0, 0.05, total)
+    actual_sig = np.roll(sig, lag_frames) + np.random.normal(0, 0.05, total)
+    mask = np.random.choice([True, False], size=total, p=[0.7, 0.3])
+
+    correlator = LagCorrelatorNative(window, -CORR_BORDER_OFFSET, one_sec_samples + CORR_BORDER_OFFSET)
+    for d, a, m in zip(desired_sig, actual_sig, mask, strict=True):
+      correlator.push(d, a, m)
+    ncc = correlator.ncc()
+
+    # the engine must match the FFT reference over the final window
+    ref = masked_normalized_cross_correlation(desired_sig[-window:].copy(), actual_sig[-window:].copy(), mask[-window:], 512)
+    for lag in range(-CORR_BORDER_OFFSET, one_sec_samples + CORR_BORDER_OFFSET):
+      assert np.allclose(ncc[lag + CORR_BORDER_OFFSET], ref[window - 1 + lag], atol=1e-9)
+
+    assert np.argmax(ncc[CORR_BORDER_OFFSET:CORR_BORDER_OFFSET + one_sec_samples]) == lag_frames
+
   def test_empty_estimator(self):
     mocked_CP = car.CarParams(steerActuatorDelay=0.5)
     estimator = LateralLagEstimator(mocked_CP, DT)
@@ -15,10 +15,14 @@ def make_warp_dm(nv12: NV12Frame, dm_w, dm_h):
   cam_w, cam_h, stride, _, _, _ = nv12
   stride_pad = stride - cam_w
 
-  def warp_dm(input_frame, M_inv):
+  def warp_dm(input_frame, M_inv, out_img):
     M_inv = M_inv.to(Device.DEFAULT).realize()
-    return warp_perspective_tinygrad(input_frame[:cam_h*stride], M_inv,
-                                     (dm_w, dm_h), (cam_h, cam_w), stride_pad, border_fill_val=16).reshape(-1, dm_h * dm_w) # Y
+    warped = warp_perspective_tinygrad(input_frame[:cam_h*stride], M_inv,
+                                       (dm_w, dm_h), (cam_h, cam_w), stride_pad, border_fill_val=16).reshape(-1, dm_h * dm_w) # Y
+    # write straight into the model's input tensor (like the input queues in
+    # compile_modeld) so the model jit keeps a stable input binding
+    out_img.assign(warped.contiguous())
+    return out_img
   return warp_dm
 
 
@@ -27,12 +31,13 @@ def compile_dm_warp(nv12: NV12Frame, dm_w, dm_h, pkl_path):
 
   warp_dm_jit = TinyJit(make_warp_dm(nv12, dm_w, dm_h), prune=True)
 
+  out_img = Tensor.zeros(1, dm_h * dm_w, dtype='uint8').contiguous().realize()
   for i in range(10):
     frame = Tensor.randint(nv12.size, low=0, high=256, dtype='uint8').realize()
     M_inv = Tensor(Tensor.randn(3, 3).mul(8).realize().numpy(), device='NPY')
     Device.default.synchronize()
     st = time.perf_counter()
-    warp_dm_jit(frame, M_inv).realize()
+    warp_dm_jit(frame, M_inv, out_img).realize()
     mt = time.perf_counter()
     Device.default.synchronize()
     et = time.perf_counter()
@@ -42,6 +42,9 @@ class ModelState:
     self.warp_inputs = {k: Tensor(v, device='NPY') for k,v in self.warp_inputs_np.items()}
     self.frame_buf_params = get_nv12_info(cam_w, cam_h)
     self.tensor_inputs = {k: Tensor(v, device='NPY').realize() for k,v in self.numpy_inputs.items()}
+    # persistent model input the warp jit writes into on-device, so the model
+    # jit sees the same buffer every frame
+    self.tensor_inputs['input_img'] = Tensor(np.zeros(self.input_shapes['input_img'], dtype=np.uint8), device=self.DEV).contiguous().realize()
     self._blob_cache : dict[int, Tensor] = {}
     self.model_run = pickle.load(open_file_chunked(str(MODEL_PKL_PATH)))
     with open(MODELS_DIR / f'dm_warp_{cam_w}x{cam_h}_tinygrad.pkl', "rb") as f:
@@ -58,7 +61,8 @@ class ModelState:
       self._blob_cache[ptr] = Tensor.from_blob(ptr, (self.frame_buf_params[3],), dtype='uint8', device=self.DEV)
 
     self.warp_inputs_np['transform'][:] = transform[:]
-    self.tensor_inputs['input_img'] = self.image_warp(self._blob_cache[ptr], self.warp_inputs['transform'])
+    # warp runs on-device from the VisionIpc buffer straight into the model input
+    self.image_warp(self._blob_cache[ptr], self.warp_inputs['transform'], self.tensor_inputs['input_img'])
 
     output = self.model_run(**self.tensor_inputs).numpy().flatten()
 
@@ -0,0 +1,140 @@
+#include "selfdrive/modeld/frame_prep.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace frame_prep {
+
+namespace {
+
+// Nearest-neighbor projective warp of one plane. pixel_pitch lets the same
+// kernel sample a deinterleaved view of the NV12 UV plane (pitch 2, offset
+// baked into src). Coordinates clamp to the source like
+// warp_perspective_tinygrad; border_fill >= 0 additionally replaces samples
+// whose rounded coordinate fell outside the source.
+void warp_plane(const uint8_t *src, int src_w, int src_h, int src_stride, int pixel_pitch,
+                const float m[9], int dst_w, int dst_h, uint8_t *dst, int border_fill) {
+  for (int y = 0; y < dst_h; ++y) {
+    // the y-dependent terms are constant along a row
+    const float nx = m[1] * y + m[2];
+    const float ny = m[4] * y + m[5];
+    const float nw = m[7] * y + m[8];
+    uint8_t *dst_row = dst + (size_t)y * dst_w;
+    int x = 0;
+
+#if defined(__ARM_NEON)
+    // coordinate math 4 pixels at a time; the gather itself stays scalar.
+    // two Newton steps bring the reciprocal estimate to full float
+    // precision, so only exact-halfway samples can round differently from
+    // a true divide.
+    const float32x4_t lane_idx = {0.0f, 1.0f, 2.0f, 3.0f};
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t max_x = vdupq_n_f32((float)(src_w - 1));
+    const float32x4_t max_y = vdupq_n_f32((float)(src_h - 1));
+    for (; x + 4 <= dst_w; x += 4) {
+      float32x4_t xf = vaddq_f32(vdupq_n_f32((float)x), lane_idx);
+      float32x4_t num_x = vmlaq_n_f32(vdupq_n_f32(nx), xf, m[0]);
+      float32x4_t num_y = vmlaq_n_f32(vdupq_n_f32(ny), xf, m[3]);
+      float32x4_t den = vmlaq_n_f32(vdupq_n_f32(nw), xf, m[6]);
+
+      float32x4_t inv = vrecpeq_f32(den);
+      inv = vmulq_f32(inv, vrecpsq_f32(den, inv));
+      inv = vmulq_f32(inv, vrecpsq_f32(den, inv));
+      float32x4_t sx = vrndnq_f32(vmulq_f32(num_x, inv));
+      float32x4_t sy = vrndnq_f32(vmulq_f32(num_y, inv));
+
+      int32x4_t ix = vcvtq_s32_f32(vminq_f32(vmaxq_f32(sx, zero), max_x));
+      int32x4_t iy = vcvtq_s32_f32(vminq_f32(vmaxq_f32(sy, zero), max_y));
+      uint32x4_t in_bounds = vandq_u32(vandq_u32(vcgeq_f32(sx, zero), vcleq_f32(sx, max_x)),
+                                       vandq_u32(vcgeq_f32(sy, zero), vcleq_f32(sy, max_y)));
+
+      int32_t ixs[4], iys[4];
+      uint32_t in_b[4];
+      vst1q_s32(ixs, ix);
+      vst1q_s32(iys, iy);
+      vst1q_u32(in_b, in_bounds);
+      for (int k = 0; k < 4; ++k) {
+        uint8_t v = src[(size_t)iys[k] * src_stride + (size_t)ixs[k] * pixel_pitch];
+        dst_row[x + k] = (border_fill >= 0 && !in_b[k]) ? (uint8_t)border_fill : v;
+      }
+    }
+#endif
+
+    for (; x < dst_w; ++x) {
+      const float w = m[6] * x + nw;
+      const float sx = nearbyintf((m[0] * x + nx) / w);
+      const float sy = nearbyintf((m[3] * x + ny) / w);
+      const int ix = std::clamp((int)sx, 0, src_w - 1);
+      const int iy = std::clamp((int)sy, 0, src_h - 1);
+      uint8_t v = src[(size_t)iy * src_stride + (size_t)ix * pixel_pitch];
+      if (border_fill >= 0 && (sx < 0.0f || sx > src_w - 1 || sy < 0.0f || sy > src_h - 1)) {
+        v = (uint8_t)border_fill;
+      }
+      dst_row[x] = v;
+    }
+  }
+}
+
+// Split a warped full-resolution Y plane into the four phase channels
+// (even/odd row x even/odd column), each (h/2, w/2).
+void extract_y_phases(const uint8_t *y_plane, int w, int h, uint8_t *dst) {
+  const int half_w = w / 2;
+  const int half_h = h / 2;
+  const size_t ch_size = (size_t)half_w * half_h;
+  for (int r = 0; r < half_h; ++r) {
+    for (int phase = 0; phase < 2; ++phase) {  // 0: even source row, 1: odd
+      const uint8_t *src_row = y_plane + (size_t)(2 * r + phase) * w;
+      uint8_t *even_col = dst + phase * ch_size + (size_t)r * half_w;
+      uint8_t *odd_col = even_col + 2 * ch_size;
+      int c = 0;
+#if defined(__ARM_NEON)
+      for (; c + 16 <= half_w; c += 16) {
+        uint8x16x2_t d = vld2q_u8(src_row + 2 * c);
+        vst1q_u8(even_col + c, d.val[0]);
+        vst1q_u8(odd_col + c, d.val[1]);
+      }
+#endif
+      for (; c < half_w; ++c) {
+        even_col[c] = src_row[2 * c];
+        odd_col[c] = src_row[2 * c + 1];
+      }
+    }
+  }
+}
+
+}  // namespace
+
+void nv12_to_model_input(const uint8_t *nv12, int cam_w, int cam_h, int stride, int uv_offset,
+                         const float *m_inv, int model_w, int model_h, uint8_t *dst) {
+  // scratch for the full-resolution warped Y; one ring slot per thread,
+  // reused across frames
+  static thread_local std::vector<uint8_t> y_warp;
+  y_warp.resize((size_t)model_w * model_h);
+
+  warp_plane(nv12, cam_w, cam_h, stride, 1, m_inv, model_w, model_h, y_warp.data(), -1);
+  extract_y_phases(y_warp.data(), model_w, model_h, dst);
+
+  // same simplification as make_frame_prepare(): UV_SCALE @ M_inv @
+  // UV_SCALE_INV reduces to elementwise scaling of the Y transform
+  const float m_uv[9] = {
+    m_inv[0], m_inv[1], m_inv[2] * 0.5f,
+    m_inv[3], m_inv[4], m_inv[5] * 0.5f,
+    m_inv[6] * 2.0f, m_inv[7] * 2.0f, m_inv[8],
+  };
+  const size_t ch_size = (size_t)(model_w / 2) * (model_h / 2);
+  const uint8_t *uv = nv12 + uv_offset;
+  warp_plane(uv, cam_w / 2, cam_h / 2, stride, 2, m_uv, model_w / 2, model_h / 2, dst + 4 * ch_size, -1);
+  warp_plane(uv + 1, cam_w / 2, cam_h / 2, stride, 2, m_uv, model_w / 2, model_h / 2, dst + 5 * ch_size, -1);
+}
+
+void nv12_y_warp(const uint8_t *nv12, int cam_w, int cam_h, int stride,
+                 const float *m_inv, int dst_w, int dst_h, uint8_t border_fill, uint8_t *dst) {
+  warp_plane(nv12, cam_w, cam_h, stride, 1, m_inv, dst_w, dst_h, dst, border_fill);
+}
+
+}  // namespace frame_prep
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+// Native model input preparation from NV12 VisionIpc buffers: projective
+// warp (nearest neighbor, matching warp_perspective_tinygrad) plus the
+// stacked-YUV channel extraction the driving model consumes. The model
+// inputs stay uint8 end to end, so there is no separate normalization
+// stage. Exposed to Python through frame_prep_pyx.
+
+namespace frame_prep {
+
+// Warp one NV12 frame into the (6, model_h/2, model_w/2) uint8 tensor from
+// make_frame_prepare() in compile_modeld.py: channels 0-3 are the four Y
+// phases (even/odd row x even/odd column), channels 4 and 5 are warped U
+// and V. m_inv is the row-major 3x3 dst->src transform for the Y plane;
+// the UV scaling is derived internally. dst must hold
+// 6 * (model_h/2) * (model_w/2) bytes, model_w and model_h must be even.
+void nv12_to_model_input(const uint8_t *nv12, int cam_w, int cam_h, int stride, int uv_offset,
+                         const float *m_inv, int model_w, int model_h, uint8_t *dst);
+
+// Y-only warp used for the driver monitoring input; samples that fall
+// outside the source take border_fill (16 = video black), matching
+// compile_dm_warp.py. dst must hold dst_w * dst_h bytes.
+void nv12_y_warp(const uint8_t *nv12, int cam_w, int cam_h, int stride,
+                 const float *m_inv, int dst_w, int dst_h, uint8_t border_fill, uint8_t *dst);
+
+}  // namespace frame_prep
@@ -0,0 +1,30 @@
+# distutils: language = c++
+# cython: language_level = 3
+
+cdef extern from "selfdrive/modeld/frame_prep.h" namespace "frame_prep":
+  void nv12_to_model_input(const unsigned char *nv12, int cam_w, int cam_h, int stride, int uv_offset,
+                           const float *m_inv, int model_w, int model_h, unsigned char *dst) nogil
+  void nv12_y_warp(const unsigned char *nv12, int cam_w, int cam_h, int stride,
+                   const float *m_inv, int dst_w, int dst_h, unsigned char border_fill, unsigned char *dst) nogil
+
+
+def prepare_model_input(const unsigned char[::1] nv12, int cam_w, int cam_h, int stride, int uv_offset,
+                        const float[:, ::1] m_inv, unsigned char[:, :, ::1] out):
+  """Warp one NV12 frame into the (6, model_h/2, model_w/2) uint8 model input tensor."""
+  cdef int model_h = out.shape[1] * 2
+  cdef int model_w = out.shape[2] * 2
+  assert out.shape[0] == 6 and m_inv.shape[0] == 3 and m_inv.shape[1] == 3
+  assert nv12.shape[0] >= uv_offset + (cam_h // 2) * stride
+  with nogil:
+    nv12_to_model_input(&nv12[0], cam_w, cam_h, stride, uv_offset, &m_inv[0, 0], model_w, model_h, &out[0, 0, 0])
+
+
+def warp_y(const unsigned char[::1] nv12, int cam_w, int cam_h, int stride,
+           const float[:, ::1] m_inv, unsigned char[:, ::1] out, unsigned char border_fill=16):
+  """Y-only warp for the driver monitoring input; out-of-bounds samples take border_fill."""
+  cdef int dst_h = out.shape[0]
+  cdef int dst_w = out.shape[1]
+  assert m_inv.shape[0] == 3 and m_inv.shape[1] == 3
+  assert nv12.shape[0] >= cam_h * stride
+  with nogil:
+    nv12_y_warp(&nv12[0], cam_w, cam_h, stride, &m_inv[0, 0], dst_w, dst_h, border_fill, &out[0, 0])
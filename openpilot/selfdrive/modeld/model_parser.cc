@@ -0,0 +1,54 @@
+#include "selfdrive/modeld/model_parser.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace model_parser {
+
+namespace {
+
+// matches safe_exp(): clip at 11 so a float16-trained output can't overflow
+inline float safe_exp(float x) {
+  return expf(std::min(x, 11.0f));
+}
+
+}  // namespace
+
+void sigmoid(float *x, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    x[i] = 1.0f / (1.0f + safe_exp(-x[i]));
+  }
+}
+
+void softmax(float *x, size_t rows, size_t width) {
+  for (size_t r = 0; r < rows; ++r) {
+    float *row = x + r * width;
+    float max_val = row[0];
+    for (size_t i = 1; i < width; ++i) {
+      max_val = std::max(max_val, row[i]);
+    }
+    float sum = 0.0f;
+    for (size_t i = 0; i < width; ++i) {
+      row[i] = safe_exp(row[i] - max_val);
+      sum += row[i];
+    }
+    const float inv_sum = 1.0f / sum;
+    for (size_t i = 0; i < width; ++i) {
+      row[i] *= inv_sum;
+    }
+  }
+}
+
+void mdn_split(const float *raw, size_t rows, size_t width, size_t n_values, float *mu, float *std) {
+  for (size_t r = 0; r < rows; ++r) {
+    const float *row = raw + r * width;
+    memcpy(mu + r * n_values, row, n_values * sizeof(float));
+    float *std_row = std + r * n_values;
+    for (size_t i = 0; i < n_values; ++i) {
+      std_row[i] = safe_exp(row[n_values + i]);
+    }
+  }
+}
+
+}  // namespace model_parser
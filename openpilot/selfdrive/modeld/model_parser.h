@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+
+// Native kernels for the model output parsing hot path: the activation and
+// MDN-split math from parse_model_outputs.py, applied in place on the raw
+// output tensor. The tensors are a few thousand floats, so the win over
+// numpy is eliminating per-op temporaries and interpreter dispatch rather
+// than SIMD exp; expf stays libm for parity with the numpy reference.
+
+namespace model_parser {
+
+// in-place sigmoid with the same exp clip as safe_exp()
+void sigmoid(float *x, size_t n);
+
+// in-place softmax over the last dimension of a (rows, width) tensor
+void softmax(float *x, size_t rows, size_t width);
+
+// split MDN rows [mu | log_std | ...] into mu and exp(log_std); raw is
+// (rows, width) with width >= 2 * n_values, mu/std are (rows, n_values)
+void mdn_split(const float *raw, size_t rows, size_t width, size_t n_values, float *mu, float *std);
+
+}  // namespace model_parser
@@ -0,0 +1,29 @@
+# distutils: language = c++
+# cython: language_level = 3
+
+cdef extern from "selfdrive/modeld/model_parser.h" namespace "model_parser":
+  void c_sigmoid "model_parser::sigmoid" (float *x, size_t n) nogil
+  void c_softmax "model_parser::softmax" (float *x, size_t rows, size_t width) nogil
+  void c_mdn_split "model_parser::mdn_split" (const float *raw, size_t rows, size_t width,
+                                              size_t n_values, float *mu, float *std) nogil
+
+
+def sigmoid_(float[::1] x):
+  """In-place sigmoid."""
+  with nogil:
+    c_sigmoid(&x[0], x.shape[0])
+
+
+def softmax_(float[:, ::1] x):
+  """In-place softmax over the last dimension."""
+  with nogil:
+    c_softmax(&x[0, 0], x.shape[0], x.shape[1])
+
+
+def mdn_split(const float[:, ::1] raw, float[:, ::1] mu, float[:, ::1] std):
+  """Split MDN rows [mu | log_std | ...] into mu and exp(log_std)."""
+  cdef size_t n_values = mu.shape[1]
+  assert std.shape[0] == mu.shape[0] and std.shape[1] == mu.shape[1]
+  assert raw.shape[0] == mu.shape[0] and raw.shape[1] >= 2 * mu.shape[1]
+  with nogil:
+    c_mdn_split(&raw[0, 0], raw.shape[0], raw.shape[1], n_values, &mu[0, 0], &std[0, 0])
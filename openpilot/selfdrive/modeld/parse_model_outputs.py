@@ -1,5 +1,6 @@
 import numpy as np
 from openpilot.selfdrive.modeld.constants import ModelConstants
+from openpilot.selfdrive.modeld.model_parser_pyx import mdn_split, sigmoid_, softmax_
 
 def safe_exp(x, out=None):
   # -11 is around 10**14, more causes float16 overflow
@@ -33,13 +34,21 @@ class Parser:
     raw = outs[name]
     if out_shape is not None:
       raw = raw.reshape((raw.shape[0],) + out_shape)
-    outs[name] = softmax(raw, axis=-1)
+    if raw.dtype == np.float32 and raw.flags.c_contiguous:
+      softmax_(raw.reshape(-1, raw.shape[-1]))
+      outs[name] = raw
+    else:
+      outs[name] = softmax(raw, axis=-1)
 
   def parse_binary_crossentropy(self, name, outs):
     if self.check_missing(outs, name):
       return
     raw = outs[name]
-    outs[name] = sigmoid(raw)
+    if raw.dtype == np.float32 and raw.flags.c_contiguous:
+      sigmoid_(raw.reshape(-1))
+      outs[name] = raw
+    else:
+      outs[name] = sigmoid(raw)
 
   def parse_mdn(self, name, outs, in_N=0, out_N=1, out_shape=None):
     if self.check_missing(outs, name):
@@ -48,6 +57,22 @@ class Parser:
     raw = raw.reshape((raw.shape[0], max(in_N, 1), -1))
 
     n_values = (raw.shape[2] - out_N)//2
+
+    # single-hypothesis heads (everything but MHP lead) go through the
+    # native kernel: one pass, no intermediate temporaries
+    if in_N <= 1 and raw.dtype == np.float32 and raw.flags.c_contiguous:
+      flat = raw.reshape(-1, raw.shape[2])
+      mu = np.empty((flat.shape[0], n_values), dtype=np.float32)
+      std = np.empty((flat.shape[0], n_values), dtype=np.float32)
+      mdn_split(flat, mu, std)
+      if out_N > 1:
+        final_shape = tuple([raw.shape[0], out_N] + list(out_shape))
+      else:
+        final_shape = tuple([raw.shape[0],] + list(out_shape))
+      outs[name] = mu.reshape(final_shape)
+      outs[name + '_stds'] = std.reshape(final_shape)
+      return
+
     pred_mu = raw[:,:,:n_values]
     pred_std = safe_exp(raw[:,:,n_values: 2*n_values])
 
@@ -18,6 +18,24 @@ Panda::Panda(std::string serial) {
 
   hw_type = get_hw_type();
   can_reset_communications();
+  serial_ = handle->hw_serial;
+}
+
+bool Panda::reconnect() {
+  try {
+    handle = std::make_unique<PandaSpiHandle>(serial_);
+  } catch (std::exception &e) {
+    return false;
+  }
+
+  // hw type and firmware can't change across a drop; one health read is
+  // enough to confirm the device is responsive again
+  if (!get_state()) {
+    return false;
+  }
+
+  can_reset_communications();
+  return true;
 }
 
 bool Panda::connected() {
@@ -165,6 +183,27 @@ static uint8_t len_to_dlc(uint8_t len) {
   }
 }
 
+uint32_t Panda::pack_can_frame(uint8_t *dst, uint32_t addr, uint8_t bus, const uint8_t *data, uint8_t len) {
+  uint8_t data_len_code = len_to_dlc(len);
+  assert(len <= 64);
+  assert(len == dlc_to_len[data_len_code]);
+
+  can_header header = {};
+  header.addr = addr;
+  header.extended = (addr >= 0x800) ? 1 : 0;
+  header.data_len_code = data_len_code;
+  header.bus = bus;
+  header.checksum = 0;
+
+  memcpy(dst, (uint8_t *)&header, sizeof(can_header));
+  memcpy(dst + sizeof(can_header), data, len);
+  uint32_t msg_size = sizeof(can_header) + len;
+
+  // set checksum
+  ((can_header *) dst)->checksum = calculate_checksum(dst, msg_size);
+  return msg_size;
+}
+
 void Panda::pack_can_buffer(const capnp::List<cereal::CanData>::Reader &can_data_list,
                             std::function<void(uint8_t *, size_t)> write_func) {
   int32_t pos = 0;
@@ -177,25 +216,30 @@ void Panda::pack_can_buffer(const capnp::List<cereal::CanData>::Reader &can_data
       continue;
     }
     auto can_data = cmsg.getDat();
-    uint8_t data_len_code = len_to_dlc(can_data.size());
-    assert(can_data.size() <= 64);
-    assert(can_data.size() == dlc_to_len[data_len_code]);
+    pos += pack_can_frame(&send_buf[pos], cmsg.getAddress(), bus, (const uint8_t *)can_data.begin(), can_data.size());
 
-    can_header header = {};
-    header.addr = cmsg.getAddress();
-    header.extended = (cmsg.getAddress() >= 0x800) ? 1 : 0;
-    header.data_len_code = data_len_code;
-    header.bus = bus;
-    header.checksum = 0;
+    if (pos >= USB_TX_SOFT_LIMIT) {
+      write_func(send_buf, pos);
+      pos = 0;
+    }
+  }
 
-    memcpy(&send_buf[pos], (uint8_t *)&header, sizeof(can_header));
-    memcpy(&send_buf[pos + sizeof(can_header)], (uint8_t *)can_data.begin(), can_data.size());
-    uint32_t msg_size = sizeof(can_header) + can_data.size();
+  // send remaining packets
+  if (pos > 0) write_func(send_buf, pos);
+}
 
-    // set checksum
-    ((can_header *) &send_buf[pos])->checksum = calculate_checksum(&send_buf[pos], msg_size);
+void Panda::pack_can_buffer(const std::vector<can_frame> &can_frames,
+                            std::function<void(uint8_t *, size_t)> write_func) {
+  int32_t pos = 0;
+  uint8_t send_buf[2 * USB_TX_SOFT_LIMIT];
 
-    pos += msg_size;
+  for (const auto &frame : can_frames) {
+    // check if the message is intended for this panda
+    uint8_t bus = frame.src;
+    if (bus >= PANDA_BUS_OFFSET) {
+      continue;
+    }
+    pos += pack_can_frame(&send_buf[pos], frame.address, bus, (const uint8_t *)frame.dat.data(), frame.dat.size());
 
     if (pos >= USB_TX_SOFT_LIMIT) {
       write_func(send_buf, pos);
@@ -213,11 +257,41 @@ void Panda::can_send(const capnp::List<cereal::CanData>::Reader &can_data_list)
   });
 }
 
+void Panda::can_send(const std::vector<can_frame> &can_frames) {
+  pack_can_buffer(can_frames, [=](uint8_t* data, size_t size) {
+    handle->bulk_write(3, data, size, 5);
+  });
+}
+
+int Panda::read_can_chunk(uint8_t *data) {
+  int recv = handle->bulk_read(0x81, data, RECV_SIZE);
+  rx_full = (recv == (int)RECV_SIZE);
+  if (!comms_healthy()) {
+    return -1;
+  }
+
+  if (PANDAD_MAXOUT) {
+    static uint8_t junk[RECV_SIZE];
+    handle->bulk_read(0xab, junk, RECV_SIZE - recv);
+  }
+  return recv;
+}
+
+bool Panda::feed_can_chunk(const uint8_t *data, uint32_t len, std::vector<can_frame> &out_vec) {
+  // unpack_can_buffer leaves at most one partial frame behind, so a full
+  // chunk always fits behind the leftover
+  assert(receive_buffer_size + len <= sizeof(receive_buffer));
+  memcpy(&receive_buffer[receive_buffer_size], data, len);
+  receive_buffer_size += len;
+  return unpack_can_buffer(receive_buffer, receive_buffer_size, out_vec);
+}
+
 bool Panda::can_receive(std::vector<can_frame>& out_vec) {
   // Check if enough space left in buffer to store RECV_SIZE data
   assert(receive_buffer_size + RECV_SIZE <= sizeof(receive_buffer));
 
   int recv = handle->bulk_read(0x81, &receive_buffer[receive_buffer_size], RECV_SIZE);
+  rx_full = (recv == (int)RECV_SIZE);
   if (!comms_healthy()) {
     return false;
   }
@@ -242,6 +316,10 @@ void Panda::can_reset_communications() {
 bool Panda::unpack_can_buffer(uint8_t *data, uint32_t &size, std::vector<can_frame> &out_vec) {
   int pos = 0;
 
+  // typical mix is classic 8-byte frames; reserving up front avoids
+  // repeated vector growth under full-bus load
+  out_vec.reserve(out_vec.size() + size / (sizeof(can_header) + 8) + 1);
+
   while (pos <= size - sizeof(can_header)) {
     can_header header;
     memcpy(&header, &data[pos], sizeof(can_header));
@@ -281,9 +359,21 @@ bool Panda::unpack_can_buffer(uint8_t *data, uint32_t &size, std::vector<can_fra
   return true;
 }
 
-uint8_t Panda::calculate_checksum(uint8_t *data, uint32_t len) {
+uint8_t Panda::calculate_checksum(const uint8_t *data, uint32_t len) {
+  // XOR is byte-independent, so fold eight bytes per iteration and reduce
+  // the lanes at the end; this is the hottest loop in CAN ingest
+  uint64_t acc = 0U;
+  uint32_t i = 0U;
+  for (; i + 8 <= len; i += 8) {
+    uint64_t chunk;
+    memcpy(&chunk, &data[i], sizeof(chunk));
+    acc ^= chunk;
+  }
   uint8_t checksum = 0U;
-  for (uint32_t i = 0U; i < len; i++) {
+  for (int shift = 0; shift < 64; shift += 8) {
+    checksum ^= (acc >> shift) & 0xffU;
+  }
+  for (; i < len; i++) {
     checksum ^= data[i];
   }
   return checksum;
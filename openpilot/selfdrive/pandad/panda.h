@@ -46,6 +46,7 @@ struct can_frame {
 class Panda {
 private:
   std::unique_ptr<PandaSpiHandle> handle;
+  std::string serial_;  // pinned on first connect so reconnect() can't grab a different panda
 
 public:
   Panda(std::string serial);
@@ -55,6 +56,11 @@ public:
   bool connected();
   bool comms_healthy();
   std::string hw_serial();
+  // warm reconnect after a transient comms drop: reopens the SPI handle and
+  // revalidates with a single health transaction, reusing the hw type and
+  // firmware check from the cold connect. returns false if the panda isn't
+  // responsive yet.
+  bool reconnect();
 
   // Static functions
   static std::vector<std::string> list();
@@ -82,17 +88,33 @@ public:
   void set_data_speed_kbps(uint16_t bus, uint16_t speed);
   void set_canfd_non_iso(uint16_t bus, bool non_iso);
   void can_send(const capnp::List<cereal::CanData>::Reader &can_data_list);
+  // same wire format, but from frames already unpacked (and possibly
+  // reordered) by the caller, e.g. the sendcan scheduler in pandad.cc
+  void can_send(const std::vector<can_frame> &can_frames);
   bool can_receive(std::vector<can_frame>& out_vec);
+  // receive pipeline stages: read_can_chunk() runs just the bulk transfer and
+  // is safe to call from a reader thread; feed_can_chunk() appends a chunk to
+  // the reassembly buffer and emits complete frames. can_receive() is the
+  // single-threaded combination of the two.
+  int read_can_chunk(uint8_t *data);
+  bool feed_can_chunk(const uint8_t *data, uint32_t len, std::vector<can_frame> &out_vec);
+  // true if the last bulk read came back full, i.e. more frames are likely
+  // still queued on the panda and another read should follow immediately
+  bool rx_buffer_full() const { return rx_full; }
   void can_reset_communications();
 
 protected:
   // for unit tests
   uint8_t receive_buffer[RECV_SIZE + sizeof(can_header) + 64];
   uint32_t receive_buffer_size = 0;
+  bool rx_full = false;
 
   Panda() {}
   void pack_can_buffer(const capnp::List<cereal::CanData>::Reader &can_data_list,
                          std::function<void(uint8_t *, size_t)> write_func);
+  void pack_can_buffer(const std::vector<can_frame> &can_frames,
+                         std::function<void(uint8_t *, size_t)> write_func);
+  uint32_t pack_can_frame(uint8_t *dst, uint32_t addr, uint8_t bus, const uint8_t *data, uint8_t len);
   bool unpack_can_buffer(uint8_t *data, uint32_t &size, std::vector<can_frame> &out_vec);
-  uint8_t calculate_checksum(uint8_t *data, uint32_t len);
+  uint8_t calculate_checksum(const uint8_t *data, uint32_t len);
 };
@@ -1,6 +1,17 @@
 #include "selfdrive/pandad/pandad.h"
 #include "openpilot/cereal/messaging/messaging.h"
 #include "common/swaglog.h"
+#include "common/timing.h"
+
+void PandaSafety::setSafetyModelTimed(cereal::CarParams::SafetyModel safety_model, uint16_t safety_param) {
+  SafetyTransition t = {.mono_time = nanos_since_boot(), .safety_model = safety_model, .safety_param = safety_param};
+  panda_->set_safety_model(safety_model, safety_param);
+  t.duration_ns = nanos_since_boot() - t.mono_time;
+  if (transitions_.size() >= MAX_TRANSITIONS) {
+    transitions_.pop_front();
+  }
+  transitions_.push_back(t);
+}
 
 void PandaSafety::configureSafetyMode(bool is_onroad) {
   if (is_onroad && !safety_configured_) {
@@ -19,11 +30,23 @@ void PandaSafety::configureSafetyMode(bool is_onroad) {
   }
 }
 
+void PandaSafety::reapplyForReconnect() {
+  // the firmware may have rebooted across the drop, which puts it back at its
+  // boot-time safety model. nothing is cached before the first transition,
+  // and the normal configureSafetyMode() flow covers that case.
+  if (transitions_.empty()) {
+    return;
+  }
+  panda_->set_alternative_experience(alternative_experience_);
+  const SafetyTransition &last = transitions_.back();
+  setSafetyModelTimed(last.safety_model, last.safety_param);
+}
+
 void PandaSafety::updateMultiplexingMode() {
   // Initialize to ELM327 without OBD multiplexing for initial fingerprinting
   if (!initialized_) {
     prev_obd_multiplexing_ = false;
-    panda_->set_safety_model(cereal::CarParams::SafetyModel::ELM327, 1U);
+    setSafetyModelTimed(cereal::CarParams::SafetyModel::ELM327, 1U);
     initialized_ = true;
   }
 
@@ -31,7 +54,7 @@ void PandaSafety::updateMultiplexingMode() {
   bool obd_multiplexing_requested = params_.getBool("ObdMultiplexingEnabled");
   if (obd_multiplexing_requested != prev_obd_multiplexing_) {
     const uint16_t safety_param = obd_multiplexing_requested ? 0U : 1U;
-    panda_->set_safety_model(cereal::CarParams::SafetyModel::ELM327, safety_param);
+    setSafetyModelTimed(cereal::CarParams::SafetyModel::ELM327, safety_param);
     prev_obd_multiplexing_ = obd_multiplexing_requested;
     params_.putBool("ObdMultiplexingChanged", true);
   }
@@ -65,6 +88,7 @@ void PandaSafety::setSafetyMode(const std::string &params_string) {
   uint16_t safety_param = safety_configs[0].getSafetyParam();
 
   LOGW("setting safety model: %d, param: %d, alternative experience: %d", (int)safety_model, safety_param, alternative_experience);
+  alternative_experience_ = alternative_experience;
   panda_->set_alternative_experience(alternative_experience);
-  panda_->set_safety_model(safety_model, safety_param);
+  setSafetyModelTimed(safety_model, safety_param);
 }
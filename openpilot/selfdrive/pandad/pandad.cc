@@ -1,19 +1,24 @@
 #include "selfdrive/pandad/pandad.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <bitset>
 #include <cassert>
 #include <cerrno>
 #include <memory>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include "openpilot/cereal/gen/cpp/car.capnp.h"
 #include "openpilot/cereal/messaging/messaging.h"
 #include "openpilot/cereal/services.h"
+#include "common/queue.h"
 #include "common/ratekeeper.h"
 #include "common/swaglog.h"
 #include "common/timing.h"
+#include "common/trace.h"
 #include "common/util.h"
 #include "common/hardware/hw.h"
 
@@ -21,8 +26,14 @@
 #define CUTOFF_IL 400
 #define SATURATE_IL 1000
 
+// how long a warm reconnect keeps retrying before falling back to a full restart
+#define WARM_RECONNECT_TIMEOUT_MS 2000
+
 ExitHandler do_exit;
 
+// written by the main loop, read by can_recv_thread
+static std::atomic<bool> onroad_flag = false;
+
 bool check_connected(Panda *panda) {
   if (!panda->connected()) {
     do_exit = true;
@@ -31,15 +42,9 @@ bool check_connected(Panda *panda) {
   return true;
 }
 
-Panda *connect(std::string serial) {
-  std::unique_ptr<Panda> panda;
-  try {
-    panda = std::make_unique<Panda>(serial);
-  } catch (std::exception &e) {
-    return nullptr;
-  }
-
-  // common panda config
+// common panda config, applied on connect and again after a warm reconnect
+// (the firmware may have rebooted across the drop)
+static void config_panda(Panda *panda) {
   if (getenv("BOARDD_LOOPBACK")) {
     panda->set_loopback(true);
   }
@@ -48,6 +53,17 @@ Panda *connect(std::string serial) {
   for (int i = 0; i < PANDA_CAN_CNT; i++) {
     panda->set_can_fd_auto(i, true);
   }
+}
+
+Panda *connect(std::string serial) {
+  std::unique_ptr<Panda> panda;
+  try {
+    panda = std::make_unique<Panda>(serial);
+  } catch (std::exception &e) {
+    return nullptr;
+  }
+
+  config_panda(panda.get());
 
   if (!panda->up_to_date() && !getenv("BOARDD_SKIP_FW_CHECK")) {
     throw std::runtime_error("Panda firmware out of date. Run pandad.py to update.");
@@ -56,6 +72,23 @@ Panda *connect(std::string serial) {
   return panda.release();
 }
 
+// Frame staged ahead of the wire by can_send_thread. The deadline encodes a
+// per-class latency budget measured from the event's publish time, and the
+// backlog drains earliest-deadline-first.
+struct StagedCanFrame {
+  uint64_t deadline_ns;
+  can_frame frame;
+};
+
+// Latency budget for a frame by priority class. Diagnostic traffic (UDS
+// physical ids 0x700-0x7ff and the 29-bit 0x18DAxxxx range, e.g. tester
+// present) is background chatter on any bus and can wait out a control burst;
+// everything else counts as actuation and keeps a tight budget.
+static uint64_t can_frame_deadline(uint64_t sent_time, uint32_t addr) {
+  bool diag = (addr >= 0x700 && addr <= 0x7ff) || ((addr & 0x1FFF0000) == 0x18DA0000);
+  return sent_time + (diag ? 100000000ULL : 10000000ULL);
+}
+
 void can_send_thread(Panda *panda, bool fake_send) {
   util::set_thread_name("pandad_can_send");
 
@@ -65,6 +98,9 @@ void can_send_thread(Panda *panda, bool fake_send) {
   assert(subscriber != NULL);
   subscriber->setTimeout(100);
 
+  std::vector<StagedCanFrame> staged;
+  std::vector<can_frame> ordered;
+
   // run as fast as messages come in
   while (!do_exit && check_connected(panda)) {
     std::unique_ptr<Message> msg(subscriber->receive());
@@ -72,27 +108,97 @@ void can_send_thread(Panda *panda, bool fake_send) {
       continue;
     }
 
-    capnp::FlatArrayMessageReader cmsg(aligned_buf.align(msg.get()));
-    cereal::Event::Reader event = cmsg.getRoot<cereal::Event>();
+    // drain everything queued behind this message so the scheduler sees the
+    // whole backlog; with control-only traffic this loop runs once and the
+    // sort below is a no-op
+    staged.clear();
+    while (msg) {
+      // read in place when the msgq buffer is word-aligned (the common case);
+      // the aligned_buf copy is only for the rare misaligned message
+      kj::ArrayPtr<const capnp::word> words;
+      if (reinterpret_cast<uintptr_t>(msg->getData()) % sizeof(capnp::word) == 0) {
+        words = kj::ArrayPtr<const capnp::word>((capnp::word *)msg->getData(), msg->getSize() / sizeof(capnp::word));
+      } else {
+        words = aligned_buf.align(msg.get());
+      }
+      capnp::FlatArrayMessageReader cmsg(words);
+      cereal::Event::Reader event = cmsg.getRoot<cereal::Event>();
+
+      // Don't send if older than 1 second
+      if (nanos_since_boot() - event.getLogMonoTime() < 1e9) {
+        for (const auto &c : event.getSendcan()) {
+          auto dat = c.getDat();
+          staged.push_back({can_frame_deadline(event.getLogMonoTime(), c.getAddress()),
+                            {.address = c.getAddress(), .dat = std::string((const char *)dat.begin(), dat.size()), .src = c.getSrc()}});
+        }
+      } else {
+        LOGE("sendcan too old to send: %" PRIu64 ", %" PRIu64, nanos_since_boot(), event.getLogMonoTime());
+      }
+      msg.reset(subscriber->receive(true));
+    }
+
+    if (staged.empty() || fake_send) {
+      continue;
+    }
+
+    // earliest deadline first. a missed deadline still sends (the 1s cut
+    // above is the only drop); this is purely an ordering policy, so an
+    // actuation frame arriving behind a queued bulk write goes out first.
+    // the sort is stable so frames within a class keep arrival order, which
+    // preserves per-bus ordering on the wire.
+    std::stable_sort(staged.begin(), staged.end(),
+                     [](const StagedCanFrame &a, const StagedCanFrame &b) { return a.deadline_ns < b.deadline_ns; });
+    ordered.clear();
+    for (auto &s : staged) {
+      ordered.push_back(std::move(s.frame));
+    }
 
-    // Don't send if older than 1 second
-    if ((nanos_since_boot() - event.getLogMonoTime() < 1e9) && !fake_send) {
-      LOGT("sending sendcan to panda: %s", (panda->hw_serial()).c_str());
-      panda->can_send(event.getSendcan());
-      LOGT("sendcan sent to panda: %s", (panda->hw_serial()).c_str());
-    } else {
-      LOGE("sendcan too old to send: %" PRIu64 ", %" PRIu64, nanos_since_boot(), event.getLogMonoTime());
+    OP_TRACE_SPAN("can_send");
+    LOGT("sending sendcan to panda: %s", (panda->hw_serial()).c_str());
+    panda->can_send(ordered);
+    LOGT("sendcan sent to panda: %s", (panda->hw_serial()).c_str());
+  }
+}
+
+// SocketCAN-style acceptance filter: a frame passes if (address & mask) == id.
+struct CanFilter {
+  uint32_t id;
+  uint32_t mask;
+};
+
+// CanFilterIds param: comma-separated hex "id" or "id:mask" entries,
+// e.g. "0x1d2,0x200:0x7f0". Read once at pandad startup.
+static std::vector<CanFilter> parse_can_filters(const std::string &config) {
+  std::vector<CanFilter> filters;
+  const char *p = config.c_str();
+  while (*p != '\0') {
+    char *end = nullptr;
+    uint32_t id = strtoul(p, &end, 16);
+    if (end == p) break;
+    uint32_t mask = 0x1FFFFFFF;
+    if (*end == ':') {
+      mask = strtoul(end + 1, &end, 16);
     }
+    filters.push_back({id & mask, mask});
+    p = (*end == ',') ? end + 1 : end;
   }
+  return filters;
 }
 
-void can_recv(Panda *panda, PubMaster *pm) {
-  static std::vector<can_frame> raw_can_data;
+void publish_can(PubMaster *pm, const std::vector<can_frame> &raw_can_data, bool comms_healthy,
+                 bool publish_empty, const std::vector<CanFilter> &filters) {
   {
-    raw_can_data.clear();
-    bool comms_healthy = panda->can_receive(raw_can_data);
+    OP_TRACE_SPAN("can_recv");
+    // offroad the buses are usually silent; skip publishing empty events to
+    // avoid waking up subscribers for nothing. unhealthy reads always publish
+    // so consumers see valid=false.
+    if (raw_can_data.empty() && comms_healthy && !publish_empty) {
+      return;
+    }
 
+    std::vector<std::pair<const char *, MessageBuilder *>> batch;
     MessageBuilder msg;
+    MessageBuilder fmsg;
     auto evt = msg.initEvent();
     evt.setValid(comms_healthy);
     auto canData = evt.initCan(raw_can_data.size());
@@ -101,8 +207,108 @@ void can_recv(Panda *panda, PubMaster *pm) {
       canData[i].setDat(kj::arrayPtr((uint8_t*)raw_can_data[i].dat.data(), raw_can_data[i].dat.size()));
       canData[i].setSrc(raw_can_data[i].src);
     }
-    pm->send("can", msg);
+    batch.push_back({"can", &msg});
+
+    // tap for experiment processes: re-publish only the frames matching the
+    // acceptance filters, so subscribers stop paying to parse the full bus
+    if (!filters.empty()) {
+      static std::vector<const can_frame *> matched;
+      matched.clear();
+      for (const auto &frame : raw_can_data) {
+        for (const auto &f : filters) {
+          if (((uint32_t)frame.address & f.mask) == f.id) {
+            matched.push_back(&frame);
+            break;
+          }
+        }
+      }
+      if (!matched.empty()) {
+        auto fevt = fmsg.initEvent();
+        fevt.setValid(comms_healthy);
+        auto fdata = fevt.initCanFiltered(matched.size());
+        for (size_t i = 0; i < matched.size(); ++i) {
+          fdata[i].setAddress(matched[i]->address);
+          fdata[i].setDat(kj::arrayPtr((uint8_t*)matched[i]->dat.data(), matched[i]->dat.size()));
+          fdata[i].setSrc(matched[i]->src);
+        }
+        batch.push_back({"canFiltered", &fmsg});
+      }
+    }
+    pm->sendBatch(batch);
+  }
+}
+
+void can_recv_thread(Panda *panda) {
+  util::set_thread_name("pandad_can_recv");
+
+  // Dedicated receive pipeline so CAN never queues behind the state and
+  // peripheral control transfers in the main loop. A reader stage keeps the
+  // transport busy while this thread unpacks and publishes; chunks come from
+  // a fixed pre-posted pool, so a parse hiccup backpressures the reader
+  // instead of allocating or dropping. If we ever run more than one panda
+  // again, each gets its own reader and the frames merge here at the single
+  // publisher, keeping per-bus ordering.
+  const std::vector<CanFilter> filters = parse_can_filters(Params().get("CanFilterIds"));
+  std::vector<const char *> service_list = {"can"};
+  if (!filters.empty()) {
+    LOGW("publishing canFiltered with %zu filters", filters.size());
+    service_list.push_back("canFiltered");
+  }
+  PubMaster pm(service_list);
+
+  struct CanChunk {
+    int len;
+    uint8_t data[RECV_SIZE];
+  };
+  static constexpr int CHUNK_POOL_SIZE = 8;
+  std::vector<std::unique_ptr<CanChunk>> pool;
+  SpscRing<CanChunk *> free_chunks(CHUNK_POOL_SIZE);
+  SpscRing<CanChunk *> filled_chunks(CHUNK_POOL_SIZE);
+  for (int i = 0; i < CHUNK_POOL_SIZE; i++) {
+    pool.push_back(std::make_unique<CanChunk>());
+    free_chunks.try_push(pool.back().get());
+  }
+
+  std::thread reader([&]() {
+    util::set_thread_name("pandad_can_read");
+    RateKeeper rk("pandad_can_read", 100);
+    while (!do_exit && check_connected(panda)) {
+      CanChunk *chunk = nullptr;
+      if (!free_chunks.try_pop(chunk)) {
+        util::sleep_for(1);
+        continue;
+      }
+      chunk->len = panda->read_can_chunk(chunk->data);
+      filled_chunks.try_push(chunk);  // can't fail: pool size bounds occupancy
+      // a full read means more frames are already queued on the panda, so
+      // keep draining instead of letting them age out the rest of the tick
+      if (!panda->rx_buffer_full()) {
+        rk.keepTime();
+      }
+    }
+  });
+
+  std::vector<can_frame> raw_can_data;
+  while (!do_exit && check_connected(panda)) {
+    CanChunk *chunk = nullptr;
+    if (!filled_chunks.try_pop(chunk)) {
+      util::sleep_for(1);
+      continue;
+    }
+
+    raw_can_data.clear();
+    bool comms_healthy = true;
+    if (chunk->len < 0) {
+      comms_healthy = false;
+    } else if (chunk->len > 0) {
+      comms_healthy = panda->feed_can_chunk(chunk->data, chunk->len, raw_can_data);
+    }
+    free_chunks.try_push(chunk);
+
+    publish_can(&pm, raw_can_data, comms_healthy, onroad_flag, filters);
   }
+
+  reader.join();
 }
 
 void fill_panda_state(cereal::PandaState::Builder &ps, cereal::PandaState::PandaType hw_type, const health_t &health) {
@@ -161,7 +367,7 @@ void fill_panda_can_state(cereal::PandaState::PandaCanState::Builder &cs, const
   cs.setCanCoreResetCnt(can_health.can_core_reset_cnt);
 }
 
-std::optional<bool> send_panda_states(PubMaster *pm, Panda *panda, bool is_onroad, bool spoofing_started) {
+std::optional<bool> send_panda_states(PubMaster *pm, Panda *panda, const PandaSafety &panda_safety, bool is_onroad, bool spoofing_started) {
   // build msg
   MessageBuilder msg;
   auto evt = msg.initEvent();
@@ -217,6 +423,16 @@ std::optional<bool> send_panda_states(PubMaster *pm, Panda *panda, bool is_onroa
     fill_panda_can_state(cs[j], can_health[j]);
   }
 
+  // recent safety mode transitions with their transfer timing
+  const auto &transitions = panda_safety.transitions();
+  auto sts = ps.initSafetyTransitions(transitions.size());
+  for (size_t t = 0; t < transitions.size(); t++) {
+    sts[t].setMonoTime(transitions[t].mono_time);
+    sts[t].setDurationNs(transitions[t].duration_ns);
+    sts[t].setSafetyModel(transitions[t].safety_model);
+    sts[t].setSafetyParam(transitions[t].safety_param);
+  }
+
   // Convert faults bitset to capnp list
   std::bitset<sizeof(health.faults_pkt) * 8> fault_bits(health.faults_pkt);
   auto faults = ps.initFaults(fault_bits.count());
@@ -234,8 +450,10 @@ std::optional<bool> send_panda_states(PubMaster *pm, Panda *panda, bool is_onroa
   return ignition_local;
 }
 
-void send_peripheral_state(Panda *panda, PubMaster *pm) {
-  auto health_opt = panda->get_state();
+void send_peripheral_state(Panda *panda, PubMaster *pm, const std::optional<health_t> &cached_health) {
+  // reuse the fast-lane snapshot when we have one; voltage/current don't move
+  // fast enough to justify another control transfer
+  auto health_opt = cached_health ? cached_health : panda->get_state();
   if (!health_opt) {
     return;
   }
@@ -258,8 +476,8 @@ void send_peripheral_state(Panda *panda, PubMaster *pm) {
   pm->send("peripheralState", msg);
 }
 
-void process_panda_state(Panda *panda, PubMaster *pm, bool engaged, bool is_onroad, bool spoofing_started) {
-  auto ignition_opt = send_panda_states(pm, panda, is_onroad, spoofing_started);
+void process_panda_state(Panda *panda, PubMaster *pm, const PandaSafety &panda_safety, bool engaged, bool is_onroad, bool spoofing_started) {
+  auto ignition_opt = send_panda_states(pm, panda, panda_safety, is_onroad, spoofing_started);
   if (!ignition_opt) {
     LOGE("Failed to get ignition_opt");
     return;
@@ -357,44 +575,62 @@ void process_peripheral_state(Panda *panda, PubMaster *pm, bool no_fan_control,
   }
 }
 
-void pandad_run(Panda *panda) {
+void pandad_run(Panda *panda, PandaSafety &panda_safety) {
   const bool no_fan_control = getenv("NO_FAN_CONTROL") != nullptr;
   const bool spoofing_started = getenv("STARTED") != nullptr;
   const bool fake_send = getenv("FAKESEND") != nullptr;
 
-  // Start helper thread for event-driven sendcan.
+  // Helper threads: event-driven sendcan, and CAN receive on its own cadence.
   std::thread send_thread(can_send_thread, panda, fake_send);
+  std::thread recv_thread(can_recv_thread, panda);
 
   RateKeeper rk("pandad", 100);
   SubMaster sm({"selfdriveState", "deviceState"});
-  PubMaster pm({"can", "pandaStates", "peripheralState"});
-  PandaSafety panda_safety(panda);
+  PubMaster pm({"pandaStates", "peripheralState"});
   bool engaged = false;
   bool is_onroad = false;
 
-  // Main loop: receive CAN first, then process lower priority panda and peripheral state.
+  // fast lane: compact health poll for fault detection, decoupled from the
+  // full pandaStates snapshot (which also reads the per-bus CAN counters)
+  std::optional<health_t> fast_health;
+  uint32_t prev_faults = 0;
+  bool force_panda_state = false;
+
+  // Main loop: panda and peripheral state housekeeping; CAN runs in the helper threads.
   while (!do_exit && check_connected(panda)) {
-    can_recv(panda, &pm);
+    // Fast lane at 20 Hz: one control transfer, just enough to catch faults
+    // between full snapshots. A fault-bit change forces the slow lane now
+    // instead of waiting out its 10 Hz cadence.
+    if (rk.frame() % 5 == 0) {
+      fast_health = panda->get_state();
+      if (fast_health && fast_health->faults_pkt != prev_faults) {
+        LOGE("panda fault status changed: 0x%x -> 0x%x", prev_faults, fast_health->faults_pkt);
+        prev_faults = fast_health->faults_pkt;
+        force_panda_state = true;
+      }
+    }
 
     // Process peripheral state at 20 Hz
     if (rk.frame() % 5 == 0) {
       process_peripheral_state(panda, &pm, no_fan_control, is_onroad);
     }
 
-    // Process panda state at 10 Hz
-    if (rk.frame() % 10 == 0) {
+    // Process panda state at 10 Hz (slow lane: full health + CAN counters)
+    if (rk.frame() % 10 == 0 || force_panda_state) {
+      force_panda_state = false;
       sm.update(0);
       engaged = sm.allAliveAndValid({"selfdriveState"}) && sm["selfdriveState"].getSelfdriveState().getEnabled();
       if (sm.updated("deviceState")) {
         is_onroad = sm["deviceState"].getDeviceState().getStarted();
+        onroad_flag = is_onroad;
       }
-      process_panda_state(panda, &pm, engaged, is_onroad, spoofing_started);
+      process_panda_state(panda, &pm, panda_safety, engaged, is_onroad, spoofing_started);
       panda_safety.configureSafetyMode(is_onroad);
     }
 
     // Send out peripheralState at 2Hz
     if (rk.frame() % 50 == 0) {
-      send_peripheral_state(panda, &pm);
+      send_peripheral_state(panda, &pm, fast_health);
     }
 
     // Forward logs from panda to cloudlog if available
@@ -419,6 +655,7 @@ void pandad_run(Panda *panda) {
   }
 
   send_thread.join();
+  recv_thread.join();
 }
 
 void pandad_main_thread(std::string serial) {
@@ -443,7 +680,39 @@ void pandad_main_thread(std::string serial) {
 
   if (!do_exit) {
     LOGW("connected to panda");
-    pandad_run(panda);
+    PandaSafety panda_safety(panda);
+
+    while (true) {
+      pandad_run(panda, panda_safety);
+
+      // a signal means we're shutting down; anything else was a comms drop.
+      // try a warm reconnect before giving up: the handle reopens and
+      // revalidates with one health transaction, and the cached bus/safety
+      // config is pushed straight back, so a transient drop costs tens of
+      // milliseconds of CAN instead of a full cold restart.
+      if (ExitHandler::signal != 0) {
+        break;
+      }
+
+      LOGW("lost connection to panda, attempting warm reconnect");
+      double start = millis_since_boot();
+      bool reconnected = false;
+      while (ExitHandler::signal == 0 && (millis_since_boot() - start) < WARM_RECONNECT_TIMEOUT_MS) {
+        if (panda->reconnect()) {
+          reconnected = true;
+          break;
+        }
+        util::sleep_for(10);
+      }
+      if (!reconnected) {
+        break;
+      }
+
+      config_panda(panda);
+      panda_safety.reapplyForReconnect();
+      do_exit = false;  // was set by check_connected
+      LOGW("panda warm reconnect took %.1f ms", millis_since_boot() - start);
+    }
   }
 
   delete panda;
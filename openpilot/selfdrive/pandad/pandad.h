@@ -1,5 +1,6 @@
 #pragma once
 
+#include <deque>
 #include <string>
 
 #include "common/params.h"
@@ -11,16 +12,34 @@ class PandaSafety {
 public:
   PandaSafety(Panda *panda) : panda_(panda) {}
   void configureSafetyMode(bool is_onroad);
+  // push the last applied safety configuration back after a warm panda
+  // reconnect, so actuation resumes without waiting out the CarParams flow
+  void reapplyForReconnect();
+
+  // timing records of recent set_safety_model calls, for quantifying
+  // engagement-path latency across firmware versions. newest last.
+  struct SafetyTransition {
+    uint64_t mono_time;
+    uint64_t duration_ns;
+    cereal::CarParams::SafetyModel safety_model;
+    uint16_t safety_param;
+  };
+  const std::deque<SafetyTransition> &transitions() const { return transitions_; }
 
 private:
   void updateMultiplexingMode();
   std::string fetchCarParams();
   void setSafetyMode(const std::string &params_string);
+  void setSafetyModelTimed(cereal::CarParams::SafetyModel safety_model, uint16_t safety_param);
+
+  static constexpr size_t MAX_TRANSITIONS = 16;
+  std::deque<SafetyTransition> transitions_;
 
   bool initialized_ = false;
   bool log_once_ = false;
   bool safety_configured_ = false;
   bool prev_obd_multiplexing_ = false;
+  uint16_t alternative_experience_ = 0;  // cached for reapplyForReconnect()
   Panda *panda_;
   Params params_;
 };
@@ -186,19 +186,31 @@ std::vector<std::string> PandaSpiHandle::list() {
   return {};
 }
 
-void add_checksum(uint8_t *data, int data_len) {
-  data[data_len] = SPI_CHECKSUM_START;
-  for (int i=0; i < data_len; i++) {
-    data[data_len] ^= data[i];
+static uint8_t spi_checksum(const uint8_t *data, int data_len) {
+  // XOR is byte-independent, so fold eight bytes per iteration and reduce
+  uint64_t acc = 0U;
+  int i = 0;
+  for (; i + 8 <= data_len; i += 8) {
+    uint64_t chunk;
+    memcpy(&chunk, &data[i], sizeof(chunk));
+    acc ^= chunk;
   }
-}
-
-bool check_checksum(uint8_t *data, int data_len) {
   uint8_t checksum = SPI_CHECKSUM_START;
-  for (uint16_t i = 0U; i < data_len; i++) {
+  for (int shift = 0; shift < 64; shift += 8) {
+    checksum ^= (acc >> shift) & 0xffU;
+  }
+  for (; i < data_len; i++) {
     checksum ^= data[i];
   }
-  return checksum == 0U;
+  return checksum;
+}
+
+void add_checksum(uint8_t *data, int data_len) {
+  data[data_len] = spi_checksum(data, data_len);
+}
+
+bool check_checksum(uint8_t *data, int data_len) {
+  return spi_checksum(data, data_len) == 0U;
 }
 
 
@@ -327,6 +339,10 @@ int PandaSpiHandle::spi_transfer(uint8_t endpoint, uint8_t *tx_data, uint16_t tx
     .max_rx_len = max_rx_len
   };
 
+  // compute the data checksum up front, so the panda isn't kept waiting
+  // between its header ACK and the data phase
+  uint8_t tx_checksum = (tx_data != NULL) ? spi_checksum(tx_data, tx_len) : SPI_CHECKSUM_START;
+
   spi_ioc_transfer transfer = {
     .tx_buf = (uint64_t)tx_buf,
     .rx_buf = (uint64_t)rx_buf
@@ -352,7 +368,7 @@ int PandaSpiHandle::spi_transfer(uint8_t endpoint, uint8_t *tx_data, uint16_t tx
   if (tx_data != NULL) {
     memcpy(tx_buf, tx_data, tx_len);
   }
-  add_checksum(tx_buf, tx_len);
+  tx_buf[tx_len] = tx_checksum;
   transfer.len = tx_len + 1;
   ret = lltransfer(transfer);
   if (ret < 0) {
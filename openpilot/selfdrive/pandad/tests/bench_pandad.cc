@@ -0,0 +1,102 @@
+// pandad CAN pipeline benchmark: drives the pack/unpack protocol code and
+// capnp event construction against a simulated panda endpoint (an in-memory
+// wire image), reporting per-cycle latency percentiles for both directions.
+// The real transport is a synchronous SPI ioctl, so this measures everything
+// above the wire: sendcan-to-wire on the way out, wire-to-publish on the way
+// in. Run before/after protocol changes to catch actuation-path regressions.
+//
+// usage: ./bench_pandad [seconds] [frames_per_cycle]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "openpilot/cereal/messaging/messaging.h"
+#include "common/timing.h"
+#include "selfdrive/pandad/panda.h"
+
+struct PandaBench : public Panda {
+  PandaBench() : Panda() {
+    hw_type = cereal::PandaState::PandaType::RED_PANDA;
+  }
+  using Panda::pack_can_buffer;
+};
+
+static double percentile(std::vector<double> &v, double p) {
+  std::sort(v.begin(), v.end());
+  return v[std::min(v.size() - 1, (size_t)(p * v.size()))];
+}
+
+static void report(const char *name, std::vector<double> &lat_ms) {
+  printf("%-16s cycles %6zu  p50 %7.1f us  p99 %7.1f us  max %7.1f us\n",
+         name, lat_ms.size(),
+         percentile(lat_ms, 0.50) * 1e3, percentile(lat_ms, 0.99) * 1e3,
+         *std::max_element(lat_ms.begin(), lat_ms.end()) * 1e3);
+}
+
+int main(int argc, char **argv) {
+  double seconds = argc > 1 ? atof(argv[1]) : 5.0;
+  int frames = argc > 2 ? atoi(argv[2]) : 256;
+
+  PandaBench panda;
+
+  // representative bus load: mixed classic and CAN-FD lengths across 3 buses
+  MessageBuilder msg;
+  auto can_list = msg.initEvent().initSendcan(frames);
+  std::mt19937 rng(42);
+  uint8_t dat[64];
+  for (int i = 0; i < frames; i++) {
+    for (auto &b : dat) b = rng();
+    int data_len = dlc_to_len[rng() % std::size(dlc_to_len)];
+    auto can = can_list[i];
+    can.setAddress(0x100 + i);
+    can.setSrc(rng() % 3);
+    can.setDat(kj::ArrayPtr(dat, (size_t)data_len));
+  }
+  auto can_data_list = can_list.asReader();
+
+  // the simulated endpoint: pack once to build the wire image that the
+  // receive direction replays every cycle
+  std::vector<uint8_t> wire;
+  panda.pack_can_buffer(can_data_list, [&](uint8_t *d, size_t s) {
+    wire.insert(wire.end(), d, d + s);
+  });
+  printf("%d frames per cycle, %zu bytes on the wire\n", frames, wire.size());
+
+  std::vector<double> send_lat, recv_lat;
+  std::vector<can_frame> out;
+  size_t wire_bytes = 0;
+
+  double end_t = millis_since_boot() + seconds * 1e3;
+  while (millis_since_boot() < end_t) {
+    // sendcan-to-wire: reader walk, headers, checksums, chunking
+    double t0 = millis_since_boot();
+    panda.pack_can_buffer(can_data_list, [&](uint8_t *d, size_t s) { wire_bytes += s; });
+    double t1 = millis_since_boot();
+
+    // wire-to-publish: unpack plus full can event construction/serialization
+    out.clear();
+    for (size_t pos = 0; pos < wire.size(); pos += RECV_SIZE) {
+      panda.feed_can_chunk(&wire[pos], std::min((size_t)RECV_SIZE, wire.size() - pos), out);
+    }
+    MessageBuilder evt_msg;
+    auto evt = evt_msg.initEvent();
+    auto can_data = evt.initCan(out.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+      can_data[i].setAddress(out[i].address);
+      can_data[i].setDat(kj::arrayPtr((uint8_t *)out[i].dat.data(), out[i].dat.size()));
+      can_data[i].setSrc(out[i].src);
+    }
+    wire_bytes += evt_msg.toBytes().size();
+    double t2 = millis_since_boot();
+
+    send_lat.push_back(t1 - t0);
+    recv_lat.push_back(t2 - t1);
+  }
+
+  report("sendcan-to-wire", send_lat);
+  report("wire-to-publish", recv_lat);
+  return 0;
+}
@@ -31,6 +31,7 @@ const std::string VALID_CACHE_PATH = "/data/.openpilot_cache";
 #define TMP_INSTALL_PATH "/data/tmppilot"
 
 const int FONT_SIZE = 160;
+const int MAX_FETCH_ATTEMPTS = 5;
 
 extern const uint8_t str_continue[] asm("_binary_selfdrive_ui_installer_continue_openpilot_sh_start");
 extern const uint8_t str_continue_end[] asm("_binary_selfdrive_ui_installer_continue_openpilot_sh_end");
@@ -122,28 +123,46 @@ int doInstall() {
     LOGD("Waiting for valid time");
   }
 
-  // cleanup previous install attempts
-  run("rm -rf " TMP_INSTALL_PATH);
+  bool cached = util::file_exists(INSTALL_PATH) && util::file_exists(VALID_CACHE_PATH);
 
-  // do the install
-  if (util::file_exists(INSTALL_PATH) && util::file_exists(VALID_CACHE_PATH)) {
-    return cachedFetch(INSTALL_PATH);
-  } else {
-    return freshClone();
+  // a failed fetch leaves TMP_INSTALL_PATH in place, so retries (and installer
+  // restarts) keep everything git already has instead of starting the
+  // multi-GB download over on flaky shop WiFi
+  int err = -1;
+  for (int attempt = 0; attempt < MAX_FETCH_ATTEMPTS && err != 0; ++attempt) {
+    if (attempt > 0) {
+      LOGW("fetch failed, retrying (attempt %d)", attempt);
+      util::sleep_for(5 * 1000);
+    }
+    err = cached ? cachedFetch(INSTALL_PATH) : freshClone();
   }
+  return err;
 }
 
 int freshClone() {
   LOGD("Doing fresh clone");
-  std::string cmd = util::string_format("git clone --progress %s -b %s --depth=1 --recurse-submodules %s 2>&1",
-                                        GIT_URL.c_str(), migrated_branch.c_str(), TMP_INSTALL_PATH);
-  return executeGitCommand(cmd);
+
+  // a clone can't resume, so set the repo up by hand and fetch into it: git's
+  // object store then carries completed work across retries and restarts
+  if (!util::file_exists(TMP_INSTALL_PATH "/.git")) {
+    run("rm -rf " TMP_INSTALL_PATH);
+    run("git init -q " TMP_INSTALL_PATH);
+    run(util::string_format("cd %s && git remote add origin %s", TMP_INSTALL_PATH, GIT_URL.c_str()).c_str());
+  }
+  run(util::string_format("cd %s && git remote set-url origin %s", TMP_INSTALL_PATH, GIT_URL.c_str()).c_str());
+
+  return executeGitCommand(util::string_format("cd %s && git fetch --progress --depth=1 origin %s 2>&1",
+                                               TMP_INSTALL_PATH, migrated_branch.c_str()));
 }
 
 int cachedFetch(const std::string &cache) {
   LOGD("Fetching with cache: %s", cache.c_str());
 
-  run(util::string_format("cp -rp %s %s", cache.c_str(), TMP_INSTALL_PATH).c_str());
+  // only seed from the cache once; an interrupted fetch resumes in the copy
+  if (!util::file_exists(TMP_INSTALL_PATH "/.git")) {
+    run("rm -rf " TMP_INSTALL_PATH);
+    run(util::string_format("cp -rp %s %s", cache.c_str(), TMP_INSTALL_PATH).c_str());
+  }
   run(util::string_format("cd %s && git remote set-url origin %s", TMP_INSTALL_PATH, GIT_URL.c_str()).c_str());
   run(util::string_format("cd %s && git remote set-branches --add origin %s", TMP_INSTALL_PATH, migrated_branch.c_str()).c_str());
 
@@ -39,6 +39,13 @@ from openpilot.common.version import get_build_metadata
 from openpilot.common.hardware.hw import Paths
 from openpilot.system.athena.rpc import dispatcher, dumps_call, handle, is_call, is_response, loads
 
+# native engine moves upload bytes without interpreter copies; fall back to
+# requests where it isn't built
+try:
+  from openpilot.system.athena.upload_engine_pyx import NativeUpload
+except ImportError:
+  NativeUpload = None
+
 
 ATHENA_HOST = os.getenv('ATHENA_HOST', 'wss://athena.comma.ai')
 HANDLER_THREADS = int(os.getenv('HANDLER_THREADS', "4"))
@@ -319,7 +326,50 @@ def upload_handler(end_event: threading.Event) -> None:
       cloudlog.exception("athena.upload_handler.exception")
 
 
-def _do_upload(upload_item: UploadItem, callback: Callable | None = None) -> requests.Response:
+class UploadResponse:
+  # the minimal slice of requests.Response the upload handler uses
+  def __init__(self, status_code: int):
+    self.status_code = status_code
+
+  def __enter__(self):
+    return self
+
+  def __exit__(self, *exc):
+    return False
+
+
+def _do_native_upload(upload_item: UploadItem, path: str, compress: bool, callback: Callable | None) -> UploadResponse:
+  engine = NativeUpload(upload_item.url, [f"{k}: {v}" for k, v in upload_item.headers.items()], UPLOAD_TOS)
+  if compress:
+    stream, _ = get_upload_stream(path, True)
+    with stream:
+      engine.set_body(stream.getvalue())
+  else:
+    engine.set_file(path)
+
+  engine.start()
+  try:
+    while not engine.done:
+      if callback:
+        callback(engine.content_length, engine.bytes_sent)
+      time.sleep(0.1)
+  except AbortTransferException:
+    engine.abort()
+    engine.wait()
+    raise
+  engine.wait()
+
+  if engine.aborted:
+    raise AbortTransferException
+  if engine.error:
+    # map transport failures onto the exceptions the retry logic already handles
+    raise requests.exceptions.ConnectionError(engine.error)
+  if callback:
+    callback(engine.content_length, engine.bytes_sent)
+  return UploadResponse(engine.status_code)
+
+
+def _do_upload(upload_item: UploadItem, callback: Callable | None = None) -> requests.Response | UploadResponse:
   path = upload_item.path
   compress = False
 
@@ -328,6 +378,9 @@ def _do_upload(upload_item: UploadItem, callback: Callable | None = None) -> req
     path = strip_zst_extension(path)
     compress = True
 
+  if NativeUpload is not None:
+    return _do_native_upload(upload_item, path, compress, callback)
+
   stream = None
   try:
     stream, content_length = get_upload_stream(path, compress)
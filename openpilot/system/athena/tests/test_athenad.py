@@ -239,8 +239,8 @@ class TestAthenadMethods:
   @pytest.mark.parametrize("status,retry", [(500,True), (412,False)])
   @with_upload_handler
   def test_upload_handler_retry(self, mocker, host, status, retry):
-    mock_put = mocker.patch('openpilot.system.athena.athenad.UPLOAD_SESS.put')
-    mock_put.return_value.__enter__.return_value.status_code = status
+    mock_upload = mocker.patch('openpilot.system.athena.athenad._do_upload')
+    mock_upload.return_value.__enter__.return_value.status_code = status
     fn = self._create_file('qlog.zst')
     item = athenad.UploadItem(path=fn, url=f"{host}/qlog.zst", headers={}, created_at=int(time.time()*1000), id='', allow_cellular=True)  # noqa: TID251
 
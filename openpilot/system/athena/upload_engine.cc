@@ -0,0 +1,153 @@
+#include "system/athena/upload_engine.h"
+
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <sys/stat.h>
+
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+// connection and stall limits; no total timeout since large uploads on slow
+// links are legitimate
+constexpr long CONNECT_TIMEOUT_S = 30;
+constexpr long LOW_SPEED_LIMIT_BPS = 1;
+constexpr long LOW_SPEED_TIME_S = 30;
+
+static int sockopt_callback(void *clientp, curl_socket_t fd, curlsocktype purpose) {
+  if (purpose == CURLSOCKTYPE_IPCXN) {
+    const int tos = *static_cast<int *>(clientp);
+    setsockopt(fd, IPPROTO_IP, IP_TOS, &tos, sizeof(tos));
+  }
+  return CURL_SOCKOPT_OK;
+}
+
+UploadEngine::UploadEngine(const std::string &url, const std::vector<std::string> &headers, int tos)
+    : url_(url), headers_(headers), tos_(tos) {}
+
+void UploadEngine::set_file(const std::string &path) {
+  assert(!thread_.joinable());
+  path_ = path;
+  struct stat st = {};
+  if (stat(path.c_str(), &st) == 0) {
+    content_length_ = st.st_size;
+  }
+}
+
+void UploadEngine::set_body(std::string body) {
+  assert(!thread_.joinable());
+  body_ = std::move(body);
+  content_length_ = body_.size();
+}
+
+UploadEngine::~UploadEngine() {
+  abort_ = true;
+  wait();
+}
+
+void UploadEngine::start() {
+  assert(!thread_.joinable());
+  thread_ = std::thread(&UploadEngine::run, this);
+}
+
+void UploadEngine::wait() {
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+std::string UploadEngine::error() const {
+  std::lock_guard lk(error_mutex_);
+  return error_;
+}
+
+int UploadEngine::progress_callback(void *self_ptr, int64_t dltotal, int64_t dlnow, int64_t ultotal, int64_t ulnow) {
+  (void)dltotal; (void)dlnow; (void)ultotal;
+  UploadEngine *self = static_cast<UploadEngine *>(self_ptr);
+  self->bytes_sent_ = ulnow;
+  return self->abort_ ? 1 : 0;
+}
+
+size_t UploadEngine::body_read_callback(char *buffer, size_t size, size_t nitems, void *self_ptr) {
+  UploadEngine *self = static_cast<UploadEngine *>(self_ptr);
+  const size_t n = std::min(size * nitems, self->body_.size() - self->body_offset_);
+  memcpy(buffer, self->body_.data() + self->body_offset_, n);
+  self->body_offset_ += n;
+  return n;
+}
+
+void UploadEngine::run() {
+  static std::once_flag curl_init;
+  std::call_once(curl_init, []() { curl_global_init(CURL_GLOBAL_DEFAULT); });
+
+  CURL *curl = curl_easy_init();
+  FILE *f = nullptr;
+  std::string err;
+  char errbuf[CURL_ERROR_SIZE] = {};
+
+  if (curl != nullptr) {
+    curl_easy_setopt(curl, CURLOPT_URL, url_.c_str());
+    curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
+    curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, (curl_off_t)content_length_);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, CONNECT_TIMEOUT_S);
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, LOW_SPEED_LIMIT_BPS);
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, LOW_SPEED_TIME_S);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, errbuf);
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, progress_callback);
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, this);
+    curl_easy_setopt(curl, CURLOPT_SOCKOPTFUNCTION, sockopt_callback);
+    curl_easy_setopt(curl, CURLOPT_SOCKOPTDATA, &tos_);
+    // response bodies are tiny (presigned PUT), discard them
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, +[](char *, size_t size, size_t nmemb, void *) { return size * nmemb; });
+
+    if (!path_.empty()) {
+      // file body: libcurl freads straight into its send buffer
+      f = fopen(path_.c_str(), "rb");
+      if (f != nullptr) {
+        curl_easy_setopt(curl, CURLOPT_READDATA, f);
+      } else {
+        err = "failed to open " + path_;
+      }
+    } else {
+      curl_easy_setopt(curl, CURLOPT_READFUNCTION, body_read_callback);
+      curl_easy_setopt(curl, CURLOPT_READDATA, this);
+    }
+
+    curl_slist *hdrs = nullptr;
+    for (const std::string &h : headers_) {
+      hdrs = curl_slist_append(hdrs, h.c_str());
+    }
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, hdrs);
+
+    if (err.empty()) {
+      const CURLcode res = curl_easy_perform(curl);
+      if (res == CURLE_OK) {
+        long code = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+        status_code_ = code;
+      } else if (res == CURLE_ABORTED_BY_CALLBACK) {
+        was_aborted_ = true;
+      } else {
+        err = errbuf[0] != '\0' ? errbuf : curl_easy_strerror(res);
+      }
+    }
+
+    curl_slist_free_all(hdrs);
+    curl_easy_cleanup(curl);
+  } else {
+    err = "curl_easy_init failed";
+  }
+
+  if (f != nullptr) {
+    fclose(f);
+  }
+  if (!err.empty()) {
+    std::lock_guard lk(error_mutex_);
+    error_ = err;
+  }
+  done_ = true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Native upload engine for athenad. Drives a libcurl PUT on its own thread so
+// the file bytes move straight from the page cache through libcurl's buffers
+// to the socket, with no interpreter copies; python only polls progress and
+// flips the abort flag. One engine per transfer, parallelism comes from
+// athenad's upload handler threads.
+class UploadEngine {
+ public:
+  // tos is the IP_TOS byte for the upload socket
+  UploadEngine(const std::string &url, const std::vector<std::string> &headers, int tos);
+  ~UploadEngine();
+
+  // set exactly one body before start(): a file on disk, or an in-memory
+  // buffer (e.g. a log compressed on the fly)
+  void set_file(const std::string &path);
+  void set_body(std::string body);
+
+  void start();
+  void abort() { abort_ = true; }
+  void wait();  // blocks until the transfer thread exits
+
+  bool done() const { return done_; }
+  int64_t content_length() const { return content_length_; }
+  int64_t bytes_sent() const { return bytes_sent_; }
+  // valid once done: HTTP status, or 0 with a non-empty error on transport failure
+  long status_code() const { return status_code_; }
+  bool aborted() const { return was_aborted_; }
+  std::string error() const;
+
+ private:
+  void run();
+  static int progress_callback(void *self, int64_t dltotal, int64_t dlnow, int64_t ultotal, int64_t ulnow);
+  static size_t body_read_callback(char *buffer, size_t size, size_t nitems, void *self);
+
+  std::string url_;
+  std::string path_;
+  std::string body_;
+  size_t body_offset_ = 0;
+  std::vector<std::string> headers_;
+  int tos_;
+  int64_t content_length_ = 0;
+
+  std::thread thread_;
+  std::atomic<bool> abort_{false};
+  std::atomic<bool> done_{false};
+  std::atomic<bool> was_aborted_{false};
+  std::atomic<int64_t> bytes_sent_{0};
+  std::atomic<long> status_code_{0};
+  mutable std::mutex error_mutex_;
+  std::string error_;
+};
@@ -0,0 +1,75 @@
+# distutils: language = c++
+# cython: language_level = 3
+from libc.stdint cimport int64_t
+from libcpp cimport bool
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+cdef extern from "system/athena/upload_engine.h":
+  cdef cppclass UploadEngine:
+    UploadEngine(const string &url, const vector[string] &headers, int tos) except +
+    void set_file(const string &path)
+    void set_body(string body)
+    void start()
+    void abort()
+    void wait() nogil
+    bool done()
+    int64_t content_length()
+    int64_t bytes_sent()
+    long status_code()
+    bool aborted()
+    string error()
+
+
+cdef class NativeUpload:
+  """One PUT transfer on its own native thread; python polls progress and can abort."""
+  cdef UploadEngine *engine
+
+  def __cinit__(self, url, headers, int tos):
+    cdef vector[string] c_headers
+    for h in headers:
+      c_headers.push_back(h.encode())
+    self.engine = new UploadEngine(url.encode(), c_headers, tos)
+
+  def __dealloc__(self):
+    del self.engine
+
+  def set_file(self, path):
+    self.engine.set_file(path.encode())
+
+  def set_body(self, bytes body):
+    self.engine.set_body(body)
+
+  def start(self):
+    self.engine.start()
+
+  def abort(self):
+    self.engine.abort()
+
+  def wait(self):
+    with nogil:
+      self.engine.wait()
+
+  @property
+  def done(self):
+    return self.engine.done()
+
+  @property
+  def content_length(self):
+    return self.engine.content_length()
+
+  @property
+  def bytes_sent(self):
+    return self.engine.bytes_sent()
+
+  @property
+  def status_code(self):
+    return self.engine.status_code()
+
+  @property
+  def aborted(self):
+    return self.engine.aborted()
+
+  @property
+  def error(self):
+    return self.engine.error().decode()
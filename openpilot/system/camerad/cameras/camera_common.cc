@@ -1,10 +1,16 @@
 #include "system/camerad/cameras/camera_common.h"
 
 #include <cassert>
+#include <cstring>
 #include <string>
 
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "common/swaglog.h"
 #include "system/camerad/cameras/spectra.h"
+#include "system/loggerd/encoder/jpeg_encoder.h"
 
 
 void CameraBuf::init(SpectraCamera *cam, VisionIpcServer * v, int frame_cnt, VisionStreamType type) {
@@ -25,8 +31,8 @@ void CameraBuf::init(SpectraCamera *cam, VisionIpcServer * v, int frame_cnt, Vis
     LOGD("allocated %d buffers", frame_buf_count);
   }
 
-  vipc_server->create_buffers_with_sizes(stream_type, VIPC_BUFFER_COUNT, out_img_width, out_img_height, cam->yuv_size, cam->stride, cam->uv_offset);
-  LOGD("created %d YUV vipc buffers with size %dx%d", VIPC_BUFFER_COUNT, cam->stride, cam->y_height);
+  vipc_server->create_buffers_with_sizes(stream_type, frame_buf_count, out_img_width, out_img_height, cam->yuv_size, cam->stride, cam->uv_offset);
+  LOGD("created %d YUV vipc buffers with size %dx%d", frame_buf_count, cam->stride, cam->y_height);
 }
 
 CameraBuf::~CameraBuf() {
@@ -53,6 +59,64 @@ void CameraBuf::sendFrameToVipc() {
   };
   cur_yuv_buf->set_frame_id(cur_frame_data.frame_id);
   vipc_server->send(cur_yuv_buf, &extra);
+
+  latest_eof = cur_frame_data.timestamp_eof;
+  latest_buf = cur_yuv_buf;
+}
+
+// *** SnapshotServer ***
+
+SnapshotServer::~SnapshotServer() {
+  exit_req = true;
+  if (thread.joinable()) thread.join();
+}
+
+void SnapshotServer::registerCamera(const std::string &name, const CameraBuf *buf) {
+  cams[name] = Cam{.buf = buf};
+}
+
+void SnapshotServer::start() {
+  thread = std::thread(&SnapshotServer::run, this);
+}
+
+void SnapshotServer::run() {
+  util::set_thread_name("snapshot");
+
+  SubMaster sm({"cameraSnapshotRequest"});
+  while (!exit_req) {
+    sm.update(100);
+    if (!sm.updated("cameraSnapshotRequest")) continue;
+
+    std::string camera = sm["cameraSnapshotRequest"].getCameraSnapshotRequest().getCamera();
+    auto it = cams.find(camera);
+    if (it == cams.end()) {
+      LOGE("snapshot request for unknown camera %s", camera.c_str());
+      continue;
+    }
+    // one retry in case the ISP lapped the ring mid-copy
+    for (int attempt = 0; attempt < 2 && !snapshot(it->second); ++attempt);
+  }
+}
+
+bool SnapshotServer::snapshot(Cam &cam) {
+  VisionBuf *buf = cam.buf->latest_buf;
+  if (buf == nullptr) return true;  // nothing published yet
+
+  if (!cam.encoder) {
+    // full-resolution JpegEncoder; its pool and libavcodec context only cost
+    // memory once a snapshot has actually been requested for this camera
+    cam.encoder = std::make_unique<JpegEncoder>("cameraSnapshot", buf->width, buf->height);
+  }
+
+  const uint64_t frame_id = buf->get_frame_id();
+  VisionIpcBufExtra extra = {(uint32_t)frame_id, 0, cam.buf->latest_eof};
+  cam.encoder->pushThumbnail(buf, extra);
+
+  if (buf->get_frame_id() != frame_id) {
+    LOGW("snapshot of frame %lu raced with buffer reuse, retrying", frame_id);
+    return false;
+  }
+  return true;
 }
 
 // common functions
@@ -68,12 +132,41 @@ kj::Array<uint8_t> get_raw_frame_image(const CameraBuf *b) {
   return kj::mv(frame_image);
 }
 
-float calculate_exposure_value(const CameraBuf *b, Rect ae_xywh, int x_skip, int y_skip) {
+float calculate_exposure_value(const CameraBuf *b, Rect ae_xywh, int x_skip, int y_skip, uint32_t *hist) {
   int lum_med;
   uint32_t lum_binning[256] = {0};
   const uint8_t *pix_ptr = b->cur_yuv_buf->y;
 
   unsigned int lum_total = 0;
+#if defined(__ARM_NEON)
+  // Deinterleaving loads compact each sampled row into a small stack buffer,
+  // so the skip grid walks memory sequentially instead of paying a strided
+  // load per sample, and the histogram update runs out of L1.
+  if ((x_skip == 2 || x_skip == 4) && ae_xywh.w / x_skip <= 4096) {
+    uint8_t samples[4096];
+    for (int y = ae_xywh.y; y < ae_xywh.y + ae_xywh.h; y += y_skip) {
+      const uint8_t *row = pix_ptr + (y * b->out_img_width) + ae_xywh.x;
+      __builtin_prefetch(row + y_skip * b->out_img_width);
+      int n = 0, x = 0;
+      if (x_skip == 2) {
+        for (; x + 32 <= ae_xywh.w; x += 32, n += 16) {
+          vst1q_u8(samples + n, vld2q_u8(row + x).val[0]);
+        }
+      } else {
+        for (; x + 64 <= ae_xywh.w; x += 64, n += 16) {
+          vst1q_u8(samples + n, vld4q_u8(row + x).val[0]);
+        }
+      }
+      for (; x < ae_xywh.w; x += x_skip) {
+        samples[n++] = row[x];
+      }
+      for (int i = 0; i < n; i++) {
+        lum_binning[samples[i]]++;
+      }
+      lum_total += n;
+    }
+  } else
+#endif
   for (int y = ae_xywh.y; y < ae_xywh.y + ae_xywh.h; y += y_skip) {
     for (int x = ae_xywh.x; x < ae_xywh.x + ae_xywh.w; x += x_skip) {
       uint8_t lum = pix_ptr[(y * b->out_img_width) + x];
@@ -82,6 +175,10 @@ float calculate_exposure_value(const CameraBuf *b, Rect ae_xywh, int x_skip, int
     }
   }
 
+  if (hist != nullptr) {
+    memcpy(hist, lum_binning, sizeof(lum_binning));
+  }
+
   // Find mean lumimance value
   unsigned int lum_cur = 0;
   for (lum_med = 255; lum_med >= 0; lum_med--) {
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <map>
 #include <memory>
+#include <string>
+#include <thread>
 
 #include "openpilot/cereal/messaging/messaging.h"
 #include "msgq/visionipc/visionipc_server.h"
@@ -34,13 +38,47 @@ public:
   std::unique_ptr<VisionBuf[]> camera_bufs_raw;
   uint32_t out_img_width, out_img_height;
 
+  // last frame handed to vipc, for SnapshotServer; the buffer stays mapped
+  // and valid until the ISP laps the ring (VIPC_BUFFER_COUNT frames later)
+  std::atomic<VisionBuf *> latest_buf = nullptr;
+  std::atomic<uint64_t> latest_eof = 0;
+
   CameraBuf() = default;
   ~CameraBuf();
   void init(SpectraCamera *cam, VisionIpcServer * v, int frame_cnt, VisionStreamType type);
   void sendFrameToVipc();
 };
 
+class JpegEncoder;
+
+// On-demand stills: a cameraSnapshotRequest msg names a camera state service
+// and the most recently published frame comes back as a cameraSnapshot JPEG.
+// The worker references the dma-buf backed vipc buffer directly -- no client
+// connection, so no consumer slot is held and the frame loop never sees the
+// request -- and verifies the frame id after the copy, retrying if the ISP
+// lapped the ring mid-read.
+class SnapshotServer {
+public:
+  ~SnapshotServer();
+  void registerCamera(const std::string &name, const CameraBuf *buf);
+  void start();
+
+private:
+  struct Cam {
+    const CameraBuf *buf;
+    std::unique_ptr<JpegEncoder> encoder;  // full resolution, created on first request
+  };
+
+  void run();
+  bool snapshot(Cam &cam);
+
+  std::map<std::string, Cam> cams;
+  std::thread thread;
+  std::atomic<bool> exit_req = false;
+};
+
 void camerad_thread();
 kj::Array<uint8_t> get_raw_frame_image(const CameraBuf *b);
-float calculate_exposure_value(const CameraBuf *b, Rect ae_xywh, int x_skip, int y_skip);
+// hist, when non-null, receives the full 256-bin luminance histogram
+float calculate_exposure_value(const CameraBuf *b, Rect ae_xywh, int x_skip, int y_skip, uint32_t *hist = nullptr);
 int open_v4l_by_name_and_index(const char name[], int index = 0, int flags = O_RDWR | O_NONBLOCK);
@@ -9,7 +9,9 @@
 #include <cerrno>
 #include <cmath>
 #include <cstring>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "common/params.h"
@@ -22,6 +24,7 @@ ExitHandler do_exit;
 const bool env_debug_frames = getenv("DEBUG_FRAMES") != nullptr;
 const bool env_log_raw_frames = getenv("LOG_RAW_FRAMES") != nullptr;
 const bool env_ctrl_exp_from_params = getenv("CTRL_EXP_FROM_PARAMS") != nullptr;
+const bool env_export_ae_hist = getenv("EXPORT_AE_HISTOGRAM") != nullptr;
 
 
 class CameraState {
@@ -39,18 +42,29 @@ public:
   int new_exp_t = 0;
 
   Rect ae_xywh = {};
+  uint32_t lum_binning[256] = {};
   float measured_grey_fraction = 0;
   float target_grey_fraction = 0.125;
 
   float fl_pix = 0;
   std::unique_ptr<PubMaster> pm;
 
+  // AE decoupled from the publish path: sendState just queues the frame id and
+  // a per-camera worker does the histogram sampling and optimizer, with the
+  // i2c update going through the existing async path. the worker keeps default
+  // scheduling, so it yields to the frame threads.
+  SafeQueue<int64_t> ae_q;  // frame ids; -1 stops the worker
+  std::thread ae_thread;
+  std::mutex ae_state_lock;  // guards exposure state shared between the worker and sendState
+
   CameraState(SpectraMaster *master, const CameraConfig &config) : camera(master, config) {};
   ~CameraState();
   void init(VisionIpcServer *v);
+  void run_ae();
   void update_exposure_score(float desired_ev, int exp_t, int exp_g_idx, float exp_gain);
-  void set_camera_exposure(float grey_frac);
+  void set_camera_exposure(float grey_frac, uint32_t frame_id);
   void set_exposure_rect();
+  void set_ae_roi(const Rect &roi);
   void sendState();
 
   float get_gain_factor() const {
@@ -71,9 +85,38 @@ void CameraState::init(VisionIpcServer *v) {
   cur_ev[0] = cur_ev[1] = cur_ev[2] = get_gain_factor() * camera.sensor->sensor_analog_gains[gain_idx] * exposure_time;
 
   pm = std::make_unique<PubMaster>(std::vector{camera.cc.publish_name});
+  ae_thread = std::thread(&CameraState::run_ae, this);
 }
 
-CameraState::~CameraState() {}
+CameraState::~CameraState() {
+  if (ae_thread.joinable()) {
+    ae_q.push(-1);
+    ae_thread.join();
+  }
+}
+
+void CameraState::run_ae() {
+  util::set_thread_name(("ae-" + std::string(camera.cc.publish_name)).c_str());
+
+  while (true) {
+    int64_t frame_id = ae_q.pop();
+    // coalesce a backlog: only the newest frame matters for exposure
+    int64_t next;
+    while (ae_q.try_pop(next)) frame_id = next;
+    if (frame_id < 0) break;
+
+    // cur_yuv_buf is the most recently published frame. it can advance to a
+    // newer one while we sample, which is fine: AE always wants the newest.
+    uint32_t hist[256];
+    float grey_frac = calculate_exposure_value(&camera.buf, ae_xywh, 2, camera.cc.stream_type != VISION_STREAM_DRIVER ? 2 : 4,
+                                               env_export_ae_hist ? hist : nullptr);
+    if (env_export_ae_hist) {
+      std::lock_guard lk(ae_state_lock);
+      memcpy(lum_binning, hist, sizeof(lum_binning));
+    }
+    set_camera_exposure(grey_frac, (uint32_t)frame_id);
+  }
+}
 
 void CameraState::set_exposure_rect() {
   // set areas for each camera, shouldn't be changed
@@ -96,12 +139,20 @@ void CameraState::set_exposure_rect() {
   Rect xywh_ref = ae_target.first;
   float fl_ref = ae_target.second;
 
-  ae_xywh = (Rect){
+  set_ae_roi((Rect){
     std::max(0, (int)camera.buf.out_img_width / 2 - (int)(fl_pix / fl_ref * xywh_ref.w / 2)),
     std::max(0, (int)camera.buf.out_img_height / 2 - (int)(fl_pix / fl_ref * (h_ref / 2 - xywh_ref.y))),
     std::min((int)(fl_pix / fl_ref * xywh_ref.w), (int)camera.buf.out_img_width / 2 + (int)(fl_pix / fl_ref * xywh_ref.w / 2)),
     std::min((int)(fl_pix / fl_ref * xywh_ref.h), (int)camera.buf.out_img_height / 2 + (int)(fl_pix / fl_ref * (h_ref / 2 - xywh_ref.y)))
-  };
+  });
+}
+
+void CameraState::set_ae_roi(const Rect &roi) {
+  // clamp to the output image so the sampling kernel can assume in-bounds rows
+  ae_xywh.x = std::clamp(roi.x, 0, (int)camera.buf.out_img_width - 1);
+  ae_xywh.y = std::clamp(roi.y, 0, (int)camera.buf.out_img_height - 1);
+  ae_xywh.w = std::clamp(roi.w, 1, (int)camera.buf.out_img_width - ae_xywh.x);
+  ae_xywh.h = std::clamp(roi.h, 1, (int)camera.buf.out_img_height - ae_xywh.y);
 }
 
 void CameraState::update_exposure_score(float desired_ev, int exp_t, int exp_g_idx, float exp_gain) {
@@ -113,8 +164,9 @@ void CameraState::update_exposure_score(float desired_ev, int exp_t, int exp_g_i
   }
 }
 
-void CameraState::set_camera_exposure(float grey_frac) {
+void CameraState::set_camera_exposure(float grey_frac, uint32_t frame_id) {
   if (!camera.enabled) return;
+  std::lock_guard lk(ae_state_lock);
   std::vector<double> target_grey_minimums = {0.1, 0.1, 0.125}; // wide, road, driver
 
   const float dt = 0.05;
@@ -132,7 +184,7 @@ void CameraState::set_camera_exposure(float grey_frac) {
 
   const auto &sensor = camera.sensor;
   // Offset idx by one to not get stuck in self loop
-  const float cur_ev_ = cur_ev[(camera.buf.cur_frame_data.frame_id - 1) % 3] * sensor->ev_scale;
+  const float cur_ev_ = cur_ev[(frame_id - 1) % 3] * sensor->ev_scale;
 
   // Scale target grey between min and 0.4 depending on lighting conditions
   float new_target_grey = std::clamp(0.4 - 0.3 * log2(1.0 + sensor->target_grey_factor*cur_ev_) / log2(6000.0), target_grey_minimums[camera.cc.camera_num], 0.4);
@@ -203,16 +255,17 @@ void CameraState::set_camera_exposure(float grey_frac) {
   dc_gain_enabled = enable_dc_gain;
 
   float gain = analog_gain_frac * get_gain_factor();
-  cur_ev[camera.buf.cur_frame_data.frame_id % 3] = exposure_time * gain;
+  cur_ev[frame_id % 3] = exposure_time * gain;
 
   // LOGE("ae - camera %d, cur_t %.5f, sof %.5f, dt %.5f", camera.cc.camera_num, 1e-9 * nanos_since_boot(), 1e-9 * camera.buf.cur_frame_data.timestamp_sof, 1e-9 * (nanos_since_boot() - camera.buf.cur_frame_data.timestamp_sof));
 
   auto exp_reg_array = sensor->getExposureRegisters(exposure_time, new_exp_g, dc_gain_enabled);
-  camera.sensors_i2c(exp_reg_array.data(), exp_reg_array.size(), CAM_SENSOR_PACKET_OPCODE_SENSOR_CONFIG, camera.sensor->data_word);
+  camera.sensors_i2c_async(exp_reg_array.data(), exp_reg_array.size(), CAM_SENSOR_PACKET_OPCODE_SENSOR_CONFIG, camera.sensor->data_word);
 }
 
 void CameraState::sendState() {
   camera.buf.sendFrameToVipc();
+  camera.markFramePublished();
 
   MessageBuilder msg;
   auto framed = (msg.initEvent().*camera.cc.init_camera_state)();
@@ -221,16 +274,29 @@ void CameraState::sendState() {
   framed.setRequestId(meta.request_id);
   framed.setTimestampEof(meta.timestamp_eof);
   framed.setTimestampSof(meta.timestamp_sof);
-  framed.setIntegLines(exposure_time);
-  framed.setGain(analog_gain_frac * get_gain_factor());
-  framed.setHighConversionGain(dc_gain_enabled);
-  framed.setMeasuredGreyFraction(measured_grey_fraction);
-  framed.setTargetGreyFraction(target_grey_fraction);
   framed.setProcessingTime(meta.processing_time);
 
-  const float ev = cur_ev[meta.frame_id % 3];
-  const float perc = util::map_val(ev, camera.sensor->min_ev, camera.sensor->max_ev, 0.0f, 100.0f);
-  framed.setExposureValPercent(perc);
+  {
+    std::lock_guard lk(ae_state_lock);
+    framed.setIntegLines(exposure_time);
+    framed.setGain(analog_gain_frac * get_gain_factor());
+    framed.setHighConversionGain(dc_gain_enabled);
+    framed.setMeasuredGreyFraction(measured_grey_fraction);
+    framed.setTargetGreyFraction(target_grey_fraction);
+
+    const float ev = cur_ev[meta.frame_id % 3];
+    const float perc = util::map_val(ev, camera.sensor->min_ev, camera.sensor->max_ev, 0.0f, 100.0f);
+    framed.setExposureValPercent(perc);
+
+    // export the AE sample histogram for offboard exposure experiments.
+    // the worker fills this, so it's one frame stale here.
+    if (env_export_ae_hist) {
+      auto hist = framed.initAeHistogram(256);
+      for (int i = 0; i < 256; i++) {
+        hist.set(i, lum_binning[i]);
+      }
+    }
+  }
   framed.setSensor(camera.sensor->image_sensor);
 
   // Log raw frames for road camera
@@ -238,10 +304,11 @@ void CameraState::sendState() {
     framed.setImage(get_raw_frame_image(&camera.buf));
   }
 
-  set_camera_exposure(calculate_exposure_value(&camera.buf, ae_xywh, 2, camera.cc.stream_type != VISION_STREAM_DRIVER ? 2 : 4));
-
   // Send the message
   pm->send(camera.cc.publish_name, msg);
+
+  // hand the frame off to the AE worker; the publish path stays constant cost
+  ae_q.push(meta.frame_id);
 }
 
 void camerad_thread() {
@@ -254,22 +321,62 @@ void camerad_thread() {
   m.init();
 
   // *** per-cam init ***
+  // sensor probe, ISP config, and buffer registration are independent per
+  // camera, so bring all three up in parallel and join before streaming
   std::vector<std::unique_ptr<CameraState>> cams;
   for (const auto &config : ALL_CAMERA_CONFIGS) {
-    auto cam = std::make_unique<CameraState>(&m, config);
-    cam->init(&v);
-    cams.emplace_back(std::move(cam));
+    cams.emplace_back(std::make_unique<CameraState>(&m, config));
+  }
+  std::vector<std::thread> init_threads;
+  for (auto &cam : cams) {
+    init_threads.emplace_back([&v, &cam] { cam->init(&v); });
   }
+  for (auto &t : init_threads) t.join();
 
   v.start_listener();
 
+  // on-demand snapshots, served off-thread from the published buffers
+  SnapshotServer snapshot_server;
+  for (auto &cam : cams) {
+    snapshot_server.registerCamera(cam->camera.cc.publish_name, &cam->camera.buf);
+  }
+  snapshot_server.start();
+
+  // warm the packet pools observed during init; the frame loop should do
+  // zero runtime dma-buf allocations from here on
+  m.mem_mgr.seal(4);
+
   // start devices
   LOG("-- Starting devices");
   for (auto &cam : cams) cam->camera.sensors_start();
 
   // poll events
   LOG("-- Dequeueing Video events");
+  PubMaster timings_pm({"cameraTimings"});
+  uint64_t last_timings_ns = 0;
   while (!do_exit) {
+    // export the frame trace rings at 1Hz for frame drop forensics
+    if (nanos_since_boot() - last_timings_ns > 1000000000ULL) {
+      last_timings_ns = nanos_since_boot();
+      MessageBuilder msg;
+      auto cl = msg.initEvent().initCameraTimings().initCameras(cams.size());
+      for (int i = 0; i < cams.size(); i++) {
+        auto &cam = cams[i]->camera;
+        cl[i].setCameraId(cam.cc.camera_num);
+        int n = std::min<uint64_t>(cam.frame_trace_idx, SpectraCamera::FRAME_TRACE_LEN);
+        auto fl = cl[i].initFrames(n);
+        for (int j = 0; j < n; j++) {
+          const auto &t = cam.frame_traces[j];
+          fl[j].setFrameIdRaw(t.frame_id_raw);
+          fl[j].setRequestId(t.request_id);
+          fl[j].setTimestampSof(t.timestamp_sof);
+          fl[j].setTimestampIfeDone(t.timestamp_ife_done);
+          fl[j].setTimestampBpsDone(t.timestamp_bps_done);
+          fl[j].setTimestampPublish(t.timestamp_publish);
+        }
+      }
+      timings_pm.send("cameraTimings", msg);
+    }
     struct pollfd fds[1] = {{.fd = m.video0_fd, .events = POLLPRI}};
     int ret = poll(fds, std::size(fds), 1000);
     if (ret < 0) {
@@ -135,13 +135,19 @@ static cam_cmd_power *power_set_wait(cam_cmd_power *power, int16_t delay_ms) {
 // *** MemoryManager ***
 
 void *MemoryManager::alloc_buf(int size, uint32_t *handle) {
+  size = ALIGNED_SIZE(size, SIZE_CLASS);
   void *ptr;
+  std::unique_lock lk(lock);
   auto &cache = cached_allocations[size];
   if (!cache.empty()) {
     ptr = cache.front();
     cache.pop();
     *handle = handle_lookup[ptr];
   } else {
+    if (sealed) {
+      pool_miss_count++;
+      LOGW("MemoryManager pool miss, runtime alloc of size %d", size);
+    }
     ptr = alloc_w_mmu_hdl(video0_fd, size, handle);
     handle_lookup[ptr] = *handle;
     size_lookup[ptr] = size;
@@ -151,9 +157,27 @@ void *MemoryManager::alloc_buf(int size, uint32_t *handle) {
 }
 
 void MemoryManager::free(void *ptr) {
+  std::unique_lock lk(lock);
   cached_allocations[size_lookup[ptr]].push(ptr);
 }
 
+void MemoryManager::seal(int count_per_class) {
+  // everything allocated during init has been returned by now, so the pool
+  // keys cover exactly the size classes the frame loop will ask for
+  std::unique_lock lk(lock);
+  for (auto &[size, cache] : cached_allocations) {
+    while ((int)cache.size() < count_per_class) {
+      uint32_t handle;
+      void *ptr = alloc_w_mmu_hdl(video0_fd, size, &handle);
+      handle_lookup[ptr] = handle;
+      size_lookup[ptr] = size;
+      cache.push(ptr);
+    }
+    LOGD("sealed pool of %d x %d bytes", count_per_class, size);
+  }
+  sealed = true;
+}
+
 MemoryManager::~MemoryManager() {
   for (auto& x : cached_allocations) {
     while (!x.second.empty()) {
@@ -227,6 +251,23 @@ void SpectraMaster::init() {
   LOGD("req mgr subscribe: %d", ret);
 
   mem_mgr.init(video0_fd);
+
+  i2c_thread = std::thread([this] {
+    util::set_thread_name("camerad_i2c");
+    while (true) {
+      I2cRequest req = i2c_q.pop();
+      if (req.cam == nullptr) break;
+      req.cam->sensors_i2c(req.payload.data(), req.payload.size(), req.op_code, req.data_word);
+      req.cam->i2c_inflight--;
+    }
+  });
+}
+
+SpectraMaster::~SpectraMaster() {
+  if (i2c_thread.joinable()) {
+    i2c_q.push({});
+    i2c_thread.join();
+  }
 }
 
 // *** SpectraCamera ***
@@ -235,7 +276,10 @@ SpectraCamera::SpectraCamera(SpectraMaster *master, const CameraConfig &config)
   : m(master),
     enabled(config.enabled),
     cc(config) {
-  ife_buf_depth = VIPC_BUFFER_COUNT;
+  // extra depth gives slow experimental VisionIPC consumers more slack
+  // before their frames are overwritten, without touching the depth
+  // encoderd and modeld are tuned for
+  ife_buf_depth = VIPC_BUFFER_COUNT + atoi(util::getenv("CAMERA_BUF_HEADROOM", "0").c_str());
   assert(ife_buf_depth < MAX_IFE_BUFS);
 }
 
@@ -324,8 +368,25 @@ void SpectraCamera::sensors_poke(int request_id) {
   }
 }
 
-void SpectraCamera::sensors_i2c(const struct i2c_random_wr_payload* dat, int len, int op_code, bool data_word) {
+void SpectraCamera::sensors_i2c(const struct i2c_random_wr_payload* dat, int len, int op_code, bool data_word, bool delta) {
   // LOGD("sensors_i2c: %d", len);
+  std::vector<struct i2c_random_wr_payload> changed;
+  if (delta) {
+    for (int i = 0; i < len; i++) {
+      auto it = sensor_reg_shadow.find(dat[i].reg_addr);
+      if (it == sensor_reg_shadow.end() || it->second != dat[i].reg_val) {
+        changed.push_back(dat[i]);
+      }
+    }
+    if (changed.empty()) return;
+    LOGD("sensor %d delta write: %zu of %d registers", cc.camera_num, changed.size(), len);
+    dat = changed.data();
+    len = changed.size();
+  }
+  for (int i = 0; i < len; i++) {
+    sensor_reg_shadow[dat[i].reg_addr] = dat[i].reg_val;
+  }
+
   uint32_t cam_packet_handle = 0;
   int size = sizeof(struct cam_packet)+sizeof(struct cam_cmd_buf_desc)*1;
   auto pkt = m->mem_mgr.alloc<struct cam_packet>(size, &cam_packet_handle);
@@ -354,6 +415,11 @@ void SpectraCamera::sensors_i2c(const struct i2c_random_wr_payload* dat, int len
   }
 }
 
+void SpectraCamera::sensors_i2c_async(const struct i2c_random_wr_payload* dat, int len, int op_code, bool data_word) {
+  i2c_inflight++;
+  m->i2c_q.push({this, {dat, dat + len}, op_code, data_word});
+}
+
 int SpectraCamera::sensors_init() {
   uint32_t cam_packet_handle = 0;
   int size = sizeof(struct cam_packet)+sizeof(struct cam_cmd_buf_desc)*2;
@@ -544,61 +610,24 @@ void SpectraCamera::config_bps(int idx, int request_id) {
     pa->unused = 0;
     pa->base = 0; // this gets patched
 
-    int cdm_len = 0;
-
-    if (bps_lin_reg.size() == 0) {
-      // set first knee pt to do BLC
-      uint32_t new_knee[8];
-      new_knee[0] = sensor->black_level << (14 - sensor->bits_per_pixel);
-      for (int i = 0; i < 7; i++) {
-        uint32_t pts = sensor->linearization_pts[i / 2];
-        new_knee[i + 1] = (i % 2 == 0) ? (pts >> 16) : (pts & 0xffff);
-      }
-      for (int i = 0; i < 4; i++) {
-        bps_lin_reg.push_back((new_knee[2*i + 1] << 16) | new_knee[2*i]);
-      }
+    // a program staged in the inactive bank becomes active here, so the
+    // switch lands exactly on a request boundary
+    if (bps_cdm_staged) {
+      bps_cdm_bank ^= 1;
+      bps_cdm_len = bps_cdm_staged_len;
+      bps_cdm_patches = std::move(bps_cdm_staged_patches);
+      bps_cdm_staged = false;
     }
 
-    if (bps_ccm_reg.size() == 0) {
-      for (int i = 0; i < 3; i++) {
-        bps_ccm_reg.push_back(sensor->color_correct_matrix[i] | (sensor->color_correct_matrix[i+3] << 0x10));
-        bps_ccm_reg.push_back(sensor->color_correct_matrix[i+6]);
-      }
-    }
-
-    // white balance
-    cdm_len += write_cont((unsigned char *)bps_cdm_program_array.ptr + cdm_len, 0x2868, {
-      0x04000400,
-      0x00000400,
-      0x00000000,
-      0x00000000,
-    });
-    // debayer
-    cdm_len += write_cont((unsigned char *)bps_cdm_program_array.ptr + cdm_len, 0x2878, {
-      0x00000080,
-      0x00800066,
-    });
-    // linearization
-    cdm_len += write_cont((unsigned char *)bps_cdm_program_array.ptr + cdm_len, 0x1868, bps_lin_reg);
-    cdm_len += write_cont((unsigned char *)bps_cdm_program_array.ptr + cdm_len, 0x1878, bps_lin_reg);
-    cdm_len += write_cont((unsigned char *)bps_cdm_program_array.ptr + cdm_len, 0x1888, bps_lin_reg);
-    cdm_len += write_cont((unsigned char *)bps_cdm_program_array.ptr + cdm_len, 0x1898, bps_lin_reg);
-    uint64_t addr;
-    cdm_len += write_dmi((unsigned char *)bps_cdm_program_array.ptr + cdm_len, &addr, sensor->linearization_lut.size()*sizeof(uint32_t), 0x1808, 1, CAM_CDM_CMD_DMI);
-    patches.push_back(addr - (uint64_t)bps_cdm_program_array.ptr);
-
-    // color correction
-    cdm_len += write_cont((unsigned char *)bps_cdm_program_array.ptr + cdm_len, 0x2e68, bps_ccm_reg);
-
-    // gamma
-    for (uint8_t ch = 1; ch <= 3; ch++) {
-      cdm_len += write_dmi((unsigned char *)bps_cdm_program_array.ptr + cdm_len, &addr, sensor->gamma_lut_rgb.size()*sizeof(uint32_t), 0x3208, ch, CAM_CDM_CMD_DMI);
-      patches.push_back(addr - (uint64_t)bps_cdm_program_array.ptr);
+    // the CDM program is static frame to frame: compile it into the active
+    // bank of bps_cdm_program_array once and remember its patch slots, so
+    // later requests just reference the snapshot
+    if (bps_cdm_len == 0) {
+      bps_cdm_len = buildBpsCdm((unsigned char *)bps_cdm_program_array.ptr, bps_cdm_patches);
     }
+    patches = bps_cdm_patches;
 
-    cdm_len += build_common_ife_bps((unsigned char *)bps_cdm_program_array.ptr + cdm_len, cc, sensor.get(), patches, false);
-
-    pa->length = cdm_len - 1;
+    pa->length = bps_cdm_len - 1;
 
     // *** second command ***
     // parsed by cam_icp_packet_generic_blob_handler
@@ -735,7 +764,7 @@ void SpectraCamera::config_bps(int idx, int request_id) {
     // rest of buffers
     add_patch(pkt.get(), bps_cmd.handle, buf_desc[0].offset + offsetof(bps_tmp, settings_addr), bps_iq.handle, 0);
     add_patch(pkt.get(), bps_cmd.handle, buf_desc[0].offset + offsetof(bps_tmp, cdm_addr2), bps_cmd.handle, sizeof(bps_tmp));
-    add_patch(pkt.get(), bps_cmd.handle, buf_desc[0].offset + 0xc8, bps_cdm_program_array.handle, 0);
+    add_patch(pkt.get(), bps_cmd.handle, buf_desc[0].offset + 0xc8, bps_cdm_program_array.handle, bps_cdm_program_array.aligned_size()*bps_cdm_bank);
     add_patch(pkt.get(), bps_cmd.handle, buf_desc[0].offset + offsetof(bps_tmp, striping_addr), bps_striping.handle, 0);
     add_patch(pkt.get(), bps_cmd.handle, buf_desc[0].offset + offsetof(bps_tmp, cdm_addr), bps_cdm_striping_bl.handle, 0);
   }
@@ -744,6 +773,85 @@ void SpectraCamera::config_bps(int idx, int request_id) {
   assert(ret == 0);
 }
 
+int SpectraCamera::buildBpsCdm(unsigned char *dst, std::vector<uint32_t> &patches) {
+  int cdm_len = 0;
+
+  if (bps_lin_reg.size() == 0) {
+    // set first knee pt to do BLC
+    uint32_t new_knee[8];
+    new_knee[0] = sensor->black_level << (14 - sensor->bits_per_pixel);
+    for (int i = 0; i < 7; i++) {
+      uint32_t pts = sensor->linearization_pts[i / 2];
+      new_knee[i + 1] = (i % 2 == 0) ? (pts >> 16) : (pts & 0xffff);
+    }
+    for (int i = 0; i < 4; i++) {
+      bps_lin_reg.push_back((new_knee[2*i + 1] << 16) | new_knee[2*i]);
+    }
+  }
+
+  if (bps_ccm_reg.size() == 0) {
+    for (int i = 0; i < 3; i++) {
+      bps_ccm_reg.push_back(sensor->color_correct_matrix[i] | (sensor->color_correct_matrix[i+3] << 0x10));
+      bps_ccm_reg.push_back(sensor->color_correct_matrix[i+6]);
+    }
+  }
+
+  // white balance
+  cdm_len += write_cont(dst + cdm_len, 0x2868, {
+    0x04000400,
+    0x00000400,
+    0x00000000,
+    0x00000000,
+  });
+  // debayer
+  cdm_len += write_cont(dst + cdm_len, 0x2878, {
+    0x00000080,
+    0x00800066,
+  });
+  // linearization
+  cdm_len += write_cont(dst + cdm_len, 0x1868, bps_lin_reg);
+  cdm_len += write_cont(dst + cdm_len, 0x1878, bps_lin_reg);
+  cdm_len += write_cont(dst + cdm_len, 0x1888, bps_lin_reg);
+  cdm_len += write_cont(dst + cdm_len, 0x1898, bps_lin_reg);
+  uint64_t addr;
+  cdm_len += write_dmi(dst + cdm_len, &addr, sensor->linearization_lut.size()*sizeof(uint32_t), 0x1808, 1, CAM_CDM_CMD_DMI);
+  patches.push_back(addr - (uint64_t)bps_cdm_program_array.ptr);
+
+  // color correction
+  cdm_len += write_cont(dst + cdm_len, 0x2e68, bps_ccm_reg);
+
+  // gamma
+  for (uint8_t ch = 1; ch <= 3; ch++) {
+    cdm_len += write_dmi(dst + cdm_len, &addr, sensor->gamma_lut_rgb.size()*sizeof(uint32_t), 0x3208, ch, CAM_CDM_CMD_DMI);
+    patches.push_back(addr - (uint64_t)bps_cdm_program_array.ptr);
+  }
+
+  cdm_len += build_common_ife_bps(dst + cdm_len, cc, sensor.get(), patches, false);
+
+  return cdm_len;
+}
+
+void SpectraCamera::stageProcessingConfig(const std::vector<uint32_t> &lin_reg, const std::vector<uint32_t> &ccm_reg) {
+  if (!lin_reg.empty()) bps_lin_reg = lin_reg;
+  if (!ccm_reg.empty()) bps_ccm_reg = ccm_reg;
+
+  // compile into the inactive bank; frames in flight keep reading the active
+  // one, and config_bps flips on the next request
+  if (cc.output_type == ISP_BPS_PROCESSED) {
+    int bank = bps_cdm_bank ^ 1;
+    bps_cdm_staged_patches.clear();
+    bps_cdm_staged_len = buildBpsCdm((unsigned char *)bps_cdm_program_array.ptr + bps_cdm_program_array.aligned_size()*bank,
+                                     bps_cdm_staged_patches);
+    bps_cdm_staged = true;
+  }
+
+  // IFE slot programs recompile lazily: each slot is rebuilt when it's next
+  // configured, which is a frame boundary for that slot
+  for (int i = 0; i < MAX_IFE_BUFS; i++) {
+    ife_update_len[i] = 0;
+  }
+}
+
 void SpectraCamera::config_ife(int idx, int request_id, bool init) {
   /*
     Handles initial + per-frame IFE config.
@@ -787,7 +895,13 @@ void SpectraCamera::config_ife(int idx, int request_id, bool init) {
       if (init) {
         buf_desc[0].length = build_initial_config((unsigned char*)ife_cmd.ptr + buf_desc[0].offset, cc, sensor.get(), patches, buf.out_img_width, buf.out_img_height);
       } else {
-        buf_desc[0].length = build_update((unsigned char*)ife_cmd.ptr + buf_desc[0].offset, cc, sensor.get(), patches);
+        // the update program is static frame to frame, so compile it once per
+        // slot and reuse the snapshot. the initial program begins with the
+        // update program, so the snapshot also survives a re-init of slot 0.
+        if (ife_update_len[idx] == 0) {
+          ife_update_len[idx] = build_update((unsigned char*)ife_cmd.ptr + buf_desc[0].offset, cc, sensor.get(), patches);
+        }
+        buf_desc[0].length = ife_update_len[idx];
       }
     }
 
@@ -1042,6 +1156,7 @@ bool SpectraCamera::openSensor() {
 
   auto init_sensor_lambda = [this](SensorInfo *s) {
     sensor.reset(s);
+    sensor_reg_shadow.clear();  // probe power-cycles the sensor, forget its registers
     return (sensors_init() == 0);
   };
 
@@ -1068,7 +1183,9 @@ bool SpectraCamera::openSensor() {
   LOGD("acquire sensor dev");
 
   LOG("-- Configuring sensor");
-  sensors_i2c(sensor->init_reg_array.data(), sensor->init_reg_array.size(), CAM_SENSOR_PACKET_OPCODE_SENSOR_CONFIG, sensor->data_word);
+  // the shadow is cleared on probe, so a first init writes the full table
+  // and a reinit of a still-powered sensor only writes what changed
+  sensors_i2c(sensor->init_reg_array.data(), sensor->init_reg_array.size(), CAM_SENSOR_PACKET_OPCODE_SENSOR_CONFIG, sensor->data_word, true);
   return true;
 }
 
@@ -1208,8 +1325,9 @@ void SpectraCamera::configICP() {
   bps_iq.init(m, settings_size, 0x20, true, m->icp_device_iommu);
   memcpy(bps_iq.ptr, bps_settings[sensor->num()], settings_size);
 
-  // for cdm register writes, just make it bigger than you need
-  bps_cdm_program_array.init(m, 0x1000, 0x20, true, m->icp_device_iommu);
+  // for cdm register writes, just make it bigger than you need.
+  // two banks so an updated program can be staged while the active one runs
+  bps_cdm_program_array.init(m, 0x1000, 0x20, true, m->icp_device_iommu, 0, 2);
 
   // striping lib output
   uint32_t striping_size = sizeof(bps_striping_output[0]) / sizeof(bps_striping_output[0][0]);
@@ -1329,6 +1447,11 @@ void SpectraCamera::linkDevices() {
 void SpectraCamera::camera_close() {
   LOG("-- Stop devices %d", cc.camera_num);
 
+  // don't tear down the session while queued i2c writes are still in flight
+  while (i2c_inflight > 0) {
+    util::sleep_for(1);
+  }
+
   if (enabled) {
     clear_req_queue();
 
@@ -1424,8 +1547,11 @@ bool SpectraCamera::handle_camera_event(const cam_req_mgr_message *event_data) {
   frame_id_raw_last = frame_id_raw;
   request_id_last = request_id;
 
+  FrameTrace &trace = frame_traces[frame_trace_idx++ % FRAME_TRACE_LEN];
+  trace = {.frame_id_raw = frame_id_raw, .request_id = request_id, .timestamp_sof = timestamp};
+
   // Wait until frame's fully read out and processed
-  if (!waitForFrameReady(request_id)) {
+  if (!waitForFrameReady(request_id, trace)) {
     // Reset queue on sync failure to prevent frame tearing
     LOGE("camera %d sync failure %ld %ld ", cc.camera_num, request_id, frame_id_raw);
     clearAndRequeue(request_id + 1);
@@ -1480,7 +1606,7 @@ void SpectraCamera::clearAndRequeue(uint64_t from_request_id) {
   skip_expected = true;
 }
 
-bool SpectraCamera::waitForFrameReady(uint64_t request_id) {
+bool SpectraCamera::waitForFrameReady(uint64_t request_id, FrameTrace &trace) {
   int buf_idx = request_id % ife_buf_depth;
   assert(sync_objs_ife[buf_idx]);
 
@@ -1504,9 +1630,11 @@ bool SpectraCamera::waitForFrameReady(uint64_t request_id) {
   // - in RAW_OUTPUT mode, this time is just the frame readout from the sensor
   // - in IFE_PROCESSED mode, this time also includes image processing (~1ms)
   bool success = waitForSync(sync_objs_ife[buf_idx], 100, "IFE sync");
+  if (success) trace.timestamp_ife_done = nanos_since_boot();
   if (success && sync_objs_bps[buf_idx]) {
     // BPS is typically 7ms
     success = waitForSync(sync_objs_bps[buf_idx], 50, "BPS sync");
+    if (success) trace.timestamp_bps_done = nanos_since_boot();
   }
 
   return success;
@@ -1,21 +1,26 @@
 #pragma once
 
 #include <sys/mman.h>
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <optional>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "media/cam_req_mgr.h"
 
+#include "common/queue.h"
 #include "common/util.h"
 #include "common/swaglog.h"
 #include "system/camerad/cameras/hw.h"
 #include "system/camerad/cameras/camera_common.h"
 #include "system/camerad/sensors/sensor.h"
 
-#define MAX_IFE_BUFS 20
+#define MAX_IFE_BUFS 28
 
 const int MIPI_SETTLE_CNT = 33;  // Calculated by camera_freqs.py
 
@@ -71,19 +76,46 @@ public:
     return std::unique_ptr<T, std::function<void(void *)>>((T*)alloc_buf(len, handle), [this](void *ptr) { this->free(ptr); });
   }
 
+  // Allocations are rounded into size classes. seal() tops up the pool of
+  // every class observed during init, after which the steady-state frame
+  // loop should never hit the dma heap; any miss past that is counted.
+  void seal(int count_per_class);
+  uint64_t pool_misses() const { return pool_miss_count; }
+
 private:
   void *alloc_buf(int len, uint32_t *handle);
   void free(void *ptr);
 
+  static constexpr int SIZE_CLASS = 512;
+
+  std::mutex lock;
+  bool sealed = false;
+  std::atomic<uint64_t> pool_miss_count = 0;
   std::map<void *, uint32_t> handle_lookup;
   std::map<void *, int> size_lookup;
   std::map<int, std::queue<void *> > cached_allocations;
   int video0_fd;
 };
 
+class SpectraCamera;
+
 class SpectraMaster {
 public:
   void init();
+  ~SpectraMaster();
+
+  // Exposure register writes from the camera frame threads are queued here
+  // and issued by a single submission thread, so a slow CCI transaction never
+  // delays frame handling. Updates queued in the same window go out
+  // back-to-back in one wakeup.
+  struct I2cRequest {
+    SpectraCamera *cam = nullptr;  // nullptr stops the thread
+    std::vector<struct i2c_random_wr_payload> payload;
+    int op_code = 0;
+    bool data_word = false;
+  };
+  SafeQueue<I2cRequest> i2c_q;
+  std::thread i2c_thread;
 
   unique_fd video0_fd;
   unique_fd cam_sync_fd;
@@ -142,6 +174,10 @@ public:
   void camera_map_bufs();
   void config_bps(int idx, int request_id);
   void config_ife(int idx, int request_id, bool init=false);
+  // glitch-free processing reconfig: compiles updated linearization/CCM
+  // settings into the inactive CDM bank while frames keep flowing, and the
+  // next request flips to it at a frame boundary. call from the camera thread.
+  void stageProcessingConfig(const std::vector<uint32_t> &lin_reg, const std::vector<uint32_t> &ccm_reg);
 
   int clear_req_queue();
   void enqueue_frame(uint64_t request_id);
@@ -149,7 +185,12 @@ public:
   int sensors_init();
   void sensors_start();
   void sensors_poke(int request_id);
-  void sensors_i2c(const struct i2c_random_wr_payload* dat, int len, int op_code, bool data_word);
+  // delta=true writes only registers that differ from the last value we
+  // programmed, so reconfiguring a live sensor is a handful of writes
+  // instead of the full table. don't use it for write-to-latch registers
+  // like the exposure group hold, where rewriting the same value matters.
+  void sensors_i2c(const struct i2c_random_wr_payload* dat, int len, int op_code, bool data_word, bool delta = false);
+  void sensors_i2c_async(const struct i2c_random_wr_payload* dat, int len, int op_code, bool data_word);
 
   bool openSensor();
   void configISP();
@@ -201,10 +242,49 @@ public:
   std::vector<uint32_t> bps_lin_reg;
   std::vector<uint32_t> bps_ccm_reg;
 
+  // compiled CDM program cache: the register programs are static frame to
+  // frame, so each is built once and later requests just point their command
+  // descriptors at the snapshot instead of re-emitting every word
+  int ife_update_len[MAX_IFE_BUFS] = {};
+  int bps_cdm_len = 0;
+  std::vector<uint32_t> bps_cdm_patches;
+
+  // double-buffered BPS CDM program: the program array holds two banks, and a
+  // staged compile in the inactive bank becomes active when config_bps flips
+  // on the next request. in-flight frames only ever see a complete bank.
+  int bps_cdm_bank = 0;
+  bool bps_cdm_staged = false;
+  int bps_cdm_staged_len = 0;
+  std::vector<uint32_t> bps_cdm_staged_patches;
+
   int buf_handle_yuv[MAX_IFE_BUFS] = {};
   int buf_handle_raw[MAX_IFE_BUFS] = {};
   int sync_objs_ife[MAX_IFE_BUFS] = {};
   int sync_objs_bps[MAX_IFE_BUFS] = {};
+  std::atomic<int> i2c_inflight = 0;
+  std::map<uint32_t, uint32_t> sensor_reg_shadow;
+
+  // frame drop forensics: per-stage timestamps for recent frames. a zero
+  // stage timestamp means the frame never cleared that stage, so drops can
+  // be attributed to the sensor, ISP, or IPC without a reflash.
+  struct FrameTrace {
+    uint64_t frame_id_raw = 0;
+    uint64_t request_id = 0;
+    uint64_t timestamp_sof = 0;
+    uint64_t timestamp_ife_done = 0;
+    uint64_t timestamp_bps_done = 0;
+    uint64_t timestamp_publish = 0;
+  };
+  static constexpr int FRAME_TRACE_LEN = 32;
+  FrameTrace frame_traces[FRAME_TRACE_LEN] = {};
+  uint64_t frame_trace_idx = 0;
+
+  void markFramePublished() {
+    if (frame_trace_idx > 0) {
+      frame_traces[(frame_trace_idx - 1) % FRAME_TRACE_LEN].timestamp_publish = nanos_since_boot();
+    }
+  }
+
   uint64_t request_id_last = 0;
   uint64_t last_requeue_ts = 0;
   uint64_t frame_id_raw_last = 0;
@@ -215,9 +295,10 @@ public:
   SpectraMaster *m;
 
 private:
+  int buildBpsCdm(unsigned char *dst, std::vector<uint32_t> &patches);
   void clearAndRequeue(uint64_t from_request_id);
   bool validateEvent(uint64_t request_id, uint64_t frame_id_raw);
-  bool waitForFrameReady(uint64_t request_id);
+  bool waitForFrameReady(uint64_t request_id, FrameTrace &trace);
   bool processFrame(int buf_idx, uint64_t request_id, uint64_t frame_id_raw, uint64_t timestamp);
   static bool syncFirstFrame(int camera_id, uint64_t request_id, uint64_t raw_id, uint64_t timestamp, bool staggered);
   struct SyncData {
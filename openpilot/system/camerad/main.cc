@@ -3,6 +3,7 @@
 #include <cassert>
 
 #include "common/params.h"
+#include "common/self_metrics.h"
 #include "common/util.h"
 
 int main(int argc, char *argv[]) {
@@ -10,6 +11,8 @@ int main(int argc, char *argv[]) {
   int ret = util::set_core_affinity({6});
   assert(ret == 0 || Params().getBool("IsOffroad")); // failure ok while offroad due to offlining cores
 
+  self_metrics::start("camerad");
   camerad_thread();
+  self_metrics::stop();
   return 0;
 }
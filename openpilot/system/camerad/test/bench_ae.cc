@@ -0,0 +1,71 @@
+// Benchmark for camerad's per-frame CPU work that runs off-device.
+//
+// Drives calculate_exposure_value over synthetic full-resolution frames at a
+// configurable multiple of real-time and reports per-frame CPU and worst-case
+// latency, so AE kernel changes can be compared on PCs before they ship.
+//
+//   ./bench_ae [seconds-of-frames] [realtime-multiple]
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "common/timing.h"
+#include "system/camerad/cameras/camera_common.h"
+
+#define W 1928
+#define H 1208
+#define FPS 20
+
+int main(int argc, char *argv[]) {
+  int duration_s = argc > 1 ? atoi(argv[1]) : 30;
+  int multiple = argc > 2 ? atoi(argv[2]) : 1;
+  assert(duration_s > 0 && multiple > 0);
+
+  // fake camera buffer with a gradient + noise pattern so the histogram
+  // isn't degenerate
+  std::vector<uint8_t> fb_y(W * H);
+  for (int y = 0; y < H; y++) {
+    for (int x = 0; x < W; x++) {
+      fb_y[y * W + x] = (uint8_t)((x * 255 / W + ((x * 31 + y * 17) & 0x1f)) & 0xff);
+    }
+  }
+  VisionBuf vb = {};
+  vb.y = fb_y.data();
+  CameraBuf cb = {};
+  cb.cur_yuv_buf = &vb;
+  cb.out_img_width = W;
+  cb.out_img_height = H;
+
+  // same regions and skips the three cameras use onroad
+  struct { Rect rect; int x_skip, y_skip; } cams[] = {
+    {{96, 160, 1734, 986}, 2, 2},  // road
+    {{96, 400, 1734, 524}, 2, 2},  // wide
+    {{96, 242, 1736, 906}, 2, 4},  // driver
+  };
+
+  const int frames = duration_s * FPS * multiple;
+  std::vector<double> frame_ms;
+  frame_ms.reserve(frames);
+
+  float sink = 0;
+  double start = millis_since_boot();
+  for (int f = 0; f < frames; f++) {
+    double t0 = millis_since_boot();
+    for (auto &cam : cams) {
+      sink += calculate_exposure_value(&cb, cam.rect, cam.x_skip, cam.y_skip);
+    }
+    frame_ms.push_back(millis_since_boot() - t0);
+  }
+  double wall_s = (millis_since_boot() - start) / 1000.0;
+
+  std::sort(frame_ms.begin(), frame_ms.end());
+  auto pct = [&](double p) { return frame_ms[std::min(frame_ms.size() - 1, (size_t)(p * frame_ms.size()))]; };
+
+  printf("%d frames x 3 cameras in %.2fs wall (sink %.1f)\n", frames, wall_s, sink);
+  printf("  AE per frame: p50 %.3fms  p99 %.3fms  max %.3fms\n", pct(0.50), pct(0.99), frame_ms.back());
+  return 0;
+}
@@ -1,5 +1,7 @@
 #include <cassert>
+#include <future>
 #include <string>
+#include <vector>
 
 #include "openpilot/cereal/messaging/messaging.h"
 #include "common/params.h"
@@ -9,6 +11,18 @@
 
 
 static kj::Array<capnp::word> build_boot_log() {
+  // Gather output of commands. each command forks its own process, so
+  // kicking them all off up front captures them in parallel while we read
+  // pstore; bootlog startup latency is then the slowest command, not the sum.
+  std::vector<std::string> bootlog_commands = {
+    "[ -x \"$(command -v journalctl)\" ] && journalctl -b -n 2000 -o short-monotonic --no-pager",
+  };
+
+  std::vector<std::future<std::string>> command_outputs;
+  for (const auto &cmd : bootlog_commands) {
+    command_outputs.push_back(std::async(std::launch::async, util::check_output, cmd));
+  }
+
   MessageBuilder msg;
   auto boot = msg.initEvent().initBoot();
 
@@ -26,19 +40,13 @@ static kj::Array<capnp::word> build_boot_log() {
     i++;
   }
 
-  // Gather output of commands
-  std::vector<std::string> bootlog_commands = {
-    "[ -x \"$(command -v journalctl)\" ] && journalctl -b -n 2000 -o short-monotonic --no-pager",
-  };
-
-
   auto commands = boot.initCommands().initEntries(bootlog_commands.size());
   for (int j = 0; j < bootlog_commands.size(); j++) {
     auto lentry = commands[j];
 
     lentry.setKey(bootlog_commands[j]);
 
-    const std::string result = util::check_output(bootlog_commands[j]);
+    const std::string result = command_outputs[j].get();
     lentry.setValue(capnp::Data::Reader((const kj::byte*)result.data(), result.size()));
   }
 
@@ -47,6 +55,9 @@ static kj::Array<capnp::word> build_boot_log() {
 }
 
 int main(int argc, char** argv) {
+  // init data gathering is independent of the boot log capture; overlap them
+  auto init_data = std::async(std::launch::async, logger_build_init_data);
+
   const std::string id = logger_get_identifier("BootCount");
   const std::string path = Path::log_root() + "/boot/" + id + ".zst";
   LOGW("bootlog to %s", path.c_str());
@@ -55,9 +66,10 @@ int main(int argc, char** argv) {
   bool r = util::create_directories(Path::log_root() + "/boot/", 0775);
   assert(r);
 
-  ZstdFileWriter file(path, LOG_COMPRESSION_LEVEL);
+  // async writer: compression streams while sections are still being captured
+  ZstdFileWriter file(path, LOG_COMPRESSION_LEVEL, true);
   // Write initdata
-  file.write(logger_build_init_data().asBytes());
+  file.write(init_data.get().asBytes());
   // Write bootlog
   file.write(build_boot_log().asBytes());
 
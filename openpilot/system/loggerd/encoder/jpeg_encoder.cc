@@ -4,15 +4,20 @@
 #include <cstring>
 
 #include "common/swaglog.h"
+#include "common/util.h"
 
 // Lower qscale = higher quality / bigger files for MJPEG.
 constexpr int MJPEG_QSCALE = 7;
 
 JpegEncoder::JpegEncoder(const std::string &publish_name, int width, int height)
     : publish_name(publish_name), thumbnail_width(width), thumbnail_height(height) {
-  yuv_buffer.resize((thumbnail_width * thumbnail_height * 3) / 2);
   pm = std::make_unique<PubMaster>(std::vector{publish_name.c_str()});
 
+  for (int i = 0; i < POOL_SIZE; i++) {
+    pool[i].yuv.resize((thumbnail_width * thumbnail_height * 3) / 2);
+    free_slots.push(i);
+  }
+
   const AVCodec *codec = avcodec_find_encoder(AV_CODEC_ID_MJPEG);
   assert(codec);
 
@@ -41,31 +46,65 @@ JpegEncoder::JpegEncoder(const std::string &publish_name, int width, int height)
 
   pkt = av_packet_alloc();
   assert(pkt);
+
+  compress_thread = std::thread(&JpegEncoder::compressThread, this);
 }
 
 JpegEncoder::~JpegEncoder() {
+  pending_slots.push(-1);
+  compress_thread.join();
+
   av_packet_free(&pkt);
   av_frame_free(&frame);
   avcodec_free_context(&codec_ctx);
 }
 
 void JpegEncoder::pushThumbnail(VisionBuf *buf, const VisionIpcBufExtra &extra) {
-  generateThumbnail(buf->y, buf->uv, buf->width, buf->height, buf->stride);
+  int slot;
+  if (!free_slots.try_pop(slot)) {
+    // all pool buffers still compressing; thumbnails are best-effort
+    LOGD("thumbnail pool exhausted, dropping frame %d", extra.frame_id);
+    return;
+  }
+
+  PendingThumbnail &p = pool[slot];
+  downscaleInto(p, buf->y, buf->uv, buf->width, buf->height, buf->stride);
+  p.frame_id = extra.frame_id;
+  p.timestamp_eof = extra.timestamp_eof;
+  pending_slots.push(slot);
+}
 
-  MessageBuilder msg;
-  auto thumbnaild = msg.initEvent().initThumbnail();
-  thumbnaild.setFrameId(extra.frame_id);
-  thumbnaild.setTimestampEof(extra.timestamp_eof);
-  thumbnaild.setThumbnail({out_buffer.data(), out_buffer.size()});
+void JpegEncoder::compressThread() {
+  util::set_thread_name("jpeg_encoder");
 
-  pm->send(publish_name.c_str(), msg);
+  int slot;
+  while ((slot = pending_slots.pop()) != -1) {
+    PendingThumbnail &p = pool[slot];
+
+    uint8_t *y_plane = p.yuv.data();
+    uint8_t *u_plane = y_plane + thumbnail_width * thumbnail_height;
+    uint8_t *v_plane = u_plane + (thumbnail_width * thumbnail_height) / 4;
+    compressToJpeg(y_plane, u_plane, v_plane);
+
+    if (!out_buffer.empty()) {
+      MessageBuilder msg;
+      auto thumbnaild = msg.initEvent().initThumbnail();
+      thumbnaild.setFrameId(p.frame_id);
+      thumbnaild.setTimestampEof(p.timestamp_eof);
+      thumbnaild.setThumbnail({out_buffer.data(), out_buffer.size()});
+
+      pm->send(publish_name.c_str(), msg);
+    }
+
+    free_slots.push(slot);
+  }
 }
 
-void JpegEncoder::generateThumbnail(const uint8_t *y_addr, const uint8_t *uv_addr, int width, int height, int stride) {
+void JpegEncoder::downscaleInto(PendingThumbnail &p, const uint8_t *y_addr, const uint8_t *uv_addr, int width, int height, int stride) {
   int downscale = width / thumbnail_width;
   assert(downscale * thumbnail_height == height);
 
-  uint8_t *y_plane = yuv_buffer.data();
+  uint8_t *y_plane = p.yuv.data();
   uint8_t *u_plane = y_plane + thumbnail_width * thumbnail_height;
   uint8_t *v_plane = u_plane + (thumbnail_width * thumbnail_height) / 4;
   {
@@ -83,8 +122,6 @@ void JpegEncoder::generateThumbnail(const uint8_t *y_addr, const uint8_t *uv_add
       }
     }
   }
-
-  compressToJpeg(y_plane, u_plane, v_plane);
 }
 
 void JpegEncoder::compressToJpeg(uint8_t *y_plane, uint8_t *u_plane, uint8_t *v_plane) {
@@ -3,10 +3,12 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "openpilot/cereal/messaging/messaging.h"
 #include "msgq/visionipc/visionbuf.h"
+#include "common/queue.h"
 
 extern "C" {
 #include <libavcodec/avcodec.h>
@@ -16,19 +18,35 @@ class JpegEncoder {
 public:
   JpegEncoder(const std::string &publish_name, int width, int height);
   ~JpegEncoder();
+  // only does the sparse NV12 downscale into a pool buffer; JPEG compression
+  // and publishing happen on a dedicated thread so the encode loop never
+  // blocks on libavcodec. drops the thumbnail if all pool buffers are busy.
   void pushThumbnail(VisionBuf *buf, const VisionIpcBufExtra &extra);
 
 private:
-  void generateThumbnail(const uint8_t *y, const uint8_t *uv, int width, int height, int stride);
+  static constexpr int POOL_SIZE = 3;
+
+  struct PendingThumbnail {
+    std::vector<uint8_t> yuv;
+    uint32_t frame_id = 0;
+    uint64_t timestamp_eof = 0;
+  };
+
+  void downscaleInto(PendingThumbnail &p, const uint8_t *y, const uint8_t *uv, int width, int height, int stride);
   void compressToJpeg(uint8_t *y_plane, uint8_t *u_plane, uint8_t *v_plane);
+  void compressThread();
 
   int thumbnail_width;
   int thumbnail_height;
   std::string publish_name;
-  std::vector<uint8_t> yuv_buffer;
   std::vector<uint8_t> out_buffer;
   std::unique_ptr<PubMaster> pm;
 
+  PendingThumbnail pool[POOL_SIZE];
+  SafeQueue<int> free_slots;     // indices into pool, ready for downscale
+  SafeQueue<int> pending_slots;  // indices awaiting compression (-1 = exit)
+  std::thread compress_thread;
+
   AVCodecContext *codec_ctx = nullptr;
   AVFrame *frame = nullptr;
   AVPacket *pkt = nullptr;
@@ -23,11 +23,20 @@
 */
 const int env_debug_encoder = (getenv("DEBUG_ENCODER") != NULL) ? atoi(getenv("DEBUG_ENCODER")) : 0;
 
+// import camerad's frame fds as dmabufs on the input queue instead of
+// userptr mappings; the encoder then reads straight from the camera buffer
+// with no CPU-side copy or cache maintenance
+const bool env_dmabuf = getenv("ENCODER_DMABUF") != NULL;
+
+static inline v4l2_memory memory_type(v4l2_buf_type buf_type) {
+  return (env_dmabuf && buf_type == V4L2_BUF_TYPE_VIDEO_OUTPUT_MPLANE) ? V4L2_MEMORY_DMABUF : V4L2_MEMORY_USERPTR;
+}
+
 static void dequeue_buffer(int fd, v4l2_buf_type buf_type, unsigned int *index=NULL, unsigned int *bytesused=NULL, unsigned int *flags=NULL, struct timeval *timestamp=NULL) {
   v4l2_plane plane = {0};
   v4l2_buffer v4l_buf = {
     .type = buf_type,
-    .memory = V4L2_MEMORY_USERPTR,
+    .memory = memory_type(buf_type),
     .m = { .planes = &plane, },
     .length = 1,
   };
@@ -53,10 +62,13 @@ static void queue_buffer(int fd, v4l2_buf_type buf_type, unsigned int index, Vis
     .type = buf_type,
     .flags = V4L2_BUF_FLAG_TIMESTAMP_COPY,
     .timestamp = timestamp,
-    .memory = V4L2_MEMORY_USERPTR,
+    .memory = memory_type(buf_type),
     .m = { .planes = &plane, },
     .length = 1,
   };
+  if (v4l_buf.memory == V4L2_MEMORY_DMABUF) {
+    plane.m.fd = buf->fd;
+  }
   util::safe_ioctl(fd, VIDIOC_QBUF, &v4l_buf, "VIDIOC_QBUF failed");
 }
 
@@ -64,7 +76,7 @@ static void request_buffers(int fd, v4l2_buf_type buf_type, unsigned int count)
   struct v4l2_requestbuffers reqbuf = {
     .count = count,
     .type = buf_type,
-    .memory = V4L2_MEMORY_USERPTR,
+    .memory = memory_type(buf_type),
   };
   util::safe_ioctl(fd, VIDIOC_REQBUFS, &reqbuf, "VIDIOC_REQBUFS failed");
 }
@@ -72,6 +84,9 @@ static void request_buffers(int fd, v4l2_buf_type buf_type, unsigned int count)
 void V4LEncoder::dequeue_handler(V4LEncoder *e) {
   std::string dequeue_thread_name = "dq-"+std::string(e->encoder_info.publish_name);
   util::set_thread_name(dequeue_thread_name.c_str());
+  if (!e->encoder_info.affinity.empty()) {
+    util::set_core_affinity(e->encoder_info.affinity);
+  }
 
   e->segment_num++;
   uint32_t idx = -1;
@@ -104,41 +119,48 @@ void V4LEncoder::dequeue_handler(V4LEncoder *e) {
     }
 
     int frame_id = -1;
-    if (pfd.revents & POLLIN) {
-      unsigned int bytesused, flags, index;
-      struct timeval timestamp;
-      dequeue_buffer(e->fd, V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE, &index, &bytesused, &flags, &timestamp);
-      e->buf_out[index].sync(VISIONBUF_SYNC_FROM_DEVICE);
-      uint8_t *buf = (uint8_t*)e->buf_out[index].addr;
-      int64_t ts = timestamp.tv_sec * 1000000 + timestamp.tv_usec;
-
-      // eof packet, we exit
-      if (flags & V4L2_QCOM_BUF_FLAG_EOS) {
-        exit = true;
-      } else if (flags & V4L2_QCOM_BUF_FLAG_CODECCONFIG) {
-        // save header
-        header = kj::heapArray<capnp::byte>(buf, bytesused);
-      } else {
-        VisionIpcBufExtra extra = e->extras.pop();
-        assert(extra.timestamp_eof/1000 == ts); // stay in sync
-        frame_id = extra.frame_id;
-        ++idx;
-        e->publisher_publish(e->segment_num, idx, extra, flags, header, kj::arrayPtr<capnp::byte>(buf, bytesused));
-      }
+    try {
+      if (pfd.revents & POLLIN) {
+        unsigned int bytesused, flags, index;
+        struct timeval timestamp;
+        dequeue_buffer(e->fd, V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE, &index, &bytesused, &flags, &timestamp);
+        e->buf_out[index].sync(VISIONBUF_SYNC_FROM_DEVICE);
+        uint8_t *buf = (uint8_t*)e->buf_out[index].addr;
+        int64_t ts = timestamp.tv_sec * 1000000 + timestamp.tv_usec;
+
+        // eof packet, we exit
+        if (flags & V4L2_QCOM_BUF_FLAG_EOS) {
+          exit = true;
+        } else if (flags & V4L2_QCOM_BUF_FLAG_CODECCONFIG) {
+          // save header
+          header = kj::heapArray<capnp::byte>(buf, bytesused);
+        } else {
+          VisionIpcBufExtra extra = e->extras.pop();
+          assert(extra.timestamp_eof/1000 == ts); // stay in sync
+          frame_id = extra.frame_id;
+          ++idx;
+          e->publisher_publish(e->segment_num, idx, extra, flags, header, kj::arrayPtr<capnp::byte>(buf, bytesused));
+        }
 
-      if (env_debug_encoder) {
-        printf("%20s got(%d) %6d bytes flags %8x idx %3d/%4d id %8d ts %ld lat %.2f ms (%lu frames free)\n",
-          e->encoder_info.publish_name, index, bytesused, flags, e->segment_num, idx, frame_id, ts, millis_since_boot()-(ts/1000.), e->free_buf_in.size());
-      }
+        if (env_debug_encoder) {
+          printf("%20s got(%d) %6d bytes flags %8x idx %3d/%4d id %8d ts %ld lat %.2f ms (%lu frames free)\n",
+            e->encoder_info.publish_name, index, bytesused, flags, e->segment_num, idx, frame_id, ts, millis_since_boot()-(ts/1000.), e->free_buf_in.size());
+        }
 
-      // requeue the buffer
-      queue_buffer(e->fd, V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE, index, &e->buf_out[index]);
-    }
+        // requeue the buffer
+        queue_buffer(e->fd, V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE, index, &e->buf_out[index]);
+      }
 
-    if (pfd.revents & POLLOUT) {
-      unsigned int index;
-      dequeue_buffer(e->fd, V4L2_BUF_TYPE_VIDEO_OUTPUT_MPLANE, &index);
-      e->free_buf_in.push(index);
+      if (pfd.revents & POLLOUT) {
+        unsigned int index;
+        dequeue_buffer(e->fd, V4L2_BUF_TYPE_VIDEO_OUTPUT_MPLANE, &index);
+        e->free_buf_in.push(index);
+      }
+    } catch (const std::exception &err) {
+      // flag the device error and exit; the encode thread runs the recovery
+      LOGE("encoder %s dequeue error: %s", e->encoder_info.publish_name, err.what());
+      e->device_error = true;
+      break;
     }
   }
 }
@@ -274,22 +296,78 @@ void V4LEncoder::encoder_open() {
 }
 
 int V4LEncoder::encode_frame(VisionBuf* buf, VisionIpcBufExtra *extra) {
+  if (device_error && !encoder_recover()) return -1;
+
   struct timeval timestamp {
     .tv_sec = (long)(extra->timestamp_eof/1000000000),
     .tv_usec = (long)((extra->timestamp_eof/1000) % 1000000),
   };
 
-  // reserve buffer
-  int buffer_in = free_buf_in.pop();
+  // reserve buffer. polled so a dequeue thread death doesn't leave us parked
+  // on a ring that will never be refilled
+  unsigned int buffer_in;
+  while (!free_buf_in.try_pop(buffer_in)) {
+    if (device_error && !encoder_recover()) return -1;
+    util::sleep_for(1);
+  }
 
   // push buffer
   extras.push(*extra);
   //buf->sync(VISIONBUF_SYNC_TO_DEVICE);
-  queue_buffer(fd, V4L2_BUF_TYPE_VIDEO_OUTPUT_MPLANE, buffer_in, buf, timestamp);
+  try {
+    queue_buffer(fd, V4L2_BUF_TYPE_VIDEO_OUTPUT_MPLANE, buffer_in, buf, timestamp);
+  } catch (const std::exception &err) {
+    device_error = true;
+    encoder_recover();
+    return -1;  // this frame is lost either way
+  }
 
   return this->counter++;
 }
 
+// Warm recovery after a device error: restart streaming on the same fd and
+// re-queue the capture pool allocated in the constructor, so the registered
+// buffers and the camera thread's VisionIpc client survive and the encode gap
+// is a few frames instead of a full encoderd restart.
+bool V4LEncoder::encoder_recover() {
+  double start_ms = millis_since_boot();
+  if (dequeue_handler_thread.joinable()) dequeue_handler_thread.join();
+  this->is_open = false;
+
+  try {
+    v4l2_buf_type buf_type = V4L2_BUF_TYPE_VIDEO_OUTPUT_MPLANE;
+    util::safe_ioctl(fd, VIDIOC_STREAMOFF, &buf_type, "recovery VIDIOC_STREAMOFF failed");
+    buf_type = V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE;
+    util::safe_ioctl(fd, VIDIOC_STREAMOFF, &buf_type, "recovery VIDIOC_STREAMOFF failed");
+
+    buf_type = V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE;
+    util::safe_ioctl(fd, VIDIOC_STREAMON, &buf_type, "recovery VIDIOC_STREAMON failed");
+    buf_type = V4L2_BUF_TYPE_VIDEO_OUTPUT_MPLANE;
+    util::safe_ioctl(fd, VIDIOC_STREAMON, &buf_type, "recovery VIDIOC_STREAMON failed");
+
+    for (unsigned int i = 0; i < BUF_OUT_COUNT; i++) {
+      queue_buffer(fd, V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE, i, &buf_out[i]);
+    }
+  } catch (const std::exception &err) {
+    LOGE("encoder %s warm recovery failed: %s", encoder_info.publish_name, err.what());
+    return false;
+  }
+
+  // drop in-flight frame metadata and hand every input slot back
+  VisionIpcBufExtra stale;
+  while (extras.try_pop(stale)) {}
+  unsigned int slot;
+  while (free_buf_in.try_pop(slot)) {}
+  for (unsigned int i = 0; i < BUF_IN_COUNT; i++) free_buf_in.push(i);
+
+  device_error = false;
+  encoder_open();
+
+  ++recovery_count;
+  LOGW("encoder %s recovered in %.1f ms (recovery #%d)", encoder_info.publish_name, millis_since_boot() - start_ms, recovery_count);
+  return true;
+}
+
 void V4LEncoder::encoder_close() {
   if (this->is_open) {
     // pop all the frames before closing, then put the buffers back
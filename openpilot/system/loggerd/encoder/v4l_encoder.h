@@ -13,6 +13,7 @@ public:
   int encode_frame(VisionBuf* buf, VisionIpcBufExtra *extra);
   void encoder_open();
   void encoder_close();
+  bool encoder_recover();
   void set_bitrate(int bitrate);
   void request_keyframe();
 
@@ -24,11 +25,18 @@ private:
   int counter = 0;
   int current_bitrate = -1;
 
-  SafeQueue<VisionIpcBufExtra> extras;
+  // set when an ioctl on the device fails; the next encode_frame attempts a
+  // warm recovery instead of letting the error take down the process
+  std::atomic<bool> device_error = false;
+  int recovery_count = 0;
+
+  // SPSC handoff between the encode thread and the dequeue handler; the
+  // lock-free ring keeps frame handoff latency deterministic under load
+  SpscRing<VisionIpcBufExtra> extras{2 * BUF_IN_COUNT};
 
   static void dequeue_handler(V4LEncoder *e);
   std::thread dequeue_handler_thread;
 
   VisionBuf buf_out[BUF_OUT_COUNT];
-  SafeQueue<unsigned int> free_buf_in;
+  SpscRing<unsigned int> free_buf_in{BUF_IN_COUNT};
 };
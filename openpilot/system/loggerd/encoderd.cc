@@ -58,8 +58,27 @@ void encoder_request_keyframe(std::unique_ptr<Encoder> &e) {
   e->request_keyframe();
 }
 
+// qcam encoders pick their rung off the QcamEncodeProfile ladder; a changed
+// profile rebuilds the encoder (resolution changes need a fresh encode
+// session), done while the encoder is closed so the next segment starts clean
+void encoder_update_qcam_profile(std::unique_ptr<Encoder> &e, const EncoderInfo &info,
+                                 int in_width, int in_height, const QcamProfile *&cur_profile) {
+  static Params params;
+  const QcamProfile &profile = get_qcam_profile(params.get("QcamEncodeProfile"));
+  if (&profile == cur_profile) return;
+  if (cur_profile != nullptr) {
+    LOGW("qcam profile %s -> %s (%dx%d @ %d bps)", cur_profile->name, profile.name,
+         profile.frame_width, profile.frame_height, profile.bitrate);
+  }
+  e.reset(new Encoder(with_qcam_profile(info, profile), in_width, in_height));
+  cur_profile = &profile;
+}
+
 void encoder_thread(EncoderdState *s, const LogCameraInfo &cam_info) {
   util::set_thread_name(cam_info.thread_name);
+  if (!cam_info.encoder_infos[0].affinity.empty()) {
+    util::set_core_affinity(cam_info.encoder_infos[0].affinity);
+  }
 
   std::vector<std::unique_ptr<Encoder>> encoders;
 
@@ -68,6 +87,7 @@ void encoder_thread(EncoderdState *s, const LogCameraInfo &cam_info) {
   std::unique_ptr<JpegEncoder> jpeg_encoder;
 
   int cur_seg = 0;
+  const QcamProfile *qcam_profile = nullptr;
   while (!do_exit) {
     if (!vipc_client.connect(false)) {
       util::sleep_for(5);
@@ -81,7 +101,12 @@ void encoder_thread(EncoderdState *s, const LogCameraInfo &cam_info) {
       assert(buf_info.width > 0 && buf_info.height > 0);
 
       for (const auto &encoder_info : cam_info.encoder_infos) {
-        auto &e = encoders.emplace_back(new Encoder(encoder_info, buf_info.width, buf_info.height));
+        auto &e = encoders.emplace_back();
+        if (encoder_info.is_qcam) {
+          encoder_update_qcam_profile(e, encoder_info, buf_info.width, buf_info.height, qcam_profile);
+        } else {
+          e.reset(new Encoder(encoder_info, buf_info.width, buf_info.height));
+        }
         e->encoder_open();
       }
 
@@ -115,9 +140,12 @@ void encoder_thread(EncoderdState *s, const LogCameraInfo &cam_info) {
       // do rotation if required
       const int frames_per_seg = SEGMENT_LENGTH * MAIN_FPS;
       if (cur_seg >= 0 && extra.frame_id >= ((cur_seg + 1) * frames_per_seg) + s->start_frame_id) {
-        for (auto &e : encoders) {
-          e->encoder_close();
-          e->encoder_open();
+        for (int i = 0; i < encoders.size(); ++i) {
+          encoders[i]->encoder_close();
+          if (cam_info.encoder_infos[i].is_qcam) {
+            encoder_update_qcam_profile(encoders[i], cam_info.encoder_infos[i], buf->width, buf->height, qcam_profile);
+          }
+          encoders[i]->encoder_open();
         }
         ++cur_seg;
       }
@@ -1,5 +1,12 @@
 #include "system/loggerd/logger.h"
 
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/xattr.h>
+
+#include <cinttypes>
+#include <cstring>
 #include <fstream>
 #include <map>
 #include <vector>
@@ -10,6 +17,7 @@
 #include "common/params.h"
 #include "common/swaglog.h"
 #include "common/version.h"
+#include "system/loggerd/loggerd.h"
 
 // ***** log metadata *****
 kj::Array<capnp::word> logger_build_init_data() {
@@ -153,6 +161,150 @@ std::string zstd_decompress(const std::string &in) {
 }
 
 
+const bool LOGGERD_STAGED_RLOG = getenv("LOGGERD_STAGED_RLOG") != nullptr;
+
+// ***** rlog staging ring *****
+
+RlogStagingRing::RlogStagingRing(const std::string &segment_path) {
+  path_ = segment_path + "/rlog.stage";
+  int fd = HANDLE_EINTR(open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0664));
+  assert(fd >= 0);
+  int err = ftruncate(fd, sizeof(Header) + RLOG_STAGE_SIZE);
+  assert(err == 0);
+
+  void *addr = mmap(nullptr, sizeof(Header) + RLOG_STAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  assert(addr != MAP_FAILED);
+
+  hdr_ = (Header *)addr;
+  data_ = (uint8_t *)addr + sizeof(Header);
+  hdr_->head = hdr_->tail = 0;
+  hdr_->magic = RLOG_STAGE_MAGIC;
+}
+
+RlogStagingRing::~RlogStagingRing() {
+  if (hdr_) munmap(hdr_, sizeof(Header) + RLOG_STAGE_SIZE);
+}
+
+void RlogStagingRing::append(const void *data, size_t size) {
+  size_t off = hdr_->head % RLOG_STAGE_SIZE;
+  size_t first = std::min(size, RLOG_STAGE_SIZE - off);
+  memcpy(data_ + off, data, first);
+  memcpy(data_, (const uint8_t *)data + first, size - first);
+  hdr_->head += size;
+}
+
+void RlogStagingRing::write(uint8_t *data, size_t size, ZstdFileWriter *out) {
+  uint32_t len = size;
+  append(&len, sizeof(len));
+  append(data, size);
+
+  // inline batch flush keeps at most ~one batch staged, so the ring can't wrap
+  // onto unflushed bytes
+  if (hdr_->head - hdr_->tail >= RLOG_STAGE_BATCH) {
+    flush(out);
+  }
+}
+
+void RlogStagingRing::flush(ZstdFileWriter *out) {
+  // the tail always sits on a record boundary: walk the records and drain
+  // only the payloads. the length prefixes exist for crash recovery and must
+  // never reach the rlog stream, which is a flat capnp event stream.
+  while (hdr_->tail < hdr_->head) {
+    uint32_t len;
+    for (size_t i = 0; i < sizeof(len); ++i) {
+      ((uint8_t *)&len)[i] = data_[(hdr_->tail + i) % RLOG_STAGE_SIZE];
+    }
+    uint64_t payload = hdr_->tail + sizeof(len);
+    size_t off = payload % RLOG_STAGE_SIZE;
+    size_t first = std::min((size_t)len, RLOG_STAGE_SIZE - off);
+    out->write(data_ + off, first);
+    if (first < len) out->write(data_, len - first);
+    hdr_->tail = payload + len;  // advance per record so a crash mid-flush doesn't replay
+  }
+}
+
+void RlogStagingRing::finish(ZstdFileWriter *out) {
+  flush(out);
+  std::remove(path_.c_str());
+}
+
+// extract any bytes left in segment staging rings after a crash into a plain
+// capnp event stream next to the (truncated) rlog
+void logger_recover_staged_rlogs(const std::string &log_root) {
+  DIR *d = opendir(log_root.c_str());
+  if (!d) return;
+
+  struct dirent *de = NULL;
+  while ((de = readdir(d))) {
+    std::string stage_path = log_root + "/" + de->d_name + "/rlog.stage";
+    if (!util::file_exists(stage_path)) continue;
+
+    util::MappedFile m = util::map_file(stage_path);
+    auto view = m.view();
+    // layout must match RlogStagingRing::Header
+    struct { uint32_t magic, pad; uint64_t head, tail; } hdr;
+    if (view.size() >= sizeof(hdr)) {
+      memcpy(&hdr, view.data(), sizeof(hdr));
+      const uint8_t *data = (const uint8_t *)view.data() + sizeof(hdr);
+
+      if (hdr.magic == RLOG_STAGE_MAGIC && hdr.tail < hdr.head && hdr.head - hdr.tail <= RLOG_STAGE_SIZE) {
+        std::string out;
+        uint64_t pos = hdr.tail;
+        auto copy_out = [&](void *dst, size_t size) {
+          for (size_t i = 0; i < size; ++i) ((uint8_t *)dst)[i] = data[(pos + i) % RLOG_STAGE_SIZE];
+          pos += size;
+        };
+        while (pos + sizeof(uint32_t) <= hdr.head) {
+          uint32_t len;
+          copy_out(&len, sizeof(len));
+          if (pos + len > hdr.head) break;  // partial trailing record
+          size_t start = out.size();
+          out.resize(start + len);
+          copy_out(&out[start], len);
+        }
+        if (!out.empty()) {
+          std::string recovered = log_root + "/" + de->d_name + "/rlog.stage.recovered";
+          util::write_file(recovered.c_str(), out.data(), out.size(), O_WRONLY | O_CREAT | O_TRUNC, 0664);
+          LOGW("recovered %zu staged rlog bytes to %s", out.size(), recovered.c_str());
+        }
+      }
+    }
+    std::remove(stage_path.c_str());
+  }
+  closedir(d);
+}
+
+// drop index entries whose segment directory the deleter has since removed.
+// runs once at startup, while nothing is appending
+static void compact_upload_index(const std::string &log_root, const std::string &index_path) {
+  std::string content = util::read_file(index_path);
+  if (content.empty()) return;
+
+  std::string kept;
+  kept.reserve(content.size());
+  size_t pos = 0;
+  while (pos < content.size()) {
+    size_t end = content.find('\n', pos);
+    if (end == std::string::npos) end = content.size();
+    std::string line = content.substr(pos, end - pos);
+    pos = end + 1;
+
+    static const std::string key = "\"segment\": \"";
+    size_t k = line.find(key);
+    if (k == std::string::npos) continue;
+    size_t start = k + key.size();
+    size_t quote = line.find('"', start);
+    if (quote == std::string::npos) continue;
+    if (util::file_exists(log_root + "/" + line.substr(start, quote - start))) {
+      kept += line + "\n";
+    }
+  }
+  if (kept.size() != content.size()) {
+    util::write_file(index_path.c_str(), kept.data(), kept.size(), O_WRONLY | O_CREAT | O_TRUNC, 0664);
+  }
+}
+
 static void log_sentinel(LoggerState *log, SentinelType type, int exit_signal = 0) {
   MessageBuilder msg;
   auto sen = msg.initEvent().initSentinel();
@@ -164,39 +316,189 @@ static void log_sentinel(LoggerState *log, SentinelType type, int exit_signal =
 LoggerState::LoggerState(const std::string &log_root) {
   route_name = logger_get_identifier("RouteCount");
   route_path = log_root + "/" + route_name;
+  index_path = log_root + "/" + UPLOAD_INDEX_NAME;
   init_data = logger_build_init_data();
+  if (LOGGERD_STAGED_RLOG) {
+    logger_recover_staged_rlogs(log_root);
+  }
+  compact_upload_index(log_root, index_path);
 }
 
 LoggerState::~LoggerState() {
+  discardPreparedSegment();
   if (rlog) {
+    writeQlogIndex();
     log_sentinel(this, SentinelType::END_OF_ROUTE, exit_signal);
+    if (rlog_stage) rlog_stage->finish(rlog.get());
     std::remove(lock_file.c_str());
+    finalizeSegment();
   }
 }
 
 bool LoggerState::next() {
   if (rlog) {
+    writeQlogIndex();
     log_sentinel(this, SentinelType::END_OF_SEGMENT);
+    if (rlog_stage) rlog_stage->finish(rlog.get());
     std::remove(lock_file.c_str());
+    rebalanceQlogBudget();
+    finalizeSegment();
+  }
+
+  // the prefetcher has usually staged the next segment already; the swap
+  // itself is then just moving the open writers in
+  PreparedSegment seg = next_segment.valid() ? next_segment.get() : prepareSegment(part + 1);
+  assert(seg.part == part + 1);
+  part = seg.part;
+  segment_path = std::move(seg.segment_path);
+  lock_file = std::move(seg.lock_file);
+  rlog = std::move(seg.rlog);
+  qlog = std::move(seg.qlog);
+
+  if (LOGGERD_STAGED_RLOG) {
+    rlog_stage.reset(new RlogStagingRing(segment_path));
   }
 
-  segment_path = route_path + "--" + std::to_string(++part);
-  bool ret = util::create_directories(segment_path, 0775);
+  // stage the following segment off the logging thread
+  next_segment = std::async(std::launch::async, &LoggerState::prepareSegment, this, part + 1);
+  return true;
+}
+
+LoggerState::PreparedSegment LoggerState::prepareSegment(int new_part) {
+  PreparedSegment seg;
+  seg.part = new_part;
+  seg.segment_path = route_path + "--" + std::to_string(new_part);
+  bool ret = util::create_directories(seg.segment_path, 0775);
   assert(ret == true);
 
-  lock_file = segment_path + "/rlog.lock";
-  std::ofstream{lock_file};
+  seg.lock_file = seg.segment_path + "/rlog.lock";
+  std::ofstream{seg.lock_file};
 
-  rlog.reset(new ZstdFileWriter(segment_path + "/rlog.zst", LOG_COMPRESSION_LEVEL));
-  qlog.reset(new ZstdFileWriter(segment_path + "/qlog.zst", LOG_COMPRESSION_LEVEL));
+  // rlog carries nearly all the bytes; compress it off the logging thread so
+  // CAN bursts aren't stalled behind zstd. preallocate roughly a segment's
+  // worth of compressed output so appends never block on extent allocation.
+  seg.rlog.reset(new ZstdFileWriter(seg.segment_path + "/rlog.zst", LOG_COMPRESSION_LEVEL, true, 32 * 1024 * 1024));
+  seg.qlog.reset(new ZstdFileWriter(seg.segment_path + "/qlog.zst", LOG_COMPRESSION_LEVEL, false, 1024 * 1024));
 
   // log init data & sentinel type.
-  write(init_data.asBytes(), true);
-  log_sentinel(this, part > 0 ? SentinelType::START_OF_SEGMENT : SentinelType::START_OF_ROUTE);
-  return true;
+  MessageBuilder msg;
+  auto sen = msg.initEvent().initSentinel();
+  sen.setType(new_part > 0 ? SentinelType::START_OF_SEGMENT : SentinelType::START_OF_ROUTE);
+  auto sentinel_bytes = msg.toBytes();
+  for (auto *log : {seg.rlog.get(), seg.qlog.get()}) {
+    log->write(init_data.asBytes());
+    log->write(sentinel_bytes.begin(), sentinel_bytes.size());
+  }
+  return seg;
+}
+
+// close the finished segment's writers and append its record to the upload
+// index. the record is only written once the log files are final, so the
+// uploader can trust indexed entries without a per-directory lock scan
+void LoggerState::finalizeSegment() {
+  rlog.reset();
+  qlog.reset();
+
+  auto file_size = [](const std::string &path) -> long long {
+    struct stat st = {};
+    return stat(path.c_str(), &st) == 0 ? (long long)st.st_size : 0;
+  };
+
+  char attr = 0;
+#ifdef __APPLE__
+  bool preserved = getxattr(segment_path.c_str(), PRESERVE_ATTR_NAME, &attr, 1, 0, 0) == 1 && attr == PRESERVE_ATTR_VALUE;
+#else
+  bool preserved = getxattr(segment_path.c_str(), PRESERVE_ATTR_NAME, &attr, 1) == 1 && attr == PRESERVE_ATTR_VALUE;
+#endif
+
+  std::string line = util::string_format("{\"segment\": \"%s--%d\", \"rlog\": %lld, \"qlog\": %lld, \"preserved\": %d}\n",
+                                         route_name.c_str(), part, file_size(segment_path + "/rlog.zst"),
+                                         file_size(segment_path + "/qlog.zst"), preserved);
+  util::write_file(index_path.c_str(), line.data(), line.size(), O_WRONLY | O_CREAT | O_APPEND, 0664);
+}
+
+// drop a staged-but-unused segment so shutdown doesn't leave an empty
+// directory for the uploader to trip over
+void LoggerState::discardPreparedSegment() {
+  if (!next_segment.valid()) return;
+
+  PreparedSegment seg = next_segment.get();
+  seg.rlog.reset();
+  seg.qlog.reset();
+  std::remove((seg.segment_path + "/rlog.zst").c_str());
+  std::remove((seg.segment_path + "/qlog.zst").c_str());
+  std::remove(seg.lock_file.c_str());
+  rmdir(seg.segment_path.c_str());
 }
 
 void LoggerState::write(uint8_t* data, size_t size, bool in_qlog) {
-  rlog->write(data, size);
-  if (in_qlog) qlog->write(data, size);
+  if (rlog_stage) {
+    rlog_stage->write(data, size, rlog.get());
+  } else {
+    rlog->write(data, size);
+  }
+  if (in_qlog) {
+    qlog->write(data, size);
+    qlog_window_bytes += size;
+    if (qlog_window_bytes >= QLOG_INDEX_INTERVAL) {
+      writeQlogIndex();
+    }
+  }
+}
+
+bool LoggerState::qlogShouldLog(const std::string &service, int decimation, size_t size) {
+  if (decimation == -1) return false;
+
+  QlogService &q = qlog_services[service];
+  bool in_qlog = (q.counter++ % (decimation * q.extra_decimation)) == 0;
+  if (in_qlog) {
+    q.segment_bytes += size;
+    q.window_count += 1;
+    q.window_bytes += size;
+  }
+  return in_qlog;
+}
+
+void LoggerState::writeQlogIndex() {
+  size_t n = 0;
+  for (const auto &[service, q] : qlog_services) n += (q.window_count > 0);
+  if (n == 0) return;
+
+  MessageBuilder msg;
+  auto index = msg.initEvent().initQlogIndex();
+  index.setWindowBytes(qlog_window_bytes);
+  auto entries = index.initEntries(n);
+  size_t i = 0;
+  for (auto &[service, q] : qlog_services) {
+    if (q.window_count == 0) continue;
+    entries[i].setService(service);
+    entries[i].setCount(q.window_count);
+    entries[i].setBytes(q.window_bytes);
+    q.window_count = 0;
+    q.window_bytes = 0;
+    ++i;
+  }
+
+  // the index goes to the qlog only and starts the next window
+  auto bytes = msg.toBytes();
+  qlog->write(bytes.begin(), bytes.size());
+  qlog_window_bytes = 0;
+}
+
+void LoggerState::rebalanceQlogBudget() {
+  if (qlog_services.empty()) return;
+
+  // services over a fair share of the segment budget get decimated harder
+  // next segment; ones that back off get their multiplier relaxed again.
+  // low-rate services stay under their share and are never touched.
+  const uint64_t fair_share = QLOG_SEGMENT_BUDGET / qlog_services.size();
+  for (auto &[service, q] : qlog_services) {
+    if (q.segment_bytes > 2 * fair_share && q.extra_decimation < 16) {
+      q.extra_decimation *= 2;
+      LOGD("qlog budget: %s used %" PRIu64 " bytes, extra decimation -> %d", service.c_str(), q.segment_bytes, q.extra_decimation);
+    } else if (q.segment_bytes < fair_share / 2 && q.extra_decimation > 1) {
+      q.extra_decimation /= 2;
+    }
+    q.segment_bytes = 0;
+  }
 }
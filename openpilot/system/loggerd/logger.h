@@ -1,8 +1,10 @@
 #pragma once
 
 #include <cassert>
+#include <future>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 #include "openpilot/cereal/messaging/messaging.h"
 #include "common/util.h"
@@ -10,9 +12,48 @@
 #include "system/loggerd/zstd_writer.h"
 
 constexpr int LOG_COMPRESSION_LEVEL = 10;
+// uncompressed qlog bytes per segment before high-rate services get extra decimation
+constexpr uint64_t QLOG_SEGMENT_BUDGET = 8 * 1024 * 1024;
+// uncompressed qlog bytes between in-stream QlogIndex records
+constexpr uint64_t QLOG_INDEX_INTERVAL = 1024 * 1024;
+
+// rlog staging ring (LOGGERD_STAGED_RLOG): events accumulate in a file-backed
+// mmap ring and only hit the compressor in RLOG_STAGE_BATCH batches; bytes
+// still in the ring after a crash are recovered on the next boot
+constexpr uint32_t RLOG_STAGE_MAGIC = 0x53474c52;  // "RLGS"
+constexpr size_t RLOG_STAGE_SIZE = 32 * 1024 * 1024;
+constexpr size_t RLOG_STAGE_BATCH = 4 * 1024 * 1024;
+
+// append-only upload index in the log root: one JSON line per finalized
+// segment (name, log sizes, preserve state), so the uploader schedules work
+// without walking every segment directory on disk
+constexpr char UPLOAD_INDEX_NAME[] = "upload_index.jsonl";
 
 typedef cereal::Sentinel::SentinelType SentinelType;
 
+class RlogStagingRing {
+public:
+  explicit RlogStagingRing(const std::string &segment_path);
+  ~RlogStagingRing();
+  // appends a length-prefixed record; drains a batch into out once enough has staged
+  void write(uint8_t *data, size_t size, ZstdFileWriter *out);
+  // drain everything and delete the stage file
+  void finish(ZstdFileWriter *out);
+
+private:
+  struct Header {
+    uint32_t magic;
+    uint32_t pad;
+    uint64_t head, tail;  // monotonically increasing byte offsets
+  };
+  void append(const void *data, size_t size);
+  void flush(ZstdFileWriter *out);
+
+  std::string path_;
+  Header *hdr_ = nullptr;
+  uint8_t *data_ = nullptr;
+};
+
 class LoggerState {
 public:
   LoggerState(const std::string& log_root = Path::log_root());
@@ -24,14 +65,48 @@ public:
   inline const std::string& routeName() const { return route_name; }
   inline void write(kj::ArrayPtr<kj::byte> bytes, bool in_qlog) { write(bytes.begin(), bytes.size(), in_qlog); }
   inline void setExitSignal(int signal) { exit_signal = signal; }
+  // budget-aware qlog decimation: applies the static services.py decimation,
+  // plus a per-service multiplier adjusted at rotation so a segment's qlog
+  // stays near QLOG_SEGMENT_BUDGET without touching low-rate services
+  bool qlogShouldLog(const std::string &service, int decimation, size_t size);
 
 protected:
+  struct QlogService {
+    int counter = 0;
+    int extra_decimation = 1;
+    uint64_t segment_bytes = 0;
+    // accumulated since the last QlogIndex record
+    uint32_t window_count = 0;
+    uint64_t window_bytes = 0;
+  };
+  void rebalanceQlogBudget();
+  // appends a QlogIndex event describing the window since the last one (or
+  // segment start) and resets the window counters; no-op on an empty window
+  void writeQlogIndex();
+
+  // a segment staged by the background prefetcher: directory created, lock
+  // file written, log files open with init data + sentinel already in them,
+  // so next() only has to swap pointers
+  struct PreparedSegment {
+    int part = -1;
+    std::string segment_path, lock_file;
+    std::unique_ptr<ZstdFileWriter> rlog, qlog;
+  };
+  PreparedSegment prepareSegment(int part);
+  void discardPreparedSegment();
+  void finalizeSegment();
+
   int part = -1, exit_signal = 0;
-  std::string route_path, route_name, segment_path, lock_file;
+  std::string route_path, route_name, segment_path, lock_file, index_path;
   kj::Array<capnp::word> init_data;
   std::unique_ptr<ZstdFileWriter> rlog, qlog;
+  std::unique_ptr<RlogStagingRing> rlog_stage;
+  std::unordered_map<std::string, QlogService> qlog_services;
+  std::future<PreparedSegment> next_segment;
+  uint64_t qlog_window_bytes = 0;
 };
 
 kj::Array<capnp::word> logger_build_init_data();
 std::string logger_get_identifier(std::string key);
 std::string zstd_decompress(const std::string &in);
+void logger_recover_staged_rlogs(const std::string &log_root);
@@ -7,6 +7,8 @@
 #include <vector>
 
 #include "common/params.h"
+#include "common/self_metrics.h"
+#include "common/trace.h"
 #include "system/loggerd/encoder/encoder.h"
 #include "system/loggerd/loggerd.h"
 #include "system/loggerd/video_writer.h"
@@ -22,6 +24,7 @@ struct LoggerdState {
 };
 
 void logger_rotate(LoggerdState *s) {
+  OP_TRACE_SPAN("logger_rotate");
   bool ret =s->logger.next();
   assert(ret);
   s->ready_to_rotate = 0;
@@ -221,7 +224,7 @@ void loggerd_thread() {
   // setup messaging
   struct ServiceState {
     std::string name;
-    int counter, freq;
+    int freq;
     bool encoder, preserve_segment, record_audio;
   };
   std::unordered_map<SubSocket*, ServiceState> service_state;
@@ -243,7 +246,6 @@ void loggerd_thread() {
       poller->registerSocket(sock);
       service_state[sock] = {
         .name = it.name,
-        .counter = 0,
         .freq = it.decimation,
         .encoder = encoder,
         .preserve_segment = (it.name == "userBookmark") || (it.name == "audioFeedback"),
@@ -289,7 +291,7 @@ void loggerd_thread() {
       int count = 0;
       Message *msg = nullptr;
       while (!do_exit && (msg = sock->receive(true))) {
-        const bool in_qlog = service.freq != -1 && (service.counter++ % service.freq == 0);
+        const bool in_qlog = s.logger.qlogShouldLog(service.name, service.freq, msg->getSize());
 
         if (service.record_audio) {
           capnp::FlatArrayMessageReader cmsg(kj::ArrayPtr<capnp::word>((capnp::word *)msg->getData(), msg->getSize() / sizeof(capnp::word)));
@@ -352,7 +354,9 @@ int main(int argc, char** argv) {
     //assert(ret == 0);
   }
 
+  self_metrics::start("loggerd");
   loggerd_thread();
+  self_metrics::stop();
 
   return 0;
 }
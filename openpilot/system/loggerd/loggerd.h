@@ -28,6 +28,31 @@ const int SEGMENT_LENGTH = LOGGERD_TEST ? atoi(getenv("LOGGERD_SEGMENT_LENGTH"))
 constexpr char PRESERVE_ATTR_NAME[] = "user.preserve";
 constexpr char PRESERVE_ATTR_VALUE = '1';
 
+// runtime-selectable qcamera encode ladder: the QcamEncodeProfile param picks
+// a preset by name and encoderd applies it at segment rotation, so per-vehicle
+// upload cost is tunable without a rebuild. "medium" matches the historical
+// fixed qcam settings and is the fallback for unset or unknown values.
+struct QcamProfile {
+  const char *name;
+  int frame_width;
+  int frame_height;
+  int bitrate;
+  int gop_size;
+};
+
+constexpr QcamProfile QCAM_PROFILES[] = {
+  {.name = "low", .frame_width = 400, .frame_height = 250, .bitrate = 128'000, .gop_size = 30},
+  {.name = "medium", .frame_width = 526, .frame_height = 330, .bitrate = 256'000, .gop_size = 15},
+  {.name = "high", .frame_width = 788, .frame_height = 494, .bitrate = 512'000, .gop_size = 15},
+};
+
+inline const QcamProfile &get_qcam_profile(const std::string &name) {
+  for (const auto &profile : QCAM_PROFILES) {
+    if (name == profile.name) return profile;
+  }
+  return QCAM_PROFILES[1];  // medium
+}
+
 struct EncoderSettings {
   cereal::EncodeIndex::Type encode_type;
   int bitrate;
@@ -42,8 +67,8 @@ struct EncoderSettings {
     }
   }
 
-  static EncoderSettings QcamEncoderSettings() {
-    return EncoderSettings{.encode_type = cereal::EncodeIndex::Type::QCAMERA_H264, .bitrate = 256'000, .gop_size = 15};
+  static EncoderSettings QcamEncoderSettings(const QcamProfile &profile) {
+    return EncoderSettings{.encode_type = cereal::EncodeIndex::Type::QCAMERA_H264, .bitrate = profile.bitrate, .gop_size = profile.gop_size};
   }
 
   static EncoderSettings StreamEncoderSettings() {
@@ -60,9 +85,14 @@ public:
   bool record = true;
   bool include_audio = false;
   bool is_live = false;
+  bool is_qcam = false;  // follows the QcamEncodeProfile ladder
   int frame_width = -1;
   int frame_height = -1;
   int fps = MAIN_FPS;
+  // cores to pin this encoder's threads to (empty = scheduler's choice); the
+  // camera thread follows its primary encoder so the three hardware encode
+  // pipelines can be spread across cores independently
+  std::vector<int> affinity;
   std::function<EncoderSettings(int)> get_settings;
 
   ::cereal::EncodeData::Reader (cereal::Event::Reader::*get_encode_data_func)() const;
@@ -130,28 +160,48 @@ const EncoderInfo qcam_encoder_info = {
   .publish_name = "qRoadEncodeData",
   .filename = "qcamera.ts",
   .include_audio = Params().getBool("RecordAudio"),
+  .is_qcam = true,
   .frame_width = 526,
   .frame_height = 330,
-  .get_settings = [](int){return EncoderSettings::QcamEncoderSettings();},
+  .get_settings = [](int){return EncoderSettings::QcamEncoderSettings(get_qcam_profile("medium"));},
   INIT_ENCODE_FUNCTIONS(QRoadEncode),
 };
 
+// qcam EncoderInfo with the given profile's geometry and rate settings applied
+inline EncoderInfo with_qcam_profile(EncoderInfo info, const QcamProfile &profile) {
+  info.frame_width = profile.frame_width;
+  info.frame_height = profile.frame_height;
+  info.get_settings = [&profile](int) { return EncoderSettings::QcamEncoderSettings(profile); };
+  return info;
+}
+
+// with EnableSubstreamEncoders set, the main encoderd also opens the
+// low-bitrate livestream session per camera on the same VisionIpc input
+// buffers; the frames are then encoded twice in hardware but only fetched
+// from memory once, and no separate stream_encoderd process is needed
+inline std::vector<EncoderInfo> with_substream(std::vector<EncoderInfo> infos, const EncoderInfo &substream_info) {
+  if (Params().getBool("EnableSubstreamEncoders")) {
+    infos.push_back(substream_info);
+  }
+  return infos;
+}
+
 const LogCameraInfo road_camera_info{
   .thread_name = "road_cam_encoder",
   .stream_type = VISION_STREAM_ROAD,
-  .encoder_infos = {main_road_encoder_info, qcam_encoder_info}
+  .encoder_infos = with_substream({main_road_encoder_info, qcam_encoder_info}, stream_road_encoder_info)
 };
 
 const LogCameraInfo wide_road_camera_info{
   .thread_name = "wide_road_cam_encoder",
   .stream_type = VISION_STREAM_WIDE_ROAD,
-  .encoder_infos = {main_wide_road_encoder_info}
+  .encoder_infos = with_substream({main_wide_road_encoder_info}, stream_wide_road_encoder_info)
 };
 
 const LogCameraInfo driver_camera_info{
   .thread_name = "driver_cam_encoder",
   .stream_type = VISION_STREAM_DRIVER,
-  .encoder_infos = {main_driver_encoder_info}
+  .encoder_infos = with_substream({main_driver_encoder_info}, stream_driver_encoder_info)
 };
 
 const LogCameraInfo stream_road_camera_info{
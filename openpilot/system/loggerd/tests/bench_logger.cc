@@ -0,0 +1,110 @@
+// Benchmark for the LoggerState + ZstdFileWriter stack.
+//
+// Drives a real logger with a synthetic service mix modeled on fleet
+// traffic at a configurable multiple of real-time and reports events/sec,
+// bytes/sec, and write-stall percentiles, so storage and compression
+// changes can be compared before they ship.
+//
+//   ./bench_logger [seconds-of-traffic] [realtime-multiple]
+
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "common/timing.h"
+#include "common/util.h"
+#include "system/loggerd/logger.h"
+
+struct SyntheticService {
+  const char *name;
+  int hz;
+  size_t bytes;  // typical serialized event size
+  int decimation;
+};
+
+// rough fleet mix: CAN dominates byte volume, modelV2 dominates single-event size
+const SyntheticService SERVICE_MIX[] = {
+  {"can",             100, 2200, 2053},
+  {"sendcan",         100,  600,  -1},
+  {"carState",        100,  400,  10},
+  {"carControl",      100,  300,  10},
+  {"modelV2",          20, 18000, 40},
+  {"drivingModelData", 20,  1200, 10},
+  {"livePose",         20,   600,  4},
+  {"longitudinalPlan", 20,   800, 10},
+  {"cameraOdometry",   20,   400, 10},
+  {"accelerometer",   104,   200, 104},
+  {"gyroscope",       104,   200, 104},
+  {"deviceState",       2,  1200,  1},
+};
+
+int main(int argc, char *argv[]) {
+  int duration_s = argc > 1 ? atoi(argv[1]) : 60;
+  int multiple = argc > 2 ? atoi(argv[2]) : 1;
+  assert(duration_s > 0 && multiple > 0);
+
+  char tmp_path[] = "/tmp/bench_logger_XXXXXX";
+  assert(mkdtemp(tmp_path) != nullptr);
+
+  // one payload buffer per service, filled with compressible-but-not-trivial data
+  std::vector<std::vector<uint8_t>> payloads;
+  for (const auto &svc : SERVICE_MIX) {
+    std::vector<uint8_t> buf(svc.bytes);
+    for (size_t i = 0; i < buf.size(); ++i) {
+      buf[i] = (uint8_t)((i * 7) ^ (i >> 3));
+    }
+    payloads.push_back(std::move(buf));
+  }
+
+  uint64_t total_events = 0, total_bytes = 0;
+  std::vector<double> write_ms;
+  write_ms.reserve(duration_s * 1000);
+
+  double start = millis_since_boot();
+  {
+    LoggerState logger(tmp_path);
+    logger.next();
+
+    // step simulated time in 10ms ticks; each tick emits the events every
+    // service would have produced, scaled by the real-time multiple
+    const int ticks = duration_s * 100;
+    for (int tick = 0; tick < ticks; ++tick) {
+      for (size_t i = 0; i < std::size(SERVICE_MIX); ++i) {
+        const auto &svc = SERVICE_MIX[i];
+        int events = (svc.hz * multiple) / 100 + ((tick % 100) < (svc.hz * multiple) % 100 ? 1 : 0);
+        for (int e = 0; e < events; ++e) {
+          bool in_qlog = logger.qlogShouldLog(svc.name, svc.decimation, payloads[i].size());
+
+          double t0 = millis_since_boot();
+          logger.write(payloads[i].data(), payloads[i].size(), in_qlog);
+          write_ms.push_back(millis_since_boot() - t0);
+
+          total_events++;
+          total_bytes += payloads[i].size();
+        }
+      }
+      // segment rotation at the logger's normal cadence (in simulated time)
+      if (tick > 0 && (tick % (60 * 100)) == 0) {
+        logger.next();
+      }
+    }
+  }
+  double wall_s = (millis_since_boot() - start) / 1000.0;
+
+  std::sort(write_ms.begin(), write_ms.end());
+  auto pct = [&](double p) { return write_ms[std::min(write_ms.size() - 1, (size_t)(p * write_ms.size()))]; };
+
+  printf("simulated %ds of traffic at %dx in %.2fs wall\n", duration_s, multiple, wall_s);
+  printf("  %" PRIu64 " events, %.0f events/sec, %.2f MB/sec\n",
+         total_events, total_events / wall_s, total_bytes / wall_s / 1e6);
+  printf("  write stall: p50 %.3fms  p99 %.3fms  p99.9 %.3fms  max %.3fms\n",
+         pct(0.50), pct(0.99), pct(0.999), write_ms.back());
+
+  std::string cleanup = "rm -rf " + std::string(tmp_path);
+  std::system(cleanup.c_str());
+  return 0;
+}
@@ -23,6 +23,9 @@ NetworkType = log.DeviceState.NetworkType
 UPLOAD_ATTR_NAME = 'user.upload'
 UPLOAD_ATTR_VALUE = b'1'
 
+# written by LoggerState at rotation: one JSON line per finalized segment
+UPLOAD_INDEX_NAME = "upload_index.jsonl"
+
 MAX_UPLOAD_SIZES = {
   "qlog": 25*1e6,  # can't be too restrictive here since we use qlogs to find
                    # bugs, including ones that can cause massive log sizes
@@ -62,6 +65,21 @@ def listdir_by_creation(d: str) -> list[str]:
     cloudlog.exception("listdir_by_creation failed")
     return []
 
+def read_upload_index(root: str) -> list[dict]:
+  entries = []
+  try:
+    with open(os.path.join(root, UPLOAD_INDEX_NAME)) as f:
+      for line in f:
+        try:
+          e = json.loads(line)
+        except ValueError:
+          continue
+        if "segment" in e:
+          entries.append(e)
+  except OSError:
+    pass
+  return entries
+
 def clear_locks(root: str) -> None:
   for logdir in os.listdir(root):
     path = os.path.join(root, logdir)
@@ -91,17 +109,32 @@ class Uploader:
     r = self.params.get("AthenadRecentlyViewedRoutes")
     requested_routes = [] if r is None else [route for route in r.split(",") if route]
 
-    for logdir in listdir_by_creation(self.root):
+    # segments finalized by loggerd come straight from the index with no
+    # per-directory listing; everything else (crash/, boot/, segments from
+    # before the index existed) still goes through the directory walk
+    index = read_upload_index(self.root)
+    indexed = {e["segment"] for e in index}
+    candidates: list[tuple[str, list[str] | None]] = [(e["segment"], ["qlog.zst", "qcamera.ts"]) for e in index]
+    candidates += [(d, None) for d in listdir_by_creation(self.root) if d not in indexed]
+
+    for logdir, index_names in candidates:
       path = os.path.join(self.root, logdir)
-      try:
-        names = os.listdir(path)
-      except OSError:
-        continue
+      if index_names is None:
+        try:
+          names = os.listdir(path)
+        except OSError:
+          continue
 
-      if any(name.endswith(".lock") for name in names):
-        continue
+        if any(name.endswith(".lock") for name in names):
+          continue
+        names = sorted(names, key=lambda n: self.immediate_priority.get(n, 1000))
+      else:
+        # rlog/qlog were final when the index entry was appended, but the
+        # encoder can still be closing qcamera.ts right after rotation
+        names = [n for n in index_names
+                 if os.path.exists(os.path.join(path, n)) and not os.path.exists(os.path.join(path, n + ".lock"))]
 
-      for name in sorted(names, key=lambda n: self.immediate_priority.get(n, 1000)):
+      for name in names:
         key = os.path.join(logdir, name)
         fn = os.path.join(path, name)
         # skip files already uploaded
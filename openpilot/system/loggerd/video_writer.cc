@@ -40,13 +40,85 @@ VideoWriter::VideoWriter(const char *path, const char *filename, bool remuxing,
     this->out_stream = avformat_new_stream(this->ofmt_ctx, raw ? avcodec : NULL);
     assert(this->out_stream);
 
-    int err = avio_open(&this->ofmt_ctx->pb, this->vid_path.c_str(), AVIO_FLAG_WRITE);
-    assert(err >= 0);
+    // custom AVIO with a large buffer so muxed output coalesces into 1MB
+    // writes instead of one syscall per packet
+    out_fd = HANDLE_EINTR(open(this->vid_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0664));
+    assert(out_fd >= 0);
+    uint8_t *avio_buf = (uint8_t *)av_malloc(MUX_BUF_SIZE);
+    assert(avio_buf);
+    this->avio_ctx = avio_alloc_context(avio_buf, MUX_BUF_SIZE, 1, this, NULL, &VideoWriter::avio_write, &VideoWriter::avio_seek);
+    assert(this->avio_ctx);
+    this->ofmt_ctx->pb = this->avio_ctx;
 
   } else {
     this->of = util::safe_fopen(this->vid_path.c_str(), "wb");
     assert(this->of);
   }
+
+  mux_thread = std::thread(&VideoWriter::mux_thread_func, this);
+}
+
+#if LIBAVFORMAT_VERSION_MAJOR >= 61
+int VideoWriter::avio_write(void *opaque, const uint8_t *buf, int buf_size) {
+#else
+int VideoWriter::avio_write(void *opaque, uint8_t *buf, int buf_size) {
+#endif
+  VideoWriter *w = (VideoWriter *)opaque;
+  int written = 0;
+  while (written < buf_size) {
+    ssize_t n = HANDLE_EINTR(::write(w->out_fd, buf + written, buf_size - written));
+    if (n <= 0) {
+      LOGE("video write failed, errno=%d", errno);
+      return AVERROR(EIO);
+    }
+    written += n;
+  }
+  return written;
+}
+
+int64_t VideoWriter::avio_seek(void *opaque, int64_t offset, int whence) {
+  VideoWriter *w = (VideoWriter *)opaque;
+  if (whence == AVSEEK_SIZE) return -1;
+  return lseek(w->out_fd, offset, whence);
+}
+
+void VideoWriter::mux_thread_func() {
+  util::set_thread_name("video_writer");
+
+  while (true) {
+    MuxJob job;
+    bool has_job = mux_q.try_pop(job, 20);
+
+    // drain all staged audio in one batch so a burst of capture-rate packets
+    // costs one pass through the encoder instead of interleaving with video
+    MuxJob audio_job;
+    while (audio_q.try_pop(audio_job)) {
+      write_audio_packet(audio_job.data.data(), audio_job.data.size(), audio_job.timestamp, audio_job.sample_rate);
+    }
+
+    if (!has_job) continue;
+    if (job.type == MuxJob::EXIT) break;
+    write_video_packet(job.data.data(), job.data.size(), job.timestamp, job.codecconfig, job.keyframe);
+  }
+}
+
+void VideoWriter::write(uint8_t *data, int len, long long timestamp, bool codecconfig, bool keyframe) {
+  MuxJob job;
+  job.type = MuxJob::VIDEO;
+  if (data && len > 0) job.data.assign(data, data + len);
+  job.timestamp = timestamp;
+  job.codecconfig = codecconfig;
+  job.keyframe = keyframe;
+  mux_q.push(job);
+}
+
+void VideoWriter::write_audio(uint8_t *data, int len, long long timestamp, int sample_rate) {
+  MuxJob job;
+  job.type = MuxJob::AUDIO;
+  if (data && len > 0) job.data.assign(data, data + len);
+  job.timestamp = timestamp;
+  job.sample_rate = sample_rate;
+  audio_q.push(job);
 }
 
 void VideoWriter::initialize_audio(int sample_rate) {
@@ -88,7 +160,7 @@ void VideoWriter::initialize_audio(int sample_rate) {
   assert(err >= 0);
 }
 
-void VideoWriter::write(uint8_t *data, int len, long long timestamp, bool codecconfig, bool keyframe) {
+void VideoWriter::write_video_packet(uint8_t *data, int len, long long timestamp, bool codecconfig, bool keyframe) {
   if (of && data) {
     size_t written = util::safe_fwrite(data, 1, len, of);
     if (written != len) {
@@ -135,7 +207,7 @@ void VideoWriter::write(uint8_t *data, int len, long long timestamp, bool codecc
   }
 }
 
-void VideoWriter::write_audio(uint8_t *data, int len, long long timestamp, int sample_rate) {
+void VideoWriter::write_audio_packet(uint8_t *data, int len, long long timestamp, int sample_rate) {
   if (!remuxing) return;
   if (!audio_initialized) {
     initialize_audio(sample_rate);
@@ -212,6 +284,9 @@ void VideoWriter::process_remaining_audio() {
 }
 
 VideoWriter::~VideoWriter() {
+  mux_q.push(MuxJob{});  // EXIT
+  mux_thread.join();
+
   if (this->remuxing) {
     if (this->audio_codec_ctx) {
       process_remaining_audio();
@@ -222,8 +297,11 @@ VideoWriter::~VideoWriter() {
     if (err != 0) LOGE("av_write_trailer failed %d", err);
     avcodec_free_context(&this->codec_ctx);
     if (this->audio_frame) av_frame_free(&this->audio_frame);
-    err = avio_closep(&this->ofmt_ctx->pb);
-    if (err != 0) LOGE("avio_closep failed %d", err);
+    avio_flush(this->avio_ctx);
+    av_freep(&this->avio_ctx->buffer);
+    avio_context_free(&this->avio_ctx);
+    this->ofmt_ctx->pb = nullptr;
+    close(out_fd);
     avformat_free_context(this->ofmt_ctx);
   } else {
     util::safe_fflush(this->of);
@@ -2,6 +2,8 @@
 
 #include <string>
 #include <deque>
+#include <thread>
+#include <vector>
 
 extern "C" {
 #include <libavformat/avformat.h>
@@ -9,20 +11,42 @@ extern "C" {
 }
 
 #include "openpilot/cereal/messaging/messaging.h"
+#include "common/queue.h"
 
 class VideoWriter {
 public:
   VideoWriter(const char *path, const char *filename, bool remuxing, int width, int height, int fps, cereal::EncodeIndex::Type codec);
+  // both just enqueue a copy of the packet; muxing, encoding, and file I/O
+  // happen on the internal mux thread so camera packet bursts never back up
+  // the loggerd message loop
   void write(uint8_t *data, int len, long long timestamp, bool codecconfig, bool keyframe);
   void write_audio(uint8_t *data, int len, long long timestamp, int sample_rate);
 
   ~VideoWriter();
 
 private:
+  struct MuxJob {
+    enum Type { VIDEO, AUDIO, EXIT } type = EXIT;
+    std::vector<uint8_t> data;
+    long long timestamp = 0;
+    bool codecconfig = false, keyframe = false;
+    int sample_rate = 0;
+  };
+
+  void mux_thread_func();
+  void write_video_packet(uint8_t *data, int len, long long timestamp, bool codecconfig, bool keyframe);
+  void write_audio_packet(uint8_t *data, int len, long long timestamp, int sample_rate);
   void initialize_audio(int sample_rate);
   void encode_and_write_audio_frame(AVFrame* frame);
   void process_remaining_audio();
 
+#if LIBAVFORMAT_VERSION_MAJOR >= 61
+  static int avio_write(void *opaque, const uint8_t *buf, int buf_size);
+#else
+  static int avio_write(void *opaque, uint8_t *buf, int buf_size);
+#endif
+  static int64_t avio_seek(void *opaque, int64_t offset, int whence);
+
   std::string vid_path, lock_path;
   FILE *of = nullptr;
 
@@ -30,6 +54,18 @@ private:
   AVFormatContext *ofmt_ctx;
   AVStream *out_stream;
 
+  // muxed output coalesces in this AVIO buffer and hits the disk in 1MB writes
+  static constexpr int MUX_BUF_SIZE = 1024 * 1024;
+  AVIOContext *avio_ctx = nullptr;
+  int out_fd = -1;
+
+  SafeQueue<MuxJob> mux_q;
+  // audio is staged on its own queue so capture-rate packets never wait
+  // behind queued video; the mux thread drains all staged audio in one batch
+  // per iteration
+  SafeQueue<MuxJob> audio_q;
+  std::thread mux_thread;
+
   bool audio_initialized = false;
   bool header_written = false;
   AVStream *audio_stream = nullptr;
@@ -2,23 +2,51 @@
 
 #include <zstd.h>
 
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include <capnp/common.h>
 
 class ZstdFileWriter {
 public:
-  ZstdFileWriter(const std::string &filename, int compression_level);
+  // async moves compression and file I/O to an internal worker thread with
+  // double-buffered input chunks; write() then only appends and swaps, so the
+  // caller is never stalled by zstd unless the worker falls a full chunk behind.
+  // prealloc reserves that many bytes with fallocate at open; with
+  // LOGGERD_DIRECT_IO set, output additionally bypasses the page cache (O_DIRECT).
+  ZstdFileWriter(const std::string &filename, int compression_level, bool async = false, size_t prealloc = 0);
   ~ZstdFileWriter();
   void write(void* data, size_t size);
   inline void write(kj::ArrayPtr<capnp::byte> array) { write(array.begin(), array.size()); }
 
 private:
   void flushCache(bool last_chunk);
+  void compressChunk(std::vector<char> &buf, bool last_chunk);
+  void writeOut(const char *data, size_t size);
+  void submitCache();
+  void workerThread();
+
+  static constexpr size_t DIO_ALIGN = 4096;
+  static constexpr size_t DIO_BUF_SIZE = 1024 * 1024;
 
   size_t input_cache_capacity_ = 0;
   std::vector<char> input_cache_;
   std::vector<char> output_buffer_;
   ZSTD_CStream *cstream_;
   FILE* file_ = nullptr;
+
+  bool direct_ = false;
+  int fd_ = -1;
+  char *dio_buf_ = nullptr;
+  size_t dio_fill_ = 0;
+
+  bool async_ = false;
+  bool worker_exit_ = false;
+  std::vector<char> pending_cache_;  // full chunk awaiting compression
+  bool pending_valid_ = false;
+  std::mutex lock_;
+  std::condition_variable cv_;
+  std::thread worker_;
 };
@@ -1,4 +1,6 @@
 #!/usr/bin/env python3
+import json
+import struct
 import zmq
 from typing import NoReturn
 
@@ -7,6 +9,52 @@ from openpilot.common.logging_extra import SwagLogFileFormatter
 from openpilot.common.hardware.hw import Paths
 from openpilot.common.swaglog import get_file_handler
 
+# swaglog.cc's compact binary framing (SWAGLOG_BINARY=1): 0xD1 frames carry a
+# JSON dictionary interning a callsite's static fields, 0xD2 frames reference
+# it by id and carry only level, timestamp and message. They are reassembled
+# into the plain JSON record here so rlogs and log files keep the same format
+# either way.
+DICT_FRAME = 0xD1
+MSG_FRAME = 0xD2
+
+
+def decode_binary_frame(dat: bytes, dicts: dict) -> tuple[int, str] | None:
+  """Returns (level, record) for a message frame, None for a dictionary frame."""
+  if dat[0] == DICT_FRAME:
+    d = json.loads(dat[1:].decode("utf-8"))
+    dicts[d["id"]] = d
+    return None
+
+  # 0xD2: varint dictionary id, level byte, little-endian double created, raw msg
+  pos = 1
+  dict_id = 0
+  shift = 0
+  while dat[pos] & 0x80:
+    dict_id |= (dat[pos] & 0x7f) << shift
+    shift += 7
+    pos += 1
+  dict_id |= dat[pos] << shift
+  pos += 1
+  level = dat[pos]
+  pos += 1
+  created = struct.unpack("<d", dat[pos:pos + 8])[0]
+  pos += 8
+  msg = dat[pos:].decode("utf-8", "replace")
+
+  # the dictionary frame can be lost if it was dropped from the spill ring;
+  # keep the message rather than dropping it with its metadata
+  d = dicts.get(dict_id, {})
+  record = json.dumps({
+    "msg": msg,
+    "ctx": d.get("ctx", {}),
+    "levelnum": level,
+    "filename": d.get("filename", ""),
+    "lineno": d.get("lineno", 0),
+    "funcname": d.get("funcname", ""),
+    "created": created,
+  })
+  return level, record
+
 
 def main() -> NoReturn:
   log_handler = get_file_handler()
@@ -21,11 +69,19 @@ def main() -> NoReturn:
   log_message_sock = messaging.pub_sock('logMessage')
   error_log_message_sock = messaging.pub_sock('errorLogMessage')
 
+  dicts: dict = {}
+
   try:
     while True:
       dat = b''.join(sock.recv_multipart())
       level = dat[0]
-      record = dat[1:].decode("utf-8")
+      if level in (DICT_FRAME, MSG_FRAME):
+        decoded = decode_binary_frame(dat, dicts)
+        if decoded is None:
+          continue
+        level, record = decoded
+      else:
+        record = dat[1:].decode("utf-8")
       if level >= log_level:
         log_handler.emit(record)
 
@@ -16,6 +16,7 @@ from openpilot.common.hardware import HARDWARE
 from openpilot.system.manager.helpers import unblock_stdout, save_bootlog
 from openpilot.system.manager.process import ensure_running
 from openpilot.system.manager.process_config import managed_processes
+from openpilot.system.manager.zygote import zygote
 from openpilot.system.athena.registration import register, UNREGISTERED_DONGLE_ID
 from openpilot.common.swaglog import cloudlog, add_file_handler
 from openpilot.common.version import get_build_metadata
@@ -87,7 +88,10 @@ def manager_init() -> None:
                        dirty=build_metadata.openpilot.is_dirty,
                        device=HARDWARE.get_device_type())
 
-  # preimport all processes
+  # fork the zygote now that env and logging are set up; python daemons fork
+  # from its warm image and import their own module post-fork, so startup
+  # isn't gated on a serial preimport of every process
+  zygote.start()
   for p in managed_processes.values():
     p.prepare()
 
@@ -101,6 +105,9 @@ def manager_cleanup() -> None:
   for p in managed_processes.values():
     p.stop(block=True)
 
+  # stop() still polls exit codes through the zygote, so it goes down last
+  zygote.stop()
+
   cloudlog.info("everything is dead")
 
 
@@ -16,6 +16,7 @@ import openpilot.system.sentry as sentry
 from openpilot.common.basedir import BASEDIR
 from openpilot.common.params import Params
 from openpilot.common.swaglog import cloudlog
+from openpilot.system.manager.zygote import zygote, ZygoteChild
 
 
 def launcher(proc: str, name: str) -> None:
@@ -52,7 +53,7 @@ def nativelauncher(pargs: list[str], cwd: str, name: str) -> None:
   os.execvp(pargs[0], pargs)
 
 
-def join_process(process: Process, timeout: float) -> None:
+def join_process(process: Process | ZygoteChild, timeout: float) -> None:
   # Process().join(timeout) will hang due to a python 3 bug: https://bugs.python.org/issue28382
   # We have to poll the exitcode instead
   t = time.monotonic()
@@ -64,7 +65,7 @@ class ManagerProcess(ABC):
   daemon = False
   sigkill = False
   should_run: Callable[[bool, Params, car.CarParams], bool]
-  proc: Process | None = None
+  proc: Process | ZygoteChild | None = None
   enabled = True
   name = ""
   shutting_down = False
@@ -179,7 +180,8 @@ class PythonProcess(ManagerProcess):
     self.restart_if_crash = restart_if_crash
 
   def prepare(self) -> None:
-    if self.enabled:
+    # with a zygote the module is imported after the fork, in the child
+    if self.enabled and not zygote.is_running():
       cloudlog.info(f"preimporting {self.module}")
       importlib.import_module(self.module)
 
@@ -191,6 +193,15 @@ class PythonProcess(ManagerProcess):
     if self.proc is not None:
       return
 
+    if zygote.is_running():
+      try:
+        self.proc = zygote.spawn(self.module, self.name)
+        cloudlog.info(f"started python {self.module} from zygote with pid {self.proc.pid}")
+        self.shutting_down = False
+        return
+      except (OSError, EOFError):
+        cloudlog.exception(f"zygote spawn of {self.module} failed, falling back to fork")
+
     cloudlog.info(f"starting python {self.module}")
     self.proc = Process(name=self.name, target=self.launcher, args=(self.module, self.name))
     self.proc.start()
@@ -0,0 +1,177 @@
+import os
+import pickle
+import socket
+import struct
+import time
+
+from openpilot.common.swaglog import cloudlog
+
+# Preforked launcher for python daemons. manager forks the zygote once its
+# params/registration/logging state is set up, the zygote warms the shared
+# import graph (capnp, numpy, messaging), and every python daemon is then
+# forked from that warm image on request. Each daemon's own module is imported
+# after the fork, in the child, so per-daemon import cost is paid in parallel
+# across daemons instead of serially in manager_init before anything starts.
+
+
+def _send_obj(sock: socket.socket, obj) -> None:
+  data = pickle.dumps(obj)
+  sock.sendall(struct.pack("<I", len(data)) + data)
+
+
+def _recv_obj(sock: socket.socket):
+  buf = b""
+  while len(buf) < 4:
+    chunk = sock.recv(4 - len(buf))
+    if not chunk:
+      raise EOFError
+    buf += chunk
+  length = struct.unpack("<I", buf)[0]
+  data = b""
+  while len(data) < length:
+    chunk = sock.recv(length - len(data))
+    if not chunk:
+      raise EOFError
+    data += chunk
+  return pickle.loads(data)
+
+
+def _serve(sock: socket.socket) -> None:
+  from setproctitle import setproctitle
+  setproctitle("zygote")
+
+  # warm the imports every daemon needs before the first spawn request; the
+  # daemon-specific modules stay out so the image doesn't pin their state
+  import capnp  # noqa
+  import numpy  # noqa
+  import openpilot.cereal.messaging  # noqa
+  from openpilot.system.manager.process import launcher
+
+  exitcodes: dict[int, int] = {}
+  while True:
+    try:
+      req = _recv_obj(sock)
+    except EOFError:
+      # manager is gone; running daemons are reparented and stay up
+      return
+
+    if req[0] == "spawn":
+      _, module, name = req
+      pid = os.fork()
+      if pid == 0:
+        sock.close()
+        code = 0
+        try:
+          launcher(module, name)
+        except SystemExit as e:
+          code = e.code if isinstance(e.code, int) else 1
+        except Exception:
+          # launcher already reported it to sentry
+          code = 1
+        os._exit(code)
+      _send_obj(sock, pid)
+    elif req[0] == "poll":
+      pid = req[1]
+      if pid not in exitcodes:
+        try:
+          wpid, status = os.waitpid(pid, os.WNOHANG)
+          if wpid == pid:
+            exitcodes[pid] = os.waitstatus_to_exitcode(status)
+        except ChildProcessError:
+          exitcodes[pid] = 0
+      _send_obj(sock, exitcodes.get(pid))
+
+
+class ZygoteChild:
+  """Duck-types the bits of multiprocessing.Process that ManagerProcess uses."""
+
+  def __init__(self, zygote: 'Zygote', pid: int):
+    self._zygote = zygote
+    self._exitcode: int | None = None
+    self.pid = pid
+
+  @property
+  def exitcode(self) -> int | None:
+    if self._exitcode is None:
+      code = self._zygote.poll(self.pid)
+      if code is None and not self._zygote.is_running():
+        # zygote died, so the real exit code is lost; all we can still do is
+        # check whether the reparented child is alive
+        try:
+          os.kill(self.pid, 0)
+        except OSError:
+          code = 0
+      self._exitcode = code
+    return self._exitcode
+
+  def is_alive(self) -> bool:
+    return self.exitcode is None
+
+  def join(self, timeout: float | None = None) -> None:
+    t = time.monotonic()
+    while self.exitcode is None and (timeout is None or time.monotonic() - t < timeout):
+      time.sleep(0.001)
+
+
+class Zygote:
+  def __init__(self):
+    self.sock: socket.socket | None = None
+    self.pid: int | None = None
+
+  def start(self) -> None:
+    if self.sock is not None:
+      return
+
+    parent_sock, child_sock = socket.socketpair()
+    pid = os.fork()
+    if pid == 0:
+      parent_sock.close()
+      try:
+        _serve(child_sock)
+      finally:
+        os._exit(0)
+    child_sock.close()
+    self.sock, self.pid = parent_sock, pid
+    cloudlog.info(f"zygote started with pid {pid}")
+
+  def is_running(self) -> bool:
+    return self.sock is not None
+
+  def spawn(self, module: str, name: str) -> ZygoteChild:
+    assert self.sock is not None
+    try:
+      _send_obj(self.sock, ("spawn", module, name))
+      return ZygoteChild(self, _recv_obj(self.sock))
+    except (OSError, EOFError):
+      self._lost()
+      raise
+
+  def poll(self, pid: int) -> int | None:
+    if self.sock is None:
+      return None
+    try:
+      _send_obj(self.sock, ("poll", pid))
+      return _recv_obj(self.sock)
+    except (OSError, EOFError):
+      self._lost()
+      return None
+
+  def stop(self) -> None:
+    if self.sock is None:
+      return
+    self.sock.close()
+    self.sock = None
+    try:
+      os.waitpid(self.pid, 0)
+    except ChildProcessError:
+      pass
+    self.pid = None
+
+  def _lost(self) -> None:
+    cloudlog.error("lost connection to zygote")
+    if self.sock is not None:
+      self.sock.close()
+      self.sock = None
+
+
+zygote = Zygote()
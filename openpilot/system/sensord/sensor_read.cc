@@ -0,0 +1,60 @@
+#include "system/sensord/sensor_read.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+#include <stdexcept>
+#include <string>
+
+namespace sensor_read {
+
+I2cDevice::I2cDevice(int bus, uint8_t addr) : addr_(addr) {
+  std::string dev = "/dev/i2c-" + std::to_string(bus);
+  fd_ = open(dev.c_str(), O_RDWR);
+  if (fd_ < 0) {
+    throw std::runtime_error("failed to open " + dev);
+  }
+}
+
+I2cDevice::~I2cDevice() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+int I2cDevice::write_reg(uint8_t reg, uint8_t value) {
+  uint8_t buf[2] = {reg, value};
+  i2c_msg msg = {
+    .addr = addr_,
+    .flags = 0,
+    .len = 2,
+    .buf = buf,
+  };
+  i2c_rdwr_ioctl_data xfer = {.msgs = &msg, .nmsgs = 1};
+  return ioctl(fd_, I2C_RDWR, &xfer) < 0 ? -1 : 0;
+}
+
+int I2cDevice::read_block(uint8_t reg, uint8_t *dst, size_t len) {
+  i2c_msg msgs[2] = {
+    {.addr = addr_, .flags = 0, .len = 1, .buf = &reg},
+    {.addr = addr_, .flags = I2C_M_RD, .len = (uint16_t)len, .buf = dst},
+  };
+  i2c_rdwr_ioctl_data xfer = {.msgs = msgs, .nmsgs = 2};
+  return ioctl(fd_, I2C_RDWR, &xfer) < 0 ? -1 : 0;
+}
+
+int I2cDevice::read_sample(uint8_t status_reg, uint8_t *status, uint8_t data_reg, uint8_t *dst, size_t len) {
+  i2c_msg msgs[4] = {
+    {.addr = addr_, .flags = 0, .len = 1, .buf = &status_reg},
+    {.addr = addr_, .flags = I2C_M_RD, .len = 1, .buf = status},
+    {.addr = addr_, .flags = 0, .len = 1, .buf = &data_reg},
+    {.addr = addr_, .flags = I2C_M_RD, .len = (uint16_t)len, .buf = dst},
+  };
+  i2c_rdwr_ioctl_data xfer = {.msgs = msgs, .nmsgs = 4};
+  return ioctl(fd_, I2C_RDWR, &xfer) < 0 ? -1 : 0;
+}
+
+}  // namespace sensor_read
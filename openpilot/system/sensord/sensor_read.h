@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sensor_read {
+
+// Thin wrapper around /dev/i2c-N using I2C_RDWR combined transfers. The SMBus
+// ioctl path costs one kernel round trip per register, which is where most of
+// the per-interrupt jitter in sensord's sample path came from.
+class I2cDevice {
+public:
+  I2cDevice(int bus, uint8_t addr);  // throws std::runtime_error if the bus can't be opened
+  ~I2cDevice();
+
+  // single register write
+  int write_reg(uint8_t reg, uint8_t value);
+  // register burst read; the address write and the read are one combined transfer
+  int read_block(uint8_t reg, uint8_t *dst, size_t len);
+  // status register plus sample burst in one combined transfer, so the data
+  // ready check and the sample read can't be split apart on the bus
+  int read_sample(uint8_t status_reg, uint8_t *status, uint8_t data_reg, uint8_t *dst, size_t len);
+
+private:
+  int fd_ = -1;
+  uint8_t addr_;
+};
+
+}  // namespace sensor_read
@@ -0,0 +1,58 @@
+# distutils: language = c++
+# cython: language_level = 3
+
+cdef extern from "system/sensord/sensor_read.h" namespace "sensor_read":
+  cdef cppclass c_I2cDevice "sensor_read::I2cDevice":
+    c_I2cDevice(int bus, unsigned char addr) except + nogil
+    int write_reg(unsigned char reg, unsigned char value) nogil
+    int read_block(unsigned char reg, unsigned char *dst, size_t length) nogil
+    int read_sample(unsigned char status_reg, unsigned char *status,
+                    unsigned char data_reg, unsigned char *dst, size_t length) nogil
+
+MAX_BLOCK = 64
+
+
+cdef class I2cDevice:
+  cdef c_I2cDevice *dev
+
+  def __cinit__(self, int bus, int addr):
+    self.dev = new c_I2cDevice(bus, <unsigned char>addr)
+
+  def __dealloc__(self):
+    self.close()
+
+  def close(self):
+    if self.dev != NULL:
+      del self.dev
+      self.dev = NULL
+
+  def write_reg(self, int reg, int value):
+    cdef int ret
+    cdef unsigned char c_reg = reg, c_value = value
+    with nogil:
+      ret = self.dev.write_reg(c_reg, c_value)
+    if ret != 0:
+      raise OSError(f"i2c write failed: reg {reg:#x}")
+
+  def read_block(self, int reg, size_t length) -> bytes:
+    cdef int ret
+    cdef unsigned char c_reg = reg
+    cdef unsigned char buf[64]
+    assert length <= 64
+    with nogil:
+      ret = self.dev.read_block(c_reg, buf, length)
+    if ret != 0:
+      raise OSError(f"i2c read failed: reg {reg:#x}")
+    return bytes(buf[:length])
+
+  def read_sample(self, int status_reg, int data_reg, size_t length) -> tuple[int, bytes]:
+    """Status register and sample burst in one combined bus transaction."""
+    cdef int ret
+    cdef unsigned char c_status_reg = status_reg, c_data_reg = data_reg, status = 0
+    cdef unsigned char buf[64]
+    assert length <= 64
+    with nogil:
+      ret = self.dev.read_sample(c_status_reg, &status, c_data_reg, buf, length)
+    if ret != 0:
+      raise OSError(f"i2c sample read failed: reg {data_reg:#x}")
+    return status, bytes(buf[:length])
@@ -3,7 +3,7 @@ import ctypes
 from collections.abc import Iterable
 
 from openpilot.cereal import log
-from openpilot.common.i2c import SMBus
+from openpilot.system.sensord.sensor_read_pyx import I2cDevice
 
 
 class Sensor:
@@ -14,7 +14,7 @@ class Sensor:
     pass
 
   def __init__(self, bus: int) -> None:
-    self.bus = SMBus(bus)
+    self.bus = I2cDevice(bus, self.device_address)
     self.source = log.SensorEventData.SensorSource.velodyne  # unknown
     self.start_ts = 0.
 
@@ -22,10 +22,15 @@ class Sensor:
     self.bus.close()
 
   def read(self, addr: int, length: int) -> bytes:
-    return bytes(self.bus.read_i2c_block_data(self.device_address, addr, length))
+    return self.bus.read_block(addr, length)
 
   def write(self, addr: int, data: int) -> None:
-    self.bus.write_byte_data(self.device_address, addr, data)
+    self.bus.write_reg(addr, data)
+
+  def read_sample(self, status_reg: int, data_reg: int, length: int) -> tuple[int, bytes]:
+    # status and sample burst in one combined transfer, so the data ready
+    # check and the read can't be split apart on the bus
+    return self.bus.read_sample(status_reg, data_reg, length)
 
   def writes(self, writes: Iterable[tuple[int, int]]) -> None:
     for addr, data in writes:
@@ -65,12 +65,11 @@ class LSM6DS3_Accel(Sensor):
     assert ts is not None  # must come from the IRQ event
 
     # Check if data is ready since IRQ is shared with gyro
-    status_reg = self.read(self.LSM6DS3_ACCEL_I2C_REG_STAT_REG, 1)[0]
+    status_reg, b = self.read_sample(self.LSM6DS3_ACCEL_I2C_REG_STAT_REG, self.LSM6DS3_ACCEL_I2C_REG_OUTX_L_XL, 6)
     if (status_reg & self.LSM6DS3_ACCEL_DRDY_XLDA) == 0:
       raise self.DataNotReady
 
     scale = 9.81 * 2.0 / (1 << 15)
-    b = self.read(self.LSM6DS3_ACCEL_I2C_REG_OUTX_L_XL, 6)
     x = self.parse_16bit(b[0], b[1]) * scale
     y = self.parse_16bit(b[2], b[3]) * scale
     z = self.parse_16bit(b[4], b[5]) * scale
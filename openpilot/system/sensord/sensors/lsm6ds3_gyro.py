@@ -60,11 +60,10 @@ class LSM6DS3_Gyro(Sensor):
     assert ts is not None  # must come from the IRQ event
 
     # Check if gyroscope data is ready, since it's shared with accelerometer
-    status_reg = self.read(self.LSM6DS3_GYRO_I2C_REG_STAT_REG, 1)[0]
+    status_reg, b = self.read_sample(self.LSM6DS3_GYRO_I2C_REG_STAT_REG, self.LSM6DS3_GYRO_I2C_REG_OUTX_L_G, 6)
     if not (status_reg & self.LSM6DS3_GYRO_DRDY_GDA):
       raise self.DataNotReady
 
-    b = self.read(self.LSM6DS3_GYRO_I2C_REG_OUTX_L_G, 6)
     x = self.parse_16bit(b[0], b[1])
     y = self.parse_16bit(b[2], b[3])
     z = self.parse_16bit(b[4], b[5])
@@ -0,0 +1,98 @@
+#include "system/ubloxd/binary_struct.h"
+
+#include <algorithm>
+
+namespace binary_struct {
+
+namespace {
+
+inline uint64_t load_le(const uint8_t *p, int size) {
+  uint64_t v = 0;
+  for (int i = size - 1; i >= 0; --i) {
+    v = (v << 8) | p[i];
+  }
+  return v;
+}
+
+inline uint64_t load_be(const uint8_t *p, int size) {
+  uint64_t v = 0;
+  for (int i = 0; i < size; ++i) {
+    v = (v << 8) | p[i];
+  }
+  return v;
+}
+
+inline uint64_t sign_extend(uint64_t v, int bits) {
+  const uint64_t m = 1ULL << (bits - 1);
+  return (v ^ m) - m;
+}
+
+}  // namespace
+
+int decode_run(const uint8_t *data, size_t len, const uint8_t *ops, size_t n_ops,
+               size_t *pos_io, int *bit_pos_io, uint64_t *out) {
+  size_t pos = *pos_io;
+  int bit_pos = *bit_pos_io;
+
+  for (size_t i = 0; i < n_ops; ++i) {
+    const uint8_t kind = ops[2 * i];
+    const int size = ops[2 * i + 1];
+
+    if (kind == BITS) {
+      // big-endian bit stream, same walk as BinaryReader.read_bits_int_be()
+      uint64_t result = 0;
+      int remaining = size;
+      while (remaining > 0) {
+        if (pos >= len) return -1;
+        const int in_byte = 8 - bit_pos;
+        const int take = std::min(remaining, in_byte);
+        const uint8_t extracted = (data[pos] >> (in_byte - take)) & ((1 << take) - 1);
+        result = (result << take) | extracted;
+        bit_pos += take;
+        remaining -= take;
+        if (bit_pos >= 8) {
+          bit_pos = 0;
+          pos++;
+        }
+      }
+      out[i] = result;
+      continue;
+    }
+
+    // everything else is byte-aligned, dropping any partial byte first
+    if (bit_pos > 0) {
+      bit_pos = 0;
+      pos++;
+    }
+
+    if (kind == BYTES) {
+      if (pos + (size_t)size > len) return -1;
+      out[i] = pos;
+      pos += size;
+      continue;
+    }
+
+    int width;
+    switch (kind) {
+      case U8: case S8: width = 1; break;
+      case U16LE: case S16LE: case U16BE: case S16BE: width = 2; break;
+      case F64: width = 8; break;
+      default: width = 4; break;
+    }
+    if (pos + (size_t)width > len) return -1;
+
+    const bool big_endian = (kind == U16BE || kind == S16BE || kind == U32BE || kind == S32BE);
+    uint64_t v = big_endian ? load_be(&data[pos], width) : load_le(&data[pos], width);
+    if (kind == S8 || kind == S16LE || kind == S16BE || kind == S32LE || kind == S32BE) {
+      v = sign_extend(v, width * 8);
+    }
+    out[i] = v;
+    pos += width;
+  }
+
+  *pos_io = pos;
+  *bit_pos_io = bit_pos;
+  return 0;
+}
+
+}  // namespace binary_struct
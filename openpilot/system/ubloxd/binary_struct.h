@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Native decode path for the binary_struct.py DSL: each BinaryStruct
+// compiles its runs of scalar fields into a packed op table, and
+// decode_run() extracts a whole run in one call. The cursor (byte and bit
+// position) is passed in and written back, so the Python side can
+// interleave data-dependent parsing (switch/array/substream) between runs
+// and bit streams that cross struct boundaries mid-byte keep working.
+
+namespace binary_struct {
+
+// op kinds, mirrored by binary_struct.py
+enum FieldKind : uint8_t {
+  U8, S8, U16LE, S16LE, U32LE, S32LE, U16BE, S16BE, U32BE, S32BE, F32, F64, BITS, BYTES,
+};
+
+// ops are packed (kind, size) byte pairs; size is the bit count for BITS,
+// the byte count for BYTES and unused otherwise. every decoded value lands
+// in out as 64 bits: sign-extended for signed ints, the raw IEEE bit
+// pattern for floats, and the byte offset of the slice for BYTES. returns
+// 0, or -1 when the data ends mid-field (cursor is left untouched).
+int decode_run(const uint8_t *data, size_t len, const uint8_t *ops, size_t n_ops,
+               size_t *pos, int *bit_pos, uint64_t *out);
+
+}  // namespace binary_struct
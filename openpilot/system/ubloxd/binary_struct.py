@@ -10,6 +10,8 @@ from enum import Enum
 from dataclasses import dataclass, is_dataclass
 from typing import Annotated, Any, TypeVar, get_args, get_origin
 
+from openpilot.system.ubloxd.binary_struct_pyx import decode_run
+
 
 class FieldType:
   """Base class for field type descriptors."""
@@ -161,6 +163,61 @@ class BinaryReader:
       self.pos += 1
 
 
+# FieldKind values from binary_struct.h, for the native decode path
+(_K_U8, _K_S8, _K_U16LE, _K_S16LE, _K_U32LE, _K_S32LE,
+ _K_U16BE, _K_S16BE, _K_U32BE, _K_S32BE, _K_F32, _K_F64, _K_BITS, _K_BYTES) = range(14)
+
+_INT_KINDS = {
+  # (bits, signed, big_endian) -> kind
+  (8, False, False): _K_U8, (8, True, False): _K_S8,
+  (16, False, False): _K_U16LE, (16, True, False): _K_S16LE,
+  (32, False, False): _K_U32LE, (32, True, False): _K_S32LE,
+  (16, False, True): _K_U16BE, (16, True, True): _K_S16BE,
+  (32, False, True): _K_U32BE, (32, True, True): _K_S32BE,
+}
+
+
+def _native_op(spec: Any) -> tuple[int, int] | None:
+  """(kind, size) op for the native decoder, or None if the field needs the python path."""
+  field_type = _field_type_from_spec(spec)
+  if isinstance(field_type, IntType):
+    kind = _INT_KINDS.get((field_type.bits, field_type.signed, field_type.big_endian))
+    return None if kind is None else (kind, 0)
+  if isinstance(field_type, FloatType):
+    return (_K_F32 if field_type.bits == 32 else _K_F64, 0)
+  if isinstance(field_type, BitsType) and field_type.bits <= 64:
+    return (_K_BITS, field_type.bits)
+  if isinstance(field_type, BytesType) and field_type.size <= 255:
+    return (_K_BYTES, field_type.size)
+  return None
+
+
+def _compile_segments(fields: list[tuple[str, Any]]) -> list[tuple]:
+  """Group consecutive scalar fields into native decode runs; anything
+  data-dependent (switch/array/substream/enum/const/nested struct) stays a
+  per-field python segment between runs."""
+  segments: list[tuple] = []
+  run_ops = bytearray()
+  run_names: list[str] = []
+
+  def flush_run():
+    if run_names:
+      segments.append(('run', bytes(run_ops), tuple(run_names)))
+      run_ops.clear()
+      run_names.clear()
+
+  for name, spec in fields:
+    op = _native_op(spec)
+    if op is not None:
+      run_ops += bytes(op)
+      run_names.append(name)
+    else:
+      flush_run()
+      segments.append(('py', name, spec))
+  flush_run()
+  return segments
+
+
 T = TypeVar('T', bound='BinaryStruct')
 
 
@@ -175,13 +232,20 @@ class BinaryStruct:
       dataclass(init=False)(cls)
     fields = list(getattr(cls, '__annotations__', {}).items())
     cls.__binary_fields__ = fields
+    cls.__binary_segments__ = _compile_segments(fields)
 
     @classmethod
     def _read(inner_cls, reader: BinaryReader):
       obj = inner_cls.__new__(inner_cls)
-      for name, spec in inner_cls.__binary_fields__:
-        value = _parse_field(spec, reader, obj)
-        setattr(obj, name, value)
+      for segment in inner_cls.__binary_segments__:
+        if segment[0] == 'run':
+          _, ops, names = segment
+          values, reader.pos, reader.bit_pos = decode_run(reader.data, ops, reader.pos, reader.bit_pos)
+          for name, value in zip(names, values, strict=True):
+            setattr(obj, name, value)
+        else:
+          _, name, spec = segment
+          setattr(obj, name, _parse_field(spec, reader, obj))
       return obj
 
     cls._read = _read
@@ -0,0 +1,53 @@
+# distutils: language = c++
+# cython: language_level = 3
+from libc.string cimport memcpy
+
+cdef extern from "system/ubloxd/binary_struct.h" namespace "binary_struct":
+  int c_decode_run "binary_struct::decode_run" (const unsigned char *data, size_t len,
+                                                const unsigned char *ops, size_t n_ops,
+                                                size_t *pos, int *bit_pos, unsigned long long *out) nogil
+
+# FieldKind from binary_struct.h
+cdef enum:
+  U8, S8, U16LE, S16LE, U32LE, S32LE, U16BE, S16BE, U32BE, S32BE, F32, F64, BITS, BYTES
+
+MAX_RUN_OPS = 128
+
+
+def decode_run(const unsigned char[::1] data, const unsigned char[::1] ops, Py_ssize_t pos, int bit_pos):
+  """Decode one run of scalar fields; returns (values, pos, bit_pos)."""
+  cdef size_t n_ops = ops.shape[0] // 2
+  cdef unsigned long long out[128]
+  cdef size_t c_pos = pos
+  cdef int c_bit_pos = bit_pos
+  cdef int ret
+  assert n_ops <= 128
+
+  with nogil:
+    ret = c_decode_run(&data[0], data.shape[0], &ops[0], n_ops, &c_pos, &c_bit_pos, out)
+  if ret != 0:
+    raise EOFError("Unexpected end of data")
+
+  cdef double dval
+  cdef float fval
+  cdef size_t i
+  cdef unsigned char kind, size
+  values = []
+  for i in range(n_ops):
+    kind = ops[2 * i]
+    size = ops[2 * i + 1]
+    if kind == BITS:
+      values.append(bool(out[i]) if size == 1 else out[i])
+    elif kind == S8 or kind == S16LE or kind == S16BE or kind == S32LE or kind == S32BE:
+      values.append(<long long>out[i])
+    elif kind == F32:
+      memcpy(&fval, &out[i], 4)
+      values.append(fval)
+    elif kind == F64:
+      memcpy(&dval, &out[i], 8)
+      values.append(dval)
+    elif kind == BYTES:
+      values.append(bytes(data[out[i]:out[i] + size]))
+    else:
+      values.append(out[i])
+  return values, c_pos, c_bit_pos
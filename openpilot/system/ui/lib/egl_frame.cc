@@ -0,0 +1,137 @@
+#include "system/ui/lib/egl_frame.h"
+
+#include <dlfcn.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+// EGL constants, from EGL/egl.h and the dma-buf import extensions
+#define EGL_NO_CONTEXT ((void *)0)
+#define EGL_NO_DISPLAY ((void *)0)
+#define EGL_NO_IMAGE_KHR ((void *)0)
+#define EGL_NONE 0x3038
+#define EGL_WIDTH 0x3057
+#define EGL_HEIGHT 0x3056
+#define EGL_LINUX_DMA_BUF_EXT 0x3270
+#define EGL_LINUX_DRM_FOURCC_EXT 0x3271
+#define EGL_DMA_BUF_PLANE0_FD_EXT 0x3272
+#define EGL_DMA_BUF_PLANE0_OFFSET_EXT 0x3273
+#define EGL_DMA_BUF_PLANE0_PITCH_EXT 0x3274
+#define EGL_DMA_BUF_PLANE1_FD_EXT 0x3275
+#define EGL_DMA_BUF_PLANE1_OFFSET_EXT 0x3276
+#define EGL_DMA_BUF_PLANE1_PITCH_EXT 0x3277
+#define EGL_SYNC_FENCE_KHR 0x30F9
+#define EGL_SYNC_FLUSH_COMMANDS_BIT_KHR 0x0001
+#define EGL_CONDITION_SATISFIED_KHR 0x30F6
+#define GL_TEXTURE0 0x84C0
+#define GL_TEXTURE_EXTERNAL_OES 0x8D65
+#define DRM_FORMAT_NV12 842094158
+
+namespace egl_frame {
+
+template <typename T>
+static void resolve(void *lib, const char *name, T &fn) {
+  fn = reinterpret_cast<T>(dlsym(lib, name));
+  if (fn == nullptr) {
+    throw std::runtime_error(std::string("failed to resolve ") + name);
+  }
+}
+
+// KHR extension entry points aren't guaranteed to be exported from the
+// libraries; eglGetProcAddress is the specified lookup, with dlsym as a
+// fallback. Leaves fn null when the extension isn't available.
+template <typename T>
+static void resolve_ext(void *(*get_proc)(const char *), void *lib, const char *name, T &fn) {
+  fn = reinterpret_cast<T>(get_proc(name));
+  if (fn == nullptr) {
+    fn = reinterpret_cast<T>(dlsym(lib, name));
+  }
+}
+
+EglPresenter::EglPresenter() {
+  egl_lib_ = dlopen("libEGL.so", RTLD_LAZY);
+  gles_lib_ = dlopen("libGLESv2.so", RTLD_LAZY);
+  if (egl_lib_ == nullptr || gles_lib_ == nullptr) {
+    throw std::runtime_error("failed to load libEGL/libGLESv2");
+  }
+
+  resolve(egl_lib_, "eglGetCurrentDisplay", get_current_display_);
+  resolve(egl_lib_, "eglGetError", get_error_);
+  resolve(gles_lib_, "glActiveTexture", active_texture_);
+  resolve(gles_lib_, "glBindTexture", bind_texture_);
+
+  void *(*get_proc)(const char *) = nullptr;
+  resolve(egl_lib_, "eglGetProcAddress", get_proc);
+
+  // dma-buf import is what zero-copy presentation is built on; no fallback
+  resolve_ext(get_proc, egl_lib_, "eglCreateImageKHR", create_image_khr_);
+  resolve_ext(get_proc, egl_lib_, "eglDestroyImageKHR", destroy_image_khr_);
+  resolve_ext(get_proc, gles_lib_, "glEGLImageTargetTexture2DOES", image_target_texture_);
+  if (create_image_khr_ == nullptr || destroy_image_khr_ == nullptr || image_target_texture_ == nullptr) {
+    throw std::runtime_error("missing EGL dma-buf import entry points");
+  }
+
+  // fence extension is optional; fence() reports false without it
+  resolve_ext(get_proc, egl_lib_, "eglCreateSyncKHR", create_sync_khr_);
+  resolve_ext(get_proc, egl_lib_, "eglClientWaitSyncKHR", client_wait_sync_khr_);
+  resolve_ext(get_proc, egl_lib_, "eglDestroySyncKHR", destroy_sync_khr_);
+
+  display_ = get_current_display_();
+  if (display_ == EGL_NO_DISPLAY) {
+    throw std::runtime_error("failed to get EGL display");
+  }
+}
+
+void *EglPresenter::createImage(int width, int height, int stride, int fd, int uv_offset, int *image_fd) {
+  // EGL takes its own reference on the fd
+  int dup_fd = dup(fd);
+  if (dup_fd < 0) return nullptr;
+
+  const int32_t attrs[] = {
+    EGL_WIDTH, width,
+    EGL_HEIGHT, height,
+    EGL_LINUX_DRM_FOURCC_EXT, DRM_FORMAT_NV12,
+    EGL_DMA_BUF_PLANE0_FD_EXT, dup_fd,
+    EGL_DMA_BUF_PLANE0_OFFSET_EXT, 0,
+    EGL_DMA_BUF_PLANE0_PITCH_EXT, stride,
+    EGL_DMA_BUF_PLANE1_FD_EXT, dup_fd,
+    EGL_DMA_BUF_PLANE1_OFFSET_EXT, uv_offset,
+    EGL_DMA_BUF_PLANE1_PITCH_EXT, stride,
+    EGL_NONE,
+  };
+
+  void *image = create_image_khr_(display_, EGL_NO_CONTEXT, EGL_LINUX_DMA_BUF_EXT, nullptr, attrs);
+  if (image == EGL_NO_IMAGE_KHR) {
+    close(dup_fd);
+    return nullptr;
+  }
+  *image_fd = dup_fd;
+  return image;
+}
+
+void EglPresenter::destroyImage(void *image, int image_fd) {
+  destroy_image_khr_(display_, image);
+  if (image_fd >= 0) {
+    close(image_fd);
+  }
+}
+
+void EglPresenter::bindToTexture(uint32_t texture_id, void *image) {
+  active_texture_(GL_TEXTURE0);
+  bind_texture_(GL_TEXTURE_EXTERNAL_OES, texture_id);
+  image_target_texture_(GL_TEXTURE_EXTERNAL_OES, image);
+}
+
+bool EglPresenter::fence(uint64_t timeout_ns) {
+  if (create_sync_khr_ == nullptr || client_wait_sync_khr_ == nullptr || destroy_sync_khr_ == nullptr) {
+    return false;
+  }
+  void *sync = create_sync_khr_(display_, EGL_SYNC_FENCE_KHR, nullptr);
+  if (sync == nullptr) return false;
+
+  int32_t ret = client_wait_sync_khr_(display_, sync, EGL_SYNC_FLUSH_COMMANDS_BIT_KHR, timeout_ns);
+  destroy_sync_khr_(display_, sync);
+  return ret == EGL_CONDITION_SATISFIED_KHR;
+}
+
+}  // namespace egl_frame
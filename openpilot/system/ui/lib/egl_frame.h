@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+namespace egl_frame {
+
+// Native EGL presentation for VisionIpc dma-buf frames: imports buffers as
+// NV12 EGLImages, binds them to an external-OES texture, and offers
+// fence-based synchronization so a buffer can't be handed back to the
+// producer while the GPU is still sampling it. Symbols are resolved at
+// runtime from libEGL/libGLESv2 (same as the old cffi path), so this builds
+// without GLES development headers.
+class EglPresenter {
+public:
+  EglPresenter();  // throws std::runtime_error if EGL is unavailable
+
+  // imports the dma-buf as an NV12 EGLImage. The fd is dup'd; the dup is
+  // written to *image_fd and owned by the caller. Returns nullptr on failure.
+  void *createImage(int width, int height, int stride, int fd, int uv_offset, int *image_fd);
+  void destroyImage(void *image, int image_fd);
+  void bindToTexture(uint32_t texture_id, void *image);
+  // inserts a fence after the draw calls and waits (flushing) until the GPU
+  // has passed it; returns false on timeout or if fences are unsupported
+  bool fence(uint64_t timeout_ns);
+
+private:
+  void *egl_lib_ = nullptr;
+  void *gles_lib_ = nullptr;
+  void *display_ = nullptr;
+
+  // function pointers resolved at runtime
+  void *(*get_current_display_)() = nullptr;
+  int32_t (*get_error_)() = nullptr;
+  void *(*create_image_khr_)(void *dpy, void *ctx, uint32_t target, void *buffer, const int32_t *attrib_list) = nullptr;
+  uint32_t (*destroy_image_khr_)(void *dpy, void *image) = nullptr;
+  void (*image_target_texture_)(uint32_t target, void *image) = nullptr;
+  void (*active_texture_)(uint32_t texture) = nullptr;
+  void (*bind_texture_)(uint32_t target, uint32_t texture) = nullptr;
+  void *(*create_sync_khr_)(void *dpy, uint32_t type, const int32_t *attrib_list) = nullptr;
+  int32_t (*client_wait_sync_khr_)(void *dpy, void *sync, int32_t flags, uint64_t timeout) = nullptr;
+  uint32_t (*destroy_sync_khr_)(void *dpy, void *sync) = nullptr;
+};
+
+}  // namespace egl_frame
@@ -0,0 +1,38 @@
+# distutils: language = c++
+# cython: language_level = 3
+from libc.stdint cimport uint32_t, uint64_t, uintptr_t
+
+cdef extern from "system/ui/lib/egl_frame.h" namespace "egl_frame":
+  cdef cppclass c_EglPresenter "egl_frame::EglPresenter":
+    c_EglPresenter() except +
+    void *createImage(int width, int height, int stride, int fd, int uv_offset, int *image_fd)
+    void destroyImage(void *image, int image_fd)
+    void bindToTexture(uint32_t texture_id, void *image)
+    bint fence(uint64_t timeout_ns)
+
+
+cdef class EglPresenter:
+  cdef c_EglPresenter *presenter
+
+  def __cinit__(self):
+    self.presenter = new c_EglPresenter()
+
+  def __dealloc__(self):
+    del self.presenter
+
+  def create_image(self, int width, int height, int stride, int fd, int uv_offset):
+    """Import a dma-buf as an NV12 EGLImage; returns (image_handle, dup_fd) or None."""
+    cdef int image_fd = -1
+    cdef void *image = self.presenter.createImage(width, height, stride, fd, uv_offset, &image_fd)
+    if image == NULL:
+      return None
+    return <uintptr_t>image, image_fd
+
+  def destroy_image(self, uintptr_t image, int image_fd):
+    self.presenter.destroyImage(<void *>image, image_fd)
+
+  def bind_to_texture(self, uint32_t texture_id, uintptr_t image):
+    self.presenter.bindToTexture(texture_id, <void *>image)
+
+  def fence(self, uint64_t timeout_ns=100_000_000):
+    return self.presenter.fence(timeout_ns)
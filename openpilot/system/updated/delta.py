@@ -0,0 +1,98 @@
+import hashlib
+import json
+import os
+import shutil
+
+import requests
+import zstandard as zstd
+
+from openpilot.common.swaglog import cloudlog
+
+# Delta updates: instead of a full git fetch over cellular, the server
+# publishes an incremental git bundle (from_commit..to_commit, zstd
+# compressed) per release channel. We fetch it in resumable chunks, verify
+# it, and hand the decompressed bundle to git fetch inside the overlay, so a
+# typical update transfers the few megabytes of new objects instead of
+# renegotiating against the whole repo. Any miss (no bundle published, hash
+# mismatch, network error) falls back to the full fetch in updated.py.
+
+DELTA_URL = os.getenv("UPDATER_DELTA_URL", "https://commadist.azureedge.net/opdelta")
+
+CHUNK_SIZE = 1024 * 1024
+
+
+def delta_manifest_url(channel: str, from_commit: str, to_commit: str) -> str:
+  return f"{DELTA_URL}/{channel}/{from_commit}-{to_commit}.json"
+
+
+def _verify_sha256(path: str, expected: str) -> bool:
+  h = hashlib.sha256()
+  with open(path, "rb") as f:
+    while len(chunk := f.read(CHUNK_SIZE)) > 0:
+      h.update(chunk)
+  return h.hexdigest().lower() == expected.lower()
+
+
+def _resumable_download(url: str, dest: str, size: int, sha256: str) -> None:
+  part = dest + ".part"
+  pos = os.path.getsize(part) if os.path.exists(part) else 0
+  if pos > size:
+    os.unlink(part)
+    pos = 0
+
+  if pos < size:
+    headers: dict[str, str | None] = {"Accept-Encoding": None}
+    if pos > 0:
+      headers["Range"] = f"bytes={pos}-"
+    with requests.get(url, stream=True, headers=headers, timeout=60) as r:
+      r.raise_for_status()
+      if pos > 0 and r.status_code != 206:
+        # server didn't honor the range request; start over
+        pos = 0
+      with open(part, "ab" if pos > 0 else "wb") as f:
+        for chunk in r.iter_content(chunk_size=CHUNK_SIZE):
+          f.write(chunk)
+
+  if not _verify_sha256(part, sha256):
+    os.unlink(part)
+    raise ValueError(f"delta bundle hash mismatch for {url}")
+  os.replace(part, dest)
+
+
+def fetch_delta_bundle(channel: str, from_commit: str, to_commit: str, cache_dir: str) -> str | None:
+  """Returns the path to a verified, decompressed git bundle covering
+  from_commit..to_commit, or None if no delta is available."""
+  try:
+    r = requests.get(delta_manifest_url(channel, from_commit, to_commit), timeout=10)
+    if r.status_code == 404:
+      cloudlog.info(f"no delta published for {channel} {from_commit[:7]}..{to_commit[:7]}")
+      return None
+    r.raise_for_status()
+    manifest = r.json()
+  except (requests.exceptions.RequestException, json.JSONDecodeError):
+    cloudlog.warning("delta manifest fetch failed")
+    return None
+
+  bundle_zst = os.path.join(cache_dir, f"{to_commit}.bundle.zst")
+  bundle = os.path.join(cache_dir, f"{to_commit}.bundle")
+
+  # drop partial downloads for other targets so the cache holds one update
+  os.makedirs(cache_dir, exist_ok=True)
+  for fn in os.listdir(cache_dir):
+    if not fn.startswith(to_commit):
+      os.unlink(os.path.join(cache_dir, fn))
+
+  try:
+    _resumable_download(manifest["url"], bundle_zst, manifest["size"], manifest["sha256"])
+  except (requests.exceptions.RequestException, ValueError, KeyError):
+    cloudlog.exception("delta bundle download failed")
+    return None
+
+  with open(bundle_zst, "rb") as src, open(bundle, "wb") as dst:
+    zstd.ZstdDecompressor().copy_stream(src, dst)
+  os.unlink(bundle_zst)
+  return bundle
+
+
+def cleanup_delta_cache(cache_dir: str) -> None:
+  shutil.rmtree(cache_dir, ignore_errors=True)
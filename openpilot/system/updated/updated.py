@@ -19,9 +19,13 @@ from openpilot.common.swaglog import cloudlog
 from openpilot.selfdrive.selfdrived.alertmanager import set_offroad_alert
 from openpilot.common.hardware import AGNOS, HARDWARE
 from openpilot.common.version import get_build_metadata
+from openpilot.system.updated.delta import fetch_delta_bundle, cleanup_delta_cache
 
 LOCK_FILE = os.getenv("UPDATER_LOCK_FILE", "/tmp/safe_staging_overlay.lock")
 STAGING_ROOT = os.getenv("UPDATER_STAGING_ROOT", "/data/safe_staging")
+# delta bundles live outside the staging root so partial downloads survive
+# an overlay re-init and the fetch can resume where it left off
+DELTA_CACHE = os.getenv("UPDATER_DELTA_CACHE", "/data/delta_cache")
 
 OVERLAY_UPPER = os.path.join(STAGING_ROOT, "upper")
 OVERLAY_METADATA = os.path.join(STAGING_ROOT, "metadata")
@@ -387,8 +391,27 @@ class Updater:
     run(["git", "config", "--replace-all", "remote.origin.fetch", "+refs/heads/*:refs/remotes/origin/*"], OVERLAY_MERGED)
 
     branch = self.target_branch
-    git_fetch_output = run(["git", "fetch", "origin", branch], OVERLAY_MERGED)
-    cloudlog.info("git fetch success: %s", git_fetch_output)
+    fetched = False
+    new_commit = self.branches[branch]
+    if new_commit is not None:
+      bundle = fetch_delta_bundle(branch, self.get_commit_hash(OVERLAY_MERGED), new_commit, DELTA_CACHE)
+      if bundle is not None:
+        try:
+          delta_fetch_output = run(["git", "fetch", bundle, f"refs/heads/{branch}"], OVERLAY_MERGED)
+          if run(["git", "rev-parse", "FETCH_HEAD"], OVERLAY_MERGED).rstrip() == new_commit:
+            # keep the remote-tracking ref in step so --set-upstream-to below works
+            run(["git", "update-ref", f"refs/remotes/origin/{branch}", new_commit], OVERLAY_MERGED)
+            cloudlog.info("delta bundle fetch success: %s", delta_fetch_output)
+            fetched = True
+          else:
+            cloudlog.error("delta bundle resolved to the wrong commit, falling back to full fetch")
+        except subprocess.CalledProcessError:
+          cloudlog.exception("delta bundle apply failed, falling back to full fetch")
+        finally:
+          os.unlink(bundle)
+    if not fetched:
+      git_fetch_output = run(["git", "fetch", "origin", branch], OVERLAY_MERGED)
+      cloudlog.info("git fetch success: %s", git_fetch_output)
 
     cloudlog.info("git reset in progress")
     cmds = [
@@ -410,6 +433,7 @@ class Updater:
     # Create the finalized, ready-to-swap update
     self.params.put("UpdaterState", "finalizing update...", block=True)
     finalize_update()
+    cleanup_delta_cache(DELTA_CACHE)
     cloudlog.info("finalize success!")
 
 
@@ -0,0 +1,70 @@
+#include "system/webrtc/lib/track_source.h"
+
+#include <cstring>
+
+#include "common/timing.h"
+
+// arbitrary 16-byte UUID identifying openpilot frame-timing SEI messages,
+// matches TIMING_SEI_UUID in system/webrtc/device/video.py
+static const uint8_t SEI_PREFIX[] = {
+  0x00, 0x00, 0x00, 0x01, 0x06, 0x05, 0x30,
+  0xa5, 0xe0, 0xc4, 0xa4, 0x5b, 0x6e, 0x4e, 0x1e,
+  0x9c, 0x7e, 0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc,
+};
+
+static void append_be_double(std::string &out, double v) {
+  uint64_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  for (int i = 7; i >= 0; --i) {
+    out.push_back((char)((bits >> (i * 8)) & 0xff));
+  }
+}
+
+EncodedTrackSource::EncodedTrackSource(const std::string &service) {
+  ctx_.reset(Context::create());
+  switchService(service);
+}
+
+void EncodedTrackSource::switchService(const std::string &service) {
+  sock_.reset(SubSocket::create(ctx_.get(), service, "127.0.0.1", true));
+  assert(sock_ != nullptr);
+}
+
+bool EncodedTrackSource::poll(std::string &out, uint32_t *flags, uint64_t *log_mono_time, bool timing_sei) {
+  std::unique_ptr<Message> msg(sock_->receive(true));
+  if (!msg) return false;
+
+  capnp::FlatArrayMessageReader cmsg(aligned_buf_.align(msg.get()));
+  cereal::Event::Reader event = cmsg.getRoot<cereal::Event>();
+
+  cereal::EncodeData::Reader edata;
+  if (event.isLivestreamRoadEncodeData()) {
+    edata = event.getLivestreamRoadEncodeData();
+  } else if (event.isLivestreamWideRoadEncodeData()) {
+    edata = event.getLivestreamWideRoadEncodeData();
+  } else if (event.isLivestreamDriverEncodeData()) {
+    edata = event.getLivestreamDriverEncodeData();
+  } else {
+    return false;
+  }
+
+  auto header = edata.getHeader();
+  auto data = edata.getData();
+  *flags = edata.getIdx().getFlags();
+  *log_mono_time = event.getLogMonoTime();
+
+  out.clear();
+  out.reserve(header.size() + data.size() + (timing_sei ? sizeof(SEI_PREFIX) + 33 : 0));
+  out.append((const char *)header.begin(), header.size());
+  if (timing_sei) {
+    const auto idx = edata.getIdx();
+    out.append((const char *)SEI_PREFIX, sizeof(SEI_PREFIX));
+    append_be_double(out, (idx.getTimestampEof() - idx.getTimestampSof()) / 1e6);
+    append_be_double(out, ((int64_t)(*log_mono_time - idx.getTimestampEof())) / 1e6);
+    append_be_double(out, ((int64_t)(nanos_since_boot() - *log_mono_time)) / 1e6);
+    append_be_double(out, seconds_since_epoch() * 1000.0);
+    out.push_back((char)0x80);
+  }
+  out.append((const char *)data.begin(), data.size());
+  return true;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "openpilot/cereal/messaging/messaging.h"
+
+// Assembles WebRTC-ready Annex-B access units from encoderd's livestream
+// bitstream packets, so the python video track never touches frame bytes:
+// one poll() drains the conflated socket, parses the EncodeData event, and
+// concatenates header, optional timing SEI, and payload in native code.
+class EncodedTrackSource {
+public:
+  explicit EncodedTrackSource(const std::string &service);
+  void switchService(const std::string &service);
+
+  // assembles the newest packet into out and fills flags (EncodeIndex flags,
+  // for keyframe detection) and log_mono_time; returns false if nothing new
+  bool poll(std::string &out, uint32_t *flags, uint64_t *log_mono_time, bool timing_sei);
+
+private:
+  std::unique_ptr<Context> ctx_;
+  std::unique_ptr<SubSocket> sock_;
+  AlignedBuffer aligned_buf_;
+};
@@ -0,0 +1,36 @@
+# distutils: language = c++
+# cython: language_level = 3
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+cdef extern from "system/webrtc/lib/track_source.h":
+  cdef cppclass c_EncodedTrackSource "EncodedTrackSource":
+    c_EncodedTrackSource(const string &service) except +
+    void switchService(const string &service) except +
+    bint poll(string &out, uint32_t *flags, uint64_t *log_mono_time, bint timing_sei) nogil except +
+
+
+cdef class EncodedTrackSource:
+  """Native assembly of Annex-B access units from a livestream encode service."""
+  cdef c_EncodedTrackSource *src
+
+  def __cinit__(self, str service):
+    self.src = new c_EncodedTrackSource(service.encode())
+
+  def __dealloc__(self):
+    del self.src
+
+  def switch_service(self, str service):
+    self.src.switchService(service.encode())
+
+  def poll(self, bint timing_sei=False):
+    """Returns (frame_data, flags, log_mono_time) for the newest packet, or None."""
+    cdef string out
+    cdef uint32_t flags = 0
+    cdef uint64_t log_mono_time = 0
+    cdef bint ok
+    with nogil:
+      ok = self.src.poll(out, &flags, &log_mono_time, timing_sei)
+    if not ok:
+      return None
+    return out[:out.size()], flags, log_mono_time
@@ -66,10 +66,8 @@ class TestStreamSession:
       mocked_pubmaster.reset_mock()
 
   def test_livestream_track(self, mocker):
-    fake_msg = messaging.new_message("livestreamDriverEncodeData")
-
-    config = {"receive.return_value": fake_msg.to_bytes()}
-    mocker.patch("msgq.SubSocket", spec=True, **config)
+    config = {"return_value.poll.return_value": (b"", 0, 0)}
+    mocker.patch("openpilot.system.webrtc.device.video.EncodedTrackSource", spec=True, **config)
     track = LiveStreamVideoStreamTrack("driver")
 
     assert track.id.startswith("driver")
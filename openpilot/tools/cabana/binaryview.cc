@@ -323,7 +323,7 @@ void BinaryViewModel::updateState() {
       int bit_val = (binary[i] >> (7 - j)) & 1;
 
       double alpha = item.sigs.empty() ? 0 : min_alpha_with_signal;
-      uint32_t flip_count = bit_flips[i][j];
+      uint32_t flip_count = i < bit_flips.size() ? bit_flips[i][j] : 0;
       if (flip_count > 0) {
         double normalized_alpha = log2(1.0 + flip_count * log_factor) * log_scaler;
         double min_alpha = item.sigs.empty() ? min_alpha_no_signal : min_alpha_with_signal;
@@ -339,8 +339,12 @@ void BinaryViewModel::updateState() {
 }
 
 const std::vector<std::array<uint32_t, 8>> &BinaryViewModel::getBitFlipChanges(size_t msg_size) {
-  // Return cached results if time range and data are unchanged
+  // Full-history counts are maintained incrementally by the stream as events
+  // arrive, so the common case (no custom time range) is a plain lookup
   auto time_range = can->timeRange();
+  if (!time_range) return can->bitFlipCounts(msg_id);
+
+  // Return cached results if time range and data are unchanged
   if (bit_flip_tracker.time_range == time_range && !bit_flip_tracker.flip_counts.empty())
     return bit_flip_tracker.flip_counts;
 
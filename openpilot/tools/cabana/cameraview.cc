@@ -6,6 +6,8 @@
 #include <GLES3/gl3.h>
 #endif
 
+#include <cstring>
+
 #include <QApplication>
 
 namespace {
@@ -65,6 +67,10 @@ CameraWidget::~CameraWidget() {
     glDeleteBuffers(1, &frame_vbo);
     glDeleteBuffers(1, &frame_ibo);
     glDeleteTextures(2, textures);
+    for (int i = 0; i < PBO_RING_SIZE; ++i) {
+      if (pbo_fences[i]) glDeleteSync(pbo_fences[i]);
+    }
+    glDeleteBuffers(PBO_RING_SIZE, pbos);
     shader_program_.reset();
   }
   doneCurrent();
@@ -159,17 +165,17 @@ void CameraWidget::paintGL() {
   transform.scale(scale_x, scale_y, 1.0f);
   shader_program_->setUniformValue("uTransform", transform);
 
-  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  // only re-upload when the frame actually changed; repaints triggered by
+  // the rest of the UI just redraw the textures that are already there
+  if (frame_meta_.frame_id != uploaded_frame_id || uploaded_frame_id == 0) {
+    uploadFrame(current_frame_);
+    uploaded_frame_id = frame_meta_.frame_id;
+  }
 
-  glPixelStorei(GL_UNPACK_ROW_LENGTH, stream_stride);
   glActiveTexture(GL_TEXTURE0);
   glBindTexture(GL_TEXTURE_2D, textures[0]);
-  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, stream_width, stream_height, GL_RED, GL_UNSIGNED_BYTE, current_frame_->y);
-
-  glPixelStorei(GL_UNPACK_ROW_LENGTH, stream_stride/2);
   glActiveTexture(GL_TEXTURE1);
   glBindTexture(GL_TEXTURE_2D, textures[1]);
-  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, stream_width/2, stream_height/2, GL_RG, GL_UNSIGNED_BYTE, current_frame_->uv);
 
   glBindVertexArray(frame_vao);
   glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_BYTE, nullptr);
@@ -180,10 +186,53 @@ void CameraWidget::paintGL() {
   glBindTexture(GL_TEXTURE_2D, 0);
   glActiveTexture(GL_TEXTURE0);
   glBindTexture(GL_TEXTURE_2D, 0);
+
+  shader_program_->release();
+}
+
+void CameraWidget::uploadFrame(VisionBuf *buf) {
+  const size_t y_size = (size_t)stream_stride * stream_height;
+  const size_t uv_size = y_size / 2;
+
+  // don't touch a slot the GPU hasn't finished reading from yet. with
+  // PBO_RING_SIZE frames in flight this wait is almost always a no-op.
+  GLsync &fence = pbo_fences[pbo_index];
+  if (fence) {
+    glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+    glDeleteSync(fence);
+    fence = nullptr;
+  }
+
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos[pbo_index]);
+  void *dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, pbo_size,
+                               GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+  if (!dst) {
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return;
+  }
+  memcpy(dst, buf->y, y_size);
+  memcpy((uint8_t *)dst + y_size, buf->uv, uv_size);
+  glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+  // with a PBO bound these return immediately and the driver DMAs the
+  // pixels to the textures in the background
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, stream_stride);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, textures[0]);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, stream_width, stream_height, GL_RED, GL_UNSIGNED_BYTE, (const void *)0);
+
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, stream_stride/2);
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_2D, textures[1]);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, stream_width/2, stream_height/2, GL_RG, GL_UNSIGNED_BYTE, (const void *)y_size);
+
   glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
   glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
-  shader_program_->release();
+  fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  pbo_index = (pbo_index + 1) % PBO_RING_SIZE;
 }
 
 void CameraWidget::vipcConnected(VisionIpcClient *vipc_client) {
@@ -207,6 +256,24 @@ void CameraWidget::vipcConnected(VisionIpcClient *vipc_client) {
   glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
   glTexImage2D(GL_TEXTURE_2D, 0, GL_RG8, stream_width/2, stream_height/2, 0, GL_RG, GL_UNSIGNED_BYTE, nullptr);
   assert(glGetError() == GL_NO_ERROR);
+
+  // (re)size the upload ring for the new stream dimensions
+  for (int i = 0; i < PBO_RING_SIZE; ++i) {
+    if (pbo_fences[i]) {
+      glDeleteSync(pbo_fences[i]);
+      pbo_fences[i] = nullptr;
+    }
+  }
+  if (!pbos[0]) glGenBuffers(PBO_RING_SIZE, pbos);
+  pbo_size = (size_t)stream_stride * stream_height * 3 / 2;
+  for (int i = 0; i < PBO_RING_SIZE; ++i) {
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos[i]);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, pbo_size, nullptr, GL_STREAM_DRAW);
+  }
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  pbo_index = 0;
+  uploaded_frame_id = 0;
+  assert(glGetError() == GL_NO_ERROR);
 }
 
 void CameraWidget::vipcFrameReceived() {
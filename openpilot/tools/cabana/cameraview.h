@@ -38,8 +38,21 @@ protected:
   void vipcThread();
   void clearFrames();
 
+  void uploadFrame(VisionBuf *buf);
+
   GLuint frame_vao, frame_vbo, frame_ibo;
   GLuint textures[2];
+
+  // ring of pixel unpack buffers for async texture uploads. frames are
+  // copied into a mapped PBO and the driver DMAs them to the textures in
+  // the background, so paintGL never stalls in glTexSubImage2D. fences
+  // keep us from rewriting a buffer the GPU is still reading from.
+  static constexpr int PBO_RING_SIZE = 3;
+  GLuint pbos[PBO_RING_SIZE] = {};
+  GLsync pbo_fences[PBO_RING_SIZE] = {};
+  size_t pbo_size = 0;
+  int pbo_index = 0;
+  uint32_t uploaded_frame_id = 0;
   std::unique_ptr<QOpenGLShaderProgram> shader_program_;
   QColor bg = Qt::black;
 
@@ -1,6 +1,7 @@
 #include "tools/cabana/chart/chart.h"
 
 #include <algorithm>
+#include <chrono>
 #include <limits>
 
 #include <QActionGroup>
@@ -27,6 +28,35 @@ const double MIN_ZOOM_SECONDS = 0.01; // 10ms
 const float EPSILON = 0.000001;
 static inline bool xLessThan(const QPointF &p, float x) { return p.x() < (x - EPSILON); }
 
+// LOD pyramid: level k buckets 8<<k points and keeps each bucket's min and max
+const size_t LOD_BASE_BUCKET = 8;
+// cap on points handed to Qt per series; ~2 per pixel on a wide screen
+const size_t LOD_MAX_RENDER_POINTS = 5000;
+
+// (Re)build pyramid levels over vals[from..). Passing the pre-append size lets
+// live streams extend the pyramid by recomputing only the trailing buckets.
+static void extendLodPyramid(std::vector<std::vector<QPointF>> &levels, const std::vector<QPointF> &vals, size_t from) {
+  if (levels.empty()) from = 0;
+  for (size_t k = 0, bucket = LOD_BASE_BUCKET;; ++k, bucket *= 2) {
+    if (levels.size() <= k) levels.emplace_back();
+    auto &level = levels[k];
+    size_t first_bucket = from / bucket;
+    // a level added after earlier appends starts empty; fill it from the beginning
+    if (level.size() < first_bucket * 2) first_bucket = 0;
+    level.resize(first_bucket * 2);
+    for (size_t b = first_bucket; b * bucket < vals.size(); ++b) {
+      auto begin = vals.cbegin() + b * bucket;
+      auto end = vals.cbegin() + std::min((b + 1) * bucket, vals.size());
+      auto [mn, mx] = std::minmax_element(begin, end, [](auto &l, auto &r) { return l.y() < r.y(); });
+      // emit in x order so the level stays sorted
+      level.push_back(mn < mx ? *mn : *mx);
+      level.push_back(mn < mx ? *mx : *mn);
+    }
+    // the coarsest level must fit the budget at full zoom-out
+    if (level.size() <= LOD_MAX_RENDER_POINTS) break;
+  }
+}
+
 ChartView::ChartView(const std::pair<double, double> &x_range, ChartsWidget *parent)
     : charts_widget(parent), QChartView(parent) {
   series_type = (SeriesType)settings.chart_series_type;
@@ -58,6 +88,11 @@ ChartView::ChartView(const std::pair<double, double> &x_range, ChartsWidget *par
   QObject::connect(dbc(), &DBCManager::msgUpdated, this, &ChartView::msgUpdated);
 }
 
+ChartView::~ChartView() {
+  // sampling jobs capture `this`; join them before the chart goes away
+  for (auto &f : sample_jobs_) f.wait();
+}
+
 void ChartView::createToolButtons() {
   move_icon = new QGraphicsPixmapItem(utils::icon("grip-horizontal"), chart());
   move_icon->setToolTip(tr("Drag and drop to move chart"));
@@ -125,6 +160,7 @@ void ChartView::addSignal(const MessageId &msg_id, const cabana::Signal *sig) {
   QXYSeries *series = createSeries(series_type, sig->color);
   sigs.push_back({.msg_id = msg_id, .sig = sig, .series = series});
   updateSeries(sig);
+  updateCompareSeries(sig);
   updateSeriesPoints();
   updateTitle();
   emit charts_widget->seriesChanged();
@@ -140,6 +176,10 @@ void ChartView::removeIf(std::function<bool(const SigItem &s)> predicate) {
     if (predicate(*it)) {
       chart()->removeSeries(it->series);
       it->series->deleteLater();
+      if (it->cmp_series) {
+        chart()->removeSeries(it->cmp_series);
+        it->cmp_series->deleteLater();
+      }
       it = sigs.erase(it);
     } else {
       ++it;
@@ -162,6 +202,7 @@ void ChartView::signalUpdated(const cabana::Signal *sig) {
     }
     updateTitle();
     updateSeries(sig);
+    updateCompareSeries(sig);
   }
 }
 
@@ -248,6 +289,10 @@ void ChartView::updatePlot(double cur, double min, double max) {
   cur_sec = cur;
   if (min != axis_x->min() || max != axis_x->max()) {
     axis_x->setRange(min, max);
+    // decimated series render a slice for the new range; full series are untouched
+    for (auto &s : sigs) {
+      if (!s.lod_levels.empty()) updateRenderedSeries(s);
+    }
     updateAxisY();
     updateSeriesPoints();
     // update tooltip
@@ -282,14 +327,44 @@ void ChartView::updateSeriesPoints() {
   }
 }
 
+void ChartView::updateRenderedSeries(SigItem &s) {
+  const auto &full = series_type == SeriesType::StepLine ? s.step_vals : s.vals;
+  if (s.lod_levels.empty()) {
+    // small series are handed to Qt in full; nothing to redo on pan/zoom
+    s.series->replace(QVector<QPointF>(full.cbegin(), full.cend()));
+    return;
+  }
+
+  auto first = std::lower_bound(s.vals.cbegin(), s.vals.cend(), axis_x->min(), xLessThan);
+  auto last = std::lower_bound(first, s.vals.cend(), axis_x->max(), xLessThan);
+  const std::vector<QPointF> *source = &full;
+  if (size_t visible = last - first; visible > LOD_MAX_RENDER_POINTS) {
+    // pick the finest level that keeps the visible slice under the budget. At
+    // these densities step transitions are sub-pixel, so step lines render
+    // from the same min/max points
+    size_t level = 0;
+    for (size_t bucket = LOD_BASE_BUCKET; level + 1 < s.lod_levels.size() && (2 * visible) / bucket > LOD_MAX_RENDER_POINTS; bucket *= 2) {
+      ++level;
+    }
+    source = &s.lod_levels[level];
+  }
+  auto begin = std::lower_bound(source->cbegin(), source->cend(), axis_x->min(), xLessThan);
+  auto end = std::lower_bound(begin, source->cend(), axis_x->max(), xLessThan);
+  // keep one point either side so lines reach the plot edges
+  if (begin != source->cbegin()) --begin;
+  if (end != source->cend()) ++end;
+  s.series->replace(QVector<QPointF>(begin, end));
+}
+
 void ChartView::appendCanEvents(const cabana::Signal *sig, const std::vector<const CanEvent *> &events,
                                 std::vector<QPointF> &vals, std::vector<QPointF> &step_vals) {
   vals.reserve(vals.size() + events.capacity());
   step_vals.reserve(step_vals.size() + events.capacity() * 2);
 
+  const cabana::SignalDecoder decoder(*sig);
   double value = 0;
   for (const CanEvent *e : events) {
-    if (sig->getValue(e->dat, e->size, &value)) {
+    if (decoder.getValue(e->dat, e->size, &value)) {
       const double ts = can->toSeconds(e->mono_time);
       vals.emplace_back(ts, value);
       if (!step_vals.empty())
@@ -300,37 +375,131 @@ void ChartView::appendCanEvents(const cabana::Signal *sig, const std::vector<con
 }
 
 void ChartView::updateSeries(const cabana::Signal *sig, const MessageEventsMap *msg_new_events) {
+  // Live-stream appends are a handful of events per tick; decode them inline.
+  if (can->liveStreaming() && msg_new_events) {
+    for (auto &s : sigs) {
+      if (!sig || s.sig == sig) {
+        auto it = msg_new_events->find(s.msg_id);
+        if (it == msg_new_events->end() || it->second.empty()) continue;
+        size_t prev_size = s.vals.size();
+        appendCanEvents(s.sig, it->second, s.vals, s.step_vals);
+        if (s.vals.size() > LOD_MAX_RENDER_POINTS) {
+          extendLodPyramid(s.lod_levels, s.vals, prev_size);
+        }
+        updateRenderedSeries(s);
+      }
+    }
+    updateAxisY();
+    resetChartCache();
+    return;
+  }
+
+  // Everything else (replay merges, signal edits, initial load) resamples the
+  // whole series on a background thread and swaps the result in when ready,
+  // so decoding a 20-signal full-route chart never blocks the event loop.
   for (auto &s : sigs) {
     if (!sig || s.sig == sig) {
-      if (!msg_new_events) {
-        s.vals.clear();
-        s.step_vals.clear();
+      // skip charts that got no new data from this merge
+      if (msg_new_events && !msg_new_events->count(s.msg_id)) continue;
+
+      int generation = ++sample_generation_[s.sig];
+      // snapshot on the GUI thread: event pointers are stable, the vector holding them is not
+      std::vector<const CanEvent *> events = can->events(s.msg_id);
+      cabana::Signal sig_copy = *s.sig;
+      const cabana::Signal *sig_key = s.sig;
+      bool build_tree = !can->liveStreaming();
+      sample_jobs_.push_back(std::async(std::launch::async,
+          [this, events = std::move(events), sig_copy = std::move(sig_copy), sig_key, generation, build_tree]() {
+        auto result = std::make_shared<SampledSeries>();
+        appendCanEvents(&sig_copy, events, result->vals, result->step_vals);
+        if (build_tree) {
+          result->segment_tree.build(result->vals);
+        }
+        if (result->vals.size() > LOD_MAX_RENDER_POINTS) {
+          extendLodPyramid(result->lod_levels, result->vals, 0);
+        }
+        QMetaObject::invokeMethod(this, [this, sig_key, generation, result]() {
+          applySampledSeries(sig_key, generation, result);
+        }, Qt::QueuedConnection);
+      }));
+    }
+  }
+
+  // reap finished jobs so the list doesn't grow unbounded
+  sample_jobs_.erase(std::remove_if(sample_jobs_.begin(), sample_jobs_.end(),
+      [](auto &f) { return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }), sample_jobs_.end());
+}
+
+// Resamples the dashed overlay from the comparison route. The second stream
+// is static once its segments are in, so this samples synchronously and in
+// full; x values are the comparison route's own elapsed seconds plus the
+// user-chosen offset, which lines both drives up at t=0 by default.
+void ChartView::updateCompareSeries(const cabana::Signal *sig) {
+  AbstractStream *cmp = charts_widget->compareStream();
+  for (auto &s : sigs) {
+    if (sig && s.sig != sig) continue;
+
+    if (!cmp) {
+      if (s.cmp_series) {
+        chart()->removeSeries(s.cmp_series);
+        s.cmp_series->deleteLater();
+        s.cmp_series = nullptr;
       }
-      auto events = msg_new_events ? msg_new_events : &can->eventsMap();
-      auto it = events->find(s.msg_id);
-      if (it == events->end() || it->second.empty()) continue;
+      s.cmp_vals.clear();
+      s.cmp_step_vals.clear();
+      continue;
+    }
 
-      if (s.vals.empty() || can->toSeconds(it->second.back()->mono_time) > s.vals.back().x()) {
-        appendCanEvents(s.sig, it->second, s.vals, s.step_vals);
-      } else {
-        std::vector<QPointF> vals, step_vals;
-        appendCanEvents(s.sig, it->second, vals, step_vals);
-        s.vals.insert(std::lower_bound(s.vals.begin(), s.vals.end(), vals.front().x(), xLessThan),
-                      vals.begin(), vals.end());
-        s.step_vals.insert(std::lower_bound(s.step_vals.begin(), s.step_vals.end(), step_vals.front().x(), xLessThan),
-                           step_vals.begin(), step_vals.end());
+    s.cmp_vals.clear();
+    s.cmp_step_vals.clear();
+    const double offset = charts_widget->compareOffset();
+    const cabana::SignalDecoder decoder(*s.sig);
+    double value = 0;
+    const auto &events = cmp->events(s.msg_id);
+    s.cmp_vals.reserve(events.size());
+    for (const CanEvent *e : events) {
+      if (decoder.getValue(e->dat, e->size, &value)) {
+        const double ts = cmp->toSeconds(e->mono_time) + offset;
+        s.cmp_vals.emplace_back(ts, value);
+        if (!s.cmp_step_vals.empty())
+          s.cmp_step_vals.emplace_back(ts, s.cmp_step_vals.back().y());
+        s.cmp_step_vals.emplace_back(ts, value);
       }
+    }
 
-      if (!can->liveStreaming()) {
-        s.segment_tree.build(s.vals);
+    if (!s.cmp_series) {
+      s.cmp_series = createSeries(series_type, s.sig->color.lighter(150));
+      for (auto marker : chart()->legend()->markers(s.cmp_series)) {
+        marker->setVisible(false);
       }
-      const auto &points = series_type == SeriesType::StepLine ? s.step_vals : s.vals;
-      s.series->replace(QVector<QPointF>(points.cbegin(), points.cend()));
     }
+    s.cmp_series->setColor(s.sig->color.lighter(150));
+    if (series_type != SeriesType::Scatter) {
+      QPen pen = s.cmp_series->pen();
+      pen.setStyle(Qt::DashLine);
+      s.cmp_series->setPen(pen);
+    }
+    const auto &vals = series_type == SeriesType::StepLine ? s.cmp_step_vals : s.cmp_vals;
+    s.cmp_series->replace(QVector<QPointF>(vals.cbegin(), vals.cend()));
   }
   updateAxisY();
-  // invoke resetChartCache in ui thread
-  QMetaObject::invokeMethod(this, &ChartView::resetChartCache, Qt::QueuedConnection);
+  resetChartCache();
+}
+
+void ChartView::applySampledSeries(const cabana::Signal *sig, int generation, std::shared_ptr<SampledSeries> result) {
+  if (generation != sample_generation_[sig]) return;  // superseded by a newer job
+  auto it = std::find_if(sigs.begin(), sigs.end(), [sig](auto &s) { return s.sig == sig; });
+  if (it == sigs.end()) return;  // signal removed while sampling
+
+  auto &s = *it;
+  s.vals = std::move(result->vals);
+  s.step_vals = std::move(result->step_vals);
+  s.segment_tree = std::move(result->segment_tree);
+  s.lod_levels = std::move(result->lod_levels);
+  updateRenderedSeries(s);
+  updateAxisY();
+  updateSeriesPoints();
+  resetChartCache();
 }
 
 // auto zoom on yaxis
@@ -361,6 +530,14 @@ void ChartView::updateAxisY() {
     } else {
       std::tie(s.min, s.max) = s.segment_tree.minmax(std::distance(s.vals.cbegin(), first), std::distance(s.vals.cbegin(), last));
     }
+    if (s.cmp_series && s.cmp_series->isVisible()) {
+      auto cmp_first = std::lower_bound(s.cmp_vals.cbegin(), s.cmp_vals.cend(), axis_x->min(), xLessThan);
+      auto cmp_last = std::lower_bound(cmp_first, s.cmp_vals.cend(), axis_x->max(), xLessThan);
+      for (auto it = cmp_first; it != cmp_last; ++it) {
+        if (it->y() < s.min) s.min = it->y();
+        if (it->y() > s.max) s.max = it->y();
+      }
+    }
     min = std::min(min, s.min);
     max = std::max(max, s.max);
   }
@@ -836,12 +1013,17 @@ void ChartView::setSeriesType(SeriesType type) {
     for (auto &s : sigs) {
       chart()->removeSeries(s.series);
       s.series->deleteLater();
+      if (s.cmp_series) {
+        chart()->removeSeries(s.cmp_series);
+        s.cmp_series->deleteLater();
+        s.cmp_series = nullptr;
+      }
     }
     for (auto &s : sigs) {
       s.series = createSeries(series_type, s.sig->color);
-      const auto &points = series_type == SeriesType::StepLine ? s.step_vals : s.vals;
-      s.series->replace(QVector<QPointF>(points.cbegin(), points.cend()));
+      updateRenderedSeries(s);
     }
+    updateCompareSeries();
     updateSeriesPoints();
     updateTitle();
 
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <future>
+#include <memory>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -30,9 +33,11 @@ class ChartView : public QChartView {
 
 public:
   ChartView(const std::pair<double, double> &x_range, ChartsWidget *parent = nullptr);
+  ~ChartView();
   void addSignal(const MessageId &msg_id, const cabana::Signal *sig);
   bool hasSignal(const MessageId &msg_id, const cabana::Signal *sig) const;
   void updateSeries(const cabana::Signal *sig = nullptr, const MessageEventsMap *msg_new_events = nullptr);
+  void updateCompareSeries(const cabana::Signal *sig = nullptr);
   void updatePlot(double cur, double min, double max);
   void setSeriesType(SeriesType type);
   void updatePlotArea(int left, bool force = false);
@@ -49,6 +54,13 @@ public:
     std::vector<QPointF> step_vals;
     QPointF track_pt{};
     SegmentTree segment_tree;
+    // min/max decimation pyramid: level k collapses buckets of 8<<k points
+    // into their extrema, so zoomed-out renders use a bounded point count
+    std::vector<std::vector<QPointF>> lod_levels;
+    // dashed twin sampled from the comparison stream, when one is loaded
+    QXYSeries *cmp_series = nullptr;
+    std::vector<QPointF> cmp_vals;
+    std::vector<QPointF> cmp_step_vals;
     double min = 0;
     double max = 0;
   };
@@ -65,6 +77,15 @@ private slots:
   void signalRemoved(const cabana::Signal *sig) { removeIf([=](auto &s) { return s.sig == sig; }); }
 
 private:
+  // sampled off the GUI thread, swapped into the SigItem when ready
+  struct SampledSeries {
+    std::vector<QPointF> vals;
+    std::vector<QPointF> step_vals;
+    SegmentTree segment_tree;
+    std::vector<std::vector<QPointF>> lod_levels;
+  };
+  void applySampledSeries(const cabana::Signal *sig, int generation, std::shared_ptr<SampledSeries> result);
+  void updateRenderedSeries(SigItem &s);
   void appendCanEvents(const cabana::Signal *sig, const std::vector<const CanEvent *> &events,
                        std::vector<QPointF> &vals, std::vector<QPointF> &step_vals);
   void createToolButtons();
@@ -118,6 +139,9 @@ private:
   bool can_drop = false;
   double tooltip_x = -1;
   QFont signal_value_font;
+  // stale results are dropped by generation; pending futures are joined in the destructor
+  std::unordered_map<const cabana::Signal *, int> sample_generation_;
+  std::vector<std::future<void>> sample_jobs_;
   ChartsWidget *charts_widget;
   friend class ChartsWidget;
 };
@@ -1,15 +1,19 @@
 #include "tools/cabana/chart/chartswidget.h"
 
 #include <algorithm>
-#include <future>
 
 #include <QApplication>
+#include <QDialogButtonBox>
+#include <QDoubleSpinBox>
+#include <QFormLayout>
+#include <QLineEdit>
 #include <QMenu>
 #include <QMimeData>
 #include <QScrollBar>
 #include <QToolBar>
 
 #include "tools/cabana/chart/chart.h"
+#include "tools/cabana/streams/replaystream.h"
 
 const int MAX_COLUMN_COUNT = 4;
 const int CHART_SPACING = 4;
@@ -79,6 +83,8 @@ ChartsWidget::ChartsWidget(QWidget *parent) : QFrame(parent) {
   reset_zoom_action = toolbar->addWidget(reset_zoom_btn = new ToolButton("zoom-out", tr("Reset Zoom")));
   reset_zoom_btn->setToolButtonStyle(Qt::ToolButtonTextBesideIcon);
 
+  toolbar->addWidget(compare_btn = new ToolButton("layers", tr("Compare with another route")));
+  compare_btn->setVisible(!can->liveStreaming());
   toolbar->addWidget(remove_all_btn = new ToolButton("x-square", tr("Remove all charts")));
   toolbar->addWidget(dock_btn = new ToolButton(""));
   main_layout->addWidget(toolbar);
@@ -122,6 +128,7 @@ ChartsWidget::ChartsWidget(QWidget *parent) : QFrame(parent) {
   QObject::connect(can, &AbstractStream::timeRangeChanged, this, &ChartsWidget::timeRangeChanged);
   QObject::connect(range_slider, &QSlider::valueChanged, this, &ChartsWidget::setMaxChartRange);
   QObject::connect(new_plot_btn, &QToolButton::clicked, this, &ChartsWidget::newChart);
+  QObject::connect(compare_btn, &QToolButton::clicked, this, &ChartsWidget::openCompareRoute);
   QObject::connect(remove_all_btn, &QToolButton::clicked, this, &ChartsWidget::removeAll);
   QObject::connect(reset_zoom_btn, &QToolButton::clicked, this, &ChartsWidget::zoomReset);
   QObject::connect(&settings, &Settings::changed, this, &ChartsWidget::settingChanged);
@@ -129,7 +136,10 @@ ChartsWidget::ChartsWidget(QWidget *parent) : QFrame(parent) {
   QObject::connect(this, &ChartsWidget::seriesChanged, this, &ChartsWidget::updateTabBar);
   QObject::connect(tabbar, &QTabBar::tabCloseRequested, this, &ChartsWidget::removeTab);
   QObject::connect(tabbar, &QTabBar::currentChanged, [this](int index) {
-    if (index != -1) updateLayout(true);
+    if (index != -1) {
+      updateLayout(true);
+      refreshChartsInCurrentTab();
+    }
   });
   QObject::connect(dock_btn, &QToolButton::clicked, this, &ChartsWidget::toggleChartsDocking);
 
@@ -170,12 +180,68 @@ void ChartsWidget::updateTabBar() {
   }
 }
 
+AbstractStream *ChartsWidget::compareStream() const {
+  return compare_stream_.get();
+}
+
+// Load (or close) a second route whose signals are overlaid on every chart as
+// dashed series. The comparison stream shares the per-message event store
+// infrastructure of the main stream and stays paused; playback only drives
+// its segment decoding.
+void ChartsWidget::openCompareRoute() {
+  if (compare_stream_) {
+    compare_stream_.reset();
+    compare_btn->setToolTip(tr("Compare with another route"));
+    for (auto c : charts) c->updateCompareSeries();
+    return;
+  }
+
+  QDialog dlg(this);
+  dlg.setWindowTitle(tr("Compare Route"));
+  QFormLayout *form = new QFormLayout(&dlg);
+  auto route_edit = new QLineEdit(&dlg);
+  route_edit->setPlaceholderText(tr("Enter route name"));
+  route_edit->setMinimumWidth(300);
+  auto offset_spin = new QDoubleSpinBox(&dlg);
+  offset_spin->setRange(-3600, 3600);
+  offset_spin->setDecimals(2);
+  offset_spin->setSuffix(tr(" s"));
+  offset_spin->setToolTip(tr("Shift the comparison route on the time axis"));
+  form->addRow(tr("Route"), route_edit);
+  form->addRow(tr("Time offset"), offset_spin);
+  auto buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dlg);
+  form->addRow(buttons);
+  QObject::connect(buttons, &QDialogButtonBox::accepted, &dlg, &QDialog::accept);
+  QObject::connect(buttons, &QDialogButtonBox::rejected, &dlg, &QDialog::reject);
+  if (dlg.exec() != QDialog::Accepted || route_edit->text().isEmpty()) return;
+
+  auto stream = std::make_unique<ReplayStream>(nullptr);
+  if (!stream->loadRoute(route_edit->text().toStdString(), "", REPLAY_FLAG_NO_VIPC)) return;
+
+  compare_offset_ = offset_spin->value();
+  compare_stream_ = std::move(stream);
+  compare_stream_->start();
+  compare_stream_->pause(true);
+  compare_btn->setToolTip(tr("Close comparison route %1").arg(route_edit->text()));
+  QObject::connect(compare_stream_.get(), &AbstractStream::eventsMerged, this, [this]() {
+    for (auto c : charts) c->updateCompareSeries();
+  });
+  for (auto c : charts) c->updateCompareSeries();
+}
+
 void ChartsWidget::eventsMerged(const MessageEventsMap &new_events) {
-  std::vector<std::future<void>> futures;
+  // each chart dispatches its own sampling job and swaps the result in when
+  // ready; nothing here waits, so merges never stall the event loop. charts
+  // on hidden tabs skip the merge entirely and resample when their tab is
+  // shown, so dozens of saved charts don't tax playback.
+  const auto &visible = currentCharts();
   for (auto c : charts) {
-    futures.push_back(std::async(std::launch::async, &ChartView::updateSeries, c, nullptr, &new_events));
+    if (std::find(visible.begin(), visible.end(), c) != visible.end()) {
+      c->updateSeries(nullptr, &new_events);
+    } else {
+      stale_charts_.insert(c);
+    }
   }
-  for (auto &f : futures) f.get();
 }
 
 void ChartsWidget::timeRangeChanged(const std::optional<std::pair<double, double>> &time_range) {
@@ -218,8 +284,10 @@ void ChartsWidget::updateState() {
     display_range.second = display_range.first + max_chart_range;
   }
 
+  // axis ranges are computed once here and pushed to the visible tab only;
+  // hidden charts pick the current range up in refreshChartsInCurrentTab()
   const auto &range = time_range ? *time_range : display_range;
-  for (auto c : charts) {
+  for (auto c : currentCharts()) {
     c->updatePlot(cur_sec, range.first, range.second);
   }
 }
@@ -389,6 +457,16 @@ void ChartsWidget::updateLayout(bool force) {
   }
 }
 
+// Charts on a hidden tab miss event merges and plot-range updates while it's
+// hidden; bring them back up to date the moment the tab is shown.
+void ChartsWidget::refreshChartsInCurrentTab() {
+  for (auto c : currentCharts()) {
+    if (stale_charts_.erase(c)) c->updateSeries();
+  }
+  updateState();
+  alignCharts();
+}
+
 void ChartsWidget::startAutoScroll() {
   auto_scroll_timer->start(50);
 }
@@ -445,6 +523,7 @@ void ChartsWidget::newChart() {
 
 void ChartsWidget::removeChart(ChartView *chart) {
   charts.erase(std::remove(charts.begin(), charts.end(), chart), charts.end());
+  stale_charts_.erase(chart);
   chart->deleteLater();
   for (auto &[_, list] : tab_charts) {
     list.erase(std::remove(list.begin(), list.end(), chart), list.end());
@@ -460,6 +539,7 @@ void ChartsWidget::removeAll() {
     tabbar->removeTab(1);
   }
   tab_charts.clear();
+  stale_charts_.clear();
 
   if (!charts.empty()) {
     for (auto c : charts) {
@@ -472,12 +552,13 @@ void ChartsWidget::removeAll() {
 }
 
 void ChartsWidget::alignCharts() {
+  // only the visible tab needs aligned y labels; hidden tabs realign when shown
   int plot_left = 0;
-  for (auto c : charts) {
+  for (auto c : currentCharts()) {
     plot_left = std::max(plot_left, c->y_label_width);
   }
   plot_left = std::max((plot_left / 10) * 10 + 10, 50);
-  for (auto c : charts) {
+  for (auto c : currentCharts()) {
     c->updatePlotArea(plot_left);
   }
 }
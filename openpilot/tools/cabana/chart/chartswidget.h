@@ -1,6 +1,8 @@
 #pragma once
 
+#include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 #include <QGridLayout>
@@ -20,6 +22,7 @@ const QString CHART_MIME_TYPE = "application/x-cabanachartview";
 
 class ChartView;
 class ChartsWidget;
+class ReplayStream;
 
 class ChartsContainer : public QWidget {
 public:
@@ -45,6 +48,9 @@ public:
   inline bool hasSignal(const MessageId &id, const cabana::Signal *sig) { return findChart(id, sig) != nullptr; }
   QStringList serializeChartIds() const;
   void restoreChartsFromIds(const QStringList &chart_ids);
+  // second route loaded for comparison overlays; null when none is open
+  AbstractStream *compareStream() const;
+  double compareOffset() const { return compare_offset_; }
 
 public slots:
   void setColumnCount(int n);
@@ -79,8 +85,10 @@ private:
   void settingChanged();
   void showValueTip(double sec);
   bool eventFilter(QObject *obj, QEvent *event) override;
+  void openCompareRoute();
   void newTab();
   void removeTab(int index);
+  void refreshChartsInCurrentTab();
   inline std::vector<ChartView *> &currentCharts() { return tab_charts[tabbar->tabData(tabbar->currentIndex()).toInt()]; }
   ChartView *findChart(const MessageId &id, const cabana::Signal *sig);
 
@@ -100,8 +108,13 @@ private:
   QUndoStack *zoom_undo_stack;
 
   ToolButton *remove_all_btn;
+  ToolButton *compare_btn = nullptr;
+  std::unique_ptr<ReplayStream> compare_stream_;
+  double compare_offset_ = 0;
   std::vector<ChartView *> charts;
   std::unordered_map<int, std::vector<ChartView *>> tab_charts;
+  // charts on hidden tabs that skipped event merges and resample when shown
+  std::unordered_set<ChartView *> stale_charts_;
   TabBar *tabbar;
   ChartsContainer *charts_container;
   QScrollArea *charts_scroll;
@@ -5,37 +5,55 @@
 #include <QPainter>
 
 void Sparkline::update(const cabana::Signal *sig, CanEventIter first, CanEventIter last, int range, QSize size) {
-  if (first == last || size.isEmpty()) {
-    pixmap = QPixmap();
+  const size_t count = std::distance(first, last);
+  const uint64_t first_time = count ? (*first)->mono_time : 0;
+  const uint64_t last_time = count ? (*std::prev(last))->mono_time : 0;
+  const bool same_samples = sig == sig_ && first_time == first_time_ && last_time == last_time_ && count == event_count_;
+  if (same_samples && range == range_ && size == size_ && sig && sig->color == color_) {
+    needs_repaint_ = false;  // unchanged since the last tick (e.g. paused stream)
+    return;
+  }
+  sig_ = sig;
+  first_time_ = first_time;
+  last_time_ = last_time;
+  event_count_ = count;
+  range_ = range;
+  size_ = size;
+  needs_repaint_ = true;
+
+  if (count == 0 || size.isEmpty()) {
+    points_.clear();
     return;
   }
 
-  points_.clear();
-  min_val = std::numeric_limits<double>::max();
-  max_val = std::numeric_limits<double>::lowest();
-  points_.reserve(std::distance(first, last));
+  if (!same_samples) {
+    points_.clear();
+    sample_min_ = std::numeric_limits<double>::max();
+    sample_max_ = std::numeric_limits<double>::lowest();
+    points_.reserve(count);
 
-  uint64_t start_time = (*first)->mono_time;
-  double value = 0.0;
-  for (auto it = first; it != last; ++it) {
-    if (sig->getValue((*it)->dat, (*it)->size, &value)) {
-      min_val = std::min(min_val, value);
-      max_val = std::max(max_val, value);
-      points_.emplace_back(((*it)->mono_time - start_time) / 1e9, value);
+    const cabana::SignalDecoder decoder(*sig);
+    double value = 0.0;
+    for (auto it = first; it != last; ++it) {
+      if (decoder.getValue((*it)->dat, (*it)->size, &value)) {
+        sample_min_ = std::min(sample_min_, value);
+        sample_max_ = std::max(sample_max_, value);
+        points_.emplace_back(((*it)->mono_time - first_time) / 1e9, value);
+      }
     }
   }
 
-  if (points_.empty()) {
-    pixmap = QPixmap();
-    return;
-  }
+  if (points_.empty()) return;
 
   freq_ = points_.size() / std::max(points_.back().x() - points_.front().x(), 1.0);
-  render(sig->color, range, size);
+  color_ = sig->color;
+  render(range, size);
 }
 
-void Sparkline::render(const QColor &color, int range, QSize size) {
-  // Adjust for flat lines
+void Sparkline::render(int range, QSize size) {
+  // Adjust for flat lines (reset from the raw extremes so cached samples re-render cleanly)
+  min_val = sample_min_;
+  max_val = sample_max_;
   bool is_flat_line = min_val == max_val;
   if (is_flat_line) {
     min_val -= 1.0;
@@ -45,12 +63,12 @@ void Sparkline::render(const QColor &color, int range, QSize size) {
   // Calculate scaling
   const double xscale = (size.width() - 1) / (double)range;
   const double yscale = (size.height() - 3) / (max_val - min_val);
-  bool draw_individual_points = (points_.back().x() * xscale / points_.size()) > 8.0;
+  draw_individual_points_ = (points_.back().x() * xscale / points_.size()) > 8.0;
 
   // Transform or downsample points
   render_points_.reserve(points_.size());
   render_points_.clear();
-  if (draw_individual_points) {
+  if (draw_individual_points_) {
     for (const auto &p : points_) {
       render_points_.emplace_back(p.x() * xscale, 1.0 + (max_val - p.y()) * yscale);
     }
@@ -77,10 +95,20 @@ void Sparkline::render(const QColor &color, int range, QSize size) {
     }
     if (in_flat) render_points_.emplace_back(points_.back().x() * xscale, 1.0 + (max_val - prev_y) * yscale);
   }
+}
+
+void Sparkline::paint() {
+  if (!needs_repaint_) return;
+  needs_repaint_ = false;
+
+  if (points_.empty() || event_count_ == 0 || size_.isEmpty()) {
+    pixmap = QPixmap();
+    return;
+  }
 
   // Render to pixmap
   qreal dpr = qApp->devicePixelRatio();
-  const QSize pixmap_size = size * dpr;
+  const QSize pixmap_size = size_ * dpr;
   if (pixmap.size() != pixmap_size) {
     pixmap = QPixmap(pixmap_size);
   }
@@ -88,11 +116,11 @@ void Sparkline::render(const QColor &color, int range, QSize size) {
   pixmap.fill(Qt::transparent);
   QPainter painter(&pixmap);
   painter.setRenderHint(QPainter::Antialiasing, render_points_.size() <= 500);
-  painter.setPen(color);
+  painter.setPen(color_);
   painter.drawPolyline(render_points_.data(), render_points_.size());
 
-  painter.setPen(QPen(color, 3));
-  if (draw_individual_points) {
+  painter.setPen(QPen(color_, 3));
+  if (draw_individual_points_) {
     painter.drawPoints(render_points_.data(), render_points_.size());
   } else {
     painter.drawPoint(render_points_.back());
@@ -9,7 +9,12 @@
 
 class Sparkline {
 public:
+  // Samples and lays out the polyline on a worker thread; samples are cached
+  // and reused as long as the event window, range and size are unchanged.
   void update(const cabana::Signal *sig, CanEventIter first, CanEventIter last, int range, QSize size);
+  // Paints the laid-out polyline to the pixmap. Must be called on the GUI thread.
+  void paint();
+  void invalidate() { sig_ = nullptr; }
   inline double freq() const { return freq_; }
   bool isEmpty() const { return pixmap.isNull(); }
 
@@ -18,9 +23,22 @@ public:
   double max_val = 0;
 
 private:
-  void render(const QColor &color, int range, QSize size);
+  void render(int range, QSize size);
 
   std::vector<QPointF> points_;
   std::vector<QPointF> render_points_;
   double freq_ = 0;
+
+  // sample cache key: resample only when the signal or event window changed
+  double sample_min_ = 0;
+  double sample_max_ = 0;
+  const cabana::Signal *sig_ = nullptr;
+  uint64_t first_time_ = 0;
+  uint64_t last_time_ = 0;
+  size_t event_count_ = 0;
+  int range_ = 0;
+  QSize size_;
+  bool draw_individual_points_ = false;
+  bool needs_repaint_ = false;
+  QColor color_;
 };
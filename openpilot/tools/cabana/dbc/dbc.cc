@@ -165,6 +165,28 @@ bool cabana::Signal::getValue(const uint8_t *data, size_t data_size, double *val
   return true;
 }
 
+// cabana::SignalDecoder
+
+cabana::SignalDecoder::SignalDecoder(const Signal &sig) {
+  plan_.init(sig);
+  if (sig.multiplexor) {
+    mux_plan_.init(*sig.multiplexor);
+    has_mux_ = true;
+  }
+}
+
+void cabana::SignalDecoder::Plan::init(const Signal &s) {
+  sig = &s;
+  // the single load/shift/mask applies when the whole signal sits in the
+  // first 8 payload bytes; anything else falls back to get_raw_value
+  word_wide = s.msb < 64 && s.lsb < 64 && s.size > 0;
+  if (!word_wide) return;
+
+  shift = s.is_little_endian ? s.lsb : (7 - s.lsb / 8) * 8 + (s.lsb & 7);
+  mask = s.size == 64 ? ~0ULL : (1ULL << s.size) - 1;
+  sign_bit = s.is_signed ? 1ULL << (s.size - 1) : 0;
+}
+
 bool cabana::Signal::operator==(const cabana::Signal &other) const {
   return name == other.name && size == other.size &&
          start_bit == other.start_bit &&
@@ -2,6 +2,7 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <limits>
 #include <string>
@@ -61,6 +62,9 @@ struct std::hash<MessageId> {
 typedef std::vector<std::pair<double, std::string>> ValueDescription;
 Q_DECLARE_METATYPE(ValueDescription);
 
+namespace cabana { class Signal; }
+double get_raw_value(const uint8_t *data, size_t data_size, const cabana::Signal &sig);
+
 namespace cabana {
 
 class Signal {
@@ -99,6 +103,47 @@ public:
   Signal *multiplexor = nullptr;
 };
 
+// Batch decode support: resolves a signal's bit layout once so loops over
+// thousands of events skip the per-call byte walk in get_raw_value. Frames of
+// 8+ bytes with the signal inside the first word (the common case on CAN)
+// decode with a single word load, shift and mask.
+class SignalDecoder {
+public:
+  explicit SignalDecoder(const Signal &sig);
+  inline bool getValue(const uint8_t *data, size_t data_size, double *val) const {
+    if (has_mux_ && mux_plan_.extract(data, data_size) != plan_.sig->multiplex_value) {
+      return false;
+    }
+    *val = plan_.extract(data, data_size);
+    return true;
+  }
+
+private:
+  struct Plan {
+    void init(const Signal &s);
+    inline double extract(const uint8_t *data, size_t data_size) const {
+      if (word_wide && data_size >= 8) {
+        uint64_t w;
+        memcpy(&w, data, sizeof(w));
+        if (!sig->is_little_endian) w = __builtin_bswap64(w);
+        uint64_t val = (w >> shift) & mask;
+        if (val & sign_bit) val |= ~mask;
+        return static_cast<int64_t>(val) * sig->factor + sig->offset;
+      }
+      return get_raw_value(data, data_size, *sig);
+    }
+
+    const Signal *sig = nullptr;
+    bool word_wide = false;
+    int shift = 0;
+    uint64_t mask = 0;
+    uint64_t sign_bit = 0;
+  };
+  Plan plan_;
+  Plan mux_plan_;
+  bool has_mux_ = false;
+};
+
 class Msg {
 public:
   Msg() = default;
@@ -1,23 +1,148 @@
 #include "tools/cabana/dbc/dbcfile.h"
 
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
 #include <QFile>
 #include <QFileInfo>
-#include <QRegularExpression>
 #include <QString>
 
+namespace {
+
+constexpr bool is_word_char(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+std::string_view trim_view(std::string_view s) {
+  while (!s.empty() && std::isspace((unsigned char)s.front())) s.remove_prefix(1);
+  while (!s.empty() && std::isspace((unsigned char)s.back())) s.remove_suffix(1);
+  return s;
+}
+
+bool starts_with(std::string_view s, std::string_view prefix) {
+  return s.size() >= prefix.size() && s.compare(0, prefix.size(), prefix) == 0;
+}
+
+bool ends_with(std::string_view s, std::string_view suffix) {
+  return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// comments only un-escape quotes; other backslashes are kept verbatim
+std::string unescape_quotes(std::string_view s) {
+  std::string out;
+  out.reserve(s.size());
+  for (size_t i = 0; i < s.size(); ++i) {
+    if (s[i] == '\\' && i + 1 < s.size() && s[i + 1] == '"') {
+      out += '"';
+      ++i;
+    } else {
+      out += s[i];
+    }
+  }
+  return out;
+}
+
+// cursor over one line. The DBC grammar is simple enough that a hand-rolled
+// scanner replaces a regex match per line; tokens are views into the file
+// buffer, so nothing is allocated until a value is actually stored.
+class LineParser {
+public:
+  explicit LineParser(std::string_view s) : s_(s) {}
+
+  void skipSpace() {
+    while (!s_.empty() && (s_.front() == ' ' || s_.front() == '\t')) s_.remove_prefix(1);
+  }
+  char peek() {
+    skipSpace();
+    return s_.empty() ? '\0' : s_.front();
+  }
+  char take() {
+    skipSpace();
+    if (s_.empty()) throw std::runtime_error("unexpected end of line");
+    char c = s_.front();
+    s_.remove_prefix(1);
+    return c;
+  }
+  void expect(char c) {
+    if (take() != c) throw std::runtime_error(std::string("expected '") + c + "'");
+  }
+  std::string_view token() {
+    skipSpace();
+    size_t n = 0;
+    while (n < s_.size() && is_word_char(s_[n])) ++n;
+    if (n == 0) throw std::runtime_error("expected identifier");
+    auto t = s_.substr(0, n);
+    s_.remove_prefix(n);
+    return t;
+  }
+  uint64_t uint() {
+    skipSpace();
+    size_t n = 0;
+    uint64_t v = 0;
+    while (n < s_.size() && std::isdigit((unsigned char)s_[n])) v = v * 10 + (s_[n++] - '0');
+    if (n == 0) throw std::runtime_error("expected number");
+    s_.remove_prefix(n);
+    return v;
+  }
+  double number() {
+    skipSpace();
+    size_t n = 0;
+    while (n < s_.size() && (std::isdigit((unsigned char)s_[n]) || strchr(".+-eE", s_[n]))) ++n;
+    char buf[64];
+    if (n == 0 || n >= sizeof(buf)) throw std::runtime_error("expected number");
+    memcpy(buf, s_.data(), n);
+    buf[n] = '\0';
+    char *end = nullptr;
+    double v = strtod(buf, &end);
+    if (end != buf + n) throw std::runtime_error("invalid number");
+    s_.remove_prefix(n);
+    return v;
+  }
+  // contents of a quoted string; backslash-aware so escaped quotes don't terminate it
+  std::string_view quoted() {
+    expect('"');
+    size_t i = 0;
+    while (i < s_.size() && s_[i] != '"') i += (s_[i] == '\\' && i + 1 < s_.size()) ? 2 : 1;
+    if (i >= s_.size()) throw std::runtime_error("unterminated string");
+    auto t = s_.substr(0, i);
+    s_.remove_prefix(i + 1);
+    return t;
+  }
+  bool atEnd() {
+    skipSpace();
+    return s_.empty();
+  }
+  std::string_view rest() const { return s_; }
+
+private:
+  std::string_view s_;
+};
+
+// comments may span lines; extend the view to the closing quote-semicolon
+std::string_view full_comment_line(std::string_view line, const std::string &content) {
+  if (ends_with(line, "\";")) return line;
+  size_t start = line.data() - content.data();
+  size_t end = content.find("\";", start);
+  if (end == std::string::npos) throw std::runtime_error("unterminated comment");
+  return std::string_view(content.data() + start, end + 2 - start);
+}
+
+}  // namespace
+
 DBCFile::DBCFile(const std::string &dbc_file_name) {
   QFile file(QString::fromStdString(dbc_file_name));
   if (file.open(QIODevice::ReadOnly)) {
     name_ = QFileInfo(QString::fromStdString(dbc_file_name)).baseName().toStdString();
     filename = dbc_file_name;
-    parse(file.readAll());
+    parse(file.readAll().toStdString());
   } else {
     throw std::runtime_error("Failed to open file.");
   }
 }
 
 DBCFile::DBCFile(const std::string &name, const std::string &content) : name_(name), filename("") {
-  parse(QString::fromStdString(content));
+  parse(content);
 }
 
 bool DBCFile::save() {
@@ -63,45 +188,49 @@ cabana::Signal *DBCFile::signal(uint32_t address, const std::string &name) {
   return m ? (cabana::Signal *)m->sig(name) : nullptr;
 }
 
-void DBCFile::parse(const QString &content) {
+void DBCFile::parse(const std::string &content) {
   msgs.clear();
 
   int line_num = 0;
-  QString line;
   cabana::Msg *current_msg = nullptr;
   int multiplexor_cnt = 0;
   bool seen_first = false;
-  QTextStream stream((QString *)&content);
 
-  while (!stream.atEnd()) {
+  size_t pos = 0;
+  while (pos < content.size()) {
+    size_t eol = content.find('\n', pos);
+    size_t len = (eol == std::string::npos ? content.size() : eol) - pos;
+    std::string_view raw_line(content.data() + pos, len);
+    if (!raw_line.empty() && raw_line.back() == '\r') raw_line.remove_suffix(1);
+    pos = (eol == std::string::npos) ? content.size() : eol + 1;
+
     ++line_num;
-    QString raw_line = stream.readLine();
-    line = raw_line.trimmed();
+    std::string_view line = trim_view(raw_line);
 
     bool seen = true;
     try {
-      if (line.startsWith("BO_ ")) {
+      if (starts_with(line, "BO_ ")) {
         multiplexor_cnt = 0;
         current_msg = parseBO(line);
-      } else if (line.startsWith("SG_ ")) {
+      } else if (starts_with(line, "SG_ ")) {
         parseSG(line, current_msg, multiplexor_cnt);
-      } else if (line.startsWith("VAL_ ")) {
+      } else if (starts_with(line, "VAL_ ")) {
         parseVAL(line);
-      } else if (line.startsWith("CM_ BO_")) {
-        parseCM_BO(line, content, raw_line, stream);
-      } else if (line.startsWith("CM_ SG_ ")) {
-        parseCM_SG(line, content, raw_line, stream);
+      } else if (starts_with(line, "CM_ BO_")) {
+        parseCM_BO(line, content);
+      } else if (starts_with(line, "CM_ SG_ ")) {
+        parseCM_SG(line, content);
       } else {
         seen = false;
       }
     } catch (std::exception &e) {
-      throw std::runtime_error(QString("[%1:%2]%3: %4").arg(QString::fromStdString(filename)).arg(line_num).arg(e.what()).arg(line).toStdString());
+      throw std::runtime_error("[" + filename + ":" + std::to_string(line_num) + "]" + e.what() + ": " + std::string(line));
     }
 
     if (seen) {
       seen_first = true;
     } else if (!seen_first) {
-      header += raw_line.toStdString() + "\n";
+      header += std::string(raw_line) + "\n";
     }
   }
 
@@ -110,65 +239,44 @@ void DBCFile::parse(const QString &content) {
   }
 }
 
-cabana::Msg *DBCFile::parseBO(const QString &line) {
-  static QRegularExpression bo_regexp(R"(^BO_ (?<address>\w+) (?<name>\w+) *: (?<size>\w+) (?<transmitter>\w+))");
-
-  QRegularExpressionMatch match = bo_regexp.match(line);
-  if (!match.hasMatch())
-    throw std::runtime_error("Invalid BO_ line format");
-
-  uint32_t address = match.captured("address").toUInt();
+cabana::Msg *DBCFile::parseBO(std::string_view line) {
+  LineParser p(line.substr(4));
+  uint32_t address = p.uint();
   if (msgs.count(address) > 0)
-    throw std::runtime_error(QString("Duplicate message address: %1").arg(address).toStdString());
+    throw std::runtime_error("Duplicate message address: " + std::to_string(address));
 
   // Create a new message object
   cabana::Msg *msg = &msgs[address];
   msg->address = address;
-  msg->name = match.captured("name").toStdString();
-  msg->size = match.captured("size").toULong();
-  msg->transmitter = match.captured("transmitter").trimmed().toStdString();
+  msg->name = std::string(p.token());
+  p.expect(':');
+  msg->size = p.uint();
+  msg->transmitter = std::string(p.token());
   return msg;
 }
 
-void DBCFile::parseCM_BO(const QString &line, const QString &content, const QString &raw_line, const QTextStream &stream) {
-  static QRegularExpression msg_comment_regexp(R"(^CM_ BO_ *(?<address>\w+) *\"(?<comment>(?:[^"\\]|\\.)*)\"\s*;)");
+void DBCFile::parseCM_BO(std::string_view line, const std::string &content) {
+  LineParser p(full_comment_line(line, content).substr(7));
+  uint32_t address = p.uint();
+  std::string_view comment = p.quoted();
+  p.expect(';');
 
-  QString parse_line = line;
-  if (!parse_line.endsWith("\";")) {
-    int pos = stream.pos() - raw_line.length() - 1;
-    parse_line = content.mid(pos, content.indexOf("\";", pos));
-  }
-  auto match = msg_comment_regexp.match(parse_line);
-  if (!match.hasMatch())
-    throw std::runtime_error("Invalid message comment format");
-
-  if (auto m = (cabana::Msg *)msg(match.captured("address").toUInt()))
-    m->comment = match.captured("comment").trimmed().replace("\\\"", "\"").toStdString();
+  if (auto m = msg(address))
+    m->comment = unescape_quotes(trim_view(comment));
 }
 
-void DBCFile::parseSG(const QString &line, cabana::Msg *current_msg, int &multiplexor_cnt) {
-  static QRegularExpression sg_regexp(R"(^SG_ (\w+) *: (\d+)\|(\d+)@(\d+)([\+|\-]) \(([0-9.+\-eE]+),([0-9.+\-eE]+)\) \[([0-9.+\-eE]+)\|([0-9.+\-eE]+)\] \"(.*)\" (.*))");
-  static QRegularExpression sgm_regexp(R"(^SG_ (\w+) (\w+) *: (\d+)\|(\d+)@(\d+)([\+|\-]) \(([0-9.+\-eE]+),([0-9.+\-eE]+)\) \[([0-9.+\-eE]+)\|([0-9.+\-eE]+)\] \"(.*)\" (.*))");
-
+void DBCFile::parseSG(std::string_view line, cabana::Msg *current_msg, int &multiplexor_cnt) {
   if (!current_msg)
     throw std::runtime_error("No Message");
 
-  int offset = 0;
-  auto match = sg_regexp.match(line);
-  if (!match.hasMatch()) {
-    match = sgm_regexp.match(line);
-    offset = 1;
-  }
-  if (!match.hasMatch())
-    throw std::runtime_error("Invalid SG_ line format");
-
-  std::string name = match.captured(1).toStdString();
+  LineParser p(line.substr(4));
+  std::string name(p.token());
   if (current_msg->sig(name) != nullptr)
     throw std::runtime_error("Duplicate signal name");
 
   cabana::Signal s{};
-  if (offset == 1) {
-    auto indicator = match.captured(2);
+  if (p.peek() != ':') {
+    std::string_view indicator = p.token();
     if (indicator == "M") {
       ++multiplexor_cnt;
       // Only one signal within a single message can be the multiplexer switch.
@@ -176,57 +284,58 @@ void DBCFile::parseSG(const QString &line, cabana::Msg *current_msg, int &multip
         throw std::runtime_error("Multiple multiplexor");
 
       s.type = cabana::Signal::Type::Multiplexor;
-    } else {
+    } else if (indicator.size() > 1 && indicator.front() == 'm') {
       s.type = cabana::Signal::Type::Multiplexed;
-      s.multiplex_value = indicator.mid(1).toInt();
+      s.multiplex_value = (int)strtol(std::string(indicator.substr(1)).c_str(), nullptr, 10);
+    } else {
+      throw std::runtime_error("Invalid SG_ line format");
     }
   }
   s.name = name;
-  s.start_bit = match.captured(offset + 2).toInt();
-  s.size = match.captured(offset + 3).toInt();
-  s.is_little_endian = match.captured(offset + 4).toInt() == 1;
-  s.is_signed = match.captured(offset + 5) == "-";
-  s.factor = match.captured(offset + 6).toDouble();
-  s.offset = match.captured(offset + 7).toDouble();
-  s.min = match.captured(8 + offset).toDouble();
-  s.max = match.captured(9 + offset).toDouble();
-  s.unit = match.captured(10 + offset).toStdString();
-  s.receiver_name = match.captured(11 + offset).trimmed().toStdString();
+  p.expect(':');
+  s.start_bit = p.uint();
+  p.expect('|');
+  s.size = p.uint();
+  p.expect('@');
+  s.is_little_endian = p.uint() == 1;
+  s.is_signed = p.take() == '-';
+  p.expect('(');
+  s.factor = p.number();
+  p.expect(',');
+  s.offset = p.number();
+  p.expect(')');
+  p.expect('[');
+  s.min = p.number();
+  p.expect('|');
+  s.max = p.number();
+  p.expect(']');
+  s.unit = std::string(p.quoted());
+  s.receiver_name = std::string(trim_view(p.rest()));
   current_msg->sigs.push_back(new cabana::Signal(s));
 }
 
-void DBCFile::parseCM_SG(const QString &line, const QString &content, const QString &raw_line, const QTextStream &stream) {
-  static QRegularExpression sg_comment_regexp(R"(^CM_ SG_ *(\w+) *(\w+) *\"((?:[^"\\]|\\.)*)\"\s*;)");
-
-  QString parse_line = line;
-  if (!parse_line.endsWith("\";")) {
-    int pos = stream.pos() - raw_line.length() - 1;
-    parse_line = content.mid(pos, content.indexOf("\";", pos));
-  }
-  auto match = sg_comment_regexp.match(parse_line);
-  if (!match.hasMatch())
-    throw std::runtime_error("Invalid CM_ SG_ line format");
+void DBCFile::parseCM_SG(std::string_view line, const std::string &content) {
+  LineParser p(full_comment_line(line, content).substr(8));
+  uint32_t address = p.uint();
+  std::string sig_name(p.token());
+  std::string_view comment = p.quoted();
+  p.expect(';');
 
-  if (auto s = signal(match.captured(1).toUInt(), match.captured(2).toStdString())) {
-    s->comment = match.captured(3).trimmed().replace("\\\"", "\"").toStdString();
+  if (auto s = signal(address, sig_name)) {
+    s->comment = unescape_quotes(trim_view(comment));
   }
 }
 
-void DBCFile::parseVAL(const QString &line) {
-  static QRegularExpression val_regexp(R"(VAL_ (\w+) (\w+) (\s*[-+]?[0-9]+\s+\".+?\"[^;]*))");
+void DBCFile::parseVAL(std::string_view line) {
+  LineParser p(line.substr(5));
+  uint32_t address = p.uint();
+  std::string sig_name(p.token());
 
-  auto match = val_regexp.match(line);
-  if (!match.hasMatch())
-    throw std::runtime_error("invalid VAL_ line format");
-
-  if (auto s = signal(match.captured(1).toUInt(), match.captured(2).toStdString())) {
-    QStringList desc_list = match.captured(3).trimmed().split('"');
-    for (int i = 0; i < desc_list.size(); i += 2) {
-      auto val = desc_list[i].trimmed();
-      if (!val.isEmpty() && (i + 1) < desc_list.size()) {
-        auto desc = desc_list[i + 1].trimmed();
-        s->val_desc.push_back({val.toDouble(), desc.toStdString()});
-      }
+  // only spend time on the description list when the signal actually exists
+  if (auto s = signal(address, sig_name)) {
+    while (!p.atEnd() && p.peek() != ';') {
+      double val = p.number();
+      s->val_desc.push_back({val, std::string(trim_view(p.quoted()))});
     }
   }
 }
@@ -2,7 +2,7 @@
 
 #include <map>
 #include <string>
-#include <QTextStream>
+#include <string_view>
 
 #include "tools/cabana/dbc/dbc.h"
 
@@ -32,12 +32,14 @@ public:
   std::string filename;
 
 private:
-  void parse(const QString &content);
-  cabana::Msg *parseBO(const QString &line);
-  void parseSG(const QString &line, cabana::Msg *current_msg, int &multiplexor_cnt);
-  void parseCM_BO(const QString &line, const QString &content, const QString &raw_line, const QTextStream &stream);
-  void parseCM_SG(const QString &line, const QString &content, const QString &raw_line, const QTextStream &stream);
-  void parseVAL(const QString &line);
+  // single-pass parser: line views point into content, so tokens are only
+  // copied into std::strings at the moment they are stored on a Msg/Signal
+  void parse(const std::string &content);
+  cabana::Msg *parseBO(std::string_view line);
+  void parseSG(std::string_view line, cabana::Msg *current_msg, int &multiplexor_cnt);
+  void parseCM_BO(std::string_view line, const std::string &content);
+  void parseCM_SG(std::string_view line, const std::string &content);
+  void parseVAL(std::string_view line);
 
   std::string header;
   std::map<uint32_t, cabana::Msg> msgs;
@@ -58,7 +58,7 @@ void DBCManager::addSignal(const MessageId &id, const cabana::Signal &sig) {
   if (auto m = msg(id)) {
     if (auto s = m->addSignal(sig)) {
       emit signalAdded(id, s);
-      emit maskUpdated();
+      emit maskUpdated(id);
     }
   }
 }
@@ -67,7 +67,7 @@ void DBCManager::updateSignal(const MessageId &id, const std::string &sig_name,
   if (auto m = msg(id)) {
     if (auto s = m->updateSignal(sig_name, sig)) {
       emit signalUpdated(s);
-      emit maskUpdated();
+      emit maskUpdated(id);
     }
   }
 }
@@ -77,7 +77,7 @@ void DBCManager::removeSignal(const MessageId &id, const std::string &sig_name)
     if (auto s = m->sig(sig_name)) {
       emit signalRemoved(s);
       m->removeSignal(sig_name);
-      emit maskUpdated();
+      emit maskUpdated(id);
     }
   }
 }
@@ -94,7 +94,7 @@ void DBCManager::removeMsg(const MessageId &id) {
   assert(dbc_file);  // This should be impossible
   dbc_file->removeMsg(id);
   emit msgRemoved(id);
-  emit maskUpdated();
+  emit maskUpdated(id);
 }
 
 std::string DBCManager::newMsgName(const MessageId &id) {
@@ -56,7 +56,9 @@ signals:
   void msgUpdated(MessageId id);
   void msgRemoved(MessageId id);
   void DBCFileChanged();
-  void maskUpdated();
+  // scoped to the edited message so listeners only invalidate state that
+  // actually depends on it; file-level changes go through DBCFileChanged
+  void maskUpdated(MessageId id);
 
 private:
   std::map<int, std::shared_ptr<DBCFile>> dbc_files;
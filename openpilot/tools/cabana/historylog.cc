@@ -1,5 +1,6 @@
 #include "tools/cabana/historylog.h"
 
+#include <algorithm>
 #include <functional>
 
 #include <QFileDialog>
@@ -10,7 +11,7 @@
 #include "tools/cabana/utils/export.h"
 
 QVariant HistoryLogModel::data(const QModelIndex &index, int role) const {
-  const auto &m = messages[index.row()];
+  const auto &m = messageForRow(index.row());
   const int col = index.column();
   if (role == Qt::DisplayRole) {
     if (col == 0) return QString::number(can->toSeconds(m.mono_time), 'f', 3);
@@ -37,7 +38,11 @@ void HistoryLogModel::reset() {
   if (auto dbc_msg = dbc()->msg(msg_id)) {
     sigs = dbc_msg->getSignals();
   }
-  messages.clear();
+  row_count_ = 0;
+  last_idx_ = -1;
+  filtered_ids_.clear();
+  cache_.clear();
+  cache_start_row_ = 0;
   hex_colors = {};
   endResetModel();
   setFilter(0, "", nullptr);
@@ -75,60 +80,116 @@ void HistoryLogModel::setFilter(int sig_idx, const QString &value, std::function
 }
 
 void HistoryLogModel::updateState(bool clear) {
-  if (clear && !messages.empty()) {
-    beginRemoveRows({}, 0, messages.size() - 1);
-    messages.clear();
-    endRemoveRows();
-  }
+  const auto &events = can->events(msg_id);
   uint64_t current_time = can->toMonoTime(can->lastMessage(msg_id).ts) + 1;
-  fetchData(messages.begin(), current_time, messages.empty() ? 0 : messages.front().mono_time);
+  int new_last = std::upper_bound(events.begin(), events.end(), current_time, CompareCanEvent()) - events.begin() - 1;
+
+  // remove/insert instead of a model reset so the filter UI (cleared on
+  // modelReset) survives a refresh
+  if (clear || new_last < last_idx_) {
+    if (row_count_ > 0) {
+      beginRemoveRows({}, 0, row_count_ - 1);
+      row_count_ = 0;
+      endRemoveRows();
+    }
+    last_idx_ = new_last;
+    rebuildFilterIndex();
+    cache_.clear();
+    cache_start_row_ = 0;
+    int new_count = filter_cmp ? (int)filtered_ids_.size() : last_idx_ + 1;
+    if (new_count > 0) {
+      beginInsertRows({}, 0, new_count - 1);
+      row_count_ = new_count;
+      endInsertRows();
+    }
+    return;
+  }
+  if (new_last == last_idx_) return;
+
+  // time only moved forward: new events surface as rows prepended at the top
+  int added = 0;
+  if (filter_cmp) {
+    for (int i = last_idx_ + 1; i <= new_last; ++i) {
+      if (matchesFilter(events[i])) {
+        filtered_ids_.push_back(i);
+        ++added;
+      }
+    }
+  } else {
+    added = new_last - last_idx_;
+  }
+  last_idx_ = new_last;
+  if (added > 0) {
+    beginInsertRows({}, 0, added - 1);
+    row_count_ += added;
+    cache_start_row_ += added;
+    endInsertRows();
+  }
 }
 
-bool HistoryLogModel::canFetchMore(const QModelIndex &parent) const {
-  const auto &events = can->events(msg_id);
-  return !events.empty() && !messages.empty() && messages.back().mono_time > events.front()->mono_time;
+int HistoryLogModel::eventIndexForRow(int row) const {
+  // row 0 is the newest visible event
+  return filter_cmp ? (int)filtered_ids_[filtered_ids_.size() - 1 - row] : last_idx_ - row;
 }
 
-void HistoryLogModel::fetchMore(const QModelIndex &parent) {
-  if (!messages.empty())
-    fetchData(messages.end(), messages.back().mono_time, 0);
+bool HistoryLogModel::matchesFilter(const CanEvent *e) const {
+  double value = 0;
+  sigs[filter_sig_idx]->getValue(e->dat, e->size, &value);
+  return filter_cmp(value, filter_value);
 }
 
-void HistoryLogModel::fetchData(std::deque<Message>::iterator insert_pos, uint64_t from_time, uint64_t min_time) {
+void HistoryLogModel::rebuildFilterIndex() {
+  filtered_ids_.clear();
+  if (!filter_cmp) return;
+
+  // one linear pass storing indices only; a fully matching 100Hz hour is a
+  // few MB, nothing like materializing the rows themselves
   const auto &events = can->events(msg_id);
-  auto first = std::upper_bound(events.rbegin(), events.rend(), from_time, [](uint64_t ts, auto e) {
-    return ts > e->mono_time;
-  });
-
-  std::vector<HistoryLogModel::Message> msgs;
-  std::vector<double> values(sigs.size());
-  msgs.reserve(batch_size);
-  for (; first != events.rend() && (*first)->mono_time > min_time; ++first) {
-    const CanEvent *e = *first;
-    for (int i = 0; i < sigs.size(); ++i) {
-      sigs[i]->getValue(e->dat, e->size, &values[i]);
-    }
-    if (!filter_cmp || filter_cmp(values[filter_sig_idx], filter_value)) {
-       msgs.emplace_back(Message{e->mono_time, values, {e->dat, e->dat + e->size}});
-      if (msgs.size() >= batch_size && min_time == 0) {
-        break;
-      }
+  for (int i = 0; i <= last_idx_; ++i) {
+    if (matchesFilter(events[i])) {
+      filtered_ids_.push_back(i);
     }
   }
+}
 
-  if (!msgs.empty()) {
-    if (isHexMode() && (min_time > 0 || messages.empty())) {
-      const auto freq = can->lastMessage(msg_id).freq;
-      const std::vector<uint8_t> no_mask;
-      for (auto &m : msgs) {
-        hex_colors.compute(msg_id, m.data.data(), m.data.size(), m.mono_time / (double)1e9, can->getSpeed(), no_mask, freq);
-        m.colors = hex_colors.colors;
-      }
+HistoryLogModel::Message HistoryLogModel::decode(const CanEvent *e) const {
+  Message m;
+  m.mono_time = e->mono_time;
+  m.data.assign(e->dat, e->dat + e->size);
+  m.sig_values.resize(sigs.size());
+  for (size_t i = 0; i < sigs.size(); ++i) {
+    sigs[i]->getValue(e->dat, e->size, &m.sig_values[i]);
+  }
+  return m;
+}
+
+const HistoryLogModel::Message &HistoryLogModel::messageForRow(int row) const {
+  if (row < cache_start_row_ || row >= cache_start_row_ + (int)cache_.size()) {
+    rebuildCache(row);
+  }
+  return cache_[row - cache_start_row_];
+}
+
+void HistoryLogModel::rebuildCache(int anchor_row) const {
+  const auto &events = can->events(msg_id);
+  int start = std::max(0, anchor_row - PREFETCH);
+  int end = std::min(row_count_, anchor_row + PREFETCH);
+
+  cache_.clear();
+  cache_start_row_ = start;
+  for (int row = start; row < end; ++row) {
+    cache_.push_back(decode(events[eventIndexForRow(row)]));
+  }
+
+  if (isHexMode()) {
+    // byte colors are a running diff, so feed the window oldest-first
+    hex_colors = {};
+    const auto freq = can->lastMessage(msg_id).freq;
+    const std::vector<uint8_t> no_mask;
+    for (auto it = cache_.rbegin(); it != cache_.rend(); ++it) {
+      hex_colors.compute(msg_id, it->data.data(), it->data.size(), it->mono_time / (double)1e9, can->getSpeed(), no_mask, freq);
+      it->colors = hex_colors.colors;
     }
-    int pos = std::distance(messages.begin(), insert_pos);
-    beginInsertRows({}, pos , pos + msgs.size() - 1);
-    messages.insert(insert_pos, std::move_iterator(msgs.begin()), std::move_iterator(msgs.end()));
-    endInsertRows();
   }
 }
 
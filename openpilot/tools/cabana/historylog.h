@@ -18,6 +18,10 @@ public:
   void paintSection(QPainter *painter, const QRect &rect, int logicalIndex) const;
 };
 
+// Virtualized history model: rowCount covers the whole event history of the
+// selected message, but rows are decoded on demand from the stream's event
+// store into a small window around the viewport, so memory stays O(viewport)
+// no matter how long the route is.
 class HistoryLogModel : public QAbstractTableModel {
   Q_OBJECT
 
@@ -28,9 +32,7 @@ public:
   void setFilter(int sig_idx, const QString &value, std::function<bool(double, double)> cmp);
   QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
   QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
-  void fetchMore(const QModelIndex &parent) override;
-  bool canFetchMore(const QModelIndex &parent) const override;
-  int rowCount(const QModelIndex &parent = QModelIndex()) const override { return messages.size(); }
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override { return row_count_; }
   int columnCount(const QModelIndex &parent = QModelIndex()) const override { return !isHexMode() ? sigs.size() + 1 : 2; }
   inline bool isHexMode() const { return sigs.empty() || hex_mode; }
   void reset();
@@ -43,17 +45,32 @@ public:
     std::vector<QColor> colors;
   };
 
-  void fetchData(std::deque<Message>::iterator insert_pos, uint64_t from_time, uint64_t min_time);
-
   MessageId msg_id;
-  CanData hex_colors;
-  const int batch_size = 50;
+  std::vector<cabana::Signal *> sigs;
+
+private:
+  int eventIndexForRow(int row) const;
+  bool matchesFilter(const CanEvent *e) const;
+  void rebuildFilterIndex();
+  Message decode(const CanEvent *e) const;
+  const Message &messageForRow(int row) const;
+  void rebuildCache(int anchor_row) const;
+
   int filter_sig_idx = -1;
   double filter_value = 0;
   std::function<bool(double, double)> filter_cmp = nullptr;
-  std::deque<Message> messages;
-  std::vector<cabana::Signal *> sigs;
   bool hex_mode = false;
+
+  int row_count_ = 0;
+  int last_idx_ = -1;                  // newest event at or before the current time
+  std::vector<uint32_t> filtered_ids_; // ascending event indices, filter active only
+
+  // decoded window around the viewport, rebuilt with prefetch in both
+  // directions whenever a row outside of it is requested
+  static constexpr int PREFETCH = 128;
+  mutable int cache_start_row_ = 0;
+  mutable std::deque<Message> cache_;
+  mutable CanData hex_colors;
 };
 
 class LogsWidget : public QFrame {
@@ -226,28 +226,77 @@ void MessageListModel::dbcModified() {
   for (const auto &[_, m] : dbc()->getMessages(-1)) {
     dbc_messages_.insert(MessageId{.source = INVALID_SOURCE, .address = m.address});
   }
+  item_cache_.clear();
   filterAndSort();
 }
 
-void MessageListModel::sortItems(std::vector<MessageListModel::Item> &items) {
-  auto compare = [this](const auto &l, const auto &r) {
-    switch (sort_column) {
-      case Column::NAME: return std::tie(l.name, l.id) < std::tie(r.name, r.id);
-      case Column::SOURCE: return std::tie(l.id.source, l.id.address) < std::tie(r.id.source, r.id.address);
-      case Column::ADDRESS: return std::tie(l.id.address, l.id.source) < std::tie(r.id.address, r.id.source);
-      case Column::NODE: return std::tie(l.node, l.id) < std::tie(r.node, r.id);
-      case Column::FREQ: return std::tie(can->lastMessage(l.id).freq, l.id) < std::tie(can->lastMessage(r.id).freq, r.id);
-      case Column::COUNT: return std::tie(can->lastMessage(l.id).count, l.id) < std::tie(can->lastMessage(r.id).count, r.id);
-      default: return false; // Default case to suppress compiler warning
+MessageListModel::Item MessageListModel::makeItem(const MessageId &id) {
+  auto it = item_cache_.find(id);
+  if (it != item_cache_.end()) return it->second;
+
+  Item item = {.id = id};
+  if (auto msg = dbc()->msg(id)) {
+    item.name = QString::fromStdString(msg->name);
+    item.node = QString::fromStdString(msg->transmitter);
+    item.search_str = item.name;
+    for (const auto &s : msg->sigs) {
+      item.search_str += '\n' + QString::fromStdString(s->name);
     }
-  };
+  } else {
+    item.name = item.search_str = QString::fromStdString(UNTITLED);
+  }
+  return item_cache_.emplace(id, item).first->second;
+}
 
+bool MessageListModel::itemLessThan(const Item &l, const Item &r) const {
+  switch (sort_column) {
+    case Column::NAME: return std::tie(l.name, l.id) < std::tie(r.name, r.id);
+    case Column::SOURCE: return std::tie(l.id.source, l.id.address) < std::tie(r.id.source, r.id.address);
+    case Column::ADDRESS: return std::tie(l.id.address, l.id.source) < std::tie(r.id.address, r.id.source);
+    case Column::NODE: return std::tie(l.node, l.id) < std::tie(r.node, r.id);
+    case Column::FREQ: return std::tie(can->lastMessage(l.id).freq, l.id) < std::tie(can->lastMessage(r.id).freq, r.id);
+    case Column::COUNT: return std::tie(can->lastMessage(l.id).count, l.id) < std::tie(can->lastMessage(r.id).count, r.id);
+    default: return false; // Default case to suppress compiler warning
+  }
+}
+
+void MessageListModel::sortItems(std::vector<MessageListModel::Item> &items) {
+  auto compare = [this](const auto &l, const auto &r) { return itemLessThan(l, r); };
   if (sort_order == Qt::DescendingOrder)
     std::stable_sort(items.rbegin(), items.rend(), compare);
   else
     std::stable_sort(items.begin(), items.end(), compare);
 }
 
+// Place newly seen ids at their sorted position instead of refiltering and
+// resorting the whole list on every tick that carries a first-time message.
+void MessageListModel::insertNewItems(const std::set<MessageId> &msgs) {
+  auto before = [this](const Item &l, const Item &r) {
+    return sort_order == Qt::DescendingOrder ? itemLessThan(r, l) : itemLessThan(l, r);
+  };
+  for (const auto &id : msgs) {
+    if (!seen_ids_.insert(id).second) continue;
+
+    // an active message replaces its inactive DBC placeholder row
+    auto stale = std::find_if(items_.begin(), items_.end(), [&](const Item &item) {
+      return item.id.source == INVALID_SOURCE && item.id.address == id.address;
+    });
+    if (stale != items_.end()) {
+      int row = stale - items_.begin();
+      beginRemoveRows({}, row, row);
+      items_.erase(stale);
+      endRemoveRows();
+    }
+
+    const Item &item = makeItem(id);
+    if (!match(item)) continue;
+    int row = std::upper_bound(items_.begin(), items_.end(), item, before) - items_.begin();
+    beginInsertRows({}, row, row);
+    items_.insert(items_.begin() + row, item);
+    endInsertRows();
+  }
+}
+
 static bool parseRange(const QString &filter, uint32_t value, int base = 10) {
   // Parse out filter string into a range (e.g. "1" -> {1, 1}, "1-3" -> {1, 3}, "1-" -> {1, inf})
   unsigned int min = std::numeric_limits<unsigned int>::min();
@@ -272,15 +321,10 @@ bool MessageListModel::match(const MessageListModel::Item &item) {
   for (auto it = filters_.cbegin(); it != filters_.cend() && match; ++it) {
     const QString &txt = it.value();
     switch (it.key()) {
-      case Column::NAME: {
-        match = item.name.contains(txt, Qt::CaseInsensitive);
-        if (!match) {
-          const auto m = dbc()->msg(item.id);
-          match = m && std::any_of(m->sigs.cbegin(), m->sigs.cend(),
-                                   [&txt](const auto &s) { return QString::fromStdString(s->name).contains(txt, Qt::CaseInsensitive); });
-        }
+      case Column::NAME:
+        // cached blob of message and signal names; avoids per-row DBC lookups
+        match = item.search_str.contains(txt, Qt::CaseInsensitive);
         break;
-      }
       case Column::SOURCE:
         match = parseRange(txt, item.id.source);
         break;
@@ -317,14 +361,13 @@ bool MessageListModel::filterAndSort() {
   all_messages.insert(all_messages.end(), dbc_msgs.begin(), dbc_msgs.end());
 
   // filter and sort
+  seen_ids_.clear();
   std::vector<Item> items;
   items.reserve(all_messages.size());
   for (const auto &id : all_messages) {
+    if (id.source != INVALID_SOURCE) seen_ids_.insert(id);
     if (show_inactive_messages || can->isMessageActive(id)) {
-      auto msg = dbc()->msg(id);
-      Item item = {.id = id,
-                  .name = msg ? QString::fromStdString(msg->name) : QString::fromStdString(UNTITLED),
-                  .node = msg ? QString::fromStdString(msg->transmitter) : QString()};
+      const Item &item = makeItem(id);
       if (match(item))
         items.emplace_back(item);
     }
@@ -341,8 +384,13 @@ bool MessageListModel::filterAndSort() {
 }
 
 void MessageListModel::msgsReceived(const std::set<MessageId> *new_msgs, bool has_new_ids) {
-  if (has_new_ids || ((filters_.count(Column::FREQ) || filters_.count(Column::COUNT) || filters_.count(Column::DATA)) &&
-                      ++sort_threshold_ == settings.fps)) {
+  if (has_new_ids && new_msgs) {
+    insertNewItems(*new_msgs);
+  }
+  // dynamic filters still need a periodic full pass; the values they match on change every frame
+  if ((has_new_ids && !new_msgs) ||
+      ((filters_.count(Column::FREQ) || filters_.count(Column::COUNT) || filters_.count(Column::DATA)) &&
+       ++sort_threshold_ == settings.fps)) {
     sort_threshold_ = 0;
     if (filterAndSort()) return;
   }
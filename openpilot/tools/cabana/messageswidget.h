@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <optional>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include <QAbstractTableModel>
@@ -45,6 +46,7 @@ public:
     MessageId id;
     QString name;
     QString node;
+    QString search_str;  // name plus signal names, matched as one cached string
     bool operator==(const Item &other) const {
       return id == other.id && name == other.name && node == other.node;
     }
@@ -53,11 +55,18 @@ public:
   bool show_inactive_messages = true;
 
 private:
+  Item makeItem(const MessageId &id);
+  bool itemLessThan(const Item &l, const Item &r) const;
   void sortItems(std::vector<MessageListModel::Item> &items);
+  void insertNewItems(const std::set<MessageId> &msgs);
   bool match(const MessageListModel::Item &id);
 
   QMap<int, QString> filters_;
   std::set<MessageId> dbc_messages_;
+  // row strings are rebuilt only on DBC changes; new ids are placed with an
+  // insertion-point search instead of refiltering and resorting everything
+  std::unordered_map<MessageId, Item> item_cache_;
+  std::set<MessageId> seen_ids_;
   int sort_column = 0;
   Qt::SortOrder sort_order = Qt::AscendingOrder;
   int sort_threshold_ = 0;
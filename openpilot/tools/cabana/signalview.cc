@@ -596,8 +596,11 @@ void SignalView::handleSignalAdded(MessageId id, const cabana::Signal *sig) {
 }
 
 void SignalView::handleSignalUpdated(const cabana::Signal *sig) {
-  if (int row = model->signalRow(sig); row != -1)
+  if (int row = model->signalRow(sig); row != -1) {
+    // the cached samples were decoded with the old definition
+    model->getItem(model->index(row, 1))->sparkline.invalidate();
     updateState();
+  }
 }
 
 std::pair<QModelIndex, QModelIndex> SignalView::visibleSignalRange() {
@@ -641,6 +644,8 @@ void SignalView::updateState(const std::set<MessageId> *msgs) {
                delegate->button_size.height() - style()->pixelMetric(QStyle::PM_FocusFrameVMargin) * 2);
 
     auto [first, last] = can->eventsInRange(model->msg_id, std::make_pair(last_msg.ts -settings.sparkline_range, last_msg.ts));
+    // sample and lay out in parallel (cached samples make this a no-op for
+    // unchanged windows), then batch the QPixmap painting into one pass here
     std::vector<std::future<void>> futures;
     for (int i = first_visible.row(); i <= last_visible.row(); ++i) {
       auto item = model->getItem(model->index(i, 1));
@@ -648,6 +653,9 @@ void SignalView::updateState(const std::set<MessageId> *msgs) {
           &Sparkline::update, &item->sparkline, item->sig, first, last, settings.sparkline_range, size));
     }
     for (auto &f : futures) f.get();
+    for (int i = first_visible.row(); i <= last_visible.row(); ++i) {
+      model->getItem(model->index(i, 1))->sparkline.paint();
+    }
   }
 
   for (int i = 0; i < model->rowCount(); ++i) {
@@ -1,5 +1,6 @@
 #include "tools/cabana/streams/abstractstream.h"
 
+#include <cstring>
 #include <limits>
 #include <utility>
 
@@ -7,19 +8,18 @@
 #include "common/timing.h"
 #include "tools/cabana/settings.h"
 
-static const int EVENT_NEXT_BUFFER_SIZE = 6 * 1024 * 1024;  // 6MB
+static const int EVENT_ARENA_INITIAL_SIZE = 64 * 1024;  // per-message, grows geometrically
 
 AbstractStream *can = nullptr;
 
 AbstractStream::AbstractStream(QObject *parent) : QObject(parent) {
   assert(parent != nullptr);
-  event_buffer_ = std::make_unique<MonotonicBuffer>(EVENT_NEXT_BUFFER_SIZE);
 
   QObject::connect(this, &AbstractStream::privateUpdateLastMsgsSignal, this, &AbstractStream::updateLastMessages, Qt::QueuedConnection);
   QObject::connect(this, &AbstractStream::seekedTo, this, &AbstractStream::updateLastMsgsTo);
   QObject::connect(this, &AbstractStream::seeking, this, [this](double sec) { current_sec_ = sec; });
   QObject::connect(dbc(), &DBCManager::DBCFileChanged, this, &AbstractStream::updateMasks);
-  QObject::connect(dbc(), &DBCManager::maskUpdated, this, &AbstractStream::updateMasks);
+  QObject::connect(dbc(), &DBCManager::maskUpdated, this, &AbstractStream::updateMsgMask);
 }
 
 void AbstractStream::updateMasks() {
@@ -45,6 +45,37 @@ void AbstractStream::updateMasks() {
   }
 }
 
+// A signal edit only changes the mask of one message in one DBC file; update
+// the sources bound to that file instead of rebuilding every mask
+void AbstractStream::updateMsgMask(const MessageId &id) {
+  if (!settings.suppress_defined_signals) return;
+
+  auto dbc_file = dbc()->findDBCFile(id);
+  std::lock_guard lk(mutex_);
+  for (const auto s : sources) {
+    if (dbc()->findDBCFile(s) != dbc_file) continue;
+
+    const MessageId mid = {.source = (uint8_t)s, .address = id.address};
+    auto msg = dbc()->msg(mid);
+    if (msg) {
+      masks_[mid] = msg->mask;
+    } else {
+      masks_.erase(mid);
+    }
+    // clear bit change counts under the new mask
+    auto it = messages_.find(mid);
+    if (msg && it != messages_.end()) {
+      auto &m = it->second;
+      const int size = std::min(msg->mask.size(), m.last_changes.size());
+      for (int i = 0; i < size; ++i) {
+        for (int j = 0; j < 8; ++j) {
+          if (((msg->mask[i] >> (7 - j)) & 1) != 0) m.bit_flip_counts[i][j] = 0;
+        }
+      }
+    }
+  }
+}
+
 void AbstractStream::suppressDefinedSignals(bool suppress) {
   settings.suppress_defined_signals = suppress;
   updateMasks();
@@ -189,12 +220,20 @@ void AbstractStream::waitForSeekFinshed() {
 
 const CanEvent *AbstractStream::newEvent(uint64_t mono_time, const cereal::CanData::Reader &c) {
   auto dat = c.getDat();
-  CanEvent *e = (CanEvent *)event_buffer_->allocate(sizeof(CanEvent) + sizeof(uint8_t) * dat.size());
-  e->src = c.getSrc();
-  e->address = c.getAddress();
+  return newEvent(mono_time, c.getSrc(), c.getAddress(), (const uint8_t *)dat.begin(), dat.size());
+}
+
+const CanEvent *AbstractStream::newEvent(uint64_t mono_time, uint8_t src, uint32_t address, const uint8_t *dat, uint8_t size) {
+  auto &arena = event_arenas_[{.source = src, .address = address}];
+  if (!arena) arena = std::make_unique<MonotonicBuffer>(EVENT_ARENA_INITIAL_SIZE);
+  // CanEvent only needs its natural alignment; the default 16 wastes a
+  // quarter of the arena on classic 8-byte frames
+  CanEvent *e = (CanEvent *)arena->allocate(sizeof(CanEvent) + sizeof(uint8_t) * size, alignof(CanEvent));
+  e->src = src;
+  e->address = address;
   e->mono_time = mono_time;
-  e->size = dat.size();
-  memcpy(e->dat, (uint8_t *)dat.begin(), e->size);
+  e->size = size;
+  memcpy(e->dat, dat, size);
   return e;
 }
 
@@ -212,7 +251,10 @@ void AbstractStream::mergeEvents(const std::vector<const CanEvent *> &events) {
       if (!new_e.empty()) {
         auto &e = events_[id];
         auto pos = std::upper_bound(e.cbegin(), e.cend(), new_e.front()->mono_time, CompareCanEvent());
+        bool append = (pos == e.cend());
         e.insert(pos, new_e.cbegin(), new_e.cend());
+        updateEventIndex(id, append);
+        updateBitFlipCounts(id, append);
       }
     }
     auto pos = std::upper_bound(all_events_.cbegin(), all_events_.cend(), events.front()->mono_time, CompareCanEvent());
@@ -221,13 +263,90 @@ void AbstractStream::mergeEvents(const std::vector<const CanEvent *> &events) {
   }
 }
 
+// Maintained per merge: extended in place for in-order appends (live
+// streaming and forward playback), rebuilt for out-of-order merges
+void AbstractStream::updateEventIndex(const MessageId &id, bool append) {
+  static const uint64_t BUCKET_NS = 1e9;
+
+  const auto &events = events_[id];
+  auto &index = event_index_[id];
+  if (!append || index.buckets.empty() || events.front()->mono_time < index.start_ts) {
+    index.start_ts = events.front()->mono_time;
+    index.indexed = 0;
+    index.buckets.clear();
+  }
+  for (size_t i = index.indexed; i < events.size(); ++i) {
+    uint64_t b = (events[i]->mono_time - index.start_ts) / BUCKET_NS;
+    while (index.buckets.size() <= b) index.buckets.push_back(i);
+  }
+  index.indexed = events.size();
+}
+
+// Fold newly merged events into the per-bit flip counters. Appends continue
+// from the last counted event; out-of-order merges restart from the front so
+// flips are always counted between time-consecutive frames.
+void AbstractStream::updateBitFlipCounts(const MessageId &id, bool append) {
+  const auto &events = events_[id];
+  auto &agg = bit_flip_counts_[id];
+  if (!append) {
+    agg.counted = 0;
+    agg.prev.clear();
+    agg.counts.clear();
+  }
+  for (size_t n = agg.counted; n < events.size(); ++n) {
+    const CanEvent *e = events[n];
+    if (e->size > agg.prev.size()) {
+      // bytes seen for the first time are the baseline, not a flip
+      const size_t old_size = agg.prev.size();
+      agg.prev.resize(e->size);
+      agg.counts.resize(e->size, {});
+      memcpy(agg.prev.data() + old_size, e->dat + old_size, e->size - old_size);
+    }
+    for (int i = 0; i < e->size; ++i) {
+      const uint8_t diff = e->dat[i] ^ agg.prev[i];
+      if (!diff) continue;
+      for (int bit = 0; bit < 8; ++bit) {
+        if (diff & (1u << bit)) ++agg.counts[i][7 - bit];
+      }
+      agg.prev[i] = e->dat[i];
+    }
+  }
+  agg.counted = events.size();
+}
+
+const std::vector<std::array<uint32_t, 8>> &AbstractStream::bitFlipCounts(const MessageId &id) const {
+  static std::vector<std::array<uint32_t, 8>> empty_counts;
+  auto it = bit_flip_counts_.find(id);
+  return it != bit_flip_counts_.end() ? it->second.counts : empty_counts;
+}
+
+// Narrow a timestamp to its bucket's index span; bisection then runs over at
+// most one second of events
+std::pair<size_t, size_t> AbstractStream::indexNarrow(const MessageId &id, uint64_t ts) const {
+  static const uint64_t BUCKET_NS = 1e9;
+
+  auto it = event_index_.find(id);
+  auto e_it = events_.find(id);
+  size_t n = e_it != events_.end() ? e_it->second.size() : 0;
+  if (it == event_index_.end() || it->second.buckets.empty()) return {0, n};
+
+  const auto &index = it->second;
+  if (ts < index.start_ts) return {0, 0};
+  uint64_t b = (ts - index.start_ts) / BUCKET_NS;
+  size_t lo = b < index.buckets.size() ? index.buckets[b] : n;
+  size_t hi = (b + 1) < index.buckets.size() ? index.buckets[b + 1] : n;
+  return {lo, hi};
+}
+
 std::pair<CanEventIter, CanEventIter> AbstractStream::eventsInRange(const MessageId &id, std::optional<std::pair<double, double>> time_range) const {
   const auto &events = can->events(id);
   if (!time_range) return {events.begin(), events.end()};
 
-  auto first = std::lower_bound(events.begin(), events.end(), can->toMonoTime(time_range->first), CompareCanEvent());
-  auto last = std::upper_bound(first, events.end(), can->toMonoTime(time_range->second), CompareCanEvent());
-  return {first, last};
+  auto [lo0, hi0] = indexNarrow(id, can->toMonoTime(time_range->first));
+  auto first = std::lower_bound(events.begin() + lo0, events.begin() + hi0, can->toMonoTime(time_range->first), CompareCanEvent());
+  auto [lo1, hi1] = indexNarrow(id, can->toMonoTime(time_range->second));
+  auto last = std::upper_bound(std::max(first, events.begin() + lo1), events.begin() + hi1, can->toMonoTime(time_range->second), CompareCanEvent());
+  return {first, std::max(first, last)};
 }
 
 namespace {
@@ -280,7 +399,7 @@ void CanData::compute(const MessageId &msg_id, const uint8_t *can_data, const in
     constexpr float fade_time = 2.0;
     const float alpha_delta = 1.0 / (freq + 1) / (fade_time * playback_speed);
 
-    for (int i = 0; i < size; ++i) {
+    auto update_byte = [&](int i) {
       auto &last_change = last_changes[i];
 
       uint8_t mask_byte = last_change.suppressed ? 0x00 : 0xFF;
@@ -319,7 +438,25 @@ void CanData::compute(const MessageId &msg_id, const uint8_t *can_data, const in
         // Fade out
         colors[i].setAlphaF(std::max(0.0, colors[i].alphaF() - alpha_delta));
       }
+    };
+
+    // Most bytes of a busy frame are static, so compare a word at a time first.
+    // The mask only clears bits, so identical raw bytes are identical after
+    // masking too; only words the XOR flags need the per-byte bookkeeping.
+    int i = 0;
+    for (; i + (int)sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+      uint64_t prev_word, cur_word;
+      memcpy(&prev_word, &dat[i], sizeof(prev_word));
+      memcpy(&cur_word, &can_data[i], sizeof(cur_word));
+      if ((prev_word ^ cur_word) == 0) {
+        for (int j = i; j < i + (int)sizeof(uint64_t); ++j) {
+          colors[j].setAlphaF(std::max(0.0, colors[j].alphaF() - alpha_delta));
+        }
+      } else {
+        for (int j = i; j < i + (int)sizeof(uint64_t); ++j) update_byte(j);
+      }
     }
+    for (; i < size; ++i) update_byte(i);
   }
   memcpy(dat.data(), can_data, size);
 }
@@ -40,10 +40,11 @@ struct CanData {
   double last_freq_update_ts = 0;
 };
 
+// field order packs the header into 14 bytes (was 17 plus padding)
 struct CanEvent {
-  uint8_t src;
-  uint32_t address;
   uint64_t mono_time;
+  uint32_t address;
+  uint8_t src;
   uint8_t size;
   uint8_t dat[];
 };
@@ -87,6 +88,7 @@ public:
   inline const MessageEventsMap &eventsMap() const { return events_; }
   inline const std::vector<const CanEvent *> &allEvents() const { return all_events_; }
   const CanData &lastMessage(const MessageId &id) const;
+  const std::vector<std::array<uint32_t, 8>> &bitFlipCounts(const MessageId &id) const;
   const std::vector<const CanEvent *> &events(const MessageId &id) const;
   std::pair<CanEventIter, CanEventIter> eventsInRange(const MessageId &id, std::optional<std::pair<double, double>> time_range) const;
 
@@ -111,6 +113,7 @@ public:
 protected:
   void mergeEvents(const std::vector<const CanEvent *> &events);
   const CanEvent *newEvent(uint64_t mono_time, const cereal::CanData::Reader &c);
+  const CanEvent *newEvent(uint64_t mono_time, uint8_t src, uint32_t address, const uint8_t *dat, uint8_t size);
   void updateEvent(const MessageId &id, double sec, const uint8_t *data, uint8_t size);
   void waitForSeekFinshed();
   std::vector<const CanEvent *> all_events_;
@@ -121,10 +124,37 @@ private:
   void updateLastMessages();
   void updateLastMsgsTo(double sec);
   void updateMasks();
+  void updateMsgMask(const MessageId &id);
+  void updateEventIndex(const MessageId &id, bool append);
+  void updateBitFlipCounts(const MessageId &id, bool append);
+  std::pair<size_t, size_t> indexNarrow(const MessageId &id, uint64_t ts) const;
+
+  // two-level time index: fixed one-second buckets record the first event
+  // index at or after each bucket boundary, so range queries bisect a single
+  // bucket instead of the whole multi-hour vector on every repaint
+  struct CanEventIndex {
+    uint64_t start_ts = 0;
+    size_t indexed = 0;  // events covered so far; appends extend from here
+    std::vector<uint32_t> buckets;
+  };
+  std::unordered_map<MessageId, CanEventIndex> event_index_;
+
+  // full-history per-bit flip counters, maintained on the merge thread as
+  // events arrive so the binary view heatmap is ready when a message opens
+  struct BitFlipAggregate {
+    size_t counted = 0;  // events folded in so far; appends continue from here
+    std::vector<uint8_t> prev;
+    std::vector<std::array<uint32_t, 8>> counts;
+  };
+  std::unordered_map<MessageId, BitFlipAggregate> bit_flip_counts_;
 
   MessageEventsMap events_;
   std::unordered_map<MessageId, CanData> last_msgs;
-  std::unique_ptr<MonotonicBuffer> event_buffer_;
+  // per-message arenas: each id's events are laid out back to back in their
+  // own chunks (timestamp, size and payload adjacent per record, records
+  // adjacent per id), so time-range scans of one message walk consecutive
+  // memory instead of hopping through a globally interleaved buffer
+  std::unordered_map<MessageId, std::unique_ptr<MonotonicBuffer>> event_arenas_;
 
   // Members accessed in multiple threads. (mutex protected)
   std::mutex mutex_;
@@ -2,11 +2,13 @@
 
 #include <QThread>
 #include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <memory>
 
 #include "common/timing.h"
 #include "common/util.h"
+#include "tools/cabana/panda.h"
 
 struct LiveStream::Logger {
   Logger() : start_ts(seconds_since_epoch()), segment_num(-1) {}
@@ -48,7 +50,8 @@ LiveStream::~LiveStream() {
 
 void LiveStream::startUpdateTimer() {
   update_timer.stop();
-  update_timer.start(1000.0 / settings.fps, this);
+  update_interval_ms_ = 1000.0 / settings.fps;
+  update_timer.start(update_interval_ms_, this);
   timer_id = update_timer.timerId();
 }
 
@@ -68,6 +71,29 @@ void LiveStream::stop() {
   stream_thread = nullptr;
 }
 
+// called in streamThread. Ingests a whole receive batch under one lock
+// acquisition, and only pays for the capnp round trip when logging to disk.
+void LiveStream::handleCanFrames(const std::vector<can_frame> &frames) {
+  if (frames.empty()) return;
+
+  const uint64_t mono_time = nanos_since_boot();
+  if (logger) {
+    MessageBuilder msg;
+    auto canData = msg.initEvent().initCan(frames.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+      canData[i].setAddress(frames[i].address);
+      canData[i].setDat(kj::arrayPtr((uint8_t *)frames[i].dat.data(), frames[i].dat.size()));
+      canData[i].setSrc(frames[i].src);
+    }
+    logger->write(capnp::messageToFlatArray(msg));
+  }
+
+  std::lock_guard lk(lock);
+  for (const auto &f : frames) {
+    received_events_.push_back(newEvent(mono_time, f.src, f.address, (const uint8_t *)f.dat.data(), f.dat.size()));
+  }
+}
+
 // called in streamThread
 void LiveStream::handleEvent(kj::ArrayPtr<capnp::word> data) {
   if (logger) {
@@ -87,6 +113,7 @@ void LiveStream::handleEvent(kj::ArrayPtr<capnp::word> data) {
 
 void LiveStream::timerEvent(QTimerEvent *event) {
   if (event->timerId() == timer_id) {
+    const double start_ms = millis_since_boot();
     {
       // merge events received from live stream thread.
       std::lock_guard lk(lock);
@@ -98,12 +125,32 @@ void LiveStream::timerEvent(QTimerEvent *event) {
     if (!all_events_.empty()) {
       begin_event_ts = all_events_.front()->mono_time;
       updateEvents();
-      return;
     }
+    adjustUpdateInterval(millis_since_boot() - start_ms);
+    return;
   }
   QObject::timerEvent(event);
 }
 
+// Adaptive coalescing: when a tick costs more than its share of the frame
+// budget, stretch the update interval so incoming events batch into fewer,
+// larger UI updates and the event loop keeps breathing room. Capture is
+// unaffected; the stream thread buffers everything regardless of cadence.
+void LiveStream::adjustUpdateInterval(double tick_ms) {
+  avg_tick_ms_ = avg_tick_ms_ * 0.9 + tick_ms * 0.1;
+
+  const int base_interval = std::max(1, (int)(1000.0 / settings.fps));
+  // target tick cost at half the interval; quantize to multiples of the base
+  // interval so the timer isn't restarted on every small fluctuation
+  int multiple = std::clamp((int)std::ceil(avg_tick_ms_ * 2 / base_interval), 1, 10);
+  int interval = base_interval * multiple;
+  if (interval != update_interval_ms_) {
+    update_interval_ms_ = interval;
+    update_timer.start(interval, this);
+    timer_id = update_timer.timerId();
+  }
+}
+
 void LiveStream::updateEvents() {
   static double prev_speed = 1.0;
 
@@ -8,6 +8,8 @@
 
 #include "tools/cabana/streams/abstractstream.h"
 
+struct can_frame;
+
 class LiveStream : public AbstractStream {
   Q_OBJECT
 
@@ -28,11 +30,13 @@ public:
 protected:
   virtual void streamThread() = 0;
   void handleEvent(kj::ArrayPtr<capnp::word> event);
+  void handleCanFrames(const std::vector<can_frame> &frames);
 
 private:
   void startUpdateTimer();
   void timerEvent(QTimerEvent *event) override;
   void updateEvents();
+  void adjustUpdateInterval(double tick_ms);
 
   std::mutex lock;
   QThread *stream_thread;
@@ -40,6 +44,9 @@ private:
 
   int timer_id;
   QBasicTimer update_timer;
+  // adaptive coalescing state: smoothed tick cost and the interval in use
+  double avg_tick_ms_ = 0;
+  int update_interval_ms_ = 0;
 
   QDateTime begin_date_time;
   uint64_t begin_event_ts = 0;
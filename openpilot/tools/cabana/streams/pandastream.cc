@@ -61,16 +61,8 @@ void PandaStream::streamThread() {
       continue;
     }
 
-    MessageBuilder msg;
-    auto evt = msg.initEvent();
-    auto canData = evt.initCan(raw_can_data.size());
-    for (uint i = 0; i<raw_can_data.size(); i++) {
-      canData[i].setAddress(raw_can_data[i].address);
-      canData[i].setDat(kj::arrayPtr((uint8_t*)raw_can_data[i].dat.data(), raw_can_data[i].dat.size()));
-      canData[i].setSrc(raw_can_data[i].src);
-    }
-
-    handleEvent(capnp::messageToFlatArray(msg));
+    // hand the whole receive batch over in one go
+    handleCanFrames(raw_can_data);
 
     panda->send_heartbeat(false);
   }
@@ -1,5 +1,9 @@
 #include "tools/cabana/streams/replaystream.h"
 
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
 #include <QLabel>
 #include <QFileDialog>
 #include <QGridLayout>
@@ -24,6 +28,12 @@ ReplayStream::ReplayStream(QObject *parent) : AbstractStream(parent) {
   });
 }
 
+ReplayStream::~ReplayStream() {
+  if (replay) {
+    saveSnapshot();
+  }
+}
+
 void ReplayStream::mergeSegments() {
   auto event_data = replay->getEventData();
   for (const auto &[n, seg] : event_data->segments) {
@@ -62,6 +72,10 @@ bool ReplayStream::loadRoute(const std::string &route, const std::string &data_d
   replay->onSegmentsMerged = [this]() { QMetaObject::invokeMethod(this, &ReplayStream::mergeSegments, Qt::BlockingQueuedConnection); };
 
   bool success = replay->load();
+  if (success) {
+    // a previous session against this route skips the log parse entirely
+    loadSnapshot();
+  }
   if (!success) {
     if (replay->lastRouteError() == RouteLoadError::Unauthorized) {
       auto auth_content = util::read_file(util::getenv("HOME") + "/.comma/auth.json");
@@ -88,6 +102,100 @@ bool ReplayStream::loadRoute(const std::string &route, const std::string &data_d
   return success;
 }
 
+// Session snapshots: the decoded CanEvent store and processed-segment set are
+// written out on close and streamed straight back into the event arenas on
+// reopen, so iterating on a DBC against the same capture costs no download,
+// decompress or capnp parse. Time indexes and heatmap counters rebuild as a
+// side effect of the merge. Segments in the snapshot are marked processed, so
+// replay playback doesn't decode their CAN data a second time.
+static constexpr uint32_t SNAPSHOT_MAGIC = 0x4e534243;  // "CBSN"
+static constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+std::string ReplayStream::snapshotPath() const {
+  std::string name = replay->route().name();
+  std::replace_if(name.begin(), name.end(), [](char c) { return c == '|' || c == '/'; }, '_');
+  return util::getenv("COMMA_CACHE") + "/" + name + ".cabana_snapshot";
+}
+
+void ReplayStream::saveSnapshot() const {
+  if (all_events_.empty()) return;
+
+  const std::string path = snapshotPath();
+  std::ofstream fs(path + ".tmp", std::ios::binary | std::ios::trunc);
+  if (!fs) return;
+
+  const uint32_t magic = SNAPSHOT_MAGIC, version = SNAPSHOT_VERSION;
+  fs.write((const char *)&magic, sizeof(magic));
+  fs.write((const char *)&version, sizeof(version));
+
+  const uint32_t seg_count = processed_segments.size();
+  fs.write((const char *)&seg_count, sizeof(seg_count));
+  for (const int32_t n : processed_segments) {
+    fs.write((const char *)&n, sizeof(n));
+  }
+
+  const uint64_t event_count = all_events_.size();
+  fs.write((const char *)&event_count, sizeof(event_count));
+  for (const CanEvent *e : all_events_) {
+    fs.write((const char *)&e->mono_time, sizeof(e->mono_time));
+    fs.write((const char *)&e->address, sizeof(e->address));
+    fs.write((const char *)&e->src, sizeof(e->src));
+    fs.write((const char *)&e->size, sizeof(e->size));
+    fs.write((const char *)e->dat, e->size);
+  }
+
+  fs.close();
+  if (fs.good()) {
+    std::rename((path + ".tmp").c_str(), path.c_str());
+  } else {
+    std::remove((path + ".tmp").c_str());
+  }
+}
+
+bool ReplayStream::loadSnapshot() {
+  const std::string data = util::read_file(snapshotPath());
+  const char *p = data.data(), *end = p + data.size();
+  auto read = [&](void *dst, size_t n) {
+    if ((size_t)(end - p) < n) return false;
+    memcpy(dst, p, n);
+    p += n;
+    return true;
+  };
+
+  uint32_t magic = 0, version = 0, seg_count = 0;
+  if (!read(&magic, sizeof(magic)) || magic != SNAPSHOT_MAGIC ||
+      !read(&version, sizeof(version)) || version != SNAPSHOT_VERSION ||
+      !read(&seg_count, sizeof(seg_count))) {
+    return false;
+  }
+  std::set<int> segments;
+  for (uint32_t i = 0; i < seg_count; ++i) {
+    int32_t n = 0;
+    if (!read(&n, sizeof(n))) return false;
+    segments.insert(n);
+  }
+
+  uint64_t event_count = 0;
+  if (!read(&event_count, sizeof(event_count))) return false;
+  std::vector<const CanEvent *> events;
+  events.reserve(event_count);
+  for (uint64_t i = 0; i < event_count; ++i) {
+    uint64_t mono_time = 0;
+    uint32_t address = 0;
+    uint8_t src = 0, size = 0;
+    if (!read(&mono_time, sizeof(mono_time)) || !read(&address, sizeof(address)) ||
+        !read(&src, sizeof(src)) || !read(&size, sizeof(size)) || (size_t)(end - p) < size) {
+      return false;
+    }
+    events.push_back(newEvent(mono_time, src, address, (const uint8_t *)p, size));
+    p += size;
+  }
+
+  mergeEvents(events);
+  processed_segments = std::move(segments);
+  return true;
+}
+
 bool ReplayStream::eventFilter(const Event *event) {
   static double prev_update_ts = 0;
   if (event->which == cereal::Event::Which::CAN) {
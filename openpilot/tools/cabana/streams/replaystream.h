@@ -17,6 +17,7 @@ class ReplayStream : public AbstractStream {
 
 public:
   ReplayStream(QObject *parent);
+  ~ReplayStream();
   void start() override { replay->start(); }
   bool loadRoute(const std::string &route, const std::string &data_dir, uint32_t replay_flags = REPLAY_FLAG_NONE, bool auto_source = false);
   bool eventFilter(const Event *event);
@@ -39,6 +40,9 @@ signals:
 
 private:
   void mergeSegments();
+  std::string snapshotPath() const;
+  void saveSnapshot() const;
+  bool loadSnapshot();
   std::unique_ptr<Replay> replay = nullptr;
   std::set<int> processed_segments;
   std::unique_ptr<OpenpilotPrefix> op_prefix;
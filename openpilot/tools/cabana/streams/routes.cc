@@ -3,6 +3,8 @@
 #include <QApplication>
 #include <QDateTime>
 #include <QDialogButtonBox>
+#include <QDir>
+#include <QFile>
 #include <QFormLayout>
 #include <QJsonArray>
 #include <QJsonDocument>
@@ -11,6 +13,8 @@
 #include <QMessageBox>
 #include <QPainter>
 #include <QPointer>
+#include <QStandardPaths>
+#include <algorithm>
 #include <thread>
 
 #include "tools/replay/py_downloader.h"
@@ -27,6 +31,52 @@ std::pair<bool, int> checkApiResponse(const std::string &result) {
   return {true, 0};
 }
 
+// Per-device route metadata cache: {"last_sync_ms": N, "routes": [...]}.
+// Serving the picker from disk and only fetching routes newer than the
+// last sync keeps it instant for devices with thousands of drives.
+QString routeCachePath(const QString &dongle_id) {
+  QDir dir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/routes");
+  if (!dir.exists()) dir.mkpath(".");
+  return dir.filePath(dongle_id + ".json");
+}
+
+QJsonObject loadRouteCache(const QString &dongle_id) {
+  QFile file(routeCachePath(dongle_id));
+  if (!file.open(QIODevice::ReadOnly)) return {};
+  return QJsonDocument::fromJson(file.readAll()).object();
+}
+
+void saveRouteCache(const QString &dongle_id, const QJsonObject &cache) {
+  QFile file(routeCachePath(dongle_id));
+  if (file.open(QIODevice::WriteOnly)) {
+    file.write(QJsonDocument(cache).toJson(QJsonDocument::Compact));
+  }
+}
+
+QJsonArray mergeRoutes(const QJsonArray &cached, const QJsonArray &fetched) {
+  QMap<QString, QJsonObject> by_name;
+  for (const QJsonValue &r : cached) by_name[r["fullname"].toString()] = r.toObject();
+  for (const QJsonValue &r : fetched) by_name[r["fullname"].toString()] = r.toObject();
+
+  QList<QJsonObject> routes = by_name.values();
+  // newest first, same order the API returns
+  std::sort(routes.begin(), routes.end(), [](const QJsonObject &a, const QJsonObject &b) {
+    return a["start_time_utc_millis"].toDouble() > b["start_time_utc_millis"].toDouble();
+  });
+  QJsonArray out;
+  for (const QJsonObject &r : routes) out.append(r);
+  return out;
+}
+
+QJsonArray filterRoutes(const QJsonArray &routes, int64_t start_ms, int64_t end_ms) {
+  QJsonArray out;
+  for (const QJsonValue &r : routes) {
+    double t = r["start_time_utc_millis"].toDouble();
+    if (t >= start_ms && t <= end_ms) out.append(r);
+  }
+  return out;
+}
+
 }  // namespace
 
 // The RouteListWidget class extends QListWidget to display a custom message when empty
@@ -100,21 +150,32 @@ void RoutesDialog::fetchRoutes() {
   route_list_->clear();
   route_list_->setEmptyText(tr("Loading..."));
 
-  std::string did = device_list_->currentText().toStdString();
+  QString dongle_id = device_list_->currentText();
   int period = period_selector_->currentData().toInt();
 
   bool preserved = (period == -1);
-  int64_t start_ms = 0, end_ms = 0;
+  int64_t start_ms = 0, end_ms = 0, fetch_start_ms = 0;
   if (!preserved) {
     QDateTime now = QDateTime::currentDateTime();
     start_ms = now.addDays(-period).toMSecsSinceEpoch();
     end_ms = now.toMSecsSinceEpoch();
+    fetch_start_ms = start_ms;
+
+    // show the cached list right away, then only ask the API for routes
+    // newer than the last sync. preserved routes can't be cached this way
+    // since preservation is a server-side flag that can change any time.
+    QJsonObject cache = loadRouteCache(dongle_id);
+    int64_t last_sync_ms = (int64_t)cache["last_sync_ms"].toDouble();
+    if (last_sync_ms > 0) {
+      displayRoutes(filterRoutes(cache["routes"].toArray(), start_ms, end_ms));
+      fetch_start_ms = std::max(start_ms, last_sync_ms);
+    }
   }
 
   int request_id = ++fetch_id_;
   QPointer<RoutesDialog> self = this;
-  std::thread([self, did, start_ms, end_ms, preserved, request_id]() {
-    std::string result = PyDownloader::getDeviceRoutes(did, start_ms, end_ms, preserved);
+  std::thread([self, did = dongle_id.toStdString(), fetch_start_ms, end_ms, preserved, request_id]() {
+    std::string result = PyDownloader::getDeviceRoutes(did, fetch_start_ms, end_ms, preserved);
     if (!self || self->fetch_id_ != request_id) return;
     QMetaObject::invokeMethod(qApp, [self, r = QString::fromStdString(result), response = checkApiResponse(result), request_id]() {
       if (self && self->fetch_id_ == request_id) self->parseRouteList(r, response.first, response.second);
@@ -123,28 +184,53 @@ void RoutesDialog::fetchRoutes() {
 }
 
 void RoutesDialog::parseRouteList(const QString &json, bool success, int error_code) {
-  if (success) {
-    for (const QJsonValue &route : QJsonDocument::fromJson(json.toUtf8()).array()) {
-      QDateTime from, to;
-      if (period_selector_->currentData().toInt() == -1) {
-        from = QDateTime::fromString(route["start_time"].toString(), Qt::ISODateWithMs);
-        to = QDateTime::fromString(route["end_time"].toString(), Qt::ISODateWithMs);
-      } else {
-        from = QDateTime::fromMSecsSinceEpoch(route["start_time_utc_millis"].toDouble());
-        to = QDateTime::fromMSecsSinceEpoch(route["end_time_utc_millis"].toDouble());
-      }
-      auto item = new QListWidgetItem(QString("%1    %2min").arg(from.toString()).arg(from.secsTo(to) / 60));
-      item->setData(Qt::UserRole, route["fullname"].toString());
-      route_list_->addItem(item);
+  if (!success) {
+    // a stale cached list beats an error dialog; only give up when there
+    // is nothing to show at all
+    if (route_list_->count() == 0) {
+      QMessageBox::warning(this, tr("Error"), tr("Failed to fetch routes. Check your network connection."));
+      reject();
     }
-    if (route_list_->count() > 0) route_list_->setCurrentRow(0);
+    route_list_->setEmptyText(tr("No items"));
+    return;
+  }
+
+  QJsonArray fetched = QJsonDocument::fromJson(json.toUtf8()).array();
+  int period = period_selector_->currentData().toInt();
+  if (period == -1) {
+    displayRoutes(fetched);
   } else {
-    QMessageBox::warning(this, tr("Error"), tr("Failed to fetch routes. Check your network connection."));
-    reject();
+    QDateTime now = QDateTime::currentDateTime();
+    QString dongle_id = device_list_->currentText();
+    QJsonObject cache = loadRouteCache(dongle_id);
+    QJsonArray merged = mergeRoutes(cache["routes"].toArray(), fetched);
+    cache["last_sync_ms"] = (double)now.toMSecsSinceEpoch();
+    cache["routes"] = merged;
+    saveRouteCache(dongle_id, cache);
+    displayRoutes(filterRoutes(merged, now.addDays(-period).toMSecsSinceEpoch(), now.toMSecsSinceEpoch()));
   }
   route_list_->setEmptyText(tr("No items"));
 }
 
+void RoutesDialog::displayRoutes(const QJsonArray &routes) {
+  route_list_->clear();
+  for (const QJsonValue &route : routes) {
+    QDateTime from, to;
+    if (route["start_time_utc_millis"].isDouble()) {
+      from = QDateTime::fromMSecsSinceEpoch(route["start_time_utc_millis"].toDouble());
+      to = QDateTime::fromMSecsSinceEpoch(route["end_time_utc_millis"].toDouble());
+    } else {
+      // the preserved-routes API reports ISO timestamps instead of millis
+      from = QDateTime::fromString(route["start_time"].toString(), Qt::ISODateWithMs);
+      to = QDateTime::fromString(route["end_time"].toString(), Qt::ISODateWithMs);
+    }
+    auto item = new QListWidgetItem(QString("%1    %2min").arg(from.toString()).arg(from.secsTo(to) / 60));
+    item->setData(Qt::UserRole, route["fullname"].toString());
+    route_list_->addItem(item);
+  }
+  if (route_list_->count() > 0) route_list_->setCurrentRow(0);
+}
+
 QString RoutesDialog::route() {
   auto current_item = route_list_->currentItem();
   return current_item ? current_item->data(Qt::UserRole).toString() : "";
@@ -4,6 +4,7 @@
 #include <QComboBox>
 #include <QDialog>
 
+class QJsonArray;
 class RouteListWidget;
 
 class RoutesDialog : public QDialog {
@@ -16,6 +17,7 @@ protected:
   void parseDeviceList(const QString &json, bool success, int error_code);
   void parseRouteList(const QString &json, bool success, int error_code);
   void fetchRoutes();
+  void displayRoutes(const QJsonArray &routes);
 
   QComboBox *device_list_;
   QComboBox *period_selector_;
@@ -7,6 +7,8 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <vector>
+
 #include <QDebug>
 #include <QDir>
 #include <QFormLayout>
@@ -80,19 +82,27 @@ bool SocketCanStream::connect() {
 
 void SocketCanStream::streamThread() {
   struct canfd_frame frame;
+  std::vector<canfd_frame> frames;
 
   while (!QThread::currentThread()->isInterruptionRequested()) {
-    ssize_t nbytes = read(sock_fd, &frame, sizeof(frame));
+    frames.clear();
+    ssize_t nbytes = read(sock_fd, &frame, sizeof(frame));  // blocks up to the 100ms timeout
     if (nbytes <= 0) continue;
+    frames.push_back(frame);
 
-    uint8_t len = (nbytes == CAN_MTU) ? frame.len : frame.len;  // works for both CAN and CAN-FD
+    // drain whatever else is queued so a busy CAN-FD bus is handed over as
+    // one batch per event instead of one event (and lock round trip) per frame
+    while (frames.size() < 256 && recv(sock_fd, &frame, sizeof(frame), MSG_DONTWAIT) > 0) {
+      frames.push_back(frame);
+    }
 
     MessageBuilder msg;
-    auto evt = msg.initEvent();
-    auto canData = evt.initCan(1);
-    canData[0].setAddress(frame.can_id & CAN_EFF_MASK);
-    canData[0].setSrc(0);
-    canData[0].setDat(kj::arrayPtr(frame.data, len));
+    auto canData = msg.initEvent().initCan(frames.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+      canData[i].setAddress(frames[i].can_id & CAN_EFF_MASK);
+      canData[i].setSrc(0);
+      canData[i].setDat(kj::arrayPtr(frames[i].data, frames[i].len));  // len works for both CAN and CAN-FD
+    }
 
     handleEvent(capnp::messageToFlatArray(msg));
   }
@@ -1,5 +1,7 @@
 #include "tools/cabana/tools/findsignal.h"
 
+#include <atomic>
+#include <map>
 #include <thread>
 
 #include <QFormLayout>
@@ -37,29 +39,79 @@ void FindSignalModel::search(std::function<bool(double)> cmp) {
   filtered_signals.clear();
   filtered_signals.reserve(prev_sigs.size());
 
+  // group candidates by message so per-message work (event range lookup,
+  // changed-bit mask) is done once; threads claim whole messages
+  std::map<MessageId, std::vector<size_t>> msg_candidates;
+  for (size_t i = 0; i < prev_sigs.size(); ++i) {
+    msg_candidates[prev_sigs[i].id].push_back(i);
+  }
+  std::vector<const std::pair<const MessageId, std::vector<size_t>> *> groups;
+  groups.reserve(msg_candidates.size());
+  for (const auto &g : msg_candidates) groups.push_back(&g);
+
+  std::atomic<size_t> next_group = 0;
   unsigned int num_threads = std::max(1u, std::thread::hardware_concurrency());
-  size_t chunk = (prev_sigs.size() + num_threads - 1) / num_threads;
   std::vector<std::thread> threads;
-  for (unsigned int t = 0; t < num_threads && t * chunk < (size_t)prev_sigs.size(); ++t) {
-    size_t start = t * chunk;
-    size_t end = std::min(start + chunk, (size_t)prev_sigs.size());
-    threads.emplace_back([&, start, end]() {
-      for (size_t i = start; i < end; ++i) {
-        const auto &s = prev_sigs[i];
-        const auto &events = can->events(s.id);
-        auto first = std::upper_bound(events.cbegin(), events.cend(), s.mono_time, CompareCanEvent());
+  for (unsigned int t = 0; t < std::min<size_t>(num_threads, groups.size()); ++t) {
+    threads.emplace_back([&]() {
+      std::vector<SearchSignal> local;
+      for (size_t g = 0; (g = next_group.fetch_add(1)) < groups.size();) {
+        const auto &[id, candidates] = *groups[g];
+        const auto &events = can->events(id);
+
+        uint64_t min_time = std::numeric_limits<uint64_t>::max();
+        for (size_t i : candidates) min_time = std::min(min_time, prev_sigs[i].mono_time);
+        auto window_first = std::upper_bound(events.cbegin(), events.cend(), min_time, CompareCanEvent());
         auto last = events.cend();
         if (last_time < std::numeric_limits<uint64_t>::max()) {
           last = std::upper_bound(events.cbegin(), events.cend(), last_time, CompareCanEvent());
         }
+        if (window_first == last) continue;
 
-        auto it = std::find_if(first, last, [&](const CanEvent *e) { return cmp(get_raw_value(e->dat, e->size, s.sig)); });
-        if (it != last) {
-          auto values = s.values;
-          values += QString("(%1, %2)").arg(can->toSeconds((*it)->mono_time), 0, 'f', 3).arg(get_raw_value((*it)->dat, (*it)->size, s.sig));
-          std::lock_guard lk(lock);
-          filtered_signals.push_back({.id = s.id, .mono_time = (*it)->mono_time, .sig = s.sig, .values = values});
+        // bits that ever changed in the window: a candidate over static bits
+        // holds one value, so it is tested once instead of scanned in full
+        std::vector<uint8_t> changed((*window_first)->size, 0);
+        const CanEvent *prev = *window_first;
+        for (auto it = window_first + 1; it != last; ++it) {
+          const CanEvent *e = *it;
+          if (e->size != prev->size) {  // varying frame size; treat everything as changing
+            std::fill(changed.begin(), changed.end(), 0xff);
+            break;
+          }
+          const size_t n = std::min(changed.size(), (size_t)e->size);
+          for (size_t b = 0; b < n; ++b) changed[b] |= e->dat[b] ^ prev->dat[b];
+          prev = e;
         }
+
+        for (size_t i : candidates) {
+          const auto &s = prev_sigs[i];
+          auto first = std::upper_bound(events.cbegin(), events.cend(), s.mono_time, CompareCanEvent());
+
+          cabana::Signal raw_bits = s.sig;
+          raw_bits.factor = 1;
+          raw_bits.offset = 0;
+          raw_bits.is_signed = false;
+          const bool is_static = get_raw_value(changed.data(), changed.size(), raw_bits) == 0;
+
+          const cabana::SignalDecoder decoder(s.sig);
+          double v = 0;
+          auto it = last;
+          if (is_static) {
+            if (first != last && decoder.getValue((*first)->dat, (*first)->size, &v) && cmp(v)) it = first;
+          } else {
+            it = std::find_if(first, last, [&](const CanEvent *e) { return decoder.getValue(e->dat, e->size, &v) && cmp(v); });
+          }
+          if (it != last) {
+            auto values = s.values;
+            values += QString("(%1, %2)").arg(can->toSeconds((*it)->mono_time), 0, 'f', 3).arg(v);
+            local.push_back({.id = s.id, .mono_time = (*it)->mono_time, .sig = s.sig, .values = values});
+          }
+        }
+      }
+      if (!local.empty()) {
+        std::lock_guard lk(lock);
+        filtered_signals.insert(filtered_signals.end(), std::make_move_iterator(local.begin()),
+                                std::make_move_iterator(local.end()));
       }
     });
   }
@@ -1,7 +1,10 @@
 #include "tools/cabana/tools/findsimilarbits.h"
 
 #include <algorithm>
-#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <utility>
 
 #include <QGridLayout>
 #include <QHeaderView>
@@ -117,45 +120,86 @@ void FindSimilarBitsDlg::find() {
 
 std::vector<FindSimilarBitsDlg::mismatched_struct> FindSimilarBitsDlg::calcBits(uint8_t bus, uint32_t selected_address, int byte_idx,
                                                                                int bit_idx, uint8_t find_bus, bool equal, int min_msgs_cnt) {
-  std::unordered_map<uint32_t, std::vector<uint32_t>> mismatches;
-  std::unordered_map<uint32_t, uint32_t> msg_count;
-  const auto &events = can->allEvents();
-  int bit_to_find = -1;
-  for (const CanEvent *e : events) {
-    if (e->src == bus) {
-      if (e->address == selected_address && e->size > byte_idx) {
-        bit_to_find = ((e->dat[byte_idx] >> (7 - bit_idx)) & 1) != 0;
-      }
+  // timeline of the tracked source bit: its value after each source frame
+  std::vector<std::pair<uint64_t, uint64_t>> src_timeline;
+  for (const CanEvent *e : can->events({.source = bus, .address = selected_address})) {
+    if (e->size > byte_idx) {
+      src_timeline.emplace_back(e->mono_time, (e->dat[byte_idx] >> (7 - bit_idx)) & 1);
     }
-    if (e->src == find_bus) {
-      ++msg_count[e->address];
-      if (bit_to_find == -1) continue;
+  }
 
-      auto &mismatched = mismatches[e->address];
-      if (mismatched.size() < e->size * 8) {
-        mismatched.resize(e->size * 8);
-      }
-      for (int i = 0; i < e->size; ++i) {
-        for (int j = 0; j < 8; ++j) {
-          int bit = ((e->dat[i] >> (7 - j)) & 1) != 0;
-          mismatched[i * 8 + j] += equal ? (bit != bit_to_find) : (bit == bit_to_find);
-        }
-      }
-    }
+  std::vector<const std::pair<const MessageId, std::vector<const CanEvent *>> *> msgs;
+  for (const auto &m : can->eventsMap()) {
+    if (m.first.source == find_bus && !m.second.empty()) msgs.push_back(&m);
   }
 
+  // Pack each candidate bit's history and the aligned source-bit history into
+  // 64-bit words, one sample per frame; the mismatch count per bit is then a
+  // popcount of the XOR of the two words streams instead of a per-bit loop.
   std::vector<mismatched_struct> result;
-  result.reserve(mismatches.size());
-  for (auto it = mismatches.begin(); it != mismatches.end(); ++it) {
-    if (auto cnt = msg_count[it->first]; cnt > (uint32_t)min_msgs_cnt) {
-      auto &mismatched = it->second;
-      for (int i = 0; i < (int)mismatched.size(); ++i) {
-        if (float perc = (mismatched[i] / (double)cnt) * 100; perc < 50) {
-          result.push_back({it->first, (uint32_t)i / 8, (uint32_t)i % 8, mismatched[i], cnt, perc});
+  std::mutex lock;
+  std::atomic<size_t> next_msg = 0;
+  unsigned int num_threads = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < std::min<size_t>(num_threads, msgs.size()); ++t) {
+    threads.emplace_back([&]() {
+      std::vector<mismatched_struct> local;
+      for (size_t m; (m = next_msg.fetch_add(1)) < msgs.size();) {
+        const auto &[id, events] = *msgs[m];
+        const uint32_t total = events.size();
+        if (!src_timeline.empty() && total > (uint32_t)min_msgs_cnt && events.front()->size == events.back()->size) {
+          const int num_bits = events.front()->size * 8;
+          const size_t num_words = (total + 63) / 64;
+          std::vector<uint64_t> src_bits(num_words, 0);
+          std::vector<std::vector<uint64_t>> bits(num_bits, std::vector<uint64_t>(num_words, 0));
+
+          uint64_t n = 0;
+          size_t src_idx = 0;
+          for (const CanEvent *e : events) {
+            // sample the source bit at this frame's time
+            while (src_idx + 1 < src_timeline.size() && src_timeline[src_idx + 1].first <= e->mono_time) ++src_idx;
+            if (src_timeline[src_idx].first > e->mono_time) continue;  // before the first source frame
+
+            const size_t word = n >> 6, shift = n & 63;
+            src_bits[word] |= src_timeline[src_idx].second << shift;
+            const int nbytes = std::min<int>(e->size, num_bits / 8);
+            for (int i = 0; i < nbytes; ++i) {
+              for (int j = 0; j < 8; ++j) {
+                bits[i * 8 + j][word] |= (uint64_t)((e->dat[i] >> (7 - j)) & 1) << shift;
+              }
+            }
+            ++n;
+          }
+
+          if (n == 0) continue;  // every frame predates the first source sample
+
+          // unused sample slots are zero in both streams, so they cancel in the xor
+          for (int b = 0; b < num_bits; ++b) {
+            uint64_t diff = 0;
+            for (size_t w = 0; w < num_words; ++w) diff += __builtin_popcountll(bits[b][w] ^ src_bits[w]);
+            const uint64_t mismatched = equal ? diff : n - diff;
+            if (float perc = (mismatched / (double)total) * 100; perc < 50) {
+              local.push_back({id.address, (uint32_t)b / 8, (uint32_t)b % 8, (uint32_t)mismatched, total, perc});
+            }
+          }
         }
       }
-    }
+      if (!local.empty()) {
+        std::lock_guard lk(lock);
+        result.insert(result.end(), local.begin(), local.end());
+      }
+    });
+  }
+  for (auto &th : threads) th.join();
+
+  // keep the best matches; the full bit grid of a route is far more than the table needs
+  constexpr size_t MAX_RESULTS = 1000;
+  auto cmp = [](auto &l, auto &r) { return l.perc < r.perc; };
+  if (result.size() > MAX_RESULTS) {
+    std::partial_sort(result.begin(), result.begin() + MAX_RESULTS, result.end(), cmp);
+    result.resize(MAX_RESULTS);
+  } else {
+    std::sort(result.begin(), result.end(), cmp);
   }
-  std::sort(result.begin(), result.end(), [](auto &l, auto &r) { return l.perc < r.perc; });
   return result;
 }
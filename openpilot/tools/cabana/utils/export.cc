@@ -1,45 +1,100 @@
 #include "tools/cabana/utils/export.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <QFile>
-#include <QTextStream>
 
 #include "tools/cabana/streams/abstractstream.h"
 
 namespace utils {
 
+namespace {
+
+constexpr char HEX_CHARS[] = "0123456789ABCDEF";
+
+// Splits [0, count) into one chunk per thread and encodes the chunks
+// concurrently. Buffers come back in index order, so writing them
+// sequentially produces the same bytes as a single-threaded pass.
+std::vector<std::string> encodeParallel(size_t count, const std::function<void(size_t, size_t, std::string &)> &encode) {
+  size_t num_threads = std::max(1u, std::thread::hardware_concurrency());
+  // not worth spinning up threads for small exports
+  num_threads = std::min(num_threads, std::max<size_t>(count / 20000, 1));
+
+  std::vector<std::string> bufs(num_threads);
+  std::vector<std::thread> threads;
+  const size_t chunk = (count + num_threads - 1) / num_threads;
+  for (size_t t = 0; t < num_threads && t * chunk < count; ++t) {
+    const size_t begin = t * chunk, end = std::min(begin + chunk, count);
+    threads.emplace_back([&, t, begin, end]() { encode(begin, end, bufs[t]); });
+  }
+  for (auto &th : threads) th.join();
+  return bufs;
+}
+
+}  // namespace
+
 void exportToCSV(const QString &file_name, std::optional<MessageId> msg_id) {
   QFile file(file_name);
-  if (file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
-    QTextStream stream(&file);
-    stream << "time,addr,bus,data\n";
-    for (auto e : msg_id ? can->events(*msg_id) : can->allEvents()) {
-      stream << QString::number(can->toSeconds(e->mono_time), 'f', 3) << ","
-             << "0x" << QString::number(e->address, 16) << "," << e->src << ","
-             << "0x" << QByteArray::fromRawData((const char *)e->dat, e->size).toHex().toUpper() << "\n";
+  if (!file.open(QIODevice::ReadWrite | QIODevice::Truncate)) return;
+
+  const auto &events = msg_id ? can->events(*msg_id) : can->allEvents();
+  auto bufs = encodeParallel(events.size(), [&](size_t begin, size_t end, std::string &buf) {
+    char row[64];
+    buf.reserve((end - begin) * 48);
+    for (size_t i = begin; i < end; ++i) {
+      const CanEvent *e = events[i];
+      int n = snprintf(row, sizeof(row), "%.3f,0x%x,%u,0x", can->toSeconds(e->mono_time), e->address, e->src);
+      buf.append(row, n);
+      for (int j = 0; j < e->size; ++j) {
+        buf.push_back(HEX_CHARS[e->dat[j] >> 4]);
+        buf.push_back(HEX_CHARS[e->dat[j] & 0xf]);
+      }
+      buf.push_back('\n');
     }
-  }
+  });
+
+  file.write("time,addr,bus,data\n");
+  for (const auto &buf : bufs) file.write(buf.data(), buf.size());
 }
 
 void exportSignalsToCSV(const QString &file_name, const MessageId &msg_id) {
   QFile file(file_name);
-  if (auto msg = dbc()->msg(msg_id); msg && msg->sigs.size() && file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
-    QTextStream stream(&file);
-    stream << "time,addr,bus";
-    for (auto s : msg->sigs)
-      stream << "," << s->name.c_str();
-    stream << "\n";
-
-    for (auto e : can->events(msg_id)) {
-      stream << QString::number(can->toSeconds(e->mono_time), 'f', 3) << ","
-             << "0x" << QString::number(e->address, 16) << "," << e->src;
-      for (auto s : msg->sigs) {
+  auto msg = dbc()->msg(msg_id);
+  if (!msg || msg->sigs.empty() || !file.open(QIODevice::ReadWrite | QIODevice::Truncate)) return;
+
+  std::string header = "time,addr,bus";
+  std::vector<cabana::SignalDecoder> decoders;
+  for (auto s : msg->sigs) {
+    header += "," + s->name;
+    decoders.emplace_back(*s);
+  }
+  header += "\n";
+
+  const auto &events = can->events(msg_id);
+  auto bufs = encodeParallel(events.size(), [&](size_t begin, size_t end, std::string &buf) {
+    char val[64];
+    buf.reserve((end - begin) * (16 + decoders.size() * 8));
+    for (size_t i = begin; i < end; ++i) {
+      const CanEvent *e = events[i];
+      int n = snprintf(val, sizeof(val), "%.3f,0x%x,%u", can->toSeconds(e->mono_time), e->address, e->src);
+      buf.append(val, n);
+      for (size_t j = 0; j < decoders.size(); ++j) {
         double value = 0;
-        s->getValue(e->dat, e->size, &value);
-        stream << "," << QString::number(value, 'f', s->precision);
+        decoders[j].getValue(e->dat, e->size, &value);
+        n = snprintf(val, sizeof(val), ",%.*f", msg->sigs[j]->precision, value);
+        buf.append(val, n);
       }
-      stream << "\n";
+      buf.push_back('\n');
     }
-  }
+  });
+
+  file.write(header.data(), header.size());
+  for (const auto &buf : bufs) file.write(buf.data(), buf.size());
 }
 
 }  // namespace utils
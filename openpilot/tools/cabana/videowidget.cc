@@ -334,6 +334,9 @@ StreamCameraView::StreamCameraView(std::string stream_name, VisionStreamType str
 
 void StreamCameraView::parseQLog(std::shared_ptr<LogReader> qlog) {
   std::mutex mutex;
+  // jpeg decode, scaling and the RGB565 conversion happen on the workers;
+  // QImage is safe off the GUI thread where QPixmap is not
+  std::map<uint64_t, std::pair<QImage, QImage>> decoded;  // {strip thumbnail, full frame}
   const auto &events = qlog->events;
   unsigned int num_threads = std::max(1u, std::thread::hardware_concurrency());
   size_t chunk = (events.size() + num_threads - 1) / num_threads;
@@ -341,24 +344,29 @@ void StreamCameraView::parseQLog(std::shared_ptr<LogReader> qlog) {
   for (unsigned int t = 0; t < num_threads && t * chunk < events.size(); ++t) {
     size_t start = t * chunk;
     size_t end = std::min(start + chunk, events.size());
-    threads.emplace_back([this, &mutex, &events, start, end]() {
+    threads.emplace_back([&mutex, &decoded, &events, start, end]() {
       for (size_t i = start; i < end; ++i) {
         const Event &e = events[i];
         if (e.which == cereal::Event::Which::THUMBNAIL) {
           capnp::FlatArrayMessageReader reader(e.data);
           auto thumb_data = reader.getRoot<cereal::Event>().getThumbnail();
           auto image_data = thumb_data.getThumbnail();
-          if (QPixmap thumb; thumb.loadFromData(image_data.begin(), image_data.size(), "jpeg")) {
-            QPixmap generated_thumb = generateThumbnail(thumb, can->toSeconds(thumb_data.getTimestampEof()));
+          if (QImage thumb; thumb.loadFromData(image_data.begin(), image_data.size(), "jpeg")) {
+            QImage small = thumb.scaledToHeight(MIN_VIDEO_HEIGHT - THUMBNAIL_MARGIN * 2, Qt::SmoothTransformation);
+            QImage big = thumb.convertToFormat(QImage::Format_RGB16);
             std::lock_guard lock(mutex);
-            thumbnails[thumb_data.getTimestampEof()] = generated_thumb;
-            big_thumbnails[thumb_data.getTimestampEof()] = thumb;
+            decoded[thumb_data.getTimestampEof()] = {std::move(small), std::move(big)};
           }
         }
       }
     });
   }
   for (auto &th : threads) th.join();
+
+  for (auto &[ts, imgs] : decoded) {
+    thumbnails[ts] = generateThumbnail(QPixmap::fromImage(imgs.first), can->toSeconds(ts));
+    big_thumbnails[ts] = std::move(imgs.second);
+  }
   update();
 }
 
@@ -383,24 +391,30 @@ void StreamCameraView::paintGL() {
 }
 
 QPixmap StreamCameraView::generateThumbnail(QPixmap thumb, double seconds) {
-  QPixmap scaled = thumb.scaledToHeight(MIN_VIDEO_HEIGHT - THUMBNAIL_MARGIN * 2, Qt::SmoothTransformation);
-  QPainter p(&scaled);
+  // input is already scaled to strip height; just draw the overlays
+  QPainter p(&thumb);
   p.setPen(QPen(palette().color(QPalette::BrightText), 2));
-  p.drawRect(scaled.rect());
+  p.drawRect(thumb.rect());
   if (auto alert = getReplay()->findAlertAtTime(seconds)) {
     p.setFont(QFont(font().family(), 10));
-    drawAlert(p, scaled.rect(), *alert);
+    drawAlert(p, thumb.rect(), *alert);
   }
-  return scaled;
+  return thumb;
 }
 
 void StreamCameraView::drawScrubThumbnail(QPainter &p) {
   p.fillRect(rect(), Qt::black);
   auto it = big_thumbnails.lower_bound(can->toMonoTime(thumbnail_dispaly_time));
   if (it != big_thumbnails.end()) {
-    QPixmap scaled_thumb = it->second.scaled(rect().size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    QRect thumb_rect(rect().center() - scaled_thumb.rect().center(), scaled_thumb.size());
-    p.drawPixmap(thumb_rect.topLeft(), scaled_thumb);
+    // smooth-scaling the full frame on every repaint stutters while scrubbing;
+    // redo it only when the hovered frame or the widget size changes
+    if (it->first != scrub_cache_time_ || rect().size() != scrub_cache_size_) {
+      scrub_cache_time_ = it->first;
+      scrub_cache_size_ = rect().size();
+      scrub_cache_ = QPixmap::fromImage(it->second.scaled(rect().size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
+    }
+    QRect thumb_rect(rect().center() - scrub_cache_.rect().center(), scrub_cache_.size());
+    p.drawPixmap(thumb_rect.topLeft(), scrub_cache_);
     drawTime(p, thumb_rect, thumbnail_dispaly_time);
   }
 }
@@ -48,8 +48,13 @@ private:
   void drawTime(QPainter &p, const QRect &rect, double seconds);
 
   QPropertyAnimation *fade_animation;
-  std::map<uint64_t, QPixmap> big_thumbnails;
+  // full frames are kept as RGB565 images to halve their resident size;
+  // the scrub view rescales one on demand and caches the result below
+  std::map<uint64_t, QImage> big_thumbnails;
   std::map<uint64_t, QPixmap> thumbnails;
+  QPixmap scrub_cache_;
+  uint64_t scrub_cache_time_ = 0;
+  QSize scrub_cache_size_;
   double thumbnail_dispaly_time = -1;
   friend class VideoWidget;
 };
@@ -0,0 +1,119 @@
+#include "tools/camerastream/stream_decoder.h"
+
+#include <utility>
+
+#include "openpilot/cereal/messaging/bridge_zmq.h"
+#include "openpilot/cereal/messaging/messaging.h"
+#include "system/camerad/cameras/nv12_info.h"
+#include "tools/replay/util.h"
+
+namespace {
+
+const int BUFFER_COUNT = 4;
+
+// v4l2 buffer flag marking an encoded keyframe (linux/videodev2.h)
+const uint32_t V4L2_BUF_FLAG_KEYFRAME = 0x8;
+
+}  // namespace
+
+StreamDecoder::StreamDecoder(const std::string &addr, const std::string &server_name, bool no_hw_decoder)
+    : addr_(addr), server_name_(server_name), no_hw_decoder_(no_hw_decoder) {}
+
+StreamDecoder::~StreamDecoder() {
+  stop();
+}
+
+void StreamDecoder::addStream(VisionStreamType stream_type, const std::string &service, int width, int height) {
+  streams_.push_back({.stream_type = stream_type, .service = service, .width = width, .height = height});
+}
+
+void StreamDecoder::start() {
+  vipc_server_ = std::make_unique<VisionIpcServer>(server_name_);
+  for (auto &s : streams_) {
+    auto [stride, y_height, uv_height_, buffer_size] = get_nv12_info(s.width, s.height);
+    (void)uv_height_;  // unused here
+    vipc_server_->create_buffers_with_sizes(s.stream_type, BUFFER_COUNT, s.width, s.height,
+                                            buffer_size, stride, stride * y_height);
+  }
+  vipc_server_->start_listener();
+
+  for (auto &s : streams_) {
+    s.thread = std::thread(&StreamDecoder::streamThread, this, std::ref(s));
+  }
+}
+
+void StreamDecoder::stop() {
+  exit_ = true;
+  for (auto &s : streams_) {
+    if (s.thread.joinable()) s.thread.join();
+  }
+  vipc_server_.reset(nullptr);
+}
+
+void StreamDecoder::streamThread(Stream &s) {
+  BridgeZmqContext ctx;
+  BridgeZmqSubSocket sock;
+  if (sock.connect(&ctx, s.service, addr_) != 0) {
+    rError("%s: failed to connect to %s", s.service.c_str(), addr_.c_str());
+    return;
+  }
+  sock.setTimeout(100);
+
+  FFmpegVideoDecoder decoder;
+  AVCodecParameters *codecpar = avcodec_parameters_alloc();
+  codecpar->codec_type = AVMEDIA_TYPE_VIDEO;
+  codecpar->codec_id = AV_CODEC_ID_HEVC;
+  codecpar->width = s.width;
+  codecpar->height = s.height;
+  bool opened = decoder.open(codecpar, !no_hw_decoder_);
+  avcodec_parameters_free(&codecpar);
+  if (!opened) {
+    rError("%s: failed to open decoder", s.service.c_str());
+    return;
+  }
+
+  AlignedBuffer aligned_buf;
+  bool seen_iframe = false;
+  while (!exit_) {
+    // the bridge may pack a whole poll tick into one multi-part message
+    for (Message *raw : sock.receiveParts()) {
+      std::unique_ptr<Message> msg(raw);
+      if (exit_) continue;
+
+      capnp::FlatArrayMessageReader reader(aligned_buf.align(msg.get()));
+      auto evt = reader.getRoot<cereal::Event>();
+      cereal::EncodeData::Reader edata;
+      if (evt.isRoadEncodeData()) {
+        edata = evt.getRoadEncodeData();
+      } else if (evt.isDriverEncodeData()) {
+        edata = evt.getDriverEncodeData();
+      } else if (evt.isWideRoadEncodeData()) {
+        edata = evt.getWideRoadEncodeData();
+      } else {
+        continue;
+      }
+
+      auto idx = edata.getIdx();
+      if (!seen_iframe) {
+        // nothing is decodable until a keyframe arrives; prime the decoder
+        // with the codec header (SPS/PPS) first, which yields no frame
+        if (!(idx.getFlags() & V4L2_BUF_FLAG_KEYFRAME)) continue;
+        auto header = edata.getHeader();
+        decoder.decodePacket(header.begin(), header.size(), nullptr);
+        seen_iframe = true;
+      }
+
+      auto data = edata.getData();
+      VisionBuf *buf = vipc_server_->get_buffer(s.stream_type);
+      if (!decoder.decodePacket(data.begin(), data.size(), buf)) continue;
+
+      VisionIpcBufExtra extra = {
+          .frame_id = idx.getFrameId(),
+          .timestamp_sof = idx.getTimestampSof(),
+          .timestamp_eof = idx.getTimestampEof(),
+      };
+      buf->set_frame_id(idx.getFrameId());
+      vipc_server_->send(buf, &extra);
+    }
+  }
+}
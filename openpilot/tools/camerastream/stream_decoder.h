@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "msgq/visionipc/visionipc_server.h"
+#include "tools/replay/framereader.h"
+
+// Decode-and-publish core for compressed_vipc: one thread per remote encode
+// stream, each demuxed packet goes through the replay FFmpeg decoder
+// (NVDEC/VAAPI when available) straight into a VisionIpc buffer.
+class StreamDecoder {
+public:
+  StreamDecoder(const std::string &addr, const std::string &server_name, bool no_hw_decoder = false);
+  ~StreamDecoder();
+  void addStream(VisionStreamType stream_type, const std::string &service, int width, int height);
+  void start();
+  void stop();
+
+private:
+  struct Stream {
+    VisionStreamType stream_type;
+    std::string service;
+    int width;
+    int height;
+    std::thread thread;
+  };
+  void streamThread(Stream &stream);
+
+  std::string addr_;
+  std::string server_name_;
+  bool no_hw_decoder_;
+  std::atomic<bool> exit_ = false;
+  std::unique_ptr<VisionIpcServer> vipc_server_;
+  std::vector<Stream> streams_;
+};
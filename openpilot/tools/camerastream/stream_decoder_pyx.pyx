@@ -0,0 +1,36 @@
+# distutils: language = c++
+# cython: language_level = 3
+from libcpp cimport bool as cbool
+from libcpp.string cimport string
+
+cdef extern from "msgq/visionipc/visionipc.h":
+  ctypedef enum VisionStreamType:
+    pass
+
+cdef extern from "tools/camerastream/stream_decoder.h":
+  cdef cppclass c_StreamDecoder "StreamDecoder":
+    c_StreamDecoder(const string &addr, const string &server_name, cbool no_hw_decoder) except +
+    void addStream(VisionStreamType stream_type, const string &service, int width, int height) except +
+    void start() except +
+    void stop() nogil
+
+
+cdef class StreamDecoder:
+  """Native decode-and-publish core: remote encode streams in, VisionIPC out."""
+  cdef c_StreamDecoder *dec
+
+  def __cinit__(self, str addr, str server_name, no_hw_decoder=False):
+    self.dec = new c_StreamDecoder(addr.encode(), server_name.encode(), no_hw_decoder)
+
+  def __dealloc__(self):
+    del self.dec
+
+  def add_stream(self, int stream_type, str service, int width, int height):
+    self.dec.addStream(<VisionStreamType>stream_type, service.encode(), width, height)
+
+  def start(self):
+    self.dec.start()
+
+  def stop(self):
+    with nogil:
+      self.dec.stop()
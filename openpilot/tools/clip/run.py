@@ -3,12 +3,10 @@ import os
 import sys
 import time
 import logging
-import subprocess
 import threading
 import queue
 import multiprocessing
 import itertools
-import numpy as np
 import tqdm
 from argparse import ArgumentParser
 from pathlib import Path
@@ -17,7 +15,7 @@ from concurrent.futures import ThreadPoolExecutor, as_completed
 from openpilot.tools.lib.route import Route
 from openpilot.tools.lib.logreader import LogReader
 from openpilot.tools.lib.filereader import FileReader
-from openpilot.tools.lib.framereader import FrameReader, ffprobe
+from openpilot.tools.lib.framereader import ffprobe
 from openpilot.selfdrive.test.process_replay.migration import migrate_all
 from openpilot.common.prefix import OpenpilotPrefix
 from openpilot.common.utils import Timer
@@ -134,11 +132,12 @@ def get_frame_dimensions(camera_path: str) -> tuple[int, int]:
   return stream["width"], stream["height"]
 
 
-def iter_segment_frames(camera_paths, start_time, end_time, fps=20, use_qcam=False, frame_size: tuple[int, int] | None = None):
+def iter_segment_frames(camera_paths, start_time, end_time, fps=20):
+  from openpilot.tools.replay.clip_frames_pyx import ClipFrameSource
   frames_per_seg = fps * 60
   start_frame, end_frame = int(start_time * fps), int(end_time * fps)
   current_seg: int = -1
-  seg_frames: FrameReader | np.ndarray | None = None
+  seg_frames: ClipFrameSource | None = None
 
   for global_idx in range(start_frame, end_frame):
     seg_idx, local_idx = global_idx // frames_per_seg, global_idx % frames_per_seg
@@ -148,25 +147,14 @@ def iter_segment_frames(camera_paths, start_time, end_time, fps=20, use_qcam=Fal
       path = camera_paths[seg_idx] if seg_idx < len(camera_paths) else None
       if not path:
         raise RuntimeError(f"No camera file for segment {seg_idx}")
-
-      if use_qcam:
-        w, h = frame_size or get_frame_dimensions(path)
-        with FileReader(path) as f:
-          result = subprocess.run(["ffmpeg", "-v", "quiet", "-i", "-", "-f", "rawvideo", "-pix_fmt", "nv12", "-"],
-                                  input=f.read(), capture_output=True)
-        if result.returncode != 0:
-          raise RuntimeError(f"ffmpeg failed: {result.stderr.decode()}")
-        seg_frames = np.frombuffer(result.stdout, dtype=np.uint8).reshape(-1, w * h * 3 // 2)
-      else:
-        seg_frames = FrameReader(path, pix_fmt="nv12")
+      seg_frames = ClipFrameSource(path)
 
     assert seg_frames is not None
-    frame = seg_frames[local_idx] if use_qcam else seg_frames.get(local_idx)
-    yield global_idx, frame
+    yield global_idx, seg_frames.get(local_idx)
 
 
 class FrameQueue:
-  def __init__(self, camera_paths, start_time, end_time, fps=20, prefetch_count=60, use_qcam=False):
+  def __init__(self, camera_paths, start_time, end_time, fps=20, prefetch_count=60):
     # Probe first valid camera file for dimensions
     first_path = next((p for p in camera_paths if p), None)
     if not first_path:
@@ -175,15 +163,15 @@ class FrameQueue:
 
     self._queue, self._stop, self._error = queue.Queue(maxsize=prefetch_count), threading.Event(), None
     self._thread = threading.Thread(target=self._worker,
-                                    args=(camera_paths, start_time, end_time, fps, use_qcam, (self.frame_w, self.frame_h)), daemon=True)
+                                    args=(camera_paths, start_time, end_time, fps), daemon=True)
     self._thread.start()
 
-  def _worker(self, camera_paths, start_time, end_time, fps, use_qcam, frame_size):
+  def _worker(self, camera_paths, start_time, end_time, fps):
     try:
-      for idx, data in iter_segment_frames(camera_paths, start_time, end_time, fps, use_qcam, frame_size):
+      for idx, data in iter_segment_frames(camera_paths, start_time, end_time, fps):
         if self._stop.is_set():
           break
-        self._queue.put((idx, data.tobytes()))
+        self._queue.put((idx, data))
     except Exception as e:
       logger.exception("Decode error")
       self._error = e
@@ -310,7 +298,7 @@ def clip(route: Route, output: str, start: int, end: int, headless: bool = True,
   with OpenpilotPrefix(shared_download_cache=True):
     metadata = load_route_metadata(route) if show_metadata else None
     camera_paths = route.qcamera_paths() if use_qcam else route.camera_paths()
-    frame_queue = FrameQueue(camera_paths, start, end, fps=FRAMERATE, use_qcam=use_qcam)
+    frame_queue = FrameQueue(camera_paths, start, end, fps=FRAMERATE)
 
     ecamera_paths = route.ecamera_paths() if not use_qcam else []
     wide_frame_queue: FrameQueue | None = None
@@ -159,6 +159,7 @@ void rebuild_series_lookup_preserving_formats(AppSession *session,
   session->series_by_path.reserve(session->route_data.series.size());
   for (RouteSeries &series : session->route_data.series) {
     session->series_by_path.emplace(series.path, &series);
+    app_extend_series_lod(&series);
     if (refresh_updated_formats_only) {
       if (!updated_prefix.empty() && util::starts_with(series.path, prefix)) {
         const bool enum_like = session->route_data.enum_info.find(series.path) != session->route_data.enum_info.end();
@@ -178,8 +179,11 @@ bool apply_route_can_decode_update(AppSession *session, UiState *state) {
     state->open_error_popup = true;
     return false;
   }
+  // only the path index is rebuilt here; plotted signals are re-materialized
+  // lazily on the next frame
   std::unordered_map<std::string, EnumInfo> can_enum_info;
-  std::vector<RouteSeries> can_series = decode_can_messages(session->route_data.can_messages, active_dbc_name, &can_enum_info);
+  std::vector<RouteSeries> can_series = index_can_messages(session->route_data.can_messages, active_dbc_name, &can_enum_info);
+  session->lazy_can_attempted.clear();
 
   std::vector<RouteSeries> updated_series;
   updated_series.reserve(session->route_data.series.size() + can_series.size());
@@ -223,6 +227,75 @@ bool apply_route_can_decode_update(AppSession *session, UiState *state) {
   return true;
 }
 
+void materialize_lazy_can_series(AppSession *session, UiState *state) {
+  if (session->route_data.can_messages.empty()) {
+    return;
+  }
+
+  std::vector<std::string> pending;
+  auto add_candidate = [&](const std::string &path) {
+    if (!is_decoded_can_series_path(path)) return;
+    if (session->lazy_can_attempted.find(path) != session->lazy_can_attempted.end()) return;
+    auto it = session->series_by_path.find(path);
+    if (it == session->series_by_path.end() || it->second == nullptr || !it->second->times.empty()) return;
+    if (std::find(pending.begin(), pending.end(), path) == pending.end()) {
+      pending.push_back(path);
+    }
+  };
+  for (const WorkspaceTab &tab : session->layout.tabs) {
+    for (const Pane &pane : tab.panes) {
+      for (const Curve &curve : pane.curves) {
+        add_candidate(curve.name);
+        if (curve.custom_python.has_value()) {
+          add_candidate(curve.custom_python->linked_source);
+          for (const std::string &source : curve.custom_python->additional_sources) {
+            add_candidate(source);
+          }
+        }
+      }
+    }
+  }
+  if (state->custom_series.open) {
+    add_candidate(state->custom_series.linked_source);
+    for (const std::string &source : state->custom_series.additional_sources) {
+      add_candidate(source);
+    }
+  }
+  if (pending.empty()) {
+    return;
+  }
+
+  const std::string active_dbc_name = !session->dbc_override.empty() ? session->dbc_override : session->route_data.dbc_name;
+  std::vector<RouteSeries> decoded = decode_can_messages_for_paths(session->route_data.can_messages, active_dbc_name, pending);
+  for (RouteSeries &series : decoded) {
+    auto it = session->series_by_path.find(series.path);
+    if (it == session->series_by_path.end() || it->second == nullptr || !it->second->times.empty()) continue;
+    it->second->times = std::move(series.times);
+    it->second->values = std::move(series.values);
+    app_extend_series_lod(it->second);
+    const bool enum_like = session->route_data.enum_info.find(series.path) != session->route_data.enum_info.end();
+    session->route_data.series_formats[series.path] = compute_series_format(it->second->values, enum_like);
+  }
+  for (const std::string &path : pending) {
+    session->lazy_can_attempted.insert(path);
+  }
+
+  // custom curves that sampled an empty source before now have data to read
+  bool refresh_custom = false;
+  for (const WorkspaceTab &tab : session->layout.tabs) {
+    for (const Pane &pane : tab.panes) {
+      for (const Curve &curve : pane.curves) {
+        if (!curve.custom_python.has_value()) continue;
+        refresh_custom = refresh_custom
+          || std::find(pending.begin(), pending.end(), curve.custom_python->linked_source) != pending.end();
+      }
+    }
+  }
+  if (refresh_custom) {
+    refresh_all_custom_curves(session, state);
+  }
+}
+
 void apply_dbc_override_change(AppSession *session, UiState *state, const std::string &dbc_override) {
   session->dbc_override = dbc_override;
   if (session->data_mode == SessionDataMode::Stream) {
@@ -867,18 +940,16 @@ void draw_sidebar(AppSession *session, const UiMetrics &ui, UiState *state, bool
     ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(8.0f, 3.0f));
     if (ImGui::BeginChild("##timeseries_browser", ImVec2(0.0f, browser_height), true)) {
       const std::string filter = lowercase_copy(state->browser_filter);
-      std::vector<std::string> visible_paths;
-      for (const BrowserNode &node : session->browser_nodes) {
-        collect_visible_leaf_paths(node, filter, &visible_paths);
-      }
+      update_browser_filter(session, filter);
+      const std::vector<std::string> &visible_paths = session->browser_index.visible_paths;
       for (const SpecialItemSpec &spec : kSpecialItemSpecs) {
         draw_browser_special_item(spec.id, spec.label);
       }
       ImGui::Dummy(ImVec2(0.0f, 2.0f));
       ImGui::Separator();
       ImGui::Dummy(ImVec2(0.0f, 2.0f));
-      for (const BrowserNode &node : session->browser_nodes) {
-        draw_browser_node(session, node, state, filter, visible_paths);
+      for (BrowserNode &node : session->browser_nodes) {
+        draw_browser_node(session, &node, state, filter, visible_paths);
       }
     }
     ImGui::EndChild();
@@ -17,6 +17,7 @@
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 // *****
@@ -118,10 +119,21 @@ struct WorkspaceTab {
   std::vector<Pane> panes;
 };
 
+struct RouteSeriesLod {
+  size_t bucket_size = 0;  // base samples folded into each group of tile points
+  size_t folded = 0;       // base samples already represented in times/values
+  std::vector<double> times;
+  std::vector<double> values;
+};
+
 struct RouteSeries {
   std::string path;
   std::vector<double> times;
   std::vector<double> values;
+  // min/max decimation pyramid: level k folds buckets of 64*4^k base samples
+  // into their first/min/max/last points, extended incrementally as data
+  // arrives so draw time is bounded by pixels instead of route length
+  std::vector<RouteSeriesLod> lod_levels;
 };
 
 struct CameraSegmentFile {
@@ -368,6 +380,9 @@ struct RouteLoadProgress {
   uint64_t bytes_downloaded = 0;
   int num_workers = 1;
   std::string segment_name;
+  // timeline entries extracted from the segment just parsed, in absolute
+  // mono time; lets the loader surface the engagement bar before the merge
+  std::vector<TimelineEntry> timeline_entries;
 };
 
 using RouteLoadProgressCallback = std::function<void(const RouteLoadProgress &)>;
@@ -400,6 +415,14 @@ std::optional<dbc::Database> load_dbc_by_name(const std::string &dbc_name);
 std::vector<RouteSeries> decode_can_messages(const std::vector<CanMessageData> &can_messages,
                                              const std::string &dbc_name,
                                              std::unordered_map<std::string, EnumInfo> *enum_info = nullptr);
+// empty placeholder series for every signal the DBC can decode from the raw
+// frames; the values are materialized lazily by decode_can_messages_for_paths
+std::vector<RouteSeries> index_can_messages(const std::vector<CanMessageData> &can_messages,
+                                            const std::string &dbc_name,
+                                            std::unordered_map<std::string, EnumInfo> *enum_info = nullptr);
+std::vector<RouteSeries> decode_can_messages_for_paths(const std::vector<CanMessageData> &can_messages,
+                                                       const std::string &dbc_name,
+                                                       const std::vector<std::string> &paths);
 RouteData load_route_data(const std::string &route_name,
                           const std::string &data_dir = {},
                           const std::string &dbc_name = {},
@@ -465,8 +488,29 @@ struct StreamSourceConfig {
 
 struct BrowserNode {
   std::string label;
-  std::string full_path;
+  std::string full_path;  // set when the node itself names a leaf path
   std::vector<BrowserNode> children;
+  // lazy trie: the node covers this slice of BrowserIndex::paths and
+  // materializes its children from it the first time it is opened
+  uint32_t range_begin = 0;
+  uint32_t range_end = 0;
+  uint32_t prefix_len = 0;  // bytes of path consumed up to and including this label
+  int self_index = -1;      // index of the exact path when this node is a leaf
+  bool children_built = false;
+};
+
+// Backing store for the lazy browser trie: the sorted visible path list with
+// a lowercase shadow for filtering. The filter is matched once per edit
+// against the flat list (refining the previous match set when the new filter
+// extends it) instead of by recursive subtree scans every frame.
+struct BrowserIndex {
+  std::vector<std::string> paths;          // sorted, deprecation-pruned
+  std::vector<std::string> lower_paths;    // lowercase shadow of paths
+  std::string applied_filter;
+  bool filter_valid = false;
+  std::vector<uint32_t> match_prefix;      // prefix sums of matches over paths
+  std::vector<uint32_t> match_indices;     // matching path indices, ascending
+  std::vector<std::string> visible_paths;  // filtered leaves in draw order
 };
 
 struct AppSession {
@@ -483,10 +527,14 @@ struct AppSession {
   RouteData route_data;
   std::unordered_map<std::string, RouteSeries *> series_by_path;
   std::vector<BrowserNode> browser_nodes;
+  BrowserIndex browser_index;
   std::unique_ptr<AsyncRouteLoader> route_loader;
   std::unique_ptr<StreamPoller> stream_poller;
   std::array<std::unique_ptr<CameraFeedView>, 4> pane_camera_feeds;
   std::unique_ptr<MapDataManager> map_data;
+  // lazily decoded CAN paths we already tried, so a signal a DBC lists but
+  // the frames never carry is not re-decoded every frame
+  std::unordered_set<std::string> lazy_can_attempted;
   bool async_route_loading = false;
   double next_stream_custom_refresh_time = 0.0;
   bool stream_paused = false;
@@ -651,6 +699,7 @@ struct UiState {
   bool show_deprecated_fields = false;
   bool show_fps_overlay = false;
   bool fps_overlay_initialized = false;
+  int idle_frames = 0;  // frames rendered since the last input or data activity
   bool suppress_range_side_effects = false;
   bool browser_nodes_dirty = false;
   int active_tab_index = 0;
@@ -717,6 +766,10 @@ void app_decimate_samples(const std::vector<double> &xs_in,
                           int max_points,
                           std::vector<double> *xs_out,
                           std::vector<double> *ys_out);
+void app_extend_series_lod(RouteSeries *series);
+const RouteSeriesLod *app_select_series_lod(const RouteSeries &series,
+                                            size_t visible_samples,
+                                            int max_points);
 std::optional<double> app_sample_xy_value_at_time(const std::vector<double> &xs,
                                                    const std::vector<double> &ys,
                                                    bool stairs,
@@ -734,11 +787,9 @@ std::string format_display_value(double display_value,
                                  const SeriesFormat &format,
                                  const EnumInfo *enum_info);
 std::vector<std::string> decode_browser_drag_payload(std::string_view payload);
-void collect_visible_leaf_paths(const BrowserNode &node,
-                                const std::string &filter,
-                                std::vector<std::string> *out);
+void update_browser_filter(AppSession *session, const std::string &lower_filter);
 void draw_browser_node(AppSession *session,
-                       const BrowserNode &node,
+                       BrowserNode *node,
                        UiState *state,
                        const std::string &filter,
                        const std::vector<std::string> &visible_paths);
@@ -750,6 +801,7 @@ void draw_browser_node(AppSession *session,
 void open_custom_series_editor(UiState *state, const std::string &preferred_source = {});
 std::string preferred_custom_series_source(const Pane &pane);
 void refresh_all_custom_curves(AppSession *session, UiState *state);
+void pump_custom_series_results(AppSession *session, UiState *state);
 void draw_custom_series_editor(AppSession *session, UiState *state);
 
 // *****
@@ -775,6 +827,12 @@ struct RouteLoadSnapshot {
   size_t total_segments = 0;
   size_t segments_downloaded = 0;
   size_t segments_parsed = 0;
+  // engagement/alert entries accumulated so far, sorted by absolute mono
+  // time; segments parse out of order, so the bar fills in piecewise
+  bool has_partial_timeline = false;
+  double partial_x_min = 0.0;
+  double partial_x_max = 0.0;
+  std::vector<TimelineEntry> partial_timeline;
 };
 
 struct StreamPollSnapshot {
@@ -10,66 +10,109 @@ namespace {
 
 constexpr float BROWSER_VALUE_WIDTH = 88.0f;
 
-bool path_matches_filter(const std::string &path, const std::string &lower_filter) {
-  if (lower_filter.empty()) return true;
-  return lowercase_copy(path).find(lower_filter) != std::string::npos;
+// Orders paths so that every component groups contiguously: '/' compares
+// lower than any other byte, which keeps "/a/b/..." together ahead of "/a/bc".
+// The lazy trie below slices this order into child ranges.
+bool browser_path_less(const std::string &a, const std::string &b) {
+  const size_t n = std::min(a.size(), b.size());
+  for (size_t i = 0; i < n; ++i) {
+    const unsigned char ca = a[i], cb = b[i];
+    if (ca != cb) {
+      if (ca == '/') return true;
+      if (cb == '/') return false;
+      return ca < cb;
+    }
+  }
+  return a.size() < b.size();
 }
 
-void insert_browser_path(std::vector<BrowserNode> *nodes, const std::string &path) {
-  size_t start = 0;
-  while (start < path.size() && path[start] == '/') {
-    ++start;
-  }
-  std::vector<std::string> parts;
-  while (start < path.size()) {
-    const size_t end = path.find('/', start);
-    parts.push_back(path.substr(start, end == std::string::npos ? std::string::npos : end - start));
-    if (end == std::string::npos) break;
-    start = end + 1;
-  }
-  if (parts.empty()) {
-    return;
-  }
+bool range_has_match(const BrowserIndex &index, uint32_t begin, uint32_t end) {
+  if (index.applied_filter.empty()) return begin < end;
+  return index.match_prefix[end] > index.match_prefix[begin];
+}
 
-  std::vector<BrowserNode> *current_nodes = nodes;
-  std::string current_path;
-  for (size_t i = 0; i < parts.size(); ++i) {
-    if (!current_path.empty()) {
-      current_path += "/";
-    }
-    current_path += parts[i];
-    auto it = std::find_if(current_nodes->begin(), current_nodes->end(),
-                           [&](const BrowserNode &node) { return node.label == parts[i]; });
-    if (it == current_nodes->end()) {
-      current_nodes->push_back(BrowserNode{.label = parts[i]});
-      it = std::prev(current_nodes->end());
+bool path_is_match(const BrowserIndex &index, int i) {
+  if (index.applied_filter.empty()) return true;
+  return index.match_prefix[i + 1] > index.match_prefix[i];
+}
+
+// Materializes one trie level from a slice of the sorted path list. All
+// paths in [begin, end) share the first prefix_len bytes; each child node
+// takes the contiguous run of paths under its component.
+std::vector<BrowserNode> build_browser_level(const BrowserIndex &index, uint32_t begin, uint32_t end, uint32_t prefix_len) {
+  std::vector<BrowserNode> nodes;
+  uint32_t i = begin;
+  while (i < end) {
+    const std::string &path = index.paths[i];
+    const size_t comp_begin = prefix_len + 1;  // skip the '/'
+    const size_t slash = path.find('/', comp_begin);
+    const size_t comp_end = slash == std::string::npos ? path.size() : slash;
+
+    BrowserNode node;
+    node.label = path.substr(comp_begin, comp_end - comp_begin);
+    node.prefix_len = static_cast<uint32_t>(comp_end);
+    if (comp_end == path.size()) {
+      node.full_path = path;
+      node.self_index = static_cast<int>(i);
+      ++i;
     }
-    if (i + 1 == parts.size()) {
-      it->full_path = "/" + current_path;
+    node.range_begin = i;
+    while (i < end
+           && index.paths[i].size() > node.prefix_len
+           && index.paths[i][node.prefix_len] == '/'
+           && index.paths[i].compare(comp_begin, node.label.size(), node.label) == 0) {
+      ++i;
     }
-    current_nodes = &it->children;
+    node.range_end = i;
+    node.children_built = node.range_begin == node.range_end;  // pure leaves have nothing to build
+    nodes.push_back(std::move(node));
   }
+  // subtrees first, then plain leaves, alphabetical within each
+  std::stable_partition(nodes.begin(), nodes.end(),
+                        [](const BrowserNode &node) { return node.range_end > node.range_begin; });
+  return nodes;
 }
 
-void sort_browser_nodes(std::vector<BrowserNode> *nodes) {
-  std::sort(nodes->begin(), nodes->end(), [](const BrowserNode &a, const BrowserNode &b) {
-    if (a.children.empty() != b.children.empty()) {
-      return !a.children.empty();
+// Collects the filtered leaf paths in draw order (subtrees before leaves at
+// every level) straight from the path slices, without materializing nodes.
+void collect_filtered_leaves(const BrowserIndex &index, uint32_t begin, uint32_t end, uint32_t prefix_len, std::vector<std::string> *out) {
+  struct ChildRange {
+    uint32_t begin, end, prefix_len;
+  };
+  std::vector<ChildRange> subtrees;
+  std::vector<uint32_t> leaves;
+  uint32_t i = begin;
+  while (i < end) {
+    const std::string &path = index.paths[i];
+    const size_t comp_begin = prefix_len + 1;
+    const size_t slash = path.find('/', comp_begin);
+    const size_t comp_end = slash == std::string::npos ? path.size() : slash;
+    int self_index = -1;
+    if (comp_end == path.size()) {
+      self_index = static_cast<int>(i);
+      ++i;
+    }
+    const uint32_t child_begin = i;
+    while (i < end
+           && index.paths[i].size() > comp_end
+           && index.paths[i][comp_end] == '/'
+           && index.paths[i].compare(comp_begin, comp_end - comp_begin, path, comp_begin, comp_end - comp_begin) == 0) {
+      ++i;
+    }
+    if (child_begin < i) {
+      if (range_has_match(index, child_begin, i)) {
+        subtrees.push_back(ChildRange{child_begin, i, static_cast<uint32_t>(comp_end)});
+      }
+    } else if (self_index >= 0 && path_is_match(index, self_index)) {
+      leaves.push_back(static_cast<uint32_t>(self_index));
     }
-    return a.label < b.label;
-  });
-  for (BrowserNode &node : *nodes) {
-    sort_browser_nodes(&node.children);
   }
-}
-
-std::vector<BrowserNode> build_browser_tree(const std::vector<std::string> &paths) {
-  std::vector<BrowserNode> nodes;
-  for (const std::string &path : paths) {
-    insert_browser_path(&nodes, path);
+  for (const ChildRange &range : subtrees) {
+    collect_filtered_leaves(index, range.begin, range.end, range.prefix_len, out);
+  }
+  for (const uint32_t leaf : leaves) {
+    out->push_back(index.paths[leaf]);
   }
-  sort_browser_nodes(&nodes);
-  return nodes;
 }
 
 bool is_deprecated_browser_path(const std::string &path) {
@@ -213,17 +256,6 @@ std::string browser_series_value_text(const AppSession &session, const UiState &
   return format_display_value(*value, display_info, enum_info);
 }
 
-bool browser_node_matches(const BrowserNode &node, const std::string &filter) {
-  if (filter.empty()) return true;
-  if (!node.full_path.empty() && path_matches_filter(node.full_path, filter)) {
-    return true;
-  }
-  for (const BrowserNode &child : node.children) {
-    if (browser_node_matches(child, filter)) return true;
-  }
-  return false;
-}
-
 }  // namespace
 
 namespace {
@@ -334,53 +366,99 @@ std::vector<std::string> decode_browser_drag_payload(std::string_view payload) {
   return out;
 }
 
-void collect_visible_leaf_paths(const BrowserNode &node,
-                                const std::string &filter,
-                                std::vector<std::string> *out) {
-  if (!browser_node_matches(node, filter)) {
+void rebuild_browser_nodes(AppSession *session, UiState *state) {
+  BrowserIndex &index = session->browser_index;
+  index.paths = visible_browser_paths(session->route_data, state->show_deprecated_fields);
+  std::sort(index.paths.begin(), index.paths.end(), browser_path_less);
+  index.lower_paths.clear();
+  index.lower_paths.reserve(index.paths.size());
+  for (const std::string &path : index.paths) {
+    index.lower_paths.push_back(lowercase_copy(path));
+  }
+  index.filter_valid = false;
+  // only the top level is materialized here; deeper levels build on first open
+  session->browser_nodes = build_browser_level(index, 0, static_cast<uint32_t>(index.paths.size()), 0);
+  prune_browser_selection(state, index.paths);
+}
+
+void update_browser_filter(AppSession *session, const std::string &lower_filter) {
+  BrowserIndex &index = session->browser_index;
+  if (index.filter_valid && index.applied_filter == lower_filter) {
     return;
   }
-  if (node.children.empty()) {
-    if (!node.full_path.empty()) {
-      out->push_back(node.full_path);
+
+  if (lower_filter.empty()) {
+    index.match_indices.clear();
+    index.match_prefix.clear();
+  } else if (index.filter_valid && !index.applied_filter.empty()
+             && lower_filter.find(index.applied_filter) != std::string::npos) {
+    // the new filter contains the old one, so it can only narrow the match
+    // set; rescan just the previous matches instead of every path
+    std::vector<uint32_t> refined;
+    refined.reserve(index.match_indices.size());
+    for (const uint32_t i : index.match_indices) {
+      if (index.lower_paths[i].find(lower_filter) != std::string::npos) {
+        refined.push_back(i);
+      }
+    }
+    index.match_indices = std::move(refined);
+  } else {
+    index.match_indices.clear();
+    for (uint32_t i = 0; i < index.lower_paths.size(); ++i) {
+      if (index.lower_paths[i].find(lower_filter) != std::string::npos) {
+        index.match_indices.push_back(i);
+      }
     }
-    return;
   }
-  for (const BrowserNode &child : node.children) {
-    collect_visible_leaf_paths(child, filter, out);
+  if (!lower_filter.empty()) {
+    index.match_prefix.assign(index.paths.size() + 1, 0);
+    for (const uint32_t i : index.match_indices) {
+      index.match_prefix[i + 1] = 1;
+    }
+    for (size_t i = 1; i < index.match_prefix.size(); ++i) {
+      index.match_prefix[i] += index.match_prefix[i - 1];
+    }
   }
-}
+  index.applied_filter = lower_filter;
+  index.filter_valid = true;
 
-void rebuild_browser_nodes(AppSession *session, UiState *state) {
-  const std::vector<std::string> paths = visible_browser_paths(session->route_data, state->show_deprecated_fields);
-  session->browser_nodes = build_browser_tree(paths);
-  prune_browser_selection(state, paths);
+  index.visible_paths.clear();
+  if (!index.paths.empty()) {
+    collect_filtered_leaves(index, 0, static_cast<uint32_t>(index.paths.size()), 0, &index.visible_paths);
+  }
 }
 
 void rebuild_route_index(AppSession *session) {
   session->series_by_path.clear();
   session->route_data.series_formats.clear();
+  session->lazy_can_attempted.clear();
   for (RouteSeries &series : session->route_data.series) {
     session->series_by_path.emplace(series.path, &series);
+    app_extend_series_lod(&series);
     const bool enum_like = session->route_data.enum_info.find(series.path) != session->route_data.enum_info.end();
     session->route_data.series_formats.emplace(series.path, compute_series_format(series.values, enum_like));
   }
 }
 
 void draw_browser_node(AppSession *session,
-                       const BrowserNode &node,
+                       BrowserNode *node,
                        UiState *state,
                        const std::string &filter,
                        const std::vector<std::string> &visible_paths) {
-  if (!browser_node_matches(node, filter)) {
-    return;
+  const BrowserIndex &index = session->browser_index;
+  const bool is_dir = node->range_end > node->range_begin;
+  if (!filter.empty()) {
+    const bool self_match = node->self_index >= 0 && path_is_match(index, node->self_index);
+    if (!self_match && !range_has_match(index, node->range_begin, node->range_end)) {
+      return;
+    }
   }
 
-  if (node.children.empty()) {
-    const std::string value_text = browser_series_value_text(*session, *state, node.full_path);
+  if (!is_dir) {
+    const std::string value_text = browser_series_value_text(*session, *state, node->full_path);
     const ImGuiStyle &style = ImGui::GetStyle();
     const ImVec2 row_size(std::max(1.0f, ImGui::GetContentRegionAvail().x), ImGui::GetFrameHeight());
-    ImGui::PushID(node.full_path.c_str());
+    ImGui::PushID(node->full_path.c_str());
     const bool clicked = ImGui::InvisibleButton("##browser_leaf", row_size);
     const bool hovered = ImGui::IsItemHovered();
     const ImRect rect(ImGui::GetItemRectMin(), ImGui::GetItemRectMax());
@@ -400,7 +478,7 @@ void draw_browser_node(AppSession *session,
                               ImVec2(label_left, rect.Min.y + style.FramePadding.y),
                               ImVec2(label_right, rect.Max.y),
                               label_right,
-                              node.label.c_str(),
+                              node->label.c_str(),
                               nullptr,
                               nullptr);
     if (!value_text.empty()) {
@@ -420,19 +498,19 @@ void draw_browser_node(AppSession *session,
       const bool shift_down = ImGui::GetIO().KeyShift;
       const bool ctrl_down = ImGui::GetIO().KeyCtrl || ImGui::GetIO().KeySuper;
       if (shift_down) {
-        select_browser_range(state, visible_paths, node.full_path);
+        select_browser_range(state, visible_paths, node->full_path);
       } else if (ctrl_down) {
-        toggle_browser_selection(state, node.full_path);
+        toggle_browser_selection(state, node->full_path);
       } else {
-        set_browser_selection_single(state, node.full_path);
+        set_browser_selection_single(state, node->full_path);
       }
     }
     if (hovered && ImGui::IsMouseDoubleClicked(0)) {
-      set_browser_selection_single(state, node.full_path);
-      app_add_curve_to_active_pane(session, state, node.full_path);
+      set_browser_selection_single(state, node->full_path);
+      app_add_curve_to_active_pane(session, state, node->full_path);
     }
     if (ImGui::BeginDragDropSource(ImGuiDragDropFlags_SourceAllowNullID)) {
-      const std::vector<std::string> drag_paths = browser_drag_paths(*state, node.full_path);
+      const std::vector<std::string> drag_paths = browser_drag_paths(*state, node->full_path);
       const std::string payload = encode_browser_drag_payload(drag_paths);
       ImGui::SetDragDropPayload("JOTP_BROWSER_PATHS", payload.c_str(), payload.size() + 1);
       if (drag_paths.size() == 1) {
@@ -448,10 +526,14 @@ void draw_browser_node(AppSession *session,
   }
 
   ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_SpanAvailWidth;
-  const bool open = ImGui::TreeNodeEx(node.label.c_str(), flags);
+  const bool open = ImGui::TreeNodeEx(node->label.c_str(), flags);
   if (open) {
-    for (const BrowserNode &child : node.children) {
-      draw_browser_node(session, child, state, filter, visible_paths);
+    if (!node->children_built) {
+      node->children = build_browser_level(index, node->range_begin, node->range_end, node->prefix_len);
+      node->children_built = true;
+    }
+    for (BrowserNode &child : node->children) {
+      draw_browser_node(session, &child, state, filter, visible_paths);
     }
     ImGui::TreePop();
   }
@@ -5,10 +5,14 @@
 
 #include <cfloat>
 #include <chrono>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <mutex>
 #include <regex>
 #include <set>
 #include <stdexcept>
+#include <thread>
 #include <unistd.h>
 
 #include "json11/json11.hpp"
@@ -145,12 +149,41 @@ std::set<std::string> collect_custom_series_paths(const CustomPythonSeries &spec
   return paths;
 }
 
-PythonEvalResult evaluate_custom_python_series(const AppSession &session,
+struct SeriesSnapshot {
+  std::string path;
+  std::vector<double> times;
+  std::vector<double> values;
+};
+
+// everything the worker needs, copied on the UI thread so the evaluation never
+// touches the session while routes load or stream batches land
+struct PythonEvalInputs {
+  CustomPythonSeries spec;
+  std::vector<std::string> route_paths;
+  std::vector<SeriesSnapshot> series;
+};
+
+PythonEvalInputs snapshot_custom_python_inputs(const AppSession &session,
                                                const CustomPythonSeries &spec) {
   const std::set<std::string> referenced_paths =
     collect_custom_series_paths(spec, spec.globals_code, spec.function_code);
   if (referenced_paths.empty()) throw std::runtime_error("No input series referenced. Set an input timeseries or reference route paths in code.");
 
+  PythonEvalInputs inputs;
+  inputs.spec = spec;
+  inputs.route_paths = session.route_data.paths;
+  for (const std::string &path : referenced_paths) {
+    const RouteSeries *series = app_find_route_series(session, path);
+    if (series == nullptr || series->times.size() < 2 || series->times.size() != series->values.size()) {
+      throw std::runtime_error("Missing route series " + path);
+    }
+    inputs.series.push_back(SeriesSnapshot{path, series->times, series->values});
+  }
+  return inputs;
+}
+
+PythonEvalResult evaluate_custom_python_inputs(const PythonEvalInputs &inputs) {
+  const CustomPythonSeries &spec = inputs.spec;
   const fs::path temp_dir = create_custom_series_temp_dir();
   try {
     const fs::path globals_path = temp_dir / "globals.py";
@@ -162,22 +195,18 @@ PythonEvalResult evaluate_custom_python_series(const AppSession &session,
     write_text_file(globals_path, spec.globals_code);
     write_text_file(code_path, spec.function_code);
 
-    json11::Json::array paths_json(session.route_data.paths.begin(), session.route_data.paths.end());
+    json11::Json::array paths_json(inputs.route_paths.begin(), inputs.route_paths.end());
     json11::Json::array additional_json(spec.additional_sources.begin(), spec.additional_sources.end());
     json11::Json::array series_json;
     size_t series_index = 0;
-    for (const std::string &path : referenced_paths) {
-      const RouteSeries *series = app_find_route_series(session, path);
-      if (series == nullptr || series->times.size() < 2 || series->times.size() != series->values.size()) {
-        throw std::runtime_error("Missing route series " + path);
-      }
+    for (const SeriesSnapshot &series : inputs.series) {
       const std::string prefix = "series_" + std::to_string(series_index++);
       const fs::path time_path = temp_dir / (prefix + ".t.bin");
       const fs::path value_path = temp_dir / (prefix + ".v.bin");
-      write_binary_vector(time_path, series->times);
-      write_binary_vector(value_path, series->values);
+      write_binary_vector(time_path, series.times);
+      write_binary_vector(value_path, series.values);
       series_json.push_back(json11::Json::object{
-        {"path", path}, {"t", time_path.string()}, {"v", value_path.string()}});
+        {"path", series.path}, {"t", time_path.string()}, {"v", value_path.string()}});
     }
     const json11::Json manifest_json = json11::Json::object{
       {"paths", std::move(paths_json)},
@@ -216,7 +245,140 @@ PythonEvalResult evaluate_custom_python_series(const AppSession &session,
   }
 }
 
-void refresh_custom_curve_samples(AppSession *session, UiState *state, Curve *curve) {
+enum class EvalTargetKind : uint8_t {
+  Curve,
+  Preview,
+  Apply,
+};
+
+struct EvalRequest {
+  EvalTargetKind kind = EvalTargetKind::Curve;
+  int tab_index = -1;
+  int pane_index = -1;
+  std::string curve_name;
+  PythonEvalInputs inputs;
+};
+
+struct EvalOutcome {
+  EvalTargetKind kind = EvalTargetKind::Curve;
+  int tab_index = -1;
+  int pane_index = -1;
+  std::string curve_name;
+  CustomPythonSeries spec;
+  PythonEvalResult result;
+  std::string error;
+};
+
+bool same_eval_target(const EvalRequest &a, const EvalRequest &b) {
+  return a.kind == b.kind && a.tab_index == b.tab_index
+      && a.pane_index == b.pane_index && a.curve_name == b.curve_name;
+}
+
+// background queue for python evaluations, modelled on MapDataManager: the UI
+// thread snapshots inputs and enqueues, the worker runs the interpreter, and
+// pump_custom_series_results applies finished outcomes on a later frame
+class CustomSeriesEvaluator {
+public:
+  static CustomSeriesEvaluator &instance() {
+    static CustomSeriesEvaluator evaluator;
+    return evaluator;
+  }
+
+  void enqueue(EvalRequest request) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      // a newer evaluation of the same target supersedes a queued one, so
+      // stream refreshes cannot pile up behind a slow interpreter
+      queue_.erase(std::remove_if(queue_.begin(), queue_.end(),
+                                  [&](const EvalRequest &queued) { return same_eval_target(queued, request); }),
+                   queue_.end());
+      queue_.push_back(std::move(request));
+    }
+    cv_.notify_one();
+  }
+
+  std::vector<EvalOutcome> drain() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<EvalOutcome> finished = std::move(completed_);
+    completed_.clear();
+    return finished;
+  }
+
+private:
+  CustomSeriesEvaluator() : worker_([this]() { run(); }) {}
+
+  ~CustomSeriesEvaluator() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+      worker_.join();
+    }
+  }
+
+  void run() {
+    while (true) {
+      EvalRequest request;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&]() { return stopping_ || !queue_.empty(); });
+        if (stopping_) {
+          return;
+        }
+        request = std::move(queue_.front());
+        queue_.pop_front();
+      }
+
+      EvalOutcome outcome;
+      outcome.kind = request.kind;
+      outcome.tab_index = request.tab_index;
+      outcome.pane_index = request.pane_index;
+      outcome.curve_name = request.curve_name;
+      outcome.spec = request.inputs.spec;
+      try {
+        outcome.result = evaluate_custom_python_inputs(request.inputs);
+      } catch (const std::exception &err) {
+        outcome.error = err.what();
+        if (outcome.error.empty()) {
+          outcome.error = "Python evaluation failed";
+        }
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        completed_.push_back(std::move(outcome));
+      }
+    }
+  }
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopping_ = false;
+  std::deque<EvalRequest> queue_;
+  std::vector<EvalOutcome> completed_;
+  std::thread worker_;
+};
+
+void apply_curve_eval_error(AppSession *session, UiState *state, Curve *curve, const std::string &err_text) {
+  curve->xs.clear();
+  curve->ys.clear();
+  if (session->data_mode == SessionDataMode::Stream && util::starts_with(err_text, "Missing route series ")) {
+    curve->runtime_error_message = err_text;
+    return;
+  }
+  const std::string error_message = std::string("Failed to evaluate custom series \"")
+    + app_curve_display_name(*curve) + "\":\n\n" + err_text;
+  if (curve->runtime_error_message != error_message) {
+    curve->runtime_error_message = error_message;
+    state->error_text = error_message;
+    state->open_error_popup = true;
+  }
+}
+
+void request_custom_curve_refresh(AppSession *session, UiState *state,
+                                  int tab_index, int pane_index, Curve *curve) {
   if (!curve->custom_python.has_value()) {
     return;
   }
@@ -227,26 +389,45 @@ void refresh_custom_curve_samples(AppSession *session, UiState *state, Curve *cu
     return;
   }
   try {
-    PythonEvalResult result = evaluate_custom_python_series(*session, *curve->custom_python);
-    curve->runtime_error_message.clear();
-    curve->xs = std::move(result.xs);
-    curve->ys = std::move(result.ys);
+    // the curve keeps its previous samples until the new result lands
+    CustomSeriesEvaluator::instance().enqueue(EvalRequest{
+      .kind = EvalTargetKind::Curve,
+      .tab_index = tab_index,
+      .pane_index = pane_index,
+      .curve_name = curve->name,
+      .inputs = snapshot_custom_python_inputs(*session, *curve->custom_python),
+    });
   } catch (const std::exception &err) {
-    curve->xs.clear();
-    curve->ys.clear();
-    const std::string err_text = err.what();
-    if (session->data_mode == SessionDataMode::Stream && util::starts_with(err_text, "Missing route series ")) {
-      curve->runtime_error_message = err_text;
-      return;
+    apply_curve_eval_error(session, state, curve, err.what());
+  }
+}
+
+Curve *find_custom_curve_for_outcome(AppSession *session, const EvalOutcome &outcome) {
+  const auto find_in_pane = [&](Pane &pane) -> Curve * {
+    for (Curve &curve : pane.curves) {
+      if (curve.custom_python.has_value() && curve.name == outcome.curve_name) {
+        return &curve;
+      }
     }
-    const std::string error_message = std::string("Failed to evaluate custom series \"")
-      + app_curve_display_name(*curve) + "\":\n\n" + err_text;
-    if (curve->runtime_error_message != error_message) {
-      curve->runtime_error_message = error_message;
-      state->error_text = error_message;
-      state->open_error_popup = true;
+    return nullptr;
+  };
+  if (outcome.tab_index >= 0 && outcome.tab_index < static_cast<int>(session->layout.tabs.size())) {
+    WorkspaceTab &tab = session->layout.tabs[static_cast<size_t>(outcome.tab_index)];
+    if (outcome.pane_index >= 0 && outcome.pane_index < static_cast<int>(tab.panes.size())) {
+      if (Curve *curve = find_in_pane(tab.panes[static_cast<size_t>(outcome.pane_index)])) {
+        return curve;
+      }
     }
   }
+  // the layout may have shifted while the evaluation ran; fall back to a name search
+  for (WorkspaceTab &tab : session->layout.tabs) {
+    for (Pane &pane : tab.panes) {
+      if (Curve *curve = find_in_pane(pane)) {
+        return curve;
+      }
+    }
+  }
+  return nullptr;
 }
 
 const std::array<CustomSeriesTemplate, 4> &custom_series_templates() {
@@ -451,12 +632,12 @@ bool preview_custom_series_editor(AppSession *session, UiState *state) {
   if (!prepare_custom_series_spec(&editor, state, false, &spec)) return false;
 
   try {
-    PythonEvalResult result = evaluate_custom_python_series(*session, spec);
-    editor.preview_label = editor.name.empty() ? "Result preview" : editor.name;
-    editor.preview_xs = std::move(result.xs);
-    editor.preview_ys = std::move(result.ys);
-    editor.preview_is_result = true;
-    state->status_text = "Previewed custom series";
+    CustomSeriesEvaluator::instance().enqueue(EvalRequest{
+      .kind = EvalTargetKind::Preview,
+      .curve_name = editor.name,
+      .inputs = snapshot_custom_python_inputs(*session, spec),
+    });
+    state->status_text = "Evaluating custom series...";
     return true;
   } catch (const std::exception &err) {
     state->error_text = err.what();
@@ -483,19 +664,14 @@ bool apply_custom_series_editor(AppSession *session, UiState *state) {
   if (!prepare_custom_series_spec(&editor, state, true, &spec)) return false;
 
   try {
-    PythonEvalResult result = evaluate_custom_python_series(*session, spec);
-    const SketchLayout before_layout = session->layout;
-    Pane &pane = tab->panes[static_cast<size_t>(tab_state->active_pane_index)];
-    editor.preview_label = editor.name;
-    editor.preview_xs = result.xs;
-    editor.preview_ys = result.ys;
-    editor.preview_is_result = true;
-    const bool inserted = upsert_custom_curve_in_pane(tab,
-                                                      tab_state->active_pane_index,
-                                                      make_custom_curve(pane, editor.name, spec, std::move(result)));
-    state->undo.push(before_layout);
-    state->status_text = inserted ? "Created custom series " + editor.name
-                                  : "Updated custom series " + editor.name;
+    CustomSeriesEvaluator::instance().enqueue(EvalRequest{
+      .kind = EvalTargetKind::Apply,
+      .tab_index = state->active_tab_index,
+      .pane_index = tab_state->active_pane_index,
+      .curve_name = editor.name,
+      .inputs = snapshot_custom_python_inputs(*session, spec),
+    });
+    state->status_text = "Evaluating custom series...";
     return true;
   } catch (const std::exception &err) {
     state->error_text = err.what();
@@ -532,10 +708,79 @@ std::string preferred_custom_series_source(const Pane &pane) {
 }
 
 void refresh_all_custom_curves(AppSession *session, UiState *state) {
-  for (WorkspaceTab &tab : session->layout.tabs) {
-    for (Pane &pane : tab.panes) {
-      for (Curve &curve : pane.curves) {
-        refresh_custom_curve_samples(session, state, &curve);
+  for (size_t tab_index = 0; tab_index < session->layout.tabs.size(); ++tab_index) {
+    WorkspaceTab &tab = session->layout.tabs[tab_index];
+    for (size_t pane_index = 0; pane_index < tab.panes.size(); ++pane_index) {
+      for (Curve &curve : tab.panes[pane_index].curves) {
+        request_custom_curve_refresh(session, state,
+                                     static_cast<int>(tab_index), static_cast<int>(pane_index), &curve);
+      }
+    }
+  }
+}
+
+void pump_custom_series_results(AppSession *session, UiState *state) {
+  for (EvalOutcome &outcome : CustomSeriesEvaluator::instance().drain()) {
+    switch (outcome.kind) {
+      case EvalTargetKind::Curve: {
+        Curve *curve = find_custom_curve_for_outcome(session, outcome);
+        if (curve == nullptr) {
+          break;  // curve was removed while the evaluation ran
+        }
+        if (!outcome.error.empty()) {
+          apply_curve_eval_error(session, state, curve, outcome.error);
+          break;
+        }
+        curve->runtime_error_message.clear();
+        curve->xs = std::move(outcome.result.xs);
+        curve->ys = std::move(outcome.result.ys);
+        break;
+      }
+      case EvalTargetKind::Preview: {
+        if (!outcome.error.empty()) {
+          state->error_text = outcome.error;
+          state->open_error_popup = true;
+          state->status_text = "Custom series preview failed";
+          break;
+        }
+        CustomSeriesEditorState &editor = state->custom_series;
+        editor.preview_label = outcome.curve_name.empty() ? "Result preview" : outcome.curve_name;
+        editor.preview_xs = std::move(outcome.result.xs);
+        editor.preview_ys = std::move(outcome.result.ys);
+        editor.preview_is_result = true;
+        state->status_text = "Previewed custom series";
+        break;
+      }
+      case EvalTargetKind::Apply: {
+        if (!outcome.error.empty()) {
+          state->error_text = outcome.error;
+          state->open_error_popup = true;
+          state->status_text = "Custom series failed";
+          break;
+        }
+        if (outcome.tab_index < 0 || outcome.tab_index >= static_cast<int>(session->layout.tabs.size())) {
+          state->status_text = "Custom series target pane is gone";
+          break;
+        }
+        WorkspaceTab *tab = &session->layout.tabs[static_cast<size_t>(outcome.tab_index)];
+        if (outcome.pane_index < 0 || outcome.pane_index >= static_cast<int>(tab->panes.size())) {
+          state->status_text = "Custom series target pane is gone";
+          break;
+        }
+        const SketchLayout before_layout = session->layout;
+        Pane &pane = tab->panes[static_cast<size_t>(outcome.pane_index)];
+        CustomSeriesEditorState &editor = state->custom_series;
+        editor.preview_label = outcome.curve_name;
+        editor.preview_xs = outcome.result.xs;
+        editor.preview_ys = outcome.result.ys;
+        editor.preview_is_result = true;
+        const bool inserted = upsert_custom_curve_in_pane(
+          tab, outcome.pane_index,
+          make_custom_curve(pane, outcome.curve_name, outcome.spec, std::move(outcome.result)));
+        state->undo.push(before_layout);
+        state->status_text = inserted ? "Created custom series " + outcome.curve_name
+                                      : "Updated custom series " + outcome.curve_name;
+        break;
       }
     }
   }
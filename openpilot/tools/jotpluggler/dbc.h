@@ -91,6 +91,37 @@ void updateMsbLsb(Signal *signal);
 double rawSignalValue(const Signal &signal, const uint8_t *data, size_t data_size);
 std::optional<double> signalValue(const Signal &signal, const Message &message, const uint8_t *data, size_t data_size);
 
+// Precomputed extraction plan for one signal: the byte span, shift and masks
+// are resolved once from msb/lsb so decoding a frame is a straight-line byte
+// gather instead of the per-bit walk in rawSignalValue. Build one per message
+// with makeMessagePlan() when decoding many frames of the same message.
+struct SignalPlan {
+  const Signal *signal = nullptr;
+  int first_byte = 0;      // lowest byte offset the signal touches
+  int num_bytes = 0;       // contiguous bytes covering the signal
+  int shift = 0;           // right shift after the gather
+  uint64_t mask = 0;       // keeps the low `size` bits
+  uint64_t sign_mask = 0;  // top bit of the field, zero for unsigned signals
+  bool is_little_endian = false;
+  double factor = 1.0;
+  double offset = 0.0;
+};
+
+struct MessagePlan {
+  const Message *message = nullptr;
+  std::vector<SignalPlan> plans;  // same order as message->signals
+  int multiplexor_plan = -1;      // index into plans, -1 when not multiplexed
+
+  // Decodes one frame; calls fn(signal_index, value) for every signal present
+  // (multiplexed signals whose selector doesn't match are skipped).
+  template <typename Fn>
+  void decode(const uint8_t *data, size_t data_size, Fn &&fn) const;
+};
+
+SignalPlan makeSignalPlan(const Signal &signal);
+MessagePlan makeMessagePlan(const Message &message);
+double applySignalPlan(const SignalPlan &plan, const uint8_t *data, size_t data_size);
+
 namespace {
 
 std::string unescape_dbc_string(std::string text) {
@@ -158,13 +189,74 @@ inline double rawSignalValue(const Signal &signal, const uint8_t *data, size_t d
     }
   }
 
-  if (signal.is_signed && (val & (1ULL << (signal.size - 1)))) {
+  // 64-bit fields are already sign-complete; shifting 1ULL by 64 is UB
+  if (signal.is_signed && signal.size < 64 && (val & (1ULL << (signal.size - 1)))) {
     val |= ~((1ULL << signal.size) - 1);
   }
 
   return static_cast<int64_t>(val) * signal.factor + signal.offset;
 }
 
+inline SignalPlan makeSignalPlan(const Signal &signal) {
+  const int lsb_byte = signal.lsb / 8;
+  const int msb_byte = signal.msb / 8;
+  SignalPlan plan;
+  plan.signal = &signal;
+  plan.first_byte = std::min(lsb_byte, msb_byte);
+  plan.num_bytes = std::abs(msb_byte - lsb_byte) + 1;
+  plan.shift = signal.lsb & 7;
+  plan.mask = signal.size >= 64 ? ~0ULL : (1ULL << signal.size) - 1;
+  plan.sign_mask = signal.is_signed ? 1ULL << (signal.size - 1) : 0;
+  plan.is_little_endian = signal.is_little_endian;
+  plan.factor = signal.factor;
+  plan.offset = signal.offset;
+  return plan;
+}
+
+inline double applySignalPlan(const SignalPlan &plan, const uint8_t *data, size_t data_size) {
+  // frames too short for the full span (and the rare >8-byte span) keep the
+  // exact semantics of the generic bit walk
+  if (plan.first_byte + plan.num_bytes > static_cast<int>(data_size) || plan.num_bytes > 8) {
+    return rawSignalValue(*plan.signal, data, data_size);
+  }
+  const uint8_t *src = data + plan.first_byte;
+  uint64_t val = 0;
+  if (plan.is_little_endian) {
+    for (int i = plan.num_bytes - 1; i >= 0; --i) val = (val << 8) | src[i];
+  } else {
+    for (int i = 0; i < plan.num_bytes; ++i) val = (val << 8) | src[i];
+  }
+  val = (val >> plan.shift) & plan.mask;
+  if (val & plan.sign_mask) {
+    val |= ~plan.mask;
+  }
+  return static_cast<int64_t>(val) * plan.factor + plan.offset;
+}
+
+inline MessagePlan makeMessagePlan(const Message &message) {
+  MessagePlan plan;
+  plan.message = &message;
+  plan.plans.reserve(message.signals.size());
+  for (const Signal &signal : message.signals) {
+    plan.plans.push_back(makeSignalPlan(signal));
+  }
+  plan.multiplexor_plan = message.multiplexor_index;
+  return plan;
+}
+
+template <typename Fn>
+void MessagePlan::decode(const uint8_t *data, size_t data_size, Fn &&fn) const {
+  int64_t mux_value = 0;
+  if (multiplexor_plan >= 0) {
+    mux_value = std::llround(applySignalPlan(plans[static_cast<size_t>(multiplexor_plan)], data, data_size));
+  }
+  for (size_t i = 0; i < plans.size(); ++i) {
+    const Signal &signal = *plans[i].signal;
+    if (signal.type == Signal::Type::Multiplexed && signal.multiplex_value != mux_value) continue;
+    fn(i, applySignalPlan(plans[i], data, data_size));
+  }
+}
+
 [[noreturn]] inline void parse_error(const std::string &filename, int line_number, const std::string &message, const std::string &line) {
   std::ostringstream out;
   out << "[" << filename << ":" << line_number << "] " << message << ": " << line;
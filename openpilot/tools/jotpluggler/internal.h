@@ -161,5 +161,6 @@ void draw_status_bar(const AppSession &session, const UiMetrics &ui, UiState *st
 void draw_sidebar_resizer(const UiMetrics &ui, UiState *state);
 
 void apply_stream_batch(AppSession *session, UiState *state, StreamExtractBatch batch);
+void materialize_lazy_can_series(AppSession *session, UiState *state);
 
 void render_frame(GLFWwindow *window, AppSession *session, UiState *state, const std::filesystem::path *capture_path);
@@ -1,7 +1,9 @@
 #include "tools/jotpluggler/app.h"
 
+#include <cctype>
 #include <cmath>
 #include <ctime>
+#include <unordered_map>
 
 namespace {
 
@@ -19,13 +21,96 @@ constexpr std::array<LevelOption, 5> LEVEL_OPTIONS = {{
 }};
 constexpr uint32_t ALL_LEVEL_MASK = (1u << LEVEL_OPTIONS.size()) - 1u;
 
-bool log_matches_search(const LogEntry &entry, std::string_view query) {
-  if (query.empty()) return true;
-  const std::string needle = lowercase_copy(query);
-  const auto contains = [&](std::string_view haystack) {
-    return lowercase_copy(haystack).find(needle) != std::string::npos;
+bool contains_icase(std::string_view haystack, std::string_view needle_lower) {
+  if (needle_lower.empty()) return true;
+  if (haystack.size() < needle_lower.size()) return false;
+  for (size_t i = 0; i + needle_lower.size() <= haystack.size(); ++i) {
+    size_t j = 0;
+    while (j < needle_lower.size() &&
+           std::tolower(static_cast<unsigned char>(haystack[i + j])) == static_cast<unsigned char>(needle_lower[j])) {
+      ++j;
+    }
+    if (j == needle_lower.size()) return true;
+  }
+  return false;
+}
+
+bool log_matches_search(const LogEntry &entry, std::string_view needle_lower) {
+  if (needle_lower.empty()) return true;
+  return contains_icase(entry.message, needle_lower) ||
+         contains_icase(entry.source, needle_lower) ||
+         contains_icase(entry.func, needle_lower);
+}
+
+// trigram posting lists over message/source/func so a search over a long
+// logMessage history does not rescan every row per frame; extended
+// incrementally as stream batches append entries
+struct LogSearchIndex {
+  const LogEntry *identity = nullptr;
+  size_t indexed = 0;
+  double last_indexed_time = 0.0;
+  std::unordered_map<uint32_t, std::vector<int>> trigrams;
+};
+
+uint32_t pack_trigram(std::string_view text, size_t pos) {
+  const auto low = [](char c) {
+    return static_cast<uint32_t>(std::tolower(static_cast<unsigned char>(c)));
   };
-  return contains(entry.message) || contains(entry.source) || contains(entry.func);
+  return (low(text[pos]) << 16) | (low(text[pos + 1]) << 8) | low(text[pos + 2]);
+}
+
+void add_log_trigrams(LogSearchIndex *index, std::string_view text, int entry_index) {
+  for (size_t pos = 0; pos + 3 <= text.size(); ++pos) {
+    std::vector<int> &postings = index->trigrams[pack_trigram(text, pos)];
+    if (postings.empty() || postings.back() != entry_index) {
+      postings.push_back(entry_index);
+    }
+  }
+}
+
+void extend_log_search_index(LogSearchIndex *index, const std::vector<LogEntry> &logs) {
+  // appends invalidate the index on realloc, and an overlapping stream batch
+  // can merge entries into the already-indexed prefix; both show up as either
+  // a moved base pointer or a changed entry at the watermark
+  const bool stale = logs.data() != index->identity ||
+                     logs.size() < index->indexed ||
+                     (index->indexed > 0 && logs[index->indexed - 1].mono_time != index->last_indexed_time);
+  if (stale) {
+    index->trigrams.clear();
+    index->indexed = 0;
+  }
+  for (size_t i = index->indexed; i < logs.size(); ++i) {
+    add_log_trigrams(index, logs[i].message, static_cast<int>(i));
+    add_log_trigrams(index, logs[i].source, static_cast<int>(i));
+    add_log_trigrams(index, logs[i].func, static_cast<int>(i));
+  }
+  index->identity = logs.data();
+  index->indexed = logs.size();
+  index->last_indexed_time = logs.empty() ? 0.0 : logs.back().mono_time;
+}
+
+// nullopt means the query is too short to prune and every row must be checked
+std::optional<std::vector<int>> trigram_candidates(const LogSearchIndex &index, std::string_view needle_lower) {
+  if (needle_lower.size() < 3) return std::nullopt;
+  std::vector<const std::vector<int> *> lists;
+  for (size_t pos = 0; pos + 3 <= needle_lower.size(); ++pos) {
+    auto it = index.trigrams.find(pack_trigram(needle_lower, pos));
+    if (it == index.trigrams.end()) return std::vector<int>{};
+    lists.push_back(&it->second);
+  }
+  std::sort(lists.begin(), lists.end(), [](const std::vector<int> *a, const std::vector<int> *b) {
+    return a->size() < b->size();
+  });
+  std::vector<int> result = *lists.front();
+  std::vector<int> merged;
+  for (size_t i = 1; i < lists.size() && !result.empty(); ++i) {
+    merged.clear();
+    std::set_intersection(result.begin(), result.end(),
+                          lists[i]->begin(), lists[i]->end(),
+                          std::back_inserter(merged));
+    result.swap(merged);
+  }
+  return result;
 }
 
 std::vector<std::string> collect_log_sources(const std::vector<LogEntry> &logs) {
@@ -40,10 +125,11 @@ std::vector<std::string> collect_log_sources(const std::vector<LogEntry> &logs)
   return sources;
 }
 
-std::vector<int> filter_log_indices(const RouteData &route_data, const LogsUiState &logs_state) {
-  std::vector<int> indices;
-  indices.reserve(route_data.logs.size());
-  for (size_t i = 0; i < route_data.logs.size(); ++i) {
+std::vector<int> filter_log_indices(const RouteData &route_data,
+                                    const LogsUiState &logs_state,
+                                    const LogSearchIndex &search_index) {
+  const std::string needle = lowercase_copy(logs_state.search);
+  const auto passes_filters = [&](size_t i) {
     const LogEntry &entry = route_data.logs[i];
     int level_index = 0;
     if (entry.level >= 50) {
@@ -56,16 +142,33 @@ std::vector<int> filter_log_indices(const RouteData &route_data, const LogsUiSta
       level_index = 1;
     }
     if ((logs_state.enabled_levels_mask & (1u << level_index)) == 0) {
-      continue;
+      return false;
     }
     if (!logs_state.all_sources) {
       const auto it = std::find(logs_state.selected_sources.begin(),
                                 logs_state.selected_sources.end(),
                                 entry.source);
-      if (it == logs_state.selected_sources.end()) continue;
+      if (it == logs_state.selected_sources.end()) return false;
+    }
+    return log_matches_search(entry, needle);
+  };
+
+  std::vector<int> indices;
+  const std::optional<std::vector<int>> candidates = trigram_candidates(search_index, needle);
+  if (candidates.has_value()) {
+    indices.reserve(candidates->size());
+    for (int candidate : *candidates) {
+      if (passes_filters(static_cast<size_t>(candidate))) {
+        indices.push_back(candidate);
+      }
+    }
+  } else {
+    indices.reserve(route_data.logs.size());
+    for (size_t i = 0; i < route_data.logs.size(); ++i) {
+      if (passes_filters(i)) {
+        indices.push_back(static_cast<int>(i));
+      }
     }
-    if (!log_matches_search(entry, logs_state.search)) continue;
-    indices.push_back(static_cast<int>(i));
   }
   return indices;
 }
@@ -352,7 +455,9 @@ void draw_logs_tab(AppSession *session, UiState *state) {
     ImGui::EndCombo();
   }
 
-  const std::vector<int> filtered_indices = filter_log_indices(route_data, logs_state);
+  static LogSearchIndex search_index;
+  extend_log_search_index(&search_index, route_data.logs);
+  const std::vector<int> filtered_indices = filter_log_indices(route_data, logs_state, search_index);
   const bool have_tracker = state->has_tracker_time && !filtered_indices.empty();
   const int active_pos = have_tracker ? find_active_log_position(route_data, filtered_indices, state->tracker_time) : -1;
 
@@ -365,6 +365,93 @@ ImU32 map_timeline_color(TimelineEntry::Type type, float alpha = 1.0f) {
   return timeline_entry_color(type, alpha, {140, 150, 165});
 }
 
+// Douglas-Peucker significance per trace point, computed once in zoom-0 world
+// units (doubles: half a pixel at zoom 18 is ~2e-6, below float resolution at
+// world scale). Level z of the pyramid keeps the points whose deviation covers
+// at least half a pixel at zoom z, so continent-scale views walk a handful of
+// indices instead of the full multi-hour trace.
+struct TraceLodPyramid {
+  const GpsPoint *identity = nullptr;
+  size_t point_count = 0;
+  std::vector<float> significance;
+  std::array<std::vector<int>, MAP_MAX_ZOOM + 1> levels;
+};
+
+void compute_trace_significance(const GpsTrace &trace, std::vector<float> *significance) {
+  const size_t n = trace.points.size();
+  significance->assign(n, std::numeric_limits<float>::infinity());
+  if (n < 3) {
+    return;
+  }
+  std::vector<double> xs(n);
+  std::vector<double> ys(n);
+  for (size_t i = 0; i < n; ++i) {
+    xs[i] = lon_to_world_x(trace.points[i].lon, 0.0);
+    ys[i] = lat_to_world_y(clamp_lat(trace.points[i].lat), 0.0);
+  }
+  std::fill(significance->begin() + 1, significance->end() - 1, 0.0f);
+
+  struct Span {
+    size_t first;
+    size_t last;
+    double cap;
+  };
+  std::vector<Span> stack;
+  stack.push_back(Span{0, n - 1, std::numeric_limits<double>::infinity()});
+  while (!stack.empty()) {
+    const Span span = stack.back();
+    stack.pop_back();
+    if (span.last <= span.first + 1) {
+      continue;
+    }
+    const double ax = xs[span.first];
+    const double ay = ys[span.first];
+    const double dx = xs[span.last] - ax;
+    const double dy = ys[span.last] - ay;
+    const double len = std::sqrt(dx * dx + dy * dy);
+    size_t best = span.first + 1;
+    double best_dev = -1.0;
+    for (size_t i = span.first + 1; i < span.last; ++i) {
+      const double ex = xs[i] - ax;
+      const double ey = ys[i] - ay;
+      const double dev = len > 1.0e-12 ? std::abs(dy * ex - dx * ey) / len : std::sqrt(ex * ex + ey * ey);
+      if (dev > best_dev) {
+        best_dev = dev;
+        best = i;
+      }
+    }
+    // capping keeps significance monotone down the recursion so a point never
+    // outranks the split point that introduced it
+    const double capped = std::min(best_dev, span.cap);
+    (*significance)[best] = static_cast<float>(capped);
+    stack.push_back(Span{span.first, best, capped});
+    stack.push_back(Span{best, span.last, capped});
+  }
+}
+
+const std::vector<int> &trace_lod_indices(TraceLodPyramid *pyramid, const GpsTrace &trace, double zoom) {
+  if (pyramid->identity != trace.points.data() || pyramid->point_count != trace.points.size()) {
+    pyramid->identity = trace.points.data();
+    pyramid->point_count = trace.points.size();
+    compute_trace_significance(trace, &pyramid->significance);
+    for (std::vector<int> &level : pyramid->levels) {
+      level.clear();
+    }
+  }
+  const int bucket = std::clamp(static_cast<int>(std::ceil(zoom)), MAP_MIN_ZOOM, MAP_MAX_ZOOM);
+  std::vector<int> &level = pyramid->levels[static_cast<size_t>(bucket)];
+  // endpoints have infinite significance, so a built level is never empty
+  if (level.empty() && !trace.points.empty()) {
+    const float threshold = static_cast<float>(0.5 / std::exp2(bucket));
+    for (size_t i = 0; i < pyramid->significance.size(); ++i) {
+      if (pyramid->significance[i] >= threshold) {
+        level.push_back(static_cast<int>(i));
+      }
+    }
+  }
+  return level;
+}
+
 ImVec2 gps_to_screen(double lat, double lon, double zoom, double top_left_x, double top_left_y, const ImVec2 &rect_min) {
   return ImVec2(rect_min.x + static_cast<float>(lon_to_world_x(lon, zoom) - top_left_x),
                 rect_min.y + static_cast<float>(lat_to_world_y(lat, zoom) - top_left_y));
@@ -1230,11 +1317,17 @@ void draw_map_pane(AppSession *session, UiState *state, Pane *, int pane_index)
     draw_edge_fade(draw_list, basemap->bounds, zoom, top_left_x, top_left_y, rect_min, rect_max);
   }
 
-  for (size_t i = 1; i < trace.points.size(); ++i) {
-    const GpsPoint &p0 = trace.points[i - 1];
-    const GpsPoint &p1 = trace.points[i];
+  static TraceLodPyramid trace_lod;
+  const std::vector<int> &lod_indices = trace_lod_indices(&trace_lod, trace, zoom);
+  for (size_t i = 1; i < lod_indices.size(); ++i) {
+    const GpsPoint &p0 = trace.points[static_cast<size_t>(lod_indices[i - 1])];
+    const GpsPoint &p1 = trace.points[static_cast<size_t>(lod_indices[i])];
     const ImVec2 s0 = gps_to_screen(p0.lat, p0.lon, zoom, top_left_x, top_left_y, rect_min);
     const ImVec2 s1 = gps_to_screen(p1.lat, p1.lon, zoom, top_left_x, top_left_y, rect_min);
+    if ((s0.x < rect_min.x && s1.x < rect_min.x) || (s0.x > rect_max.x && s1.x > rect_max.x) ||
+        (s0.y < rect_min.y && s1.y < rect_min.y) || (s0.y > rect_max.y && s1.y > rect_max.y)) {
+      continue;
+    }
     draw_list->AddLine(s0, s1, MAP_ROUTE_HALO, 5.8f);
     draw_list->AddLine(s0, s1, map_timeline_color(p1.type, 1.0f), 3.25f);
   }
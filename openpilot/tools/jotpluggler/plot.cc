@@ -5,7 +5,9 @@
 
 #include <cmath>
 #include <cstdio>
+#include <cstring>
 #include <limits>
+#include <unordered_map>
 
 struct PlotBounds {
   double x_min = 0.0;
@@ -64,6 +66,70 @@ struct PreparedCurve {
   std::vector<double> ys;
 };
 
+// Prepared curves cached per pane so undamaged panes redraw from the last
+// slice-and-decimate result instead of rebuilding it every frame. The key
+// covers everything that shapes the output; series data is fingerprinted by
+// identity, size and endpoint samples rather than a per-sample hash.
+struct PaneCurveCache {
+  bool valid = false;
+  uint64_t key = 0;
+  std::vector<PreparedCurve> curves;
+};
+
+std::unordered_map<const Pane *, PaneCurveCache> pane_curve_cache;
+
+uint64_t damage_mix(uint64_t h, uint64_t v) {
+  return (h ^ v) * 0x100000001b3ULL;
+}
+
+uint64_t damage_mix(uint64_t h, double v) {
+  uint64_t bits = 0;
+  memcpy(&bits, &v, sizeof(bits));
+  return damage_mix(h, bits);
+}
+
+uint64_t damage_mix(uint64_t h, const std::string &v) {
+  for (const char c : v) h = damage_mix(h, static_cast<uint64_t>(static_cast<uint8_t>(c)));
+  return damage_mix(h, v.size());
+}
+
+uint64_t pane_curve_damage_key(const AppSession &session, const Pane &pane, const UiState &state, int max_points) {
+  uint64_t h = 0xcbf29ce484222325ULL;
+  h = damage_mix(h, static_cast<uint64_t>(max_points));
+  h = damage_mix(h, static_cast<uint64_t>(state.has_shared_range));
+  h = damage_mix(h, state.x_view_min);
+  h = damage_mix(h, state.x_view_max);
+  h = damage_mix(h, static_cast<uint64_t>(state.has_tracker_time));
+  h = damage_mix(h, state.has_tracker_time ? state.tracker_time : 0.0);
+  for (const Curve &curve : pane.curves) {
+    h = damage_mix(h, curve.name);
+    h = damage_mix(h, curve.label);
+    h = damage_mix(h, static_cast<uint64_t>(curve.visible));
+    h = damage_mix(h, static_cast<uint64_t>(curve.derivative));
+    h = damage_mix(h, curve.derivative_dt);
+    h = damage_mix(h, curve.value_scale);
+    h = damage_mix(h, curve.value_offset);
+    h = damage_mix(h, static_cast<uint64_t>(curve.color[0]) << 16 | static_cast<uint64_t>(curve.color[1]) << 8 | curve.color[2]);
+    if (curve_has_local_samples(curve)) {
+      h = damage_mix(h, curve.xs.size());
+      if (!curve.xs.empty()) {
+        h = damage_mix(h, curve.xs.back());
+        h = damage_mix(h, curve.ys.back());
+      }
+    } else if (const RouteSeries *series = app_find_route_series(session, curve.name)) {
+      // a re-decode swaps the series object; a stream append grows it
+      h = damage_mix(h, reinterpret_cast<uintptr_t>(series));
+      h = damage_mix(h, series->times.size());
+      if (!series->times.empty()) {
+        h = damage_mix(h, series->times.back());
+        h = damage_mix(h, series->values.front());
+        h = damage_mix(h, series->values.back());
+      }
+    }
+  }
+  return h;
+}
+
 struct StateBlock {
   double t0 = 0.0;
   double t1 = 0.0;
@@ -242,6 +308,70 @@ void app_decimate_samples(std::vector<double> &&xs_in,
   app_decimate_samples_impl(xs_in, ys_in, max_points, xs_out, ys_out);
 }
 
+// every tile keeps the first/min/max/last samples of its bucket, so stair
+// edges stay put and spikes survive no matter how far the view is zoomed out
+constexpr size_t LOD_BASE_BUCKET = 64;
+constexpr size_t LOD_LEVEL_STEP = 4;
+constexpr size_t LOD_MIN_BUCKETS = 256;
+
+void app_extend_series_lod(RouteSeries *series) {
+  const size_t sample_count = series->times.size();
+  if (sample_count != series->values.size()) {
+    return;
+  }
+  size_t bucket_size = LOD_BASE_BUCKET;
+  for (size_t level = 0; sample_count / bucket_size >= LOD_MIN_BUCKETS; ++level, bucket_size *= LOD_LEVEL_STEP) {
+    if (level == series->lod_levels.size()) {
+      series->lod_levels.push_back(RouteSeriesLod{.bucket_size = bucket_size});
+    }
+    RouteSeriesLod &lod = series->lod_levels[level];
+    while (lod.folded + lod.bucket_size <= sample_count) {
+      const size_t start = lod.folded;
+      const size_t end = start + lod.bucket_size;
+      size_t min_index = start;
+      size_t max_index = start;
+      for (size_t index = start + 1; index < end; ++index) {
+        if (series->values[index] < series->values[min_index]) {
+          min_index = index;
+        }
+        if (series->values[index] > series->values[max_index]) {
+          max_index = index;
+        }
+      }
+      std::array<size_t, 4> indices = {start, min_index, max_index, end - 1};
+      std::sort(indices.begin(), indices.end());
+      size_t last_index = std::numeric_limits<size_t>::max();
+      for (size_t index : indices) {
+        if (index == last_index) {
+          continue;
+        }
+        lod.times.push_back(series->times[index]);
+        lod.values.push_back(series->values[index]);
+        last_index = index;
+      }
+      lod.folded = end;
+    }
+  }
+}
+
+const RouteSeriesLod *app_select_series_lod(const RouteSeries &series,
+                                            size_t visible_samples,
+                                            int max_points) {
+  if (max_points <= 0 || visible_samples <= static_cast<size_t>(max_points) * 2) {
+    return nullptr;
+  }
+  const RouteSeriesLod *coarsest = nullptr;
+  for (const RouteSeriesLod &lod : series.lod_levels) {
+    if (lod.folded == 0) break;
+    coarsest = &lod;
+    // up to 4 tile points survive per bucket; take the finest level that fits
+    if (visible_samples / lod.bucket_size * 4 <= static_cast<size_t>(max_points) * 2) {
+      return &lod;
+    }
+  }
+  return coarsest;
+}
+
 std::optional<double> app_sample_xy_value_at_time(const std::vector<double> &xs,
                                               const std::vector<double> &ys,
                                               bool stairs,
@@ -343,8 +473,28 @@ bool build_curve_series(const AppSession &session,
       end_index = std::min(end_index, series->times.size());
     }
     if (end_index <= begin_index + 1) return false;
-    xs.assign(series->times.begin() + begin_index, series->times.begin() + end_index);
-    ys.assign(series->values.begin() + begin_index, series->values.begin() + end_index);
+    // derivative curves need adjacent raw samples; everything else can read
+    // from the tile level sized to the pixel budget
+    const RouteSeriesLod *lod = curve.derivative
+      ? nullptr
+      : app_select_series_lod(*series, end_index - begin_index, max_points);
+    if (lod != nullptr) {
+      const auto tile_begin = std::lower_bound(lod->times.begin(), lod->times.end(), series->times[begin_index]);
+      const auto tile_end = std::upper_bound(lod->times.begin(), lod->times.end(), series->times[end_index - 1]);
+      const size_t value_offset = static_cast<size_t>(std::distance(lod->times.begin(), tile_begin));
+      xs.assign(tile_begin, tile_end);
+      ys.assign(lod->values.begin() + value_offset, lod->values.begin() + value_offset + xs.size());
+      // whatever the fold has not reached yet comes from the raw samples, so
+      // the live edge of a stream is never clipped
+      for (size_t index = std::max(begin_index, lod->folded); index < end_index; ++index) {
+        xs.push_back(series->times[index]);
+        ys.push_back(series->values[index]);
+      }
+    }
+    if (xs.size() < 2) {
+      xs.assign(series->times.begin() + begin_index, series->times.begin() + end_index);
+      ys.assign(series->values.begin() + begin_index, series->values.begin() + end_index);
+    }
   }
 
   std::vector<double> transformed_xs;
@@ -748,18 +898,29 @@ bool apply_axis_limits_editor(AppSession *session, UiState *state) {
 }
 
 void draw_plot(const AppSession &session, Pane *pane, UiState *state) {
-  std::vector<PreparedCurve> prepared_curves;
-  prepared_curves.reserve(pane->curves.size());
   const int max_points = std::max(256, static_cast<int>(ImGui::GetContentRegionAvail().x) * 2);
-  for (size_t curve_index = 0; curve_index < pane->curves.size(); ++curve_index) {
-    const Curve &curve = pane->curves[curve_index];
-    if (!curve.visible || !curve_has_samples(session, curve)) continue;
-    PreparedCurve prepared;
-    if (build_curve_series(session, curve, *state, max_points, &prepared)) {
-      prepared.pane_curve_index = static_cast<int>(curve_index);
-      prepared_curves.push_back(std::move(prepared));
+
+  // undamaged panes redraw from the cached prepared curves; only panes whose
+  // view, data or curve config moved pay for slicing and decimation again
+  const uint64_t damage_key = pane_curve_damage_key(session, *pane, *state, max_points);
+  if (pane_curve_cache.size() > 256) pane_curve_cache.clear();
+  PaneCurveCache &cache = pane_curve_cache[pane];
+  if (!cache.valid || cache.key != damage_key) {
+    cache.curves.clear();
+    cache.curves.reserve(pane->curves.size());
+    for (size_t curve_index = 0; curve_index < pane->curves.size(); ++curve_index) {
+      const Curve &curve = pane->curves[curve_index];
+      if (!curve.visible || !curve_has_samples(session, curve)) continue;
+      PreparedCurve prepared;
+      if (build_curve_series(session, curve, *state, max_points, &prepared)) {
+        prepared.pane_curve_index = static_cast<int>(curve_index);
+        cache.curves.push_back(std::move(prepared));
+      }
     }
+    cache.key = damage_key;
+    cache.valid = true;
   }
+  const std::vector<PreparedCurve> &prepared_curves = cache.curves;
 
   const PlotBounds bounds = compute_plot_bounds(*pane, prepared_curves, *state);
   PaneValueFormatContext pane_value_format;
@@ -8,6 +8,30 @@
 
 namespace fs = std::filesystem;
 
+// After this many undamaged frames the render loop stops free-running at
+// vsync and sleeps between frames; long enough for hover fades to settle.
+constexpr int IDLE_GRACE_FRAMES = 30;
+
+// A frame is damaged when anything that can change pixels is active: user
+// input, playback, a live stream, or async loads still in flight.
+static bool frame_has_damage(const AppSession &session, const UiState &state) {
+  const ImGuiIO &io = ImGui::GetIO();
+  if (io.MouseDelta.x != 0.0f || io.MouseDelta.y != 0.0f || io.MouseWheel != 0.0f || io.MouseWheelH != 0.0f) {
+    return true;
+  }
+  for (const bool down : io.MouseDown) {
+    if (down) return true;
+  }
+  for (int key = ImGuiKey_NamedKey_BEGIN; key < ImGuiKey_NamedKey_END; ++key) {
+    if (ImGui::IsKeyDown(static_cast<ImGuiKey>(key))) return true;
+  }
+  if (io.WantTextInput) return true;  // keep the caret blinking
+  if (state.playback_playing || state.follow_latest) return true;
+  if (session.data_mode == SessionDataMode::Stream) return true;
+  if (session.async_route_loading) return true;
+  return false;
+}
+
 void draw_fps_overlay(const UiState &state, float top_offset) {
   if (!state.show_fps_overlay) {
     return;
@@ -116,7 +140,15 @@ void save_framebuffer_png(const fs::path &output_path, int width, int height) {
 }
 
 void render_frame(GLFWwindow *window, AppSession *session, UiState *state, const fs::path *capture_path) {
-  glfwPollEvents();
+  // damage-tracked idle throttle: once the UI has settled, sleep between
+  // frames instead of free-running at vsync. input events wake the loop
+  // immediately; the timeout keeps background work polled a few times a
+  // second, so idle CPU/GPU use drops to near zero with a layout open.
+  if (state->idle_frames > IDLE_GRACE_FRAMES && capture_path == nullptr) {
+    glfwWaitEventsTimeout(0.25);
+  } else {
+    glfwPollEvents();
+  }
 
   int framebuffer_width = 0;
   int framebuffer_height = 0;
@@ -126,6 +158,12 @@ void render_frame(GLFWwindow *window, AppSession *session, UiState *state, const
   ImGui_ImplGlfw_NewFrame();
   ImGui::NewFrame();
 
+  if (frame_has_damage(*session, *state) || capture_path != nullptr) {
+    state->idle_frames = 0;
+  } else {
+    ++state->idle_frames;
+  }
+
   if (state->request_save_layout) {
     if (session->layout_path.empty()) {
       state->open_save_layout = true;
@@ -153,6 +191,9 @@ void render_frame(GLFWwindow *window, AppSession *session, UiState *state, const
     }
   }
 
+  materialize_lazy_can_series(session, state);
+  pump_custom_series_results(session, state);
+
   const bool show_camera = capture_path == nullptr && session->data_mode != SessionDataMode::Stream;
   render_layout(session, state, show_camera);
   ImGui::Render();
@@ -79,6 +79,23 @@ bool should_subscribe_stream_service(const std::string &name) {
   return true;
 }
 
+// snapshot-type services can be thinned when the poller falls behind: every
+// message carries the full state, so dropping intermediates only coarsens
+// the plotted history. anything cumulative (CAN frames, log text) has to be
+// kept sample-for-sample.
+bool stream_service_conflatable(const std::string &name) {
+  static const std::array<std::string_view, 4> kCumulativeServices = {{
+    "can",
+    "sendcan",
+    "logMessage",
+    "errorLogMessage",
+  }};
+  for (std::string_view cumulative : kCumulativeServices) {
+    if (name == cumulative) return false;
+  }
+  return true;
+}
+
 void glfw_error_callback(int error, const char *description) {
   const std::string_view desc = description != nullptr ? description : "unknown";
   if (error == 65539 && desc.find("Invalid window attribute 0x0002000D") != std::string_view::npos) {
@@ -269,6 +286,7 @@ struct AsyncRouteLoader::Impl {
       dbc_name = dbc_name_value;
       result.reset();
       error_text.clear();
+      partial_timeline.clear();
     }
     active.store(!route_name_value.empty());
     completed.store(route_name_value.empty());
@@ -286,6 +304,9 @@ struct AsyncRouteLoader::Impl {
           total_segments.store(progress.total_segments > 0 ? progress.total_segments : progress.segment_count);
           segments_downloaded.store(progress.segments_downloaded);
           segments_parsed.store(progress.segments_parsed);
+          if (!progress.timeline_entries.empty()) {
+            append_partial_timeline(progress.timeline_entries);
+          }
           terminal_progress.update(progress);
         });
         {
@@ -306,12 +327,39 @@ struct AsyncRouteLoader::Impl {
     });
   }
 
+  // segments finish out of order, so each batch is merged into the sorted
+  // partial timeline as it lands; the snapshot copy below is then trivial
+  void append_partial_timeline(const std::vector<TimelineEntry> &entries) {
+    std::lock_guard<std::mutex> lock(mutex);
+    partial_timeline.insert(partial_timeline.end(), entries.begin(), entries.end());
+    std::sort(partial_timeline.begin(), partial_timeline.end(), [](const TimelineEntry &a, const TimelineEntry &b) {
+      return a.start_time < b.start_time;
+    });
+    std::vector<TimelineEntry> merged;
+    merged.reserve(partial_timeline.size());
+    for (TimelineEntry &entry : partial_timeline) {
+      if (!merged.empty() && merged.back().type == entry.type) {
+        merged.back().end_time = std::max(merged.back().end_time, entry.end_time);
+        continue;
+      }
+      merged.push_back(entry);
+    }
+    partial_timeline = std::move(merged);
+  }
+
   RouteLoadSnapshot snapshot() const {
     RouteLoadSnapshot snapshot;
     snapshot.active = active.load();
     snapshot.total_segments = total_segments.load();
     snapshot.segments_downloaded = segments_downloaded.load();
     snapshot.segments_parsed = segments_parsed.load();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!partial_timeline.empty()) {
+      snapshot.has_partial_timeline = true;
+      snapshot.partial_x_min = partial_timeline.front().start_time;
+      snapshot.partial_x_max = partial_timeline.back().end_time;
+      snapshot.partial_timeline = partial_timeline;
+    }
     return snapshot;
   }
 
@@ -343,6 +391,7 @@ struct AsyncRouteLoader::Impl {
   mutable std::mutex mutex;
   std::thread worker;
   std::unique_ptr<RouteData> result;
+  std::vector<TimelineEntry> partial_timeline;
   std::string route_name;
   std::string data_dir;
   std::string dbc_name;
@@ -385,9 +434,7 @@ struct StreamPoller::Impl {
     stop();
     {
       std::lock_guard<std::mutex> lock(mutex);
-      pending = {};
-      pending_series_slots.clear();
-      pending_can_slots.clear();
+      ready_batches.clear();
       error_text.clear();
       source = requested_source;
       if (source.kind == StreamSourceKind::CerealLocal) {
@@ -425,9 +472,7 @@ struct StreamPoller::Impl {
     paused.store(paused_value);
     if (paused_value) {
       std::lock_guard<std::mutex> lock(mutex);
-      pending = {};
-      pending_series_slots.clear();
-      pending_can_slots.clear();
+      ready_batches.clear();
       error_text.clear();
     }
   }
@@ -467,19 +512,30 @@ struct StreamPoller::Impl {
   }
 
   bool consume(StreamExtractBatch *batch, std::string *out_error_text) {
-    std::lock_guard<std::mutex> lock(mutex);
-    const bool has_error = !error_text.empty();
-    const bool has_batch = stream_batch_has_data(pending);
-    if (!has_error && !has_batch) return false;
-    if (batch != nullptr) {
-      *batch = std::move(pending);
-      pending = {};
-      pending_series_slots.clear();
-      pending_can_slots.clear();
+    std::vector<StreamExtractBatch> batches;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      const bool has_error = !error_text.empty();
+      if (!has_error && ready_batches.empty()) return false;
+      if (batch != nullptr) {
+        batches = std::move(ready_batches);
+        ready_batches.clear();
+      }
+      if (out_error_text != nullptr) {
+        *out_error_text = std::move(error_text);
+        error_text.clear();
+      }
     }
-    if (out_error_text != nullptr) {
-      *out_error_text = error_text;
-      error_text.clear();
+    if (batch != nullptr && !batches.empty()) {
+      // fold the queued batches together on the consumer's own time,
+      // after the lock is released
+      StreamExtractBatch merged;
+      std::unordered_map<std::string, size_t> series_slots;
+      std::unordered_map<CanMessageId, size_t, CanMessageIdHash> can_slots;
+      for (StreamExtractBatch &b : batches) {
+        merge_batch(&merged, &series_slots, &can_slots, &b);
+      }
+      *batch = std::move(merged);
     }
     return true;
   }
@@ -547,15 +603,30 @@ struct StreamPoller::Impl {
     }
   }
 
+  // Batches are handed over through a queue so the critical section on the
+  // poller side is an O(1) move; the per-path merge bookkeeping happens on
+  // whichever side owns the data outside the lock, and rendering never waits
+  // behind an in-progress merge.
+  static constexpr size_t kMaxReadyBatches = 32;
+
   void publish_batch(StreamAccumulator *accumulator) {
     StreamExtractBatch batch = accumulator->takeBatch();
     if (!stream_batch_has_data(batch)) {
       return;
     }
     std::lock_guard<std::mutex> lock(mutex);
-    merge_batch(&pending, &pending_series_slots, &pending_can_slots, &batch);
-    latest_dbc_name = pending.dbc_name;
-    latest_car_fingerprint = pending.car_fingerprint;
+    if (!batch.dbc_name.empty()) latest_dbc_name = batch.dbc_name;
+    if (!batch.car_fingerprint.empty()) latest_car_fingerprint = batch.car_fingerprint;
+    if (ready_batches.size() >= kMaxReadyBatches) {
+      // consumer has stalled; fold into the newest queued batch instead of
+      // growing the queue without bound. apply_stream_batch tolerates the
+      // duplicate paths plain concatenation produces.
+      std::unordered_map<std::string, size_t> series_slots;
+      std::unordered_map<CanMessageId, size_t, CanMessageIdHash> can_slots;
+      merge_batch(&ready_batches.back(), &series_slots, &can_slots, &batch);
+    } else {
+      ready_batches.push_back(std::move(batch));
+    }
   }
 
   void run_cereal_source(StreamAccumulator *accumulator) {
@@ -568,6 +639,7 @@ struct StreamPoller::Impl {
     std::unique_ptr<Context> context(Context::create());
     std::unique_ptr<Poller> poller(Poller::create());
     std::vector<std::unique_ptr<SubSocket>> sockets;
+    std::unordered_map<SubSocket *, bool> conflatable;
     sockets.reserve(services.size());
     for (const auto &[name, info] : services) {
       if (!should_subscribe_stream_service(name)) continue;
@@ -576,29 +648,51 @@ struct StreamPoller::Impl {
       if (socket == nullptr) continue;
       socket->setTimeout(0);
       poller->registerSocket(socket.get());
+      conflatable.emplace(socket.get(), stream_service_conflatable(name));
       sockets.push_back(std::move(socket));
     }
     if (sockets.empty()) throw std::runtime_error("Failed to connect to any cereal service");
     connected.store(true);
 
+    std::vector<std::unique_ptr<Message>> pending;
     while (running.load()) {
       std::vector<SubSocket *> ready = poller->poll(1);
       for (SubSocket *socket : ready) {
+        // drain the whole backlog before parsing anything, so the queue
+        // depth is known up front instead of discovered one recv at a time
+        pending.clear();
         while (running.load()) {
           std::unique_ptr<Message> msg(socket->receive(true));
           if (!msg) break;
-          const size_t size = msg->getSize();
-          if (size < sizeof(capnp::word) || (size % sizeof(capnp::word)) != 0) {
+          pending.push_back(std::move(msg));
+        }
+        received_messages.fetch_add(pending.size());
+        if (pending.empty() || paused.load()) continue;
+
+        // conflation tiers: the deeper the backlog on a snapshot-type
+        // service, the more intermediate states get skipped. the newest
+        // message always survives so the current value stays fresh
+        size_t stride = 1;
+        if (conflatable.at(socket)) {
+          if (pending.size() >= 256) {
+            stride = 8;
+          } else if (pending.size() >= 64) {
+            stride = 4;
+          } else if (pending.size() >= 16) {
+            stride = 2;
+          }
+        }
+        for (size_t i = 0; i < pending.size(); ++i) {
+          if (stride > 1 && i % stride != 0 && i + 1 != pending.size()) {
             continue;
           }
-          if (paused.load()) {
-            received_messages.fetch_add(1);
+          const size_t size = pending[i]->getSize();
+          if (size < sizeof(capnp::word) || (size % sizeof(capnp::word)) != 0) {
             continue;
           }
-          kj::ArrayPtr<const capnp::word> data(reinterpret_cast<const capnp::word *>(msg->getData()),
+          kj::ArrayPtr<const capnp::word> data(reinterpret_cast<const capnp::word *>(pending[i]->getData()),
                                                size / sizeof(capnp::word));
           accumulator->appendEvent(data);
-          received_messages.fetch_add(1);
         }
       }
       publish_batch(accumulator);
@@ -611,9 +705,7 @@ struct StreamPoller::Impl {
   std::atomic<bool> connected{false};
   std::atomic<bool> paused{false};
   std::atomic<uint64_t> received_messages{0};
-  StreamExtractBatch pending;
-  std::unordered_map<std::string, size_t> pending_series_slots;
-  std::unordered_map<CanMessageId, size_t, CanMessageIdHash> pending_can_slots;
+  std::vector<StreamExtractBatch> ready_batches;
   std::string error_text;
   StreamSourceConfig source;
   std::string latest_dbc_name;
@@ -649,11 +741,151 @@ bool StreamPoller::consume(StreamExtractBatch *batch, std::string *error_text) {
   return impl_->consume(batch, error_text);
 }
 
+struct CameraRequestKey {
+  int segment = -1;
+  int decode_index = -1;
+};
+
+struct CameraDecodeResult {
+  CameraRequestKey key;
+  std::string path;
+  bool success = false;
+  int width = 0;
+  int height = 0;
+  double decode_ms = 0.0;
+  std::vector<uint8_t> rgba;
+};
+
+// one per process: FrameReaders and decoded frames are keyed by file path and
+// shared across every CameraFeedView, so panes scrubbing in sync never load a
+// segment twice and total decode memory stays bounded for the whole route
+struct CameraDecodeService {
+  static constexpr size_t kMaxReaders = 8;
+  static constexpr size_t kMaxFrames = 24;
+
+  static CameraDecodeService &instance() {
+    static CameraDecodeService service;
+    return service;
+  }
+
+  std::shared_ptr<FrameReader> find_reader(const std::string &path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return find_reader_locked(path);
+  }
+
+  std::shared_ptr<FrameReader> get_reader(CameraType type,
+                                          const std::string &path,
+                                          std::atomic<bool> *abort_flag,
+                                          bool wait_for_inflight,
+                                          const std::atomic<bool> &stop) {
+    while (!stop.load()) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (std::shared_ptr<FrameReader> cached = find_reader_locked(path)) {
+          return cached;
+        }
+        if (loading_paths.find(path) != loading_paths.end()) {
+          if (!wait_for_inflight) {
+            return nullptr;
+          }
+          cv.wait(lock, [&]() {
+            return stop.load() || loading_paths.find(path) == loading_paths.end();
+          });
+          continue;
+        }
+        loading_paths.insert(path);
+      }
+
+      auto reader = std::make_shared<FrameReader>();
+      const auto load_begin = std::chrono::steady_clock::now();
+      const bool loaded = reader->load(type, path, false, abort_flag, true);
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        loading_paths.erase(path);
+        if (loaded) {
+          readers.emplace_front(path, reader);
+          while (readers.size() > kMaxReaders) {
+            readers.pop_back();
+          }
+        }
+      }
+      cv.notify_all();
+
+      if (!loaded) {
+        return nullptr;
+      }
+      if (kLogCameraTimings) {
+        const double load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_begin).count();
+        std::fprintf(stderr, "camera load %.1fms (%s)\n", load_ms, path.c_str());
+      }
+      return reader;
+    }
+    return nullptr;
+  }
+
+  std::optional<CameraDecodeResult> find_frame(const std::string &path, int decode_index) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const CameraDecodeResult &frame : frames) {
+      if (frame.path == path && frame.key.decode_index == decode_index) {
+        return frame;
+      }
+    }
+    return std::nullopt;
+  }
+
+  std::optional<CameraDecodeResult> find_nearby_frame(const std::string &path, int decode_index, int max_distance) {
+    std::optional<CameraDecodeResult> result;
+    int best_distance = std::numeric_limits<int>::max();
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const CameraDecodeResult &frame : frames) {
+      if (frame.path != path) continue;
+      const int distance = std::abs(frame.key.decode_index - decode_index);
+      if (distance == 0 || distance > max_distance || distance >= best_distance) continue;
+      best_distance = distance;
+      result = frame;
+    }
+    return result;
+  }
+
+  void remember_frame(const CameraDecodeResult &result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = std::find_if(frames.begin(), frames.end(), [&](const CameraDecodeResult &frame) {
+      return frame.path == result.path && frame.key.decode_index == result.key.decode_index;
+    });
+    if (it != frames.end()) {
+      frames.erase(it);
+    }
+    frames.push_front(result);
+    while (frames.size() > kMaxFrames) {
+      frames.pop_back();
+    }
+  }
+
+private:
+  std::shared_ptr<FrameReader> find_reader_locked(const std::string &path) {
+    auto it = std::find_if(readers.begin(), readers.end(), [&](const auto &entry) {
+      return entry.first == path;
+    });
+    if (it == readers.end()) {
+      return nullptr;
+    }
+    std::shared_ptr<FrameReader> reader = it->second;
+    readers.erase(it);
+    readers.emplace_front(path, reader);
+    return reader;
+  }
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<std::pair<std::string, std::shared_ptr<FrameReader>>> readers;  // front = most recently used
+  std::unordered_set<std::string> loading_paths;
+  std::deque<CameraDecodeResult> frames;  // front = most recently used
+};
+
 struct CameraFeedView::Impl {
-  struct RequestKey {
-    int segment = -1;
-    int decode_index = -1;
-  };
+  using RequestKey = CameraRequestKey;
+  using DecodeResult = CameraDecodeResult;
 
   struct DecodeRequest {
     RequestKey key;
@@ -665,23 +897,15 @@ struct CameraFeedView::Impl {
   struct PreloadTask {
     int segment = -1;
     std::string path;
-    uint64_t generation = 0;
-  };
-
-  struct DecodeResult {
-    RequestKey key;
-    bool success = false;
-    int width = 0;
-    int height = 0;
-    double decode_ms = 0.0;
-    std::vector<uint8_t> rgba;
   };
 
   static constexpr float kDefaultAspect = 1208.0f / 1928.0f;
-  static constexpr size_t kCachedFrames = 8;
   static constexpr int kPrefetchAhead = 2;
   static constexpr int kImmediateNearbyFrameDistance = 8;
   static constexpr int kPreloadWorkerCount = 2;
+  // with readers shared and LRU-bounded, warming more than the neighbouring
+  // segments would just evict what other feeds are using
+  static constexpr size_t kPreloadNearbySegments = 2;
 
   Impl() {
     demand_worker = std::thread([this]() { demand_worker_loop(); });
@@ -716,7 +940,6 @@ struct CameraFeedView::Impl {
       camera_view = view;
       pending_request.reset();
       pending_result.reset();
-      cached_results.clear();
       preload_queue.clear();
       preload_focus_segment = -1;
       ++route_generation;
@@ -756,10 +979,10 @@ struct CameraFeedView::Impl {
         same_request(failed_request, request->key)) {
       return;
     }
-    if (try_upload_cached_result(request->key)) {
+    if (try_upload_cached_result(*request)) {
       return;
     }
-    try_upload_nearby_cached_result(request->key);
+    try_upload_nearby_cached_result(*request);
 
     bool focus_changed = false;
     {
@@ -900,7 +1123,7 @@ struct CameraFeedView::Impl {
   }
 
   void upload_result(const DecodeResult &result) {
-    remember_cached_result(result);
+    CameraDecodeService::instance().remember_frame(result);
 
     const bool new_size = texture_width != result.width || texture_height != result.height;
     if (texture == 0) {
@@ -927,36 +1150,19 @@ struct CameraFeedView::Impl {
     failed_request.reset();
   }
 
-  bool try_upload_cached_result(const RequestKey &key) {
-    std::optional<DecodeResult> result;
-    {
-      std::lock_guard<std::mutex> lock(mutex);
-      auto it = std::find_if(cached_results.begin(), cached_results.end(), [&](const DecodeResult &cached) {
-        return cached.key.segment == key.segment && cached.key.decode_index == key.decode_index;
-      });
-      if (it == cached_results.end()) {
-        return false;
-      }
-      result = *it;
+  bool try_upload_cached_result(const DecodeRequest &request) {
+    std::optional<DecodeResult> result = CameraDecodeService::instance().find_frame(request.path, request.key.decode_index);
+    if (!result.has_value()) {
+      return false;
     }
     active_request.reset();
     upload_result(*result);
     return true;
   }
 
-  bool try_upload_nearby_cached_result(const RequestKey &key) {
-    std::optional<DecodeResult> result;
-    int best_distance = std::numeric_limits<int>::max();
-    {
-      std::lock_guard<std::mutex> lock(mutex);
-      for (const DecodeResult &cached : cached_results) {
-        if (cached.key.segment != key.segment) continue;
-        const int distance = std::abs(cached.key.decode_index - key.decode_index);
-        if (distance == 0 || distance > kImmediateNearbyFrameDistance || distance >= best_distance) continue;
-        best_distance = distance;
-        result = cached;
-      }
-    }
+  bool try_upload_nearby_cached_result(const DecodeRequest &request) {
+    std::optional<DecodeResult> result =
+        CameraDecodeService::instance().find_nearby_frame(request.path, request.key.decode_index, kImmediateNearbyFrameDistance);
     if (!result.has_value()) {
       return false;
     }
@@ -964,20 +1170,6 @@ struct CameraFeedView::Impl {
     return true;
   }
 
-  void remember_cached_result(const DecodeResult &result) {
-    std::lock_guard<std::mutex> lock(mutex);
-    auto it = std::find_if(cached_results.begin(), cached_results.end(), [&](const DecodeResult &cached) {
-      return cached.key.segment == result.key.segment && cached.key.decode_index == result.key.decode_index;
-    });
-    if (it != cached_results.end()) {
-      cached_results.erase(it);
-    }
-    cached_results.push_front(result);
-    while (cached_results.size() > kCachedFrames) {
-      cached_results.pop_back();
-    }
-  }
-
   void destroy_texture() {
     if (texture != 0 && g_glfw_alive.load() && glfwGetCurrentContext() != nullptr) {
       glDeleteTextures(1, &texture);
@@ -1022,10 +1214,10 @@ struct CameraFeedView::Impl {
     for (const CameraSegmentFile &segment_file : route_index.segment_files) {
       if (segment_file.path.empty()) continue;
       if (segment_file.segment == focus_segment) continue;
+      if (static_cast<size_t>(std::abs(segment_file.segment - focus_segment)) > kPreloadNearbySegments) continue;
       ordered.push_back(PreloadTask{
         .segment = segment_file.segment,
         .path = segment_file.path,
-        .generation = route_generation,
       });
     }
     std::sort(ordered.begin(), ordered.end(), [&](const PreloadTask &a, const PreloadTask &b) {
@@ -1038,71 +1230,11 @@ struct CameraFeedView::Impl {
     preload_focus_segment = focus_segment;
   }
 
-  std::shared_ptr<FrameReader> find_loaded_reader_locked(int segment, uint64_t generation) {
-    if (readers_generation != generation) {
-      readers.clear();
-      loading_segments.clear();
-      readers_generation = generation;
-    }
-    auto it = readers.find(segment);
-    return it != readers.end() ? it->second : nullptr;
-  }
-
-  std::shared_ptr<FrameReader> ensure_reader_loaded(int segment,
-                                                    const std::string &path,
-                                                    uint64_t generation,
-                                                    const char *reason,
+  std::shared_ptr<FrameReader> ensure_reader_loaded(const std::string &path,
                                                     std::atomic<bool> *abort_flag,
                                                     bool wait_for_inflight) {
-    while (!stop.load()) {
-      {
-        std::unique_lock<std::mutex> lock(readers_mutex);
-        if (std::shared_ptr<FrameReader> cached = find_loaded_reader_locked(segment, generation)) {
-          return cached;
-        }
-        if (loading_segments.find(segment) != loading_segments.end()) {
-          if (!wait_for_inflight) {
-            return nullptr;
-          }
-          readers_cv.wait(lock, [&]() {
-            return stop.load()
-                || readers_generation != generation
-                || loading_segments.find(segment) == loading_segments.end();
-          });
-          continue;
-        }
-        loading_segments.insert(segment);
-      }
-
-      auto reader = std::make_shared<FrameReader>();
-      const auto load_begin = std::chrono::steady_clock::now();
-      const bool loaded = reader->load(decoder_camera_type(camera_view), path, false, abort_flag, true);
-
-      {
-        std::lock_guard<std::mutex> lock(readers_mutex);
-        if (readers_generation != generation) {
-          readers.clear();
-          loading_segments.clear();
-          readers_generation = generation;
-        }
-        loading_segments.erase(segment);
-        if (loaded) {
-          readers[segment] = reader;
-        }
-      }
-      readers_cv.notify_all();
-
-      if (!loaded) {
-        return nullptr;
-      }
-      if (kLogCameraTimings) {
-        const double load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_begin).count();
-        std::fprintf(stderr, "camera[%s] %s-load seg=%d %.1fms\n",
-                     camera_view_spec(camera_view).runtime_name, reason, segment, load_ms);
-      }
-      return reader;
-    }
-    return nullptr;
+    return CameraDecodeService::instance().get_reader(decoder_camera_type(camera_view), path,
+                                                      abort_flag, wait_for_inflight, stop);
   }
 
   void preload_worker_loop() {
@@ -1119,14 +1251,10 @@ struct CameraFeedView::Impl {
       }
 
       abort_preload_work.store(false);
-      {
-        std::lock_guard<std::mutex> lock(readers_mutex);
-        if (find_loaded_reader_locked(preload->segment, preload->generation)) {
-          continue;
-        }
+      if (CameraDecodeService::instance().find_reader(preload->path)) {
+        continue;
       }
-      ensure_reader_loaded(preload->segment, preload->path, preload->generation, "preload",
-                           &abort_preload_work, false);
+      ensure_reader_loaded(preload->path, &abort_preload_work, false);
     }
   }
 
@@ -1151,10 +1279,8 @@ struct CameraFeedView::Impl {
 
       abort_demand_work.store(false);
 
-      DecodeResult result{.key = request->key};
-      std::shared_ptr<FrameReader> reader = ensure_reader_loaded(request->key.segment, request->path,
-                                                                 request->generation, "demand",
-                                                                 &abort_demand_work, true);
+      DecodeResult result{.key = request->key, .path = request->path};
+      std::shared_ptr<FrameReader> reader = ensure_reader_loaded(request->path, &abort_demand_work, true);
       if (!reader) {
         publish_result(*request, std::move(result));
         continue;
@@ -1198,6 +1324,7 @@ struct CameraFeedView::Impl {
         }
         DecodeResult prefetched{
           .key = RequestKey{.segment = request->key.segment, .decode_index = next_index},
+          .path = request->path,
           .success = true,
           .width = reader->width,
           .height = reader->height,
@@ -1211,7 +1338,7 @@ struct CameraFeedView::Impl {
                           prefetched.width * 4,
                           prefetched.width,
                           prefetched.height);
-        remember_cached_result(prefetched);
+        CameraDecodeService::instance().remember_frame(prefetched);
       }
     }
 
@@ -1233,17 +1360,11 @@ struct CameraFeedView::Impl {
   std::optional<DecodeResult> pending_result;
   std::deque<PreloadTask> preload_queue;
   int preload_focus_segment = -1;
-  std::deque<DecodeResult> cached_results;
   uint64_t latest_request_serial = 0;
   uint64_t route_generation = 1;
   std::optional<RequestKey> active_request;
   std::optional<RequestKey> displayed_request;
   std::optional<RequestKey> failed_request;
-  std::mutex readers_mutex;
-  std::condition_variable readers_cv;
-  std::unordered_map<int, std::shared_ptr<FrameReader>> readers;
-  std::unordered_set<int> loading_segments;
-  uint64_t readers_generation = 0;
   GLuint texture = 0;
   int texture_width = 0;
   int texture_height = 0;
@@ -29,6 +29,27 @@ void reset_timeline_view(UiState *state, const AppSession &session) {
 
 void draw_timeline_bar_contents(const AppSession &session, UiState *state, float width) {
   if (!session.route_data.has_time_range) {
+    // while a route load is in flight, show the engagement entries gathered
+    // so far; the bar is display-only until the full time range exists
+    if (session.route_loader) {
+      const RouteLoadSnapshot load = session.route_loader->snapshot();
+      if (load.active && load.has_partial_timeline && load.partial_x_max > load.partial_x_min) {
+        const ImVec2 cursor = ImGui::GetCursorScreenPos();
+        const ImVec2 size(width, TIMELINE_BAR_HEIGHT);
+        const ImVec2 bar_min(cursor.x + 1.0f, cursor.y + 1.0f);
+        const ImVec2 bar_max(cursor.x + size.x - 1.0f, cursor.y + size.y - 1.0f);
+        ImGui::Dummy(size);
+        ImDrawList *draw_list = ImGui::GetWindowDrawList();
+        draw_list->AddRectFilled(bar_min, bar_max, timeline_entry_color(TimelineEntry::Type::None, 0.2f));
+        for (const TimelineEntry &entry : load.partial_timeline) {
+          const float x0 = timeline_time_to_x(entry.start_time, load.partial_x_min, load.partial_x_max, bar_min.x, bar_max.x);
+          const float x1 = std::max(timeline_time_to_x(entry.end_time, load.partial_x_min, load.partial_x_max, bar_min.x, bar_max.x),
+                                    x0 + 1.0f);
+          draw_list->AddRectFilled(ImVec2(x0, bar_min.y), ImVec2(x1, bar_max.y), timeline_entry_color(entry.type, 1.0f));
+        }
+        return;
+      }
+    }
     ImGui::Dummy(ImVec2(width, TIMELINE_BAR_HEIGHT));
     return;
   }
@@ -4,6 +4,10 @@
 
 #include <kj/exception.h>
 
+extern "C" {
+#include <zstd.h>
+}
+
 #include <chrono>
 #include <cmath>
 #include <cstdlib>
@@ -125,12 +129,14 @@ struct LoadStats {
 
   explicit LoadStats(const RouteLoadProgressCallback &callback) : progress(callback) {}
 
-  void publish(RouteLoadStage stage, size_t segment_index, const std::string &segment_name) {
+  void publish(RouteLoadStage stage, size_t segment_index, const std::string &segment_name,
+               std::vector<TimelineEntry> timeline_entries = {}) {
     if (!progress) {
       return;
     }
     RouteLoadProgress update;
     update.stage = stage;
+    update.timeline_entries = std::move(timeline_entries);
     update.segment_index = segment_index;
     update.segment_count = segment_count;
     update.current = stage == RouteLoadStage::DownloadingSegment
@@ -934,6 +940,7 @@ void append_can_frame(CanServiceKind service,
 }
 
 void append_dynamic_scalar_point(const std::string &path, double tm, double value, SeriesAccumulator *series);
+size_t ensure_dynamic_slot(const std::string &path, SeriesAccumulator *series);
 
 void decode_can_frame(const dbc::Database *can_dbc,
                       const std::string &service_name,
@@ -965,6 +972,44 @@ void decode_can_frame(const dbc::Database *can_dbc,
   }
 }
 
+// Batch counterpart of decode_can_frame for a message's whole sample array:
+// the per-signal extraction plans, series slots and enum info are resolved
+// once up front, so the frame loop is nothing but byte gathers and appends.
+// This is what makes re-decoding a full route after a DBC edit fast.
+void decode_can_samples(const dbc::Database *can_dbc,
+                        const std::string &service_name,
+                        const CanMessageData &message_data,
+                        SeriesAccumulator *series) {
+  const dbc::Message *message = can_dbc != nullptr ? can_dbc->message(message_data.id.address) : nullptr;
+  if (message == nullptr || message_data.samples.empty()) {
+    return;
+  }
+
+  const dbc::MessagePlan plan = dbc::makeMessagePlan(*message);
+  const std::string base_path = "/" + service_name + "/" + std::to_string(message_data.id.bus) + "/" + message->name;
+  std::vector<size_t> slots(plan.plans.size());
+  for (size_t i = 0; i < plan.plans.size(); ++i) {
+    const dbc::Signal &signal = *plan.plans[i].signal;
+    const std::string path = base_path + "/" + signal.name;
+    if (series->enum_info.find(path) == series->enum_info.end()) {
+      std::vector<std::string> enum_names = can_dbc->enumNames(signal);
+      if (!enum_names.empty()) {
+        series->enum_info.emplace(path, EnumInfo{.names = std::move(enum_names)});
+      }
+    }
+    slots[i] = ensure_dynamic_slot(path, series);
+  }
+
+  for (const CanFrameSample &sample : message_data.samples) {
+    const uint8_t *raw = reinterpret_cast<const uint8_t *>(sample.data.data());
+    plan.decode(raw, sample.data.size(), [&](size_t i, double value) {
+      RouteSeries &dst = series->dynamic_series[slots[i]];
+      dst.times.push_back(sample.mono_time);
+      dst.values.push_back(value);
+    });
+  }
+}
+
 void append_live_can_frame(CanServiceKind service,
                            const LiveCanFrame &frame,
                            double time_offset,
@@ -1590,7 +1635,7 @@ LoadedRouteArtifacts load_route_series_parallel(
       segment_stats.event_count = reader.events.size();
       segment_stats.series_count = populated_series_count(results[index].series);
       stats->segments_parsed.fetch_add(1);
-      stats->publish(RouteLoadStage::ParsingSegment, index, std::to_string(segment_number));
+      stats->publish(RouteLoadStage::ParsingSegment, index, std::to_string(segment_number), results[index].timeline);
     }
   };
 
@@ -1606,9 +1651,89 @@ LoadedRouteArtifacts load_route_series_parallel(
   if (!first_error.empty()) throw std::runtime_error(first_error);
 
   stats->merge_start = LoadStats::Clock::now();
+  // two-pass, slot-parallel merge: destination slots are assigned in segment
+  // order first, then every columnar block is sized once and filled, so the
+  // big appends never reallocate per segment and independent series can be
+  // stitched together on different cores
   SeriesAccumulator merged = make_series_accumulator(schema);
-  for (size_t i = 0; i < results.size(); ++i) {
-    merge_series_accumulator(&merged, &results[i].series);
+  for (SegmentResult &result : results) {
+    for (const RouteSeries &series : result.series.dynamic_series) {
+      if (!series.path.empty()) {
+        ensure_dynamic_slot(series.path, &merged);
+      }
+    }
+    for (const CanMessageData &message : result.series.can_messages) {
+      ensure_can_message(message.id.service, message.id.bus, message.id.address, &merged);
+    }
+    for (auto &[path, info] : result.series.enum_info) {
+      merged.enum_info.try_emplace(path, std::move(info));
+    }
+  }
+
+  const size_t fixed_count = merged.fixed_series.size();
+  const size_t dynamic_count = merged.dynamic_series.size();
+  const size_t merge_slot_count = fixed_count + dynamic_count + merged.can_messages.size();
+  std::atomic<size_t> next_slot{0};
+  auto merge_worker = [&]() {
+    while (true) {
+      const size_t slot = next_slot.fetch_add(1);
+      if (slot >= merge_slot_count) {
+        return;
+      }
+      if (slot < fixed_count + dynamic_count) {
+        RouteSeries &dst = slot < fixed_count
+          ? merged.fixed_series[slot]
+          : merged.dynamic_series[slot - fixed_count];
+        size_t total = 0;
+        for (const SegmentResult &result : results) {
+          if (slot < fixed_count) {
+            total += result.series.fixed_series[slot].times.size();
+          } else if (auto it = result.series.dynamic_slots.find(dst.path); it != result.series.dynamic_slots.end()) {
+            total += result.series.dynamic_series[it->second].times.size();
+          }
+        }
+        dst.times.reserve(total);
+        dst.values.reserve(total);
+        for (const SegmentResult &result : results) {
+          const RouteSeries *src = nullptr;
+          if (slot < fixed_count) {
+            src = &result.series.fixed_series[slot];
+          } else if (auto it = result.series.dynamic_slots.find(dst.path); it != result.series.dynamic_slots.end()) {
+            src = &result.series.dynamic_series[it->second];
+          }
+          if (src == nullptr || src->times.empty()) continue;
+          dst.times.insert(dst.times.end(), src->times.begin(), src->times.end());
+          dst.values.insert(dst.values.end(), src->values.begin(), src->values.end());
+        }
+      } else {
+        CanMessageData &dst = merged.can_messages[slot - fixed_count - dynamic_count];
+        size_t total = 0;
+        for (const SegmentResult &result : results) {
+          if (auto it = result.series.can_message_slots.find(dst.id); it != result.series.can_message_slots.end()) {
+            total += result.series.can_messages[it->second].samples.size();
+          }
+        }
+        dst.samples.reserve(total);
+        for (SegmentResult &result : results) {
+          auto it = result.series.can_message_slots.find(dst.id);
+          if (it == result.series.can_message_slots.end()) continue;
+          std::vector<CanFrameSample> &src = result.series.can_messages[it->second].samples;
+          dst.samples.insert(dst.samples.end(),
+                             std::make_move_iterator(src.begin()),
+                             std::make_move_iterator(src.end()));
+        }
+      }
+    }
+  };
+  const size_t merge_workers = std::max<size_t>(1, std::min(worker_budget, merge_slot_count));
+  std::vector<std::thread> merge_threads;
+  merge_threads.reserve(merge_workers - 1);
+  for (size_t i = 1; i < merge_workers; ++i) {
+    merge_threads.emplace_back(merge_worker);
+  }
+  merge_worker();
+  for (std::thread &thread : merge_threads) {
+    thread.join();
   }
   std::vector<LogEntry> logs;
   std::vector<TimelineEntry> timeline;
@@ -1656,6 +1781,442 @@ std::vector<std::string> collect_layout_roots(const SketchLayout &layout) {
   return roots;
 }
 
+// ---- route snapshot cache ----
+//
+// server routes are immutable once uploaded, so the fully parsed RouteData can
+// be written to disk and reopening a saved session skips the download and the
+// parse entirely. the format mirrors the vector map tile cache: a versioned
+// binary payload compressed with zstd, keyed by a hash of the route spec.
+
+constexpr char kRouteSnapshotMagic[4] = {'J', 'R', 'S', '1'};
+
+uint64_t fnv1a64(std::string_view text) {
+  uint64_t value = 1469598103934665603ULL;
+  for (unsigned char c : text) {
+    value ^= static_cast<uint64_t>(c);
+    value *= 1099511628211ULL;
+  }
+  return value;
+}
+
+fs::path route_snapshot_root() {
+  const char *home = std::getenv("HOME");
+  fs::path root = home != nullptr ? fs::path(home) / ".comma" : fs::temp_directory_path();
+  root /= "jotpluggler_route_snapshot";
+  return root;
+}
+
+std::string route_snapshot_key(const RouteSelection &route, const std::string &dbc_override) {
+  // the dbc override changes which placeholder CAN series get indexed, so an
+  // explicit override gets its own snapshot; auto-detection is deterministic
+  return util::string_format("v1_%s_%d_%d_%d_%s", route.canonical_name.c_str(),
+                             route.begin_segment, route.end_segment,
+                             static_cast<int>(route.selector), dbc_override.c_str());
+}
+
+fs::path route_snapshot_path(const std::string &key) {
+  const uint64_t hash = fnv1a64(key);
+  return route_snapshot_root() / util::string_format("%016llx.bin.zst", static_cast<unsigned long long>(hash));
+}
+
+template <typename T>
+void append_pod(std::string *out, const T &value) {
+  const size_t start = out->size();
+  out->resize(start + sizeof(T));
+  std::memcpy(out->data() + start, &value, sizeof(T));
+}
+
+template <typename T>
+bool read_pod(std::string_view data, size_t *offset, T *value) {
+  if (*offset + sizeof(T) > data.size()) {
+    return false;
+  }
+  std::memcpy(value, data.data() + *offset, sizeof(T));
+  *offset += sizeof(T);
+  return true;
+}
+
+void append_string(std::string *out, const std::string &text) {
+  append_pod(out, static_cast<uint32_t>(text.size()));
+  out->append(text);
+}
+
+bool read_string(std::string_view data, size_t *offset, std::string *text) {
+  uint32_t size = 0;
+  if (!read_pod(data, offset, &size) || *offset + size > data.size()) {
+    return false;
+  }
+  text->assign(data.data() + *offset, size);
+  *offset += size;
+  return true;
+}
+
+void append_doubles(std::string *out, const std::vector<double> &values) {
+  append_pod(out, static_cast<uint64_t>(values.size()));
+  const size_t start = out->size();
+  out->resize(start + values.size() * sizeof(double));
+  std::memcpy(out->data() + start, values.data(), values.size() * sizeof(double));
+}
+
+bool read_doubles(std::string_view data, size_t *offset, std::vector<double> *values) {
+  uint64_t count = 0;
+  if (!read_pod(data, offset, &count)) {
+    return false;
+  }
+  const size_t bytes = static_cast<size_t>(count) * sizeof(double);
+  if (*offset + bytes > data.size()) {
+    return false;
+  }
+  values->resize(static_cast<size_t>(count));
+  std::memcpy(values->data(), data.data() + *offset, bytes);
+  *offset += bytes;
+  return true;
+}
+
+void append_string_list(std::string *out, const std::vector<std::string> &items) {
+  append_pod(out, static_cast<uint32_t>(items.size()));
+  for (const std::string &item : items) {
+    append_string(out, item);
+  }
+}
+
+bool read_string_list(std::string_view data, size_t *offset, std::vector<std::string> *items) {
+  uint32_t count = 0;
+  if (!read_pod(data, offset, &count)) {
+    return false;
+  }
+  items->clear();
+  items->reserve(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    std::string item;
+    if (!read_string(data, offset, &item)) {
+      return false;
+    }
+    items->push_back(std::move(item));
+  }
+  return true;
+}
+
+void append_camera_index(std::string *out, const CameraFeedIndex &feed) {
+  append_pod(out, static_cast<uint32_t>(feed.segment_files.size()));
+  for (const CameraSegmentFile &file : feed.segment_files) {
+    append_pod(out, file.segment);
+    append_string(out, file.path);
+  }
+  append_pod(out, static_cast<uint64_t>(feed.entries.size()));
+  for (const CameraFrameIndexEntry &entry : feed.entries) {
+    append_pod(out, entry.timestamp);
+    append_pod(out, entry.segment);
+    append_pod(out, entry.decode_index);
+    append_pod(out, entry.frame_id);
+  }
+}
+
+bool read_camera_index(std::string_view data, size_t *offset, CameraFeedIndex *feed) {
+  uint32_t file_count = 0;
+  if (!read_pod(data, offset, &file_count)) {
+    return false;
+  }
+  feed->segment_files.resize(file_count);
+  for (CameraSegmentFile &file : feed->segment_files) {
+    if (!read_pod(data, offset, &file.segment) || !read_string(data, offset, &file.path)) {
+      return false;
+    }
+  }
+  uint64_t entry_count = 0;
+  if (!read_pod(data, offset, &entry_count)) {
+    return false;
+  }
+  feed->entries.resize(static_cast<size_t>(entry_count));
+  for (CameraFrameIndexEntry &entry : feed->entries) {
+    if (!read_pod(data, offset, &entry.timestamp)
+        || !read_pod(data, offset, &entry.segment)
+        || !read_pod(data, offset, &entry.decode_index)
+        || !read_pod(data, offset, &entry.frame_id)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string serialize_route_snapshot(const RouteData &route_data) {
+  std::string raw;
+  raw.append(kRouteSnapshotMagic, sizeof(kRouteSnapshotMagic));
+
+  append_string(&raw, route_data.route_id.dongle_id);
+  append_string(&raw, route_data.route_id.log_id);
+  append_pod(&raw, route_data.route_id.slice_begin);
+  append_pod(&raw, route_data.route_id.slice_end);
+  append_pod(&raw, static_cast<uint8_t>(route_data.route_id.slice_explicit));
+  append_pod(&raw, static_cast<uint8_t>(route_data.route_id.selector));
+  append_pod(&raw, static_cast<uint8_t>(route_data.route_id.selector_explicit));
+  append_pod(&raw, route_data.route_id.available_begin);
+  append_pod(&raw, route_data.route_id.available_end);
+  append_string(&raw, route_data.car_fingerprint);
+  append_string(&raw, route_data.dbc_name);
+  append_pod(&raw, static_cast<uint8_t>(route_data.has_time_range));
+  append_pod(&raw, route_data.x_min);
+  append_pod(&raw, route_data.x_max);
+
+  // lod levels and series formats are not persisted: rebuild_route_index
+  // recomputes both when the route is applied to a session
+  append_pod(&raw, static_cast<uint32_t>(route_data.series.size()));
+  for (const RouteSeries &series : route_data.series) {
+    append_string(&raw, series.path);
+    append_doubles(&raw, series.times);
+    append_doubles(&raw, series.values);
+  }
+  append_string_list(&raw, route_data.paths);
+  append_string_list(&raw, route_data.roots);
+
+  append_pod(&raw, static_cast<uint32_t>(route_data.can_messages.size()));
+  for (const CanMessageData &message : route_data.can_messages) {
+    append_pod(&raw, static_cast<uint8_t>(message.id.service));
+    append_pod(&raw, message.id.bus);
+    append_pod(&raw, message.id.address);
+    append_pod(&raw, static_cast<uint64_t>(message.samples.size()));
+    for (const CanFrameSample &sample : message.samples) {
+      append_pod(&raw, sample.mono_time);
+      append_pod(&raw, sample.bus_time);
+      append_string(&raw, sample.data);
+    }
+  }
+
+  append_camera_index(&raw, route_data.road_camera);
+  append_camera_index(&raw, route_data.driver_camera);
+  append_camera_index(&raw, route_data.wide_road_camera);
+  append_camera_index(&raw, route_data.qroad_camera);
+
+  append_pod(&raw, route_data.gps_trace.min_lat);
+  append_pod(&raw, route_data.gps_trace.max_lat);
+  append_pod(&raw, route_data.gps_trace.min_lon);
+  append_pod(&raw, route_data.gps_trace.max_lon);
+  append_pod(&raw, static_cast<uint64_t>(route_data.gps_trace.points.size()));
+  for (const GpsPoint &point : route_data.gps_trace.points) {
+    append_pod(&raw, point.time);
+    append_pod(&raw, point.lat);
+    append_pod(&raw, point.lon);
+    append_pod(&raw, point.bearing);
+    append_pod(&raw, static_cast<uint8_t>(point.type));
+  }
+
+  append_pod(&raw, static_cast<uint64_t>(route_data.logs.size()));
+  for (const LogEntry &entry : route_data.logs) {
+    append_pod(&raw, entry.mono_time);
+    append_pod(&raw, entry.boot_time);
+    append_pod(&raw, entry.wall_time);
+    append_pod(&raw, entry.level);
+    append_string(&raw, entry.source);
+    append_string(&raw, entry.func);
+    append_string(&raw, entry.message);
+    append_string(&raw, entry.context);
+    append_pod(&raw, static_cast<uint8_t>(entry.origin));
+  }
+
+  append_pod(&raw, static_cast<uint32_t>(route_data.timeline.size()));
+  for (const TimelineEntry &entry : route_data.timeline) {
+    append_pod(&raw, entry.start_time);
+    append_pod(&raw, entry.end_time);
+    append_pod(&raw, static_cast<uint8_t>(entry.type));
+  }
+
+  append_pod(&raw, static_cast<uint32_t>(route_data.enum_info.size()));
+  for (const auto &[path, info] : route_data.enum_info) {
+    append_string(&raw, path);
+    append_string_list(&raw, info.names);
+  }
+  return raw;
+}
+
+std::optional<RouteData> deserialize_route_snapshot(std::string_view raw) {
+  if (raw.size() < sizeof(kRouteSnapshotMagic)
+      || std::memcmp(raw.data(), kRouteSnapshotMagic, sizeof(kRouteSnapshotMagic)) != 0) {
+    return std::nullopt;
+  }
+  size_t offset = sizeof(kRouteSnapshotMagic);
+  RouteData route_data;
+
+  uint8_t slice_explicit = 0;
+  uint8_t selector = 0;
+  uint8_t selector_explicit = 0;
+  uint8_t has_time_range = 0;
+  if (!read_string(raw, &offset, &route_data.route_id.dongle_id)
+      || !read_string(raw, &offset, &route_data.route_id.log_id)
+      || !read_pod(raw, &offset, &route_data.route_id.slice_begin)
+      || !read_pod(raw, &offset, &route_data.route_id.slice_end)
+      || !read_pod(raw, &offset, &slice_explicit)
+      || !read_pod(raw, &offset, &selector)
+      || !read_pod(raw, &offset, &selector_explicit)
+      || !read_pod(raw, &offset, &route_data.route_id.available_begin)
+      || !read_pod(raw, &offset, &route_data.route_id.available_end)
+      || !read_string(raw, &offset, &route_data.car_fingerprint)
+      || !read_string(raw, &offset, &route_data.dbc_name)
+      || !read_pod(raw, &offset, &has_time_range)
+      || !read_pod(raw, &offset, &route_data.x_min)
+      || !read_pod(raw, &offset, &route_data.x_max)) {
+    return std::nullopt;
+  }
+  route_data.route_id.slice_explicit = slice_explicit != 0;
+  route_data.route_id.selector = static_cast<LogSelector>(selector);
+  route_data.route_id.selector_explicit = selector_explicit != 0;
+  route_data.has_time_range = has_time_range != 0;
+
+  uint32_t series_count = 0;
+  if (!read_pod(raw, &offset, &series_count)) {
+    return std::nullopt;
+  }
+  route_data.series.resize(series_count);
+  for (RouteSeries &series : route_data.series) {
+    if (!read_string(raw, &offset, &series.path)
+        || !read_doubles(raw, &offset, &series.times)
+        || !read_doubles(raw, &offset, &series.values)) {
+      return std::nullopt;
+    }
+  }
+  if (!read_string_list(raw, &offset, &route_data.paths)
+      || !read_string_list(raw, &offset, &route_data.roots)) {
+    return std::nullopt;
+  }
+
+  uint32_t message_count = 0;
+  if (!read_pod(raw, &offset, &message_count)) {
+    return std::nullopt;
+  }
+  route_data.can_messages.resize(message_count);
+  for (CanMessageData &message : route_data.can_messages) {
+    uint8_t service = 0;
+    uint64_t sample_count = 0;
+    if (!read_pod(raw, &offset, &service)
+        || !read_pod(raw, &offset, &message.id.bus)
+        || !read_pod(raw, &offset, &message.id.address)
+        || !read_pod(raw, &offset, &sample_count)) {
+      return std::nullopt;
+    }
+    message.id.service = static_cast<CanServiceKind>(service);
+    message.samples.resize(static_cast<size_t>(sample_count));
+    for (CanFrameSample &sample : message.samples) {
+      if (!read_pod(raw, &offset, &sample.mono_time)
+          || !read_pod(raw, &offset, &sample.bus_time)
+          || !read_string(raw, &offset, &sample.data)) {
+        return std::nullopt;
+      }
+    }
+  }
+
+  if (!read_camera_index(raw, &offset, &route_data.road_camera)
+      || !read_camera_index(raw, &offset, &route_data.driver_camera)
+      || !read_camera_index(raw, &offset, &route_data.wide_road_camera)
+      || !read_camera_index(raw, &offset, &route_data.qroad_camera)) {
+    return std::nullopt;
+  }
+
+  uint64_t point_count = 0;
+  if (!read_pod(raw, &offset, &route_data.gps_trace.min_lat)
+      || !read_pod(raw, &offset, &route_data.gps_trace.max_lat)
+      || !read_pod(raw, &offset, &route_data.gps_trace.min_lon)
+      || !read_pod(raw, &offset, &route_data.gps_trace.max_lon)
+      || !read_pod(raw, &offset, &point_count)) {
+    return std::nullopt;
+  }
+  route_data.gps_trace.points.resize(static_cast<size_t>(point_count));
+  for (GpsPoint &point : route_data.gps_trace.points) {
+    uint8_t type = 0;
+    if (!read_pod(raw, &offset, &point.time)
+        || !read_pod(raw, &offset, &point.lat)
+        || !read_pod(raw, &offset, &point.lon)
+        || !read_pod(raw, &offset, &point.bearing)
+        || !read_pod(raw, &offset, &type)) {
+      return std::nullopt;
+    }
+    point.type = static_cast<TimelineEntry::Type>(type);
+  }
+
+  uint64_t log_count = 0;
+  if (!read_pod(raw, &offset, &log_count)) {
+    return std::nullopt;
+  }
+  route_data.logs.resize(static_cast<size_t>(log_count));
+  for (LogEntry &entry : route_data.logs) {
+    uint8_t origin = 0;
+    if (!read_pod(raw, &offset, &entry.mono_time)
+        || !read_pod(raw, &offset, &entry.boot_time)
+        || !read_pod(raw, &offset, &entry.wall_time)
+        || !read_pod(raw, &offset, &entry.level)
+        || !read_string(raw, &offset, &entry.source)
+        || !read_string(raw, &offset, &entry.func)
+        || !read_string(raw, &offset, &entry.message)
+        || !read_string(raw, &offset, &entry.context)
+        || !read_pod(raw, &offset, &origin)) {
+      return std::nullopt;
+    }
+    entry.origin = static_cast<LogOrigin>(origin);
+  }
+
+  uint32_t timeline_count = 0;
+  if (!read_pod(raw, &offset, &timeline_count)) {
+    return std::nullopt;
+  }
+  route_data.timeline.resize(timeline_count);
+  for (TimelineEntry &entry : route_data.timeline) {
+    uint8_t type = 0;
+    if (!read_pod(raw, &offset, &entry.start_time)
+        || !read_pod(raw, &offset, &entry.end_time)
+        || !read_pod(raw, &offset, &type)) {
+      return std::nullopt;
+    }
+    entry.type = static_cast<TimelineEntry::Type>(type);
+  }
+
+  uint32_t enum_count = 0;
+  if (!read_pod(raw, &offset, &enum_count)) {
+    return std::nullopt;
+  }
+  route_data.enum_info.reserve(enum_count);
+  for (uint32_t i = 0; i < enum_count; ++i) {
+    std::string path;
+    EnumInfo info;
+    if (!read_string(raw, &offset, &path) || !read_string_list(raw, &offset, &info.names)) {
+      return std::nullopt;
+    }
+    route_data.enum_info.emplace(std::move(path), std::move(info));
+  }
+  return route_data;
+}
+
+bool save_route_snapshot(const fs::path &path, const RouteData &route_data) {
+  const std::string raw = serialize_route_snapshot(route_data);
+  // level 3: snapshots run to hundreds of megabytes and write time matters
+  // more than squeezing out the last bit of ratio
+  const size_t bound = ZSTD_compressBound(raw.size());
+  std::string compressed(bound, '\0');
+  const size_t size = ZSTD_compress(compressed.data(), compressed.size(), raw.data(), raw.size(), 3);
+  if (ZSTD_isError(size)) {
+    return false;
+  }
+  compressed.resize(size);
+  ensure_parent_dir(path);
+  const std::string path_string = path.string();
+  return util::write_file(path_string.c_str(), compressed.data(), compressed.size(), O_WRONLY | O_CREAT | O_TRUNC) == 0;
+}
+
+std::optional<RouteData> load_route_snapshot(const fs::path &path) {
+  const std::string compressed = util::read_file(path.string());
+  if (compressed.empty()) {
+    return std::nullopt;
+  }
+  const unsigned long long raw_size = ZSTD_getFrameContentSize(compressed.data(), compressed.size());
+  if (raw_size == ZSTD_CONTENTSIZE_ERROR || raw_size == ZSTD_CONTENTSIZE_UNKNOWN || raw_size > (1ULL << 33)) {
+    return std::nullopt;
+  }
+  std::string raw(static_cast<size_t>(raw_size), '\0');
+  const size_t actual = ZSTD_decompress(raw.data(), raw.size(), compressed.data(), compressed.size());
+  if (ZSTD_isError(actual)) {
+    return std::nullopt;
+  }
+  raw.resize(actual);
+  return deserialize_route_snapshot(raw);
+}
+
 }  // namespace
 
 std::vector<std::string> collect_route_roots_for_paths(const std::vector<std::string> &paths) {
@@ -1809,6 +2370,14 @@ RouteData load_route_data(const std::string &route_name,
   if (route.canonical_name.empty() || (data_dir.empty() && route.dongle_id.empty())) {
     throw std::runtime_error("Invalid route format: " + route_name);
   }
+  // only server routes are snapshotted: a local directory can still be filling
+  // up with segments and is already cheap to re-read
+  const std::string snapshot_key = data_dir.empty() ? route_snapshot_key(route, dbc_name) : std::string();
+  if (!snapshot_key.empty()) {
+    if (std::optional<RouteData> cached = load_route_snapshot(route_snapshot_path(snapshot_key))) {
+      return std::move(*cached);
+    }
+  }
   LoadStats stats(progress);
   stats.load_start = LoadStats::Clock::now();
   std::map<int, SegmentLogs> segments = data_dir.empty()
@@ -1828,7 +2397,10 @@ RouteData load_route_data(const std::string &route_name,
   const std::optional<dbc::Database> can_dbc = load_dbc_by_name(resolved_dbc);
 
   const SchemaIndex &schema = SchemaIndex::instance();
-  LoadedRouteArtifacts artifacts = load_route_series_parallel(segments, schema, can_dbc ? &*can_dbc : nullptr,
+  // CAN signals are not decoded here: the raw frames are kept and placeholder
+  // series advertise the decodable paths, with samples materialized on first
+  // plot request instead of for every signal of every frame up front
+  LoadedRouteArtifacts artifacts = load_route_series_parallel(segments, schema, nullptr,
                                                              route.selector, can_dbc.has_value(), &stats);
   RouteData route_data = build_route_data(std::move(artifacts.series),
                                           std::move(artifacts.can_messages),
@@ -1838,6 +2410,22 @@ RouteData load_route_data(const std::string &route_name,
                                           metadata.car_fingerprint,
                                           resolved_dbc);
   route_data.route_id = make_route_identifier(route, segments);
+  std::unordered_map<std::string, EnumInfo> can_enum_info;
+  std::vector<RouteSeries> can_index = index_can_messages(route_data.can_messages, resolved_dbc, &can_enum_info);
+  if (!can_index.empty()) {
+    for (auto &[path, info] : can_enum_info) {
+      route_data.enum_info.try_emplace(path, std::move(info));
+    }
+    for (RouteSeries &series : can_index) {
+      route_data.paths.push_back(series.path);
+      route_data.series.push_back(std::move(series));
+    }
+    std::sort(route_data.paths.begin(), route_data.paths.end());
+    std::sort(route_data.series.begin(), route_data.series.end(), [](const RouteSeries &a, const RouteSeries &b) {
+      return a.path < b.path;
+    });
+    route_data.roots = collect_route_roots_for_paths(route_data.paths);
+  }
   build_camera_index(segments, route_data, &SegmentLogs::fcamera, "roadEncodeIdx", &route_data.road_camera);
   build_camera_index(segments, route_data, &SegmentLogs::dcamera, "driverEncodeIdx", &route_data.driver_camera);
   build_camera_index(segments, route_data, &SegmentLogs::ecamera, "wideRoadEncodeIdx", &route_data.wide_road_camera);
@@ -1845,6 +2433,9 @@ RouteData load_route_data(const std::string &route_name,
   stats.load_end = LoadStats::Clock::now();
   stats.publish(RouteLoadStage::Finished, segments.size(), {});
   stats.print_summary(route_data.series.size());
+  if (!snapshot_key.empty()) {
+    save_route_snapshot(route_snapshot_path(snapshot_key), route_data);
+  }
   return route_data;
 }
 
@@ -1880,20 +2471,75 @@ std::vector<RouteSeries> decode_can_messages(const std::vector<CanMessageData> &
 
   SeriesAccumulator series;
   for (const CanMessageData &message : can_messages) {
-    const char *service_name = message.id.service == CanServiceKind::Can ? "can" : "sendcan";
-    for (const CanFrameSample &sample : message.samples) {
-      decode_can_frame(&*can_dbc,
-                       service_name,
-                       message.id.bus,
-                       message.id.address,
-                       reinterpret_cast<const uint8_t *>(sample.data.data()),
-                       sample.data.size(),
-                       sample.mono_time,
+    decode_can_samples(&*can_dbc,
+                       message.id.service == CanServiceKind::Can ? "can" : "sendcan",
+                       message,
                        &series);
-    }
   }
   if (enum_info != nullptr) {
     *enum_info = std::move(series.enum_info);
   }
   return collect_series(std::move(series));
 }
+
+std::vector<RouteSeries> index_can_messages(const std::vector<CanMessageData> &can_messages,
+                                            const std::string &dbc_name,
+                                            std::unordered_map<std::string, EnumInfo> *enum_info) {
+  if (enum_info != nullptr) {
+    enum_info->clear();
+  }
+  const std::optional<dbc::Database> can_dbc = load_dbc_by_name(dbc_name);
+  if (!can_dbc.has_value()) {
+    return {};
+  }
+
+  std::vector<RouteSeries> index;
+  for (const CanMessageData &message : can_messages) {
+    const dbc::Message *msg = can_dbc->message(message.id.address);
+    if (msg == nullptr) {
+      continue;
+    }
+    const char *service_name = message.id.service == CanServiceKind::Can ? "can" : "sendcan";
+    const std::string base_path = "/" + std::string(service_name) + "/" + std::to_string(message.id.bus) + "/" + msg->name;
+    for (const dbc::Signal &signal : msg->signals) {
+      std::string path = base_path + "/" + signal.name;
+      if (enum_info != nullptr && enum_info->find(path) == enum_info->end()) {
+        std::vector<std::string> enum_names = can_dbc->enumNames(signal);
+        if (!enum_names.empty()) {
+          enum_info->emplace(path, EnumInfo{.names = std::move(enum_names)});
+        }
+      }
+      index.push_back(RouteSeries{std::move(path)});
+    }
+  }
+  return index;
+}
+
+std::vector<RouteSeries> decode_can_messages_for_paths(const std::vector<CanMessageData> &can_messages,
+                                                       const std::string &dbc_name,
+                                                       const std::vector<std::string> &paths) {
+  const std::optional<dbc::Database> can_dbc = load_dbc_by_name(dbc_name);
+  if (!can_dbc.has_value() || paths.empty()) {
+    return {};
+  }
+
+  SeriesAccumulator series;
+  for (const CanMessageData &message : can_messages) {
+    const dbc::Message *msg = can_dbc->message(message.id.address);
+    if (msg == nullptr) {
+      continue;
+    }
+    const std::string service_name = message.id.service == CanServiceKind::Can ? "can" : "sendcan";
+    // requesting any signal materializes its whole message: the siblings cost
+    // little extra on top of walking the frames once
+    const std::string base_path = "/" + service_name + "/" + std::to_string(message.id.bus) + "/" + msg->name + "/";
+    const bool wanted = std::any_of(paths.begin(), paths.end(), [&](const std::string &path) {
+      return util::starts_with(path, base_path);
+    });
+    if (!wanted) {
+      continue;
+    }
+    decode_can_samples(&*can_dbc, service_name, message, &series);
+  }
+  return collect_series(std::move(series));
+}
@@ -1,5 +1,7 @@
 #include "tools/jotpluggler/internal.h"
 
+#include <array>
+#include <limits>
 #include <tuple>
 
 template <typename Cmp, typename SeriesAccessor, typename LogAccessor>
@@ -66,6 +68,75 @@ void append_stream_timeline_entries(std::vector<TimelineEntry> *timeline, std::v
   }
 }
 
+// live sessions accumulate samples for as long as the device streams, so the
+// full-rate data has to be bounded. the newest window stays at full rate and
+// everything older is folded into first/min/max/last buckets, RRD-style: each
+// compaction pass refolds the old prefix, so history gets progressively
+// coarser with age and total memory converges instead of growing linearly
+constexpr size_t STREAM_FULL_RATE_SAMPLES = 1 << 17;
+constexpr size_t STREAM_COMPACT_TRIGGER = STREAM_FULL_RATE_SAMPLES * 2;
+constexpr size_t STREAM_COMPACT_BUCKET = 16;
+// raw CAN frames cannot be min/max folded, so they get a plain retention
+// window; series already materialized from them keep their folded history,
+// but a CAN signal plotted for the first time only shows this much past
+constexpr double STREAM_CAN_HISTORY_SECONDS = 600.0;
+
+void compact_stream_series(RouteSeries *series) {
+  if (series->times.size() < STREAM_COMPACT_TRIGGER || series->times.size() != series->values.size()) {
+    return;
+  }
+  const size_t fold_end = series->times.size() - STREAM_FULL_RATE_SAMPLES;
+  std::vector<double> times;
+  std::vector<double> values;
+  times.reserve((fold_end / STREAM_COMPACT_BUCKET + 1) * 4 + STREAM_FULL_RATE_SAMPLES);
+  values.reserve(times.capacity());
+  for (size_t start = 0; start < fold_end; start += STREAM_COMPACT_BUCKET) {
+    const size_t end = std::min(start + STREAM_COMPACT_BUCKET, fold_end);
+    size_t min_index = start;
+    size_t max_index = start;
+    for (size_t index = start + 1; index < end; ++index) {
+      if (series->values[index] < series->values[min_index]) {
+        min_index = index;
+      }
+      if (series->values[index] > series->values[max_index]) {
+        max_index = index;
+      }
+    }
+    std::array<size_t, 4> indices = {start, min_index, max_index, end - 1};
+    std::sort(indices.begin(), indices.end());
+    size_t last_index = std::numeric_limits<size_t>::max();
+    for (size_t index : indices) {
+      if (index == last_index) {
+        continue;
+      }
+      times.push_back(series->times[index]);
+      values.push_back(series->values[index]);
+      last_index = index;
+    }
+  }
+  times.insert(times.end(), series->times.begin() + static_cast<ptrdiff_t>(fold_end), series->times.end());
+  values.insert(values.end(), series->values.begin() + static_cast<ptrdiff_t>(fold_end), series->values.end());
+  series->times = std::move(times);
+  series->values = std::move(values);
+  // the draw pyramid addresses base samples by position, so it has to be
+  // rebuilt over the compacted array
+  series->lod_levels.clear();
+  app_extend_series_lod(series);
+}
+
+void trim_stream_can_history(std::vector<CanMessageData> *messages, double latest_time) {
+  const double cutoff = latest_time - STREAM_CAN_HISTORY_SECONDS;
+  for (CanMessageData &message : *messages) {
+    auto keep_begin = std::lower_bound(message.samples.begin(), message.samples.end(), cutoff,
+                                       [](const CanFrameSample &sample, double t) {
+                                         return sample.mono_time < t;
+                                       });
+    if (keep_begin != message.samples.begin()) {
+      message.samples.erase(message.samples.begin(), keep_begin);
+    }
+  }
+}
+
 bool can_message_less(const CanMessageData &a, const CanMessageData &b) {
   return std::make_tuple(a.id.service, a.id.bus, a.id.address)
        < std::make_tuple(b.id.service, b.id.bus, b.id.address);
@@ -102,6 +173,8 @@ void apply_stream_batch(AppSession *session, UiState *state, StreamExtractBatch
     RouteSeries &existing = *existing_it->second;
     existing.times.insert(existing.times.end(), incoming.times.begin(), incoming.times.end());
     existing.values.insert(existing.values.end(), incoming.values.begin(), incoming.values.end());
+    app_extend_series_lod(&existing);
+    compact_stream_series(&existing);
   }
   for (RouteSeries &series : new_series) {
     session->route_data.paths.push_back(series.path);
@@ -183,6 +256,9 @@ void apply_stream_batch(AppSession *session, UiState *state, StreamExtractBatch
     }
     session->route_data.has_time_range = true;
   }
+  if (latest_time.has_value()) {
+    trim_stream_can_history(&session->route_data.can_messages, *latest_time);
+  }
 
   if (new_paths
       || std::find(touched_paths.begin(), touched_paths.end(), "/gpsLocationExternal/latitude") != touched_paths.end()
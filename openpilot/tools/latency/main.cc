@@ -0,0 +1,147 @@
+// Frame-to-actuation latency tracker.
+//
+// Follows one camera frame through the service chain by id instead of by
+// arrival time: roadCameraState carries the frameId and timestampSof,
+// modelV2 echoes the frameId, longitudinalPlan points back at the model
+// via modelMonoTime, controlsState points at the plan via
+// longitudinalPlanMonoTime, and the first sendcan after the controls
+// cycle closes the chain. Per-stage latency percentiles print every few
+// seconds.
+//
+// Works live on a device, or against recorded routes by running
+// `tools/replay/replay <route>` in another terminal: replay republishes
+// the original events, and all deltas come from the logMonoTime fields
+// inside the payloads, so replayed timing matches the drive.
+//
+//   ./latency
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "common/timing.h"
+#include "openpilot/cereal/messaging/messaging.h"
+
+namespace {
+
+struct FrameTrace {
+  uint64_t sof = 0;
+  uint64_t camera = 0, model = 0, plan = 0, controls = 0, actuation = 0;
+};
+
+const char *STAGE_NAMES[] = {
+  "sof -> camerad",
+  "camerad -> modeld",
+  "modeld -> plannerd",
+  "plannerd -> selfdrived",
+  "selfdrived -> sendcan",
+  "total sof -> sendcan",
+};
+constexpr int NUM_STAGES = 6;
+
+class LatencyTracker {
+public:
+  void handle(const std::string &name, cereal::Event::Reader evt) {
+    const uint64_t mono_time = evt.getLogMonoTime();
+    if (name == "roadCameraState") {
+      auto fc = evt.getRoadCameraState();
+      frames_[fc.getFrameId()] = FrameTrace{.sof = fc.getTimestampSof(), .camera = mono_time};
+      gc(fc.getFrameId());
+    } else if (name == "modelV2") {
+      auto model = evt.getModelV2();
+      if (auto it = frames_.find(model.getFrameId()); it != frames_.end()) {
+        it->second.model = mono_time;
+        model_to_frame_[mono_time] = model.getFrameId();
+      }
+    } else if (name == "longitudinalPlan") {
+      auto plan = evt.getLongitudinalPlan();
+      if (auto it = model_to_frame_.find(plan.getModelMonoTime()); it != model_to_frame_.end()) {
+        frames_[it->second].plan = mono_time;
+        plan_to_frame_[mono_time] = it->second;
+      }
+    } else if (name == "controlsState") {
+      auto cs = evt.getControlsState();
+      if (auto it = plan_to_frame_.find(cs.getLongitudinalPlanMonoTime()); it != plan_to_frame_.end()) {
+        frames_[it->second].controls = mono_time;
+        pending_frame_ = it->second;
+      }
+    } else if (name == "sendcan" && pending_frame_ != 0) {
+      if (auto it = frames_.find(pending_frame_); it != frames_.end()) {
+        it->second.actuation = mono_time;
+        finalize(it->second);
+        frames_.erase(it);
+      }
+      pending_frame_ = 0;
+    }
+  }
+
+  void report() {
+    printf("\n%-24s %8s %8s %8s %8s %8s\n", "stage", "count", "p50 ms", "p90 ms", "p99 ms", "max ms");
+    for (int i = 0; i < NUM_STAGES; ++i) {
+      auto &ms = samples_[i];
+      if (ms.empty()) {
+        printf("%-24s %8s waiting for chain...\n", STAGE_NAMES[i], "-");
+        continue;
+      }
+      std::sort(ms.begin(), ms.end());
+      auto pct = [&](double p) { return ms[std::min(ms.size() - 1, (size_t)(p * ms.size()))]; };
+      printf("%-24s %8zu %8.2f %8.2f %8.2f %8.2f\n",
+             STAGE_NAMES[i], ms.size(), pct(0.50), pct(0.90), pct(0.99), ms.back());
+      ms.clear();
+    }
+  }
+
+private:
+  void finalize(const FrameTrace &t) {
+    // a chain only counts when every hop resolved and time moved forward
+    const uint64_t ts[] = {t.sof, t.camera, t.model, t.plan, t.controls, t.actuation};
+    for (int i = 1; i < 6; ++i) {
+      if (ts[i] == 0 || ts[i] < ts[i - 1]) return;
+    }
+    for (int i = 1; i < 6; ++i) {
+      samples_[i - 1].push_back((ts[i] - ts[i - 1]) / 1e6);
+    }
+    samples_[5].push_back((t.actuation - t.sof) / 1e6);
+  }
+
+  // frames that never complete (dropped model runs, disengaged controls)
+  // would otherwise accumulate forever
+  void gc(uint32_t latest_frame_id) {
+    while (!frames_.empty() && frames_.begin()->first + 100 < latest_frame_id) {
+      frames_.erase(frames_.begin());
+    }
+    while (model_to_frame_.size() > 200) model_to_frame_.erase(model_to_frame_.begin());
+    while (plan_to_frame_.size() > 200) plan_to_frame_.erase(plan_to_frame_.begin());
+  }
+
+  std::map<uint32_t, FrameTrace> frames_;
+  std::map<uint64_t, uint32_t> model_to_frame_;  // modelV2 logMonoTime -> frameId
+  std::map<uint64_t, uint32_t> plan_to_frame_;   // longitudinalPlan logMonoTime -> frameId
+  uint32_t pending_frame_ = 0;
+  std::array<std::vector<double>, NUM_STAGES> samples_;
+};
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  SubMaster sm({"roadCameraState", "modelV2", "longitudinalPlan", "controlsState", "sendcan"});
+  LatencyTracker tracker;
+
+  double last_report = millis_since_boot();
+  while (true) {
+    // batched drain so no event in the chain is ever skipped
+    for (const auto &e : sm.drainBatch(100)) {
+      tracker.handle(e.name, e.event);
+    }
+    sm.releaseDrained();
+
+    if (millis_since_boot() - last_report > 5000) {
+      tracker.report();
+      last_report = millis_since_boot();
+    }
+  }
+  return 0;
+}
@@ -15,7 +15,8 @@ import json
 import os
 import sys
 import tempfile
-import shutil
+import threading
+from concurrent.futures import ThreadPoolExecutor
 
 from openpilot.common.hardware.hw import Paths
 from openpilot.tools.lib.api import CommaApi, UnauthorizedError, APIError
@@ -44,10 +45,114 @@ def cache_file_path(url):
   return os.path.join(Paths.download_cache_root(), hashlib.sha256(url_without_query.encode()).hexdigest())
 
 
+# content-addressed store: the bytes live once under cas/<sha256> and every
+# URL cache entry is a hardlink to that blob, so the same segment fetched
+# through different mirrors or signed URLs occupies disk once. Set
+# COMMA_CACHE_SIZE_MB to bound the cache; least recently used entries are
+# evicted after each download (0 = unlimited).
+def cas_blob_path(digest):
+  return os.path.join(Paths.download_cache_root(), "cas", digest)
+
+
+def _file_sha256(path):
+  h = hashlib.sha256()
+  with open(path, 'rb') as f:
+    for chunk in iter(lambda: f.read(1024 * 1024), b''):
+      h.update(chunk)
+  return h.hexdigest()
+
+
+def _link_into_cache(tmp_path, local_path):
+  digest = _file_sha256(tmp_path)
+  blob = cas_blob_path(digest)
+  os.makedirs(os.path.dirname(blob), exist_ok=True)
+  if not os.path.exists(blob):
+    try:
+      os.link(tmp_path, blob)
+    except FileExistsError:
+      pass  # another process downloaded the same content concurrently
+  os.unlink(tmp_path)
+  # link + rename so a concurrent download of the same URL replaces atomically
+  tmp_link = f"{blob}.link.{os.getpid()}"
+  os.link(blob, tmp_link)
+  os.replace(tmp_link, local_path)
+
+
+def _prune_cache():
+  limit = int(os.environ.get("COMMA_CACHE_SIZE_MB", "0")) * 1024 * 1024
+  if limit <= 0:
+    return
+  root = Paths.download_cache_root()
+  try:
+    entries = []
+    seen_inodes = {}
+    for name in os.listdir(root):
+      path = os.path.join(root, name)
+      if not os.path.isfile(path):
+        continue
+      st = os.stat(path)
+      entries.append((st.st_mtime, path))
+      seen_inodes[st.st_ino] = st.st_size
+    # hardlinked entries share an inode, so count each blob's bytes once
+    total = sum(seen_inodes.values())
+    for _, path in sorted(entries):
+      if total <= limit:
+        break
+      st = os.stat(path)
+      os.unlink(path)
+      if st.st_nlink <= 2:  # last URL entry for this blob
+        total -= st.st_size
+    # drop blobs no URL entry references anymore
+    cas_dir = os.path.join(root, "cas")
+    if os.path.isdir(cas_dir):
+      for name in os.listdir(cas_dir):
+        blob = os.path.join(cas_dir, name)
+        if os.stat(blob).st_nlink == 1:
+          os.unlink(blob)
+  except OSError:
+    pass  # pruning is best effort; a concurrent tool may be mutating the cache
+
+
 def cmd_route_files(args):
   api_call(lambda api: api.get(f"v1/route/{args.route}/files"))
 
 
+def _download_parallel(pool, url, total, tmp_path, parallelism):
+  """Fetch the file as concurrent Range requests written into one sparse temp
+  file. Each connection streams its own slice, so throughput scales with
+  parallelism instead of being capped by a single TCP stream."""
+  chunk = (total + parallelism - 1) // parallelism
+  progress = [0] * parallelism
+  lock = threading.Lock()
+
+  with open(tmp_path, 'wb') as f:
+    f.truncate(total)
+
+  def fetch(i):
+    start = i * chunk
+    end = min(start + chunk, total) - 1
+    if start > end:
+      return
+    r = pool.request("GET", url, headers={"Range": f"bytes={start}-{end}"}, preload_content=False)
+    try:
+      if r.status != 206:
+        raise RuntimeError(f"HTTP {r.status} for range request")
+      with open(tmp_path, 'r+b') as f:
+        f.seek(start)
+        for data in r.stream(1024 * 1024):
+          f.write(data)
+          with lock:
+            progress[i] += len(data)
+            sys.stderr.write(f"PROGRESS:{sum(progress)}:{total}\n")
+            sys.stderr.flush()
+    finally:
+      r.release_conn()
+
+  with ThreadPoolExecutor(max_workers=parallelism) as executor:
+    for future in [executor.submit(fetch, i) for i in range(parallelism)]:
+      future.result()
+
+
 def cmd_download(args):
   url = args.url
   use_cache = not args.no_cache
@@ -55,6 +160,10 @@ def cmd_download(args):
   if use_cache:
     local_path = cache_file_path(url)
     if os.path.exists(local_path):
+      try:
+        os.utime(local_path, None)  # mark as recently used for LRU eviction
+      except OSError:
+        pass
       sys.stdout.write(local_path + "\n")
       sys.stdout.flush()
       return
@@ -78,17 +187,28 @@ def cmd_download(args):
     os.makedirs(Paths.download_cache_root(), exist_ok=True)
     tmp_fd, tmp_path = tempfile.mkstemp(dir=Paths.download_cache_root())
     try:
-      downloaded = 0
-      chunk_size = 1024 * 1024
-      with os.fdopen(tmp_fd, 'wb') as f:
-        for data in r.stream(chunk_size):
-          f.write(data)
-          downloaded += len(data)
-          sys.stderr.write(f"PROGRESS:{downloaded}:{total}\n")
-          sys.stderr.flush()
+      # Parallel range requests when the server supports them and the file is
+      # big enough to amortize the extra connections; readahead across files
+      # comes from the replay segment cache window, which downloads segments
+      # ahead of the playback position.
+      accept_ranges = r.headers.get('accept-ranges', '').lower() == 'bytes'
+      if accept_ranges and args.parallel > 1 and total >= 8 * 1024 * 1024:
+        os.close(tmp_fd)
+        r.release_conn()
+        _download_parallel(URLFile.pool_manager(), url, total, tmp_path, args.parallel)
+      else:
+        downloaded = 0
+        chunk_size = 1024 * 1024
+        with os.fdopen(tmp_fd, 'wb') as f:
+          for data in r.stream(chunk_size):
+            f.write(data)
+            downloaded += len(data)
+            sys.stderr.write(f"PROGRESS:{downloaded}:{total}\n")
+            sys.stderr.flush()
 
       if use_cache:
-        shutil.move(tmp_path, local_path)
+        _link_into_cache(tmp_path, local_path)
+        _prune_cache()
         sys.stdout.write(local_path + "\n")
       else:
         sys.stdout.write(tmp_path + "\n")
@@ -137,6 +257,7 @@ def main():
   p_dl = subparsers.add_parser("download")
   p_dl.add_argument("url")
   p_dl.add_argument("--no-cache", action="store_true")
+  p_dl.add_argument("--parallel", type=int, default=int(os.environ.get("FILEREADER_PARALLEL", "4")))
   p_dl.set_defaults(func=cmd_download)
 
   p_dev = subparsers.add_parser("devices")
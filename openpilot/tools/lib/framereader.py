@@ -10,6 +10,13 @@ from openpilot.tools.lib.filereader import FileReader, resolve_name
 from openpilot.tools.lib.exceptions import DataUnreadableError
 from openpilot.tools.lib.vidindex import hevc_index
 
+try:
+  # native decoder over tools/replay's FrameReader (hardware decode where
+  # available, no ffmpeg subprocess); built by scons, so not always around
+  from openpilot.tools.replay.clip_frames_pyx import ClipFrameSource
+except ImportError:
+  ClipFrameSource = None
+
 logger = logging.getLogger("tools")
 
 HEVC_SLICE_B = 0
@@ -151,18 +158,38 @@ def FrameIterator(fn: str, index_data: dict|None=None, pix_fmt: str = "rgb24",
 class FrameReader:
   def __init__(self, fn: str, index_data: dict|None = None, cache_size: int = 30,
                pix_fmt: str = "rgb24", hwaccel="auto", loglevel="quiet"):
-    self.decoder = FfmpegDecoder(fn, index_data=index_data, pix_fmt=pix_fmt, hwaccel=hwaccel, loglevel=loglevel)
-    self.iframes = self.decoder.iframes
     self._cache: LRUCache = LRUCache(cache_size)
-    self.w, self.h, self.frame_count, = self.decoder.w, self.decoder.h, self.decoder.frame_count
     self.pix_fmt = pix_fmt
 
+    # nv12 requests go through the native decoder when the binding is built:
+    # frames come back with a single nogil call instead of a subprocess
+    self._native = None
+    if pix_fmt == "nv12" and index_data is None and ClipFrameSource is not None:
+      try:
+        self._native = ClipFrameSource(resolve_name(fn), hwaccel == "none")
+      except RuntimeError:
+        logger.warning("native decode failed for %s, falling back to ffmpeg", fn)
+
+    if self._native is not None:
+      self.decoder = None
+      self.iframes = None
+      self.w, self.h, self.frame_count = self._native.width, self._native.height, len(self._native)
+    else:
+      self.decoder = FfmpegDecoder(fn, index_data=index_data, pix_fmt=pix_fmt, hwaccel=hwaccel, loglevel=loglevel)
+      self.iframes = self.decoder.iframes
+      self.w, self.h, self.frame_count = self.decoder.w, self.decoder.h, self.decoder.frame_count
+
     self.it: Iterator[tuple[int, np.ndarray]] | None = None
     self.fidx = -1
 
   def get(self, fidx:int):
     if fidx in self._cache:  # If frame is cached, return it
       return self._cache[fidx]
+    if self._native is not None:
+      frame = np.empty(self.w * self.h * 3 // 2, dtype=np.uint8)
+      self._native.get_into(fidx, frame)
+      self._cache[fidx] = frame
+      return frame
     read_start = self.decoder.get_gop_start(fidx)
     if not self.it or fidx < self.fidx or read_start != self.decoder.get_gop_start(self.fidx):  # If the frame is in a different GOP, reset the iterator
       self.it = self.decoder.get_iterator(read_start)
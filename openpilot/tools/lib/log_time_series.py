@@ -76,6 +76,23 @@ def msgs_to_time_series(msgs):
   return values
 
 
+def segments_to_time_series(segment_paths, fields, max_threads=0):
+  """
+    Extract scalar field paths (e.g. "carState.vEgo") straight from rlog segments
+    into numpy arrays using the native replay LogReader, parallel across segments.
+    Much faster than msgs_to_time_series when the fields of interest are known up
+    front, since no python message objects are built.
+  """
+  from openpilot.tools.replay.extract_pyx import extract_columns
+  values = {}
+  for spec, t_raw, v_raw in extract_columns(list(segment_paths), list(fields), max_threads):
+    values[spec] = {
+      "t": np.frombuffer(t_raw, dtype=np.uint64) / 1e9,
+      "value": np.frombuffer(v_raw, dtype=np.float64),
+    }
+  return values
+
+
 if __name__ == "__main__":
   import sys
   from openpilot.tools.lib.logreader import LogReader
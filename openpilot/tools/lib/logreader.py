@@ -131,6 +131,34 @@ class _LogFileReader:
         yield ent
 
 
+class _NativeLogFileReader:
+  """Reads one log with tools/replay's C++ LogReader instead of pycapnp.
+
+  Events are parsed and sorted natively; pycapnp readers are created lazily
+  per event as zero-copy views into the native buffer. An optional service
+  list is pushed down to raw event framing, so filtered-out services are
+  never parsed at all.
+  """
+
+  def __init__(self, fn, services: list[str] | None = None):
+    from openpilot.tools.replay.logreader_pyx import NativeLog
+
+    filters = None
+    if services is not None:
+      # union discriminants from the capnp schema; 0xffff marks non-union fields
+      discriminants = {f.name: f.discriminantValue for f in capnp_log.Event.schema.node.struct.fields if f.discriminantValue != 0xffff}
+      filters = [False] * (max(discriminants.values()) + 1)
+      for service in services:
+        filters[discriminants[service]] = True
+
+    self._log = NativeLog(fn, filters)
+
+  def __iter__(self) -> Iterator[capnp._DynamicStructReader]:
+    for buf in self._log:
+      with capnp_log.Event.from_bytes(buf) as evt:
+        yield CachedEventReader(evt)
+
+
 class ReadMode(enum.StrEnum):
   RLOG = "r"  # only read rlogs
   QLOG = "q"  # only read qlogs
@@ -244,7 +272,8 @@ class LogReader:
     return identifiers
 
   def __init__(self, identifier: str | list[str], default_mode: ReadMode = ReadMode.RLOG,
-               sources: list[Source] | None = None, sort_by_time=False, only_union_types=False):
+               sources: list[Source] | None = None, sort_by_time=False, only_union_types=False,
+               native=False, services: list[str] | None = None):
     if sources is None:
       sources = [internal_source, comma_api_source, openpilotci_source, comma_car_segments_source]
 
@@ -256,13 +285,21 @@ class LogReader:
 
     self.sort_by_time = sort_by_time
     self.only_union_types = only_union_types
+    # native uses the C++ LogReader from tools/replay: events are parsed and
+    # sorted natively and handed to pycapnp lazily, and the optional service
+    # list is filtered during raw event framing
+    self.native = native
+    self.services = services
 
-    self.__lrs: dict[int, _LogFileReader] = {}
+    self.__lrs: dict[int, _LogFileReader | _NativeLogFileReader] = {}
     self.reset()
 
   def _get_lr(self, i):
     if i not in self.__lrs:
-      self.__lrs[i] = _LogFileReader(self.logreader_identifiers[i], sort_by_time=self.sort_by_time, only_union_types=self.only_union_types)
+      if self.native:
+        self.__lrs[i] = _NativeLogFileReader(self.logreader_identifiers[i], services=self.services)
+      else:
+        self.__lrs[i] = _LogFileReader(self.logreader_identifiers[i], sort_by_time=self.sort_by_time, only_union_types=self.only_union_types)
     return self.__lrs[i]
 
   def __iter__(self):
@@ -4,6 +4,7 @@
 
 #include <capnp/dynamic.h>
 
+#include "common/timing.h"
 #include "system/camerad/cameras/nv12_info.h"
 #include "tools/replay/util.h"
 
@@ -70,6 +71,8 @@ void CameraServer::cameraThread(Camera &cam) {
           .timestamp_eof = eidx.getTimestampEof(),
       };
       vipc_server_->send(yuv, &extra);
+      cam.last_sent_ts = nanos_since_boot();
+      if (cam.sent_frames++ == 0) cam.first_sent_ts = cam.last_sent_ts;
     } else {
       rError("camera[%d] failed to get frame: %lu", cam.type, segment_id);
     }
@@ -109,6 +112,12 @@ void CameraServer::pushFrame(CameraType type, FrameReader *fr, const Event *even
   cam.queue.push({fr, event});
 }
 
+std::pair<uint64_t, double> CameraServer::frameStats(CameraType type) const {
+  const auto &cam = cameras_[type];
+  double seconds = (cam.last_sent_ts - cam.first_sent_ts) / 1e9;
+  return {cam.sent_frames, seconds > 0 ? cam.sent_frames / seconds : 0.0};
+}
+
 void CameraServer::waitForSent() {
   while (publishing_ > 0) {
     std::this_thread::yield();
@@ -16,6 +16,8 @@ public:
   ~CameraServer();
   void pushFrame(CameraType type, FrameReader* fr, const Event *event);
   void waitForSent();
+  // {frames sent, decode+publish fps} for the perf report
+  std::pair<uint64_t, double> frameStats(CameraType type) const;
 
 protected:
   struct Camera {
@@ -26,6 +28,9 @@ protected:
     std::thread thread;
     SafeQueue<std::pair<FrameReader*, const Event *>> queue;
     std::set<VisionBuf *> cached_buf;
+    uint64_t sent_frames = 0;
+    uint64_t first_sent_ts = 0;
+    uint64_t last_sent_ts = 0;
   };
   void startVipcServer();
   void cameraThread(Camera &cam);
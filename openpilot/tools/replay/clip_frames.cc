@@ -0,0 +1,33 @@
+#include "tools/replay/clip_frames.h"
+
+#include <cstring>
+
+#include "system/camerad/cameras/nv12_info.h"
+
+bool ClipFrameSource::load(const std::string &url, bool no_hw_decoder) {
+  if (!fr_.load(RoadCam, url, no_hw_decoder, nullptr, true)) {
+    return false;
+  }
+
+  auto [stride, y_height, uv_height_, buffer_size] = get_nv12_info(fr_.width, fr_.height);
+  (void)uv_height_;  // unused, same as replay
+  buf_.allocate(buffer_size);
+  buf_.init_yuv(fr_.width, fr_.height, stride, stride * y_height);
+  return true;
+}
+
+bool ClipFrameSource::get(int idx, uint8_t *dst) {
+  if (!fr_.get(idx, &buf_)) {
+    return false;
+  }
+
+  // repack the stride-aligned decode buffer into tightly packed NV12
+  uint8_t *out = dst;
+  for (int r = 0; r < fr_.height; ++r, out += fr_.width) {
+    memcpy(out, buf_.y + (size_t)r * buf_.stride, fr_.width);
+  }
+  for (int r = 0; r < fr_.height / 2; ++r, out += fr_.width) {
+    memcpy(out, buf_.uv + (size_t)r * buf_.stride, fr_.width);
+  }
+  return true;
+}
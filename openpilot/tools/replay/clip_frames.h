@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+#include "tools/replay/framereader.h"
+
+// Frame source for tools/clip and tools/lib: decodes camera segments with
+// FrameReader (hardware decode where available) instead of piping whole
+// segments through an ffmpeg subprocess. Frames come out packed NV12, ready
+// for vipc.send().
+class ClipFrameSource {
+public:
+  bool load(const std::string &url, bool no_hw_decoder = false);
+  // decodes frame idx and packs it into dst (frameSize() bytes); sequential
+  // access reuses decoder state, so only seeks pay a GOP re-decode
+  bool get(int idx, uint8_t *dst);
+  int width() const { return fr_.width; }
+  int height() const { return fr_.height; }
+  size_t frameCount() const { return fr_.getFrameCount(); }
+  size_t frameSize() const { return (size_t)fr_.width * fr_.height * 3 / 2; }
+
+private:
+  FrameReader fr_;
+  VisionBuf buf_;
+};
@@ -0,0 +1,62 @@
+# distutils: language = c++
+# cython: language_level = 3
+from cpython.bytes cimport PyBytes_FromStringAndSize, PyBytes_AS_STRING
+from libcpp.string cimport string
+
+cdef extern from "tools/replay/clip_frames.h":
+  cdef cppclass c_ClipFrameSource "ClipFrameSource":
+    c_ClipFrameSource() except +
+    bint load(const string &url, bint no_hw_decoder) nogil except +
+    bint get(int idx, unsigned char *dst) nogil
+    int width()
+    int height()
+    size_t frameCount()
+    size_t frameSize()
+
+
+cdef class ClipFrameSource:
+  """Decodes one camera segment with the native FrameReader; get() returns
+  packed NV12 bytes ready for vipc.send()."""
+  cdef c_ClipFrameSource *src
+
+  def __cinit__(self, str url, bint no_hw_decoder=False):
+    self.src = new c_ClipFrameSource()
+    cdef string c_url = url.encode()
+    cdef bint ok
+    with nogil:
+      ok = self.src.load(c_url, no_hw_decoder)
+    if not ok:
+      raise RuntimeError(f"failed to load {url}")
+
+  def __dealloc__(self):
+    del self.src
+
+  @property
+  def width(self):
+    return self.src.width()
+
+  @property
+  def height(self):
+    return self.src.height()
+
+  def __len__(self):
+    return self.src.frameCount()
+
+  def get(self, int idx) -> bytes:
+    cdef bytes out = PyBytes_FromStringAndSize(NULL, self.src.frameSize())
+    cdef unsigned char *dst = <unsigned char *>PyBytes_AS_STRING(out)
+    cdef bint ok
+    with nogil:
+      ok = self.src.get(idx, dst)
+    if not ok:
+      raise RuntimeError(f"failed to decode frame {idx}")
+    return out
+
+  def get_into(self, int idx, unsigned char[::1] out):
+    """Decode frame idx straight into a caller-provided buffer of frameSize() bytes."""
+    assert <size_t>out.shape[0] == self.src.frameSize()
+    cdef bint ok
+    with nogil:
+      ok = self.src.get(idx, &out[0])
+    if not ok:
+      raise RuntimeError(f"failed to decode frame {idx}")
@@ -32,6 +32,7 @@ const std::initializer_list<std::pair<std::string, std::string>> keyboard_shortc
   {
     {"enter", "Enter seek request"},
     {"+/-", "Playback speed"},
+    {"p", "Write perf report"},
     {"q", "Exit"},
   },
 };
@@ -350,6 +351,10 @@ void ConsoleUI::handleKey(char c) {
     replay->seekTo(+10, true);
   } else if (c == 'S') {
     replay->seekTo(-10, true);
+  } else if (c == 'p') {
+    std::string report = replay->perfReportJson();
+    util::write_file("/tmp/replay_perf.json", report.data(), report.size(), O_WRONLY | O_CREAT | O_TRUNC);
+    rWarning("perf report written to /tmp/replay_perf.json");
   } else if (c == ' ') {
     pauseReplay(!replay->isPaused());
   }
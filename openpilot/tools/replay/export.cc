@@ -0,0 +1,78 @@
+#include "tools/replay/export.h"
+
+#include <algorithm>
+#include <optional>
+#include <sstream>
+
+#include <capnp/dynamic.h>
+
+#include "common/util.h"
+#include "tools/replay/extract.h"
+
+using columnar::toDouble;
+using columnar::whichFromService;
+
+ColumnExporter::ColumnExporter(const std::string &out_dir, const std::vector<std::string> &fields) : out_dir_(out_dir) {
+  for (const auto &spec : fields) {
+    auto path = split(spec, '.');
+    if (path.size() < 2 || !whichFromService(path[0])) {
+      rWarning("export: skipping invalid field spec '%s'", spec.c_str());
+      continue;
+    }
+
+    auto column = std::make_unique<Column>();
+    column->spec = spec;
+    column->path.assign(path.begin() + 1, path.end());
+    columns_by_which_[*whichFromService(path[0])].push_back(column.get());
+    columns_.push_back(std::move(column));
+
+    if (std::find(services_.begin(), services_.end(), path[0]) == services_.end()) {
+      services_.push_back(path[0]);
+    }
+  }
+}
+
+bool ColumnExporter::handle(const Event *e) {
+  auto it = columns_by_which_.find(e->which);
+  if (it == columns_by_which_.end()) return false;
+
+  capnp::FlatArrayMessageReader reader(e->data);
+  auto event = reader.getRoot<capnp::DynamicStruct>(capnp::Schema::from<cereal::Event>());
+  for (Column *column : it->second) {
+    capnp::DynamicValue::Reader value = event.get(kj::StringPtr(column->path[0]));
+    for (size_t i = 1; i < column->path.size() && value.getType() == capnp::DynamicValue::STRUCT; ++i) {
+      value = value.as<capnp::DynamicStruct>().get(kj::StringPtr(column->path[i]));
+    }
+    if (auto v = toDouble(value)) {
+      column->mono_times.push_back(e->mono_time);
+      column->values.push_back(*v);
+    }
+  }
+  return true;
+}
+
+bool ColumnExporter::write() const {
+  if (!util::create_directories(out_dir_, 0755)) {
+    rError("export: failed to create output directory %s", out_dir_.c_str());
+    return false;
+  }
+
+  std::ostringstream schema;
+  schema << "{\"columns\": [";
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    const auto &column = *columns_[i];
+    std::string base = out_dir_ + "/" + column.spec;
+    util::write_file((base + ".t").c_str(), column.mono_times.data(), column.mono_times.size() * sizeof(uint64_t), O_WRONLY | O_CREAT | O_TRUNC);
+    util::write_file((base + ".v").c_str(), column.values.data(), column.values.size() * sizeof(double), O_WRONLY | O_CREAT | O_TRUNC);
+    schema << (i ? ", " : "")
+           << "{\"name\": \"" << column.spec << "\", \"rows\": " << column.values.size()
+           << ", \"mono_time\": {\"file\": \"" << column.spec << ".t\", \"dtype\": \"uint64\"}"
+           << ", \"value\": {\"file\": \"" << column.spec << ".v\", \"dtype\": \"float64\"}}";
+    rInfo("export: %s (%zu rows)", column.spec.c_str(), column.values.size());
+  }
+  schema << "]}\n";
+
+  std::string schema_str = schema.str();
+  util::write_file((out_dir_ + "/schema.json").c_str(), schema_str.data(), schema_str.size(), O_WRONLY | O_CREAT | O_TRUNC);
+  return true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tools/replay/logreader.h"
+
+// Single-pass columnar export: selected scalar fields are appended to
+// in-memory columns as events stream by, then written out as one raw native
+// array per column plus a schema.json, so Python analytics can np.memmap the
+// columns directly instead of replaying msgq traffic.
+class ColumnExporter {
+public:
+  // field specs are dotted capnp paths rooted at the event, e.g. "carState.vEgo"
+  ColumnExporter(const std::string &out_dir, const std::vector<std::string> &fields);
+  // returns true when the event belongs to an exported service (consume, don't publish)
+  bool handle(const Event *e);
+  bool write() const;
+  const std::vector<std::string> &services() const { return services_; }
+
+private:
+  struct Column {
+    std::string spec;
+    std::vector<std::string> path;  // path components below the service root
+    std::vector<uint64_t> mono_times;
+    std::vector<double> values;
+  };
+
+  std::string out_dir_;
+  std::vector<std::string> services_;
+  std::vector<std::unique_ptr<Column>> columns_;
+  std::map<cereal::Event::Which, std::vector<Column *>> columns_by_which_;
+};
@@ -0,0 +1,111 @@
+#include "tools/replay/extract.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "tools/replay/util.h"
+
+namespace columnar {
+
+std::optional<cereal::Event::Which> whichFromService(const std::string &service) {
+  for (auto field : capnp::Schema::from<cereal::Event>().getUnionFields()) {
+    if (field.getProto().getName() == service) {
+      return (cereal::Event::Which)field.getProto().getDiscriminantValue();
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<double> toDouble(const capnp::DynamicValue::Reader &value) {
+  switch (value.getType()) {
+    case capnp::DynamicValue::BOOL: return value.as<bool>();
+    case capnp::DynamicValue::INT: return value.as<int64_t>();
+    case capnp::DynamicValue::UINT: return value.as<uint64_t>();
+    case capnp::DynamicValue::FLOAT: return value.as<double>();
+    case capnp::DynamicValue::ENUM: return value.as<capnp::DynamicEnum>().getRaw();
+    default: return std::nullopt;
+  }
+}
+
+namespace {
+
+struct ColumnSpec {
+  std::string spec;
+  cereal::Event::Which which;
+  std::vector<std::string> path;  // path components below the service root
+};
+
+void extractSegment(const std::string &segment, const std::vector<bool> &filters,
+                    const std::vector<ColumnSpec> &specs, std::vector<Column> &columns) {
+  LogReader log(filters);
+  if (!log.load(segment, nullptr, true)) {
+    rWarning("extract: failed to load %s", segment.c_str());
+    return;
+  }
+
+  for (const Event &e : log.events) {
+    capnp::FlatArrayMessageReader reader(e.data);
+    auto event = reader.getRoot<capnp::DynamicStruct>(capnp::Schema::from<cereal::Event>());
+    for (size_t i = 0; i < specs.size(); ++i) {
+      const ColumnSpec &spec = specs[i];
+      if (spec.which != e.which) continue;
+
+      capnp::DynamicValue::Reader value = event.get(kj::StringPtr(spec.path[0]));
+      for (size_t j = 1; j < spec.path.size() && value.getType() == capnp::DynamicValue::STRUCT; ++j) {
+        value = value.as<capnp::DynamicStruct>().get(kj::StringPtr(spec.path[j]));
+      }
+      if (auto v = toDouble(value)) {
+        columns[i].mono_times.push_back(e.mono_time);
+        columns[i].values.push_back(*v);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+std::vector<Column> extractColumns(const std::vector<std::string> &segments,
+                                   const std::vector<std::string> &fields, int max_threads) {
+  std::vector<ColumnSpec> specs;
+  std::vector<bool> filters(capnp::Schema::from<cereal::Event>().getUnionFields().size(), false);
+  for (const auto &field : fields) {
+    auto path = split(field, '.');
+    auto which = path.size() >= 2 ? whichFromService(path[0]) : std::nullopt;
+    if (!which) {
+      rWarning("extract: skipping invalid field spec '%s'", field.c_str());
+      continue;
+    }
+    specs.push_back({field, *which, {path.begin() + 1, path.end()}});
+    filters[(size_t)*which] = true;
+  }
+
+  std::vector<std::vector<Column>> per_segment(segments.size(), std::vector<Column>(specs.size()));
+  std::atomic<size_t> next_segment = 0;
+  int n_threads = max_threads > 0 ? max_threads : std::thread::hardware_concurrency();
+  n_threads = std::max(1, std::min<int>(n_threads, segments.size()));
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < n_threads; ++i) {
+    threads.emplace_back([&]() {
+      for (size_t seg; (seg = next_segment++) < segments.size(); ) {
+        extractSegment(segments[seg], filters, specs, per_segment[seg]);
+      }
+    });
+  }
+  for (auto &t : threads) t.join();
+
+  // concatenate in segment order so each column stays sorted by mono_time
+  std::vector<Column> result(specs.size());
+  for (size_t i = 0; i < specs.size(); ++i) {
+    result[i].spec = specs[i].spec;
+    for (const auto &seg_columns : per_segment) {
+      const Column &c = seg_columns[i];
+      result[i].mono_times.insert(result[i].mono_times.end(), c.mono_times.begin(), c.mono_times.end());
+      result[i].values.insert(result[i].values.end(), c.values.begin(), c.values.end());
+    }
+  }
+  return result;
+}
+
+}  // namespace columnar
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <capnp/dynamic.h>
+
+#include "tools/replay/logreader.h"
+
+namespace columnar {
+
+// helpers shared with the --export path in export.cc
+std::optional<cereal::Event::Which> whichFromService(const std::string &service);
+std::optional<double> toDouble(const capnp::DynamicValue::Reader &value);
+
+struct Column {
+  std::string spec;
+  std::vector<uint64_t> mono_times;
+  std::vector<double> values;
+};
+
+// Loads the given rlog segments with LogReader (service filters pushed down to
+// raw event framing) and extracts the dotted field paths into one column per
+// spec, concatenated in segment order. Segments load in parallel;
+// max_threads <= 0 uses the hardware concurrency.
+std::vector<Column> extractColumns(const std::vector<std::string> &segments,
+                                   const std::vector<std::string> &fields, int max_threads = 0);
+
+}  // namespace columnar
@@ -0,0 +1,40 @@
+# distutils: language = c++
+# cython: language_level = 3
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+cdef extern from "tools/replay/extract.h" namespace "columnar":
+  cdef cppclass Column:
+    string spec
+    vector[unsigned long long] mono_times
+    vector[double] values
+  vector[Column] c_extractColumns "columnar::extractColumns" (const vector[string] &segments,
+                                                              const vector[string] &fields,
+                                                              int max_threads) nogil except +
+
+
+def extract_columns(segments, fields, int max_threads=0):
+  """Extract dotted field paths from rlog segments into columnar buffers.
+
+  Returns a list of (spec, mono_times, values) tuples, where mono_times is
+  raw uint64 nanoseconds and values raw float64, both as bytes ready for
+  np.frombuffer."""
+  cdef vector[string] c_segments
+  cdef vector[string] c_fields
+  for s in segments:
+    c_segments.push_back(s.encode())
+  for f in fields:
+    c_fields.push_back(f.encode())
+
+  cdef vector[Column] columns
+  with nogil:
+    columns = c_extractColumns(c_segments, c_fields, max_threads)
+
+  out = []
+  cdef size_t i, n
+  for i in range(columns.size()):
+    n = columns[i].values.size()
+    out.append((columns[i].spec.decode(),
+                (<const char *>columns[i].mono_times.data())[:n * sizeof(unsigned long long)],
+                (<const char *>columns[i].values.data())[:n * sizeof(double)]))
+  return out
@@ -1,5 +1,8 @@
 #include "tools/replay/framereader.h"
 
+#include <sys/stat.h>
+
+#include <cstring>
 #include <map>
 #include <memory>
 #include <tuple>
@@ -62,10 +65,63 @@ struct DecoderManager {
 
 DecoderManager decoder_manager;
 
+// packet index sidecar ("<file>.fridx"): the flags/pos table built by the
+// demux scan, persisted next to the video so reopening a segment skips the
+// full av_read_frame pass. Validated against the video's size and mtime; a
+// stale, truncated or unwritable sidecar just means we scan again.
+constexpr uint32_t PACKET_INDEX_MAGIC = 0x58495246;  // "FRIX"
+constexpr uint32_t PACKET_INDEX_VERSION = 1;
+
+struct PacketIndexHeader {
+  uint32_t magic;
+  uint32_t version;
+  int64_t file_size;
+  int64_t mtime;
+  uint32_t count;
+};
+
+bool loadPacketIndex(const std::string &file, std::vector<FrameReader::PacketInfo> *packets) {
+  struct stat st = {};
+  if (stat(file.c_str(), &st) != 0) return false;
+
+  std::string data = util::read_file(file + ".fridx");
+  if (data.size() < sizeof(PacketIndexHeader)) return false;
+
+  PacketIndexHeader hdr;
+  memcpy(&hdr, data.data(), sizeof(hdr));
+  if (hdr.magic != PACKET_INDEX_MAGIC || hdr.version != PACKET_INDEX_VERSION ||
+      hdr.file_size != (int64_t)st.st_size || hdr.mtime != (int64_t)st.st_mtime ||
+      data.size() != sizeof(hdr) + hdr.count * sizeof(FrameReader::PacketInfo)) {
+    return false;
+  }
+
+  packets->resize(hdr.count);
+  memcpy(packets->data(), data.data() + sizeof(hdr), hdr.count * sizeof(FrameReader::PacketInfo));
+  return hdr.count > 0;
+}
+
+void savePacketIndex(const std::string &file, const std::vector<FrameReader::PacketInfo> &packets) {
+  struct stat st = {};
+  if (stat(file.c_str(), &st) != 0) return;
+
+  PacketIndexHeader hdr = {
+    .magic = PACKET_INDEX_MAGIC,
+    .version = PACKET_INDEX_VERSION,
+    .file_size = (int64_t)st.st_size,
+    .mtime = (int64_t)st.st_mtime,
+    .count = (uint32_t)packets.size(),
+  };
+  std::string data(sizeof(hdr) + packets.size() * sizeof(FrameReader::PacketInfo), '\0');
+  memcpy(data.data(), &hdr, sizeof(hdr));
+  memcpy(data.data() + sizeof(hdr), packets.data(), packets.size() * sizeof(FrameReader::PacketInfo));
+  util::write_file((file + ".fridx").c_str(), data.data(), data.size(), O_WRONLY | O_CREAT | O_TRUNC);
+}
+
 }  // namespace
 
 FrameReader::FrameReader() {
   av_log_set_level(AV_LOG_QUIET);
+  frame_cache_size_ = atoi(util::getenv("REPLAY_FRAME_CACHE", "0").c_str());
 }
 
 FrameReader::~FrameReader() {
@@ -104,13 +160,18 @@ bool FrameReader::loadFromFile(CameraType type, const std::string &file, bool no
   width = decoder_->width;
   height = decoder_->height;
 
-  AVPacket pkt;
-  packets_info.reserve(60 * 20);  // 20fps, one minute
-  while (!(abort && *abort) && av_read_frame(input_ctx, &pkt) == 0) {
-    if (pkt.stream_index == video_stream_idx_) {
-      packets_info.emplace_back(PacketInfo{.flags = pkt.flags, .pos = pkt.pos});
+  if (!loadPacketIndex(file, &packets_info)) {
+    AVPacket pkt;
+    packets_info.reserve(60 * 20);  // 20fps, one minute
+    while (!(abort && *abort) && av_read_frame(input_ctx, &pkt) == 0) {
+      if (pkt.stream_index == video_stream_idx_) {
+        packets_info.emplace_back(PacketInfo{.flags = pkt.flags, .pos = pkt.pos});
+      }
+      av_packet_unref(&pkt);
+    }
+    if (!(abort && *abort) && !packets_info.empty()) {
+      savePacketIndex(file, packets_info);
     }
-    av_packet_unref(&pkt);
   }
   avio_seek(input_ctx->pb, 0, SEEK_SET);
   return !packets_info.empty();
@@ -120,7 +181,33 @@ bool FrameReader::get(int idx, VisionBuf *buf) {
   if (!buf || idx < 0 || idx >= packets_info.size()) {
     return false;
   }
-  return decoder_->decode(this, idx, buf);
+
+  if (frame_cache_size_ > 0) {
+    if (auto it = frame_cache_.find(idx); it != frame_cache_.end()) {
+      lru_order_.splice(lru_order_.begin(), lru_order_, it->second.first);
+      const CachedFrame &f = it->second.second;
+      memcpy(buf->y, f.y.data(), f.y.size());
+      memcpy(buf->uv, f.uv.data(), f.uv.size());
+      return true;
+    }
+  }
+
+  if (!decoder_->decode(this, idx, buf)) {
+    return false;
+  }
+
+  if (frame_cache_size_ > 0) {
+    if ((int)frame_cache_.size() >= frame_cache_size_) {
+      frame_cache_.erase(lru_order_.back());
+      lru_order_.pop_back();
+    }
+    lru_order_.push_front(idx);
+    CachedFrame f;
+    f.y.assign(buf->y, buf->y + (size_t)buf->stride * height);
+    f.uv.assign(buf->uv, buf->uv + (size_t)buf->stride * height / 2);
+    frame_cache_.emplace(idx, std::make_pair(lru_order_.begin(), std::move(f)));
+  }
+  return true;
 }
 
 // class VideoDecoder
@@ -150,7 +237,11 @@ bool FFmpegVideoDecoder::open(AVCodecParameters *codecpar, bool hw_decoder) {
   height = decoder_ctx->height;
 
   if (hw_decoder && !initHardwareDecoder(HW_DEVICE_TYPE)) {
-    rWarning("No device with hardware decoder found. fallback to CPU decoding.");
+#ifndef __APPLE__
+    // no NVDEC (AMD/Intel workstations): try VAAPI before giving up on hw decode
+    if (!initHardwareDecoder(AV_HWDEVICE_TYPE_VAAPI))
+#endif
+      rWarning("No device with hardware decoder found. fallback to CPU decoding.");
   }
 
   if (avcodec_open2(decoder_ctx, decoder, nullptr) < 0) {
@@ -215,7 +306,10 @@ bool FFmpegVideoDecoder::decode(FrameReader *reader, int idx, VisionBuf *buf) {
       continue;
     }
 
-    AVFrame *frame = decodeFrame(&pkt);
+    // Only the requested frame gets a destination buffer; intermediate frames
+    // between the keyframe and idx are decoded and discarded without ever
+    // leaving the decoder (no GPU->CPU transfer).
+    AVFrame *frame = decodeFrame(&pkt, (current_idx == idx) ? buf : nullptr);
     av_packet_unref(&pkt);
     if (!frame) {
       rError("Failed to decode frame at index %d", current_idx);
@@ -230,7 +324,15 @@ bool FFmpegVideoDecoder::decode(FrameReader *reader, int idx, VisionBuf *buf) {
   return false;
 }
 
-AVFrame *FFmpegVideoDecoder::decodeFrame(AVPacket *pkt) {
+bool FFmpegVideoDecoder::decodePacket(const uint8_t *data, size_t size, VisionBuf *buf) {
+  AVPacket pkt = {};
+  pkt.data = const_cast<uint8_t *>(data);
+  pkt.size = static_cast<int>(size);
+  AVFrame *frame = decodeFrame(&pkt, buf);
+  return frame && buf && copyBuffer(frame, buf);
+}
+
+AVFrame *FFmpegVideoDecoder::decodeFrame(AVPacket *pkt, VisionBuf *buf) {
   int ret = avcodec_send_packet(decoder_ctx, pkt);
   if (ret < 0) {
     rError("Error sending a packet for decoding: %d", ret);
@@ -239,19 +341,46 @@ AVFrame *FFmpegVideoDecoder::decodeFrame(AVPacket *pkt) {
 
   ret = avcodec_receive_frame(decoder_ctx, av_frame_);
   if (ret != 0) {
-    rError("avcodec_receive_frame error: %d", ret);
+    // EAGAIN just means the decoder wants more input before emitting a frame
+    if (ret != AVERROR(EAGAIN)) rError("avcodec_receive_frame error: %d", ret);
     return nullptr;
   }
 
-  if (av_frame_->format == hw_pix_fmt && av_hwframe_transfer_data(hw_frame_, av_frame_, 0) < 0) {
+  if (av_frame_->format != hw_pix_fmt) return av_frame_;
+
+  // frames that are about to be discarded stay on the GPU
+  if (!buf) return av_frame_;
+
+  // download straight into the VisionIpc buffer: NV12 matches the buffer
+  // layout, so on success copyBuffer has nothing left to do
+  av_frame_unref(hw_frame_);
+  hw_frame_->format = AV_PIX_FMT_NV12;
+  hw_frame_->width = av_frame_->width;
+  hw_frame_->height = av_frame_->height;
+  hw_frame_->data[0] = buf->y;
+  hw_frame_->data[1] = buf->uv;
+  hw_frame_->linesize[0] = buf->stride;
+  hw_frame_->linesize[1] = buf->stride;
+  if (av_hwframe_transfer_data(hw_frame_, av_frame_, 0) == 0) {
+    return hw_frame_;
+  }
+
+  // the device can't transfer to NV12 in place; fall back to a decoder-owned
+  // frame and let copyBuffer do the conversion
+  av_frame_unref(hw_frame_);
+  if (av_hwframe_transfer_data(hw_frame_, av_frame_, 0) < 0) {
     rError("error transferring frame data from GPU to CPU");
     return nullptr;
   }
-  return (av_frame_->format == hw_pix_fmt) ? hw_frame_ : av_frame_;
+  return hw_frame_;
 }
 
 bool FFmpegVideoDecoder::copyBuffer(AVFrame *f, VisionBuf *buf) {
-  if (hw_pix_fmt == HW_PIX_FMT) {
+  // already downloaded in place by decodeFrame
+  if (f->data[0] == buf->y) return true;
+
+  // hardware downloads (CUDA/VAAPI) hand back NV12; software decode yields I420
+  if (f->format == AV_PIX_FMT_NV12) {
     for (int i = 0; i < height/2; i++) {
       memcpy(buf->y + (i*2 + 0)*buf->stride, f->data[0] + (i*2 + 0)*f->linesize[0], width);
       memcpy(buf->y + (i*2 + 1)*buf->stride, f->data[0] + (i*2 + 1)*f->linesize[0], width);
@@ -299,15 +428,23 @@ bool QcomVideoDecoder::decode(FrameReader *reader, int idx, VisionBuf *buf) {
     }
   }
   reader->prev_idx = idx;
-  bool result = false;
-  AVPacket pkt;
   msm_vidc.avctx = reader->input_ctx;
+
+  // pipelined decode: queue the whole keyframe run-up, keeping the v4l2 input
+  // port full while the block works, and only wait for the frame we want
+  msm_vidc.beginFrame(buf, idx - from_idx);
+  AVPacket pkt;
   for (int i = from_idx; i <= idx; ++i) {
-    if (av_read_frame(reader->input_ctx, &pkt) == 0) {
-      result = msm_vidc.decodeFrame(&pkt, buf) && (i == idx);
-      av_packet_unref(&pkt);
+    if (av_read_frame(reader->input_ctx, &pkt) != 0) {
+      rError("Failed to read packet at index %d", i);
+      return false;
+    }
+    bool queued = msm_vidc.queuePacket(&pkt);
+    av_packet_unref(&pkt);
+    if (!queued) {
+      return false;
     }
   }
-  return result;
+  return msm_vidc.drainFrame() == buf;
 }
 #endif
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <list>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "msgq/visionipc/visionbuf.h"
@@ -37,6 +40,16 @@ public:
     int64_t pos;
   };
   std::vector<PacketInfo> packets_info;
+
+  // decoded-frame LRU cache, REPLAY_FRAME_CACHE frames per stream (0 = off).
+  // without it every backwards scrub step re-decodes from the previous
+  // keyframe; with it a revisited frame is a pair of memcpys.
+  struct CachedFrame {
+    std::vector<uint8_t> y, uv;
+  };
+  int frame_cache_size_ = 0;
+  std::list<int> lru_order_;
+  std::unordered_map<int, std::pair<std::list<int>::iterator, CachedFrame>> frame_cache_;
 };
 
 
@@ -54,10 +67,15 @@ public:
   ~FFmpegVideoDecoder() override;
   bool open(AVCodecParameters *codecpar, bool hw_decoder) override;
   bool decode(FrameReader *reader, int idx, VisionBuf *buf) override;
+  // streaming entry point (tools/camerastream): decode one already-demuxed
+  // packet, no FrameReader or seek machinery involved. Returns true when a
+  // full frame was written to buf; false while the decoder is still buffering
+  // input (e.g. the codec header packet).
+  bool decodePacket(const uint8_t *data, size_t size, VisionBuf *buf);
 
 private:
   bool initHardwareDecoder(AVHWDeviceType hw_device_type);
-  AVFrame *decodeFrame(AVPacket *pkt);
+  AVFrame *decodeFrame(AVPacket *pkt, VisionBuf *buf);
   bool copyBuffer(AVFrame *f, VisionBuf *buf);
 
   AVFrame *av_frame_, *hw_frame_;
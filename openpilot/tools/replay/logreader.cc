@@ -8,6 +8,95 @@
 #include "tools/replay/util.h"
 #include "common/util.h"
 
+// Sidecar index format: IndexHeader followed by one IndexRecord per event, in
+// the event vector's sorted order. Records address words inside the cached
+// decompressed log, so rebuilding the vector is a single pass of emplace_backs
+// and a seek afterwards is just the usual bisect — no zstd, no capnp.
+static constexpr uint32_t INDEX_MAGIC = 0x524c4f47;  // "RLOG"
+static constexpr uint32_t INDEX_VERSION = 1;
+
+struct IndexHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t raw_size;
+  uint64_t num_events;
+};
+
+struct IndexRecord {
+  uint64_t mono_time;
+  uint64_t offset_words;
+  uint32_t size_words;
+  int32_t eidx_segnum;
+  uint16_t which;
+  uint16_t pad;
+};
+
+static std::string indexCachePath(const std::string &url) {
+  std::string dir = util::getenv("REPLAY_INDEX_DIR", "/tmp/replay_index");
+  util::create_directories(dir, 0775);
+  return dir + "/" + std::to_string(std::hash<std::string>{}(getUrlWithoutQuery(url)));
+}
+
+bool LogReader::loadFromIndex(const std::string &url, const ProgressCallback &progress) {
+  const std::string base = indexCachePath(url);
+  mapped_raw_ = util::map_file(base + ".raw");
+  util::MappedFile idx = util::map_file(base + ".idx");
+
+  const IndexHeader *hdr = (const IndexHeader *)idx.data();
+  if (!mapped_raw_ || !idx || idx.size() < sizeof(IndexHeader) ||
+      hdr->magic != INDEX_MAGIC || hdr->version != INDEX_VERSION ||
+      hdr->raw_size != mapped_raw_.size() ||
+      idx.size() != sizeof(IndexHeader) + hdr->num_events * sizeof(IndexRecord)) {
+    // drop the mapping so a fresh parse can rewrite the cache files safely
+    mapped_raw_ = util::MappedFile();
+    return false;
+  }
+
+  const IndexRecord *recs = (const IndexRecord *)(idx.data() + sizeof(IndexHeader));
+  const capnp::word *words = (const capnp::word *)mapped_raw_.data();
+  events.reserve(hdr->num_events);
+  for (uint64_t i = 0; i < hdr->num_events; ++i) {
+    const IndexRecord &r = recs[i];
+    events.emplace_back((cereal::Event::Which)r.which, r.mono_time,
+                        kj::arrayPtr(words + r.offset_words, r.size_words), r.eidx_segnum);
+  }
+  decompressed_size_ = mapped_raw_.size();
+  if (progress) {
+    progress(ProgressStage::Parsing, decompressed_size_, decompressed_size_);
+  }
+  rDebug("loaded %zu events from index %s", events.size(), base.c_str());
+  return !events.empty();
+}
+
+void LogReader::writeIndex(const std::string &url, const std::string &data) {
+  // migrated events point into the arena instead of the raw log, so a route
+  // old enough to need migration can't be indexed by offset
+  if (requires_migration) return;
+
+  const std::string base = indexCachePath(url);
+  if (util::write_file((base + ".raw").c_str(), data.data(), data.size(), O_WRONLY | O_CREAT | O_TRUNC) < 0) {
+    return;
+  }
+
+  const capnp::word *words = (const capnp::word *)data.data();
+  std::vector<IndexRecord> recs;
+  recs.reserve(events.size());
+  for (const Event &evt : events) {
+    recs.push_back({evt.mono_time, (uint64_t)(evt.data.begin() - words),
+                    (uint32_t)evt.data.size(), evt.eidx_segnum, (uint16_t)evt.which, 0});
+  }
+
+  IndexHeader hdr = {INDEX_MAGIC, INDEX_VERSION, data.size(), recs.size()};
+  std::string buf((const char *)&hdr, sizeof(hdr));
+  buf.append((const char *)recs.data(), recs.size() * sizeof(IndexRecord));
+  // the index is written last and validated against the raw size, so a
+  // partial .raw from an interrupted run is never trusted
+  const std::string tmp = base + ".idx.tmp";
+  if (util::write_file(tmp.c_str(), buf.data(), buf.size(), O_WRONLY | O_CREAT | O_TRUNC) >= 0) {
+    ::rename(tmp.c_str(), (base + ".idx").c_str());
+  }
+}
+
 bool LogReader::load(const std::string &url, std::atomic<bool> *abort, bool local_cache,
                      const ProgressCallback &progress) {
   using Clock = std::chrono::steady_clock;
@@ -17,6 +106,12 @@ bool LogReader::load(const std::string &url, std::atomic<bool> *abort, bool loca
   decompress_seconds_ = 0.0;
   parse_seconds_ = 0.0;
 
+  // mmap-backed fast path: index is only maintained for cached, unfiltered
+  // loads, where the event offsets cover the full log
+  if (local_cache && filters_.empty() && loadFromIndex(url, progress)) {
+    return true;
+  }
+
   if (progress) {
     installDownloadProgressHandler([progress](uint64_t cur, uint64_t total, bool success) {
       if (success) {
@@ -45,8 +140,12 @@ bool LogReader::load(const std::string &url, std::atomic<bool> *abort, bool loca
   decompressed_size_ = data.size();
 
   bool success = !data.empty() && load(data.data(), data.size(), abort, progress);
-  if (filters_.empty())
+  if (filters_.empty()) {
     raw_ = std::move(data);
+    if (success && local_cache && !(abort && *abort)) {
+      writeIndex(url, raw_);
+    }
+  }
   return success;
 }
 
@@ -63,7 +162,40 @@ bool LogReader::load(const char *data, size_t size, std::atomic<bool> *abort,
     if (progress) {
       progress(ProgressStage::Parsing, 0, total_bytes);
     }
+    // Filter pushdown: when a service allowlist is active, excluded events
+    // are skipped using only the segment table for framing and the raw union
+    // discriminant for dispatch — no reader construction, no traversal. The
+    // discriminant offset comes from the schema, so this tracks log.capnp.
+    const bool pushdown = !filters_.empty();
+    static const uint16_t discriminant_offset =
+        capnp::Schema::from<cereal::Event>().asStruct().getProto().getStruct().getDiscriminantOffset();
+
     while (words.size() > 0 && !(abort && *abort)) {
+      if (pushdown && words.size() >= 2) {
+        const uint32_t *tbl = (const uint32_t *)words.begin();
+        const size_t seg_words = tbl[1];
+        // single-segment struct-rooted message (every logged event); anything
+        // unusual falls through to the full reader below
+        if (tbl[0] == 0 && 1 + seg_words <= words.size() && seg_words >= 1) {
+          const capnp::word *seg = words.begin() + 1;
+          const uint64_t root = *(const uint64_t *)seg;
+          const int32_t ptr_offset = ((int32_t)(uint32_t)root) >> 2;
+          const uint32_t data_words = (root >> 32) & 0xffff;
+          const capnp::word *data = seg + 1 + ptr_offset;
+          if ((root & 3) == 0 && ptr_offset >= 0 && data + data_words <= seg + seg_words &&
+              discriminant_offset < data_words * 4) {
+            const uint16_t which = ((const uint16_t *)data)[discriminant_offset];
+            if (which == (uint16_t)cereal::Event::Which::SELFDRIVE_STATE) {
+              requires_migration = false;
+            }
+            if (which >= filters_.size() || !filters_[which]) {
+              words = kj::arrayPtr(words.begin() + 1 + seg_words, words.end());
+              continue;
+            }
+          }
+        }
+      }
+
       capnp::FlatArrayMessageReader reader(words);
       auto event = reader.getRoot<cereal::Event>();
       auto which = event.which();
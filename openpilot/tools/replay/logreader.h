@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "openpilot/cereal/gen/cpp/log.capnp.h"
+#include "common/util.h"
 #include "tools/replay/util.h"
 
 const CameraType ALL_CAMERAS[] = {RoadCam, DriverCam, WideRoadCam};
@@ -26,6 +27,11 @@ public:
   int32_t eidx_segnum;
 };
 
+// accessors for the python binding (logreader_pyx), which can't see into kj types
+inline const char *eventData(const Event &e) { return reinterpret_cast<const char *>(e.data.begin()); }
+inline size_t eventSize(const Event &e) { return e.data.size() * sizeof(capnp::word); }
+inline int eventWhich(const Event &e) { return static_cast<int>(e.which); }
+
 class LogReader {
 public:
   enum class ProgressStage {
@@ -50,8 +56,14 @@ public:
 
 private:
   void migrateOldEvents();
+  // sidecar index cache: a copy of the decompressed log plus fixed-size event
+  // records, so reloading a cached segment mmaps both files and skips zstd
+  // and capnp entirely
+  bool loadFromIndex(const std::string &url, const ProgressCallback &progress);
+  void writeIndex(const std::string &url, const std::string &data);
 
   std::string raw_;
+  util::MappedFile mapped_raw_;
   bool requires_migration = true;
   std::vector<bool> filters_;
   MonotonicBuffer buffer_{1024 * 1024};
@@ -0,0 +1,70 @@
+# distutils: language = c++
+# cython: language_level = 3
+from libcpp cimport bool as cbool
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+cdef extern from "Python.h":
+  object PyMemoryView_FromMemory(char *mem, Py_ssize_t size, int flags)
+  int PyBUF_READ
+
+cdef extern from "<atomic>" namespace "std":
+  cdef cppclass atomic_bool:
+    pass
+
+cdef extern from "tools/replay/logreader.h":
+  cdef cppclass c_Event "Event":
+    unsigned long long mono_time
+  const char *eventData(const c_Event &e)
+  size_t eventSize(const c_Event &e)
+  int eventWhich(const c_Event &e)
+  cdef cppclass c_LogReader "LogReader":
+    c_LogReader(const vector[cbool] &filters) except +
+    cbool load(const string &url, atomic_bool *abort, cbool local_cache) nogil except +
+    vector[c_Event] events
+
+
+cdef class NativeLog:
+  """One rlog parsed by the C++ LogReader.
+
+  Events stay in the native buffer; event_data() returns a zero-copy
+  memoryview into it, valid only while this object is alive. filters is an
+  optional list of bools indexed by union discriminant; when set, filtering
+  happens during raw event framing so skipped services are never parsed."""
+  cdef c_LogReader *lr
+
+  def __cinit__(self, str path, filters=None, bint local_cache=True):
+    cdef vector[cbool] c_filters
+    if filters is not None:
+      for f in filters:
+        c_filters.push_back(<cbool>bool(f))
+    self.lr = new c_LogReader(c_filters)
+    cdef string c_path = path.encode()
+    cdef cbool ok, c_cache = local_cache
+    with nogil:
+      ok = self.lr.load(c_path, NULL, c_cache)
+    if not ok:
+      raise RuntimeError(f"failed to load {path}")
+
+  def __dealloc__(self):
+    del self.lr
+
+  def __len__(self):
+    return self.lr.events.size()
+
+  def mono_time(self, size_t i):
+    assert i < self.lr.events.size()
+    return self.lr.events[i].mono_time
+
+  def which(self, size_t i) -> int:
+    assert i < self.lr.events.size()
+    return eventWhich(self.lr.events[i])
+
+  def event_data(self, size_t i):
+    assert i < self.lr.events.size()
+    return PyMemoryView_FromMemory(<char *>eventData(self.lr.events[i]), eventSize(self.lr.events[i]), PyBUF_READ)
+
+  def __iter__(self):
+    cdef size_t i
+    for i in range(self.lr.events.size()):
+      yield self.event_data(i)
@@ -9,16 +9,22 @@
 
 #include "common/prefix.h"
 #include "common/timing.h"
+#include "common/util.h"
 #include "tools/replay/consoleui.h"
+#include "tools/replay/export.h"
 #include "tools/replay/replay.h"
 #include "tools/replay/util.h"
 
 const std::string helpText =
-R"(Usage: replay [options] [route]
+R"(Usage: replay [options] [route ...]
+Queue several routes to review a multi-route drive gaplessly: each extra
+route is prefetched during the tail of the one before it.
 Options:
   -a, --allow        Whitelist of services to send (comma-separated)
   -b, --block        Blacklist of services to send (comma-separated)
   -c, --cache        Cache <n> segments in memory. Default is 5
+      --cache-mb     Cap the segment cache at <n> MB; segments farthest from
+                     playback are evicted first. Default is unlimited
   -s, --start        Start from <seconds>
   -x, --playback     Playback <speed>
       --demo         Use a demo route instead of providing your own
@@ -35,11 +41,18 @@ Options:
       --no-vipc      Do not output video
       --all          Output all messages including bookmarkButton, uiDebug, userBookmark
       --benchmark    Run in benchmark mode (process all events then exit with stats)
+      --headless     Run without UI and exit at the end of the route. Publishes on a
+                     virtual clock: unpaced by default, or at -x <speed> if given
+                     (not clamped to the UI speed range)
+      --export       Export fields to columnar files in a single headless pass instead
+                     of publishing, e.g. --export carState.vEgo,carState.aEgo
+      --export-dir   Output directory for --export. Default is replay_export
   -h, --help         Show this help message
 )";
 
 struct ReplayConfig {
   std::string route;
+  std::vector<std::string> next_routes;
   std::vector<std::string> allow;
   std::vector<std::string> block;
   std::string data_dir;
@@ -48,7 +61,10 @@ struct ReplayConfig {
   bool auto_source = false;
   int start_seconds = 0;
   int cache_segments = -1;
+  int cache_mb = -1;
   float playback_speed = -1;
+  std::vector<std::string> export_fields;
+  std::string export_dir = "replay_export";
 };
 
 bool parseArgs(int argc, char *argv[], ReplayConfig &config) {
@@ -56,6 +72,7 @@ bool parseArgs(int argc, char *argv[], ReplayConfig &config) {
       {"allow", required_argument, nullptr, 'a'},
       {"block", required_argument, nullptr, 'b'},
       {"cache", required_argument, nullptr, 'c'},
+      {"cache-mb", required_argument, nullptr, 0},
       {"start", required_argument, nullptr, 's'},
       {"playback", required_argument, nullptr, 'x'},
       {"demo", no_argument, nullptr, 0},
@@ -71,6 +88,9 @@ bool parseArgs(int argc, char *argv[], ReplayConfig &config) {
       {"no-vipc", no_argument, nullptr, 0},
       {"all", no_argument, nullptr, 0},
       {"benchmark", no_argument, nullptr, 0},
+      {"headless", no_argument, nullptr, 0},
+      {"export", required_argument, nullptr, 0},
+      {"export-dir", required_argument, nullptr, 0},
       {"help", no_argument, nullptr, 'h'},
       {nullptr, 0, nullptr, 0},  // Terminating entry
   };
@@ -85,6 +105,7 @@ bool parseArgs(int argc, char *argv[], ReplayConfig &config) {
       {"no-vipc", REPLAY_FLAG_NO_VIPC},
       {"all", REPLAY_FLAG_ALL_SERVICES},
       {"benchmark", REPLAY_FLAG_BENCHMARK},
+      {"headless", REPLAY_FLAG_HEADLESS},
   };
 
   if (argc == 1) {
@@ -106,6 +127,9 @@ bool parseArgs(int argc, char *argv[], ReplayConfig &config) {
         std::string name = cli_options[option_index].name;
         if (name == "demo") config.route = DEMO_ROUTE;
         else if (name == "auto") config.auto_source = true;
+        else if (name == "cache-mb") config.cache_mb = std::atoi(optarg);
+        else if (name == "export") config.export_fields = split(optarg, ',');
+        else if (name == "export-dir") config.export_dir = optarg;
         else config.flags |= flag_map.at(name);
         break;
       }
@@ -114,9 +138,13 @@ bool parseArgs(int argc, char *argv[], ReplayConfig &config) {
     }
   }
 
-  // Check for a route name (first positional argument)
+  // Check for a route name (first positional argument); any further
+  // positional arguments are queued for gapless multi-route playback
   if (config.route.empty() && optind < argc) {
-    config.route = argv[optind];
+    config.route = argv[optind++];
+  }
+  while (optind < argc) {
+    config.next_routes.push_back(argv[optind++]);
   }
 
   if (config.route.empty()) {
@@ -148,16 +176,42 @@ int main(int argc, char *argv[]) {
     op_prefix = std::make_unique<OpenpilotPrefix>(config.prefix);
   }
 
+  // Exporting is a single headless pass that consumes events instead of
+  // publishing them; restricting allow to the exported services lets the
+  // log parser skip everything else.
+  std::unique_ptr<ColumnExporter> exporter;
+  if (!config.export_fields.empty()) {
+    config.flags |= REPLAY_FLAG_HEADLESS | REPLAY_FLAG_NO_VIPC | REPLAY_FLAG_NO_LOOP;
+    exporter = std::make_unique<ColumnExporter>(config.export_dir, config.export_fields);
+    if (config.allow.empty()) {
+      config.allow = exporter->services();
+    }
+  }
+
   Replay replay(config.route, config.allow, config.block, nullptr, config.flags, config.data_dir, config.auto_source);
   if (config.cache_segments > 0) {
     replay.setSegmentCacheLimit(config.cache_segments);
   }
+  if (config.cache_mb > 0) {
+    replay.setCacheByteBudget(config.cache_mb * 1024ull * 1024);
+  }
   if (config.playback_speed > 0) {
-    replay.setSpeed(std::clamp(config.playback_speed, ConsoleUI::speed_array.front(), ConsoleUI::speed_array.back()));
+    // The UI speed range only applies when there is a UI; headless runs take
+    // any positive multiplier
+    if (config.flags & REPLAY_FLAG_HEADLESS) {
+      replay.setSpeed(config.playback_speed);
+    } else {
+      replay.setSpeed(std::clamp(config.playback_speed, ConsoleUI::speed_array.front(), ConsoleUI::speed_array.back()));
+    }
+  } else if (config.flags & REPLAY_FLAG_HEADLESS) {
+    replay.setSpeed(0);  // unpaced
   }
   if (!replay.load()) {
     return 1;
   }
+  for (const auto &route : config.next_routes) {
+    replay.queueRoute(route);
+  }
 
   if (config.flags & REPLAY_FLAG_BENCHMARK) {
     replay.start(config.start_seconds);
@@ -178,9 +232,22 @@ int main(int argc, char *argv[]) {
                 << event << "\n";
     }
 
+    std::string report = replay.perfReportJson();
+    util::write_file("replay_benchmark.json", report.data(), report.size(), O_WRONLY | O_CREAT | O_TRUNC);
+    std::cout << "\nperf report written to replay_benchmark.json\n";
+
     return 0;
   }
 
+  if (config.flags & REPLAY_FLAG_HEADLESS) {
+    if (exporter) {
+      replay.installEventFilter([&](const Event *e) { return exporter->handle(e); });
+    }
+    replay.start(config.start_seconds);
+    replay.waitForFinished();
+    return (!exporter || exporter->write()) ? 0 : 1;
+  }
+
   ConsoleUI console_ui(&replay);
   replay.start(config.start_seconds);
   return console_ui.exec();
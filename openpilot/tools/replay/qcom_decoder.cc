@@ -56,32 +56,49 @@ bool MsmVidc::init(const char* dev, size_t width, size_t height, uint64_t codec)
 
 VisionBuf* MsmVidc::decodeFrame(AVPacket *pkt, VisionBuf *buf) {
   assert(initialized && (pkt != nullptr) && (buf != nullptr));
+  beginFrame(buf, 0);
+  if (!queuePacket(pkt)) {
+    return nullptr;
+  }
+  return drainFrame();
+}
 
+void MsmVidc::beginFrame(VisionBuf *buf, int discard_frames) {
+  assert(initialized && (buf != nullptr) && (discard_frames >= 0));
   this->frame_ready = false;
   this->current_output_buf = buf;
-  bool sent_packet = false;
+  this->discard_before_output = discard_frames;
+}
 
-  while (!this->frame_ready) {
-    if (!sent_packet) {
-      int buf_index = getBufferUnlocked();
-      if (buf_index >= 0) {
-        assert(buf_index < out_buf_cnt);
-        sendPacket(buf_index, pkt);
-        sent_packet = true;
-      }
+bool MsmVidc::queuePacket(AVPacket *pkt) {
+  assert(initialized && (pkt != nullptr) && (pkt->data != nullptr) && (pkt->size > 0));
+
+  int buf_index;
+  while ((buf_index = getBufferUnlocked()) < 0) {
+    // input port full: service the device until a slot frees up. Captures of
+    // run-up frames are dequeued (and discarded) along the way.
+    if (poll(pfd, nfds, -1) < 0) {
+      LOGE("poll() error: %d", errno);
+      return false;
     }
+    processEvents();
+  }
+  assert(buf_index < out_buf_cnt);
+  sendPacket(buf_index, pkt);
+  return true;
+}
 
+VisionBuf* MsmVidc::drainFrame() {
+  while (!this->frame_ready) {
     if (poll(pfd, nfds, -1) < 0) {
       LOGE("poll() error: %d", errno);
       return nullptr;
     }
-
     if (VisionBuf* result = processEvents()) {
       return result;
     }
   }
-
-  return buf;
+  return this->current_output_buf;
 }
 
 VisionBuf* MsmVidc::processEvents() {
@@ -122,6 +139,14 @@ VisionBuf* MsmVidc::handleCapture() {
     return nullptr;
   }
 
+  if (this->discard_before_output > 0) {
+    // run-up frame between the seek keyframe and the requested index;
+    // recycle the capture buffer without a copy
+    --this->discard_before_output;
+    queueCaptureBuffer(buf.index);
+    return nullptr;
+  }
+
   copyBuffer(&cap_bufs[buf.index], this->current_output_buf);
   queueCaptureBuffer(buf.index);
   return this->current_output_buf;
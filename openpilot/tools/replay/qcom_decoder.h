@@ -33,6 +33,15 @@ public:
   bool init(const char* dev, size_t width, size_t height, uint64_t codec);
   VisionBuf* decodeFrame(AVPacket* pkt, VisionBuf* buf);
 
+  // pipelined decode: beginFrame() names the destination and how many run-up
+  // frames to discard, queuePacket() blocks only for a free input slot, and
+  // drainFrame() waits for the one frame that matters. Keeping several
+  // packets in flight runs the decode block at its throughput instead of one
+  // round trip per frame.
+  void beginFrame(VisionBuf* buf, int discard_frames);
+  bool queuePacket(AVPacket* pkt);
+  VisionBuf* drainFrame();
+
   AVFormatContext* avctx = nullptr;
   int fd = 0;
 
@@ -40,6 +49,7 @@ private:
   bool initialized = false;
   bool reconfigure_pending = false;
   bool frame_ready = false;
+  int discard_before_output = 0;
 
   VisionBuf* current_output_buf = nullptr;
   VisionBuf out_buf;                          // Single input buffer
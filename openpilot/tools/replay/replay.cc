@@ -18,16 +18,25 @@ void notifyEvent(Callback &callback, Args &&...args) {
 
 Replay::Replay(const std::string &route, std::vector<std::string> allow, std::vector<std::string> block,
                SubMaster *sm, uint32_t flags, const std::string &data_dir, bool auto_source)
-    : sm_(sm), flags_(flags), seg_mgr_(std::make_unique<SegmentManager>(route, flags, data_dir, auto_source)) {
+    : sm_(sm), flags_(flags), data_dir_(data_dir), auto_source_(auto_source),
+      seg_mgr_(std::make_unique<SegmentManager>(route, flags, data_dir, auto_source)) {
   std::signal(SIGUSR1, interrupt_sleep_handler);
 
   if (flags_ & REPLAY_FLAG_BENCHMARK) {
     benchmark_stats_.process_start_ts = nanos_since_boot();
-    seg_mgr_->setBenchmarkCallback([this](int seg_num, const std::string& event) {
+  }
+  seg_mgr_->setBenchmarkCallback([this](int seg_num, const std::string& event) {
+    std::unique_lock lock(benchmark_lock_);
+    if (event == "loading") {
+      segment_load_start_[seg_num] = nanos_since_boot();
+    } else if (auto it = segment_load_start_.find(seg_num); event == "loaded" && it != segment_load_start_.end()) {
+      benchmark_stats_.segments[seg_num].load_seconds = (nanos_since_boot() - it->second) / 1e9;
+    }
+    if (hasFlag(REPLAY_FLAG_BENCHMARK)) {
       benchmark_stats_.timeline.emplace_back(nanos_since_boot(),
           "segment " + std::to_string(seg_num) + " " + event);
-    });
-  }
+    }
+  });
 
   if (!(flags_ & REPLAY_FLAG_ALL_SERVICES)) {
     block.insert(block.end(), {"bookmarkButton", "uiDebug", "userBookmark"});
@@ -82,10 +91,119 @@ Replay::~Replay() {
     stream_thread_.join();
     rInfo("shutdown: done");
   }
+  if (next_route_thread_.joinable()) {
+    next_route_thread_.join();
+  }
   camera_server_.reset();
+  next_seg_mgr_.reset();
   seg_mgr_.reset();
 }
 
+void Replay::queueRoute(const std::string &route) {
+  std::unique_lock lk(next_route_lock_);
+  pending_routes_.push_back(route);
+}
+
+// must hold next_route_lock_. Kicks off the background load of the next
+// queued route; merge callbacks just wake the stream thread so it can switch
+// as soon as the first segment lands.
+void Replay::prefetchNextRouteLocked() {
+  if (next_seg_mgr_ || pending_routes_.empty() || exit_) return;
+
+  if (next_route_thread_.joinable()) {
+    next_route_thread_.join();
+  }
+
+  std::string route = pending_routes_.front();
+  pending_routes_.erase(pending_routes_.begin());
+  rInfo("prefetching next route %s", route.c_str());
+
+  next_route_state_ = NextRouteState::Loading;
+  next_seg_mgr_ = std::make_unique<SegmentManager>(route, flags_, data_dir_, auto_source_);
+  next_seg_mgr_->setCallback([this]() {
+    if (!exit_) interruptStream([]() { return true; });
+  });
+  next_route_thread_ = std::thread([this, mgr = next_seg_mgr_.get()]() {
+    bool ok = mgr->load();
+    if (ok) {
+      mgr->setCurrentSegment(mgr->route_.segments().begin()->first);
+    } else {
+      rWarning("failed to load queued route %s", mgr->route_.name().c_str());
+    }
+    std::unique_lock lk(next_route_lock_);
+    next_route_state_ = ok ? NextRouteState::Ready : NextRouteState::Failed;
+  });
+}
+
+bool Replay::hasQueuedRoute() {
+  std::unique_lock lk(next_route_lock_);
+  prefetchNextRouteLocked();
+  return next_seg_mgr_ != nullptr;
+}
+
+// called from the stream thread when the current route has been exhausted.
+// Returns true once playback state has been reset onto the next route.
+bool Replay::switchToNextRoute() {
+  std::unique_ptr<SegmentManager> next;
+  {
+    std::unique_lock lk(next_route_lock_);
+    prefetchNextRouteLocked();
+    if (!next_seg_mgr_ || next_route_state_ == NextRouteState::Loading) return false;
+    if (next_route_state_ == NextRouteState::Failed) {
+      // drop the broken route and start on the one after it
+      next_seg_mgr_.reset();
+      prefetchNextRouteLocked();
+      return false;
+    }
+    if (next_seg_mgr_->getEventData()->segments.empty()) return false;  // first segment still merging
+    next = std::move(next_seg_mgr_);
+  }
+  if (next_route_thread_.joinable()) {
+    next_route_thread_.join();
+  }
+
+  rInfo("switching to route %s", next->route_.name().c_str());
+  seg_mgr_ = std::move(next);
+  seg_mgr_->setCallback([this]() { handleSegmentMerge(); });
+
+  auto event_data = seg_mgr_->getEventData();
+  const auto &events = event_data->segments.begin()->second->log->events;
+  route_start_ts_ = events.front().mono_time;
+  cur_mono_time_ = route_start_ts_ - 1;
+  cur_which_ = cereal::Event::Which::INIT_DATA;
+  min_seconds_ = seg_mgr_->route_.segments().begin()->first * 60;
+  max_seconds_ = (seg_mgr_->route_.segments().rbegin()->first + 1) * 60;
+  route_date_time_ = route().datetime();
+  current_segment_.store(seg_mgr_->route_.segments().begin()->first);
+
+  // write CarParams for the new route
+  auto it = std::find_if(events.begin(), events.end(), [](const Event &e) { return e.which == cereal::Event::Which::CAR_PARAMS; });
+  if (it != events.end()) {
+    capnp::FlatArrayMessageReader reader(it->data);
+    auto event = reader.getRoot<cereal::Event>();
+    car_fingerprint_ = event.getCarParams().getCarFingerprint();
+
+    capnp::MallocMessageBuilder builder;
+    builder.setRoot(event.getCarParams());
+    auto words = capnp::messageToFlatArray(builder);
+    auto bytes = words.asBytes();
+    Params().put("CarParams", (const char *)bytes.begin(), bytes.size());
+    Params().put("CarParamsPersistent", (const char *)bytes.begin(), bytes.size());
+  } else {
+    rWarning("failed to read CarParams from current segment");
+  }
+
+  timeline_.initialize(seg_mgr_->route_, route_start_ts_, !(flags_ & REPLAY_FLAG_NO_FILE_CACHE),
+                       [this](std::shared_ptr<LogReader> log) { notifyEvent(onQLogLoaded, log); });
+
+  {
+    std::unique_lock lock(stream_lock_);
+    events_ready_ = true;
+  }
+  notifyEvent(onSegmentsMerged);
+  return true;
+}
+
 bool Replay::load() {
   rInfo("loading route %s", seg_mgr_->route_.name().c_str());
 
@@ -123,6 +241,7 @@ void Replay::seekTo(double seconds, bool relative) {
   }
 
   rInfo("Seeking to %d s, segment %d", (int)target_time, target_segment);
+  seek_start_ts_.store(nanos_since_boot());
   notifyEvent(onSeeking, target_time);
 
   interruptStream([&]() {
@@ -141,8 +260,12 @@ void Replay::checkSeekProgress() {
   if (!seg_mgr_->getEventData()->isSegmentLoaded(current_segment_.load())) return;
 
   double seek_to = seeking_to_.exchange(-1.0, std::memory_order_acquire);
-  if (seek_to >= 0 && onSeekedTo) {
-    onSeekedTo(seek_to);
+  if (seek_to >= 0) {
+    if (uint64_t start_ts = seek_start_ts_.exchange(0)) {
+      std::unique_lock lock(benchmark_lock_);
+      benchmark_stats_.seek_seconds.push_back((nanos_since_boot() - start_ts) / 1e9);
+    }
+    if (onSeekedTo) onSeekedTo(seek_to);
   }
 
   // Resume the interrupted stream
@@ -172,6 +295,22 @@ void Replay::handleSegmentMerge() {
   if (!stream_thread_.joinable() && !event_data->segments.empty()) {
     startStream(event_data->segments.begin()->second);
   }
+
+  // Pull per-segment log stats into the perf report as segments land
+  {
+    std::unique_lock lock(benchmark_lock_);
+    for (const auto &[n, seg] : event_data->segments) {
+      auto &s = benchmark_stats_.segments[n];
+      if (s.decompressed_size == 0 && seg->log) {
+        s.compressed_size = seg->log->compressed_size();
+        s.decompressed_size = seg->log->decompressed_size();
+        s.download_seconds = seg->log->download_seconds();
+        s.decompress_seconds = seg->log->decompress_seconds();
+        s.parse_seconds = seg->log->parse_seconds();
+      }
+    }
+  }
+
   notifyEvent(onSegmentsMerged);
 
   // Interrupt the stream to handle segment merge
@@ -285,6 +424,13 @@ void Replay::streamThread() {
     const auto &events = event_data_->events;
     auto first = std::upper_bound(events.cbegin(), events.cend(), Event(cur_which_, cur_mono_time_, {}));
     if (first == events.cend()) {
+      int last_segment = seg_mgr_->route_.segments().rbegin()->first;
+      if (event_data_->isSegmentLoaded(last_segment) && hasQueuedRoute()) {
+        stream_lock_.unlock();
+        bool switched = switchToNextRoute();
+        stream_lock_.lock();
+        if (switched) continue;
+      }
       rInfo("waiting for events...");
       events_ready_ = false;
       continue;
@@ -302,7 +448,20 @@ void Replay::streamThread() {
       camera_server_->waitForSent();
     }
 
-    if (it == events.cend() && !hasFlag(REPLAY_FLAG_NO_LOOP) && !hasFlag(REPLAY_FLAG_BENCHMARK)) {
+    // at the end of the route a queued follow-up route takes priority over
+    // looping or exiting
+    if (it == events.cend() && !hasFlag(REPLAY_FLAG_BENCHMARK) &&
+        event_data_->isSegmentLoaded(seg_mgr_->route_.segments().rbegin()->first) && hasQueuedRoute()) {
+      stream_lock_.unlock();
+      bool switched = switchToNextRoute();
+      stream_lock_.lock();
+      if (!switched) {
+        events_ready_ = false;  // wait for the next route's first merge
+      }
+      continue;
+    }
+
+    if (it == events.cend() && !hasFlag(REPLAY_FLAG_NO_LOOP) && !hasFlag(REPLAY_FLAG_BENCHMARK) && !hasFlag(REPLAY_FLAG_HEADLESS)) {
       int last_segment = seg_mgr_->route_.segments().rbegin()->first;
       if (event_data_->isSegmentLoaded(last_segment)) {
         rInfo("reaches the end of route, restart from beginning");
@@ -314,11 +473,21 @@ void Replay::streamThread() {
       // Exit benchmark mode after first segment completes
       exit_ = true;
       break;
+    } else if (it == events.cend() && hasFlag(REPLAY_FLAG_HEADLESS)) {
+      // Headless mode runs the whole route: only exit once the last segment
+      // has been merged and published; otherwise loop back and wait for more
+      int last_segment = seg_mgr_->route_.segments().rbegin()->first;
+      if (event_data_->isSegmentLoaded(last_segment)) {
+        exit_ = true;
+        break;
+      }
     }
   }
 
-  if (hasFlag(REPLAY_FLAG_BENCHMARK)) {
-    benchmark_stats_.timeline.emplace_back(nanos_since_boot(), "benchmark done");
+  if (hasFlag(REPLAY_FLAG_BENCHMARK) || hasFlag(REPLAY_FLAG_HEADLESS)) {
+    if (hasFlag(REPLAY_FLAG_BENCHMARK)) {
+      benchmark_stats_.timeline.emplace_back(nanos_since_boot(), "benchmark done");
+    }
 
     {
       std::unique_lock lock(benchmark_lock_);
@@ -343,6 +512,12 @@ std::vector<Event>::const_iterator Replay::publishEvents(std::vector<Event>::con
     if (current_segment_.load(std::memory_order_relaxed) != segment) {
       current_segment_.store(segment, std::memory_order_relaxed);
       seg_mgr_->setCurrentSegment(segment);
+      // entering the route's tail: start loading the next queued route now so
+      // the switch at the end is gapless
+      if (segment == seg_mgr_->route_.segments().rbegin()->first) {
+        std::unique_lock lk(next_route_lock_);
+        prefetchNextRouteLocked();
+      }
     }
 
     // Track segment completion for benchmark timeline
@@ -369,7 +544,9 @@ std::vector<Event>::const_iterator Replay::publishEvents(std::vector<Event>::con
     if (!sockets_[evt.which]) continue;
 
     const uint64_t current_nanos = nanos_since_boot();
-    const int64_t time_diff = (evt.mono_time - evt_start_ts) / speed_ - (current_nanos - loop_start_ts);
+    // Virtual clock: with no pacing the loop is limited only by the consumers
+    const bool unpaced = hasFlag(REPLAY_FLAG_BENCHMARK) || (hasFlag(REPLAY_FLAG_HEADLESS) && speed_ <= 0.0);
+    const int64_t time_diff = unpaced ? 0 : (evt.mono_time - evt_start_ts) / speed_ - (current_nanos - loop_start_ts);
 
     // Reset timestamps for potential synchronization issues:
     // - A negative time_diff may indicate slow execution or system wake-up,
@@ -378,8 +555,7 @@ std::vector<Event>::const_iterator Replay::publishEvents(std::vector<Event>::con
       evt_start_ts = evt.mono_time;
       loop_start_ts = current_nanos;
       prev_replay_speed = speed_;
-    } else if (time_diff > 0 && !hasFlag(REPLAY_FLAG_BENCHMARK)) {
-      // Skip sleep in benchmark mode for maximum throughput
+    } else if (time_diff > 0) {
       precise_nano_sleep(time_diff, interrupt_requested_);
     }
 
@@ -388,7 +564,9 @@ std::vector<Event>::const_iterator Replay::publishEvents(std::vector<Event>::con
     if (evt.eidx_segnum == -1) {
       publishMessage(&evt);
     } else if (camera_server_) {
-      if (speed_ > 1.0) {
+      // Above realtime the bounded frame buffers are the backpressure point:
+      // block until the previous frame is consumed instead of dropping it
+      if (speed_ > 1.0 || hasFlag(REPLAY_FLAG_HEADLESS)) {
         camera_server_->waitForSent();
       }
       publishFrame(&evt);
@@ -399,10 +577,63 @@ std::vector<Event>::const_iterator Replay::publishEvents(std::vector<Event>::con
 }
 
 void Replay::waitForFinished() {
-  if (!hasFlag(REPLAY_FLAG_BENCHMARK)) {
+  if (!hasFlag(REPLAY_FLAG_BENCHMARK) && !hasFlag(REPLAY_FLAG_HEADLESS)) {
     return;
   }
 
   std::unique_lock lock(benchmark_lock_);
   benchmark_cv_.wait(lock, [this]() { return benchmark_done_; });
 }
+
+std::string Replay::perfReportJson() {
+  BenchmarkStats stats;
+  {
+    std::unique_lock lock(benchmark_lock_);
+    stats = benchmark_stats_;
+  }
+  stats.merge_count = seg_mgr_->merge_count_;
+  stats.merge_seconds = seg_mgr_->merge_time_ns_ / 1e9;
+  stats.cache_bytes = seg_mgr_->cache_bytes_;
+  stats.evictions = seg_mgr_->evicted_count_;
+  if (camera_server_) {
+    for (auto cam : ALL_CAMERAS) {
+      std::tie(stats.cameras[cam].frames, stats.cameras[cam].fps) = camera_server_->frameStats(cam);
+    }
+  }
+  return stats.toJson();
+}
+
+std::string BenchmarkStats::toJson() const {
+  std::ostringstream json;
+  json << std::fixed << std::setprecision(3);
+  json << "{\n  \"segments\": {";
+  bool first = true;
+  for (const auto &[n, s] : segments) {
+    double mbps = s.decompress_seconds > 0 ? s.decompressed_size / s.decompress_seconds / 1e6 : 0;
+    json << (first ? "" : ",") << "\n    \"" << n << "\": {"
+         << "\"load_seconds\": " << s.load_seconds
+         << ", \"compressed_size\": " << s.compressed_size
+         << ", \"decompressed_size\": " << s.decompressed_size
+         << ", \"download_seconds\": " << s.download_seconds
+         << ", \"decompress_seconds\": " << s.decompress_seconds
+         << ", \"decompress_mbps\": " << mbps
+         << ", \"parse_seconds\": " << s.parse_seconds << "}";
+    first = false;
+  }
+  json << "\n  },\n  \"cameras\": [";
+  for (int i = 0; i < MAX_CAMERAS; ++i) {
+    json << (i ? ", " : "") << "{\"frames\": " << cameras[i].frames << ", \"fps\": " << cameras[i].fps << "}";
+  }
+  json << "],\n  \"merges\": {\"count\": " << merge_count << ", \"seconds\": " << merge_seconds << "},";
+  json << "\n  \"cache\": {\"bytes\": " << cache_bytes << ", \"evictions\": " << evictions << "},";
+  json << "\n  \"seek_seconds\": [";
+  for (size_t i = 0; i < seek_seconds.size(); ++i) {
+    json << (i ? ", " : "") << seek_seconds[i];
+  }
+  json << "],\n  \"timeline\": [";
+  for (size_t i = 0; i < timeline.size(); ++i) {
+    json << (i ? ", " : "") << "[" << (timeline[i].first - process_start_ts) / 1e6 << ", \"" << timeline[i].second << "\"]";
+  }
+  json << "]\n}\n";
+  return json.str();
+}
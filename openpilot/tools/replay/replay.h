@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -25,11 +26,37 @@ enum REPLAY_FLAGS {
   REPLAY_FLAG_NO_VIPC = 0x0400,
   REPLAY_FLAG_ALL_SERVICES = 0x0800,
   REPLAY_FLAG_BENCHMARK = 0x1000,
+  REPLAY_FLAG_HEADLESS = 0x2000,
 };
 
+// Structured perf report: segment load breakdown, merge stalls, seek
+// latencies and per-camera decode throughput. Collected on every run (the
+// hooks are cheap); the event timeline is benchmark mode only.
 struct BenchmarkStats {
   uint64_t process_start_ts = 0;
   std::vector<std::pair<uint64_t, std::string>> timeline;
+
+  struct SegmentStats {
+    double load_seconds = 0;
+    uint64_t compressed_size = 0;
+    uint64_t decompressed_size = 0;
+    double download_seconds = 0;
+    double decompress_seconds = 0;
+    double parse_seconds = 0;
+  };
+  struct CameraStats {
+    uint64_t frames = 0;
+    double fps = 0;
+  };
+  std::map<int, SegmentStats> segments;
+  CameraStats cameras[MAX_CAMERAS];
+  int merge_count = 0;
+  double merge_seconds = 0;
+  uint64_t cache_bytes = 0;
+  int evictions = 0;
+  std::vector<double> seek_seconds;
+
+  std::string toJson() const;
 };
 
 class Replay {
@@ -46,6 +73,7 @@ public:
   inline bool isPaused() const { return user_paused_; }
   inline int segmentCacheLimit() const { return seg_mgr_->segment_cache_limit_; }
   inline void setSegmentCacheLimit(int n) { seg_mgr_->segment_cache_limit_ = std::max(MIN_SEGMENTS_CACHE, n); }
+  inline void setCacheByteBudget(uint64_t bytes) { seg_mgr_->cache_byte_limit_ = bytes; }
   inline bool hasFlag(REPLAY_FLAGS flag) const { return flags_ & flag; }
   void setLoop(bool loop) { loop ? flags_ &= ~REPLAY_FLAG_NO_LOOP : flags_ |= REPLAY_FLAG_NO_LOOP; }
   bool loop() const { return !(flags_ & REPLAY_FLAG_NO_LOOP); }
@@ -56,6 +84,8 @@ public:
   inline double toSeconds(uint64_t mono_time) const { return (mono_time - route_start_ts_) / 1e9; }
   inline double minSeconds() const { return min_seconds_; }
   inline double maxSeconds() const { return max_seconds_; }
+  // speed <= 0 runs the virtual clock unpaced: events are published as fast
+  // as the bounded VisionIPC buffers drain (headless batch mode)
   inline void setSpeed(float speed) { speed_ = speed; }
   inline float getSpeed() const { return speed_; }
   inline const std::string &carFingerprint() const { return car_fingerprint_; }
@@ -65,6 +95,12 @@ public:
   void installEventFilter(std::function<bool(const Event *)> filter) { event_filter_ = filter; }
   void waitForFinished();
   const BenchmarkStats &getBenchmarkStats() const { return benchmark_stats_; }
+  std::string perfReportJson();
+
+  // gapless multi-route review: queued routes are prefetched while the tail
+  // of the current route plays and swapped in at the end of the route without
+  // tearing down the stream thread, sockets or cameras
+  void queueRoute(const std::string &route);
 
   // Event callback functions
   std::function<void()> onSegmentsMerged = nullptr;
@@ -86,6 +122,9 @@ private:
   void publishMessage(const Event *e);
   void publishFrame(const Event *e);
   void checkSeekProgress();
+  bool hasQueuedRoute();
+  void prefetchNextRouteLocked();
+  bool switchToNextRoute();
 
   std::unique_ptr<SegmentManager> seg_mgr_;
   Timeline timeline_;
@@ -118,7 +157,21 @@ private:
 
   std::shared_ptr<SegmentManager::EventData> event_data_ = std::make_shared<SegmentManager::EventData>();
 
+  // queued follow-up routes (ignition cycles split drives across routes).
+  // The next route's SegmentManager loads in the background while the current
+  // route's tail plays, so the switch only costs a state reset.
+  std::string data_dir_;
+  bool auto_source_ = false;
+  std::mutex next_route_lock_;
+  std::vector<std::string> pending_routes_;
+  std::unique_ptr<SegmentManager> next_seg_mgr_;
+  enum class NextRouteState { Loading, Ready, Failed };
+  NextRouteState next_route_state_ = NextRouteState::Loading;
+  std::thread next_route_thread_;
+
   BenchmarkStats benchmark_stats_;
+  std::map<int, uint64_t> segment_load_start_;
+  std::atomic<uint64_t> seek_start_ts_ = 0;
   std::condition_variable benchmark_cv_;
   std::mutex benchmark_lock_;
   bool benchmark_done_ = false;
@@ -1,15 +1,35 @@
 #include "tools/replay/route.h"
 
+#include <sys/stat.h>
+
+#include <algorithm>
 #include <array>
 #include <filesystem>
 #include <regex>
 
 #include "json11/json11.hpp"
 #include "common/hardware/hw.h"
+#include "common/threadpool.h"
 #include "tools/replay/py_downloader.h"
 #include "tools/replay/replay.h"
 #include "tools/replay/util.h"
 
+namespace {
+
+// route manifest cache: the route-files response is kept next to the segment
+// downloads and reused while fresh, so reopening a route skips the python
+// subprocess and the API round trip entirely. The server's signed URLs
+// expire, so entries past the TTL are refetched.
+constexpr int64_t ROUTE_MANIFEST_TTL_SECONDS = 3600;
+
+std::string routeManifestPath(const std::string &route) {
+  std::string name = route;
+  std::replace(name.begin(), name.end(), '|', '_');
+  return Path::download_cache_root() + "route_files_" + name + ".json";
+}
+
+}  // namespace
+
 Route::Route(const std::string &route, const std::string &data_dir, bool auto_source)
     : route_string_(route), data_dir_(data_dir), auto_source_(auto_source) {}
 
@@ -104,6 +124,17 @@ bool Route::loadFromAutoSource() {
 }
 
 bool Route::loadFromServer() {
+  const std::string manifest_path = routeManifestPath(route_.str);
+  struct stat st = {};
+  if (stat(manifest_path.c_str(), &st) == 0 && (time(nullptr) - st.st_mtime) < ROUTE_MANIFEST_TTL_SECONDS) {
+    std::string parse_err;
+    auto cached = json11::Json::parse(util::read_file(manifest_path), parse_err);
+    if (parse_err.empty() && loadFromJson(cached)) {
+      return true;
+    }
+    segments_.clear();
+  }
+
   std::string result = PyDownloader::getRouteFiles(route_.str);
   if (result.empty()) {
     err_ = RouteLoadError::NetworkError;
@@ -135,7 +166,12 @@ bool Route::loadFromServer() {
     return false;
   }
 
-  return loadFromJson(json);
+  bool ok = loadFromJson(json);
+  if (ok) {
+    util::create_directories(Path::download_cache_root(), 0775);
+    util::write_file(manifest_path.c_str(), result.data(), result.size(), O_WRONLY | O_CREAT | O_TRUNC);
+  }
+  return ok;
 }
 
 bool Route::loadFromJson(const json11::Json &json) {
@@ -202,23 +238,40 @@ Segment::Segment(int n, const SegmentFile &files, uint32_t flags, const std::vec
       flags & REPLAY_FLAG_ECAM ? files.wide_road_cam : "",
       files.rlog.empty() ? files.qlog : files.rlog,
   };
+  // load on the shared pool instead of per-file threads, so concurrent
+  // segment windows (and cabana running alongside) share cores instead of
+  // oversubscribing them. playback stalls on log events first, so the log
+  // outranks the camera streams.
+  auto should_load = [&](int i) {
+    return !file_list[i].empty() && (!(flags & REPLAY_FLAG_NO_VIPC) || i >= MAX_CAMERAS);
+  };
+  // count all tasks up front: the first posted task may finish (and decrement)
+  // before the constructor posts the rest
   for (int i = 0; i < file_list.size(); ++i) {
-    if (!file_list[i].empty() && (!(flags & REPLAY_FLAG_NO_VIPC) || i >= MAX_CAMERAS)) {
+    if (should_load(i)) {
       ++loading_;
-      threads_.emplace_back(&Segment::loadFile, this, i, file_list[i]);
+      ++pending_tasks_;
+    }
+  }
+  for (int i = 0; i < file_list.size(); ++i) {
+    if (should_load(i)) {
+      auto prio = i >= MAX_CAMERAS ? ThreadPool::Priority::High : ThreadPool::Priority::Normal;
+      ThreadPool::shared().post([this, i, file = file_list[i]]() {
+        loadFile(i, file);
+        std::lock_guard lock(mutex_);
+        if (--pending_tasks_ == 0) cv_.notify_all();
+      }, prio);
     }
   }
 }
 
 Segment::~Segment() {
-  {
-    std::lock_guard lock(mutex_);
-    on_load_finished_ = nullptr;  // Prevent callback after destruction
-  }
   abort_ = true;
-  for (auto &thread : threads_) {
-    if (thread.joinable()) thread.join();
-  }
+  std::unique_lock lock(mutex_);
+  on_load_finished_ = nullptr;  // Prevent callback after destruction
+  // queued tasks abort quickly once abort_ is set; wait for them to drain so
+  // no pool task touches a dead Segment
+  cv_.wait(lock, [this]() { return pending_tasks_ == 0; });
 }
 
 void Segment::loadFile(int id, const std::string file) {
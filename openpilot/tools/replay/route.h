@@ -1,11 +1,11 @@
 #pragma once
 
+#include <condition_variable>
 #include <ctime>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
-#include <thread>
 #include <vector>
 
 #include "json11/json11.hpp"
@@ -76,6 +76,14 @@ public:
           std::function<void(int, bool)> callback);
   ~Segment();
   LoadState getState();
+  // approximate resident bytes; the decompressed rlog dominates
+  uint64_t memoryUsage() const {
+    uint64_t total = log ? log->decompressed_size() + log->events.size() * sizeof(Event) : 0;
+    for (const auto &fr : frames) {
+      if (fr) total += fr->getFrameCount() * sizeof(FrameReader::PacketInfo);
+    }
+    return total;
+  }
 
   const int seg_num = 0;
   std::unique_ptr<LogReader> log;
@@ -87,7 +95,8 @@ protected:
   std::atomic<bool> abort_ = false;
   std::atomic<int> loading_ = 0;
   std::mutex mutex_;
-  std::vector<std::thread> threads_;
+  std::condition_variable cv_;
+  int pending_tasks_ = 0;  // load tasks still queued or running on the shared pool
   std::function<void(int, bool)> on_load_finished_ = nullptr;
   uint32_t flags;
   std::vector<bool> filters_;
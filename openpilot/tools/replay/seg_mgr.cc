@@ -1,6 +1,9 @@
 #include "tools/replay/seg_mgr.h"
 
 #include <algorithm>
+#include <queue>
+
+#include "common/timing.h"
 
 SegmentManager::~SegmentManager() {
   {
@@ -54,15 +57,23 @@ void SegmentManager::manageSegmentCache() {
     auto cur = segments_.lower_bound(cur_seg_num_);
     if (cur == segments_.end()) continue;
 
-    // Calculate the range of segments to load
-    auto begin = std::prev(cur, std::min<int>(segment_cache_limit_ / 2, std::distance(segments_.begin(), cur)));
-    auto end = std::next(begin, std::min<int>(segment_cache_limit_, std::distance(begin, segments_.end())));
-    begin = std::prev(end, std::min<int>(segment_cache_limit_, std::distance(segments_.begin(), end)));
+    // Calculate the range of segments to load; the byte budget can shrink the
+    // window below the configured segment count
+    int window = std::min(segment_cache_limit_, byte_limited_window_);
+    auto begin = std::prev(cur, std::min<int>(window / 2, std::distance(segments_.begin(), cur)));
+    auto end = std::next(begin, std::min<int>(window, std::distance(begin, segments_.end())));
+    begin = std::prev(end, std::min<int>(window, std::distance(segments_.begin(), end)));
 
     lock.unlock();
 
     loadSegmentsInRange(begin, cur, end);
+    enforceByteBudget(begin, cur, end);
+    uint64_t merge_start_ts = nanos_since_boot();
     bool merged = mergeSegments(begin, end);
+    if (merged) {
+      ++merge_count_;
+      merge_time_ns_ += nanos_since_boot() - merge_start_ts;
+    }
 
     // Free segments outside the current range
     std::for_each(segments_.begin(), begin, [](auto &segment) { segment.second.reset(); });
@@ -74,6 +85,47 @@ void SegmentManager::manageSegmentCache() {
   }
 }
 
+// Byte-budget eviction: when the loaded window exceeds the configured cap,
+// drop segments from the window edge farthest from playback until it fits
+// (for forward playback that is the trailing, already-played edge), but always
+// keep at least the current segment and one neighbor. The shrunken window
+// size is remembered so evicted segments aren't immediately reloaded, and is
+// grown back gently once usage drops well below the cap.
+void SegmentManager::enforceByteBudget(SegmentMap::iterator &begin, const SegmentMap::iterator &cur, SegmentMap::iterator &end) {
+  if (cache_byte_limit_ == 0) return;
+
+  auto seg_bytes = [](const std::shared_ptr<Segment> &s) -> uint64_t {
+    return (s && s->getState() == Segment::LoadState::Loaded) ? s->memoryUsage() : 0;
+  };
+  uint64_t total = 0;
+  for (auto it = begin; it != end; ++it) total += seg_bytes(it->second);
+
+  bool evicted = false;
+  while (total > cache_byte_limit_ && std::distance(begin, end) > 2) {
+    auto front = begin;
+    auto back = std::prev(end);
+    bool drop_front = (cur->first - front->first) >= (back->first - cur->first);
+    auto victim = drop_front ? front : back;
+    if (victim == cur) break;
+
+    total -= seg_bytes(victim->second);
+    if (victim->second) {
+      rDebug("evicting segment %d (cache over %lu byte budget)", victim->first, cache_byte_limit_);
+      victim->second.reset();
+      ++evicted_count_;
+      evicted = true;
+    }
+    drop_front ? ++begin : --end;
+  }
+
+  if (evicted) {
+    byte_limited_window_ = std::max<int>(2, std::distance(begin, end));
+  } else if (total < cache_byte_limit_ * 3 / 4 && byte_limited_window_ < segment_cache_limit_) {
+    ++byte_limited_window_;
+  }
+  cache_bytes_ = total;
+}
+
 bool SegmentManager::mergeSegments(const SegmentMap::iterator &begin, const SegmentMap::iterator &end) {
   std::set<int> segments_to_merge;
   size_t total_event_count = 0;
@@ -91,21 +143,63 @@ bool SegmentManager::mergeSegments(const SegmentMap::iterator &begin, const Segm
   auto &merged_events = merged_event_data->events;
   merged_events.reserve(total_event_count);
 
-  std::string segments_str = join(segments_to_merge, ", ");
-  rDebug("merging segments: %s", segments_str.c_str());
-  for (int n : segments_to_merge) {
+  // per-segment sorted spans feeding a single-pass k-way merge. the merged
+  // vector stays contiguous because publishEvents, seeks and cabana all
+  // bisect and iterate it directly; the incrementality comes from reusing
+  // the previously merged history instead of re-merging it.
+  struct Span {
+    std::vector<Event>::const_iterator it, end;
+  };
+  auto span_of = [this](int n) {
     const auto &events = segments_.at(n)->log->events;
-    if (events.empty()) continue;
+    auto events_begin = (!events.empty() && events.front().which == cereal::Event::Which::INIT_DATA)
+                            ? std::next(events.begin()) : events.begin();
+    return Span{events_begin, events.end()};
+  };
 
-    // Skip INIT_DATA if present
-    auto events_begin = (events.front().which == cereal::Event::Which::INIT_DATA) ? std::next(events.begin()) : events.begin();
+  const auto prev_event_data = std::atomic_load(&event_data_);
+  const auto &prev_events = prev_event_data->events;
+
+  // Fast path for forward playback: every previously merged segment is
+  // retained and all new segments start after the merged history, so the
+  // history is copied verbatim and only the new tail is k-way merged.
+  bool append_only = !prev_events.empty() &&
+                     std::includes(segments_to_merge.begin(), segments_to_merge.end(),
+                                   merged_segments_.begin(), merged_segments_.end());
+  if (append_only) {
+    for (int n : segments_to_merge) {
+      if (merged_segments_.count(n)) continue;
+      Span s = span_of(n);
+      if (s.it != s.end && *s.it < prev_events.back()) {
+        append_only = false;
+        break;
+      }
+    }
+  }
 
-    size_t previous_size = merged_events.size();
-    merged_events.insert(merged_events.end(), events_begin, events.end());
-    std::inplace_merge(merged_events.begin(), merged_events.begin() + previous_size, merged_events.end());
+  std::string segments_str = join(segments_to_merge, ", ");
+  rDebug("merging segments: %s%s", segments_str.c_str(), append_only ? " (append)" : "");
 
+  auto cmp = [](const Span &a, const Span &b) { return *b.it < *a.it; };
+  std::priority_queue<Span, std::vector<Span>, decltype(cmp)> heap(cmp);
+  for (int n : segments_to_merge) {
+    if (append_only && merged_segments_.count(n)) continue;
+    Span s = span_of(n);
+    if (s.it != s.end) heap.push(s);
     merged_event_data->segments[n] = segments_.at(n);
   }
+  if (append_only) {
+    merged_events.insert(merged_events.end(), prev_events.begin(), prev_events.end());
+    for (int n : merged_segments_) {
+      merged_event_data->segments[n] = segments_.at(n);
+    }
+  }
+  while (!heap.empty()) {
+    Span s = heap.top();
+    heap.pop();
+    merged_events.push_back(*s.it);
+    if (++s.it != s.end) heap.push(s);
+  }
 
   std::atomic_store(&event_data_, std::move(merged_event_data));
   merged_segments_ = segments_to_merge;
@@ -114,7 +208,12 @@ bool SegmentManager::mergeSegments(const SegmentMap::iterator &begin, const Segm
 }
 
 void SegmentManager::loadSegmentsInRange(SegmentMap::iterator begin, SegmentMap::iterator cur, SegmentMap::iterator end) {
-  auto tryLoadSegment = [this](auto first, auto last) {
+  // Kick off every missing segment in the window at once. Each Segment
+  // decompresses and parses its files on its own threads, so the window loads
+  // in parallel instead of draining one segment at a time; the window size
+  // bounds the total thread count. Forward segments are created first so they
+  // win the race for disk and network.
+  auto startLoading = [this](auto first, auto last) {
     for (auto it = first; it != last; ++it) {
       auto &segment_ptr = it->second;
       if (!segment_ptr) {
@@ -132,16 +231,9 @@ void SegmentManager::loadSegmentsInRange(SegmentMap::iterator begin, SegmentMap:
               cv_.notify_one();
             });
       }
-
-      if (segment_ptr->getState() == Segment::LoadState::Loading) {
-        return true;  // Segment is still loading
-      }
     }
-    return false;  // No segments need loading
   };
 
-  // Try forward loading, then reverse if necessary
-  if (!tryLoadSegment(cur, end)) {
-    tryLoadSegment(std::make_reverse_iterator(cur), std::make_reverse_iterator(begin));
-  }
+  startLoading(cur, end);
+  startLoading(std::make_reverse_iterator(cur), std::make_reverse_iterator(begin));
 }
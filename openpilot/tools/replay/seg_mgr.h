@@ -1,6 +1,8 @@
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
+#include <limits>
 #include <map>
 #include <mutex>
 #include <set>
@@ -34,10 +36,20 @@ public:
 
   Route route_;
   int segment_cache_limit_ = MIN_SEGMENTS_CACHE;
+  uint64_t cache_byte_limit_ = 0;  // 0 = unlimited
+
+  // merge accounting for the perf report: the stream thread stalls while a merge runs
+  std::atomic<int> merge_count_ = 0;
+  std::atomic<uint64_t> merge_time_ns_ = 0;
+
+  // byte-budget accounting for the perf report
+  std::atomic<uint64_t> cache_bytes_ = 0;
+  std::atomic<int> evicted_count_ = 0;
 
 private:
   void manageSegmentCache();
   void loadSegmentsInRange(SegmentMap::iterator begin, SegmentMap::iterator cur, SegmentMap::iterator end);
+  void enforceByteBudget(SegmentMap::iterator &begin, const SegmentMap::iterator &cur, SegmentMap::iterator &end);
   bool mergeSegments(const SegmentMap::iterator &begin, const SegmentMap::iterator &end);
 
   std::vector<bool> filters_;
@@ -49,6 +61,7 @@ private:
   int cur_seg_num_ = -1;
   bool needs_update_ = false;
   bool exit_ = false;
+  int byte_limited_window_ = std::numeric_limits<int>::max();
 
   SegmentMap segments_;
   std::shared_ptr<EventData> event_data_;
@@ -2,6 +2,8 @@
 
 #include <algorithm>
 #include <array>
+#include <deque>
+#include <future>
 
 #include "openpilot/cereal/gen/cpp/log.capnp.h"
 
@@ -14,6 +16,14 @@ Timeline::~Timeline() {
 
 void Timeline::initialize(const Route &route, uint64_t route_start_ts, bool local_cache,
                           std::function<void(std::shared_ptr<LogReader>)> callback) {
+  // reused across route switches: stop any previous build and start fresh
+  if (thread_.joinable()) {
+    should_exit_.store(true);
+    thread_.join();
+    should_exit_.store(false);
+    staging_entries_.clear();
+    std::atomic_store(&timeline_entries_, std::make_shared<std::vector<Entry>>());
+  }
   thread_ = std::thread(&Timeline::buildTimeline, this, route, route_start_ts, local_cache, callback);
 }
 
@@ -51,13 +61,28 @@ void Timeline::buildTimeline(const Route &route, uint64_t route_start_ts, bool l
                              std::function<void(std::shared_ptr<LogReader>)> callback) {
   std::optional<size_t> current_engaged_idx, current_alert_idx;
 
-  for (const auto &segment : route.segments()) {
-    if (should_exit_) break;
-
-    auto log = std::make_shared<LogReader>();
-    if (!log->load(segment.second.qlog, &should_exit_, local_cache) || log->events.empty()) {
-      continue;  // Skip if log loading fails or no events
+  // Qlogs are downloaded and parsed a few segments ahead in parallel, but
+  // consumed strictly in order since engagement/alert state spans segment
+  // boundaries. Each consumed segment publishes immediately, so the UI shows
+  // a filling timeline after the first segment instead of after the route.
+  const size_t prefetch_count = 4;
+  std::deque<std::future<std::shared_ptr<LogReader>>> pending;
+  auto next_seg = route.segments().begin();
+  auto prefetch = [&]() {
+    for (; pending.size() < prefetch_count && next_seg != route.segments().end(); ++next_seg) {
+      pending.push_back(std::async(std::launch::async, [this, qlog = next_seg->second.qlog, local_cache]() -> std::shared_ptr<LogReader> {
+        auto log = std::make_shared<LogReader>();
+        bool ok = log->load(qlog, &should_exit_, local_cache) && !log->events.empty();
+        return ok ? log : nullptr;
+      }));
     }
+  };
+
+  for (prefetch(); !pending.empty(); prefetch()) {
+    auto log = pending.front().get();
+    pending.pop_front();
+    if (should_exit_) break;
+    if (!log) continue;  // Skip if log loading fails or no events
 
     for (const Event &e : log->events) {
       double seconds = (e.mono_time - route_start_ts) / 1e9;
@@ -188,18 +188,46 @@ void *MonotonicBuffer::allocate(size_t bytes, size_t alignment) {
   void *p = std::align(alignment, bytes, current_buf, available);
   if (p == nullptr) {
     available = next_buffer_size = std::max(next_buffer_size, bytes);
-    current_buf = buffers.emplace_back(std::aligned_alloc(alignment, next_buffer_size));
+    current_buf = buffers.emplace_back(std::aligned_alloc(alignment, next_buffer_size), next_buffer_size).first;
     next_buffer_size *= growth_factor;
+    if (max_buffer_size > 0) {
+      next_buffer_size = std::min(next_buffer_size, max_buffer_size);
+    }
     p = current_buf;
   }
 
   current_buf = (char *)current_buf + bytes;
   available -= bytes;
+  used += bytes;
   return p;
 }
 
+void MonotonicBuffer::reset() {
+  high_water = std::max(high_water, used);
+  used = 0;
+  if (buffers.empty()) return;
+
+  // keep only the largest backing buffer and rewind to its start
+  auto largest = std::max_element(buffers.begin(), buffers.end(),
+                                  [](auto &a, auto &b) { return a.second < b.second; });
+  auto kept = *largest;
+  for (auto &[buf, size] : buffers) {
+    if (buf != kept.first) free(buf);
+  }
+  buffers.clear();
+  buffers.push_back(kept);
+  current_buf = kept.first;
+  available = kept.second;
+}
+
+MonotonicBuffer::Stats MonotonicBuffer::stats() const {
+  Stats s{.bytes_used = used, .high_water = std::max(high_water, used), .num_buffers = buffers.size()};
+  for (auto &[buf, size] : buffers) s.bytes_reserved += size;
+  return s;
+}
+
 MonotonicBuffer::~MonotonicBuffer() {
-  for (auto buf : buffers) {
+  for (auto &[buf, size] : buffers) {
     free(buf);
   }
 }
@@ -33,16 +33,34 @@ void logMessage(ReplyMsgType type, const char* fmt, ...);
 
 class MonotonicBuffer {
 public:
-  MonotonicBuffer(size_t initial_size) : next_buffer_size(initial_size) {}
+  struct Stats {
+    size_t bytes_used = 0;      // handed out since the last reset
+    size_t bytes_reserved = 0;  // total backing allocation
+    size_t high_water = 0;      // max bytes_used observed across resets
+    size_t num_buffers = 0;
+  };
+
+  // max_buffer_size caps the geometric growth of individual backing buffers
+  // (0 = uncapped)
+  MonotonicBuffer(size_t initial_size, size_t max_buffer_size = 0)
+      : next_buffer_size(initial_size), max_buffer_size(max_buffer_size) {}
   ~MonotonicBuffer();
   void *allocate(size_t bytes, size_t alignment = 16ul);
   void deallocate(void *p) {}
+  // Rewinds the arena, freeing all but the largest backing buffer, so a
+  // steady-state consumer reuses its high-water-mark allocation with no
+  // further mallocs.
+  void reset();
+  Stats stats() const;
 
 private:
   void *current_buf = nullptr;
   size_t next_buffer_size = 0;
+  size_t max_buffer_size = 0;
   size_t available = 0;
-  std::deque<void *> buffers;
+  size_t used = 0;
+  size_t high_water = 0;
+  std::deque<std::pair<void *, size_t>> buffers;
   static constexpr float growth_factor = 1.5;
 };
 